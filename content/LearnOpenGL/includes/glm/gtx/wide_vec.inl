@@ -0,0 +1,740 @@
+/// @ref gtx_wide_vec
+/// @file glm/gtx/wide_vec.inl
+
+namespace glm{
+namespace detail
+{
+	// Transposes N vec3 at Src into three arrays of N floats
+	template<int N>
+	GLM_FUNC_QUALIFIER void wide_transpose3(float* X, float* Y, float* Z, float const* Src)
+	{
+		int i = 0;
+#		ifdef GLM_WIDE_VEC_SSE2
+			// four vectors are three registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+			for(; i + 4 <= N; i += 4, Src += 12)
+			{
+				__m128 const a = _mm_loadu_ps(Src);
+				__m128 const b = _mm_loadu_ps(Src + 4);
+				__m128 const c = _mm_loadu_ps(Src + 8);
+				__m128 const b2c1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+				__m128 const b3c2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+				__m128 const a1b0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+				__m128 const a2b1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+				__m128 const c0c3 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+				_mm_storeu_ps(X + i, _mm_shuffle_ps(a, b2c1, _MM_SHUFFLE(2, 0, 3, 0)));
+				_mm_storeu_ps(Y + i, _mm_shuffle_ps(a1b0, b3c2, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(Z + i, _mm_shuffle_ps(a2b1, c0c3, _MM_SHUFFLE(2, 0, 2, 0)));
+			}
+#		endif
+		for(; i < N; ++i, Src += 3)
+		{
+			X[i] = Src[0];
+			Y[i] = Src[1];
+			Z[i] = Src[2];
+		}
+	}
+
+	// The other way around, three arrays of N floats into N vec3 at Dst
+	template<int N>
+	GLM_FUNC_QUALIFIER void wide_interleave3(float* Dst, float const* X, float const* Y, float const* Z)
+	{
+		int i = 0;
+#		ifdef GLM_WIDE_VEC_SSE2
+			for(; i + 4 <= N; i += 4, Dst += 12)
+			{
+				__m128 const x = _mm_loadu_ps(X + i);
+				__m128 const y = _mm_loadu_ps(Y + i);
+				__m128 const z = _mm_loadu_ps(Z + i);
+				__m128 const x0y0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+				__m128 const z0x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+				__m128 const y1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+				__m128 const x2y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+				__m128 const z2x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+				__m128 const y3z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+				_mm_storeu_ps(Dst, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(Dst + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(Dst + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+			}
+#		endif
+		for(; i < N; ++i, Dst += 3)
+		{
+			Dst[0] = X[i];
+			Dst[1] = Y[i];
+			Dst[2] = Z[i];
+		}
+	}
+
+	// Lane i of the four results gets the four floats at Src[i] + Offset, a 4 x N transpose.
+	// Building the registers from scalar stores would stall on store forwarding.
+	template<int N>
+	GLM_FUNC_QUALIFIER void wide_gather4(float_wide<N>& X, float_wide<N>& Y, float_wide<N>& Z, float_wide<N>& W, float const* const* Src, int Offset)
+	{
+		float Lanes[4][N];
+		for(int i = 0; i < N; ++i)
+			for(int c = 0; c < 4; ++c)
+				Lanes[c][i] = Src[i][Offset + c];
+		X = float_wide<N>::load(Lanes[0]);
+		Y = float_wide<N>::load(Lanes[1]);
+		Z = float_wide<N>::load(Lanes[2]);
+		W = float_wide<N>::load(Lanes[3]);
+	}
+
+#	ifdef GLM_WIDE_VEC_SSE2
+	GLM_FUNC_QUALIFIER void wide_gather4(float_wide<4>& X, float_wide<4>& Y, float_wide<4>& Z, float_wide<4>& W, float const* const* Src, int Offset)
+	{
+		__m128 r0 = _mm_loadu_ps(Src[0] + Offset);
+		__m128 r1 = _mm_loadu_ps(Src[1] + Offset);
+		__m128 r2 = _mm_loadu_ps(Src[2] + Offset);
+		__m128 r3 = _mm_loadu_ps(Src[3] + Offset);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		X.data = r0;
+		Y.data = r1;
+		Z.data = r2;
+		W.data = r3;
+	}
+#	endif
+
+#	ifdef GLM_WIDE_VEC_AVX
+	// Lanes 0 to 3 in the low half, 4 to 7 in the high half, then the SSE transpose on both halves
+	GLM_FUNC_QUALIFIER void wide_gather4(__m256* Dst, float const* const* Src, int Offset)
+	{
+		__m256 r[4];
+		for(int i = 0; i < 4; ++i)
+			r[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(Src[i] + Offset)), _mm_loadu_ps(Src[i + 4] + Offset), 1);
+		__m256 const t0 = _mm256_unpacklo_ps(r[0], r[1]);
+		__m256 const t1 = _mm256_unpacklo_ps(r[2], r[3]);
+		__m256 const t2 = _mm256_unpackhi_ps(r[0], r[1]);
+		__m256 const t3 = _mm256_unpackhi_ps(r[2], r[3]);
+		Dst[0] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		Dst[1] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		Dst[2] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		Dst[3] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	GLM_FUNC_QUALIFIER void wide_gather4(float_wide<8>& X, float_wide<8>& Y, float_wide<8>& Z, float_wide<8>& W, float const* const* Src, int Offset)
+	{
+		__m256 r[4];
+		wide_gather4(r, Src, Offset);
+		X.data = r[0];
+		Y.data = r[1];
+		Z.data = r[2];
+		W.data = r[3];
+	}
+#	endif
+
+#	ifdef GLM_WIDE_VEC_AVX512
+	GLM_FUNC_QUALIFIER __m512 wide_combine(__m256 Low, __m256 High)
+	{
+		return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(Low)), _mm256_castps_pd(High), 1));
+	}
+
+	GLM_FUNC_QUALIFIER void wide_gather4(float_wide<16>& X, float_wide<16>& Y, float_wide<16>& Z, float_wide<16>& W, float const* const* Src, int Offset)
+	{
+		__m256 Low[4], High[4];
+		wide_gather4(Low, Src, Offset);
+		wide_gather4(High, Src + 8, Offset);
+		X.data = wide_combine(Low[0], High[0]);
+		Y.data = wide_combine(Low[1], High[1]);
+		Z.data = wide_combine(Low[2], High[2]);
+		W.data = wide_combine(Low[3], High[3]);
+	}
+#	endif
+}//namespace detail
+
+	// float_wide, plain arrays
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N>::float_wide(float Scalar)
+	{
+		for(int i = 0; i < N; ++i)
+			data[i] = Scalar;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> float_wide<N>::load(float const* p)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = p[i];
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void float_wide<N>::store(float* p) const
+	{
+		for(int i = 0; i < N; ++i)
+			p[i] = data[i];
+	}
+
+#	define GLM_WIDE_VEC_BINARY(op)																		\
+	template<int N>																						\
+	GLM_FUNC_QUALIFIER float_wide<N> operator op(float_wide<N> const& a, float_wide<N> const& b)		\
+	{																									\
+		float_wide<N> Result;																			\
+		for(int i = 0; i < N; ++i)																		\
+			Result.data[i] = a.data[i] op b.data[i];													\
+		return Result;																					\
+	}
+
+	GLM_WIDE_VEC_BINARY(+)
+	GLM_WIDE_VEC_BINARY(-)
+	GLM_WIDE_VEC_BINARY(*)
+	GLM_WIDE_VEC_BINARY(/)
+#	undef GLM_WIDE_VEC_BINARY
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> operator-(float_wide<N> const& a)
+	{
+		return float_wide<N>(0.0f) - a;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> sqrt(float_wide<N> const& a)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = std::sqrt(a.data[i]);
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> min(float_wide<N> const& a, float_wide<N> const& b)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = b.data[i] < a.data[i] ? b.data[i] : a.data[i];
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> max(float_wide<N> const& a, float_wide<N> const& b)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = a.data[i] < b.data[i] ? b.data[i] : a.data[i];
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> floor(float_wide<N> const& a)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = std::floor(a.data[i]);
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> fract(float_wide<N> const& a)
+	{
+		return a - floor(a);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> abs(float_wide<N> const& a)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = a.data[i] >= 0.0f ? a.data[i] : -a.data[i];
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> step(float_wide<N> const& edge, float_wide<N> const& x)
+	{
+		float_wide<N> Result;
+		for(int i = 0; i < N; ++i)
+			Result.data[i] = x.data[i] < edge.data[i] ? 0.0f : 1.0f;
+		return Result;
+	}
+
+	// float_wide, SIMD registers. These overloads are not templates, so they win over the ones above.
+
+#	define GLM_WIDE_VEC_SIMD(width, prefix)																	\
+	GLM_FUNC_QUALIFIER float_wide<width> operator+(float_wide<width> const& a, float_wide<width> const& b)			\
+	{ return float_wide<width>(prefix##_add_ps(a.data, b.data)); }													\
+	GLM_FUNC_QUALIFIER float_wide<width> operator-(float_wide<width> const& a, float_wide<width> const& b)			\
+	{ return float_wide<width>(prefix##_sub_ps(a.data, b.data)); }													\
+	GLM_FUNC_QUALIFIER float_wide<width> operator*(float_wide<width> const& a, float_wide<width> const& b)			\
+	{ return float_wide<width>(prefix##_mul_ps(a.data, b.data)); }													\
+	GLM_FUNC_QUALIFIER float_wide<width> operator/(float_wide<width> const& a, float_wide<width> const& b)			\
+	{ return float_wide<width>(prefix##_div_ps(a.data, b.data)); }													\
+	GLM_FUNC_QUALIFIER float_wide<width> operator-(float_wide<width> const& a)										\
+	{ return float_wide<width>(prefix##_sub_ps(prefix##_setzero_ps(), a.data)); }									\
+	GLM_FUNC_QUALIFIER float_wide<width> sqrt(float_wide<width> const& a)											\
+	{ return float_wide<width>(prefix##_sqrt_ps(a.data)); }															\
+	GLM_FUNC_QUALIFIER float_wide<width> min(float_wide<width> const& a, float_wide<width> const& b)				\
+	{ return float_wide<width>(prefix##_min_ps(b.data, a.data)); }													\
+	GLM_FUNC_QUALIFIER float_wide<width> max(float_wide<width> const& a, float_wide<width> const& b)				\
+	{ return float_wide<width>(prefix##_max_ps(b.data, a.data)); }
+
+#	ifdef GLM_WIDE_VEC_SSE2
+#		if GLM_ARCH & GLM_ARCH_SSE41_BIT
+			GLM_FUNC_QUALIFIER float_wide<4> floor(float_wide<4> const& a)
+			{
+				return float_wide<4>(_mm_floor_ps(a.data));
+			}
+#		else
+			// Truncate, then subtract one where that rounded up. Lanes of 2^23 and more are
+			// integers already, and the sign of a is kept so that floor(-0) is -0.
+			GLM_FUNC_QUALIFIER float_wide<4> floor(float_wide<4> const& a)
+			{
+				__m128 const SignMask = _mm_set1_ps(-0.0f);
+				__m128 const Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.data));
+				__m128 const Floored = _mm_sub_ps(Truncated, _mm_and_ps(_mm_cmpgt_ps(Truncated, a.data), _mm_set1_ps(1.0f)));
+				__m128 const IsSmall = _mm_cmplt_ps(_mm_andnot_ps(SignMask, a.data), _mm_set1_ps(8388608.0f));
+				__m128 const Result = _mm_or_ps(_mm_and_ps(IsSmall, Floored), _mm_andnot_ps(IsSmall, a.data));
+				return float_wide<4>(_mm_or_ps(Result, _mm_and_ps(SignMask, a.data)));
+			}
+#		endif
+
+		GLM_FUNC_QUALIFIER float_wide<4> abs(float_wide<4> const& a)
+		{
+			return float_wide<4>(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.data));
+		}
+
+		GLM_FUNC_QUALIFIER float_wide<4> step(float_wide<4> const& edge, float_wide<4> const& x)
+		{
+			return float_wide<4>(_mm_and_ps(_mm_cmpnlt_ps(x.data, edge.data), _mm_set1_ps(1.0f)));
+		}
+
+		GLM_WIDE_VEC_SIMD(4, _mm)
+#	endif
+#	ifdef GLM_WIDE_VEC_AVX
+		GLM_FUNC_QUALIFIER float_wide<8> floor(float_wide<8> const& a)
+		{
+			return float_wide<8>(_mm256_floor_ps(a.data));
+		}
+
+		GLM_FUNC_QUALIFIER float_wide<8> abs(float_wide<8> const& a)
+		{
+			return float_wide<8>(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.data));
+		}
+
+		GLM_FUNC_QUALIFIER float_wide<8> step(float_wide<8> const& edge, float_wide<8> const& x)
+		{
+			return float_wide<8>(_mm256_and_ps(_mm256_cmp_ps(x.data, edge.data, _CMP_NLT_UQ), _mm256_set1_ps(1.0f)));
+		}
+
+		GLM_WIDE_VEC_SIMD(8, _mm256)
+#	endif
+#	ifdef GLM_WIDE_VEC_AVX512
+		GLM_FUNC_QUALIFIER float_wide<16> floor(float_wide<16> const& a)
+		{
+			return float_wide<16>(_mm512_floor_ps(a.data));
+		}
+
+		GLM_FUNC_QUALIFIER float_wide<16> abs(float_wide<16> const& a)
+		{
+			return float_wide<16>(_mm512_castsi512_ps(_mm512_andnot_epi32(_mm512_castps_si512(_mm512_set1_ps(-0.0f)), _mm512_castps_si512(a.data))));
+		}
+
+		GLM_FUNC_QUALIFIER float_wide<16> step(float_wide<16> const& edge, float_wide<16> const& x)
+		{
+			return float_wide<16>(_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(x.data, edge.data, _CMP_NLT_UQ), _mm512_set1_ps(1.0f)));
+		}
+
+		GLM_WIDE_VEC_SIMD(16, _mm512)
+#	endif
+#	undef GLM_WIDE_VEC_SIMD
+
+	// Lanes
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float lane(float_wide<N> const& a, int i)
+	{
+		float Lanes[N];
+		a.store(Lanes);
+		return Lanes[i];
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3 lane(vec3_wide<N> const& v, int i)
+	{
+		return vec3(lane(v.x, i), lane(v.y, i), lane(v.z, i));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec4 lane(vec4_wide<N> const& v, int i)
+	{
+		return vec4(lane(v.x, i), lane(v.y, i), lane(v.z, i), lane(v.w, i));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER mat4 lane(mat4_wide<N> const& m, int i)
+	{
+		return mat4(lane(m[0], i), lane(m[1], i), lane(m[2], i), lane(m[3], i));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER quat lane(quat_wide<N> const& q, int i)
+	{
+		return quat(lane(q.w, i), lane(q.x, i), lane(q.y, i), lane(q.z, i));
+	}
+
+	// Conversions
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void load(vec3_wide<N>& Dst, vec3 const* Src)
+	{
+		float X[N], Y[N], Z[N];
+		detail::wide_transpose3<N>(X, Y, Z, &Src[0].x);
+		Dst.x = float_wide<N>::load(X);
+		Dst.y = float_wide<N>::load(Y);
+		Dst.z = float_wide<N>::load(Z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void load(vec4_wide<N>& Dst, vec4 const* Src)
+	{
+		float const* Pointers[N];
+		for(int i = 0; i < N; ++i)
+			Pointers[i] = &Src[i].x;
+		detail::wide_gather4(Dst.x, Dst.y, Dst.z, Dst.w, Pointers, 0);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void load(quat_wide<N>& Dst, quat const* Src)
+	{
+		float const* Pointers[N];
+		for(int i = 0; i < N; ++i)
+			Pointers[i] = &Src[i].x;
+		detail::wide_gather4(Dst.x, Dst.y, Dst.z, Dst.w, Pointers, 0);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void load(vec3_wide<N>& Dst, float const* X, float const* Y, float const* Z)
+	{
+		Dst = vec3_wide<N>(float_wide<N>::load(X), float_wide<N>::load(Y), float_wide<N>::load(Z));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void store(vec3* Dst, vec3_wide<N> const& Src)
+	{
+		float X[N], Y[N], Z[N];
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+		detail::wide_interleave3<N>(&Dst[0].x, X, Y, Z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void store(vec4* Dst, vec4_wide<N> const& Src)
+	{
+		float X[N], Y[N], Z[N], W[N];
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+		Src.w.store(W);
+		for(int i = 0; i < N; ++i)
+			Dst[i] = vec4(X[i], Y[i], Z[i], W[i]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void store(quat* Dst, quat_wide<N> const& Src)
+	{
+		float X[N], Y[N], Z[N], W[N];
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+		Src.w.store(W);
+		for(int i = 0; i < N; ++i)
+			Dst[i] = quat(W[i], X[i], Y[i], Z[i]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void store(float* X, float* Y, float* Z, vec3_wide<N> const& Src)
+	{
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+	}
+
+	// vec4, mat4 and quat gathers are register transposes, faster than hardware gathers
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void gather(vec3_wide<N>& Dst, vec3 const* Base, int const* Indices)
+	{
+		float X[N], Y[N], Z[N];
+		for(int i = 0; i < N; ++i)
+		{
+			vec3 const& v = Base[Indices[i]];
+			X[i] = v.x;
+			Y[i] = v.y;
+			Z[i] = v.z;
+		}
+		Dst = vec3_wide<N>(float_wide<N>::load(X), float_wide<N>::load(Y), float_wide<N>::load(Z));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void gather(vec4_wide<N>& Dst, vec4 const* Base, int const* Indices)
+	{
+		float const* Pointers[N];
+		for(int i = 0; i < N; ++i)
+			Pointers[i] = &Base[Indices[i]].x;
+		detail::wide_gather4(Dst.x, Dst.y, Dst.z, Dst.w, Pointers, 0);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void gather(mat4_wide<N>& Dst, mat4 const* Base, int const* Indices)
+	{
+		float const* Pointers[N];
+		for(int i = 0; i < N; ++i)
+			Pointers[i] = &Base[Indices[i]][0].x;
+		for(int c = 0; c < 4; ++c)
+			detail::wide_gather4(Dst[c].x, Dst[c].y, Dst[c].z, Dst[c].w, Pointers, c * 4);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void gather(quat_wide<N>& Dst, quat const* Base, int const* Indices)
+	{
+		float const* Pointers[N];
+		for(int i = 0; i < N; ++i)
+			Pointers[i] = &Base[Indices[i]].x;
+		detail::wide_gather4(Dst.x, Dst.y, Dst.z, Dst.w, Pointers, 0);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void scatter(vec3* Base, int const* Indices, vec3_wide<N> const& Src)
+	{
+		float X[N], Y[N], Z[N];
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+		for(int i = 0; i < N; ++i)
+			Base[Indices[i]] = vec3(X[i], Y[i], Z[i]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER void scatter(vec4* Base, int const* Indices, vec4_wide<N> const& Src)
+	{
+		float X[N], Y[N], Z[N], W[N];
+		Src.x.store(X);
+		Src.y.store(Y);
+		Src.z.store(Z);
+		Src.w.store(W);
+		for(int i = 0; i < N; ++i)
+			Base[Indices[i]] = vec4(X[i], Y[i], Z[i], W[i]);
+	}
+
+	// Vector arithmetic
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator+(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return vec3_wide<N>(a.x + b.x, a.y + b.y, a.z + b.z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator-(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return vec3_wide<N>(a.x - b.x, a.y - b.y, a.z - b.z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator*(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return vec3_wide<N>(a.x * b.x, a.y * b.y, a.z * b.z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator*(vec3_wide<N> const& a, float_wide<N> const& s)
+	{
+		return vec3_wide<N>(a.x * s, a.y * s, a.z * s);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator*(vec3_wide<N> const& a, float s)
+	{
+		return a * float_wide<N>(s);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator/(vec3_wide<N> const& a, float_wide<N> const& s)
+	{
+		return vec3_wide<N>(a.x / s, a.y / s, a.z / s);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator-(vec3_wide<N> const& a)
+	{
+		return vec3_wide<N>(-a.x, -a.y, -a.z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec4_wide<N> operator+(vec4_wide<N> const& a, vec4_wide<N> const& b)
+	{
+		return vec4_wide<N>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec4_wide<N> operator*(vec4_wide<N> const& a, float_wide<N> const& s)
+	{
+		return vec4_wide<N>(a.x * s, a.y * s, a.z * s, a.w * s);
+	}
+
+	// Geometric functions
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> dot(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> dot(vec4_wide<N> const& a, vec4_wide<N> const& b)
+	{
+		return (a.x * b.x + a.y * b.y) + (a.z * b.z + a.w * b.w);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> cross(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return vec3_wide<N>(
+			a.y * b.z - b.y * a.z,
+			a.z * b.x - b.z * a.x,
+			a.x * b.y - b.x * a.y);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> length(vec3_wide<N> const& v)
+	{
+		return sqrt(dot(v, v));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> distance(vec3_wide<N> const& a, vec3_wide<N> const& b)
+	{
+		return length(b - a);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> normalize(vec3_wide<N> const& v)
+	{
+		return v * (float_wide<N>(1.0f) / sqrt(dot(v, v)));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> mix(vec3_wide<N> const& a, vec3_wide<N> const& b, float_wide<N> const& t)
+	{
+		return a + (b - a) * t;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> mix(vec3_wide<N> const& a, vec3_wide<N> const& b, float t)
+	{
+		return mix(a, b, float_wide<N>(t));
+	}
+
+	// Matrix transforms, summed the way mat4 * vec4 sums its columns
+
+	template<int N>
+	GLM_FUNC_QUALIFIER mat4_wide<N>::mat4_wide(mat4 const& m)
+	{
+		for(int c = 0; c < 4; ++c)
+			value[c] = vec4_wide<N>(m[c]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec4_wide<N> operator*(mat4 const& m, vec4_wide<N> const& v)
+	{
+		return mat4_wide<N>(m) * v;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec4_wide<N> operator*(mat4_wide<N> const& m, vec4_wide<N> const& v)
+	{
+		return vec4_wide<N>(
+			(m[0].x * v.x + m[1].x * v.y) + (m[2].x * v.z + m[3].x * v.w),
+			(m[0].y * v.x + m[1].y * v.y) + (m[2].y * v.z + m[3].y * v.w),
+			(m[0].z * v.x + m[1].z * v.y) + (m[2].z * v.z + m[3].z * v.w),
+			(m[0].w * v.x + m[1].w * v.y) + (m[2].w * v.z + m[3].w * v.w));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> transformPosition(mat4 const& m, vec3_wide<N> const& p)
+	{
+		return transformPosition(mat4_wide<N>(m), p);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> transformPosition(mat4_wide<N> const& m, vec3_wide<N> const& p)
+	{
+		return vec3_wide<N>(
+			(m[0].x * p.x + m[1].x * p.y) + (m[2].x * p.z + m[3].x),
+			(m[0].y * p.x + m[1].y * p.y) + (m[2].y * p.z + m[3].y),
+			(m[0].z * p.x + m[1].z * p.y) + (m[2].z * p.z + m[3].z));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> transformDirection(mat4 const& m, vec3_wide<N> const& d)
+	{
+		return transformDirection(mat4_wide<N>(m), d);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> transformDirection(mat4_wide<N> const& m, vec3_wide<N> const& d)
+	{
+		return vec3_wide<N>(
+			(m[0].x * d.x + m[1].x * d.y) + m[2].x * d.z,
+			(m[0].y * d.x + m[1].y * d.y) + m[2].y * d.z,
+			(m[0].z * d.x + m[1].z * d.y) + m[2].z * d.z);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER mat4_wide<N> operator+(mat4_wide<N> const& a, mat4_wide<N> const& b)
+	{
+		mat4_wide<N> Result;
+		Result[0] = a[0] + b[0];
+		Result[1] = a[1] + b[1];
+		Result[2] = a[2] + b[2];
+		Result[3] = a[3] + b[3];
+		return Result;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER mat4_wide<N> operator*(mat4_wide<N> const& m, float_wide<N> const& s)
+	{
+		mat4_wide<N> Result;
+		Result[0] = m[0] * s;
+		Result[1] = m[1] * s;
+		Result[2] = m[2] * s;
+		Result[3] = m[3] * s;
+		return Result;
+	}
+
+	// Quaternions, the same expressions as quat's operators
+
+	template<int N>
+	GLM_FUNC_QUALIFIER quat_wide<N> operator*(quat_wide<N> const& p, quat_wide<N> const& q)
+	{
+		return quat_wide<N>(
+			p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z,
+			p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+			p.w * q.y + p.y * q.w + p.z * q.x - p.x * q.z,
+			p.w * q.z + p.z * q.w + p.x * q.y - p.y * q.x);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER vec3_wide<N> operator*(quat_wide<N> const& q, vec3_wide<N> const& v)
+	{
+		vec3_wide<N> const QuatVector(q.x, q.y, q.z);
+		vec3_wide<N> const uv(cross(QuatVector, v));
+		vec3_wide<N> const uuv(cross(QuatVector, uv));
+
+		return v + ((uv * q.w) + uuv) * 2.0f;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> dot(quat_wide<N> const& a, quat_wide<N> const& b)
+	{
+		return (a.x * b.x + a.y * b.y) + (a.z * b.z + a.w * b.w);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER quat_wide<N> normalize(quat_wide<N> const& q)
+	{
+		float_wide<N> const OneOverLen = float_wide<N>(1.0f) / sqrt(dot(q, q));
+		return quat_wide<N>(q.w * OneOverLen, q.x * OneOverLen, q.y * OneOverLen, q.z * OneOverLen);
+	}
+}//namespace glm
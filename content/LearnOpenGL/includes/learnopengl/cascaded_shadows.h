@@ -0,0 +1,164 @@
+#ifndef CASCADED_SHADOWS_H
+#define CASCADED_SHADOWS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CASCADED_SHADOWS_USE_SSE
+#endif
+
+// one cascade of a directional light's shadow map
+struct ShadowCascade {
+    glm::mat4 lightSpace;           // orthographic projection * light view, what the shaders get
+    glm::vec3 boxMin, boxMax;       // the projected box in light view space, the light looks down -z
+    float nearDistance, farDistance; // slice of the camera frustum the cascade covers
+};
+
+// bounding spheres of the shadow casters, one array per component so the culler can test four at once
+struct ShadowCasters {
+    std::vector<float> x, y, z, radius;
+
+    void add(const glm::vec3 &center, float r)
+    {
+        x.push_back(center.x);
+        y.push_back(center.y);
+        z.push_back(center.z);
+        radius.push_back(r);
+    }
+    size_t size() const { return x.size(); }
+    void clear() { x.clear(); y.clear(); z.clear(); radius.clear(); }
+};
+
+// Stable cascade fitting and per cascade caster culling for a directional light; no OpenGL calls.
+// Every cascade is fitted around the bounding sphere of its slice of the camera frustum, computed
+// straight from the field of view, so its size does not change when the camera turns. The light
+// view is the same rotation for all cascades and the sphere's center is snapped to whole shadow map
+// texels in it, so moving the camera slides the cascades by whole texels and the edges stop shimmering.
+class CascadedShadows
+{
+public:
+    // rotation from world space into light view space, shared by every cascade
+    static glm::mat4 lightView(const glm::vec3 &lightDir)
+    {
+        glm::vec3 up = std::fabs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        return glm::lookAt(glm::vec3(0.0f), -lightDir, up);
+    }
+
+    // splitDistances holds the camera's near plane, the distances between cascades and its far plane.
+    // casterReach extends every box towards the light so that casters outside the slice still cast into it.
+    static void fitCascades(const glm::vec3 &cameraPosition, const glm::vec3 &cameraFront, float fovy, float aspect,
+                            const std::vector<float> &splitDistances, const glm::vec3 &lightDir,
+                            unsigned int resolution, float casterReach, std::vector<ShadowCascade> &cascades)
+    {
+        const glm::mat4 view = lightView(lightDir);
+        // squared distance of a frustum corner from the view axis per unit of depth
+        const float tanHalf = std::tan(fovy * 0.5f);
+        const float k2 = tanHalf * tanHalf * (1.0f + aspect * aspect);
+
+        cascades.resize(splitDistances.size() - 1);
+        for (size_t i = 0; i + 1 < splitDistances.size(); i++)
+        {
+            const float nearDistance = splitDistances[i], farDistance = splitDistances[i + 1];
+            // smallest sphere through the near and far corners of the slice, centered on the view axis
+            float center = 0.5f * (nearDistance + farDistance) * (1.0f + k2);
+            float radius;
+            if (center >= farDistance)
+            {
+                center = farDistance;
+                radius = farDistance * std::sqrt(k2);
+            }
+            else
+            {
+                radius = std::sqrt((farDistance - center) * (farDistance - center) + farDistance * farDistance * k2);
+            }
+            // rounded up so that float noise in the camera basis never changes the size of a texel
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            glm::vec3 lightCenter = glm::vec3(view * glm::vec4(cameraPosition + cameraFront * center, 1.0f));
+            const float texel = 2.0f * radius / resolution;
+            lightCenter.x = std::floor(lightCenter.x / texel) * texel;
+            lightCenter.y = std::floor(lightCenter.y / texel) * texel;
+
+            ShadowCascade &cascade = cascades[i];
+            cascade.nearDistance = nearDistance;
+            cascade.farDistance = farDistance;
+            cascade.boxMin = lightCenter - glm::vec3(radius);
+            cascade.boxMax = lightCenter + glm::vec3(radius, radius, radius + casterReach);
+            const glm::mat4 projection = glm::ortho(cascade.boxMin.x, cascade.boxMax.x, cascade.boxMin.y, cascade.boxMax.y,
+                                                    -cascade.boxMax.z, -cascade.boxMin.z);
+            cascade.lightSpace = projection * view;
+        }
+    }
+
+    // Appends to lists[c] the index of every caster whose bounding sphere overlaps the box of cascade c,
+    // so each cascade only draws what can land in it. view is lightView() of the light the cascades were fitted for.
+    static void cullCasters(const ShadowCasters &casters, const glm::mat4 &view, const std::vector<ShadowCascade> &cascades,
+                            std::vector<std::vector<unsigned int>> &lists)
+    {
+        const size_t count = casters.size();
+        const size_t cascadeCount = cascades.size();
+        lists.resize(cascadeCount);
+        for (auto &list : lists)
+            list.clear();
+
+        size_t i = 0;
+#ifdef CASCADED_SHADOWS_USE_SSE
+        __m128 m[3][3];
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                m[row][column] = _mm_set1_ps(view[column][row]);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(&casters.x[i]);
+            const __m128 y = _mm_loadu_ps(&casters.y[i]);
+            const __m128 z = _mm_loadu_ps(&casters.z[i]);
+            const __m128 r = _mm_loadu_ps(&casters.radius[i]);
+            __m128 light[3];
+            for (int row = 0; row < 3; row++)
+                light[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[row][0], x), _mm_mul_ps(m[row][1], y)), _mm_mul_ps(m[row][2], z));
+            __m128 low[3], high[3];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                low[axis] = _mm_sub_ps(light[axis], r);
+                high[axis] = _mm_add_ps(light[axis], r);
+            }
+
+            for (size_t c = 0; c < cascadeCount; c++)
+            {
+                const ShadowCascade &cascade = cascades[c];
+                __m128 inside = _mm_and_ps(_mm_cmpge_ps(high[0], _mm_set1_ps(cascade.boxMin.x)), _mm_cmple_ps(low[0], _mm_set1_ps(cascade.boxMax.x)));
+                inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(high[1], _mm_set1_ps(cascade.boxMin.y)), _mm_cmple_ps(low[1], _mm_set1_ps(cascade.boxMax.y))));
+                inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(high[2], _mm_set1_ps(cascade.boxMin.z)), _mm_cmple_ps(low[2], _mm_set1_ps(cascade.boxMax.z))));
+                int mask = _mm_movemask_ps(inside);
+                while (mask)
+                {
+                    int lane = 0;
+                    while (!(mask & (1 << lane)))
+                        lane++;
+                    lists[c].push_back(static_cast<unsigned int>(i + lane));
+                    mask &= mask - 1;
+                }
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            const glm::vec3 light = glm::mat3(view) * glm::vec3(casters.x[i], casters.y[i], casters.z[i]);
+            const float r = casters.radius[i];
+            for (size_t c = 0; c < cascadeCount; c++)
+            {
+                const ShadowCascade &cascade = cascades[c];
+                if (light.x + r >= cascade.boxMin.x && light.x - r <= cascade.boxMax.x &&
+                    light.y + r >= cascade.boxMin.y && light.y - r <= cascade.boxMax.y &&
+                    light.z + r >= cascade.boxMin.z && light.z - r <= cascade.boxMax.z)
+                    lists[c].push_back(static_cast<unsigned int>(i));
+            }
+        }
+    }
+};
+#endif
@@ -0,0 +1,622 @@
+#ifndef IBL_BAKER_H
+#define IBL_BAKER_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IBL_BAKER_USE_SSE
+#endif
+
+// A cubemap of linear HDR colour on the CPU. Every mip level holds its six faces in
+// GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order with the rows in glTexImage2D order, and every
+// texel is four floats (the fourth unused) so that it is one SSE register.
+struct CubemapImage {
+    int size = 0;                           // faces of level 0 are size x size texels
+    std::vector<std::vector<float>> levels;
+
+    int levelSize(int level) const { return std::max(1, size >> level); }
+    float *texel(int level, int face, int x, int y)
+    {
+        const int s = levelSize(level);
+        return &levels[level][(((size_t)face * s + y) * s + x) * 4];
+    }
+    const float *texel(int level, int face, int x, int y) const
+    {
+        const int s = levelSize(level);
+        return &levels[level][(((size_t)face * s + y) * s + x) * 4];
+    }
+    void allocate(int faceSize, int levelCount)
+    {
+        size = faceSize;
+        levels.resize(levelCount);
+        for (int level = 0; level < levelCount; level++)
+            levels[level].assign((size_t)6 * levelSize(level) * levelSize(level) * 4, 0.0f);
+    }
+};
+
+// the split sum BRDF lookup table as 2.2.2.brdf.fs renders it: scale and bias of F0 per texel,
+// NdotV along x and roughness along y
+struct BRDFLookup {
+    int size = 0;
+    std::vector<float> data;                // (y * size + x) * 2
+};
+
+// Irradiance as nine spherical harmonics coefficients, already convolved with the cosine lobe
+// and divided by pi, so evaluate() gives what 2.1.2.irradiance_convolution.fs stores.
+struct IrradianceSH {
+    glm::vec3 coefficients[9];
+
+    static void basis(const glm::vec3 &n, float y[9])
+    {
+        y[0] = 0.282095f;
+        y[1] = 0.488603f * n.y;
+        y[2] = 0.488603f * n.z;
+        y[3] = 0.488603f * n.x;
+        y[4] = 1.092548f * n.x * n.y;
+        y[5] = 1.092548f * n.y * n.z;
+        y[6] = 0.315392f * (3.0f * n.z * n.z - 1.0f);
+        y[7] = 1.092548f * n.x * n.z;
+        y[8] = 0.546274f * (n.x * n.x - n.y * n.y);
+    }
+
+    glm::vec3 evaluate(const glm::vec3 &n) const
+    {
+        float y[9];
+        basis(n, y);
+        glm::vec3 irradiance(0.0f);
+        for (int i = 0; i < 9; i++)
+            irradiance += coefficients[i] * y[i];
+        return glm::max(irradiance, glm::vec3(0.0f));
+    }
+};
+
+// a KTX 1.1 file as read by IBLBaker::loadKTX, ready for glTexImage2D
+struct KTXTexture {
+    uint32_t glType = 0, glFormat = 0, glInternalFormat = 0;
+    int width = 0, height = 0, faces = 0, levels = 0;
+    std::vector<std::vector<unsigned char>> images; // level * faces + face, rows 4 byte aligned
+};
+
+// Bakes the image based lighting of the 6.pbr samples on the CPU, with no OpenGL calls:
+// equirectangular to cubemap conversion, SH9 irradiance, the GGX prefiltered specular mip chain
+// and the BRDF lookup table, written as KTX files the samples can upload instead of convolving
+// the environment on the GPU at every start. The prefilter and the lookup table follow
+// 2.2.2.prefilter.fs and 2.2.2.brdf.fs sample for sample. All the work is split over threadCount
+// threads (0 = one per hardware thread); texels are filtered four channels at a time with SSE2,
+// and the lookup table integrates four samples at a time.
+class IBLBaker
+{
+public:
+    // float RGB pixels as stbi_loadf returns them with stbi_set_flip_vertically_on_load(true),
+    // mapped the way 2.2.2.equirectangular_to_cubemap.fs maps them; fills level 0 only
+    static void equirectangularToCubemap(const float *rgb, int width, int height, int faceSize,
+                                         CubemapImage &cube, unsigned int threadCount = 0)
+    {
+        cube.allocate(faceSize, 1);
+        parallelFor(6 * faceSize, threadCount, [&](int row) {
+            const int face = row / faceSize, y = row % faceSize;
+            for (int x = 0; x < faceSize; x++)
+            {
+                glm::vec3 dir = glm::normalize(texelDirection(face, x, y, faceSize));
+                // 0.5 + atan / 2pi and 0.5 + asin / pi, in texels, with GL_LINEAR filtering
+                float u = (0.5f + std::atan2(dir.z, dir.x) * 0.15915494f) * width - 0.5f;
+                float v = (0.5f + std::asin(glm::clamp(dir.y, -1.0f, 1.0f)) * 0.31830989f) * height - 0.5f;
+                float fu = std::floor(u), fv = std::floor(v);
+                float tu = u - fu, tv = v - fv;
+                // wrap around the seam horizontally, clamp at the poles
+                int u0 = ((int)fu % width + width) % width, u1 = (u0 + 1) % width;
+                int v0 = glm::clamp((int)fv, 0, height - 1), v1 = glm::clamp((int)fv + 1, 0, height - 1);
+                float *out = cube.texel(0, face, x, y);
+                for (int c = 0; c < 3; c++)
+                {
+                    float top = rgb[((size_t)v0 * width + u0) * 3 + c] * (1.0f - tu) + rgb[((size_t)v0 * width + u1) * 3 + c] * tu;
+                    float bottom = rgb[((size_t)v1 * width + u0) * 3 + c] * (1.0f - tu) + rgb[((size_t)v1 * width + u1) * 3 + c] * tu;
+                    out[c] = top * (1.0f - tv) + bottom * tv;
+                }
+                out[3] = 1.0f;
+            }
+        });
+    }
+
+    // box filters level 0 down to 1 x 1, as glGenerateMipmap does
+    static void generateMipmaps(CubemapImage &cube, unsigned int threadCount = 0)
+    {
+        int levelCount = 1;
+        while ((cube.size >> levelCount) > 0)
+            levelCount++;
+        cube.levels.resize(1);
+        cube.levels.resize(levelCount);
+        for (int level = 1; level < levelCount; level++)
+        {
+            const int size = cube.levelSize(level), previous = cube.levelSize(level - 1);
+            cube.levels[level].assign((size_t)6 * size * size * 4, 0.0f);
+            parallelFor(6 * size, threadCount, [&](int row) {
+                const int face = row / size, y = row % size;
+                const int y0 = std::min(2 * y, previous - 1), y1 = std::min(2 * y + 1, previous - 1);
+                for (int x = 0; x < size; x++)
+                {
+                    const int x0 = std::min(2 * x, previous - 1), x1 = std::min(2 * x + 1, previous - 1);
+                    Color sum = add(add(load(cube.texel(level - 1, face, x0, y0)), load(cube.texel(level - 1, face, x1, y0))),
+                                    add(load(cube.texel(level - 1, face, x0, y1)), load(cube.texel(level - 1, face, x1, y1))));
+                    store(cube.texel(level, face, x, y), scale(sum, 0.25f));
+                }
+            });
+        }
+    }
+
+    // Projects the radiance onto the first nine spherical harmonics, weighting every texel by its
+    // solid angle, and convolves them with the cosine lobe. A level of at most 128 x 128 is used;
+    // the higher bands are gone after the convolution anyway.
+    static void projectIrradianceSH(const CubemapImage &environment, IrradianceSH &sh, unsigned int threadCount = 0)
+    {
+        int level = 0;
+        while (level + 1 < (int)environment.levels.size() && environment.levelSize(level) > 128)
+            level++;
+        const int size = environment.levelSize(level);
+
+        // one partial sum per row, added up in order afterwards so the result does not depend on the thread count
+        std::vector<float> partial((size_t)6 * size * 9 * 4, 0.0f);
+        parallelFor(6 * size, threadCount, [&](int row) {
+            const int face = row / size, y = row % size;
+            Color sum[9];
+            for (int i = 0; i < 9; i++)
+                sum[i] = zero();
+            for (int x = 0; x < size; x++)
+            {
+                float basis[9];
+                IrradianceSH::basis(glm::normalize(texelDirection(face, x, y, size)), basis);
+                Color radiance = scale(load(environment.texel(level, face, x, y)), texelSolidAngle(x, y, size));
+                for (int i = 0; i < 9; i++)
+                    sum[i] = add(sum[i], scale(radiance, basis[i]));
+            }
+            for (int i = 0; i < 9; i++)
+                store(&partial[((size_t)row * 9 + i) * 4], sum[i]);
+        });
+
+        // cosine lobe convolution per band (pi, 2pi/3, pi/4), divided by pi
+        const float band[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+        for (int i = 0; i < 9; i++)
+        {
+            glm::dvec3 total(0.0);
+            for (int row = 0; row < 6 * size; row++)
+            {
+                const float *p = &partial[((size_t)row * 9 + i) * 4];
+                total += glm::dvec3(p[0], p[1], p[2]);
+            }
+            sh.coefficients[i] = glm::vec3(total) * band[i];
+        }
+    }
+
+    static void irradianceCubemap(const IrradianceSH &sh, int faceSize, CubemapImage &irradiance, unsigned int threadCount = 0)
+    {
+        irradiance.allocate(faceSize, 1);
+        parallelFor(6 * faceSize, threadCount, [&](int row) {
+            const int face = row / faceSize, y = row % faceSize;
+            for (int x = 0; x < faceSize; x++)
+            {
+                glm::vec3 value = sh.evaluate(glm::normalize(texelDirection(face, x, y, faceSize)));
+                float *out = irradiance.texel(0, face, x, y);
+                out[0] = value.r;
+                out[1] = value.g;
+                out[2] = value.b;
+                out[3] = 1.0f;
+            }
+        });
+    }
+
+    // The specular mip chain of 2.2.2.prefilter.fs: level l has roughness l / (levelCount - 1) and
+    // averages sampleCount GGX importance samples, each read from the environment mip that matches
+    // its solid angle. With N = V = R the samples only differ between texels by the rotation into
+    // the texel's tangent frame, so each level computes them, and their mip level, once up front.
+    static void prefilterCubemap(const CubemapImage &environment, int faceSize, int levelCount, unsigned int sampleCount,
+                                 CubemapImage &prefiltered, unsigned int threadCount = 0)
+    {
+        prefiltered.allocate(faceSize, levelCount);
+        const float texelSolidAngle = 4.0f * PI / (6.0f * environment.size * environment.size);
+        for (int level = 0; level < levelCount; level++)
+        {
+            const float roughness = levelCount > 1 ? (float)level / (float)(levelCount - 1) : 0.0f;
+            const float a = roughness * roughness;
+
+            // tangent space L, NdotL and mip level of every sample that lands above the horizon
+            std::vector<float> samples;
+            for (unsigned int i = 0; i < sampleCount; i++)
+            {
+                glm::vec3 h = importanceSampleGGX(hammersley(i, sampleCount), a);
+                glm::vec3 l = 2.0f * h.z * h - glm::vec3(0.0f, 0.0f, 1.0f);
+                if (l.z <= 0.0f)
+                    continue;
+                float a2 = a * a;
+                float denom = h.z * h.z * (a2 - 1.0f) + 1.0f;
+                float d = a2 / (PI * denom * denom);
+                float pdf = d * h.z / (4.0f * h.z) + 0.0001f;
+                float sampleSolidAngle = 1.0f / ((float)sampleCount * pdf + 0.0001f);
+                float lod = roughness == 0.0f ? 0.0f : 0.5f * std::log2(sampleSolidAngle / texelSolidAngle);
+                samples.insert(samples.end(), { l.x, l.y, l.z, l.z, lod });
+                // a mirror has every sample on N, one of them gives the same average
+                if (roughness == 0.0f)
+                    break;
+            }
+
+            const int size = prefiltered.levelSize(level);
+            parallelFor(6 * size, threadCount, [&](int row) {
+                const int face = row / size, y = row % size;
+                for (int x = 0; x < size; x++)
+                {
+                    glm::vec3 n = glm::normalize(texelDirection(face, x, y, size));
+                    glm::vec3 up = std::fabs(n.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+                    glm::vec3 tangent = glm::normalize(glm::cross(up, n));
+                    glm::vec3 bitangent = glm::cross(n, tangent);
+
+                    Color color = zero();
+                    float totalWeight = 0.0f;
+                    for (size_t s = 0; s < samples.size(); s += 5)
+                    {
+                        glm::vec3 l = tangent * samples[s] + bitangent * samples[s + 1] + n * samples[s + 2];
+                        color = add(color, scale(sampleLod(environment, l, samples[s + 4]), samples[s + 3]));
+                        totalWeight += samples[s + 3];
+                    }
+                    store(prefiltered.texel(level, face, x, y), scale(color, totalWeight > 0.0f ? 1.0f / totalWeight : 0.0f));
+                    prefiltered.texel(level, face, x, y)[3] = 1.0f;
+                }
+            });
+        }
+    }
+
+    // 2.2.2.brdf.fs over a size x size table
+    static void integrateBRDF(int size, unsigned int sampleCount, BRDFLookup &lut, unsigned int threadCount = 0)
+    {
+        lut.size = size;
+        lut.data.assign((size_t)size * size * 2, 0.0f);
+        // the half vectors of a row, one array per component, padded with samples that count for nothing
+        const unsigned int padded = (sampleCount + 3) & ~3u;
+        parallelFor(size, threadCount, [&](int y) {
+            const float roughness = (y + 0.5f) / size;
+            const float a = roughness * roughness;
+            const float k = a / 2.0f;
+            std::vector<float> hx(padded, 0.0f), hz(padded, 1.0f), valid(padded, 0.0f);
+            for (unsigned int i = 0; i < sampleCount; i++)
+            {
+                glm::vec3 h = importanceSampleGGX(hammersley(i, sampleCount), a);
+                // V has no y, so neither has anything that depends on H.y
+                hx[i] = h.x;
+                hz[i] = h.z;
+                valid[i] = 1.0f;
+            }
+            for (int x = 0; x < size; x++)
+            {
+                const float nDotV = (x + 0.5f) / size;
+                const float vx = std::sqrt(1.0f - nDotV * nDotV), vz = nDotV;
+                const float gv = nDotV / (nDotV * (1.0f - k) + k);
+                float sumA = 0.0f, sumB = 0.0f;
+                unsigned int i = 0;
+#ifdef IBL_BAKER_USE_SSE
+                __m128 accA = _mm_setzero_ps(), accB = _mm_setzero_ps();
+                const __m128 zeroes = _mm_setzero_ps(), ones = _mm_set1_ps(1.0f);
+                for (; i < padded; i += 4)
+                {
+                    __m128 x4 = _mm_loadu_ps(&hx[i]), z4 = _mm_loadu_ps(&hz[i]);
+                    __m128 vDotH = _mm_add_ps(_mm_mul_ps(x4, _mm_set1_ps(vx)), _mm_mul_ps(z4, _mm_set1_ps(vz)));
+                    __m128 nDotL = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(vDotH, vDotH), z4), _mm_set1_ps(vz));
+                    __m128 use = _mm_and_ps(_mm_cmpgt_ps(nDotL, zeroes), _mm_cmpgt_ps(_mm_loadu_ps(&valid[i]), zeroes));
+                    nDotL = _mm_max_ps(nDotL, zeroes);
+                    vDotH = _mm_max_ps(vDotH, zeroes);
+                    __m128 gl = _mm_div_ps(nDotL, _mm_add_ps(_mm_mul_ps(nDotL, _mm_set1_ps(1.0f - k)), _mm_set1_ps(k)));
+                    __m128 gVis = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(gl, _mm_set1_ps(gv)), vDotH), _mm_mul_ps(z4, _mm_set1_ps(nDotV)));
+                    gVis = _mm_and_ps(gVis, use);
+                    __m128 f1 = _mm_sub_ps(ones, vDotH);
+                    __m128 f2 = _mm_mul_ps(f1, f1);
+                    __m128 fc = _mm_mul_ps(_mm_mul_ps(f2, f2), f1);
+                    accA = _mm_add_ps(accA, _mm_mul_ps(_mm_sub_ps(ones, fc), gVis));
+                    accB = _mm_add_ps(accB, _mm_mul_ps(fc, gVis));
+                }
+                float lanesA[4], lanesB[4];
+                _mm_storeu_ps(lanesA, accA);
+                _mm_storeu_ps(lanesB, accB);
+                sumA = (lanesA[0] + lanesA[1]) + (lanesA[2] + lanesA[3]);
+                sumB = (lanesB[0] + lanesB[1]) + (lanesB[2] + lanesB[3]);
+#endif
+                for (; i < sampleCount; i++)
+                {
+                    float vDotH = hx[i] * vx + hz[i] * vz;
+                    float nDotL = 2.0f * vDotH * hz[i] - vz;
+                    if (nDotL <= 0.0f)
+                        continue;
+                    vDotH = std::max(vDotH, 0.0f);
+                    float gVis = nDotL / (nDotL * (1.0f - k) + k) * gv * vDotH / (hz[i] * nDotV);
+                    float fc = std::pow(1.0f - vDotH, 5.0f);
+                    sumA += (1.0f - fc) * gVis;
+                    sumB += fc * gVis;
+                }
+                lut.data[((size_t)y * size + x) * 2] = sumA / sampleCount;
+                lut.data[((size_t)y * size + x) * 2 + 1] = sumB / sampleCount;
+            }
+        });
+    }
+
+    // trilinear lookup in the direction dir, like textureLod with GL_LINEAR_MIPMAP_LINEAR;
+    // every face is clamped at its edges
+    static glm::vec3 sample(const CubemapImage &cube, const glm::vec3 &dir, float lod)
+    {
+        float rgba[4];
+        store(rgba, sampleLod(cube, dir, lod));
+        return glm::vec3(rgba[0], rgba[1], rgba[2]);
+    }
+
+    // direction through the center of a texel, not normalized
+    static glm::vec3 texelDirection(int face, int x, int y, int size)
+    {
+        const float u = 2.0f * (x + 0.5f) / size - 1.0f, v = 2.0f * (y + 0.5f) / size - 1.0f;
+        switch (face)
+        {
+        case 0: return glm::vec3(1.0f, -v, -u);
+        case 1: return glm::vec3(-1.0f, -v, u);
+        case 2: return glm::vec3(u, 1.0f, v);
+        case 3: return glm::vec3(u, -1.0f, -v);
+        case 4: return glm::vec3(u, -v, 1.0f);
+        default: return glm::vec3(-u, -v, -1.0f);
+        }
+    }
+
+    // solid angle a texel covers on the unit sphere
+    static float texelSolidAngle(int x, int y, int size)
+    {
+        const float x0 = 2.0f * x / size - 1.0f, x1 = 2.0f * (x + 1) / size - 1.0f;
+        const float y0 = 2.0f * y / size - 1.0f, y1 = 2.0f * (y + 1) / size - 1.0f;
+        return areaElement(x0, y0) - areaElement(x0, y1) - areaElement(x1, y0) + areaElement(x1, y1);
+    }
+
+    // RGB16F, like the textures the samples render the environment into, with every level (and face)
+    static bool saveKTX(const std::string &path, const CubemapImage &cube)
+    {
+        KTXTexture ktx;
+        ktx.glType = KTX_HALF_FLOAT;
+        ktx.glFormat = KTX_RGB;
+        ktx.glInternalFormat = KTX_RGB16F;
+        ktx.width = ktx.height = cube.size;
+        ktx.faces = 6;
+        ktx.levels = (int)cube.levels.size();
+        for (int level = 0; level < ktx.levels; level++)
+        {
+            const int size = cube.levelSize(level);
+            const size_t rowBytes = ((size_t)size * 6 + 3) & ~(size_t)3;
+            for (int face = 0; face < 6; face++)
+            {
+                std::vector<unsigned char> image(rowBytes * size, 0);
+                for (int y = 0; y < size; y++)
+                {
+                    for (int x = 0; x < size; x++)
+                    {
+                        const float *texel = cube.texel(level, face, x, y);
+                        uint16_t half[3] = { glm::packHalf1x16(texel[0]), glm::packHalf1x16(texel[1]), glm::packHalf1x16(texel[2]) };
+                        std::memcpy(&image[y * rowBytes + (size_t)x * 6], half, 6);
+                    }
+                }
+                ktx.images.push_back(std::move(image));
+            }
+        }
+        return writeKTX(path, ktx);
+    }
+
+    // RG16F, one level
+    static bool saveKTX(const std::string &path, const BRDFLookup &lut)
+    {
+        KTXTexture ktx;
+        ktx.glType = KTX_HALF_FLOAT;
+        ktx.glFormat = KTX_RG;
+        ktx.glInternalFormat = KTX_RG16F;
+        ktx.width = ktx.height = lut.size;
+        ktx.faces = 1;
+        ktx.levels = 1;
+        std::vector<unsigned char> image((size_t)lut.size * lut.size * 4);
+        for (size_t i = 0; i < (size_t)lut.size * lut.size * 2; i++)
+        {
+            uint16_t half = glm::packHalf1x16(lut.data[i]);
+            std::memcpy(&image[i * 2], &half, 2);
+        }
+        ktx.images.push_back(std::move(image));
+        return writeKTX(path, ktx);
+    }
+
+    // reads uncompressed 2D and cube map KTX 1.1 files written with the reader's byte order
+    static bool loadKTX(const std::string &path, KTXTexture &ktx)
+    {
+        FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return false;
+        unsigned char identifier[12];
+        uint32_t header[13];
+        // endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat, width, height,
+        // depth, array elements, faces, mip levels, key/value bytes
+        bool ok = std::fread(identifier, 1, 12, file) == 12 && std::memcmp(identifier, KTX_IDENTIFIER, 12) == 0 &&
+                  std::fread(header, 4, 13, file) == 13 && header[0] == 0x04030201 &&
+                  header[1] != 0 && header[8] == 0 && header[9] == 0 && (header[10] == 1 || header[10] == 6) &&
+                  std::fseek(file, (long)header[12], SEEK_CUR) == 0;
+        if (ok)
+        {
+            ktx.glType = header[1];
+            ktx.glFormat = header[3];
+            ktx.glInternalFormat = header[4];
+            ktx.width = (int)header[6];
+            ktx.height = (int)std::max<uint32_t>(header[7], 1);
+            ktx.faces = (int)header[10];
+            ktx.levels = (int)std::max<uint32_t>(header[11], 1);
+            ktx.images.clear();
+        }
+        for (int level = 0; ok && level < ktx.levels; level++)
+        {
+            uint32_t imageSize;
+            ok = std::fread(&imageSize, 4, 1, file) == 1;
+            for (int face = 0; ok && face < ktx.faces; face++)
+            {
+                std::vector<unsigned char> image(imageSize);
+                ok = std::fread(image.data(), 1, imageSize, file) == imageSize &&
+                     std::fseek(file, (long)(3 - (imageSize + 3) % 4), SEEK_CUR) == 0;
+                ktx.images.push_back(std::move(image));
+            }
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    // runs task(i) for every i in [0, count) on threadCount threads, the calling one included
+    static void parallelFor(int count, unsigned int threadCount, const std::function<void(int)> &task)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = (unsigned int)std::min<int>((int)threadCount, std::max(count, 1));
+        std::atomic<int> next(0);
+        auto worker = [&]() {
+            for (int i = next++; i < count; i = next++)
+                task(i);
+        };
+        std::vector<std::thread> workers;
+        for (unsigned int t = 1; t < threadCount; t++)
+            workers.emplace_back(worker);
+        worker();
+        for (std::thread &t : workers)
+            t.join();
+    }
+
+    static constexpr float PI = 3.14159265359f;
+
+private:
+    static constexpr uint32_t KTX_HALF_FLOAT = 0x140B, KTX_RGB = 0x1907, KTX_RG = 0x8227;
+    static constexpr uint32_t KTX_RGB16F = 0x881B, KTX_RG16F = 0x822F;
+    static constexpr unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+#ifdef IBL_BAKER_USE_SSE
+    typedef __m128 Color;
+    static Color load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, Color c) { _mm_storeu_ps(p, c); }
+    static Color zero() { return _mm_setzero_ps(); }
+    static Color add(Color a, Color b) { return _mm_add_ps(a, b); }
+    static Color scale(Color a, float s) { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+    static Color lerp(Color a, Color b, float t) { return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t))); }
+#else
+    struct Color { float v[4]; };
+    static Color load(const float *p) { Color c; std::memcpy(c.v, p, sizeof(c.v)); return c; }
+    static void store(float *p, Color c) { std::memcpy(p, c.v, sizeof(c.v)); }
+    static Color zero() { return Color{ { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+    static Color add(Color a, Color b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+    static Color scale(Color a, float s) { for (int i = 0; i < 4; i++) a.v[i] *= s; return a; }
+    static Color lerp(Color a, Color b, float t) { for (int i = 0; i < 4; i++) a.v[i] += (b.v[i] - a.v[i]) * t; return a; }
+#endif
+
+    static float areaElement(float x, float y)
+    {
+        return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0f));
+    }
+
+    static glm::vec2 hammersley(unsigned int i, unsigned int n)
+    {
+        uint32_t bits = i;
+        bits = (bits << 16u) | (bits >> 16u);
+        bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+        bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+        bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+        bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+        return glm::vec2((float)i / (float)n, (float)bits * 2.3283064365386963e-10f);
+    }
+
+    // GGX half vector around +z, a = roughness * roughness
+    static glm::vec3 importanceSampleGGX(const glm::vec2 &xi, float a)
+    {
+        float phi = 2.0f * PI * xi.x;
+        float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+        float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+        return glm::vec3(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+    }
+
+    static void faceCoordinates(const glm::vec3 &dir, int &face, float &s, float &t)
+    {
+        const float ax = std::fabs(dir.x), ay = std::fabs(dir.y), az = std::fabs(dir.z);
+        float major, sc, tc;
+        if (ax >= ay && ax >= az)
+        {
+            face = dir.x >= 0.0f ? 0 : 1;
+            major = ax;
+            sc = dir.x >= 0.0f ? -dir.z : dir.z;
+            tc = -dir.y;
+        }
+        else if (ay >= az)
+        {
+            face = dir.y >= 0.0f ? 2 : 3;
+            major = ay;
+            sc = dir.x;
+            tc = dir.y >= 0.0f ? dir.z : -dir.z;
+        }
+        else
+        {
+            face = dir.z >= 0.0f ? 4 : 5;
+            major = az;
+            sc = dir.z >= 0.0f ? dir.x : -dir.x;
+            tc = -dir.y;
+        }
+        s = 0.5f * (sc / major + 1.0f);
+        t = 0.5f * (tc / major + 1.0f);
+    }
+
+    static Color sampleFace(const CubemapImage &cube, int level, int face, float s, float t)
+    {
+        const int size = cube.levelSize(level);
+        const float x = glm::clamp(s * size - 0.5f, 0.0f, (float)(size - 1));
+        const float y = glm::clamp(t * size - 0.5f, 0.0f, (float)(size - 1));
+        const int x0 = (int)x, y0 = (int)y;
+        const int x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+        const float fx = x - x0, fy = y - y0;
+        Color bottom = lerp(load(cube.texel(level, face, x0, y0)), load(cube.texel(level, face, x1, y0)), fx);
+        Color top = lerp(load(cube.texel(level, face, x0, y1)), load(cube.texel(level, face, x1, y1)), fx);
+        return lerp(bottom, top, fy);
+    }
+
+    static Color sampleLod(const CubemapImage &cube, const glm::vec3 &dir, float lod)
+    {
+        int face;
+        float s, t;
+        faceCoordinates(dir, face, s, t);
+        lod = glm::clamp(lod, 0.0f, (float)(cube.levels.size() - 1));
+        const int level = (int)lod;
+        const float blend = lod - level;
+        Color color = sampleFace(cube, level, face, s, t);
+        if (blend > 0.0f)
+            color = lerp(color, sampleFace(cube, level + 1, face, s, t), blend);
+        return color;
+    }
+
+    static bool writeKTX(const std::string &path, const KTXTexture &ktx)
+    {
+        FILE *file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        const uint32_t header[13] = {
+            0x04030201, ktx.glType, 2, ktx.glFormat, ktx.glInternalFormat, ktx.glFormat,
+            (uint32_t)ktx.width, (uint32_t)ktx.height, 0, 0, (uint32_t)ktx.faces, (uint32_t)ktx.levels, 0
+        };
+        bool ok = std::fwrite(KTX_IDENTIFIER, 1, 12, file) == 12 && std::fwrite(header, 4, 13, file) == 13;
+        for (int level = 0; ok && level < ktx.levels; level++)
+        {
+            // the size of one face; every face is a multiple of 4 bytes, so there is no padding between them
+            const uint32_t imageSize = (uint32_t)ktx.images[(size_t)level * ktx.faces].size();
+            ok = std::fwrite(&imageSize, 4, 1, file) == 1;
+            for (int face = 0; ok && face < ktx.faces; face++)
+                ok = std::fwrite(ktx.images[(size_t)level * ktx.faces + face].data(), 1, imageSize, file) == imageSize;
+        }
+        return std::fclose(file) == 0 && ok;
+    }
+};
+
+#endif
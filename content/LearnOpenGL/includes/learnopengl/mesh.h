@@ -7,30 +7,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <learnopengl/shader.h>
+#include <learnopengl/vertex.h>
+#include <learnopengl/vertex_compression.h>
 
 #include <string>
 #include <vector>
 using namespace std;
 
-#define MAX_BONE_INFLUENCE 4
-
-struct Vertex {
-    // position
-    glm::vec3 Position;
-    // normal
-    glm::vec3 Normal;
-    // texCoords
-    glm::vec2 TexCoords;
-    // tangent
-    glm::vec3 Tangent;
-    // bitangent
-    glm::vec3 Bitangent;
-	//bone indexes which will influence this vertex
-	int m_BoneIDs[MAX_BONE_INFLUENCE];
-	//weights from each bone
-	float m_Weights[MAX_BONE_INFLUENCE];
-};
-
 struct Texture {
     unsigned int id;
     string type;
@@ -44,13 +27,19 @@ public:
     vector<unsigned int> indices;
     vector<Texture>      textures;
     unsigned int VAO;
-
-    // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    // GPU vertex layout and the ranges its quantized attributes are decoded with (see vertex_compression.h)
+    VertexCompression compression;
+    glm::vec3 positionOffset, positionScale;
+    glm::vec2 uvOffset, uvScale;
+    size_t vertexBytes;
+
+    // constructor, the default compression keeps full float vertices
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, VertexCompression compression = VertexCompression())
     {
-        this->vertices = vertices;
-        this->indices = indices;
-        this->textures = textures;
+        this->vertices = std::move(vertices);
+        this->indices = std::move(indices);
+        this->textures = std::move(textures);
+        this->compression = compression;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
         setupMesh();
@@ -85,6 +74,15 @@ public:
             glBindTexture(GL_TEXTURE_2D, textures[i].id);
         }
         
+        // quantized positions and texture coordinates are decoded in the shader (VERTEX_DECODE_GLSL)
+        if (!compression.isFull())
+        {
+            glUniform3fv(glGetUniformLocation(shader.ID, "positionOffset"), 1, &positionOffset[0]);
+            glUniform3fv(glGetUniformLocation(shader.ID, "positionScale"), 1, &positionScale[0]);
+            glUniform2fv(glGetUniformLocation(shader.ID, "uvOffset"), 1, &uvOffset[0]);
+            glUniform2fv(glGetUniformLocation(shader.ID, "uvScale"), 1, &uvScale[0]);
+        }
+        
         // draw mesh
         glBindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
@@ -107,39 +105,39 @@ private:
         glGenBuffers(1, &EBO);
 
         glBindVertexArray(VAO);
+        // encode the vertices into the GPU layout; the full layout is the Vertex array itself
+        EncodedVertices encoded;
+        if (compression.isFull())
+            encoded.attributes = vertexAttributes(compression, encoded.stride);
+        else
+            encoded = encodeVertices(vertices, compression);
+        compression = encoded.compression;
+        positionOffset = encoded.positionOffset;
+        positionScale = encoded.positionScale;
+        uvOffset = encoded.uvOffset;
+        uvScale = encoded.uvScale;
+        vertexBytes = vertices.size() * encoded.stride;
+
         // load data into vertex buffers
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         // A great thing about structs is that their memory layout is sequential for all its items.
         // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
         // again translates to 3/2 floats which translates to a byte array.
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);  
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, compression.isFull() ? (const void*)vertices.data() : (const void*)encoded.data.data(), GL_STATIC_DRAW);  
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
-        // set the vertex attribute pointers
-        // vertex Positions
-        glEnableVertexAttribArray(0);	
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex normals
-        glEnableVertexAttribArray(1);	
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-        // vertex texture coords
-        glEnableVertexAttribArray(2);	
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-        // vertex tangent
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-        // vertex bitangent
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
-		// ids
-		glEnableVertexAttribArray(5);
-		glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
-
-		// weights
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
+        // set the vertex attribute pointers the layout asks for
+        // (positions, normals, texture coords, tangents, bitangents, bone ids and weights at locations 0-6)
+        for (const VertexAttribute &attribute : encoded.attributes)
+        {
+            glEnableVertexAttribArray(attribute.location);
+            if (attribute.integer)
+                glVertexAttribIPointer(attribute.location, attribute.size, attribute.type, encoded.stride, (void*)(size_t)attribute.offset);
+            else
+                glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized, encoded.stride, (void*)(size_t)attribute.offset);
+        }
         glBindVertexArray(0);
     }
 };
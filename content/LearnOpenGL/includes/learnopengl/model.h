@@ -11,13 +11,16 @@
 #include <assimp/postprocess.h>
 
 #include <learnopengl/mesh.h>
+#include <learnopengl/model_cache.h>
 #include <learnopengl/shader.h>
+#include <learnopengl/texture_cache.h>
 
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <vector>
 using namespace std;
 
@@ -26,14 +29,20 @@ unsigned int TextureFromFile(const char *path, const string &directory, bool gam
 class Model 
 {
 public:
+    // import flags, part of the cache key: the cache is only valid for data imported with exactly these
+    static const unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
     // model data 
     vector<Texture> textures_loaded;	// stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once.
     vector<Mesh>    meshes;
+    vector<ModelNode> nodes;         // node hierarchy, parents always come before their children
+    unordered_map<string, size_t> textureIndex; // path -> index in textures_loaded
     string directory;
     bool gammaCorrection;
+    VertexCompression compression;   // GPU vertex layout of all meshes, full floats unless asked otherwise
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false) : gammaCorrection(gamma)
+    Model(string const &path, bool gamma = false, VertexCompression compression = VertexCompression()) : gammaCorrection(gamma), compression(compression)
     {
         loadModel(path);
     }
@@ -44,103 +53,126 @@ public:
         for(unsigned int i = 0; i < meshes.size(); i++)
             meshes[i].Draw(shader);
     }
-    
-private:
-    // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
-    void loadModel(string const &path)
+
+    // reads a model with ASSIMP into plain vertex/index arrays, texture references and nodes; does not touch OpenGL.
+    static bool importModel(string const &path, ModelData &model)
     {
-        // read file via ASSIMP
         Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+        const aiScene* scene = importer.ReadFile(path, IMPORT_FLAGS);
         // check for errors
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
         {
             cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
-            return;
+            return false;
         }
+        // process ASSIMP's root node recursively
+        processNode(scene->mRootNode, scene, model, -1);
+        return true;
+    }
+    
+private:
+    // loads a model from its binary cache when that is up to date, otherwise with ASSIMP (and refreshes the cache), then creates the meshes.
+    void loadModel(string const &path)
+    {
         // retrieve the directory path of the filepath
         directory = path.substr(0, path.find_last_of('/'));
 
-        // process ASSIMP's root node recursively
-        processNode(scene->mRootNode, scene);
+        ModelData model;
+        uint64_t hash = 0;
+        bool hashed = ModelCache::hashFile(path, hash);
+        string cachePath = ModelCache::cachePath(path);
+        if (!hashed || !ModelCache::read(cachePath, hash, IMPORT_FLAGS, model))
+        {
+            model = ModelData();
+            if (!importModel(path, model))
+                return;
+            // a read-only asset directory just means no cache, the model still loads
+            if (hashed && !ModelCache::write(cachePath, hash, IMPORT_FLAGS, model))
+                cout << "WARNING::MODEL_CACHE: could not write " << cachePath << endl;
+        }
+
+        loadTextures(model);
+        meshes.reserve(model.meshes.size());
+        for (ModelData::MeshData &mesh : model.meshes)
+        {
+            vector<Texture> textures;
+            for (const TextureRef &ref : mesh.textures)
+                textures.push_back(textures_loaded[textureIndex[ref.path]]);
+            meshes.push_back(Mesh(std::move(mesh.vertices), std::move(mesh.indices), std::move(textures), compression));
+        }
+        nodes = std::move(model.nodes);
     }
 
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-    void processNode(aiNode *node, const aiScene *scene)
+    static void processNode(aiNode *node, const aiScene *scene, ModelData &model, int parent)
     {
+        ModelNode modelNode;
+        modelNode.name = node->mName.C_Str();
+        // assimp matrices are row major, glm's column major
+        const aiMatrix4x4 &m = node->mTransformation;
+        modelNode.transform = glm::mat4(m.a1, m.b1, m.c1, m.d1, m.a2, m.b2, m.c2, m.d2, m.a3, m.b3, m.c3, m.d3, m.a4, m.b4, m.c4, m.d4);
+        modelNode.parent = parent;
+        modelNode.firstMesh = static_cast<unsigned int>(model.meshes.size());
+        modelNode.meshCount = node->mNumMeshes;
+        int index = static_cast<int>(model.nodes.size());
+        model.nodes.push_back(modelNode);
+
         // process each mesh located at the current node
         for(unsigned int i = 0; i < node->mNumMeshes; i++)
         {
             // the node object only contains indices to index the actual objects in the scene. 
             // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
+            model.meshes.emplace_back();
+            processMesh(mesh, scene, model.meshes.back());
         }
         // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
         for(unsigned int i = 0; i < node->mNumChildren; i++)
         {
-            processNode(node->mChildren[i], scene);
+            processNode(node->mChildren[i], scene, model, index);
         }
 
     }
 
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene)
+    static void processMesh(aiMesh *mesh, const aiScene *scene, ModelData::MeshData &data)
     {
         // data to fill
-        vector<Vertex> vertices;
-        vector<unsigned int> indices;
-        vector<Texture> textures;
+        vector<Vertex> &vertices = data.vertices;
+        vector<unsigned int> &indices = data.indices;
+        vertices.resize(mesh->mNumVertices);
 
         // walk through each of the mesh's vertices
         for(unsigned int i = 0; i < mesh->mNumVertices; i++)
         {
-            Vertex vertex;
-            glm::vec3 vector; // we declare a placeholder vector since assimp uses its own vector class that doesn't directly convert to glm's vec3 class so we transfer the data to this placeholder glm::vec3 first.
+            // zero initialized, so unused fields are deterministic in the cache
+            Vertex &vertex = vertices[i];
+            vertex = Vertex();
             // positions
-            vector.x = mesh->mVertices[i].x;
-            vector.y = mesh->mVertices[i].y;
-            vector.z = mesh->mVertices[i].z;
-            vertex.Position = vector;
+            vertex.Position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
             // normals
             if (mesh->HasNormals())
-            {
-                vector.x = mesh->mNormals[i].x;
-                vector.y = mesh->mNormals[i].y;
-                vector.z = mesh->mNormals[i].z;
-                vertex.Normal = vector;
-            }
+                vertex.Normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
             // texture coordinates
             if(mesh->mTextureCoords[0]) // does the mesh contain texture coordinates?
             {
-                glm::vec2 vec;
                 // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't 
                 // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
-                vec.x = mesh->mTextureCoords[0][i].x; 
-                vec.y = mesh->mTextureCoords[0][i].y;
-                vertex.TexCoords = vec;
+                vertex.TexCoords = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
                 // tangent
-                vector.x = mesh->mTangents[i].x;
-                vector.y = mesh->mTangents[i].y;
-                vector.z = mesh->mTangents[i].z;
-                vertex.Tangent = vector;
+                vertex.Tangent = glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
                 // bitangent
-                vector.x = mesh->mBitangents[i].x;
-                vector.y = mesh->mBitangents[i].y;
-                vector.z = mesh->mBitangents[i].z;
-                vertex.Bitangent = vector;
+                vertex.Bitangent = glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
             }
             else
                 vertex.TexCoords = glm::vec2(0.0f, 0.0f);
-
-            vertices.push_back(vertex);
         }
         // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
+        indices.reserve(mesh->mNumFaces * 3);
         for(unsigned int i = 0; i < mesh->mNumFaces; i++)
         {
-            aiFace face = mesh->mFaces[i];
+            const aiFace &face = mesh->mFaces[i];
             // retrieve all indices of the face and store them in the indices vector
-            for(unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);        
+            indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
         }
         // process materials
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];    
@@ -152,53 +184,50 @@ private:
         // normal: texture_normalN
 
         // 1. diffuse maps
-        vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        collectMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", data.textures);
         // 2. specular maps
-        vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        collectMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", data.textures);
         // 3. normal maps
-        std::vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
-        textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+        collectMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal", data.textures);
         // 4. height maps
-        std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
-        textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
-        
-        // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        collectMaterialTextures(material, aiTextureType_AMBIENT, "texture_height", data.textures);
     }
 
-    // checks all material textures of a given type and loads the textures if they're not loaded yet.
-    // the required info is returned as a Texture struct.
-    vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, string typeName)
+    // appends the paths of all material textures of a given type; they are loaded once the whole model is known.
+    static void collectMaterialTextures(aiMaterial *mat, aiTextureType type, const string &typeName, vector<TextureRef> &textures)
     {
-        vector<Texture> textures;
         for(unsigned int i = 0; i < mat->GetTextureCount(type); i++)
         {
             aiString str;
             mat->GetTexture(type, i, &str);
-            // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++)
+            textures.push_back(TextureRef{typeName, str.C_Str()});
+        }
+    }
+
+    // loads every texture the meshes refer to. Paths are deduplicated up front, the images are decoded
+    // in parallel and uploaded here, and files another Model already loaded are shared through the TextureCache.
+    void loadTextures(const ModelData &model)
+    {
+        vector<string> filenames;
+        for (const ModelData::MeshData &mesh : model.meshes)
+        {
+            for (const TextureRef &ref : mesh.textures)
             {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
+                // the first mesh to use a path decides its sampler type, as before
+                if (textureIndex.emplace(ref.path, textures_loaded.size()).second)
                 {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                    break;
+                    Texture texture;
+                    texture.id = 0;
+                    texture.type = ref.type;
+                    texture.path = ref.path;
+                    textures_loaded.push_back(texture);
+                    filenames.push_back(this->directory + '/' + ref.path);
                 }
             }
-            if(!skip)
-            {   // if texture hasn't been loaded already, load it
-                Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecesery load duplicate textures.
-            }
         }
-        return textures;
+        vector<unsigned int> ids = TextureCache::instance().load(filenames);
+        for (size_t i = 0; i < ids.size(); i++)
+            textures_loaded[textures_loaded.size() - ids.size() + i].id = ids[i];
     }
 };
 
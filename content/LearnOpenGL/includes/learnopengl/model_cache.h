@@ -0,0 +1,391 @@
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/mesh.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// a texture a mesh refers to, before it is loaded into OpenGL
+struct TextureRef {
+    string type;
+    string path;
+};
+
+// one node of the model's scene graph; its meshes are meshes[firstMesh, firstMesh + meshCount)
+struct ModelNode {
+    string       name;
+    glm::mat4    transform;
+    int          parent;     // -1 for the root
+    unsigned int firstMesh;
+    unsigned int meshCount;
+};
+
+// everything the importer produces for a model, without any OpenGL objects
+struct ModelData {
+    struct MeshData {
+        vector<Vertex>       vertices;
+        vector<unsigned int> indices;
+        vector<TextureRef>   textures;
+    };
+    vector<MeshData>  meshes;
+    vector<ModelNode> nodes;
+};
+
+
+// Read-only view of a whole file, memory mapped where the platform allows it.
+class MappedFile
+{
+public:
+    MappedFile() : data(nullptr), size(0)
+#ifdef _WIN32
+        , file(INVALID_HANDLE_VALUE), mapping(NULL)
+#endif
+    {
+    }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string &path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        data = mapping ? static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = static_cast<const unsigned char*>(mapped);
+                size = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd); // the mapping keeps the file alive
+#endif
+        if (!data)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data)
+            munmap(const_cast<unsigned char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const unsigned char *data;
+    size_t size;
+
+private:
+#ifdef _WIN32
+    HANDLE file, mapping;
+#endif
+};
+
+
+// Binary cache of processed models, stored next to the source asset as <asset>.lglcache.
+// It holds the final vertex and index arrays, the texture references of every mesh and
+// the node hierarchy, keyed on a hash of the source file and the Assimp import flags, so
+// a warm start maps the file and hands the arrays to OpenGL without running Assimp.
+// Only the asset file itself is hashed: after editing a material library (.mtl) the
+// cache has to be deleted by hand.
+class ModelCache
+{
+public:
+    // bump whenever the layout below or the import code in Model changes
+    static const uint32_t VERSION = 1;
+
+    static string cachePath(const string &path)
+    {
+        return path + ".lglcache";
+    }
+
+    // hashes the contents of a file; returns false if it cannot be read
+    static bool hashFile(const string &path, uint64_t &hash)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return false;
+        hash = hashBytes(file.data, file.size);
+        return true;
+    }
+
+    // FNV-1a over 64 bit words (bytes for the tail), folded with the length
+    static uint64_t hashBytes(const unsigned char *bytes, size_t size)
+    {
+        const uint64_t prime = 1099511628211ull;
+        uint64_t hash = 14695981039346656037ull ^ size;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, 8);
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; i++)
+            hash = (hash ^ bytes[i]) * prime;
+        return hash;
+    }
+
+    // loads a cache written for the same source hash and import flags; returns false on any mismatch
+    static bool read(const string &path, uint64_t sourceHash, uint32_t importFlags, ModelData &model)
+    {
+        MappedFile file;
+        if (!file.open(path) || file.size < sizeof(Header))
+            return false;
+        Header header;
+        memcpy(&header, file.data, sizeof(Header));
+        if (memcmp(header.magic, "LGMC", 4) != 0 || header.version != VERSION || header.vertexSize != sizeof(Vertex) ||
+            header.sourceHash != sourceHash || header.importFlags != importFlags || header.fileSize != file.size)
+            return false;
+
+        // the tables follow the header, the strings follow the tables
+        size_t meshTable = sizeof(Header);
+        size_t textureTable = meshTable + header.meshCount * sizeof(MeshRecord);
+        size_t nodeTable = textureTable + header.textureCount * sizeof(TextureRecord);
+        size_t strings = nodeTable + header.nodeCount * sizeof(NodeRecord);
+        if (strings + header.stringBytes > file.size)
+            return false;
+        const char *stringData = reinterpret_cast<const char*>(file.data + strings);
+        auto getString = [&](uint32_t offset, uint32_t length, string &out) {
+            if (uint64_t(offset) + length > header.stringBytes)
+                return false;
+            out.assign(stringData + offset, length);
+            return true;
+        };
+
+        model.meshes.resize(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; i++)
+        {
+            MeshRecord mesh;
+            memcpy(&mesh, file.data + meshTable + i * sizeof(MeshRecord), sizeof(MeshRecord));
+            if (mesh.vertexOffset + uint64_t(mesh.vertexCount) * sizeof(Vertex) > file.size ||
+                mesh.indexOffset + uint64_t(mesh.indexCount) * sizeof(unsigned int) > file.size ||
+                uint64_t(mesh.firstTexture) + mesh.textureCount > header.textureCount)
+                return false;
+            // the blobs are 16 byte aligned in a page aligned mapping, so these are straight copies
+            ModelData::MeshData &out = model.meshes[i];
+            const Vertex *vertices = reinterpret_cast<const Vertex*>(file.data + mesh.vertexOffset);
+            const unsigned int *indices = reinterpret_cast<const unsigned int*>(file.data + mesh.indexOffset);
+            out.vertices.assign(vertices, vertices + mesh.vertexCount);
+            out.indices.assign(indices, indices + mesh.indexCount);
+            out.textures.resize(mesh.textureCount);
+            for (uint32_t t = 0; t < mesh.textureCount; t++)
+            {
+                TextureRecord texture;
+                memcpy(&texture, file.data + textureTable + (mesh.firstTexture + t) * sizeof(TextureRecord), sizeof(TextureRecord));
+                if (!getString(texture.typeOffset, texture.typeLength, out.textures[t].type) ||
+                    !getString(texture.pathOffset, texture.pathLength, out.textures[t].path))
+                    return false;
+            }
+        }
+
+        model.nodes.resize(header.nodeCount);
+        for (uint32_t i = 0; i < header.nodeCount; i++)
+        {
+            NodeRecord node;
+            memcpy(&node, file.data + nodeTable + i * sizeof(NodeRecord), sizeof(NodeRecord));
+            ModelNode &out = model.nodes[i];
+            memcpy(&out.transform[0][0], node.transform, sizeof(node.transform));
+            out.parent = node.parent;
+            out.firstMesh = node.firstMesh;
+            out.meshCount = node.meshCount;
+            if (node.parent >= int32_t(i) || uint64_t(node.firstMesh) + node.meshCount > header.meshCount ||
+                !getString(node.nameOffset, node.nameLength, out.name))
+                return false;
+        }
+        return true;
+    }
+
+    // writes the cache to a temporary file first, so an interrupted write never leaves a broken cache behind
+    static bool write(const string &path, uint64_t sourceHash, uint32_t importFlags, const ModelData &model)
+    {
+        Header header = {};
+        memcpy(header.magic, "LGMC", 4);
+        header.version = VERSION;
+        header.vertexSize = sizeof(Vertex);
+        header.importFlags = importFlags;
+        header.sourceHash = sourceHash;
+        header.meshCount = static_cast<uint32_t>(model.meshes.size());
+        header.nodeCount = static_cast<uint32_t>(model.nodes.size());
+
+        string stringData;
+        auto addString = [&](const string &value, uint32_t &offset, uint32_t &length) {
+            offset = static_cast<uint32_t>(stringData.size());
+            length = static_cast<uint32_t>(value.size());
+            stringData += value;
+        };
+
+        vector<MeshRecord> meshRecords(model.meshes.size());
+        vector<TextureRecord> textureRecords;
+        for (size_t i = 0; i < model.meshes.size(); i++)
+        {
+            const ModelData::MeshData &mesh = model.meshes[i];
+            meshRecords[i].vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+            meshRecords[i].indexCount = static_cast<uint32_t>(mesh.indices.size());
+            meshRecords[i].firstTexture = static_cast<uint32_t>(textureRecords.size());
+            meshRecords[i].textureCount = static_cast<uint32_t>(mesh.textures.size());
+            for (const TextureRef &texture : mesh.textures)
+            {
+                TextureRecord record;
+                addString(texture.type, record.typeOffset, record.typeLength);
+                addString(texture.path, record.pathOffset, record.pathLength);
+                textureRecords.push_back(record);
+            }
+        }
+        header.textureCount = static_cast<uint32_t>(textureRecords.size());
+
+        vector<NodeRecord> nodeRecords(model.nodes.size());
+        for (size_t i = 0; i < model.nodes.size(); i++)
+        {
+            const ModelNode &node = model.nodes[i];
+            memcpy(nodeRecords[i].transform, &node.transform[0][0], sizeof(nodeRecords[i].transform));
+            nodeRecords[i].parent = node.parent;
+            nodeRecords[i].firstMesh = node.firstMesh;
+            nodeRecords[i].meshCount = node.meshCount;
+            nodeRecords[i].reserved = 0;
+            addString(node.name, nodeRecords[i].nameOffset, nodeRecords[i].nameLength);
+        }
+        header.stringBytes = static_cast<uint32_t>(stringData.size());
+
+        // lay out the vertex and index blobs after the strings
+        uint64_t offset = sizeof(Header) + meshRecords.size() * sizeof(MeshRecord) + textureRecords.size() * sizeof(TextureRecord) +
+                          nodeRecords.size() * sizeof(NodeRecord) + stringData.size();
+        for (size_t i = 0; i < model.meshes.size(); i++)
+        {
+            offset = align(offset);
+            meshRecords[i].vertexOffset = offset;
+            offset += model.meshes[i].vertices.size() * sizeof(Vertex);
+            offset = align(offset);
+            meshRecords[i].indexOffset = offset;
+            offset += model.meshes[i].indices.size() * sizeof(unsigned int);
+        }
+        header.fileSize = offset;
+
+        string temporary = path + ".tmp";
+        {
+            ofstream out(temporary, ios::binary | ios::trunc);
+            if (!out)
+                return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            out.write(reinterpret_cast<const char*>(meshRecords.data()), meshRecords.size() * sizeof(MeshRecord));
+            out.write(reinterpret_cast<const char*>(textureRecords.data()), textureRecords.size() * sizeof(TextureRecord));
+            out.write(reinterpret_cast<const char*>(nodeRecords.data()), nodeRecords.size() * sizeof(NodeRecord));
+            out.write(stringData.data(), stringData.size());
+            uint64_t written = static_cast<uint64_t>(out.tellp());
+            const char padding[16] = {};
+            for (size_t i = 0; i < model.meshes.size(); i++)
+            {
+                out.write(padding, meshRecords[i].vertexOffset - written);
+                out.write(reinterpret_cast<const char*>(model.meshes[i].vertices.data()), model.meshes[i].vertices.size() * sizeof(Vertex));
+                written = meshRecords[i].vertexOffset + model.meshes[i].vertices.size() * sizeof(Vertex);
+                out.write(padding, meshRecords[i].indexOffset - written);
+                out.write(reinterpret_cast<const char*>(model.meshes[i].indices.data()), model.meshes[i].indices.size() * sizeof(unsigned int));
+                written = meshRecords[i].indexOffset + model.meshes[i].indices.size() * sizeof(unsigned int);
+            }
+            if (!out)
+            {
+                out.close();
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        std::remove(path.c_str()); // rename does not replace existing files on Windows
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    // all records are made of 4 and 8 byte fields ordered so the compiler adds no padding
+    struct Header {
+        char     magic[4];
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t importFlags;
+        uint64_t sourceHash;
+        uint64_t fileSize;
+        uint32_t meshCount;
+        uint32_t textureCount;
+        uint32_t nodeCount;
+        uint32_t stringBytes;
+    };
+    struct MeshRecord {
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t firstTexture;
+        uint32_t textureCount;
+    };
+    struct TextureRecord {
+        uint32_t typeOffset, typeLength;
+        uint32_t pathOffset, pathLength;
+    };
+    struct NodeRecord {
+        float    transform[16];
+        int32_t  parent;
+        uint32_t firstMesh;
+        uint32_t meshCount;
+        uint32_t nameOffset, nameLength;
+        uint32_t reserved;
+    };
+
+    static uint64_t align(uint64_t offset)
+    {
+        return (offset + 15) & ~uint64_t(15);
+    }
+};
+#endif
@@ -0,0 +1,195 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// an image decoded by stb_image, not yet in OpenGL
+struct DecodedImage {
+    unsigned char *data = nullptr;
+    int width = 0, height = 0, nrComponents = 0;
+};
+
+// Process-wide cache of 2D textures loaded from files, keyed on the full file path, so every
+// Model (or anything else) that refers to the same file shares one GL texture.
+// Missing textures are decoded on worker threads while the calling thread, which owns the
+// OpenGL context, uploads them one after the other as they become ready.
+class TextureCache
+{
+public:
+    static TextureCache& instance()
+    {
+        static TextureCache cache;
+        return cache;
+    }
+
+    // returns the GL texture of every file, in order, loading the ones that are not cached yet
+    vector<unsigned int> load(const vector<string> &filenames)
+    {
+        vector<unsigned int> ids(filenames.size(), 0);
+        vector<string> missing;
+        vector<size_t> missingSlot;
+        // hashed lookup, and each missing file is decoded once even if it is listed several times
+        unordered_map<string, size_t> pending;
+        for (size_t i = 0; i < filenames.size(); i++)
+        {
+            auto cached = textures.find(filenames[i]);
+            if (cached != textures.end())
+            {
+                ids[i] = cached->second;
+                continue;
+            }
+            auto queued = pending.emplace(filenames[i], missing.size());
+            if (queued.second)
+                missing.push_back(filenames[i]);
+            missingSlot.push_back(i);
+        }
+        if (missing.empty())
+            return ids;
+
+        vector<unsigned int> created(missing.size());
+        glGenTextures(static_cast<GLsizei>(created.size()), created.data());
+        decode(missing, 0, [&](size_t i, DecodedImage &image) {
+            upload(created[i], image, missing[i]);
+            textures[missing[i]] = created[i];
+        });
+        for (size_t slot : missingSlot)
+            ids[slot] = created[pending[filenames[slot]]];
+        return ids;
+    }
+
+    // deletes every cached texture; textures still referenced elsewhere become invalid
+    void clear()
+    {
+        for (auto &texture : textures)
+            glDeleteTextures(1, &texture.second);
+        textures.clear();
+    }
+
+    size_t size() const { return textures.size(); }
+
+    // Decodes the files with stb_image on worker threads (0 = one per hardware thread) and hands
+    // every image to consume on the calling thread, in file order. consume owns the pixels and
+    // has to stbi_image_free them. Only a few images run ahead of consume, so memory stays bounded
+    // however many files there are. A file that fails to decode is passed with data == nullptr.
+    // stb_image's global settings (e.g. flipping on load) must not change while this runs.
+    // Without STBI_THREADS stb_image cannot be prepared for threads, so the files are decoded in turn.
+    // As with stbi_load_batch, stbi_failure_reason is shared by the workers.
+    static void decode(const vector<string> &filenames, unsigned int threadCount, const function<void(size_t, DecodedImage&)> &consume)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, thread::hardware_concurrency());
+        threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, filenames.size()));
+#ifdef STBI_THREADS
+        if (threadCount > 1)
+            stbi_init_threads(); // the lazily built zlib tables are not thread safe
+#else
+        threadCount = 1;
+#endif
+        if (threadCount <= 1)
+        {
+            for (size_t i = 0; i < filenames.size(); i++)
+            {
+                DecodedImage image;
+                image.data = stbi_load(filenames[i].c_str(), &image.width, &image.height, &image.nrComponents, 0);
+                consume(i, image);
+            }
+            return;
+        }
+
+        const size_t window = threadCount * 2; // decoded images allowed to wait for consume
+        vector<DecodedImage> images(filenames.size());
+        vector<char> ready(filenames.size(), 0);
+        size_t next = 0, consumed = 0;
+        mutex lock;
+        condition_variable changed;
+
+        auto worker = [&]() {
+            unique_lock<mutex> guard(lock);
+            for (;;)
+            {
+                changed.wait(guard, [&] { return next >= filenames.size() || next < consumed + window; });
+                if (next >= filenames.size())
+                    return;
+                size_t i = next++;
+                guard.unlock();
+                DecodedImage image;
+                image.data = stbi_load(filenames[i].c_str(), &image.width, &image.height, &image.nrComponents, 0);
+                guard.lock();
+                images[i] = image;
+                ready[i] = 1;
+                changed.notify_all();
+            }
+        };
+        vector<thread> workers;
+        for (unsigned int t = 0; t < threadCount; t++)
+            workers.emplace_back(worker);
+
+        for (size_t i = 0; i < filenames.size(); i++)
+        {
+            DecodedImage image;
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&] { return ready[i] != 0; });
+                image = images[i];
+            }
+            consume(i, image);
+            {
+                lock_guard<mutex> guard(lock);
+                consumed = i + 1;
+            }
+            changed.notify_all();
+        }
+        for (thread &t : workers)
+            t.join();
+    }
+
+private:
+    unordered_map<string, unsigned int> textures;
+
+    TextureCache() {}
+
+    static void upload(unsigned int textureID, DecodedImage &image, const string &filename)
+    {
+        if (image.data)
+        {
+            GLenum format = GL_RGBA;
+            if (image.nrComponents == 1)
+                format = GL_RED;
+            else if (image.nrComponents == 2)
+                format = GL_RG;
+            else if (image.nrComponents == 3)
+                format = GL_RGB;
+            else if (image.nrComponents == 4)
+                format = GL_RGBA;
+
+            glBindTexture(GL_TEXTURE_2D, textureID);
+            glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+            glGenerateMipmap(GL_TEXTURE_2D);
+
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        }
+        else
+        {
+            std::cout << "Texture failed to load at path: " << filename << std::endl;
+        }
+        stbi_image_free(image.data);
+        image.data = nullptr;
+    }
+};
+#endif
@@ -0,0 +1,403 @@
+#ifndef VERTEX_COMPRESSION_H
+#define VERTEX_COMPRESSION_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <learnopengl/vertex.h>
+using namespace std;
+
+// How each part of a Vertex is stored on the GPU. The defaults keep the full 32 bit
+// float layout, so meshes look exactly as before unless a compact format is asked for.
+//
+// The compact formats have to be decoded in the vertex shader; VERTEX_DECODE_GLSL below has
+// the uniforms and functions for it. Attribute locations stay the same as the full layout:
+//   0 position   vec3, or unorm16 x4 within the mesh's bounding box (positionOffset + positionScale * p.xyz)
+//   1 normal     vec3, or octahedral snorm16 x2 (decodeOctahedral)
+//   2 texcoords  vec2, half x2, or unorm16 x2 within the mesh's uv range (uvOffset + uvScale * uv)
+//   3 tangent    vec3, or octahedral snorm8 x2 + bitangent sign (z) in one snorm8 x4
+//   4 bitangent  vec3, or absent: cross(normal, tangent) * sign
+//   5 bone ids   int x4, or uint8 x4 (no bone = 255, which is past MAX_BONES)
+//   6 weights    float x4, or unorm8 x4 summing to 255
+struct VertexCompression {
+    enum PositionFormat { POSITION_FLOAT, POSITION_UNORM16 };
+    enum TexCoordFormat { TEXCOORD_FLOAT, TEXCOORD_HALF, TEXCOORD_UNORM16 };
+    enum FrameFormat    { FRAME_FLOAT, FRAME_OCTAHEDRAL };
+    enum SkinFormat     { SKIN_NONE, SKIN_FULL, SKIN_BYTE };
+
+    PositionFormat position = POSITION_FLOAT;
+    TexCoordFormat texCoords = TEXCOORD_FLOAT;
+    FrameFormat    frame = FRAME_FLOAT;
+    SkinFormat     skin = SKIN_FULL;
+
+    // everything quantized: 20 bytes per static vertex, 28 with bones
+    static VertexCompression compact(bool skinned = false)
+    {
+        VertexCompression compression;
+        compression.position = POSITION_UNORM16;
+        compression.texCoords = TEXCOORD_HALF;
+        compression.frame = FRAME_OCTAHEDRAL;
+        compression.skin = skinned ? SKIN_BYTE : SKIN_NONE;
+        return compression;
+    }
+
+    bool isFull() const
+    {
+        return position == POSITION_FLOAT && texCoords == TEXCOORD_FLOAT && frame == FRAME_FLOAT && skin == SKIN_FULL;
+    }
+};
+
+// one glVertexAttrib(I)Pointer call
+struct VertexAttribute {
+    GLuint    location;
+    GLint     size;
+    GLenum    type;
+    GLboolean normalized;
+    bool      integer;
+    GLuint    offset;
+};
+
+// vertex data encoded for one mesh, with what is needed to set up and decode it
+struct EncodedVertices {
+    VertexCompression       compression;    // what was actually used (see encodeVertices)
+    vector<VertexAttribute> attributes;
+    GLsizei                 stride = 0;
+    vector<unsigned char>   data;
+    glm::vec3 positionOffset = glm::vec3(0.0f), positionScale = glm::vec3(1.0f);
+    glm::vec2 uvOffset = glm::vec2(0.0f), uvScale = glm::vec2(1.0f);
+};
+
+// uniforms and functions compact meshes need in their vertex shader
+static const char * const VERTEX_DECODE_GLSL = R"(
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+uniform vec2 uvOffset;
+uniform vec2 uvScale;
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+)";
+
+// octahedral mapping of a unit vector onto [-1, 1]^2
+inline glm::vec2 octahedralEncode(glm::vec3 n)
+{
+    float length = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (length <= 0.0f)
+        return glm::vec2(0.0f); // no direction (e.g. a mesh without tangents) decodes to +z
+    n /= length;
+    glm::vec2 p(n.x, n.y);
+    if (n.z < 0.0f)
+    {
+        glm::vec2 folded = (1.0f - glm::abs(glm::vec2(p.y, p.x)));
+        p = glm::vec2(p.x >= 0.0f ? folded.x : -folded.x, p.y >= 0.0f ? folded.y : -folded.y);
+    }
+    return p;
+}
+
+inline glm::vec3 octahedralDecode(glm::vec2 e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+// quantizes to signed normalized integers of the given maximum (127 or 32767), trying the four
+// neighbouring grid points and keeping the one that decodes closest to n
+inline glm::ivec2 octahedralQuantize(const glm::vec3 &n, float maximum)
+{
+    glm::vec2 p = octahedralEncode(n) * maximum;
+    glm::ivec2 best(0);
+    float bestError = -2.0f;
+    for (int i = 0; i < 4; i++)
+    {
+        glm::ivec2 candidate(static_cast<int>((i & 1) ? std::ceil(p.x) : std::floor(p.x)), static_cast<int>((i & 2) ? std::ceil(p.y) : std::floor(p.y)));
+        candidate = glm::clamp(candidate, glm::ivec2(-static_cast<int>(maximum)), glm::ivec2(static_cast<int>(maximum)));
+        float error = glm::dot(octahedralDecode(glm::vec2(candidate) / maximum), n); // cosine, larger is better
+        if (error > bestError)
+        {
+            bestError = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// the attribute setup of a layout; the full layout matches Vertex byte for byte
+inline vector<VertexAttribute> vertexAttributes(const VertexCompression &compression, GLsizei &stride)
+{
+    vector<VertexAttribute> attributes;
+    GLuint offset = 0;
+    auto add = [&](GLuint location, GLint size, GLenum type, GLboolean normalized, bool integer, GLuint bytes) {
+        attributes.push_back(VertexAttribute{location, size, type, normalized, integer, offset});
+        offset += bytes;
+    };
+    if (compression.position == VertexCompression::POSITION_UNORM16)
+        add(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, false, 8); // w is padding, keeps the next attribute 4 byte aligned
+    else
+        add(0, 3, GL_FLOAT, GL_FALSE, false, 12);
+    if (compression.frame == VertexCompression::FRAME_OCTAHEDRAL)
+        add(1, 2, GL_SHORT, GL_TRUE, false, 4);
+    else
+        add(1, 3, GL_FLOAT, GL_FALSE, false, 12);
+    if (compression.texCoords == VertexCompression::TEXCOORD_HALF)
+        add(2, 2, GL_HALF_FLOAT, GL_FALSE, false, 4);
+    else if (compression.texCoords == VertexCompression::TEXCOORD_UNORM16)
+        add(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, false, 4);
+    else
+        add(2, 2, GL_FLOAT, GL_FALSE, false, 8);
+    if (compression.frame == VertexCompression::FRAME_OCTAHEDRAL)
+        add(3, 4, GL_BYTE, GL_TRUE, false, 4);
+    else
+    {
+        add(3, 3, GL_FLOAT, GL_FALSE, false, 12);
+        add(4, 3, GL_FLOAT, GL_FALSE, false, 12);
+    }
+    if (compression.skin == VertexCompression::SKIN_BYTE)
+    {
+        add(5, 4, GL_UNSIGNED_BYTE, GL_FALSE, true, 4);
+        add(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, false, 4);
+    }
+    else if (compression.skin == VertexCompression::SKIN_FULL)
+    {
+        add(5, 4, GL_INT, GL_FALSE, true, 16);
+        add(6, 4, GL_FLOAT, GL_FALSE, false, 16);
+    }
+    stride = static_cast<GLsizei>(offset);
+    return attributes;
+}
+
+// Encodes the vertices of one mesh. SKIN_BYTE falls back to SKIN_FULL when a bone id does not fit in a byte.
+inline EncodedVertices encodeVertices(const vector<Vertex> &vertices, VertexCompression compression)
+{
+    EncodedVertices encoded;
+    if (compression.skin == VertexCompression::SKIN_BYTE)
+    {
+        for (const Vertex &vertex : vertices)
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                if (vertex.m_BoneIDs[i] < -1 || vertex.m_BoneIDs[i] >= 255)
+                    compression.skin = VertexCompression::SKIN_FULL;
+    }
+    encoded.compression = compression;
+    encoded.attributes = vertexAttributes(compression, encoded.stride);
+    encoded.data.resize(vertices.size() * encoded.stride);
+    if (compression.isFull())
+    {
+        if (!vertices.empty())
+            memcpy(encoded.data.data(), vertices.data(), encoded.data.size());
+        return encoded;
+    }
+
+    // quantization ranges of this mesh
+    if (!vertices.empty())
+    {
+        glm::vec3 low(vertices[0].Position), high(vertices[0].Position);
+        glm::vec2 uvLow(vertices[0].TexCoords), uvHigh(vertices[0].TexCoords);
+        for (const Vertex &vertex : vertices)
+        {
+            low = glm::min(low, vertex.Position);
+            high = glm::max(high, vertex.Position);
+            uvLow = glm::min(uvLow, vertex.TexCoords);
+            uvHigh = glm::max(uvHigh, vertex.TexCoords);
+        }
+        encoded.positionOffset = low;
+        encoded.positionScale = glm::max(high - low, glm::vec3(1e-20f));
+        encoded.uvOffset = uvLow;
+        encoded.uvScale = glm::max(uvHigh - uvLow, glm::vec2(1e-20f));
+    }
+
+    for (size_t v = 0; v < vertices.size(); v++)
+    {
+        const Vertex &vertex = vertices[v];
+        unsigned char *out = &encoded.data[v * encoded.stride];
+        for (const VertexAttribute &attribute : encoded.attributes)
+        {
+            unsigned char *field = out + attribute.offset;
+            switch (attribute.location)
+            {
+            case 0:
+                if (attribute.type == GL_UNSIGNED_SHORT)
+                {
+                    glm::vec3 unit = (vertex.Position - encoded.positionOffset) / encoded.positionScale;
+                    uint16_t q[4] = { glm::packUnorm1x16(unit.x), glm::packUnorm1x16(unit.y), glm::packUnorm1x16(unit.z), 0 };
+                    memcpy(field, q, sizeof(q));
+                }
+                else
+                    memcpy(field, &vertex.Position, 12);
+                break;
+            case 1:
+                if (attribute.type == GL_SHORT)
+                {
+                    glm::ivec2 e = octahedralQuantize(vertex.Normal, 32767.0f);
+                    int16_t q[2] = { static_cast<int16_t>(e.x), static_cast<int16_t>(e.y) };
+                    memcpy(field, q, sizeof(q));
+                }
+                else
+                    memcpy(field, &vertex.Normal, 12);
+                break;
+            case 2:
+                if (attribute.type == GL_HALF_FLOAT)
+                {
+                    uint16_t q[2] = { glm::packHalf1x16(vertex.TexCoords.x), glm::packHalf1x16(vertex.TexCoords.y) };
+                    memcpy(field, q, sizeof(q));
+                }
+                else if (attribute.type == GL_UNSIGNED_SHORT)
+                {
+                    glm::vec2 unit = (vertex.TexCoords - encoded.uvOffset) / encoded.uvScale;
+                    uint16_t q[2] = { glm::packUnorm1x16(unit.x), glm::packUnorm1x16(unit.y) };
+                    memcpy(field, q, sizeof(q));
+                }
+                else
+                    memcpy(field, &vertex.TexCoords, 8);
+                break;
+            case 3:
+                if (attribute.type == GL_BYTE)
+                {
+                    glm::ivec2 e = octahedralQuantize(vertex.Tangent, 127.0f);
+                    // handedness of the tangent frame, so the bitangent can be rebuilt from normal and tangent
+                    bool flipped = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f;
+                    int8_t q[4] = { static_cast<int8_t>(e.x), static_cast<int8_t>(e.y), static_cast<int8_t>(flipped ? -127 : 127), 0 };
+                    memcpy(field, q, sizeof(q));
+                }
+                else
+                    memcpy(field, &vertex.Tangent, 12);
+                break;
+            case 4:
+                memcpy(field, &vertex.Bitangent, 12);
+                break;
+            case 5:
+                if (attribute.type == GL_UNSIGNED_BYTE)
+                {
+                    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                        field[i] = static_cast<unsigned char>(vertex.m_BoneIDs[i] < 0 ? 255 : vertex.m_BoneIDs[i]);
+                }
+                else
+                    memcpy(field, vertex.m_BoneIDs, 16);
+                break;
+            case 6:
+                if (attribute.type == GL_UNSIGNED_BYTE)
+                {
+                    // round, then hand the rounding error to the largest weight so the weights still sum to one
+                    int sum = 0, largest = 0;
+                    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                    {
+                        field[i] = static_cast<unsigned char>(std::lround(glm::clamp(vertex.m_Weights[i], 0.0f, 1.0f) * 255.0f));
+                        sum += field[i];
+                        if (vertex.m_Weights[i] > vertex.m_Weights[largest])
+                            largest = i;
+                    }
+                    if (sum > 0)
+                        field[largest] = static_cast<unsigned char>(glm::clamp(field[largest] + 255 - sum, 0, 255));
+                }
+                else
+                    memcpy(field, vertex.m_Weights, 16);
+                break;
+            }
+        }
+    }
+    return encoded;
+}
+
+// CPU mirror of the shader side decode, for tests and reports
+inline void decodeVertex(const EncodedVertices &encoded, size_t index, Vertex &vertex)
+{
+    vertex = Vertex();
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+        vertex.m_BoneIDs[i] = -1;
+    const unsigned char *in = &encoded.data[index * encoded.stride];
+    bool flipped = false;
+    for (const VertexAttribute &attribute : encoded.attributes)
+    {
+        const unsigned char *field = in + attribute.offset;
+        switch (attribute.location)
+        {
+        case 0:
+            if (attribute.type == GL_UNSIGNED_SHORT)
+            {
+                uint16_t q[4];
+                memcpy(q, field, sizeof(q));
+                glm::vec3 unit(glm::unpackUnorm1x16(q[0]), glm::unpackUnorm1x16(q[1]), glm::unpackUnorm1x16(q[2]));
+                vertex.Position = encoded.positionOffset + encoded.positionScale * unit;
+            }
+            else
+                memcpy(&vertex.Position, field, 12);
+            break;
+        case 1:
+            if (attribute.type == GL_SHORT)
+            {
+                int16_t q[2];
+                memcpy(q, field, sizeof(q));
+                vertex.Normal = octahedralDecode(glm::max(glm::vec2(q[0], q[1]) / 32767.0f, glm::vec2(-1.0f)));
+            }
+            else
+                memcpy(&vertex.Normal, field, 12);
+            break;
+        case 2:
+            if (attribute.type == GL_HALF_FLOAT)
+            {
+                uint16_t q[2];
+                memcpy(q, field, sizeof(q));
+                vertex.TexCoords = glm::vec2(glm::unpackHalf1x16(q[0]), glm::unpackHalf1x16(q[1]));
+            }
+            else if (attribute.type == GL_UNSIGNED_SHORT)
+            {
+                uint16_t q[2];
+                memcpy(q, field, sizeof(q));
+                vertex.TexCoords = encoded.uvOffset + encoded.uvScale * glm::vec2(glm::unpackUnorm1x16(q[0]), glm::unpackUnorm1x16(q[1]));
+            }
+            else
+                memcpy(&vertex.TexCoords, field, 8);
+            break;
+        case 3:
+            if (attribute.type == GL_BYTE)
+            {
+                int8_t q[4];
+                memcpy(q, field, sizeof(q));
+                vertex.Tangent = octahedralDecode(glm::max(glm::vec2(q[0], q[1]) / 127.0f, glm::vec2(-1.0f)));
+                flipped = q[2] < 0;
+            }
+            else
+                memcpy(&vertex.Tangent, field, 12);
+            break;
+        case 4:
+            memcpy(&vertex.Bitangent, field, 12);
+            break;
+        case 5:
+            if (attribute.type == GL_UNSIGNED_BYTE)
+            {
+                for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                    vertex.m_BoneIDs[i] = field[i] == 255 ? -1 : field[i];
+            }
+            else
+                memcpy(vertex.m_BoneIDs, field, 16);
+            break;
+        case 6:
+            if (attribute.type == GL_UNSIGNED_BYTE)
+            {
+                for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                    vertex.m_Weights[i] = field[i] / 255.0f;
+            }
+            else
+                memcpy(vertex.m_Weights, field, 16);
+            break;
+        }
+    }
+    if (encoded.compression.frame == VertexCompression::FRAME_OCTAHEDRAL)
+        vertex.Bitangent = glm::cross(vertex.Normal, vertex.Tangent) * (flipped ? -1.0f : 1.0f);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include <learnopengl/filesystem.h>
+#include <learnopengl/model.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+// Headless benchmark of the processed-model cache: compares importing a model
+// with ASSIMP (a cold start) against mapping its binary cache (a warm start).
+// Neither path creates a window or OpenGL context, so the numbers are the
+// CPU time Model spends before it uploads the meshes.
+//
+// usage: model_cache_benchmark [model path] [repetitions]
+
+static double elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    string path = argc > 1 ? argv[1] : FileSystem::getPath("resources/objects/nanosuit/nanosuit.obj");
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+    string cachePath = path + ".benchmark.lglcache"; // leave the cache Model itself uses alone
+
+    uint64_t hash = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!ModelCache::hashFile(path, hash))
+    {
+        std::cout << "cannot read " << path << std::endl;
+        return 1;
+    }
+    double hashTime = elapsedMs(start);
+
+    double coldTime = 0.0, warmTime = 0.0, writeTime = 0.0;
+    size_t meshCount = 0, vertexCount = 0, indexCount = 0, nodeCount = 0;
+    for (int i = 0; i < repetitions; i++)
+    {
+        // cold: ASSIMP import with triangulation and tangent generation
+        ModelData imported;
+        start = std::chrono::high_resolution_clock::now();
+        if (!Model::importModel(path, imported))
+            return 1;
+        coldTime += elapsedMs(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        if (!ModelCache::write(cachePath, hash, Model::IMPORT_FLAGS, imported))
+        {
+            std::cout << "cannot write " << cachePath << std::endl;
+            return 1;
+        }
+        writeTime += elapsedMs(start);
+
+        // warm: hash the source again (as Model does) and read the cache
+        ModelData cached;
+        start = std::chrono::high_resolution_clock::now();
+        uint64_t warmHash = 0;
+        if (!ModelCache::hashFile(path, warmHash) || !ModelCache::read(cachePath, warmHash, Model::IMPORT_FLAGS, cached))
+        {
+            std::cout << "cache was not accepted" << std::endl;
+            return 1;
+        }
+        warmTime += elapsedMs(start);
+
+        // the cache has to give back exactly what the importer produced
+        vertexCount = indexCount = 0;
+        bool same = cached.meshes.size() == imported.meshes.size() && cached.nodes.size() == imported.nodes.size();
+        for (size_t m = 0; same && m < cached.meshes.size(); m++)
+        {
+            const ModelData::MeshData &a = imported.meshes[m], &b = cached.meshes[m];
+            same = a.vertices.size() == b.vertices.size() && a.indices == b.indices && a.textures.size() == b.textures.size() &&
+                   memcmp(a.vertices.data(), b.vertices.data(), a.vertices.size() * sizeof(Vertex)) == 0;
+            vertexCount += b.vertices.size();
+            indexCount += b.indices.size();
+        }
+        meshCount = cached.meshes.size();
+        nodeCount = cached.nodes.size();
+        if (!same)
+        {
+            std::cout << "cached model differs from the imported one" << std::endl;
+            return 1;
+        }
+    }
+    // a different import configuration must not hit the cache
+    ModelData stale;
+    if (ModelCache::read(cachePath, hash, Model::IMPORT_FLAGS ^ aiProcess_FlipUVs, stale))
+    {
+        std::cout << "cache accepted for other import flags" << std::endl;
+        return 1;
+    }
+    std::remove(cachePath.c_str());
+
+    std::cout << path << std::endl;
+    std::cout << "  meshes " << meshCount << ", nodes " << nodeCount << ", vertices " << vertexCount << ", indices " << indexCount << std::endl;
+    std::cout << "  hash source     " << hashTime << " ms" << std::endl;
+    std::cout << "  assimp (cold)   " << coldTime / repetitions << " ms" << std::endl;
+    std::cout << "  write cache     " << writeTime / repetitions << " ms" << std::endl;
+    std::cout << "  cache (warm)    " << warmTime / repetitions << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <learnopengl/filesystem.h>
+#include <learnopengl/texture_cache.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+// Headless benchmark of the decode phase of model texture loading: every image
+// in a directory is decoded with stb_image on one thread and then on a worker
+// per hardware thread, the way TextureCache does it before uploading. No window
+// or OpenGL context is created.
+//
+// usage: texture_decode_benchmark [image directory] [repetitions]
+
+static double decodeAll(const vector<string> &files, unsigned int threads, size_t &bytes)
+{
+    bytes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    TextureCache::decode(files, threads, [&](size_t, DecodedImage &image) {
+        bytes += size_t(image.width) * image.height * image.nrComponents;
+        stbi_image_free(image.data);
+    });
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    string directory = argc > 1 ? argv[1] : FileSystem::getPath("resources/objects/nanosuit");
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    vector<string> files;
+    for (const auto &entry : std::filesystem::directory_iterator(directory))
+    {
+        string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp")
+            files.push_back(entry.path().string());
+    }
+    if (files.empty())
+    {
+        std::cout << "no images in " << directory << std::endl;
+        return 1;
+    }
+
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    double serial = 0.0, parallel = 0.0;
+    size_t serialBytes = 0, parallelBytes = 0;
+    for (int i = 0; i < repetitions; i++)
+    {
+        serial += decodeAll(files, 1, serialBytes);
+        parallel += decodeAll(files, threads, parallelBytes);
+    }
+    if (serialBytes != parallelBytes)
+    {
+        std::cout << "decoded sizes differ: " << serialBytes << " / " << parallelBytes << std::endl;
+        return 1;
+    }
+
+    std::cout << files.size() << " images, " << serialBytes / (1024.0 * 1024.0) << " MB decoded" << std::endl;
+    std::cout << "  1 thread        " << serial / repetitions << " ms" << std::endl;
+    std::cout << "  " << threads << " threads       " << parallel / repetitions << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <learnopengl/filesystem.h>
+#include <learnopengl/model.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// Headless check of the compact vertex formats in vertex_compression.h: every
+// format is encoded and decoded on the CPU (the same math the vertex shader
+// does) and compared against the original vertices, first on random data and
+// then on the bundled models, reporting the vertex memory of each format.
+// Returns non-zero if any error exceeds the bound expected for its format.
+//
+// usage: vertex_compression_report [model paths...]
+
+struct Errors {
+    float position = 0.0f;   // relative to the mesh's bounding box diagonal
+    float normal = 0.0f;     // degrees
+    float tangent = 0.0f;    // degrees
+    float bitangent = 0.0f;  // degrees
+    float texCoords = 0.0f;  // absolute
+    float weights = 0.0f;    // absolute
+    bool boneIds = true;
+};
+
+static float angleDegrees(const glm::vec3 &a, const glm::vec3 &b)
+{
+    float la = glm::length(a), lb = glm::length(b);
+    if (la < 1e-6f || lb < 1e-6f)
+        return 0.0f; // no direction to compare (e.g. meshes without tangents)
+    // atan2 keeps its precision for tiny angles, where acos of a float dot product does not
+    return glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+}
+
+static void measure(const vector<Vertex> &vertices, const EncodedVertices &encoded, Errors &errors)
+{
+    glm::vec3 low(1e30f), high(-1e30f);
+    for (const Vertex &vertex : vertices)
+    {
+        low = glm::min(low, vertex.Position);
+        high = glm::max(high, vertex.Position);
+    }
+    float diagonal = std::max(glm::length(high - low), 1e-20f);
+    Vertex decoded;
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Vertex &original = vertices[i];
+        decodeVertex(encoded, i, decoded);
+        errors.position = std::max(errors.position, glm::length(decoded.Position - original.Position) / diagonal);
+        errors.normal = std::max(errors.normal, angleDegrees(decoded.Normal, original.Normal));
+        errors.tangent = std::max(errors.tangent, angleDegrees(decoded.Tangent, original.Tangent));
+        // the rebuilt bitangent can only follow the original if that was orthogonal to normal and tangent
+        glm::vec3 orthogonal = glm::cross(original.Normal, original.Tangent) * (glm::dot(glm::cross(original.Normal, original.Tangent), original.Bitangent) < 0.0f ? -1.0f : 1.0f);
+        errors.bitangent = std::max(errors.bitangent, angleDegrees(decoded.Bitangent, encoded.compression.frame == VertexCompression::FRAME_OCTAHEDRAL ? orthogonal : original.Bitangent));
+        errors.texCoords = std::max(errors.texCoords, glm::length(decoded.TexCoords - original.TexCoords) / std::max(1.0f, glm::length(original.TexCoords)));
+        if (encoded.compression.skin != VertexCompression::SKIN_NONE)
+        {
+            for (int b = 0; b < MAX_BONE_INFLUENCE; b++)
+            {
+                errors.weights = std::max(errors.weights, std::abs(decoded.m_Weights[b] - original.m_Weights[b]));
+                errors.boneIds = errors.boneIds && (decoded.m_BoneIDs[b] == original.m_BoneIDs[b] || (original.m_BoneIDs[b] < 0 && decoded.m_BoneIDs[b] < 0));
+            }
+        }
+    }
+}
+
+// the largest error each format may show
+static bool withinBounds(const VertexCompression &compression, const Errors &errors)
+{
+    bool ok = errors.boneIds;
+    ok = ok && errors.position <= (compression.position == VertexCompression::POSITION_UNORM16 ? 2e-5f : 0.0f);
+    ok = ok && errors.normal <= (compression.frame == VertexCompression::FRAME_OCTAHEDRAL ? 0.01f : 0.0f);
+    ok = ok && errors.tangent <= (compression.frame == VertexCompression::FRAME_OCTAHEDRAL ? 1.0f : 0.0f);
+    ok = ok && errors.bitangent <= (compression.frame == VertexCompression::FRAME_OCTAHEDRAL ? 1.0f : 0.0f);
+    ok = ok && errors.texCoords <= (compression.texCoords == VertexCompression::TEXCOORD_FLOAT ? 0.0f : 1e-3f);
+    ok = ok && errors.weights <= (compression.skin == VertexCompression::SKIN_BYTE ? 2.0f / 255.0f : 0.0f);
+    return ok;
+}
+
+static vector<Vertex> randomVertices(size_t count)
+{
+    std::mt19937 random(1234);
+    std::normal_distribution<float> gaussian;
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    auto direction = [&]() { return glm::normalize(glm::vec3(gaussian(random), gaussian(random), gaussian(random))); };
+    vector<Vertex> vertices(count);
+    for (Vertex &vertex : vertices)
+    {
+        vertex = Vertex();
+        vertex.Position = glm::vec3(uniform(random) * 200.0f - 100.0f, uniform(random) * 10.0f, uniform(random) * 50.0f);
+        vertex.Normal = direction();
+        // an orthonormal frame of either handedness
+        vertex.Tangent = glm::normalize(glm::cross(vertex.Normal, direction()));
+        vertex.Bitangent = glm::cross(vertex.Normal, vertex.Tangent) * (uniform(random) < 0.5f ? -1.0f : 1.0f);
+        vertex.TexCoords = glm::vec2(uniform(random) * 4.0f - 2.0f, uniform(random));
+        float total = 0.0f;
+        for (int b = 0; b < MAX_BONE_INFLUENCE; b++)
+        {
+            vertex.m_BoneIDs[b] = b < 3 ? static_cast<int>(uniform(random) * 100.0f) : -1;
+            vertex.m_Weights[b] = b < 3 ? uniform(random) : 0.0f;
+            total += vertex.m_Weights[b];
+        }
+        for (int b = 0; b < MAX_BONE_INFLUENCE; b++)
+            vertex.m_Weights[b] /= total;
+    }
+    return vertices;
+}
+
+struct Format {
+    const char *name;
+    VertexCompression compression;
+};
+
+static vector<Format> formats()
+{
+    VertexCompression unormUVs = VertexCompression::compact();
+    unormUVs.texCoords = VertexCompression::TEXCOORD_UNORM16;
+    VertexCompression staticFull;
+    staticFull.skin = VertexCompression::SKIN_NONE;
+    return {
+        { "full", VertexCompression() },
+        { "full static", staticFull },
+        { "compact", VertexCompression::compact() },
+        { "compact unorm uv", unormUVs },
+        { "compact skinned", VertexCompression::compact(true) },
+    };
+}
+
+static bool report(const string &name, const vector<vector<Vertex>> &meshes)
+{
+    bool ok = true;
+    size_t vertexCount = 0;
+    for (const vector<Vertex> &mesh : meshes)
+        vertexCount += mesh.size();
+    std::cout << name << " (" << meshes.size() << " meshes, " << vertexCount << " vertices)" << std::endl;
+    size_t fullBytes = 0;
+    for (const Format &format : formats())
+    {
+        Errors errors;
+        size_t bytes = 0;
+        GLsizei stride = 0;
+        for (const vector<Vertex> &mesh : meshes)
+        {
+            EncodedVertices encoded = encodeVertices(mesh, format.compression);
+            bytes += encoded.data.size();
+            stride = encoded.stride;
+            measure(mesh, encoded, errors);
+        }
+        if (fullBytes == 0)
+            fullBytes = bytes;
+        bool passed = withinBounds(format.compression, errors);
+        ok = ok && passed;
+        std::cout << "  " << std::left << std::setw(18) << format.name << std::right << std::setw(4) << stride << " B/vertex"
+                  << std::setw(10) << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) << " MB"
+                  << std::setw(7) << std::setprecision(2) << double(fullBytes) / std::max<size_t>(bytes, 1) << "x"
+                  << std::scientific << std::setprecision(1)
+                  << "  pos " << errors.position << "  uv " << errors.texCoords
+                  << std::fixed << std::setprecision(3)
+                  << "  normal " << errors.normal << " deg  tangent " << errors.tangent << " deg  weights " << errors.weights
+                  << (passed ? "" : "  FAILED") << std::endl;
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    bool ok = report("random vertices", { randomVertices(100000) });
+
+    vector<string> paths;
+    for (int i = 1; i < argc; i++)
+        paths.push_back(argv[i]);
+    if (paths.empty())
+    {
+        for (const char *model : { "nanosuit/nanosuit.obj", "cyborg/cyborg.obj", "planet/planet.obj", "rock/rock.obj" })
+            paths.push_back(FileSystem::getPath(string("resources/objects/") + model));
+    }
+    for (const string &path : paths)
+    {
+        ModelData model;
+        if (!Model::importModel(path, model))
+            continue;
+        vector<vector<Vertex>> meshes;
+        for (ModelData::MeshData &mesh : model.meshes)
+            meshes.push_back(std::move(mesh.vertices));
+        ok = report(path, meshes) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include <learnopengl/filesystem.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless benchmark of PNG decoding in the bundled stb_image: every PNG under
+// a directory (the tutorial textures by default) is read into memory once and
+// decoded from there on one thread, so the time is inflate plus unfiltering
+// without the disk. The files are then decoded again through stbi_load_batch
+// on a worker per hardware thread. Returns non-zero if any image fails to
+// decode or the batch does not produce the same pixels.
+//
+// usage: png_decode_benchmark [image directory] [repetitions]
+
+using std::string;
+using std::vector;
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    string directory = argc > 1 ? argv[1] : FileSystem::getPath("resources/textures");
+    int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    vector<string> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(directory))
+    {
+        string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == ".png")
+            files.push_back(entry.path().string());
+    }
+    if (files.empty())
+    {
+        std::cout << "no PNG files in " << directory << std::endl;
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    vector<vector<stbi_uc>> encoded;
+    size_t encodedBytes = 0;
+    for (const string &file : files)
+    {
+        std::ifstream in(file, std::ios::binary);
+        encoded.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        encodedBytes += encoded.back().size();
+    }
+
+    // keep the first decode of each file to compare the batch against
+    vector<vector<stbi_uc>> pixels(files.size());
+    size_t decodedBytes = 0;
+    double best = 1e30;
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        auto start = bench_clock::now();
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            int width, height, nrComponents;
+            stbi_uc *data = stbi_load_from_memory(encoded[i].data(), int(encoded[i].size()), &width, &height, &nrComponents, 0);
+            if (!data)
+            {
+                std::cout << files[i] << ": " << stbi_failure_reason() << std::endl;
+                return 1;
+            }
+            if (repetition == 0)
+            {
+                pixels[i].assign(data, data + size_t(width) * height * nrComponents);
+                decodedBytes += pixels[i].size();
+            }
+            stbi_image_free(data);
+        }
+        best = std::min(best, elapsedMs(start));
+    }
+
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    vector<const char *> names;
+    for (const string &file : files)
+        names.push_back(file.c_str());
+    vector<stbi_batch_image> images(files.size());
+    double bestBatch = 1e30;
+    bool identical = true;
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        auto start = bench_clock::now();
+        int loaded = stbi_load_batch(names.data(), int(names.size()), images.data(), 0, int(threads));
+        bestBatch = std::min(bestBatch, elapsedMs(start));
+
+        identical = identical && loaded == int(files.size());
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            const stbi_batch_image &image = images[i];
+            size_t size = size_t(image.x) * image.y * image.channels_in_file;
+            identical = identical && image.data && size == pixels[i].size() &&
+                        std::equal(pixels[i].begin(), pixels[i].end(), image.data);
+            stbi_image_free(image.data);
+        }
+    }
+
+    std::cout << files.size() << " PNG files, " << encodedBytes / (1024.0 * 1024.0) << " MB compressed, "
+              << decodedBytes / (1024.0 * 1024.0) << " MB decoded" << std::endl;
+    std::cout << "  1 thread, from memory   " << best << " ms, " << decodedBytes / (best * 1000.0) << " MB/s" << std::endl;
+    std::cout << "  stbi_load_batch, " << threads << " threads  " << bestBatch << " ms, "
+              << decodedBytes / (bestBatch * 1000.0) << " MB/s" << std::endl;
+    if (!identical)
+    {
+        std::cout << "stbi_load_batch did not match the single threaded decode" << std::endl;
+        return 1;
+    }
+    return 0;
+}
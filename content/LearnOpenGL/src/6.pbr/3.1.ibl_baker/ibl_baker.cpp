@@ -0,0 +1,91 @@
+#include <learnopengl/filesystem.h>
+#include <learnopengl/ibl_baker.h>
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+// Headless IBL baker: turns an equirectangular HDR environment into the four textures the
+// 6.pbr IBL samples otherwise render at every start, and writes them as KTX files:
+//   environment.ktx  512 x 512 cubemap with its full mip chain (the skybox)
+//   irradiance.ktx   32 x 32 cubemap evaluated from the SH9 projection of the environment
+//   prefilter.ktx    128 x 128 cubemap, 5 levels of GGX prefiltering from roughness 0 to 1
+//   brdf.ktx         512 x 512 RG16F split sum lookup table
+// 2.2.2.ibl_specular_textured loads them from resources/textures/hdr/newport_loft_ibl when
+// they are there.
+//
+// usage: ibl_baker [environment.hdr] [output directory] [threads]
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    std::string input = argc > 1 ? argv[1] : FileSystem::getPath("resources/textures/hdr/newport_loft.hdr");
+    std::string output = argc > 2 ? argv[2] : FileSystem::getPath("resources/textures/hdr/newport_loft_ibl");
+    unsigned int threads = argc > 3 ? (unsigned int)std::atoi(argv[3]) : 0;
+
+    // the samples load the HDR flipped, and the mapping assumes it
+    stbi_set_flip_vertically_on_load(true);
+    int width, height, nrComponents;
+    float *data = stbi_loadf(input.c_str(), &width, &height, &nrComponents, 3);
+    if (!data)
+    {
+        std::cout << "Failed to load HDR image " << input << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+
+    auto start = bench_clock::now();
+    CubemapImage environment;
+    IBLBaker::equirectangularToCubemap(data, width, height, 512, environment, threads);
+    IBLBaker::generateMipmaps(environment, threads);
+    stbi_image_free(data);
+    double environmentTime = elapsedMs(start);
+
+    start = bench_clock::now();
+    IrradianceSH sh;
+    CubemapImage irradiance;
+    IBLBaker::projectIrradianceSH(environment, sh, threads);
+    IBLBaker::irradianceCubemap(sh, 32, irradiance, threads);
+    double irradianceTime = elapsedMs(start);
+
+    start = bench_clock::now();
+    CubemapImage prefilter;
+    IBLBaker::prefilterCubemap(environment, 128, 5, 1024, prefilter, threads);
+    double prefilterTime = elapsedMs(start);
+
+    start = bench_clock::now();
+    BRDFLookup brdf;
+    IBLBaker::integrateBRDF(512, 1024, brdf, threads);
+    double brdfTime = elapsedMs(start);
+
+    std::filesystem::create_directories(output);
+    if (!IBLBaker::saveKTX(output + "/environment.ktx", environment) ||
+        !IBLBaker::saveKTX(output + "/irradiance.ktx", irradiance) ||
+        !IBLBaker::saveKTX(output + "/prefilter.ktx", prefilter) ||
+        !IBLBaker::saveKTX(output + "/brdf.ktx", brdf))
+    {
+        std::cout << "Failed to write the KTX files to " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << input << " (" << width << " x " << height << ") -> " << output << std::endl;
+    std::cout << "  environment cubemap and mips  " << environmentTime << " ms" << std::endl;
+    std::cout << "  SH9 irradiance                " << irradianceTime << " ms" << std::endl;
+    std::cout << "  prefiltered specular          " << prefilterTime << " ms" << std::endl;
+    std::cout << "  BRDF lookup table             " << brdfTime << " ms" << std::endl;
+    std::cout << "SH9 irradiance coefficients (divided by pi):" << std::endl;
+    for (int i = 0; i < 9; i++)
+    {
+        const glm::vec3 &c = sh.coefficients[i];
+        std::cout << "  " << c.r << " " << c.g << " " << c.b << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+#include <learnopengl/filesystem.h>
+#include <learnopengl/ibl_baker.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Headless benchmark of the CPU IBL baker: every stage of the bake is timed on one thread
+// and on one thread per hardware thread, and the results are compared with brute force
+// references that integrate over every texel of the environment (or a dense grid of BRDF
+// samples) instead of importance sampling or projecting onto spherical harmonics:
+//   irradiance  SH9 against the cosine weighted sum over the 64 x 64 environment level
+//   prefilter   levels 1-4 against the GGX weighted sum over the 64 x 64 environment level
+//   BRDF        32 x 32 texels of the table against a 256 x 256 sample grid in double precision
+// The error is the RMS over texels and channels relative to the RMS of the reference. Returns
+// non-zero if the single and multi threaded bakes differ or an error is above its limit.
+//
+// usage: ibl_bake_benchmark [environment.hdr]
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+static double elapsedMs(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// relative RMS difference of one level of two cubemaps
+static double relativeError(const CubemapImage &result, int resultLevel, const CubemapImage &reference, int referenceLevel)
+{
+    const std::vector<float> &a = result.levels[resultLevel], &b = reference.levels[referenceLevel];
+    double difference = 0.0, magnitude = 0.0;
+    for (size_t i = 0; i < a.size(); i += 4)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            difference += (double)(a[i + c] - b[i + c]) * (a[i + c] - b[i + c]);
+            magnitude += (double)b[i + c] * b[i + c];
+        }
+    }
+    return std::sqrt(difference / std::max(magnitude, 1e-30));
+}
+
+static bool identical(const CubemapImage &a, const CubemapImage &b)
+{
+    return a.size == b.size && a.levels == b.levels;
+}
+
+// direction, solid angle and radiance of every texel of one environment level
+struct EnvironmentTexels {
+    std::vector<glm::vec3> direction, radiance;
+    std::vector<float> solidAngle;
+
+    EnvironmentTexels(const CubemapImage &environment, int level)
+    {
+        const int size = environment.levelSize(level);
+        for (int face = 0; face < 6; face++)
+        {
+            for (int y = 0; y < size; y++)
+            {
+                for (int x = 0; x < size; x++)
+                {
+                    const float *texel = environment.texel(level, face, x, y);
+                    direction.push_back(glm::normalize(IBLBaker::texelDirection(face, x, y, size)));
+                    radiance.push_back(glm::vec3(texel[0], texel[1], texel[2]));
+                    solidAngle.push_back(IBLBaker::texelSolidAngle(x, y, size));
+                }
+            }
+        }
+    }
+};
+
+// E(n) / pi, summing every texel of the environment
+static void referenceIrradiance(const EnvironmentTexels &texels, int faceSize, CubemapImage &irradiance)
+{
+    irradiance.allocate(faceSize, 1);
+    IBLBaker::parallelFor(6 * faceSize, 0, [&](int row) {
+        const int face = row / faceSize, y = row % faceSize;
+        for (int x = 0; x < faceSize; x++)
+        {
+            glm::vec3 n = glm::normalize(IBLBaker::texelDirection(face, x, y, faceSize));
+            glm::dvec3 sum(0.0);
+            for (size_t i = 0; i < texels.direction.size(); i++)
+            {
+                float cosine = glm::dot(n, texels.direction[i]);
+                if (cosine > 0.0f)
+                    sum += glm::dvec3(texels.radiance[i]) * (double)(cosine * texels.solidAngle[i]);
+            }
+            float *out = irradiance.texel(0, face, x, y);
+            out[0] = (float)(sum.x / IBLBaker::PI);
+            out[1] = (float)(sum.y / IBLBaker::PI);
+            out[2] = (float)(sum.z / IBLBaker::PI);
+        }
+    });
+}
+
+// What the importance sampled prefilter converges to with N = V = R: the average radiance
+// weighted by NdotL and the GGX pdf of the direction, here over every texel of the environment.
+static void referencePrefilter(const EnvironmentTexels &texels, int faceSize, float roughness, CubemapImage &prefiltered)
+{
+    const double a2 = std::pow((double)roughness, 4.0);
+    prefiltered.allocate(faceSize, 1);
+    IBLBaker::parallelFor(6 * faceSize, 0, [&](int row) {
+        const int face = row / faceSize, y = row % faceSize;
+        for (int x = 0; x < faceSize; x++)
+        {
+            glm::vec3 n = glm::normalize(IBLBaker::texelDirection(face, x, y, faceSize));
+            glm::dvec3 sum(0.0);
+            double totalWeight = 0.0;
+            for (size_t i = 0; i < texels.direction.size(); i++)
+            {
+                const glm::vec3 &l = texels.direction[i];
+                double nDotL = glm::dot(n, l);
+                if (nDotL <= 0.0)
+                    continue;
+                double nDotH = glm::dot(n, glm::normalize(n + l));
+                double denom = nDotH * nDotH * (a2 - 1.0) + 1.0;
+                double weight = nDotL * a2 / (denom * denom) * texels.solidAngle[i];
+                sum += glm::dvec3(texels.radiance[i]) * weight;
+                totalWeight += weight;
+            }
+            float *out = prefiltered.texel(0, face, x, y);
+            out[0] = (float)(sum.x / totalWeight);
+            out[1] = (float)(sum.y / totalWeight);
+            out[2] = (float)(sum.z / totalWeight);
+        }
+    });
+}
+
+// The split sum BRDF terms on a midpoint grid over the GGX distributed half vectors, which
+// needs no low discrepancy sequence and converges as the grid gets finer.
+static glm::dvec2 referenceBRDF(double nDotV, double roughness, int grid)
+{
+    const double a = roughness * roughness, k = a / 2.0;
+    const double vx = std::sqrt(1.0 - nDotV * nDotV), vz = nDotV;
+    double sumA = 0.0, sumB = 0.0;
+    for (int i = 0; i < grid; i++)
+    {
+        const double phi = 2.0 * 3.14159265358979 * (i + 0.5) / grid;
+        for (int j = 0; j < grid; j++)
+        {
+            const double u = (j + 0.5) / grid;
+            const double cosTheta = std::sqrt((1.0 - u) / (1.0 + (a * a - 1.0) * u));
+            const double sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+            const double hx = std::cos(phi) * sinTheta, hz = cosTheta;
+            const double vDotH = vx * hx + vz * hz;
+            const double nDotL = 2.0 * vDotH * hz - vz;
+            if (nDotL <= 0.0)
+                continue;
+            const double g = nDotL / (nDotL * (1.0 - k) + k) * nDotV / (nDotV * (1.0 - k) + k);
+            const double gVis = g * std::max(vDotH, 0.0) / (hz * nDotV);
+            const double fc = std::pow(1.0 - std::max(vDotH, 0.0), 5.0);
+            sumA += (1.0 - fc) * gVis;
+            sumB += fc * gVis;
+        }
+    }
+    return glm::dvec2(sumA, sumB) / ((double)grid * grid);
+}
+
+struct Timing {
+    double serial, parallel;
+};
+
+static void printTiming(const char *stage, const Timing &timing)
+{
+    std::cout << "  " << std::left << std::setw(32) << stage << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << timing.serial << std::setw(10) << timing.parallel
+              << std::setw(8) << std::setprecision(2) << timing.serial / timing.parallel << "x" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string input = argc > 1 ? argv[1] : FileSystem::getPath("resources/textures/hdr/newport_loft.hdr");
+    const unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    stbi_set_flip_vertically_on_load(true);
+    int width, height, nrComponents;
+    float *data = stbi_loadf(input.c_str(), &width, &height, &nrComponents, 3);
+    if (!data)
+    {
+        std::cout << "Failed to load HDR image " << input << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+
+    // every stage once on one thread and once on all of them, and both have to give the same texels
+    CubemapImage environment[2], irradiance[2], prefilter[2];
+    IrradianceSH sh[2];
+    BRDFLookup brdf[2];
+    Timing environmentTime, irradianceTime, prefilterTime, brdfTime;
+    for (int run = 0; run < 2; run++)
+    {
+        const unsigned int threadCount = run == 0 ? 1 : threads;
+        double *slot[4] = { run == 0 ? &environmentTime.serial : &environmentTime.parallel,
+                            run == 0 ? &irradianceTime.serial : &irradianceTime.parallel,
+                            run == 0 ? &prefilterTime.serial : &prefilterTime.parallel,
+                            run == 0 ? &brdfTime.serial : &brdfTime.parallel };
+
+        auto start = bench_clock::now();
+        IBLBaker::equirectangularToCubemap(data, width, height, 512, environment[run], threadCount);
+        IBLBaker::generateMipmaps(environment[run], threadCount);
+        *slot[0] = elapsedMs(start);
+
+        start = bench_clock::now();
+        IBLBaker::projectIrradianceSH(environment[run], sh[run], threadCount);
+        IBLBaker::irradianceCubemap(sh[run], 32, irradiance[run], threadCount);
+        *slot[1] = elapsedMs(start);
+
+        start = bench_clock::now();
+        IBLBaker::prefilterCubemap(environment[run], 128, 5, 1024, prefilter[run], threadCount);
+        *slot[2] = elapsedMs(start);
+
+        start = bench_clock::now();
+        IBLBaker::integrateBRDF(512, 1024, brdf[run], threadCount);
+        *slot[3] = elapsedMs(start);
+    }
+    stbi_image_free(data);
+
+    std::cout << input << " (" << width << " x " << height << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(32) << "stage" << std::right << std::setw(10) << "1 thread"
+              << std::setw(10) << (std::to_string(threads) + " thr") << std::setw(9) << "speedup" << std::endl;
+    printTiming("environment 512 + mips", environmentTime);
+    printTiming("SH9 irradiance 32", irradianceTime);
+    printTiming("prefilter 128 x 5, 1024 spp", prefilterTime);
+    printTiming("BRDF LUT 512, 1024 spp", brdfTime);
+
+    bool consistent = identical(environment[0], environment[1]) && identical(irradiance[0], irradiance[1]) &&
+                      identical(prefilter[0], prefilter[1]) && brdf[0].data == brdf[1].data;
+    if (!consistent)
+        std::cout << "the single and multi threaded bakes differ" << std::endl;
+
+    // brute force references on the 64 x 64 level of the environment
+    const int referenceLevel = 3;
+    auto start = bench_clock::now();
+    EnvironmentTexels texels(environment[1], referenceLevel);
+    CubemapImage reference;
+    referenceIrradiance(texels, 32, reference);
+    const double irradianceError = relativeError(irradiance[1], 0, reference, 0);
+    std::cout << "relative RMS error against brute force (" << texels.direction.size() << " environment texels)" << std::endl;
+    std::cout << "  SH9 irradiance           " << std::setprecision(4) << irradianceError * 100.0 << " %" << std::endl;
+
+    double prefilterError = 0.0;
+    for (int level = 1; level < 5; level++)
+    {
+        const float roughness = level / 4.0f;
+        referencePrefilter(texels, prefilter[1].levelSize(level), roughness, reference);
+        double error = relativeError(prefilter[1], level, reference, 0);
+        prefilterError = std::max(prefilterError, error);
+        std::cout << "  prefilter roughness " << std::setprecision(2) << roughness << " " << std::setprecision(4)
+                  << error * 100.0 << " %" << std::endl;
+    }
+
+    double brdfDifference = 0.0, brdfMagnitude = 0.0;
+    const int stride = brdf[1].size / 32;
+    for (int y = stride / 2; y < brdf[1].size; y += stride)
+    {
+        for (int x = stride / 2; x < brdf[1].size; x += stride)
+        {
+            glm::dvec2 expected = referenceBRDF((x + 0.5) / brdf[1].size, (y + 0.5) / brdf[1].size, 256);
+            const float *value = &brdf[1].data[((size_t)y * brdf[1].size + x) * 2];
+            brdfDifference += (value[0] - expected.x) * (value[0] - expected.x) + (value[1] - expected.y) * (value[1] - expected.y);
+            brdfMagnitude += expected.x * expected.x + expected.y * expected.y;
+        }
+    }
+    const double brdfError = std::sqrt(brdfDifference / brdfMagnitude);
+    std::cout << "  BRDF LUT                 " << brdfError * 100.0 << " %" << std::endl;
+    std::cout << "references took " << std::setprecision(1) << elapsedMs(start) << " ms" << std::endl;
+
+    // SH9 rings around bright light sources and the prefilter reads box filtered mips, so neither is
+    // exact; beyond these limits something is broken rather than approximate
+    if (!consistent || irradianceError > 0.05 || prefilterError > 0.03 || brdfError > 0.01)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "collision_grid.h"
+
+
+CollisionGrid::CollisionGrid()
+    : origin(0.0f), cellSize(1.0f), columns(0), rows(0)
+{
+
+}
+
+void CollisionGrid::Clear()
+{
+    this->columns = this->rows = 0;
+    this->cellStart.clear();
+    this->cellItems.clear();
+}
+
+void CollisionGrid::Build(const std::vector<GameObject> &objects, glm::vec2 cellSize)
+{
+    this->Clear();
+    if (objects.empty() || cellSize.x <= 0.0f || cellSize.y <= 0.0f)
+        return;
+    // calculate the bounds of all objects
+    glm::vec2 min(objects[0].Position), max(objects[0].Position + objects[0].Size);
+    for (const GameObject &object : objects)
+    {
+        min = glm::min(min, object.Position);
+        max = glm::max(max, object.Position + object.Size);
+    }
+    this->origin = min;
+    this->cellSize = cellSize;
+    this->columns = std::max(1u, static_cast<unsigned int>(std::ceil((max.x - min.x) / cellSize.x)));
+    this->rows = std::max(1u, static_cast<unsigned int>(std::ceil((max.y - min.y) / cellSize.y)));
+    // first pass: count the objects per cell (shifted by one so the prefix sum yields the start offsets)
+    this->cellStart.assign(this->columns * this->rows + 1, 0);
+    for (const GameObject &object : objects)
+    {
+        glm::ivec2 first = this->cellOf(object.Position);
+        glm::ivec2 last = this->cellOf(object.Position + object.Size);
+        for (int y = first.y; y <= last.y; ++y)
+            for (int x = first.x; x <= last.x; ++x)
+                ++this->cellStart[y * this->columns + x + 1];
+    }
+    for (unsigned int i = 1; i < this->cellStart.size(); ++i)
+        this->cellStart[i] += this->cellStart[i - 1];
+    // second pass: scatter the object indices into their cells
+    this->cellItems.resize(this->cellStart.back());
+    std::vector<unsigned int> cursor(this->cellStart.begin(), this->cellStart.end() - 1);
+    for (unsigned int i = 0; i < objects.size(); ++i)
+    {
+        glm::ivec2 first = this->cellOf(objects[i].Position);
+        glm::ivec2 last = this->cellOf(objects[i].Position + objects[i].Size);
+        for (int y = first.y; y <= last.y; ++y)
+            for (int x = first.x; x <= last.x; ++x)
+                this->cellItems[cursor[y * this->columns + x]++] = i;
+    }
+}
+
+void CollisionGrid::Query(glm::vec2 min, glm::vec2 max, std::vector<unsigned int> &result) const
+{
+    result.clear();
+    if (this->cellStart.empty())
+        return;
+    // reject boxes that lie completely outside of the grid
+    glm::vec2 gridMax = this->origin + this->cellSize * glm::vec2(this->columns, this->rows);
+    if (max.x < this->origin.x || max.y < this->origin.y || min.x > gridMax.x || min.y > gridMax.y)
+        return;
+    glm::ivec2 first = this->cellOf(min);
+    glm::ivec2 last = this->cellOf(max);
+    for (int y = first.y; y <= last.y; ++y)
+    {
+        for (int x = first.x; x <= last.x; ++x)
+        {
+            unsigned int cell = y * this->columns + x;
+            result.insert(result.end(), this->cellItems.begin() + this->cellStart[cell], this->cellItems.begin() + this->cellStart[cell + 1]);
+        }
+    }
+    // objects spanning several cells are reported once, in their original order
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+glm::ivec2 CollisionGrid::cellOf(glm::vec2 position) const
+{
+    glm::vec2 cell = glm::floor((position - this->origin) / this->cellSize);
+    return glm::clamp(glm::ivec2(cell), glm::ivec2(0), glm::ivec2(this->columns - 1, this->rows - 1));
+}
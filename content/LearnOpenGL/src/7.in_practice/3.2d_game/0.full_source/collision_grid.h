@@ -0,0 +1,45 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+
+
+// CollisionGrid is a uniform grid broad phase over a static set of
+// game objects (e.g. the bricks of a level). Each cell stores the
+// indices of the objects overlapping it in one flat array so that a
+// query only has to visit the few cells covered by the query box
+// instead of testing every object.
+class CollisionGrid
+{
+public:
+    // constructor
+    CollisionGrid();
+    // (re)builds the grid over the given objects using cells of the given size
+    void Build(const std::vector<GameObject> &objects, glm::vec2 cellSize);
+    // retrieves the indices (sorted, without duplicates) of all objects whose cells overlap the AABB [min, max]
+    void Query(glm::vec2 min, glm::vec2 max, std::vector<unsigned int> &result) const;
+    // removes all cells
+    void Clear();
+private:
+    // grid state
+    glm::vec2 origin, cellSize;
+    unsigned int columns, rows;
+    // cell i holds cellItems[cellStart[i]] up to cellItems[cellStart[i + 1]]
+    std::vector<unsigned int> cellStart;
+    std::vector<unsigned int> cellItems;
+    // clamps a world position to a cell coordinate
+    glm::ivec2 cellOf(glm::vec2 position) const;
+};
+
+#endif
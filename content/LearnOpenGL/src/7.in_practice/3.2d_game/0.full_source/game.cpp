@@ -31,14 +31,16 @@ GameObject        *Player;
 BallObject        *Ball;
 ParticleGenerator *Particles;
 PostProcessor     *Effects;
-ISoundEngine      *SoundEngine = createIrrKlangDevice();
+ISoundEngine      *SoundEngine = nullptr;   // created in Init, headless runs have no audio
 TextRenderer      *Text;
 
 float ShakeTime = 0.0f;
+// bricks returned by the broad phase for the current frame
+std::vector<unsigned int> BrickCandidates;
 
 
 Game::Game(unsigned int width, unsigned int height) 
-    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Level(0), Lives(3)
+    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Level(0), Lives(3), ParticlesPerFrame(2)
 { 
 
 }
@@ -51,7 +53,8 @@ Game::~Game()
     delete Particles;
     delete Effects;
     delete Text;
-    SoundEngine->drop();
+    if (SoundEngine)
+        SoundEngine->drop();
 }
 
 void Game::Init()
@@ -101,7 +104,21 @@ void Game::Init()
     glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
     Ball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture("face"));
     // audio
-    SoundEngine->play2D(FileSystem::getPath("resources/audio/breakout.mp3").c_str(), true);
+    SoundEngine = createIrrKlangDevice();
+    if (SoundEngine)
+        SoundEngine->play2D(FileSystem::getPath("resources/audio/breakout.mp3").c_str(), true);
+}
+
+void Game::InitHeadless(unsigned int particleAmount)
+{
+    // no audio in headless mode: SoundEngine stays null and every play2D call is skipped
+    // only the objects that take part in the simulation; textures stay empty and are never uploaded
+    Particles = new ParticleGenerator(particleAmount);
+    glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    Player = new GameObject(playerPos, PLAYER_SIZE, Texture2D());
+    glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+    Ball = new BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, Texture2D());
+    this->Level = 0;
 }
 
 void Game::Update(float dt)
@@ -111,14 +128,14 @@ void Game::Update(float dt)
     // check for collisions
     this->DoCollisions();
     // update particles
-    Particles->Update(dt, *Ball, 2, glm::vec2(Ball->Radius / 2.0f));
+    Particles->Update(dt, *Ball, this->ParticlesPerFrame, glm::vec2(Ball->Radius / 2.0f));
     // update PowerUps
     this->UpdatePowerUps(dt);
     // reduce shake time
     if (ShakeTime > 0.0f)
     {
         ShakeTime -= dt;
-        if (ShakeTime <= 0.0f)
+        if (ShakeTime <= 0.0f && Effects)
             Effects->Shake = false;
     }
     // check loss condition
@@ -138,7 +155,8 @@ void Game::Update(float dt)
     {
         this->ResetLevel();
         this->ResetPlayer();
-        Effects->Chaos = true;
+        if (Effects)
+            Effects->Chaos = true;
         this->State = GAME_WIN;
     }
 }
@@ -266,7 +284,8 @@ void Game::ResetPlayer()
     Player->Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
     Ball->Reset(Player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
     // also disable all active powerups
-    Effects->Chaos = Effects->Confuse = false;
+    if (Effects)
+        Effects->Chaos = Effects->Confuse = false;
     Ball->PassThrough = Ball->Sticky = false;
     Player->Color = glm::vec3(1.0f);
     Ball->Color = glm::vec3(1.0f);
@@ -308,14 +327,14 @@ void Game::UpdatePowerUps(float dt)
                 }
                 else if (powerUp.Type == "confuse")
                 {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "confuse"))
+                    if (!IsOtherPowerUpActive(this->PowerUps, "confuse") && Effects)
                     {	// only reset if no other PowerUp of type confuse is active
                         Effects->Confuse = false;
                     }
                 }
                 else if (powerUp.Type == "chaos")
                 {
-                    if (!IsOtherPowerUpActive(this->PowerUps, "chaos"))
+                    if (!IsOtherPowerUpActive(this->PowerUps, "chaos") && Effects)
                     {	// only reset if no other PowerUp of type chaos is active
                         Effects->Chaos = false;
                     }
@@ -371,12 +390,12 @@ void ActivatePowerUp(PowerUp &powerUp)
     {
         Player->Size.x += 50;
     }
-    else if (powerUp.Type == "confuse")
+    else if (powerUp.Type == "confuse" && Effects)
     {
         if (!Effects->Chaos)
             Effects->Confuse = true; // only activate if chaos wasn't already active
     }
-    else if (powerUp.Type == "chaos")
+    else if (powerUp.Type == "chaos" && Effects)
     {
         if (!Effects->Confuse)
             Effects->Chaos = true;
@@ -404,8 +423,12 @@ Direction VectorDirection(glm::vec2 closest);
 
 void Game::DoCollisions()
 {
-    for (GameObject &box : this->Levels[this->Level].Bricks)
+    // broad phase: only the bricks in the grid cells covered by the ball are tested
+    GameLevel &level = this->Levels[this->Level];
+    level.Grid.Query(Ball->Position, Ball->Position + Ball->Size, BrickCandidates);
+    for (unsigned int index : BrickCandidates)
     {
+        GameObject &box = level.Bricks[index];
         if (!box.Destroyed)
         {
             Collision collision = CheckCollision(*Ball, box);
@@ -414,15 +437,18 @@ void Game::DoCollisions()
                 // destroy block if not solid
                 if (!box.IsSolid)
                 {
-                    box.Destroyed = true;
+                    level.DestroyBrick(box);
                     this->SpawnPowerUps(box);
-                    SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.mp3").c_str(), false);
+                    if (SoundEngine)
+                        SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.mp3").c_str(), false);
                 }
                 else
                 {   // if block is solid, enable shake effect
                     ShakeTime = 0.05f;
-                    Effects->Shake = true;
-                    SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.mp3").c_str(), false);
+                    if (Effects)
+                        Effects->Shake = true;
+                    if (SoundEngine)
+                        SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.mp3").c_str(), false);
                 }
                 // collision resolution
                 Direction dir = std::get<1>(collision);
@@ -468,7 +494,8 @@ void Game::DoCollisions()
                 ActivatePowerUp(powerUp);
                 powerUp.Destroyed = true;
                 powerUp.Activated = true;
-                SoundEngine->play2D(FileSystem::getPath("resources/audio/powerup.wav").c_str(), false);
+                if (SoundEngine)
+                    SoundEngine->play2D(FileSystem::getPath("resources/audio/powerup.wav").c_str(), false);
             }
         }
     }
@@ -493,7 +520,8 @@ void Game::DoCollisions()
         // if Sticky powerup is activated, also stick ball to paddle once new velocity vectors were calculated
         Ball->Stuck = Ball->Sticky;
 
-        SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.wav").c_str(), false);
+        if (SoundEngine)
+            SoundEngine->play2D(FileSystem::getPath("resources/audio/bleep.wav").c_str(), false);
     }
 }
 
@@ -58,11 +58,14 @@ public:
     std::vector<PowerUp>    PowerUps;
     unsigned int            Level;
     unsigned int            Lives;
+    unsigned int            ParticlesPerFrame;
     // constructor/destructor
     Game(unsigned int width, unsigned int height);
     ~Game();
     // initialize game state (load all shaders/textures/levels)
     void Init();
+    // initialize the simulation state only (no window, GL context or audio required); levels are added by the caller
+    void InitHeadless(unsigned int particleAmount);
     // game loop
     void ProcessInput(float dt);
     void Update(float dt);
@@ -10,12 +10,15 @@
 
 #include <fstream>
 #include <sstream>
+#include <random>
 
 
 void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight)
 {
     // clear old data
     this->Bricks.clear();
+    this->Grid.Clear();
+    this->remaining = 0;
     // load from file
     unsigned int tileCode;
     GameLevel level;
@@ -44,20 +47,47 @@ void GameLevel::Draw(SpriteRenderer &renderer)
             tile.Draw(renderer);
 }
 
+void GameLevel::Generate(unsigned int columns, unsigned int rows, unsigned int levelWidth, unsigned int levelHeight, unsigned int seed)
+{
+    // clear old data
+    this->Bricks.clear();
+    this->Grid.Clear();
+    this->remaining = 0;
+    if (columns == 0 || rows == 0)
+        return;
+    // roughly one in ten tiles is empty and one in ten is solid, the rest gets a random color
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<unsigned int> tile(0, 9);
+    std::vector<std::vector<unsigned int>> tileData(rows, std::vector<unsigned int>(columns));
+    for (std::vector<unsigned int> &row : tileData)
+        for (unsigned int &code : row)
+        {
+            unsigned int value = tile(random);
+            code = value == 0 ? 0 : value == 1 ? 1 : 2 + value % 4;
+        }
+    this->init(tileData, levelWidth, levelHeight);
+}
+
+void GameLevel::DestroyBrick(GameObject &brick)
+{
+    if (brick.Destroyed || brick.IsSolid)
+        return;
+    brick.Destroyed = true;
+    --this->remaining;
+}
+
 bool GameLevel::IsCompleted()
 {
-    for (GameObject &tile : this->Bricks)
-        if (!tile.IsSolid && !tile.Destroyed)
-            return false;
-    return true;
+    return this->remaining == 0;
 }
 
-void GameLevel::init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight)
+void GameLevel::init(const std::vector<std::vector<unsigned int>> &tileData, unsigned int levelWidth, unsigned int levelHeight)
 {
     // calculate dimensions
     unsigned int height = tileData.size();
     unsigned int width = tileData[0].size(); // note we can index vector at [0] since this function is only called if height > 0
     float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / height; 
+    this->Bricks.reserve(width * height);
     // initialize level tiles based on tileData		
     for (unsigned int y = 0; y < height; ++y)
     {
@@ -87,7 +117,10 @@ void GameLevel::init(std::vector<std::vector<unsigned int>> tileData, unsigned i
                 glm::vec2 pos(unit_width * x, unit_height * y);
                 glm::vec2 size(unit_width, unit_height);
                 this->Bricks.push_back(GameObject(pos, size, ResourceManager::GetTexture("block"), color));
+                ++this->remaining;
             }
         }
     }
+    // bricks never move, so the broad phase only has to be built once per level
+    this->Grid.Build(this->Bricks, glm::vec2(unit_width, unit_height));
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <glm/glm.hpp>
 
 #include "game_object.h"
+#include "collision_grid.h"
 #include "sprite_renderer.h"
 #include "resource_manager.h"
 
@@ -25,17 +26,25 @@ class GameLevel
 public:
     // level state
     std::vector<GameObject> Bricks;
+    // broad phase over Bricks, rebuilt whenever the level is (re)initialized
+    CollisionGrid           Grid;
     // constructor
-    GameLevel() { }
+    GameLevel() : remaining(0) { }
     // loads level from file
     void Load(const char *file, unsigned int levelWidth, unsigned int levelHeight);
+    // generates a random level of columns x rows tiles (used for stress testing large levels)
+    void Generate(unsigned int columns, unsigned int rows, unsigned int levelWidth, unsigned int levelHeight, unsigned int seed = 0);
     // render level
     void Draw(SpriteRenderer &renderer);
+    // destroys the given (non-solid) brick
+    void DestroyBrick(GameObject &brick);
     // check if the level is completed (all non-solid tiles are destroyed)
     bool IsCompleted();
 private:
+    // number of non-solid bricks that are not yet destroyed
+    unsigned int remaining;
     // initialize level from tile data
-    void init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
+    void init(const std::vector<std::vector<unsigned int>> &tileData, unsigned int levelWidth, unsigned int levelHeight);
 };
 
 #endif
\ No newline at end of file
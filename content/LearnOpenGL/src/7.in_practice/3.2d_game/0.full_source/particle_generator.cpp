@@ -8,30 +8,73 @@
 ******************************************************************/
 #include "particle_generator.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE
+#endif
+
 ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-    : shader(shader), texture(texture), amount(amount)
+    : amount(amount), shader(shader), texture(texture), VAO(0)
 {
     this->init();
 }
 
+ParticleGenerator::ParticleGenerator(unsigned int amount)
+    : amount(amount), VAO(0)
+{
+    this->initPool();
+}
+
 void ParticleGenerator::Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset)
 {
     // add new particles 
     for (unsigned int i = 0; i < newParticles; ++i)
     {
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->particles[unusedParticle], object, offset);
+        unsigned int unusedParticle = this->firstUnusedParticle();
+        this->respawnParticle(unusedParticle, object, offset);
     }
-    // update all particles
-    for (unsigned int i = 0; i < this->amount; ++i)
+    // update all particles that were ever used; particles that die this frame are
+    // handed back to the free list, dead particles are left untouched
+    ParticlePool &p = this->particles;
+    unsigned int count = p.HighWater;
+    unsigned int i = 0;
+#ifdef PARTICLES_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 delta = _mm_set1_ps(dt);
+    const __m128 fade = _mm_set1_ps(dt * 2.5f);
+    for (; i + 4 <= count; i += 4)
     {
-        Particle &p = this->particles[i];
-        p.Life -= dt; // reduce life
-        if (p.Life > 0.0f)
+        __m128 life = _mm_loadu_ps(&p.Life[i]);
+        __m128 wasAlive = _mm_cmpgt_ps(life, zero);
+        life = _mm_sub_ps(life, _mm_and_ps(wasAlive, delta)); // reduce life
+        __m128 alive = _mm_cmpgt_ps(life, zero);
+        _mm_storeu_ps(&p.Life[i], life);
+        // masked with the alive lanes so only living particles move and fade
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(&p.PositionX[i]), _mm_and_ps(alive, _mm_mul_ps(_mm_loadu_ps(&p.VelocityX[i]), delta)));
+        __m128 y = _mm_sub_ps(_mm_loadu_ps(&p.PositionY[i]), _mm_and_ps(alive, _mm_mul_ps(_mm_loadu_ps(&p.VelocityY[i]), delta)));
+        __m128 a = _mm_sub_ps(_mm_loadu_ps(&p.ColorA[i]), _mm_and_ps(alive, fade));
+        _mm_storeu_ps(&p.PositionX[i], x);
+        _mm_storeu_ps(&p.PositionY[i], y);
+        _mm_storeu_ps(&p.ColorA[i], a);
+        int died = _mm_movemask_ps(_mm_andnot_ps(alive, wasAlive));
+        for (unsigned int lane = 0; died != 0; ++lane, died >>= 1)
+            if (died & 1)
+                p.FreeList.push_back(i + lane);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if (p.Life[i] <= 0.0f)
+            continue;
+        p.Life[i] -= dt; // reduce life
+        if (p.Life[i] > 0.0f)
         {	// particle is alive, thus update
-            p.Position -= p.Velocity * dt; 
-            p.Color.a -= dt * 2.5f;
+            p.PositionX[i] -= p.VelocityX[i] * dt;
+            p.PositionY[i] -= p.VelocityY[i] * dt;
+            p.ColorA[i] -= dt * 2.5f;
         }
+        else
+            p.FreeList.push_back(i);
     }
 }
 
@@ -41,12 +84,13 @@ void ParticleGenerator::Draw()
     // use additive blending to give it a 'glow' effect
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     this->shader.Use();
-    for (Particle particle : this->particles)
+    const ParticlePool &p = this->particles;
+    for (unsigned int i = 0; i < p.HighWater; ++i)
     {
-        if (particle.Life > 0.0f)
+        if (p.Life[i] > 0.0f)
         {
-            this->shader.SetVector2f("offset", particle.Position);
-            this->shader.SetVector4f("color", particle.Color);
+            this->shader.SetVector2f("offset", glm::vec2(p.PositionX[i], p.PositionY[i]));
+            this->shader.SetVector4f("color", glm::vec4(p.ColorR[i], p.ColorG[i], p.ColorB[i], p.ColorA[i]));
             this->texture.Bind();
             glBindVertexArray(this->VAO);
             glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -57,6 +101,11 @@ void ParticleGenerator::Draw()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
+unsigned int ParticleGenerator::AliveCount() const
+{
+    return this->particles.HighWater - static_cast<unsigned int>(this->particles.FreeList.size());
+}
+
 void ParticleGenerator::init()
 {
     // set up mesh and attribute properties
@@ -81,40 +130,56 @@ void ParticleGenerator::init()
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glBindVertexArray(0);
 
-    // create this->amount default particle instances
-    for (unsigned int i = 0; i < this->amount; ++i)
-        this->particles.push_back(Particle());
+    this->initPool();
+}
+
+void ParticleGenerator::initPool()
+{
+    // create this->amount default (dead) particle instances
+    ParticlePool &p = this->particles;
+    p.PositionX.assign(this->amount, 0.0f);
+    p.PositionY.assign(this->amount, 0.0f);
+    p.VelocityX.assign(this->amount, 0.0f);
+    p.VelocityY.assign(this->amount, 0.0f);
+    p.ColorR.assign(this->amount, 1.0f);
+    p.ColorG.assign(this->amount, 1.0f);
+    p.ColorB.assign(this->amount, 1.0f);
+    p.ColorA.assign(this->amount, 1.0f);
+    p.Life.assign(this->amount, 0.0f);
+    p.FreeList.clear();
+    p.FreeList.reserve(this->amount);
+    p.HighWater = 0;
 }
 
-// stores the index of the last particle used (for quick access to next dead particle)
-unsigned int lastUsedParticle = 0;
 unsigned int ParticleGenerator::firstUnusedParticle()
 {
-    // first search from last used particle, this will usually return almost instantly
-    for (unsigned int i = lastUsedParticle; i < this->amount; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    // otherwise, do a linear search
-    for (unsigned int i = 0; i < lastUsedParticle; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
+    ParticlePool &p = this->particles;
+    // reuse the most recently killed particle first, it is likely still in cache
+    if (!p.FreeList.empty())
+    {
+        unsigned int index = p.FreeList.back();
+        p.FreeList.pop_back();
+        return index;
     }
+    // otherwise take a particle that was never used before
+    if (p.HighWater < this->amount)
+        return p.HighWater++;
     // all particles are taken, override the first one (note that if it repeatedly hits this case, more particles should be reserved)
-    lastUsedParticle = 0;
     return 0;
 }
 
-void ParticleGenerator::respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset)
+void ParticleGenerator::respawnParticle(unsigned int index, GameObject &object, glm::vec2 offset)
 {
+    if (index >= this->amount)
+        return;
     float random = ((rand() % 100) - 50) / 10.0f;
     float rColor = 0.5f + ((rand() % 100) / 100.0f);
-    particle.Position = object.Position + random + offset;
-    particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
-    particle.Life = 1.0f;
-    particle.Velocity = object.Velocity * 0.1f;
+    ParticlePool &p = this->particles;
+    p.PositionX[index] = object.Position.x + random + offset.x;
+    p.PositionY[index] = object.Position.y + random + offset.y;
+    p.ColorR[index] = p.ColorG[index] = p.ColorB[index] = rColor;
+    p.ColorA[index] = 1.0f;
+    p.Life[index] = 1.0f;
+    p.VelocityX[index] = object.Velocity.x * 0.1f;
+    p.VelocityY[index] = object.Velocity.y * 0.1f;
 }
\ No newline at end of file
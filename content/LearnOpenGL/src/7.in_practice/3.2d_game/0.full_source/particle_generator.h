@@ -18,13 +18,19 @@
 #include "game_object.h"
 
 
-// Represents a single particle and its state
-struct Particle {
-    glm::vec2 Position, Velocity;
-    glm::vec4 Color;
-    float     Life;
+// Holds the state of all particles as separate arrays (structure of
+// arrays) so the per frame update can process several particles at once.
+struct ParticlePool {
+    std::vector<float> PositionX, PositionY;
+    std::vector<float> VelocityX, VelocityY;
+    std::vector<float> ColorR, ColorG, ColorB, ColorA;
+    std::vector<float> Life;
+    // indices of dead particles below HighWater, ready for reuse
+    std::vector<unsigned int> FreeList;
+    // particles at or above this index have never been used
+    unsigned int HighWater;
 
-    Particle() : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) { }
+    ParticlePool() : HighWater(0) { }
 };
 
 
@@ -36,13 +42,17 @@ class ParticleGenerator
 public:
     // constructor
     ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
+    // constructs a generator without any render state (for headless simulation)
+    ParticleGenerator(unsigned int amount);
     // update all particles
     void Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
     // render all particles
     void Draw();
+    // returns the number of particles that are currently alive
+    unsigned int AliveCount() const;
 private:
     // state
-    std::vector<Particle> particles;
+    ParticlePool particles;
     unsigned int amount;
     // render state
     Shader shader;
@@ -50,10 +60,12 @@ private:
     unsigned int VAO;
     // initializes buffer and vertex attributes
     void init();
-    // returns the first Particle index that's currently unused e.g. Life <= 0.0f or 0 if no particle is currently inactive
+    // allocates the particle arrays
+    void initPool();
+    // returns the index of an unused particle, popped from the free list, or 0 if no particle is currently inactive
     unsigned int firstUnusedParticle();
     // respawns particle
-    void respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    void respawnParticle(unsigned int index, GameObject &object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 };
 
 #endif
\ No newline at end of file
@@ -7,134 +7,232 @@
 ** option) any later version.
 ******************************************************************/
 #include <iostream>
+#include <algorithm>
 
 #include <glm/gtc/matrix_transform.hpp>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 
 #include "text_renderer.h"
 #include "resource_manager.h"
 
 
+// decodes the UTF-8 code point starting at text[i] and moves i past it
+static unsigned int decodeUtf8(const std::string &text, size_t &i)
+{
+    unsigned char c = text[i++];
+    unsigned int codepoint;
+    size_t extra;
+    if (c < 0x80)
+        return c;
+    else if ((c & 0xE0) == 0xC0) { codepoint = c & 0x1F; extra = 1; }
+    else if ((c & 0xF0) == 0xE0) { codepoint = c & 0x0F; extra = 2; }
+    else if ((c & 0xF8) == 0xF0) { codepoint = c & 0x07; extra = 3; }
+    else
+        return 0xFFFD; // stray continuation byte
+    for (; extra > 0; --extra)
+    {
+        if (i >= text.size() || (text[i] & 0xC0) != 0x80)
+            return 0xFFFD; // truncated sequence
+        codepoint = (codepoint << 6) | (text[i++] & 0x3F);
+    }
+    return codepoint;
+}
+
 TextRenderer::TextRenderer(unsigned int width, unsigned int height)
+    : Atlas(0), Library(nullptr), Face(nullptr), AtlasWidth(512), AtlasHeight(0), PenX(0), PenY(0), RowHeight(0)
 {
     // load and configure shader
     this->TextShader = ResourceManager::LoadShader("text_2d.vs", "text_2d.fs", nullptr, "text");
     this->TextShader.SetMatrix4("projection", glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f), true);
     this->TextShader.SetInteger("text", 0);
-    // configure VAO/VBO for texture quads
+    // configure VAO/VBO for texture quads, the buffer is sized when text is rendered
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &this->VBO);
     glBindVertexArray(this->VAO);
     glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
+TextRenderer::~TextRenderer()
+{
+    if (this->Face)
+        FT_Done_Face(this->Face);
+    if (this->Library)
+        FT_Done_FreeType(this->Library);
+    glDeleteTextures(1, &this->Atlas);
+    glDeleteBuffers(1, &this->VBO);
+    glDeleteVertexArrays(1, &this->VAO);
+}
+
 void TextRenderer::Load(std::string font, unsigned int fontSize)
 {
-    // first clear the previously loaded Characters
+    // first clear the previously loaded Characters and font
     this->Characters.clear();
+    if (this->Face)
+        FT_Done_Face(this->Face);
+    this->Face = nullptr;
     // then initialize and load the FreeType library
-    FT_Library ft;    
-    if (FT_Init_FreeType(&ft)) // all functions return a value different than 0 whenever an error occurred
+    if (!this->Library && FT_Init_FreeType(&this->Library)) // all functions return a value different than 0 whenever an error occurred
+    {
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-    // load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, font.c_str(), 0, &face))
+        this->Library = nullptr;
+        return;
+    }
+    // load font as face, it stays open for characters that are first used later on
+    if (FT_New_Face(this->Library, font.c_str(), 0, &this->Face))
+    {
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        this->Face = nullptr;
+        return;
+    }
     // set size to load glyphs as
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
-    // disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); 
-    // then for the first 128 ASCII characters, pre-load/compile their characters and store them
-    for (GLubyte c = 0; c < 128; c++) // lol see what I did there 
+    FT_Set_Pixel_Sizes(this->Face, 0, fontSize);
+    // start with an empty atlas a few rows of glyphs high, it grows when full
+    this->PenX = this->PenY = this->RowHeight = 0;
+    this->AtlasHeight = 0;
+    this->AtlasPixels.clear();
+    if (!this->Atlas)
+        glGenTextures(1, &this->Atlas);
+    glBindTexture(GL_TEXTURE_2D, this->Atlas);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    this->growAtlas();
+    // pre-load the printable ASCII characters, anything else is loaded when first rendered
+    for (unsigned int c = 32; c < 127; c++)
+        this->loadCharacter(c);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextRenderer::growAtlas()
+{
+    unsigned int height = this->AtlasHeight ? this->AtlasHeight * 2 : 128;
+    this->AtlasPixels.resize(this->AtlasWidth * height, 0);
+    this->AtlasHeight = height;
+    // the pixels are kept on the CPU, so growing only needs one full upload
+    glBindTexture(GL_TEXTURE_2D, this->Atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, this->AtlasWidth, this->AtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, this->AtlasPixels.data());
+}
+
+const Character *TextRenderer::loadCharacter(unsigned int codepoint)
+{
+    if (!this->Face)
+        return nullptr;
+    // load character glyph, a missing character renders as the font's replacement box
+    if (FT_Load_Char(this->Face, codepoint, FT_LOAD_RENDER))
     {
-        // load character glyph 
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-        {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-            continue;
-        }
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-            );
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-       
-        // now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
+        // cached as an empty glyph so the error is reported once, not every frame the text is rendered
+        std::cout << "ERROR::FREETYTPE: Failed to load Glyph " << codepoint << std::endl;
+        Character missing = { glm::ivec2(0), glm::ivec2(0), glm::ivec2(0), 0 };
+        return &(this->Characters[codepoint] = missing);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    // destroy FreeType once we're finished
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+    const FT_Bitmap &bitmap = this->Face->glyph->bitmap;
+    unsigned int width = bitmap.width, rows = bitmap.rows;
+    // a glyph wider than an atlas row cannot be packed, it keeps its advance but draws nothing
+    if (width + 1 > this->AtlasWidth)
+    {
+        std::cout << "ERROR::FREETYTPE: Glyph " << codepoint << " is wider than the " << this->AtlasWidth << " pixel atlas" << std::endl;
+        Character oversize = { glm::ivec2(0), glm::ivec2(0), glm::ivec2(0), static_cast<unsigned int>(this->Face->glyph->advance.x) };
+        return &(this->Characters[codepoint] = oversize);
+    }
+    // find room in the atlas, one pixel apart so linear filtering does not bleed
+    if (this->PenX + width + 1 > this->AtlasWidth)
+    {
+        this->PenX = 0;
+        this->PenY += this->RowHeight + 1;
+        this->RowHeight = 0;
+    }
+    while (this->PenY + rows > this->AtlasHeight)
+        this->growAtlas();
+    // copy the bitmap into the atlas and upload only its region
+    for (unsigned int row = 0; row < rows; row++)
+        std::copy(bitmap.buffer + row * bitmap.pitch, bitmap.buffer + row * bitmap.pitch + width,
+                  this->AtlasPixels.begin() + (this->PenY + row) * this->AtlasWidth + this->PenX);
+    if (width > 0 && rows > 0)
+    {
+        glBindTexture(GL_TEXTURE_2D, this->Atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, this->AtlasWidth);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, this->PenX, this->PenY, width, rows, GL_RED, GL_UNSIGNED_BYTE,
+                        &this->AtlasPixels[this->PenY * this->AtlasWidth + this->PenX]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    // now store character for later use
+    Character character = {
+        glm::ivec2(this->PenX, this->PenY),
+        glm::ivec2(width, rows),
+        glm::ivec2(this->Face->glyph->bitmap_left, this->Face->glyph->bitmap_top),
+        static_cast<unsigned int>(this->Face->glyph->advance.x)
+    };
+    this->PenX += width + 1;
+    this->RowHeight = std::max(this->RowHeight, rows);
+    return &(this->Characters[codepoint] = character);
 }
 
 void TextRenderer::RenderText(std::string text, float x, float y, float scale, glm::vec3 color)
 {
-    // activate corresponding render state	
-    this->TextShader.Use();
-    this->TextShader.SetVector3f("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+    auto H = this->Characters.find('H');
+    float top = H != this->Characters.end() ? static_cast<float>(H->second.Bearing.y) : 0.0f;
 
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++)
+    // build the quads of the whole string first, loading characters on first use
+    this->Vertices.clear();
+    size_t i = 0;
+    while (i < text.size())
     {
-        Character ch = Characters[*c];
+        unsigned int codepoint = decodeUtf8(text, i);
+        auto found = this->Characters.find(codepoint);
+        const Character *ch = found != this->Characters.end() ? &found->second : this->loadCharacter(codepoint);
+        if (!ch)
+            continue;
+        // spaces and glyphs that failed to load only move the pen
+        if (ch->Size.x == 0 || ch->Size.y == 0)
+        {
+            x += (ch->Advance >> 6) * scale;
+            continue;
+        }
 
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+        float xpos = x + ch->Bearing.x * scale;
+        float ypos = y + (top - ch->Bearing.y) * scale;
 
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 0.0f },
+        float w = ch->Size.x * scale;
+        float h = ch->Size.y * scale;
+        // atlas coordinates are normalized here since the atlas may have grown since the glyph was loaded
+        float u0 = ch->Offset.x / static_cast<float>(this->AtlasWidth);
+        float v0 = ch->Offset.y / static_cast<float>(this->AtlasHeight);
+        float u1 = (ch->Offset.x + ch->Size.x) / static_cast<float>(this->AtlasWidth);
+        float v1 = (ch->Offset.y + ch->Size.y) / static_cast<float>(this->AtlasHeight);
+        const float vertices[6][4] = {
+            { xpos,     ypos + h,   u0, v1 },
+            { xpos + w, ypos,       u1, v0 },
+            { xpos,     ypos,       u0, v0 },
 
-            { xpos,     ypos + h,   0.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 0.0f }
+            { xpos,     ypos + h,   u0, v1 },
+            { xpos + w, ypos + h,   u1, v1 },
+            { xpos + w, ypos,       u1, v0 }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        this->Vertices.insert(this->Vertices.end(), &vertices[0][0], &vertices[0][0] + 6 * 4);
         // now advance cursors for next glyph
-        x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
+        x += (ch->Advance >> 6) * scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
     }
+    if (this->Vertices.empty())
+        return;
+
+    // activate corresponding render state	
+    this->TextShader.Use();
+    this->TextShader.SetVector3f("textColor", color);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, this->Atlas);
+    glBindVertexArray(this->VAO);
+    // respecify the buffer each call so the driver does not wait on the previous draw
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    glBufferData(GL_ARRAY_BUFFER, this->Vertices.size() * sizeof(float), this->Vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // all glyphs in a single draw
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(this->Vertices.size() / 4));
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+}
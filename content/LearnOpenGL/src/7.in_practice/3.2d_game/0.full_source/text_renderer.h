@@ -9,10 +9,13 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <ft2build.h>
+#include FT_FREETYPE_H
 
 #include "texture.h"
 #include "shader.h"
@@ -20,7 +23,7 @@
 
 /// Holds all state information relevant to a character as loaded using FreeType
 struct Character {
-    unsigned int TextureID; // ID handle of the glyph texture
+    glm::ivec2   Offset;    // top left corner of glyph in the atlas
     glm::ivec2   Size;      // size of glyph
     glm::ivec2   Bearing;   // offset from baseline to left/top of glyph
     unsigned int Advance;   // horizontal offset to advance to next glyph
@@ -28,24 +31,41 @@ struct Character {
 
 
 // A renderer class for rendering text displayed by a font loaded using the 
-// FreeType library. A single font is loaded, processed into a list of Character
-// items for later rendering.
+// FreeType library. Glyphs are loaded the first time a code point is used and
+// packed into a single atlas texture, so any UTF-8 string is rendered with
+// one draw call.
 class TextRenderer
 {
 public:
-    // holds a list of pre-compiled Characters
-    std::map<char, Character> Characters; 
+    // holds the glyphs loaded so far, by Unicode code point
+    std::unordered_map<unsigned int, Character> Characters; 
     // shader used for text rendering
     Shader TextShader;
-    // constructor
+    // constructor/destructor
     TextRenderer(unsigned int width, unsigned int height);
-    // pre-compiles a list of characters from the given font
+    ~TextRenderer();
+    // opens the given font and pre-loads the ASCII characters
     void Load(std::string font, unsigned int fontSize);
-    // renders a string of text using the precompiled list of characters
+    // renders a UTF-8 string of text, loading characters it has not seen yet
     void RenderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
 private:
     // render state
     unsigned int VAO, VBO;
+    unsigned int Atlas;
+    // font stays open so new characters can be loaded at any time
+    FT_Library Library;
+    FT_Face    Face;
+    // atlas packing state, glyphs are placed in rows left to right
+    unsigned int AtlasWidth, AtlasHeight;
+    unsigned int PenX, PenY, RowHeight;
+    std::vector<unsigned char> AtlasPixels;
+    // vertices of the last rendered text, kept to avoid allocating every frame
+    std::vector<float> Vertices;
+    // loads a glyph into the atlas, returns nullptr when no font is loaded; glyphs that fail to load
+    // or do not fit in an atlas row are cached with an empty size
+    const Character *loadCharacter(unsigned int codepoint);
+    // doubles the atlas height and re-uploads it
+    void growAtlas();
 };
 
-#endif 
\ No newline at end of file
+#endif 
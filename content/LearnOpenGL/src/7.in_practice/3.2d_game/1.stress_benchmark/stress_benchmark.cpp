@@ -0,0 +1,65 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../0.full_source/game.h"
+
+// Headless stress benchmark: drives Game::Update on a large generated
+// level with a large particle pool, without creating a window or any
+// OpenGL context, and reports the CPU time spent per frame.
+//
+// usage: stress_benchmark [columns] [rows] [particles] [frames]
+
+int main(int argc, char *argv[])
+{
+    unsigned int columns   = argc > 1 ? std::atoi(argv[1]) : 400;
+    unsigned int rows      = argc > 2 ? std::atoi(argv[2]) : 250;
+    unsigned int particles = argc > 3 ? std::atoi(argv[3]) : 1000000;
+    unsigned int frames    = argc > 4 ? std::atoi(argv[4]) : 1000;
+    const float  dt        = 1.0f / 60.0f;
+
+    // the level spans the upper half of a playing field sized so every brick is 8x4 units
+    unsigned int width = std::max(800u, columns * 8), height = std::max(600u, rows * 8);
+    Game breakout(width, height);
+    breakout.InitHeadless(particles);
+    GameLevel level;
+    level.Generate(columns, rows, width, height / 2);
+    breakout.Levels.push_back(level);
+    breakout.State = GAME_ACTIVE;
+    breakout.Lives = frames + 1; // never run out of lives (and reload a level from disk) while measuring
+    // spawn enough particles per frame to keep the whole pool alive (particles live for one second)
+    breakout.ParticlesPerFrame = static_cast<unsigned int>(particles * dt) + 1;
+    // keep launching the ball whenever it is reset onto the paddle
+    breakout.Keys[GLFW_KEY_SPACE] = true;
+
+    std::cout << "bricks: " << breakout.Levels[0].Bricks.size() << ", particles: " << particles << ", frames: " << frames << std::endl;
+
+    double total = 0.0, worst = 0.0;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        breakout.ProcessInput(dt);
+        breakout.Update(dt);
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        total += ms;
+        worst = std::max(worst, ms);
+    }
+
+    unsigned int destroyed = 0;
+    for (const GameObject &brick : breakout.Levels[0].Bricks)
+        if (brick.Destroyed)
+            ++destroyed;
+    std::cout << "update: " << total / frames << " ms average, " << worst << " ms worst" << std::endl;
+    std::cout << "bricks destroyed: " << destroyed << ", power-ups alive: " << breakout.PowerUps.size() << std::endl;
+    return 0;
+}
@@ -1,9 +1,18 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aInstanceModel;
+
+layout (std140, binding = 0) uniform LightSpaceMatrices
+{
+    mat4 lightSpaceMatrices[16];
+};
 
 uniform mat4 model;
+uniform bool instanced;
+uniform int cascadeIndex;
 
 void main()
 {
-    gl_Position = model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    mat4 world = instanced ? aInstanceModel : model;
+    gl_Position = lightSpaceMatrices[cascadeIndex] * world * vec4(aPos, 1.0);
+}
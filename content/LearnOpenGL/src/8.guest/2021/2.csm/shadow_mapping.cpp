@@ -10,6 +10,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
+#include <learnopengl/cascaded_shadows.h>
 
 #include <iostream>
 #include <random>
@@ -20,6 +21,9 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
 unsigned int loadTexture(const char *path);
 void renderScene(const Shader &shader);
+void renderShadowCascades(const Shader &shader);
+void createCasters();
+void initCube();
 void renderCube();
 void renderQuad();
 std::vector<glm::mat4> getLightSpaceMatrices();
@@ -47,6 +51,8 @@ int debugLayer = 0;
 
 // meshes
 unsigned int planeVAO;
+unsigned int cubeVAO = 0;
+unsigned int cubeVBO = 0;
 
 // lighting info
 // -------------
@@ -62,6 +68,15 @@ std::mt19937 generator = std::mt19937(device());
 
 std::vector<glm::mat4> lightMatricesCache;
 
+// shadow casters: the cubes' model matrices and bounding spheres, and per cascade the cubes it draws
+std::vector<glm::mat4> modelMatrices;
+ShadowCasters casterBounds;
+std::vector<ShadowCascade> cascades;
+std::vector<std::vector<unsigned int>> cascadeCasters;
+std::vector<glm::mat4> cascadeInstances;
+unsigned int instanceVBO;
+unsigned int instancedCubeVAO;
+
 int main()
 {
     //generator.seed(2);
@@ -108,7 +123,7 @@ int main()
     // build and compile shaders
     // -------------------------
     Shader shader("10.shadow_mapping.vs", "10.shadow_mapping.fs");
-    Shader simpleDepthShader("10.shadow_mapping_depth.vs", "10.shadow_mapping_depth.fs", "10.shadow_mapping_depth.gs");
+    Shader simpleDepthShader("10.shadow_mapping_depth.vs", "10.shadow_mapping_depth.fs");
     Shader debugDepthQuad("10.debug_quad.vs", "10.debug_quad_depth.fs");
     Shader debugCascadeShader("10.debug_cascade.vs", "10.debug_cascade.fs");
 
@@ -138,6 +153,24 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glBindVertexArray(0);
 
+    // casters and the cube VAO the shadow pass draws them with, one model matrix per instance
+    createCasters();
+    initCube();
+    glGenBuffers(1, &instanceVBO);
+    glGenVertexArrays(1, &instancedCubeVAO);
+    glBindVertexArray(instancedCubeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(3 + i, 1);
+    }
+    glBindVertexArray(0);
+
     // load textures
     // -------------
     unsigned int woodTexture = loadTexture(FileSystem::getPath("resources/textures/wood.png").c_str());
@@ -232,9 +265,8 @@ int main()
 
         glBindFramebuffer(GL_FRAMEBUFFER, lightFBO);
         glViewport(0, 0, depthMapResolution, depthMapResolution);
-        glClear(GL_DEPTH_BUFFER_BIT);
         glCullFace(GL_FRONT);  // peter panning
-        renderScene(simpleDepthShader);
+        renderShadowCascades(simpleDepthShader);
         glCullFace(GL_BACK);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -313,38 +345,97 @@ void renderScene(const Shader &shader)
     glBindVertexArray(planeVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
-    static std::vector<glm::mat4> modelMatrices;
-    if (modelMatrices.size() == 0)
+    for (const auto& model : modelMatrices)
+    {
+        shader.setMat4("model", model);
+        renderCube();
+    }
+}
+
+// renders the casters into every cascade's layer of the shadow map; each cascade draws the floor
+// and, in one instanced draw, only the cubes whose bounding spheres overlap its box
+// --------------------------------------------------------------------------------------------------
+void renderShadowCascades(const Shader &shader)
+{
+    CascadedShadows::cullCasters(casterBounds, CascadedShadows::lightView(lightDir), cascades, cascadeCasters);
+
+    // the instances of all cascades go in one buffer, each cascade draws its own range of it
+    cascadeInstances.clear();
+    for (const auto& casters : cascadeCasters)
     {
-        for (int i = 0; i < 10; ++i)
+        for (unsigned int caster : casters)
+            cascadeInstances.push_back(modelMatrices[caster]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, cascadeInstances.size() * sizeof(glm::mat4), cascadeInstances.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    unsigned int baseInstance = 0;
+    for (size_t i = 0; i < cascades.size(); ++i)
+    {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, lightDepthMaps, 0, int(i));
+        glClear(GL_DEPTH_BUFFER_BIT);
+        shader.setInt("cascadeIndex", int(i));
+
+        shader.setBool("instanced", false);
+        shader.setMat4("model", glm::mat4(1.0f));
+        glBindVertexArray(planeVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        const unsigned int count = static_cast<unsigned int>(cascadeCasters[i].size());
+        if (count > 0)
         {
-            static std::uniform_real_distribution<float> offsetDistribution = std::uniform_real_distribution<float>(-10, 10);
-            static std::uniform_real_distribution<float> scaleDistribution = std::uniform_real_distribution<float>(1.0, 2.0);
-            static std::uniform_real_distribution<float> rotationDistribution = std::uniform_real_distribution<float>(0, 180);
-
-            auto model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(offsetDistribution(generator), offsetDistribution(generator) + 10.0f, offsetDistribution(generator)));
-            model = glm::rotate(model, glm::radians(rotationDistribution(generator)), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
-            model = glm::scale(model, glm::vec3(scaleDistribution(generator)));
-            modelMatrices.push_back(model);
+            shader.setBool("instanced", true);
+            glBindVertexArray(instancedCubeVAO);
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 36, count, baseInstance);
         }
+        baseInstance += count;
     }
+    glBindVertexArray(0);
+    // leave the whole array attached as it was created
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, lightDepthMaps, 0);
+}
 
-    for (const auto& model : modelMatrices)
+// places the randomly transformed cubes and keeps the bounding sphere of each for the shadow culling
+// --------------------------------------------------------------------------------------------------
+void createCasters()
+{
+    std::uniform_real_distribution<float> offsetDistribution = std::uniform_real_distribution<float>(-10, 10);
+    std::uniform_real_distribution<float> scaleDistribution = std::uniform_real_distribution<float>(1.0, 2.0);
+    std::uniform_real_distribution<float> rotationDistribution = std::uniform_real_distribution<float>(0, 180);
+
+    modelMatrices.clear();
+    casterBounds.clear();
+    for (int i = 0; i < 10; ++i)
     {
-        shader.setMat4("model", model);
-        renderCube();
+        const glm::vec3 position(offsetDistribution(generator), offsetDistribution(generator) + 10.0f, offsetDistribution(generator));
+        const float scale = scaleDistribution(generator);
+        auto model = glm::mat4(1.0f);
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(rotationDistribution(generator)), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
+        model = glm::scale(model, glm::vec3(scale));
+        modelMatrices.push_back(model);
+        // the cube spans [-1, 1] on every axis before scaling
+        casterBounds.add(position, scale * std::sqrt(3.0f));
     }
 }
 
 
 // renderCube() renders a 1x1 3D cube in NDC.
 // -------------------------------------------------
-unsigned int cubeVAO = 0;
-unsigned int cubeVBO = 0;
 void renderCube()
 {
     // initialize (if necessary)
+    if (cubeVAO == 0)
+        initCube();
+    // render Cube
+    glBindVertexArray(cubeVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(0);
+}
+
+void initCube()
+{
     if (cubeVAO == 0)
     {
         float vertices[] = {
@@ -407,10 +498,6 @@ void renderCube()
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
     }
-    // render Cube
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
 }
 
 // renderQuad() renders a 1x1 XY quad in NDC
@@ -659,80 +746,22 @@ std::vector<glm::vec4> getFrustumCornersWorldSpace(const glm::mat4& proj, const
     return getFrustumCornersWorldSpace(proj * view);
 }
 
-glm::mat4 getLightSpaceMatrix(const float nearPlane, const float farPlane)
+std::vector<glm::mat4> getLightSpaceMatrices()
 {
-    const auto proj = glm::perspective(
-        glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, nearPlane,
-        farPlane);
-    const auto corners = getFrustumCornersWorldSpace(proj, camera.GetViewMatrix());
-
-    glm::vec3 center = glm::vec3(0, 0, 0);
-    for (const auto& v : corners)
-    {
-        center += glm::vec3(v);
-    }
-    center /= corners.size();
-
-    const auto lightView = glm::lookAt(center + lightDir, center, glm::vec3(0.0f, 1.0f, 0.0f));
-
-    float minX = std::numeric_limits<float>::max();
-    float maxX = std::numeric_limits<float>::min();
-    float minY = std::numeric_limits<float>::max();
-    float maxY = std::numeric_limits<float>::min();
-    float minZ = std::numeric_limits<float>::max();
-    float maxZ = std::numeric_limits<float>::min();
-    for (const auto& v : corners)
-    {
-        const auto trf = lightView * v;
-        minX = std::min(minX, trf.x);
-        maxX = std::max(maxX, trf.x);
-        minY = std::min(minY, trf.y);
-        maxY = std::max(maxY, trf.y);
-        minZ = std::min(minZ, trf.z);
-        maxZ = std::max(maxZ, trf.z);
-    }
-
-    // Tune this parameter according to the scene
-    constexpr float zMult = 10.0f;
-    if (minZ < 0)
-    {
-        minZ *= zMult;
-    }
-    else
-    {
-        minZ /= zMult;
-    }
-    if (maxZ < 0)
-    {
-        maxZ /= zMult;
-    }
-    else
-    {
-        maxZ *= zMult;
-    }
+    // the camera's near plane, the cascade splits and its far plane
+    std::vector<float> splitDistances{ cameraNearPlane };
+    splitDistances.insert(splitDistances.end(), shadowCascadeLevels.begin(), shadowCascadeLevels.end());
+    splitDistances.push_back(cameraFarPlane);
 
-    const glm::mat4 lightProjection = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
+    // Tune the reach towards the light according to the scene, casters further out are clipped
+    constexpr float casterReach = 100.0f;
+    CascadedShadows::fitCascades(camera.Position, camera.Front, glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT,
+                                 splitDistances, lightDir, depthMapResolution, casterReach, cascades);
 
-    return lightProjection * lightView;
-}
-
-std::vector<glm::mat4> getLightSpaceMatrices()
-{
     std::vector<glm::mat4> ret;
-    for (size_t i = 0; i < shadowCascadeLevels.size() + 1; ++i)
+    for (const auto& cascade : cascades)
     {
-        if (i == 0)
-        {
-            ret.push_back(getLightSpaceMatrix(cameraNearPlane, shadowCascadeLevels[i]));
-        }
-        else if (i < shadowCascadeLevels.size())
-        {
-            ret.push_back(getLightSpaceMatrix(shadowCascadeLevels[i - 1], shadowCascadeLevels[i]));
-        }
-        else
-        {
-            ret.push_back(getLightSpaceMatrix(shadowCascadeLevels[i - 1], cameraFarPlane));
-        }
+        ret.push_back(cascade.lightSpace);
     }
     return ret;
 }
@@ -0,0 +1,122 @@
+#include <learnopengl/cascaded_shadows.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// Headless benchmark of the cascaded shadow map fitting and caster culling used by 2.csm.
+// No window or OpenGL context is created. 50K casters are scattered over the area the camera
+// flies through; every frame the cascades are fitted and each caster is assigned to the cascades
+// its bounding sphere overlaps. The original code rendered every caster into every cascade.
+//
+// usage: csm_culling_benchmark [casters] [frames]
+
+static double elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool overlaps(const ShadowCasters &casters, size_t i, const glm::mat4 &view, const ShadowCascade &cascade)
+{
+    const glm::vec3 light = glm::vec3(view * glm::vec4(casters.x[i], casters.y[i], casters.z[i], 1.0f));
+    const float r = casters.radius[i];
+    return glm::all(glm::greaterThanEqual(light + r, cascade.boxMin)) && glm::all(glm::lessThanEqual(light - r, cascade.boxMax));
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t casterCount = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    const float cameraFarPlane = 500.0f;
+    const std::vector<float> splitDistances{ 0.1f, cameraFarPlane / 50.0f, cameraFarPlane / 25.0f, cameraFarPlane / 10.0f, cameraFarPlane / 2.0f, cameraFarPlane };
+    const glm::vec3 lightDir = glm::normalize(glm::vec3(20.0f, 50, 20.0f));
+    const unsigned int resolution = 4096;
+    const float casterReach = 100.0f;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> ground(-1000.0f, 1000.0f), height(0.0f, 30.0f), size(0.5f, 3.0f);
+    ShadowCasters casters;
+    for (size_t i = 0; i < casterCount; i++)
+        casters.add(glm::vec3(ground(generator), height(generator), ground(generator)), size(generator));
+
+    const glm::mat4 view = CascadedShadows::lightView(lightDir);
+    std::vector<ShadowCascade> cascades;
+    std::vector<std::vector<unsigned int>> lists;
+    double fitTime = 0.0, cullTime = 0.0;
+    size_t culledRenders = 0;
+    bool stable = true, correct = true;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        // fly in a circle while turning the camera a little every frame
+        const float t = float(frame) / frames * glm::two_pi<float>();
+        const glm::vec3 position(400.0f * std::cos(t), 20.0f, 400.0f * std::sin(t));
+        const glm::vec3 front = glm::normalize(glm::vec3(-std::sin(t + 0.3f), -0.2f, std::cos(t + 0.3f)));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        CascadedShadows::fitCascades(position, front, glm::radians(45.0f), 16.0f / 9.0f, splitDistances, lightDir, resolution, casterReach, cascades);
+        fitTime += elapsedMs(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        CascadedShadows::cullCasters(casters, view, cascades, lists);
+        cullTime += elapsedMs(start);
+
+        for (size_t c = 0; c < cascades.size(); c++)
+        {
+            culledRenders += lists[c].size();
+            // the box starts on a whole texel, so moving the camera slides the shadow map by whole texels
+            const ShadowCascade &cascade = cascades[c];
+            const float texel = (cascade.boxMax.x - cascade.boxMin.x) / resolution;
+            const float offset = cascade.boxMin.x / texel;
+            if (std::fabs(offset - std::round(offset)) > 0.01f)
+                stable = false;
+        }
+
+        // compare one frame against a plain per caster test
+        if (frame == frames / 2)
+        {
+            for (size_t c = 0; c < cascades.size(); c++)
+            {
+                size_t next = 0;
+                for (size_t i = 0; i < casterCount; i++)
+                {
+                    if (!overlaps(casters, i, view, cascades[c]))
+                        continue;
+                    if (next >= lists[c].size() || lists[c][next] != i)
+                        correct = false;
+                    next++;
+                }
+                if (next != lists[c].size())
+                    correct = false;
+            }
+        }
+    }
+
+    // the radius must not change as the camera turns, so the size of every cascade is compared across a turn
+    std::vector<ShadowCascade> turned;
+    CascadedShadows::fitCascades(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::radians(45.0f), 16.0f / 9.0f, splitDistances, lightDir, resolution, casterReach, cascades);
+    CascadedShadows::fitCascades(glm::vec3(0.0f), glm::normalize(glm::vec3(0.3f, -0.4f, 0.8f)), glm::radians(45.0f), 16.0f / 9.0f, splitDistances, lightDir, resolution, casterReach, turned);
+    for (size_t c = 0; c < cascades.size(); c++)
+    {
+        if (cascades[c].boxMax.x - cascades[c].boxMin.x != turned[c].boxMax.x - turned[c].boxMin.x)
+            stable = false;
+    }
+
+    const size_t cascadeCount = splitDistances.size() - 1;
+    const double naiveRenders = double(casterCount) * cascadeCount;
+    printf("%zu casters, %zu cascades, %d frames\n", casterCount, cascadeCount, frames);
+    printf("fit:  %8.4f ms/frame\n", fitTime / frames);
+    printf("cull: %8.4f ms/frame\n", cullTime / frames);
+    printf("caster renders per frame: every cascade %.0f, culled %.0f (%.1f%% saved)\n",
+           naiveRenders, double(culledRenders) / frames, 100.0 * (1.0 - culledRenders / (naiveRenders * frames)));
+    printf("shadow draw calls per frame: one per caster %zu, batched per cascade %zu\n", casterCount, cascadeCount);
+
+    if (!stable || !correct)
+    {
+        std::cout << (stable ? "culling does not match the reference" : "cascades are not stable") << std::endl;
+        return 1;
+    }
+    return 0;
+}
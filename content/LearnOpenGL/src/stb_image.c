@@ -160,6 +160,14 @@ typedef unsigned char validate_uint32[sizeof(stbi__uint32) == 4 ? 1 : -1];
 
 #include <emmintrin.h>
 
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define STBI__SSSE3
+#include <tmmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #ifdef _MSC_VER
 
 #if _MSC_VER >= 1400  // not VC6
@@ -3276,6 +3284,8 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp) {
 // fast-way is faster to check than jpeg huffman, but slow way is slower
 #define STBI__ZFAST_BITS  9 // accelerate all cases in default tables
 #define STBI__ZFAST_MASK  ((1 << STBI__ZFAST_BITS) - 1)
+#define STBI__ZPAIR_BITS  11 // two literals whose codes fit in this many bits decode together
+#define STBI__ZPAIR_MASK  ((1 << STBI__ZPAIR_BITS) - 1)
 
 // zlib-style huffman encoding
 // (jpegs packs from left, zlib from right, so can't share code)
@@ -3366,6 +3376,7 @@ typedef struct {
     int z_expandable;
 
     stbi__zhuffman z_length, z_distance;
+    stbi__uint32 zpair[1 << STBI__ZPAIR_BITS]; // see stbi__zbuild_pairs
 } stbi__zbuf;
 
 stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z) {
@@ -3374,6 +3385,17 @@ stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z) {
 }
 
 static void stbi__fill_bits(stbi__zbuf *z) {
+    // with four bytes left, take the ones the loop below would in one load
+    if (z->zbuffer_end - z->zbuffer >= 4) {
+        stbi_uc *b = z->zbuffer;
+        int k = (32 - z->num_bits) >> 3;
+        stbi__uint32 v = b[0] | (stbi__uint32) b[1] << 8 | (stbi__uint32) b[2] << 16 | (stbi__uint32) b[3] << 24;
+        if (k < 4) v &= (1u << (8 * k)) - 1;
+        z->code_buffer |= v << z->num_bits;
+        z->zbuffer += k;
+        z->num_bits += 8 * k;
+        return;
+    }
     do {
         STBI_ASSERT(z->code_buffer < (1U << z->num_bits));
         z->code_buffer |= (unsigned int) stbi__zget8(z) << z->num_bits;
@@ -3420,6 +3442,24 @@ stbi_inline static int stbi__zhuffman_decode(stbi__zbuf *a, stbi__zhuffman *z) {
     return stbi__zhuffman_decode_slowpath(a, z);
 }
 
+// For each STBI__ZPAIR_BITS bit pattern that starts with two literal codes,
+// store both literals and their total length, so that the block decoder can
+// output them with one lookup; 0 for the others. Both codes come from the
+// fast table and must fit in the bits of the lookup.
+static void stbi__zbuild_pairs(stbi__zbuf *a) {
+    stbi__zhuffman *z = &a->z_length;
+    int i;
+    for (i = 0; i < (1 << STBI__ZPAIR_BITS); ++i) {
+        int first = z->fast[i & STBI__ZFAST_MASK], second, s;
+        a->zpair[i] = 0;
+        if (!first || (first & 511) >= 256) continue;
+        s = first >> 9;
+        second = z->fast[(i >> s) & STBI__ZFAST_MASK];
+        if (!second || (second & 511) >= 256 || s + (second >> 9) > STBI__ZPAIR_BITS) continue;
+        a->zpair[i] = (stbi__uint32) (((s + (second >> 9)) << 16) | ((second & 511) << 8) | (first & 511));
+    }
+}
+
 static int stbi__zexpand(stbi__zbuf *z, char *zout, int n)  // need to make room for n bytes
 {
     char *q;
@@ -3457,7 +3497,19 @@ static int stbi__zdist_extra[32] =
 static int stbi__parse_huffman_block(stbi__zbuf *a) {
     char *zout = a->zout;
     for (;;) {
-        int z = stbi__zhuffman_decode(a, &a->z_length);
+        stbi__uint32 pair;
+        int z;
+        if (a->num_bits < 16) stbi__fill_bits(a);
+        pair = a->zpair[a->code_buffer & STBI__ZPAIR_MASK];
+        if (pair && zout + 2 <= a->zout_end) {
+            zout[0] = (char) (pair & 255);
+            zout[1] = (char) ((pair >> 8) & 255);
+            zout += 2;
+            a->code_buffer >>= pair >> 16;
+            a->num_bits -= (int) (pair >> 16);
+            continue;
+        }
+        z = stbi__zhuffman_decode(a, &a->z_length);
         if (z < 256) {
             if (z < 0) return stbi__err("bad huffman code", "Corrupt PNG"); // error in huffman codes
             if (zout >= a->zout_end) {
@@ -3486,8 +3538,18 @@ static int stbi__parse_huffman_block(stbi__zbuf *a) {
             }
             p = (stbi_uc *) (zout - dist);
             if (dist == 1) { // run of one byte; common in images.
-                stbi_uc v = *p;
-                if (len) { do *zout++ = v; while (--len); }
+                memset(zout, *p, len);
+                zout += len;
+            } else if (dist >= 8 && a->zout_end - zout >= len + 8) {
+                // 8 bytes at a time, which the distance keeps from overlapping; the last
+                // copy may go past len, into bytes that are written after this anyway
+                char *end = zout + len;
+                do {
+                    memcpy(zout, p, 8);
+                    zout += 8;
+                    p += 8;
+                } while (zout < end);
+                zout = end;
             } else {
                 if (len) { do *zout++ = *p++; while (--len); }
             }
@@ -3618,6 +3680,7 @@ static int stbi__parse_zlib(stbi__zbuf *a, int parse_header) {
             } else {
                 if (!stbi__compute_huffman_codes(a)) return 0;
             }
+            stbi__zbuild_pairs(a);
             if (!stbi__parse_huffman_block(a)) return 0;
         }
     } while (!final);
@@ -3764,17 +3827,157 @@ static stbi_uc first_row_filter[5] =
         };
 
 static int stbi__paeth(int a, int b, int c) {
-    int p = a + b - c;
-    int pa = abs(p - a);
-    int pb = abs(p - b);
-    int pc = abs(p - c);
-    if (pa <= pb && pa <= pc) return a;
-    if (pb <= pc) return b;
-    return c;
+    // picks the same predictor as the reference code in the PNG spec, rearranged
+    // into compares against one threshold so that it compiles without branches
+    int thresh = c * 3 - (a + b);
+    int lo = a < b ? a : b;
+    int hi = a < b ? b : a;
+    int t0 = (hi <= thresh) ? lo : c;
+    return (thresh <= lo) ? hi : t0;
 }
 
 static stbi_uc stbi__depth_scale_table[9] = {0, 0xff, 0x55, 0, 0x11, 0, 0, 0, 0x01};
 
+#if defined(STBI_SSE2) && (defined(STBI__X64_TARGET) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STBI__PNG_SSE2
+#endif
+
+#ifdef STBI__PNG_SSE2
+// SIMD forms of the filter loops in stbi__create_png_image_raw. Sub, Avg and
+// Paeth depend on the pixel to the left, so they go one pixel at a time with
+// its channels side by side in a register; Up goes 16 or 32 bytes at a time.
+
+// a three byte pixel is moved as two bytes and one, so as not to touch the next row
+stbi_inline static __m128i stbi__png_load_pixel(stbi_uc const *p, int n) {
+    stbi__uint32 v;
+    if (n == 4) {
+        memcpy(&v, p, 4);
+    } else {
+        stbi__uint16 lo;
+        memcpy(&lo, p, 2);
+        v = lo | (stbi__uint32) p[2] << 16;
+    }
+    return _mm_cvtsi32_si128((int) v);
+}
+
+stbi_inline static void stbi__png_store_pixel(stbi_uc *p, __m128i v, int n) {
+    stbi__uint32 v32 = (stbi__uint32) _mm_cvtsi128_si32(v);
+    if (n == 4) {
+        memcpy(p, &v32, 4);
+    } else {
+        stbi__uint16 lo = (stbi__uint16) v32;
+        memcpy(p, &lo, 2);
+        p[2] = (stbi_uc) (v32 >> 16);
+    }
+}
+
+stbi_inline static __m128i stbi__png_abs16(__m128i v) {
+#ifdef STBI__SSSE3
+    return _mm_abs_epi16(v);
+#else
+    return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+#endif
+}
+
+static void stbi__png_unfilter_up_sse2(stbi_uc *cur, stbi_uc const *prior, stbi_uc const *raw, int n) {
+    int k = 0;
+#ifdef __AVX2__
+    for (; k + 32 <= n; k += 32) {
+        __m256i r = _mm256_loadu_si256((__m256i const *) (raw + k));
+        __m256i p = _mm256_loadu_si256((__m256i const *) (prior + k));
+        _mm256_storeu_si256((__m256i *) (cur + k), _mm256_add_epi8(r, p));
+    }
+#endif
+    for (; k + 16 <= n; k += 16) {
+        __m128i r = _mm_loadu_si128((__m128i const *) (raw + k));
+        __m128i p = _mm_loadu_si128((__m128i const *) (prior + k));
+        _mm_storeu_si128((__m128i *) (cur + k), _mm_add_epi8(r, p));
+    }
+    for (; k < n; ++k)
+        cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
+}
+
+// img_n bytes per pixel in raw, out_n in cur, where out_n > img_n adds an
+// opaque alpha byte. cur and prior point at the second pixel of their rows.
+stbi_inline static int stbi__png_unfilter_pixels_sse2(int filter, stbi_uc *cur, stbi_uc const *prior, stbi_uc const *raw, int pixels, int img_n, int out_n) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i alpha = out_n > img_n ? _mm_cvtsi32_si128((int) (0xffu << (8 * img_n))) : zero;
+    __m128i a = stbi__png_load_pixel(cur - out_n, img_n);
+    int i = 0;
+
+    switch (filter) {
+        case STBI__F_sub:
+        case STBI__F_paeth_first: // paeth(a, 0, 0) is a
+            if (img_n == 4 && out_n == 4) {
+                // add each of four pixels to the ones after it, then the one before
+                for (; i + 4 <= pixels; i += 4, raw += 16, cur += 16) {
+                    __m128i x = _mm_loadu_si128((__m128i const *) raw);
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+                    x = _mm_add_epi8(x, _mm_shuffle_epi32(a, 0x00));
+                    _mm_storeu_si128((__m128i *) cur, x);
+                    a = _mm_shuffle_epi32(x, 0xff);
+                }
+            }
+            for (; i < pixels; ++i, raw += img_n, cur += out_n) {
+                a = _mm_or_si128(_mm_add_epi8(a, stbi__png_load_pixel(raw, img_n)), alpha);
+                stbi__png_store_pixel(cur, a, out_n);
+            }
+            return 1;
+        case STBI__F_up:
+            for (; i < pixels; ++i, raw += img_n, cur += out_n, prior += out_n) {
+                a = _mm_add_epi8(stbi__png_load_pixel(raw, img_n), stbi__png_load_pixel(prior, img_n));
+                stbi__png_store_pixel(cur, _mm_or_si128(a, alpha), out_n);
+            }
+            return 1;
+        case STBI__F_avg:
+            for (; i < pixels; ++i, raw += img_n, cur += out_n, prior += out_n) {
+                __m128i b = stbi__png_load_pixel(prior, img_n);
+                // _mm_avg_epu8 rounds up where (a + b) >> 1 rounds down
+                __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+                a = _mm_or_si128(_mm_add_epi8(avg, stbi__png_load_pixel(raw, img_n)), alpha);
+                stbi__png_store_pixel(cur, a, out_n);
+            }
+            return 1;
+        case STBI__F_paeth: {
+            __m128i c = _mm_unpacklo_epi8(stbi__png_load_pixel(prior - out_n, img_n), zero);
+            a = _mm_unpacklo_epi8(a, zero);
+            for (; i < pixels; ++i, raw += img_n, cur += out_n, prior += out_n) {
+                __m128i b = _mm_unpacklo_epi8(stbi__png_load_pixel(prior, img_n), zero);
+                __m128i pa = stbi__png_abs16(_mm_sub_epi16(b, c));
+                __m128i pb = stbi__png_abs16(_mm_sub_epi16(a, c));
+                __m128i pc = stbi__png_abs16(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c)));
+                __m128i smallest = _mm_min_epi16(pa, _mm_min_epi16(pb, pc));
+                // ties go to a, then b, as in stbi__paeth
+                __m128i use_a = _mm_cmpeq_epi16(pa, smallest);
+                __m128i use_b = _mm_cmpeq_epi16(pb, smallest);
+                __m128i pred = _mm_or_si128(_mm_and_si128(use_b, b), _mm_andnot_si128(use_b, c));
+                pred = _mm_or_si128(_mm_and_si128(use_a, a), _mm_andnot_si128(use_a, pred));
+                a = _mm_unpacklo_epi8(stbi__png_load_pixel(raw, img_n), zero);
+                a = _mm_and_si128(_mm_add_epi16(pred, a), _mm_set1_epi16(0xff));
+                stbi__png_store_pixel(cur, _mm_or_si128(_mm_packus_epi16(a, a), alpha), out_n);
+                c = b;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// returns 0 for the cases left to the C loops
+static int stbi__png_unfilter_sse2(int filter, stbi_uc *cur, stbi_uc const *prior, stbi_uc const *raw, int pixels, int img_n, int out_n) {
+    if (filter == STBI__F_up && img_n == out_n) {
+        stbi__png_unfilter_up_sse2(cur, prior, raw, pixels * img_n);
+        return 1;
+    }
+    // constant sizes, so that the pixel loads and stores are single moves
+    if (img_n == 3 && out_n == 3) return stbi__png_unfilter_pixels_sse2(filter, cur, prior, raw, pixels, 3, 3);
+    if (img_n == 3 && out_n == 4) return stbi__png_unfilter_pixels_sse2(filter, cur, prior, raw, pixels, 3, 4);
+    if (img_n == 4 && out_n == 4) return stbi__png_unfilter_pixels_sse2(filter, cur, prior, raw, pixels, 4, 4);
+    return 0;
+}
+#endif // STBI__PNG_SSE2
+
 // create the png data from post-deflated data
 static int
 stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y,
@@ -3871,6 +4074,10 @@ stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int
         // this is a little gross, so that we don't switch per-pixel or per-component
         if (depth < 8 || img_n == out_n) {
             int nk = (width - 1) * filter_bytes;
+#ifdef STBI__PNG_SSE2
+            if (stbi__png_unfilter_sse2(filter, cur, prior, raw, width - 1, filter_bytes, filter_bytes))
+                filter = -1; // done, skip the loops below
+#endif
 #define STBI__CASE(f) \
              case f:     \
                 for (k=0; k < nk; ++k)
@@ -3901,6 +4108,12 @@ stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int
             raw += nk;
         } else {
             STBI_ASSERT(img_n + 1 == out_n);
+#ifdef STBI__PNG_SSE2
+            if (depth == 8 && stbi__png_unfilter_sse2(filter, cur, prior, raw, x - 1, img_n, out_n)) {
+                raw += (x - 1) * img_n;
+                filter = -1; // done, skip the loops below
+            }
+#endif
 #define STBI__CASE(f) \
              case f:     \
                 for (i=x-1; i >= 1; --i, cur[filter_bytes]=255,raw+=filter_bytes,cur+=output_bytes,prior+=output_bytes) \
@@ -6481,4 +6694,112 @@ STBIDEF int stbi_info_from_callbacks(stbi_io_callbacks const *c, void *user, int
     stbi__context s;
     stbi__start_callbacks(&s, (stbi_io_callbacks *) c, user);
     return stbi__info_main(&s, x, y, comp);
-}
\ No newline at end of file
+}
+
+#if defined(STBI_THREADS) && !defined(STBI_NO_STDIO)
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define STBI__BATCH_MAX_THREADS 64
+
+typedef struct {
+    char const * const *filenames;
+    stbi_batch_image *images;
+    int count, next, desired_channels;
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+#else
+    pthread_mutex_t lock;
+#endif
+} stbi__batch;
+
+static int stbi__batch_take(stbi__batch *b) {
+    int i;
+#ifdef _WIN32
+    EnterCriticalSection(&b->lock);
+    i = b->next++;
+    LeaveCriticalSection(&b->lock);
+#else
+    pthread_mutex_lock(&b->lock);
+    i = b->next++;
+    pthread_mutex_unlock(&b->lock);
+#endif
+    return i;
+}
+
+// each worker decodes the next file in the list until there are none left
+#ifdef _WIN32
+static DWORD WINAPI stbi__batch_worker(LPVOID arg)
+#else
+static void *stbi__batch_worker(void *arg)
+#endif
+{
+    stbi__batch *b = (stbi__batch *) arg;
+    int i;
+    while ((i = stbi__batch_take(b)) < b->count) {
+        stbi_batch_image *image = &b->images[i];
+        image->data = stbi_load(b->filenames[i], &image->x, &image->y, &image->channels_in_file, b->desired_channels);
+    }
+    return 0;
+}
+
+STBIDEF void stbi_init_threads(void) {
+#ifndef STBI_NO_ZLIB
+    // the fixed code lengths are filled in on first use; do that before there are other threads
+    if (!stbi__zdefault_distance[31]) stbi__init_zdefaults();
+#endif
+}
+
+STBIDEF int stbi_load_batch(char const * const *filenames, int count, stbi_batch_image *images, int desired_channels, int num_threads) {
+    stbi__batch b;
+    int i, started = 0, loaded = 0;
+#ifdef _WIN32
+    HANDLE threads[STBI__BATCH_MAX_THREADS];
+#else
+    pthread_t threads[STBI__BATCH_MAX_THREADS];
+#endif
+
+    if (count <= 0) return 0;
+    if (num_threads > count) num_threads = count;
+    if (num_threads > STBI__BATCH_MAX_THREADS) num_threads = STBI__BATCH_MAX_THREADS;
+    memset(images, 0, count * sizeof(*images));
+    b.filenames = filenames;
+    b.images = images;
+    b.count = count;
+    b.next = 0;
+    b.desired_channels = desired_channels;
+
+    stbi_init_threads();
+#ifdef _WIN32
+    InitializeCriticalSection(&b.lock);
+    for (i = 1; i < num_threads; ++i)
+        if ((threads[started] = CreateThread(NULL, 0, stbi__batch_worker, &b, 0, NULL)) != NULL) ++started;
+#else
+    pthread_mutex_init(&b.lock, NULL);
+    for (i = 1; i < num_threads; ++i)
+        if (pthread_create(&threads[started], NULL, stbi__batch_worker, &b) == 0) ++started;
+#endif
+
+    // the calling thread is a worker too, so the batch finishes even if no thread started
+    stbi__batch_worker(&b);
+
+#ifdef _WIN32
+    for (i = 0; i < started; ++i) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+    DeleteCriticalSection(&b.lock);
+#else
+    for (i = 0; i < started; ++i)
+        pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&b.lock);
+#endif
+
+    for (i = 0; i < count; ++i)
+        if (images[i].data) ++loaded;
+    return loaded;
+}
+#endif // STBI_THREADS
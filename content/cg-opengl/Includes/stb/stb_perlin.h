@@ -61,6 +61,29 @@
 // float stb_perlin_turbulence_noise3(float x, float y, float z,
 //                                    float lacunarity, float gain, int octaves)
 //
+// Rows:
+//
+// Terrain and texture generators usually sample a grid, so each function above
+// also has a _row version that fills out[0..count-1] with the samples at
+// (x + i*dx, y, z). The y and z lattice work is done once per row, and with
+// SSE2 four samples are evaluated at a time. The results are the same as
+// calling the single sample functions in a loop.
+//
+// void stb_perlin_noise3_row(float *out, int count, float x, float dx, float y, float z,
+//                            int x_wrap, int y_wrap, int z_wrap, int seed)
+//
+// void stb_perlin_ridge_noise3_row(float *out, int count, float x, float dx, float y, float z,
+//                                  float lacunarity, float gain, float offset, int octaves)
+//
+// void stb_perlin_fbm_noise3_row(float *out, int count, float x, float dx, float y, float z,
+//                                float lacunarity, float gain, int octaves)
+//
+// void stb_perlin_turbulence_noise3_row(float *out, int count, float x, float dx, float y, float z,
+//                                       float lacunarity, float gain, int octaves)
+//
+// Define STB_PERLIN_NO_SIMD to use the scalar code on SSE2 targets too.
+//
+//
 // Typical values to start playing with:
 //     octaves    =   6     -- number of "octaves" of noise3() to sum
 //     lacunarity = ~ 2.0   -- spacing between successive octaves (use exactly 2.0 for wrapping output)
@@ -81,6 +104,10 @@ extern float stb_perlin_noise3(float x, float y, float z, int x_wrap, int y_wrap
 extern float stb_perlin_ridge_noise3(float x, float y, float z, float lacunarity, float gain, float offset, int octaves);
 extern float stb_perlin_fbm_noise3(float x, float y, float z, float lacunarity, float gain, int octaves);
 extern float stb_perlin_turbulence_noise3(float x, float y, float z, float lacunarity, float gain, int octaves);
+extern void  stb_perlin_noise3_row(float *out, int count, float x, float dx, float y, float z, int x_wrap, int y_wrap, int z_wrap, int seed);
+extern void  stb_perlin_ridge_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, float offset, int octaves);
+extern void  stb_perlin_fbm_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, int octaves);
+extern void  stb_perlin_turbulence_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, int octaves);
 #ifdef __cplusplus
 }
 #endif
@@ -89,6 +116,11 @@ extern float stb_perlin_turbulence_noise3(float x, float y, float z, float lacun
 
 #include <math.h> // fabs()
 
+#if !defined(STB_PERLIN_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STB_PERLIN_SSE2
+#include <emmintrin.h>
+#endif
+
 // not same permutation table as Perlin's reference to avoid copyright issues;
 // Perlin's table can be found at http://mrl.nyu.edu/~perlin/noise/
 static unsigned char stb__perlin_randtab[512] =
@@ -186,25 +218,25 @@ static int stb__perlin_fastfloor(float a)
 }
 
 // different grad function from Perlin's, but easy to modify to match reference
+static float stb__perlin_basis[12][4] =
+{
+   {  1, 1, 0 },
+   { -1, 1, 0 },
+   {  1,-1, 0 },
+   { -1,-1, 0 },
+   {  1, 0, 1 },
+   { -1, 0, 1 },
+   {  1, 0,-1 },
+   { -1, 0,-1 },
+   {  0, 1, 1 },
+   {  0,-1, 1 },
+   {  0, 1,-1 },
+   {  0,-1,-1 },
+};
+
 static float stb__perlin_grad(int grad_idx, float x, float y, float z)
 {
-   static float basis[12][4] =
-   {
-      {  1, 1, 0 },
-      { -1, 1, 0 },
-      {  1,-1, 0 },
-      { -1,-1, 0 },
-      {  1, 0, 1 },
-      { -1, 0, 1 },
-      {  1, 0,-1 },
-      { -1, 0,-1 },
-      {  0, 1, 1 },
-      {  0,-1, 1 },
-      {  0, 1,-1 },
-      {  0,-1,-1 },
-   };
-
-   float *grad = basis[grad_idx];
+   float *grad = stb__perlin_basis[grad_idx];
    return grad[0]*x + grad[1]*y + grad[2]*z;
 }
 
@@ -321,6 +353,169 @@ float stb_perlin_turbulence_noise3(float x, float y, float z, float lacunarity,
    return sum;
 }
 
+// rows are evaluated in chunks of this many samples
+#define STB__PERLIN_ROW_CHUNK  64
+
+#ifdef STB_PERLIN_SSE2
+static __m128 stb__perlin_ease4(__m128 a)
+{
+   __m128 r = _mm_sub_ps(_mm_mul_ps(a, _mm_set1_ps(6)), _mm_set1_ps(15));
+   r = _mm_add_ps(_mm_mul_ps(r, a), _mm_set1_ps(10));
+   return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(r, a), a), a);
+}
+
+static __m128 stb__perlin_lerp4(__m128 a, __m128 b, __m128 t)
+{
+   return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+// stb__perlin_grad for four gradient indices
+static __m128 stb__perlin_grad4(const unsigned char *grad_idx, __m128 x, __m128 y, __m128 z)
+{
+   float *g0 = stb__perlin_basis[grad_idx[0]];
+   float *g1 = stb__perlin_basis[grad_idx[1]];
+   float *g2 = stb__perlin_basis[grad_idx[2]];
+   float *g3 = stb__perlin_basis[grad_idx[3]];
+   __m128 gx = _mm_setr_ps(g0[0], g1[0], g2[0], g3[0]);
+   __m128 gy = _mm_setr_ps(g0[1], g1[1], g2[1], g3[1]);
+   __m128 gz = _mm_setr_ps(g0[2], g1[2], g2[2], g3[2]);
+   return _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, x), _mm_mul_ps(gy, y)), _mm_mul_ps(gz, z));
+}
+#endif
+
+// out[i] = stb_perlin_noise3_internal(xs[i]*frequency, y, z, ...) for i < count
+static void stb__perlin_noise3_chunk(float *out, const float *xs, int count, float frequency, float y, float z, int x_wrap, int y_wrap, int z_wrap, unsigned char seed)
+{
+   int i = 0;
+#ifdef STB_PERLIN_SSE2
+   unsigned int x_mask = (x_wrap-1) & 255;
+   unsigned int y_mask = (y_wrap-1) & 255;
+   unsigned int z_mask = (z_wrap-1) & 255;
+   int py = stb__perlin_fastfloor(y);
+   int pz = stb__perlin_fastfloor(z);
+   int y0 = py & y_mask, y1 = (py+1) & y_mask;
+   int z0 = pz & z_mask, z1 = (pz+1) & z_mask;
+   float yf = y - py, zf = z - pz;
+   __m128 one = _mm_set1_ps(1);
+   __m128 y4 = _mm_set1_ps(yf), y4m1 = _mm_sub_ps(y4, one);
+   __m128 z4 = _mm_set1_ps(zf), z4m1 = _mm_sub_ps(z4, one);
+   __m128 v = _mm_set1_ps(stb__perlin_ease(yf));
+   __m128 w = _mm_set1_ps(stb__perlin_ease(zf));
+
+   for (; i+4 <= count; i += 4) {
+      __m128 x = _mm_mul_ps(_mm_loadu_ps(xs+i), _mm_set1_ps(frequency));
+      __m128i xi = _mm_cvttps_epi32(x);
+      // fastfloor: subtract one where truncation rounded up
+      __m128i px = _mm_add_epi32(xi, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(xi))));
+      __m128 xm1, u;
+      __m128 n000,n001,n010,n011,n100,n101,n110,n111;
+      unsigned char g[8][4];
+      int pxs[4], lane;
+
+      x = _mm_sub_ps(x, _mm_cvtepi32_ps(px));
+      xm1 = _mm_sub_ps(x, one);
+      u = stb__perlin_ease4(x);
+
+      _mm_storeu_si128((__m128i *) pxs, px);
+      for (lane = 0; lane < 4; ++lane) {
+         int r0 = stb__perlin_randtab[(pxs[lane] & x_mask) + seed];
+         int r1 = stb__perlin_randtab[((pxs[lane]+1) & x_mask) + seed];
+         int r00 = stb__perlin_randtab[r0+y0];
+         int r01 = stb__perlin_randtab[r0+y1];
+         int r10 = stb__perlin_randtab[r1+y0];
+         int r11 = stb__perlin_randtab[r1+y1];
+         g[0][lane] = stb__perlin_randtab_grad_idx[r00+z0];
+         g[1][lane] = stb__perlin_randtab_grad_idx[r00+z1];
+         g[2][lane] = stb__perlin_randtab_grad_idx[r01+z0];
+         g[3][lane] = stb__perlin_randtab_grad_idx[r01+z1];
+         g[4][lane] = stb__perlin_randtab_grad_idx[r10+z0];
+         g[5][lane] = stb__perlin_randtab_grad_idx[r10+z1];
+         g[6][lane] = stb__perlin_randtab_grad_idx[r11+z0];
+         g[7][lane] = stb__perlin_randtab_grad_idx[r11+z1];
+      }
+
+      n000 = stb__perlin_grad4(g[0], x  , y4  , z4  );
+      n001 = stb__perlin_grad4(g[1], x  , y4  , z4m1);
+      n010 = stb__perlin_grad4(g[2], x  , y4m1, z4  );
+      n011 = stb__perlin_grad4(g[3], x  , y4m1, z4m1);
+      n100 = stb__perlin_grad4(g[4], xm1, y4  , z4  );
+      n101 = stb__perlin_grad4(g[5], xm1, y4  , z4m1);
+      n110 = stb__perlin_grad4(g[6], xm1, y4m1, z4  );
+      n111 = stb__perlin_grad4(g[7], xm1, y4m1, z4m1);
+
+      _mm_storeu_ps(out+i, stb__perlin_lerp4(
+         stb__perlin_lerp4(stb__perlin_lerp4(n000,n001,w), stb__perlin_lerp4(n010,n011,w), v),
+         stb__perlin_lerp4(stb__perlin_lerp4(n100,n101,w), stb__perlin_lerp4(n110,n111,w), v), u));
+   }
+#endif
+   for (; i < count; ++i)
+      out[i] = stb_perlin_noise3_internal(xs[i]*frequency, y, z, x_wrap, y_wrap, z_wrap, seed);
+}
+
+void stb_perlin_noise3_row(float *out, int count, float x, float dx, float y, float z, int x_wrap, int y_wrap, int z_wrap, int seed)
+{
+   float xs[STB__PERLIN_ROW_CHUNK];
+   int base, i;
+   for (base = 0; base < count; base += STB__PERLIN_ROW_CHUNK) {
+      int n = count-base < STB__PERLIN_ROW_CHUNK ? count-base : STB__PERLIN_ROW_CHUNK;
+      for (i = 0; i < n; i++)
+         xs[i] = x + (base+i)*dx;
+      stb__perlin_noise3_chunk(out+base, xs, n, 1.0f, y, z, x_wrap, y_wrap, z_wrap, (unsigned char) seed);
+   }
+}
+
+// the octave loops of the functions above, a chunk of samples per octave
+enum { STB__PERLIN_FBM, STB__PERLIN_RIDGE, STB__PERLIN_TURBULENCE };
+
+static void stb__perlin_fractal_row(int kind, float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, float offset, int octaves)
+{
+   float xs[STB__PERLIN_ROW_CHUNK], r[STB__PERLIN_ROW_CHUNK], prev[STB__PERLIN_ROW_CHUNK];
+   int base, i, j;
+   for (base = 0; base < count; base += STB__PERLIN_ROW_CHUNK) {
+      int n = count-base < STB__PERLIN_ROW_CHUNK ? count-base : STB__PERLIN_ROW_CHUNK;
+      float frequency = 1.0f;
+      float amplitude = kind == STB__PERLIN_RIDGE ? 0.5f : 1.0f;
+      float *sum = out+base;
+      for (j = 0; j < n; j++) {
+         xs[j] = x + (base+j)*dx;
+         sum[j] = 0.0f;
+         prev[j] = 1.0f;
+      }
+      for (i = 0; i < octaves; i++) {
+         stb__perlin_noise3_chunk(r, xs, n, frequency, y*frequency, z*frequency, 0, 0, 0, (unsigned char) i);
+         for (j = 0; j < n; j++) {
+            if (kind == STB__PERLIN_RIDGE) {
+               float t = offset - (float) fabs(r[j]);
+               t = t*t;
+               sum[j] += t*amplitude*prev[j];
+               prev[j] = t;
+            } else if (kind == STB__PERLIN_FBM) {
+               sum[j] += r[j]*amplitude;
+            } else {
+               sum[j] += (float) fabs(r[j]*amplitude);
+            }
+         }
+         frequency *= lacunarity;
+         amplitude *= gain;
+      }
+   }
+}
+
+void stb_perlin_ridge_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, float offset, int octaves)
+{
+   stb__perlin_fractal_row(STB__PERLIN_RIDGE, out, count, x, dx, y, z, lacunarity, gain, offset, octaves);
+}
+
+void stb_perlin_fbm_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, int octaves)
+{
+   stb__perlin_fractal_row(STB__PERLIN_FBM, out, count, x, dx, y, z, lacunarity, gain, 0.0f, octaves);
+}
+
+void stb_perlin_turbulence_noise3_row(float *out, int count, float x, float dx, float y, float z, float lacunarity, float gain, int octaves)
+{
+   stb__perlin_fractal_row(STB__PERLIN_TURBULENCE, out, count, x, dx, y, z, lacunarity, gain, 0.0f, octaves);
+}
+
 #endif  // STB_PERLIN_IMPLEMENTATION
 
 /*
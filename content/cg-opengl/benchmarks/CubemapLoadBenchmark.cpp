@@ -0,0 +1,132 @@
+// Headless benchmark of the skybox face loading: no window or OpenGL context
+// is created. Six procedural faces are written as JPEG files, the way the
+// skybox face sets are shipped, and loaded the way CCubemap::LoadCubemap used
+// to (one face after the other), with CCubemapLoader on all cores, again
+// writing the KTX cache (cold) and from the KTX cache (warm). The staging
+// buffers have to match the serial decode byte for byte. A small odd sized RGBA set
+// checks that the channels and the padded KTX rows survive the cache.
+
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb/stb_image_write.h>
+
+#include "skybox/CubemapLoader.h"
+#include "timer/HighResolutionTimer.h"
+
+static const int RUNS = 3;
+
+static std::vector<std::string> WriteFaces(const char *prefix, const int &size, const int &channels, const bool &jpeg)
+{
+    std::vector<std::string> faces;
+    std::vector<unsigned char> pixels((size_t)size * size * channels);
+    for (int face = 0; face < 6; ++face) {
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                unsigned char *pixel = &pixels[((size_t)y * size + x) * channels];
+                for (int c = 0; c < channels; ++c) {
+                    pixel[c] = (unsigned char)(127.5f + 127.5f * sinf(x * 0.013f * (c + 1) + y * 0.0071f + face));
+                }
+            }
+        }
+        faces.push_back(std::string(prefix) + std::to_string(face) + (jpeg ? ".jpg" : ".png"));
+        if (jpeg) {
+            stbi_write_jpg(faces.back().c_str(), size, size, channels, pixels.data(), 90);
+        } else {
+            stbi_write_png(faces.back().c_str(), size, size, channels, pixels.data(), 0);
+        }
+    }
+    return faces;
+}
+
+// what CCubemap::LoadCubemap did before, one face after the other
+static void LoadSerial(const std::vector<std::string> &faces, SCubemapImage &image)
+{
+    stbi_set_flip_vertically_on_load(true);
+    image.pixels.clear();
+    for (const std::string &face : faces) {
+        unsigned char *data = stbi_load(face.c_str(), &image.width, &image.height, &image.channels, 0);
+        image.pixels.insert(image.pixels.end(), data, data + image.GetFaceSize());
+        stbi_image_free(data);
+    }
+}
+
+static bool SameImage(const SCubemapImage &expected, const SCubemapImage &actual)
+{
+    return expected.width == actual.width && expected.height == actual.height
+        && expected.channels == actual.channels && expected.pixels == actual.pixels;
+}
+
+static void RemoveFiles(const std::vector<std::string> &faces)
+{
+    for (const std::string &face : faces) {
+        remove(face.c_str());
+    }
+    remove(CCubemapLoader::GetCachePath(faces).c_str());
+}
+
+int main(int argc, char *argv[])
+{
+    const int size = argc > 1 ? atoi(argv[1]) : 2048;
+
+    std::vector<std::string> faces = WriteFaces("cubemap_benchmark_", size, 3, true);
+    const std::string cache = CCubemapLoader::GetCachePath(faces);
+    CCubemapLoader loader;
+    CHighResolutionTimer timer;
+    double serialTime = 1e30, parallelTime = 1e30, coldTime = 1e30, warmTime = 1e30;
+    SCubemapImage expected, cold, warm;
+    bool identical = true;
+
+    for (int run = 0; run < RUNS; ++run) {
+        timer.Start();
+        LoadSerial(faces, expected);
+        serialTime = std::min(serialTime, timer.Elapsed());
+
+        timer.Start();
+        bool loaded = loader.Decode(faces, cold);
+        parallelTime = std::min(parallelTime, timer.Elapsed());
+        identical = identical && loaded && SameImage(expected, cold);
+
+        remove(cache.c_str());
+        timer.Start();
+        loaded = loader.LoadCached(cache.c_str(), faces, cold);
+        coldTime = std::min(coldTime, timer.Elapsed());
+
+        timer.Start();
+        loaded = loader.LoadCached(cache.c_str(), faces, warm) && loaded;
+        warmTime = std::min(warmTime, timer.Elapsed());
+        identical = identical && loaded && SameImage(expected, cold) && SameImage(expected, warm);
+    }
+    RemoveFiles(faces);
+
+    std::cout << "6 x " << size << "^2 JPEG faces, " << loader.GetThreadCount() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  serial decode        " << std::setw(10) << serialTime << " ms" << std::endl
+              << "  parallel decode      " << std::setw(10) << parallelTime << " ms" << std::endl
+              << "  cold (decode, cache) " << std::setw(10) << coldTime << " ms" << std::endl
+              << "  warm (KTX cache)     " << std::setw(10) << warmTime << " ms" << std::endl;
+    if (!identical) {
+        std::cerr << "the cubemap differs from the serial decode" << std::endl;
+        return 1;
+    }
+
+    // 33 x 33 RGBA rows need no padding, 33 x 33 RGB rows do
+    for (int channels = 3; channels <= 4; ++channels) {
+        std::vector<std::string> small = WriteFaces("cubemap_check_", 33, channels, false);
+        LoadSerial(small, expected);
+        remove(CCubemapLoader::GetCachePath(small).c_str());
+        bool loaded = loader.LoadCached(CCubemapLoader::GetCachePath(small).c_str(), small, cold)
+                   && CCubemapLoader::LoadKTX(CCubemapLoader::GetCachePath(small).c_str(), small, warm);
+        RemoveFiles(small);
+        if (!loaded || !SameImage(expected, cold) || !SameImage(expected, warm)) {
+            std::cerr << channels << " channel faces do not survive the KTX cache" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Headless benchmark of the glyph cache: no window or OpenGL context is
+// created. 10K glyphs of mixed script text, drawn from a few thousand distinct
+// code points, are laid out with a cold cache, where every new code point is
+// rasterized to a distance field on the worker and packed into the atlas, and
+// then again frame after frame with a warm cache the way a HUD would.
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "font/GlyphCache.h"
+#include "timer/HighResolutionTimer.h"
+
+// src/resources of the source tree, whatever directory the benchmark is run from
+static std::string ResourcesPath()
+{
+#ifdef CG_RESOURCES_PATH
+    return CG_RESOURCES_PATH;
+#else
+    std::string source = __FILE__;
+    size_t slash = source.find_last_of("/\\");
+    return (slash == std::string::npos ? std::string(".") : source.substr(0, slash)) + "/../src/resources";
+#endif
+}
+
+static void AppendUtf8(std::string &text, const unsigned int &codePoint)
+{
+    if (codePoint < 0x80) {
+        text += char(codePoint);
+    } else if (codePoint < 0x800) {
+        text += char(0xC0 | (codePoint >> 6));
+        text += char(0x80 | (codePoint & 0x3F));
+    } else {
+        text += char(0xE0 | (codePoint >> 12));
+        text += char(0x80 | ((codePoint >> 6) & 0x3F));
+        text += char(0x80 | (codePoint & 0x3F));
+    }
+}
+
+static std::string MixedText(const size_t &glyphCount, size_t &codePointCount)
+{
+    // Latin, Greek, Cyrillic, Armenian, Hebrew and Arabic letters, punctuation, currency,
+    // arrows, maths and box drawing, so the cold run rasterizes and packs thousands of glyphs
+    const unsigned int ranges[][2] = {
+        { 0x0021, 0x007E }, { 0x00A1, 0x024F }, { 0x0370, 0x03FF }, { 0x0400, 0x052F },
+        { 0x0531, 0x058F }, { 0x05D0, 0x05EA }, { 0x0600, 0x06FF }, { 0x1E00, 0x1FFF },
+        { 0x2010, 0x205E }, { 0x20A0, 0x20BF }, { 0x2100, 0x214F }, { 0x2190, 0x22FF },
+        { 0x2500, 0x25FF }
+    };
+    std::vector<unsigned int> codePoints;
+    for (const auto &range : ranges) {
+        for (unsigned int c = range[0]; c <= range[1]; ++c) {
+            codePoints.push_back(c);
+        }
+    }
+    codePointCount = codePoints.size();
+
+    // a stride coprime to the count walks through all of them in a scattered order,
+    // words of one to eight glyphs and a line break every few words
+    const size_t stride = 7919;
+    std::string text;
+    size_t glyphs = 0, word = 0;
+    for (size_t i = 0; glyphs < glyphCount; ++word) {
+        for (size_t length = 1 + word % 8; length > 0 && glyphs < glyphCount; --length, ++glyphs) {
+            i = (i + stride) % codePoints.size();
+            AppendUtf8(text, codePoints[i]);
+        }
+        text += word % 12 == 11 ? '\n' : ' ';
+    }
+    return text;
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string font = argc > 1 ? argv[1] : ResourcesPath() + "/fonts/Arial.ttf";
+    const size_t glyphCount = 10000;
+    const int frames = 200;
+    size_t codePoints = 0;
+    const std::string text = MixedText(glyphCount, codePoints);
+
+    CHighResolutionTimer timer;
+    CGlyphCache cache;
+    timer.Start();
+    if (!cache.Load(font)) {
+        std::cerr << "cannot load " << font << std::endl;
+        return 1;
+    }
+    double loadTime = timer.Elapsed();
+
+    // cold: the layout only queues the glyphs it has not seen, the worker rasterizes them meanwhile
+    std::vector<SGlyphQuad> quads;
+    timer.Start();
+    cache.Layout(text, 0.0f, 0.0f, 20.0f, quads);
+    double coldLayoutTime = timer.Elapsed();
+    size_t coldQuads = quads.size();
+
+    timer.Start();
+    cache.Flush();
+    double rasterTime = timer.Elapsed();
+
+    // warm: everything is in the atlas, which is what every later frame sees
+    timer.Start();
+    for (int i = 0; i < frames; ++i) {
+        quads.clear();
+        cache.Layout(text, 0.0f, 0.0f, 20.0f, quads);
+        cache.Update();
+    }
+    double warmLayoutTime = timer.Elapsed() / frames;
+
+    std::cout << std::setw(10) << "glyphs" << std::setw(10) << "distinct" << std::setw(10) << "unique" << std::setw(12) << "atlas"
+              << std::setw(10) << "load ms" << std::setw(12) << "cold ms" << std::setw(12) << "raster ms"
+              << std::setw(12) << "warm ms" << std::setw(10) << "quads" << std::endl;
+    std::cout << std::setw(10) << glyphCount << std::setw(10) << codePoints << std::setw(10) << cache.GetGlyphCount()
+              << std::setw(12) << (std::to_string(cache.GetAtlasWidth()) + "x" + std::to_string(cache.GetAtlasHeight()))
+              << std::fixed << std::setprecision(3) << std::setw(10) << loadTime << std::setw(12) << coldLayoutTime
+              << std::setw(12) << rasterTime << std::setw(12) << warmLayoutTime << std::setw(10) << quads.size() << std::endl;
+
+    // the cold layout drew only what was ready, the warm one every visible glyph
+    if (quads.size() < coldQuads) {
+        std::cerr << "warm layout produced fewer quads than the cold one" << std::endl;
+        return 1;
+    }
+    cache.Release();
+    return 0;
+}
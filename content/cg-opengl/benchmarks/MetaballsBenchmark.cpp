@@ -0,0 +1,76 @@
+// Headless benchmark of the metaball polygonizer: no window or OpenGL
+// context is created, only the CPU side surface extraction is timed for
+// several ball counts and grid sizes, single threaded and on all cores.
+
+#include "objects/MetaballsPolygonizer.h"
+#include "timer/HighResolutionTimer.h"
+
+static void RandomBalls(std::vector<SBall> &balls, const int &count)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-0.7f, 0.7f);
+    balls.resize(count);
+    for (SBall &ball : balls) {
+        memset(&ball, 0, sizeof(SBall));
+        ball.p[0] = position(random);
+        ball.p[1] = position(random);
+        ball.p[2] = position(random);
+        ball.m = 1;
+    }
+}
+
+static double TimePolygonize(CMetaballsPolygonizer &polygonizer, const std::vector<SBall> &balls, const float &level, const int &frames)
+{
+    // warm up so that every buffer has reached its final size
+    polygonizer.Polygonize(balls.data(), (int)balls.size(), level);
+    
+    CHighResolutionTimer timer;
+    timer.Start();
+    for (int i = 0; i < frames; ++i) {
+        polygonizer.Polygonize(balls.data(), (int)balls.size(), level);
+    }
+    return timer.Elapsed() / frames;
+}
+
+int main(int argc, char *argv[])
+{
+    const int frames = argc > 1 ? atoi(argv[1]) : 20;
+    const float level = 100.0f;
+    const float cullTolerance = 0.05f;
+    const int ballCounts[] = { 10, 32, 128, 512 };
+    const int gridSizes[] = { 32, 64, 128 };
+    
+    CMarchingCubes::BuildTables();
+    
+    CMetaballsPolygonizer serial(1);
+    CMetaballsPolygonizer parallel;
+    serial.SetCullTolerance(cullTolerance);
+    parallel.SetCullTolerance(cullTolerance);
+    
+    std::cout << "threads: " << parallel.GetThreadCount() << ", cull tolerance: " << cullTolerance << std::endl;
+    std::cout << std::setw(8) << "balls" << std::setw(8) << "grid" << std::setw(12) << "triangles"
+              << std::setw(14) << "1 thread ms" << std::setw(14) << "N threads ms" << std::setw(10) << "speedup" << std::endl;
+    
+    std::vector<SBall> balls;
+    for (int ballCount : ballCounts) {
+        RandomBalls(balls, ballCount);
+        for (int gridSize : gridSizes) {
+            serial.SetGridSize(gridSize);
+            parallel.SetGridSize(gridSize);
+            
+            double serialTime = TimePolygonize(serial, balls, level, frames);
+            double parallelTime = TimePolygonize(parallel, balls, level, frames);
+            
+            // both runs have to produce the same surface
+            if (serial.GetIndices().size() != parallel.GetIndices().size()) {
+                std::cerr << "mismatch: " << serial.GetIndices().size() << " vs " << parallel.GetIndices().size() << " indices" << std::endl;
+                return 1;
+            }
+            
+            std::cout << std::setw(8) << ballCount << std::setw(8) << gridSize << std::setw(12) << parallel.GetIndices().size() / 3
+                      << std::setw(14) << std::fixed << std::setprecision(3) << serialTime
+                      << std::setw(14) << parallelTime << std::setw(10) << std::setprecision(2) << serialTime / parallelTime << std::endl;
+        }
+    }
+    return 0;
+}
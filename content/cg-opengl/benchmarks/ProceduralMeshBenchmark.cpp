@@ -0,0 +1,696 @@
+// Headless benchmark of the indexed procedural shapes: no window or OpenGL
+// context is created. Each shape is generated by a copy of the loop it
+// replaced and by procedural_mesh, single threaded and on all cores. The
+// legacy triangle soup is checked against the indexed mesh: every corner has
+// to be one of its vertices with the same position, texture coordinate and
+// normal, and both have to cover the same area with as many non-degenerate
+// triangles, all facing outwards. At the sizes the samples use, the O(n^2)
+// vertex search GLTriangleBatch::AddTriangle ran on the soup is timed too.
+// Times are those of a second run, into arrays already allocated.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "utilities/procedural_mesh.h"
+#include "timer/HighResolutionTimer.h"
+
+struct SCorner
+{
+    float position[3];
+    float normal[3];
+    float texture[2];
+};
+
+typedef std::vector<SCorner> Soup;
+
+struct SMesh
+{
+    std::vector<float> positions, normals, tangents, bitangents, texCoords;
+    std::vector<std::uint32_t> indices;
+};
+
+// which corner attributes the legacy generator gets right
+enum ECompare
+{
+    COMPARE_POSITION = 1,
+    COMPARE_TEXTURE = 2,
+    COMPARE_NORMAL = 4,
+    COMPARE_ALL = 7
+};
+
+static void Normalize(float *v)
+{
+    float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+}
+
+static void SetCorner(float verts[][3], float norms[][3], float texCoords[][2], int corner,
+                      float x, float y, float z, float nx, float ny, float nz, float s, float t)
+{
+    verts[corner][0] = x;
+    verts[corner][1] = y;
+    verts[corner][2] = z;
+    norms[corner][0] = nx;
+    norms[corner][1] = ny;
+    norms[corner][2] = nz;
+    texCoords[corner][0] = s;
+    texCoords[corner][1] = t;
+}
+
+// GLTriangleBatch::AddTriangle without the vertex search: normals made unit length, corners appended
+static void AddTriangle(Soup &soup, float verts[][3], float norms[][3], float texCoords[][2])
+{
+    for (int i = 0; i < 3; ++i) {
+        SCorner corner;
+        Normalize(norms[i]);
+        memcpy(corner.position, verts[i], sizeof(corner.position));
+        memcpy(corner.normal, norms[i], sizeof(corner.normal));
+        memcpy(corner.texture, texCoords[i], sizeof(corner.texture));
+        soup.push_back(corner);
+    }
+}
+
+// the two triangles of a quad the way the legacy loops emitted them
+static void AddQuad(Soup &soup, float verts[][3], float norms[][3], float texCoords[][2])
+{
+    AddTriangle(soup, verts, norms, texCoords);
+    memcpy(verts[0], verts[1], sizeof(verts[0]));
+    memcpy(norms[0], norms[1], sizeof(norms[0]));
+    memcpy(texCoords[0], texCoords[1], sizeof(texCoords[0]));
+    memcpy(verts[1], verts[3], sizeof(verts[0]));
+    memcpy(norms[1], norms[3], sizeof(norms[0]));
+    memcpy(texCoords[1], texCoords[3], sizeof(texCoords[0]));
+    AddTriangle(soup, verts, norms, texCoords);
+}
+
+// gltMakeSphere before procedural_mesh
+static void LegacySphere(Soup &soup, float radius, int slices, int stacks)
+{
+    float drho = (float)(3.141592653589) / (float)stacks;
+    float dtheta = 2.0f * (float)(3.141592653589) / (float)slices;
+    float ds = 1.0f / (float)slices;
+    float dt = 1.0f / (float)stacks;
+    float t = 1.0f;
+    float verts[4][3], norms[4][3], texCoords[4][2];
+
+    soup.reserve((size_t)slices * stacks * 6);
+    for (int i = 0; i < stacks; i++) {
+        float rho = (float)i * drho;
+        float srho = (float)(sin(rho));
+        float crho = (float)(cos(rho));
+        float srhodrho = (float)(sin(rho + drho));
+        float crhodrho = (float)(cos(rho + drho));
+        float s = 0.0f;
+
+        for (int j = 0; j < slices; j++) {
+            float theta = j * dtheta;
+            float stheta = (float)(-sin(theta));
+            float ctheta = (float)(cos(theta));
+            SetCorner(verts, norms, texCoords, 0, stheta * srho * radius, ctheta * srho * radius, crho * radius,
+                      stheta * srho, ctheta * srho, crho, s, t);
+            SetCorner(verts, norms, texCoords, 1, stheta * srhodrho * radius, ctheta * srhodrho * radius, crhodrho * radius,
+                      stheta * srhodrho, ctheta * srhodrho, crhodrho, s, t - dt);
+
+            theta = ((j + 1) == slices) ? 0.0f : (j + 1) * dtheta;
+            stheta = (float)(-sin(theta));
+            ctheta = (float)(cos(theta));
+            s += ds;
+            SetCorner(verts, norms, texCoords, 2, stheta * srho * radius, ctheta * srho * radius, crho * radius,
+                      stheta * srho, ctheta * srho, crho, s, t);
+            SetCorner(verts, norms, texCoords, 3, stheta * srhodrho * radius, ctheta * srhodrho * radius, crhodrho * radius,
+                      stheta * srhodrho, ctheta * srhodrho, crhodrho, s, t - dt);
+
+            AddQuad(soup, verts, norms, texCoords);
+        }
+        t -= dt;
+    }
+}
+
+// gltMakeTorus before procedural_mesh
+static void LegacyTorus(Soup &soup, float majorRadius, float minorRadius, int numMajor, int numMinor)
+{
+    double majorStep = 2.0f * 3.14159265358979323846 / numMajor;
+    double minorStep = 2.0f * 3.14159265358979323846 / numMinor;
+    float verts[4][3], norms[4][3], texCoords[4][2];
+
+    soup.reserve((size_t)numMajor * (numMinor + 1) * 6);
+    for (int i = 0; i < numMajor; ++i) {
+        double a0 = i * majorStep;
+        double a1 = a0 + majorStep;
+        float x0 = (float)cos(a0);
+        float y0 = (float)sin(a0);
+        float x1 = (float)cos(a1);
+        float y1 = (float)sin(a1);
+
+        for (int j = 0; j <= numMinor; ++j) {
+            double b = j * minorStep;
+            float c = (float)cos(b);
+            float r = minorRadius * c + majorRadius;
+            float z = minorRadius * (float)sin(b);
+            SetCorner(verts, norms, texCoords, 0, x0 * r, y0 * r, z, x0 * c, y0 * c, z / minorRadius,
+                      (float)(i) / (float)(numMajor), (float)(j) / (float)(numMinor));
+            SetCorner(verts, norms, texCoords, 1, x1 * r, y1 * r, z, x1 * c, y1 * c, z / minorRadius,
+                      (float)(i + 1) / (float)(numMajor), (float)(j) / (float)(numMinor));
+
+            b = (j + 1) * minorStep;
+            c = (float)cos(b);
+            r = minorRadius * c + majorRadius;
+            z = minorRadius * (float)sin(b);
+            SetCorner(verts, norms, texCoords, 2, x0 * r, y0 * r, z, x0 * c, y0 * c, z / minorRadius,
+                      (float)(i) / (float)(numMajor), (float)(j + 1) / (float)(numMinor));
+            SetCorner(verts, norms, texCoords, 3, x1 * r, y1 * r, z, x1 * c, y1 * c, z / minorRadius,
+                      (float)(i + 1) / (float)(numMajor), (float)(j + 1) / (float)(numMinor));
+
+            AddQuad(soup, verts, norms, texCoords);
+        }
+    }
+}
+
+// gltMakeCylinder before procedural_mesh
+static void LegacyCylinder(Soup &soup, float baseRadius, float topRadius, float length, int numSlices, int numStacks)
+{
+    float radiusStep = (topRadius - baseRadius) / float(numStacks);
+    float stepSizeSlice = (3.1415926536f * 2.0f) / float(numSlices);
+    float ds = 1.0f / float(numSlices);
+    float dt = 1.0f / float(numStacks);
+    float verts[4][3], norms[4][3], texCoords[4][2];
+
+    soup.reserve((size_t)numSlices * numStacks * 6);
+    for (int i = 0; i < numStacks; i++) {
+        float t = i == 0 ? 0.0f : float(i) * dt;
+        float tNext = i == (numStacks - 1) ? 1.0f : float(i + 1) * dt;
+        float currentRadius = baseRadius + (radiusStep * float(i));
+        float nextRadius = baseRadius + (radiusStep * float(i + 1));
+        float currentZ = float(i) * (length / float(numStacks));
+        float nextZ = float(i + 1) * (length / float(numStacks));
+        float zNormal = fabsf(baseRadius - topRadius) < 0.00001f ? 0.0f : baseRadius - topRadius;
+
+        for (int j = 0; j < numSlices; j++) {
+            float s = j == 0 ? 0.0f : float(j) * ds;
+            float sNext = j == (numSlices - 1) ? 1.0f : float(j + 1) * ds;
+            float theyta = stepSizeSlice * float(j);
+            float theytaNext = j == (numSlices - 1) ? 0.0f : stepSizeSlice * (float(j + 1));
+
+            SetCorner(verts, norms, texCoords, 1, cosf(theyta) * currentRadius, sinf(theyta) * currentRadius, currentZ,
+                      cosf(theyta) * currentRadius, sinf(theyta) * currentRadius, zNormal, s, t);
+            SetCorner(verts, norms, texCoords, 0, cosf(theyta) * nextRadius, sinf(theyta) * nextRadius, nextZ,
+                      cosf(theyta) * nextRadius, sinf(theyta) * nextRadius, zNormal, s, tNext);
+            SetCorner(verts, norms, texCoords, 3, cosf(theytaNext) * currentRadius, sinf(theytaNext) * currentRadius, currentZ,
+                      cosf(theytaNext) * currentRadius, sinf(theytaNext) * currentRadius, zNormal, sNext, t);
+            SetCorner(verts, norms, texCoords, 2, cosf(theytaNext) * nextRadius, sinf(theytaNext) * nextRadius, nextZ,
+                      cosf(theytaNext) * nextRadius, sinf(theytaNext) * nextRadius, zNormal, sNext, tNext);
+            Normalize(norms[1]);
+            Normalize(norms[3]);
+            // for cones, tip is tricky
+            if (fabsf(nextRadius) < 0.00001f) {
+                memcpy(norms[0], norms[1], sizeof(norms[0]));
+                memcpy(norms[2], norms[3], sizeof(norms[0]));
+            }
+
+            AddQuad(soup, verts, norms, texCoords);
+        }
+    }
+}
+
+static void LegacySubdivideIcosahedron(Soup &soup, const glm::vec3 &A0, const glm::vec3 &B0, const glm::vec3 &C0, int subdivide)
+{
+    if (subdivide == 0) {
+        const glm::vec3 *corners[3] = { &A0, &B0, &C0 };
+        for (int i = 0; i < 3; ++i) {
+            SCorner corner = {};
+            memcpy(corner.position, &corners[i]->x, sizeof(corner.position));
+            memcpy(corner.normal, &corners[i]->x, sizeof(corner.normal));
+            soup.push_back(corner);
+        }
+        return;
+    }
+
+    glm::vec3 A1 = (B0 + C0) * 0.5f;
+    glm::vec3 B1 = (C0 + A0) * 0.5f;
+    glm::vec3 C1 = (A0 + B0) * 0.5f;
+    if (glm::length(A1) > 0.0f)
+        A1 = glm::normalize(A1);
+    if (glm::length(B1) > 0.0f)
+        B1 = glm::normalize(B1);
+    if (glm::length(C1) > 0.0f)
+        C1 = glm::normalize(C1);
+
+    LegacySubdivideIcosahedron(soup, A0, B1, C1, subdivide - 1);
+    LegacySubdivideIcosahedron(soup, B0, C1, A1, subdivide - 1);
+    LegacySubdivideIcosahedron(soup, C0, A1, B1, subdivide - 1);
+    LegacySubdivideIcosahedron(soup, B1, A1, C1, subdivide - 1);
+}
+
+// glf::generate_icosahedron of the opengl-samels framework before procedural_mesh
+static void LegacyIcosphere(Soup &soup, int subdivision)
+{
+    float t = (1 + sqrtf(5.0f)) / 2;
+    const glm::vec3 v[12] = {
+        glm::normalize(glm::vec3(-1.0f, t, 0.0f)), glm::normalize(glm::vec3(+1.0f, t, 0.0f)),
+        glm::normalize(glm::vec3(-1.0f, -t, 0.0f)), glm::normalize(glm::vec3(+1.0f, -t, 0.0f)),
+        glm::normalize(glm::vec3(0.0f, -1.0f, t)), glm::normalize(glm::vec3(0.0f, 1.0f, t)),
+        glm::normalize(glm::vec3(0.0f, -1.0f, -t)), glm::normalize(glm::vec3(0.0f, 1.0f, -t)),
+        glm::normalize(glm::vec3(t, 0.0f, -1.0f)), glm::normalize(glm::vec3(t, 0.0f, 1.0f)),
+        glm::normalize(glm::vec3(-t, 0.0f, -1.0f)), glm::normalize(glm::vec3(-t, 0.0f, 1.0f))
+    };
+    enum { A, B, C, D, E, F, G, H, I, J, K, L };
+    const int faces[20][3] = {
+        { A, L, F }, { A, F, B }, { A, B, H }, { A, H, K }, { A, K, L },
+        { B, F, J }, { F, L, E }, { L, K, C }, { K, H, G }, { H, B, I },
+        { D, J, E }, { D, E, C }, { D, C, G }, { D, G, I }, { D, I, J },
+        { E, J, F }, { C, E, L }, { G, C, K }, { I, G, H }, { J, I, B }
+    };
+
+    soup.reserve((size_t)60 << (2 * subdivision));
+    for (int f = 0; f < 20; ++f) {
+        LegacySubdivideIcosahedron(soup, v[faces[f][0]], v[faces[f][1]], v[faces[f][2]], subdivision);
+    }
+}
+
+// CTorusKnot::Create before procedural_mesh, vertex (step, facet) at step * (facets + 1) + facet
+static void LegacyTorusKnot(Soup &vertices, int aSteps, int aFacets, float aScale, float aThickness, float aUScale, float aVScale, float aP, float aQ)
+{
+    aThickness *= aScale;
+    long double pi2 = 6.28318530717958647692;
+    vertices.resize((size_t)(aSteps + 1) * (aFacets + 1));
+
+    for (int i = 0; i < aSteps; i++) {
+        long double centerpoint[3];
+        long double Pp = aP * (double)i * pi2 / aSteps;
+        long double Qp = aQ * (double)i * pi2 / aSteps;
+        long double r = (.5f * (2 + (double)sin(Qp))) * aScale;
+        centerpoint[0] = r * (double)cos(Pp);
+        centerpoint[1] = r * (double)cos(Qp);
+        centerpoint[2] = r * (double)sin(Pp);
+
+        float nextpoint[3];
+        Pp = aP * (i + 1) * pi2 / aSteps;
+        Qp = aQ * (i + 1) * pi2 / aSteps;
+        r = (.5f * (2 + (double)sin(Qp))) * aScale;
+        nextpoint[0] = r * (double)cos(Pp);
+        nextpoint[1] = r * (double)cos(Qp);
+        nextpoint[2] = r * (double)sin(Pp);
+
+        long double T[3], N[3], B[3];
+        for (int k = 0; k < 3; ++k) {
+            T[k] = nextpoint[k] - centerpoint[k];
+            N[k] = nextpoint[k] + centerpoint[k];
+        }
+        B[0] = T[1] * N[2] - T[2] * N[1];
+        B[1] = T[2] * N[0] - T[0] * N[2];
+        B[2] = T[0] * N[1] - T[1] * N[0];
+        N[0] = B[1] * T[2] - B[2] * T[1];
+        N[1] = B[2] * T[0] - B[0] * T[2];
+        N[2] = B[0] * T[1] - B[1] * T[0];
+        long double l = (double)sqrt(B[0] * B[0] + B[1] * B[1] + B[2] * B[2]);
+        for (int k = 0; k < 3; ++k)
+            B[k] /= l;
+        l = (double)sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+        for (int k = 0; k < 3; ++k)
+            N[k] /= l;
+
+        for (int j = 0; j < aFacets; j++) {
+            long double pointx = (double)sin(j * pi2 / aFacets) * aThickness;
+            long double pointy = (double)cos(j * pi2 / aFacets) * aThickness;
+            SCorner &vertex = vertices[i * (aFacets + 1) + j];
+            for (int k = 0; k < 3; ++k) {
+                vertex.position[k] = N[k] * pointx + B[k] * pointy + centerpoint[k];
+                vertex.normal[k] = vertex.position[k] - centerpoint[k];
+            }
+            Normalize(vertex.normal);
+            vertex.texture[0] = ((double)j / aFacets) * aUScale;
+            vertex.texture[1] = ((double)i / aSteps) * aVScale;
+        }
+        // duplicate vertex for sideways wrapping
+        vertices[i * (aFacets + 1) + aFacets] = vertices[i * (aFacets + 1)];
+        vertices[i * (aFacets + 1) + aFacets].texture[0] = aUScale;
+    }
+    // duplicate ring for longways wrapping
+    for (int j = 0; j <= aFacets; j++) {
+        vertices[aSteps * (aFacets + 1) + j] = vertices[j];
+        vertices[aSteps * (aFacets + 1) + j].texture[1] = aVScale;
+    }
+}
+
+// the vertex search of GLTriangleBatch::AddTriangle, run over the whole soup
+static size_t LegacyWeld(const Soup &soup, std::vector<SCorner> &vertices, std::vector<std::uint32_t> &indices)
+{
+    const float e = 0.00001f;
+    vertices.clear();
+    indices.clear();
+    for (const SCorner &corner : soup) {
+        size_t match = 0;
+        for (; match < vertices.size(); ++match) {
+            const SCorner &v = vertices[match];
+            if (fabsf(v.position[0] - corner.position[0]) < e && fabsf(v.position[1] - corner.position[1]) < e &&
+                fabsf(v.position[2] - corner.position[2]) < e && fabsf(v.normal[0] - corner.normal[0]) < e &&
+                fabsf(v.normal[1] - corner.normal[1]) < e && fabsf(v.normal[2] - corner.normal[2]) < e &&
+                fabsf(v.texture[0] - corner.texture[0]) < e && fabsf(v.texture[1] - corner.texture[1]) < e)
+                break;
+        }
+        if (match == vertices.size())
+            vertices.push_back(corner);
+        indices.push_back((std::uint32_t)match);
+    }
+    return vertices.size();
+}
+
+template<typename Shape>
+static void Generate(const Shape &shape, SMesh &mesh, unsigned int threads)
+{
+    procedural_mesh::counts counts = procedural_mesh::count(shape);
+    mesh.positions.resize(counts.Vertices * 3);
+    mesh.normals.resize(counts.Vertices * 3);
+    mesh.tangents.resize(counts.Vertices * 3);
+    mesh.bitangents.resize(counts.Vertices * 3);
+    mesh.texCoords.resize(counts.Vertices * 2);
+    mesh.indices.resize(counts.Indices);
+
+    procedural_mesh::buffers buffers;
+    buffers.Position = mesh.positions.data();
+    buffers.Normal = mesh.normals.data();
+    buffers.Tangent = mesh.tangents.data();
+    buffers.Bitangent = mesh.bitangents.data();
+    buffers.TexCoord = mesh.texCoords.data();
+    buffers.Indices = mesh.indices.data();
+    buffers.Threads = threads;
+    procedural_mesh::generate(shape, buffers);
+}
+
+static glm::dvec3 TriangleCross(const float *a, const float *b, const float *c)
+{
+    glm::dvec3 A(a[0], a[1], a[2]), B(b[0], b[1], b[2]), C(c[0], c[1], c[2]);
+    return glm::cross(B - A, C - A);
+}
+
+// two corners closer than the tolerance, like the pole triangles of the legacy sphere
+static bool Collapsed(const float *a, const float *b, const float *c, float tolerance)
+{
+    glm::vec3 A(a[0], a[1], a[2]), B(b[0], b[1], b[2]), C(c[0], c[1], c[2]);
+    return glm::distance(A, B) < tolerance || glm::distance(B, C) < tolerance || glm::distance(C, A) < tolerance;
+}
+
+// the indexed mesh has to be closed under the legacy corners, face outwards and keep orthonormal frames
+static bool Validate(const std::string &name, const Soup &soup, const SMesh &mesh, int compare, float scale)
+{
+    const float positionTolerance = 1e-4f * scale;
+    const float textureTolerance = 1e-4f;
+    const float normalTolerance = 1e-3f;
+    const float collapseTolerance = 1e-6f * scale;
+    const size_t vertexCount = mesh.positions.size() / 3;
+
+    // a grid of positionTolerance * 4 cells, each corner looks in the cells it may straddle
+    const float cell = positionTolerance * 4.0f;
+    std::unordered_map<std::uint64_t, std::uint32_t> heads;
+    std::vector<std::uint32_t> next(vertexCount, 0xffffffffu);
+    auto key = [](std::int64_t x, std::int64_t y, std::int64_t z) {
+        return (std::uint64_t)(x & 0x1fffff) | ((std::uint64_t)(y & 0x1fffff) << 21) | ((std::uint64_t)(z & 0x1fffff) << 42);
+    };
+    heads.reserve(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float *p = &mesh.positions[v * 3];
+        std::uint64_t k = key((std::int64_t)floorf(p[0] / cell), (std::int64_t)floorf(p[1] / cell), (std::int64_t)floorf(p[2] / cell));
+        auto inserted = heads.insert(std::make_pair(k, (std::uint32_t)v));
+        if (!inserted.second) {
+            next[v] = inserted.first->second;
+            inserted.first->second = (std::uint32_t)v;
+        }
+    }
+
+    auto matches = [&](const SCorner &corner, size_t v) {
+        for (int k = 0; k < 3; ++k) {
+            if ((compare & COMPARE_POSITION) && fabsf(mesh.positions[v * 3 + k] - corner.position[k]) > positionTolerance)
+                return false;
+            if ((compare & COMPARE_NORMAL) && fabsf(mesh.normals[v * 3 + k] - corner.normal[k]) > normalTolerance)
+                return false;
+        }
+        for (int k = 0; k < 2; ++k) {
+            if ((compare & COMPARE_TEXTURE) && fabsf(mesh.texCoords[v * 2 + k] - corner.texture[k]) > textureTolerance)
+                return false;
+        }
+        return true;
+    };
+
+    size_t unmatched = 0, legacyTriangles = 0;
+    double legacyArea = 0.0;
+    for (size_t t = 0; t + 2 < soup.size(); t += 3) {
+        if (Collapsed(soup[t].position, soup[t + 1].position, soup[t + 2].position, collapseTolerance))
+            continue;
+        ++legacyTriangles;
+        legacyArea += glm::length(TriangleCross(soup[t].position, soup[t + 1].position, soup[t + 2].position)) * 0.5;
+
+        for (size_t c = t; c < t + 3; ++c) {
+            const float *p = soup[c].position;
+            std::int64_t lo[3], hi[3];
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = (std::int64_t)floorf((p[k] - positionTolerance) / cell);
+                hi[k] = (std::int64_t)floorf((p[k] + positionTolerance) / cell);
+            }
+            bool found = false;
+            for (std::int64_t x = lo[0]; x <= hi[0] && !found; ++x)
+                for (std::int64_t y = lo[1]; y <= hi[1] && !found; ++y)
+                    for (std::int64_t z = lo[2]; z <= hi[2] && !found; ++z) {
+                        auto head = heads.find(key(x, y, z));
+                        for (std::uint32_t v = head == heads.end() ? 0xffffffffu : head->second; v != 0xffffffffu && !found; v = next[v])
+                            found = matches(soup[c], v);
+                    }
+            if (!found)
+                ++unmatched;
+        }
+    }
+
+    size_t triangles = 0, inward = 0, degenerate = 0;
+    double area = 0.0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        const std::uint32_t *i = &mesh.indices[t];
+        if (i[0] >= vertexCount || i[1] >= vertexCount || i[2] >= vertexCount) {
+            std::cerr << name << ": index out of range" << std::endl;
+            return false;
+        }
+        if (Collapsed(&mesh.positions[i[0] * 3], &mesh.positions[i[1] * 3], &mesh.positions[i[2] * 3], collapseTolerance)) {
+            ++degenerate;
+            continue;
+        }
+        glm::dvec3 n = TriangleCross(&mesh.positions[i[0] * 3], &mesh.positions[i[1] * 3], &mesh.positions[i[2] * 3]);
+        ++triangles;
+        area += glm::length(n) * 0.5;
+        glm::dvec3 normals(0.0);
+        for (int k = 0; k < 3; ++k)
+            normals += glm::dvec3(mesh.normals[i[k] * 3], mesh.normals[i[k] * 3 + 1], mesh.normals[i[k] * 3 + 2]);
+        if (glm::dot(n, normals) <= 0.0)
+            ++inward;
+    }
+
+    double frameError = 0.0;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        glm::dvec3 n(mesh.normals[v * 3], mesh.normals[v * 3 + 1], mesh.normals[v * 3 + 2]);
+        glm::dvec3 t(mesh.tangents[v * 3], mesh.tangents[v * 3 + 1], mesh.tangents[v * 3 + 2]);
+        glm::dvec3 b(mesh.bitangents[v * 3], mesh.bitangents[v * 3 + 1], mesh.bitangents[v * 3 + 2]);
+        frameError = std::max(frameError, fabs(glm::length(n) - 1.0));
+        frameError = std::max(frameError, fabs(glm::length(t) - 1.0));
+        frameError = std::max(frameError, fabs(glm::dot(n, t)));
+        frameError = std::max(frameError, glm::length(glm::abs(glm::cross(n, t)) - glm::abs(b)));
+    }
+
+    if (unmatched || inward || degenerate || triangles != legacyTriangles ||
+        fabs(area - legacyArea) > 1e-4 * legacyArea || frameError > 1e-4) {
+        std::cerr << name << ": " << unmatched << " unmatched corners, " << inward << " inward and " << degenerate
+                  << " degenerate triangles, " << triangles << " / " << legacyTriangles << " triangles, area "
+                  << area << " / " << legacyArea << ", frame error " << frameError << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// the torus knot keeps the legacy vertex order, so vertices are compared one to one
+static bool ValidateKnot(const std::string &name, const Soup &vertices, const SMesh &mesh, float scale)
+{
+    if (vertices.size() * 3 != mesh.positions.size()) {
+        std::cerr << name << ": " << mesh.positions.size() / 3 << " vertices instead of " << vertices.size() << std::endl;
+        return false;
+    }
+    double positionError = 0.0, normalError = 0.0, textureError = 0.0;
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        for (int k = 0; k < 3; ++k) {
+            positionError = std::max(positionError, (double)fabsf(vertices[v].position[k] - mesh.positions[v * 3 + k]));
+            normalError = std::max(normalError, (double)fabsf(vertices[v].normal[k] - mesh.normals[v * 3 + k]));
+        }
+        for (int k = 0; k < 2; ++k)
+            textureError = std::max(textureError, (double)fabsf(vertices[v].texture[k] - mesh.texCoords[v * 2 + k]));
+    }
+    if (positionError > 1e-4 * scale || normalError > 1e-3 || textureError > 1e-4) {
+        std::cerr << name << ": position error " << positionError << ", normal error " << normalError
+                  << ", texture error " << textureError << std::endl;
+        return false;
+    }
+
+    // the knot winds around itself, so only the orientation is checked on the triangles
+    Soup triangles;
+    for (std::uint32_t index : mesh.indices) {
+        SCorner corner;
+        memcpy(corner.position, &mesh.positions[index * 3], sizeof(corner.position));
+        triangles.push_back(corner);
+    }
+    return Validate(name, triangles, mesh, COMPARE_POSITION, scale);
+}
+
+struct SRow
+{
+    std::string name;
+    std::string size;
+    size_t vertices;
+    size_t indices;
+    double legacyTime;
+    double weldTime;        // < 0 where the vertex search is too slow to run
+    double serialTime;
+    double parallelTime;
+};
+
+static void PrintRow(const SRow &row)
+{
+    std::cout << std::setw(10) << row.name << std::setw(11) << row.size << std::setw(10) << row.vertices << std::setw(10) << row.indices
+              << std::fixed << std::setprecision(2) << std::setw(11) << row.legacyTime;
+    if (row.weldTime >= 0.0)
+        std::cout << std::setw(11) << row.weldTime;
+    else
+        std::cout << std::setw(11) << "-";
+    std::cout << std::setw(11) << row.serialTime << std::setw(11) << row.parallelTime << std::endl;
+}
+
+template<typename Shape, typename Legacy>
+static bool Benchmark(const std::string &name, const std::string &size, const Shape &shape, const Legacy &legacy,
+                      int compare, float scale, bool weld)
+{
+    CHighResolutionTimer timer;
+    SRow row;
+    row.name = name;
+    row.size = size;
+
+    // every run after a first one, so that the arrays are allocated and paged in
+    Soup soup;
+    legacy(soup);
+    soup.clear();
+    timer.Start();
+    legacy(soup);
+    row.legacyTime = timer.Elapsed();
+
+    row.weldTime = -1.0;
+    if (weld) {
+        std::vector<SCorner> vertices;
+        std::vector<std::uint32_t> indices;
+        timer.Start();
+        LegacyWeld(soup, vertices, indices);
+        row.weldTime = row.legacyTime + timer.Elapsed();
+    }
+
+    SMesh serial, parallel;
+    Generate(shape, serial, 1);
+    timer.Start();
+    Generate(shape, serial, 1);
+    row.serialTime = timer.Elapsed();
+    Generate(shape, parallel, 0);
+    timer.Start();
+    Generate(shape, parallel, 0);
+    row.parallelTime = timer.Elapsed();
+    row.vertices = parallel.positions.size() / 3;
+    row.indices = parallel.indices.size();
+
+    if (serial.positions != parallel.positions || serial.normals != parallel.normals || serial.tangents != parallel.tangents ||
+        serial.bitangents != parallel.bitangents || serial.texCoords != parallel.texCoords || serial.indices != parallel.indices) {
+        std::cerr << name << " " << size << ": threads change the mesh" << std::endl;
+        return false;
+    }
+    bool valid = compare ? Validate(name + " " + size, soup, parallel, compare, scale)
+                         : ValidateKnot(name + " " + size, soup, parallel, scale);
+    if (valid)
+        PrintRow(row);
+    return valid;
+}
+
+static std::string Size(int a, int b)
+{
+    return std::to_string(a) + "x" + std::to_string(b);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<int> levels;
+    for (int i = 1; i < argc; ++i) {
+        levels.push_back(atoi(argv[i]));
+    }
+    if (levels.empty()) {
+        levels = { 6, 7, 8, 9 };
+    }
+
+    std::cout << "threads: " << std::max(1u, std::thread::hardware_concurrency())
+              << ", legacy ms with the AddTriangle vertex search in the weld column" << std::endl;
+    std::cout << std::setw(10) << "shape" << std::setw(11) << "size" << std::setw(10) << "vertices" << std::setw(10) << "indices"
+              << std::setw(11) << "legacy ms" << std::setw(11) << "weld ms" << std::setw(11) << "1 thread" << std::setw(11) << "N thread" << std::endl;
+
+    bool valid = true;
+
+    // the sizes of the sb5 samples, where the legacy meshes were welded
+    const int small[][2] = { { 32, 16 }, { 52, 26 }, { 128, 64 } };
+    for (const auto &s : small) {
+        valid = valid && Benchmark("sphere", Size(s[0], s[1]), procedural_mesh::uv_sphere(1.0f, s[0], s[1]),
+                                   [&](Soup &soup) { LegacySphere(soup, 1.0f, s[0], s[1]); }, COMPARE_ALL, 1.0f, true);
+    }
+    for (const auto &s : small) {
+        // the legacy torus emitted its first ring of quads twice, the copy has v > 1
+        valid = valid && Benchmark("torus", Size(s[0], s[1]), procedural_mesh::torus(0.8f, 0.25f, s[0], s[1]),
+                                   [&](Soup &soup) {
+                                       LegacyTorus(soup, 0.8f, 0.25f, s[0], s[1]);
+                                       Soup first;
+                                       for (size_t t = 0; t < soup.size(); t += 3) {
+                                           if (soup[t].texture[1] <= 1.0f && soup[t + 1].texture[1] <= 1.0f && soup[t + 2].texture[1] <= 1.0f)
+                                               first.insert(first.end(), soup.begin() + t, soup.begin() + t + 3);
+                                       }
+                                       soup.swap(first);
+                                   },
+                                   COMPARE_ALL, 1.0f, true);
+    }
+    // the legacy cone normals are wrong, only positions and texture coordinates are compared there
+    valid = valid && Benchmark("cylinder", Size(32, 4), procedural_mesh::cylinder(1.0f, 1.0f, 2.0f, 32, 4),
+                               [](Soup &soup) { LegacyCylinder(soup, 1.0f, 1.0f, 2.0f, 32, 4); }, COMPARE_ALL, 2.0f, true);
+    valid = valid && Benchmark("cone", Size(32, 4), procedural_mesh::cylinder(1.0f, 0.0f, 2.0f, 32, 4),
+                               [](Soup &soup) { LegacyCylinder(soup, 1.0f, 0.0f, 2.0f, 32, 4); }, COMPARE_POSITION | COMPARE_TEXTURE, 2.0f, true);
+
+    // high tessellation, where the vertex search cannot run any more
+    const int large[][2] = { { 1024, 512 }, { 2048, 1024 } };
+    for (const auto &s : large) {
+        valid = valid && Benchmark("sphere", Size(s[0], s[1]), procedural_mesh::uv_sphere(1.0f, s[0], s[1]),
+                                   [&](Soup &soup) { LegacySphere(soup, 1.0f, s[0], s[1]); }, COMPARE_ALL, 1.0f, false);
+    }
+    valid = valid && Benchmark("cylinder", Size(4096, 256), procedural_mesh::cylinder(1.0f, 0.5f, 2.0f, 4096, 256),
+                               [](Soup &soup) { LegacyCylinder(soup, 1.0f, 0.5f, 2.0f, 4096, 256); }, COMPARE_POSITION | COMPARE_TEXTURE, 2.0f, false);
+
+    const int knots[][2] = { { 1024, 32 }, { 16384, 64 } };
+    for (const auto &s : knots) {
+        procedural_mesh::torus_knot knot(s[0], s[1], 3.0f, 2.0f);
+        knot.Scale = 4.0f;
+        knot.Thickness = 0.5f;
+        knot.UScale = 2.0f;
+        knot.VScale = 32.0f;
+        valid = valid && Benchmark("knot", Size(s[0], s[1]), knot,
+                                   [&](Soup &vertices) { LegacyTorusKnot(vertices, s[0], s[1], 4.0f, 0.5f, 2.0f, 32.0f, 3.0f, 2.0f); }, 0, 8.0f, false);
+    }
+
+    for (int level : levels) {
+        valid = valid && Benchmark("icosphere", std::to_string(level), procedural_mesh::icosphere(1.0f, level),
+                                   [&](Soup &soup) { LegacyIcosphere(soup, level); }, COMPARE_POSITION, 1.0f, false);
+    }
+
+    return valid ? 0 : 1;
+}
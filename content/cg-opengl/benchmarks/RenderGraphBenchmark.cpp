@@ -0,0 +1,129 @@
+// Headless benchmark of the post processing render graph: no window or
+// OpenGL context is created. The graph of every effect is compiled at 1080p
+// and the frame buffer memory and binds per frame are compared with creating
+// every slot on its own, which is what the game did for all effects. A longer
+// synthetic chain shows targets of the same description being aliased.
+
+#include <iomanip>
+#include <iostream>
+
+#include "buffers/PostProcessingGraph.h"
+#include "timer/HighResolutionTimer.h"
+
+static double Megabytes(const size_t &bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+// a live pass has to find a frame buffer behind every target it uses, and
+// targets aliased onto one frame buffer must never be used by overlapping ranges of passes
+static bool CheckGraph(const CRenderGraph &graph)
+{
+    const int targetCount = (int)graph.GetTargetCount();
+    std::vector<int> first(targetCount, -1), last(targetCount, -1);
+    for (int p = 0; p < (int)graph.GetPassCount(); ++p) {
+        if (!graph.IsPassLive(p)) continue;
+        std::vector<int> targets = graph.GetPassReads(p);
+        targets.push_back(graph.GetPassTarget(p));
+        for (const int &target : targets) {
+            if (target == CRenderGraph::SCREEN) continue;
+            if (graph.GetPhysicalTarget(target) < 0) return false;
+            if (first[target] < 0) first[target] = p;
+            last[target] = p;
+        }
+    }
+    for (int a = 0; a < targetCount; ++a) {
+        for (int b = a + 1; b < targetCount; ++b) {
+            if (first[a] < 0 || first[b] < 0 || graph.GetPhysicalTarget(a) != graph.GetPhysicalTarget(b)) continue;
+            if (!(last[a] < first[b] || last[b] < first[a])) return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    const unsigned int width = 1920, height = 1080, shadowSize = 1024;
+    const int compiles = 1000;
+
+    std::cout << std::setw(6) << "mode" << std::setw(8) << "passes" << std::setw(10) << "buffers"
+              << std::setw(12) << "naive MB" << std::setw(12) << "graph MB" << std::setw(8) << "binds" << std::endl;
+
+    bool valid = true;
+    size_t naiveBytes = 0, largestBytes = 0;
+    CRenderGraph graph;
+    std::vector<int> slotTargets;
+    const int modeCount = (int)PostProcessingEffectMode::NumberOfPPFX;
+    for (int m = 0; m < modeCount; ++m) {
+        graph.Clear();
+        CPostProcessingGraph::Declare((PostProcessingEffectMode)m, width, height, shadowSize, graph, slotTargets);
+        graph.Compile();
+        const SRenderGraphStats &stats = graph.GetStats();
+        naiveBytes = stats.declaredBytes;
+        largestBytes = std::max(largestBytes, stats.allocatedBytes);
+        valid = valid && CheckGraph(graph) && stats.allocatedBytes < stats.declaredBytes && stats.livePasses == stats.declaredPasses;
+        // the deferred renderer skips rebinding the screen for the lamps when the graph merged them
+        if ((PostProcessingEffectMode)m == PostProcessingEffectMode::DeferredRendering) {
+            valid = valid && graph.IsPassMerged(graph.FindPass("lamps")) && stats.targetBinds == stats.livePasses - 1;
+        }
+
+        // the single pass effects all compile to the same graph, only list the others
+        if (stats.declaredPasses <= 2 && m != 0) continue;
+        std::cout << std::setw(6) << m << std::setw(8) << stats.livePasses << std::setw(10)
+                  << (std::to_string(stats.physicalTargets) + "/" + std::to_string(stats.declaredTargets))
+                  << std::fixed << std::setprecision(1) << std::setw(12) << Megabytes(stats.declaredBytes)
+                  << std::setw(12) << Megabytes(stats.allocatedBytes) << std::setw(8) << stats.targetBinds << std::endl;
+    }
+    std::cout << "every slot created: " << std::fixed << std::setprecision(1) << Megabytes(naiveBytes)
+              << " MB, largest effect graph: " << Megabytes(largestBytes) << " MB" << std::endl;
+
+    // a bloom, tone mapping and anti aliasing chain where every step gets its own target
+    graph.Clear();
+    SRenderTargetDesc hdr = { FrameBufferType::HighDynamicRangeLighting, width, height,
+                              CPostProcessingGraph::GetTargetBytes(FrameBufferType::HighDynamicRangeLighting, width, height, shadowSize) };
+    SRenderTargetDesc ldr = { FrameBufferType::Default, width, height,
+                              CPostProcessingGraph::GetTargetBytes(FrameBufferType::Default, width, height, shadowSize) };
+    const int scene = graph.CreateTarget("scene", hdr);
+    const int bright = graph.CreateTarget("bright", hdr);
+    const int blur[4] = { graph.CreateTarget("blur 0", hdr), graph.CreateTarget("blur 1", hdr),
+                          graph.CreateTarget("blur 2", hdr), graph.CreateTarget("blur 3", hdr) };
+    const int composite = graph.CreateTarget("composite", hdr);
+    const int tonemapped = graph.CreateTarget("tone mapped", ldr);
+    const int debug = graph.CreateTarget("debug view", ldr);
+    graph.AddPass("opaque", {}, scene);
+    graph.AddPass("transparent", {}, scene);
+    graph.AddPass("bright parts", { scene }, bright);
+    graph.AddPass("blur", { bright }, blur[0]);
+    for (int i = 1; i < 4; ++i) {
+        graph.AddPass("blur", { blur[i - 1] }, blur[i]);
+    }
+    graph.AddPass("bloom", { scene, blur[3] }, composite);
+    graph.AddPass("debug view", { bright }, debug);
+    graph.AddPass("tone mapping", { composite }, tonemapped);
+    graph.AddPass("fxaa", { tonemapped }, CRenderGraph::SCREEN);
+    graph.AddPass("hud", {}, CRenderGraph::SCREEN);
+
+    CHighResolutionTimer timer;
+    timer.Start();
+    for (int i = 0; i < compiles; ++i) {
+        graph.Compile();
+    }
+    const double compileTime = timer.Elapsed() * 1000.0 / compiles;
+
+    const SRenderGraphStats &stats = graph.GetStats();
+    std::cout << "chain: " << stats.livePasses << "/" << stats.declaredPasses << " passes, "
+              << stats.physicalTargets << "/" << stats.declaredTargets << " buffers, "
+              << std::fixed << std::setprecision(1) << Megabytes(stats.allocatedBytes) << "/" << Megabytes(stats.declaredBytes) << " MB, "
+              << stats.targetBinds << " binds, compile " << std::setprecision(2) << compileTime << " us" << std::endl;
+
+    valid = valid && CheckGraph(graph);
+    // the debug view is never shown, the blur steps reuse the bright parts buffer and each other,
+    // and the transparent and hud passes draw into what the previous pass left bound
+    valid = valid && graph.GetPhysicalTarget(debug) < 0 && stats.livePasses == stats.declaredPasses - 1;
+    valid = valid && stats.physicalTargets < stats.liveTargets && stats.targetBinds == stats.livePasses - 2;
+    if (!valid) {
+        std::cerr << "render graph check failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+// Headless benchmark of the chunked terrain: no window or OpenGL context is
+// created. A 16K x 16K heightmap is represented by the height ranges of its
+// chunks only, and the per frame quadtree culling and level of detail
+// selection is timed along a camera flight. A smaller heightmap is written
+// to a tile file and streamed back to time the chunk decoding.
+
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "objects/TerrainQuadtree.h"
+#include "objects/TerrainTileFile.h"
+#include "timer/HighResolutionTimer.h"
+
+static float TerrainHeight(const float &x, const float &z)
+{
+    return 0.6f * sinf(x * 0.0011f) * cosf(z * 0.0017f) + 0.3f * sinf(x * 0.013f + z * 0.007f) + 0.1f * cosf(z * 0.051f);
+}
+
+// every neighbour of a selected chunk has to be within one level, otherwise the stitching leaves cracks
+static bool CheckNeighbourLevels(const CTerrainQuadtree &quadtree, const std::vector<STerrainChunkSelection> &selection, const glm::vec3 &camera)
+{
+    const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    for (const STerrainChunkSelection &selected : selection) {
+        int x = selected.chunk % quadtree.GetChunksX();
+        int z = selected.chunk / quadtree.GetChunksX();
+        for (int i = 0; i < 4; ++i) {
+            int nx = x + offsets[i][0], nz = z + offsets[i][1];
+            if (nx < 0 || nz < 0 || nx >= (int)quadtree.GetChunksX() || nz >= (int)quadtree.GetChunksZ())
+                continue;
+            int lod = (int)quadtree.ChunkLod(nx + nz * quadtree.GetChunksX(), camera);
+            bool stitched = (selected.edgeMask & (1 << i)) != 0;
+            if (abs(lod - (int)selected.lod) > 1 || stitched != (lod > (int)selected.lod))
+                return false;
+        }
+    }
+    return true;
+}
+
+// a stitched edge may only use the vertices of the coarser neighbour
+static bool CheckIndexPatterns(const CTerrainQuadtree &quadtree)
+{
+    std::vector<unsigned int> indices;
+    const unsigned int n = quadtree.GetChunkQuads();
+    for (unsigned int lod = 0; lod + 1 < quadtree.GetLodCount(); ++lod) {
+        for (unsigned int edgeMask = 1; edgeMask < 16; ++edgeMask) {
+            quadtree.BuildIndexPattern(lod, edgeMask, indices);
+            for (unsigned int index : indices) {
+                unsigned int x = index % (n + 1), z = index / (n + 1), coarse = 2u << lod;
+                if (((edgeMask & TERRAIN_EDGE_NEGATIVE_X) && x == 0 && z % coarse != 0) ||
+                    ((edgeMask & TERRAIN_EDGE_POSITIVE_X) && x == n && z % coarse != 0) ||
+                    ((edgeMask & TERRAIN_EDGE_NEGATIVE_Z) && z == 0 && x % coarse != 0) ||
+                    ((edgeMask & TERRAIN_EDGE_POSITIVE_Z) && z == n && x % coarse != 0))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int BenchmarkSelection(const unsigned int &samples, const unsigned int &chunkQuads, const int &frames)
+{
+    // one world unit per sample, heights in [-100, 100]
+    const unsigned int chunks = CTerrainTileFile::ChunkCount(samples, chunkQuads);
+    std::vector<glm::vec2> heightRanges(chunks * chunks);
+    for (unsigned int z = 0; z < chunks; ++z) {
+        for (unsigned int x = 0; x < chunks; ++x) {
+            glm::vec2 range(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+            for (unsigned int j = 0; j <= chunkQuads; j += 8) {
+                for (unsigned int i = 0; i <= chunkQuads; i += 8) {
+                    float h = 100.0f * TerrainHeight((float)(x * chunkQuads + i), (float)(z * chunkQuads + j));
+                    range = glm::vec2(std::min(range.x, h), std::max(range.y, h));
+                }
+            }
+            // the ranges are sampled sparsely, pad them the way a real bound would be conservative
+            heightRanges[x + z * chunks] = range + glm::vec2(-5.0f, 5.0f);
+        }
+    }
+
+    CTerrainQuadtree quadtree;
+    quadtree.Create(chunks, chunks, chunkQuads, glm::vec2(0.0f), glm::vec2((float)chunkQuads), heightRanges);
+    quadtree.SetLodDistance(4.0f * chunkQuads);
+
+    if (!CheckIndexPatterns(quadtree)) {
+        std::cerr << "stitched index pattern uses a vertex the coarser neighbour does not have" << std::endl;
+        return 1;
+    }
+
+    const float extent = (float)(chunks * chunkQuads);
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.5f, 8000.0f);
+    std::vector<STerrainChunkSelection> selection;
+    selection.reserve(quadtree.GetChunkCount());
+
+    double total = 0.0, worst = 0.0;
+    size_t selected = 0;
+    std::vector<size_t> lodHistogram(quadtree.GetLodCount(), 0);
+    for (int frame = 0; frame < frames; ++frame) {
+        // circle over the terrain while looking around and slowly climbing
+        float t = (float)frame / frames;
+        glm::vec3 camera(extent * (0.5f + 0.35f * cosf(6.2832f * t)), 150.0f + 400.0f * t, extent * (0.5f + 0.35f * sinf(6.2832f * t)));
+        glm::vec3 target = camera + glm::vec3(cosf(12.566f * t + 1.0f), -0.3f, sinf(12.566f * t + 1.0f));
+        glm::mat4 viewProjection = projection * glm::lookAt(camera, target, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        CHighResolutionTimer timer;
+        timer.Start();
+        selection.clear();
+        quadtree.Select(camera, viewProjection, selection);
+        double elapsed = timer.Elapsed();
+
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+        selected += selection.size();
+        for (const STerrainChunkSelection &chunk : selection) {
+            lodHistogram[chunk.lod]++;
+        }
+
+        if (!CheckNeighbourLevels(quadtree, selection, camera)) {
+            std::cerr << "neighbouring chunks differ by more than one level in frame " << frame << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "heightmap: " << samples << "^2, chunks: " << quadtree.GetChunkCount() << " of " << chunkQuads << "^2 quads, nodes: "
+              << quadtree.GetNodeCount() << ", levels: " << quadtree.GetLodCount() << std::endl;
+    std::cout << "selection: " << std::fixed << std::setprecision(4) << total / frames << " ms average, " << worst << " ms worst, "
+              << selected / frames << " chunks visible on average" << std::endl;
+    std::cout << "chunks per level:";
+    for (unsigned int lod = 0; lod < lodHistogram.size(); ++lod) {
+        std::cout << " " << lodHistogram[lod] / frames;
+    }
+    std::cout << std::endl;
+    return 0;
+}
+
+static int BenchmarkTileFile(const unsigned int &samples, const unsigned int &chunkQuads)
+{
+    std::vector<float> heights(samples * samples);
+    for (unsigned int z = 0; z < samples; ++z) {
+        for (unsigned int x = 0; x < samples; ++x) {
+            heights[x + z * samples] = TerrainHeight((float)x, (float)z);
+        }
+    }
+
+    const char *filename = "TerrainLodBenchmark.tiles";
+    CHighResolutionTimer timer;
+    timer.Start();
+    if (!CTerrainTileFile::Write(filename, heights.data(), samples, samples, chunkQuads)) {
+        std::cerr << "cannot write " << filename << std::endl;
+        return 1;
+    }
+    double writeTime = timer.Elapsed();
+
+    CTerrainTileFile tiles;
+    if (!tiles.Open(filename)) {
+        std::cerr << "cannot open " << filename << std::endl;
+        return 1;
+    }
+
+    // stream every chunk back and compare it to the source heights
+    std::vector<float> decoded, expected;
+    float maxError = 0.0f;
+    const unsigned int chunkCount = tiles.GetChunksX() * tiles.GetChunksZ();
+    double readTime = 0.0;
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk) {
+        timer.Start();
+        tiles.ReadChunk(chunk, decoded);
+        readTime += timer.Elapsed();
+        CTerrainTileFile::ExtractChunk(heights.data(), samples, samples, chunkQuads, chunk, expected);
+        for (size_t i = 0; i < decoded.size(); ++i) {
+            maxError = std::max(maxError, fabsf(decoded[i] - expected[i]));
+        }
+    }
+
+    // chunks overlap by their last quad and the apron, those samples must decode bit identically
+    // in both neighbours or the streamed terrain shows cracks along the chunk seams
+    const unsigned int side = chunkQuads + 3;
+    unsigned int seamMismatches = 0;
+    std::vector<float> neighbour;
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk) {
+        const unsigned int cx = chunk % tiles.GetChunksX(), cz = chunk / tiles.GetChunksX();
+        tiles.ReadChunk(chunk, decoded);
+        if (cx + 1 < tiles.GetChunksX()) {
+            tiles.ReadChunk(chunk + 1, neighbour);
+            for (unsigned int z = 0; z < side; ++z) {
+                for (unsigned int k = 0; k < 3; ++k) {
+                    seamMismatches += memcmp(&decoded[chunkQuads + k + z * side], &neighbour[k + z * side], sizeof(float)) != 0;
+                }
+            }
+        }
+        if (cz + 1 < tiles.GetChunksZ()) {
+            tiles.ReadChunk(chunk + tiles.GetChunksX(), neighbour);
+            for (unsigned int k = 0; k < 3; ++k) {
+                seamMismatches += memcmp(&decoded[(chunkQuads + k) * side], &neighbour[k * side], side * sizeof(float)) != 0;
+            }
+        }
+    }
+    tiles.Close();
+    remove(filename);
+
+    std::cout << "tile file: " << samples << "^2 written in " << std::setprecision(1) << writeTime << " ms, "
+              << chunkCount << " chunks read in " << readTime << " ms (" << std::setprecision(4) << readTime / chunkCount
+              << " ms per chunk), max error " << std::scientific << maxError << std::defaultfloat
+              << ", " << seamMismatches << " seam mismatches" << std::endl;
+
+    // heights span [-1, 1], 16 bit quantization over that range is off by at most half a step of
+    // 2 / 65535, plus the float rounding of the encode and decode
+    return maxError <= 1.0f / 65535.0f + 1e-6f && seamMismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const int frames = argc > 1 ? atoi(argv[1]) : 1000;
+    const unsigned int samples = argc > 2 ? atoi(argv[2]) : 16385;
+    const unsigned int chunkQuads = 64;
+
+    if (BenchmarkSelection(samples, chunkQuads, frames) != 0)
+        return 1;
+    return BenchmarkTileFile(2049, chunkQuads);
+}
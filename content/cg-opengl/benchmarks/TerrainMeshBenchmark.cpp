@@ -0,0 +1,97 @@
+// Headless benchmark of the terrain mesh generator: no window or OpenGL
+// context is created. Procedural heightmaps of 4K x 4K and 8K x 8K samples
+// are turned into meshes single threaded and on all cores.
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "objects/TerrainMeshGenerator.h"
+#include "timer/HighResolutionTimer.h"
+
+static void ProceduralHeights(std::vector<float> &heights, const unsigned int &size)
+{
+    heights.resize((size_t)size * size);
+    for (unsigned int z = 0; z < size; ++z) {
+        for (unsigned int x = 0; x < size; ++x) {
+            heights[x + (size_t)z * size] = 0.6f * sinf(x * 0.0021f) * cosf(z * 0.0017f) + 0.3f * sinf(x * 0.013f + z * 0.007f) + 0.1f * cosf(z * 0.051f);
+        }
+    }
+}
+
+// a cheap fingerprint to compare two meshes without keeping both in memory
+static double Checksum(const CTerrainMeshGenerator &generator)
+{
+    double sum = 0.0;
+    const std::vector<STerrainVertex> &vertices = generator.GetVertices();
+    for (size_t i = 0; i < vertices.size(); i += 97) {
+        sum += vertices[i].position.y + vertices[i].normal.x * 3.0 + vertices[i].normal.z * 7.0 + vertices[i].texture.s;
+    }
+    sum += (double)generator.GetIndexCount() * generator.GetIndexSize();
+    return sum;
+}
+
+static int BenchmarkSize(const unsigned int &size)
+{
+    std::vector<float> heights;
+    ProceduralHeights(heights, size);
+
+    const glm::vec3 origin(-0.5f * size, 0.0f, -0.5f * size);
+    const glm::vec3 spacing(1.0f, 100.0f, 1.0f);
+    const float textureScale = 1.0f / 20.0f;
+
+    CHighResolutionTimer timer;
+    double serialTime, parallelTime;
+    double serialChecksum, parallelChecksum;
+    unsigned int threads, indexSize;
+    size_t vertexCount, indexCount;
+
+    // one generator at a time, an 8K mesh alone takes several gigabytes
+    {
+        CTerrainMeshGenerator serial(1);
+        timer.Start();
+        serial.Generate(heights.data(), size, size, origin, spacing, textureScale);
+        serialTime = timer.Elapsed();
+        serialChecksum = Checksum(serial);
+    }
+    {
+        CTerrainMeshGenerator parallel;
+        threads = parallel.GetThreadCount();
+        timer.Start();
+        parallel.Generate(heights.data(), size, size, origin, spacing, textureScale);
+        parallelTime = timer.Elapsed();
+        parallelChecksum = Checksum(parallel);
+        vertexCount = parallel.GetVertices().size();
+        indexCount = parallel.GetIndexCount();
+        indexSize = parallel.GetIndexSize();
+    }
+
+    if (serialChecksum != parallelChecksum) {
+        std::cerr << "meshes differ: " << serialChecksum << " / " << parallelChecksum << std::endl;
+        return 1;
+    }
+
+    std::cout << std::setw(6) << size << std::setw(12) << vertexCount << std::setw(12) << indexCount << std::setw(4) << indexSize * 8
+              << std::fixed << std::setprecision(1) << std::setw(12) << serialTime << std::setw(12) << parallelTime
+              << std::setw(6) << threads << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<unsigned int> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = { 4096, 8192 };
+    }
+
+    std::cout << std::setw(6) << "size" << std::setw(12) << "vertices" << std::setw(12) << "indices" << std::setw(4) << "bit"
+              << std::setw(12) << "1 thread ms" << std::setw(12) << "N thread ms" << std::setw(6) << "N" << std::endl;
+    for (unsigned int size : sizes) {
+        if (BenchmarkSize(size) != 0)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Headless benchmark of the texture resampler: no window or OpenGL context is
+// created. A procedural 8K x 8K sRGB RGBA image is resized with single
+// threaded stbir_resize_uint8_srgb and with CTextureResampler on one thread
+// (SSE2, then AVX2 when the CPU has it) and on all cores, and a full mip chain
+// is built both ways. Every result has to match stbir byte for byte.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "texture/TextureResampler.h"
+#include "timer/HighResolutionTimer.h"
+
+static const int RUNS = 3;
+
+static void ProceduralImage(std::vector<unsigned char> &pixels, const int &size)
+{
+    pixels.resize((size_t)size * size * 4);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            unsigned char *pixel = &pixels[((size_t)y * size + x) * 4];
+            pixel[0] = (unsigned char)(127.5f + 127.5f * sinf(x * 0.0131f + y * 0.0023f));
+            pixel[1] = (unsigned char)((x ^ y) & 0xff);
+            pixel[2] = (unsigned char)(127.5f + 127.5f * cosf(y * 0.0417f));
+            // hard edged cut outs, the case premultiplied filtering is for
+            pixel[3] = ((x / 37 + y / 53) & 3) ? 255 : (unsigned char)(x * 7 + y * 3);
+        }
+    }
+}
+
+// bytes that differ from the stbir result
+static size_t Differences(const std::vector<unsigned char> &expected, const std::vector<unsigned char> &actual)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        count += expected[i] != actual[i];
+    }
+    return count;
+}
+
+template <typename Resize>
+static double BestTime(Resize resize)
+{
+    CHighResolutionTimer timer;
+    double best = 1e30;
+    for (int run = 0; run < RUNS; ++run) {
+        timer.Start();
+        resize();
+        best = std::min(best, timer.Elapsed());
+    }
+    return best;
+}
+
+// the top left inputSize x inputSize pixels of the image to outputSize x outputSize
+static int BenchmarkResize(const std::vector<unsigned char> &image, const int &imageSize, const int &inputSize, const int &outputSize,
+                           CTextureResampler &serial, CTextureResampler &parallel)
+{
+    const int stride = imageSize * 4;
+    std::vector<unsigned char> expected((size_t)outputSize * outputSize * 4), actual(expected.size());
+    size_t differences = 0;
+
+    double stbirTime = BestTime([&]() {
+        stbir_resize_uint8_srgb(image.data(), inputSize, inputSize, stride, expected.data(), outputSize, outputSize, 0, 4, 3, 0);
+    });
+
+    serial.SetUseAVX2(false);
+    double sseTime = BestTime([&]() {
+        serial.ResizeUint8SRGB(image.data(), inputSize, inputSize, stride, actual.data(), outputSize, outputSize, 0, 4, 3, 0);
+    });
+    differences += Differences(expected, actual);
+
+    serial.SetUseAVX2(true);
+    double avx2Time = 0.0;
+    if (serial.IsUsingAVX2()) {
+        avx2Time = BestTime([&]() {
+            serial.ResizeUint8SRGB(image.data(), inputSize, inputSize, stride, actual.data(), outputSize, outputSize, 0, 4, 3, 0);
+        });
+        differences += Differences(expected, actual);
+    }
+
+    double parallelTime = BestTime([&]() {
+        parallel.ResizeUint8SRGB(image.data(), inputSize, inputSize, stride, actual.data(), outputSize, outputSize, 0, 4, 3, 0);
+    });
+    differences += Differences(expected, actual);
+
+    std::cout << std::setw(6) << inputSize << " ->" << std::setw(6) << outputSize << std::fixed << std::setprecision(1)
+              << std::setw(12) << stbirTime << std::setw(12) << sseTime << std::setw(12) << avx2Time
+              << std::setw(12) << parallelTime << std::setw(6) << parallel.GetThreadCount()
+              << std::setw(10) << differences << std::endl;
+    if (differences) {
+        std::cerr << differences << " bytes differ from stbir" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+static int BenchmarkMipChain(const std::vector<unsigned char> &image, const int &size, CTextureResampler &parallel)
+{
+    CHighResolutionTimer timer;
+
+    // what a baking tool would do with stbir alone, one level at a time from the level before
+    timer.Start();
+    std::vector<SMipLevel> expected(1);
+    expected[0].width = expected[0].height = size;
+    expected[0].pixels = image;
+    while (expected.back().width > 1 || expected.back().height > 1) {
+        const SMipLevel &previous = expected.back();
+        SMipLevel level;
+        level.width = std::max(1, previous.width / 2);
+        level.height = std::max(1, previous.height / 2);
+        level.pixels.resize((size_t)level.width * level.height * 4);
+        stbir_resize_uint8_srgb(previous.pixels.data(), previous.width, previous.height, 0,
+                                level.pixels.data(), level.width, level.height, 0, 4, 3, 0);
+        expected.push_back(std::move(level));
+    }
+    double stbirTime = timer.Elapsed();
+
+    std::vector<SMipLevel> levels;
+    timer.Start();
+    if (!parallel.BuildMipChain(image.data(), size, size, 4, 3, true, levels)) {
+        std::cerr << "BuildMipChain failed" << std::endl;
+        return 1;
+    }
+    double parallelTime = timer.Elapsed();
+
+    size_t differences = levels.size() == expected.size() ? 0 : 1;
+    for (size_t i = 0; i < std::min(levels.size(), expected.size()); ++i) {
+        differences += Differences(expected[i].pixels, levels[i].pixels);
+    }
+
+    std::cout << "mip chain of " << levels.size() << " levels: stbir " << std::fixed << std::setprecision(1) << stbirTime
+              << " ms, " << parallel.GetThreadCount() << " threads " << parallelTime << " ms, "
+              << differences << " bytes differ" << std::endl;
+    return differences ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int size = argc > 1 ? atoi(argv[1]) : 8192;
+
+    std::vector<unsigned char> image;
+    ProceduralImage(image, size);
+
+    CTextureResampler serial(1);
+    CTextureResampler parallel;
+
+    std::cout << std::setw(16) << "resize" << std::setw(12) << "stbir ms" << std::setw(12) << "SSE2 ms" << std::setw(12) << "AVX2 ms"
+              << std::setw(12) << "N thread ms" << std::setw(6) << "N" << std::setw(10) << "differ" << std::endl;
+    // the mip step, a non power of two reduction and an upsample
+    if (BenchmarkResize(image, size, size, size / 2, serial, parallel) != 0 ||
+        BenchmarkResize(image, size, size, size * 3 / 10, serial, parallel) != 0 ||
+        BenchmarkResize(image, size, size / 4, size / 2, serial, parallel) != 0)
+        return 1;
+    return BenchmarkMipChain(image, size, parallel);
+}
@@ -0,0 +1,150 @@
+// Headless benchmark of the voxel world: no window or OpenGL context is
+// created. A noise terrain of 16 x 8 x 16 chunks is generated and every chunk
+// is greedy meshed on one thread and on all cores, reporting chunks per
+// second and the memory of the palette compressed blocks and of the meshes.
+// The quads have to cover exactly the block faces that touch air. Blocks are
+// then dug out at random to time the remeshing of the dirty chunks, and the
+// chunks are culled along a camera flight.
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "objects/VoxelWorld.h"
+#include "timer/HighResolutionTimer.h"
+
+// block faces that touch air, what the greedy quads have to cover
+static size_t ExposedFaces(const CVoxelWorld &world)
+{
+    const int sizeX = world.GetChunksX() * CVoxelChunk::SIZE;
+    const int sizeY = world.GetChunksY() * CVoxelChunk::SIZE;
+    const int sizeZ = world.GetChunksZ() * CVoxelChunk::SIZE;
+    size_t faces = 0;
+    for (int z = 0; z < sizeZ; ++z) {
+        for (int y = 0; y < sizeY; ++y) {
+            for (int x = 0; x < sizeX; ++x) {
+                if (world.GetBlock(x, y, z) == VOXEL_AIR)
+                    continue;
+                faces += (world.GetBlock(x - 1, y, z) == VOXEL_AIR) + (world.GetBlock(x + 1, y, z) == VOXEL_AIR)
+                       + (world.GetBlock(x, y - 1, z) == VOXEL_AIR) + (world.GetBlock(x, y + 1, z) == VOXEL_AIR)
+                       + (world.GetBlock(x, y, z - 1) == VOXEL_AIR) + (world.GetBlock(x, y, z + 1) == VOXEL_AIR);
+            }
+        }
+    }
+    return faces;
+}
+
+// block faces covered by the quads of every chunk, from the first and third corner of each quad
+static size_t CoveredFaces(const CVoxelWorld &world, size_t &quads)
+{
+    size_t faces = 0;
+    quads = 0;
+    for (unsigned int chunk = 0; chunk < world.GetChunkCount(); ++chunk) {
+        const std::vector<SVoxelVertex> &vertices = world.GetChunkVertices(chunk);
+        for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+            const uint32_t a = vertices[i].position, c = vertices[i + 2].position;
+            int extent[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                extent[axis] = abs((int)((c >> (axis * 6)) & 63) - (int)((a >> (axis * 6)) & 63));
+            }
+            faces += (size_t)std::max(extent[0], 1) * std::max(extent[1], 1) * std::max(extent[2], 1);
+        }
+        quads += vertices.size() / 4;
+    }
+    return faces;
+}
+
+static double MeshAll(CVoxelWorld &world, const int &seed)
+{
+    world.Generate(seed);
+    std::vector<unsigned int> meshed;
+    CHighResolutionTimer timer;
+    timer.Start();
+    world.MeshDirtyChunks(meshed);
+    return timer.Elapsed();
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned int chunksX = argc > 1 ? atoi(argv[1]) : 16, chunksY = argc > 2 ? atoi(argv[2]) : 8, chunksZ = chunksX;
+    const int seed = 7;
+
+    CVoxelWorld serial(1), parallel;
+    serial.Create(chunksX, chunksY, chunksZ);
+    parallel.Create(chunksX, chunksY, chunksZ);
+
+    CHighResolutionTimer timer;
+    timer.Start();
+    parallel.Generate(seed);
+    double generateTime = timer.Elapsed();
+
+    double serialTime = MeshAll(serial, seed);
+    double parallelTime = MeshAll(parallel, seed);
+    const unsigned int chunks = parallel.GetChunkCount();
+
+    unsigned int nonEmpty = 0, meshedChunks = 0;
+    for (unsigned int chunk = 0; chunk < chunks; ++chunk) {
+        nonEmpty += !parallel.GetChunk(chunk).IsEmpty();
+        meshedChunks += !parallel.GetChunkVertices(chunk).empty();
+    }
+    size_t quads = 0;
+    size_t exposed = ExposedFaces(parallel), covered = CoveredFaces(parallel, quads);
+    const size_t denseBytes = (size_t)chunks * CVoxelChunk::VOLUME * sizeof(VoxelBlock);
+
+    std::cout << chunksX << " x " << chunksY << " x " << chunksZ << " chunks of " << CVoxelChunk::SIZE << "^3, "
+              << nonEmpty << " not empty, " << meshedChunks << " with faces, generated in "
+              << std::fixed << std::setprecision(1) << generateTime << " ms" << std::endl;
+    std::cout << std::setw(12) << "meshing" << std::setw(12) << "ms" << std::setw(14) << "chunks/s" << std::endl;
+    std::cout << std::setw(12) << "serial" << std::setw(12) << serialTime << std::setw(14) << (int)(chunks / serialTime * 1000.0) << std::endl;
+    std::cout << std::setw(12) << std::to_string(parallel.GetThreadCount()) + " threads" << std::setw(12) << parallelTime << std::setw(14) << (int)(chunks / parallelTime * 1000.0) << std::endl;
+    std::cout << "blocks: " << parallel.GetBlockMemoryUsage() / 1024 << " KB, " << parallel.GetBlockMemoryUsage() / chunks
+              << " bytes per chunk (dense " << denseBytes / chunks << ")" << std::endl;
+    std::cout << "meshes: " << parallel.GetMeshMemoryUsage() / 1024 << " KB, " << quads << " quads for " << exposed
+              << " block faces, " << (meshedChunks ? parallel.GetMeshMemoryUsage() / meshedChunks : 0) << " bytes per chunk with faces" << std::endl;
+    if (covered != exposed) {
+        std::cerr << "the quads cover " << covered << " block faces instead of " << exposed << std::endl;
+        return 1;
+    }
+
+    // dig random tunnels and remesh what they touched
+    srand(1);
+    const int sizeX = chunksX * CVoxelChunk::SIZE, sizeY = chunksY * CVoxelChunk::SIZE, sizeZ = chunksZ * CVoxelChunk::SIZE;
+    for (int i = 0; i < 2000; ++i) {
+        const int x = rand() % sizeX, y = rand() % (sizeY / 2), z = rand() % sizeZ;
+        parallel.SetBlock(x, y, z, VOXEL_AIR);
+        parallel.SetBlock(x + 1, y, z, VOXEL_AIR);
+    }
+    const unsigned int dirty = parallel.GetDirtyChunkCount();
+    std::vector<unsigned int> meshed;
+    timer.Start();
+    parallel.MeshDirtyChunks(meshed);
+    double remeshTime = timer.Elapsed();
+    exposed = ExposedFaces(parallel);
+    covered = CoveredFaces(parallel, quads);
+    std::cout << "4000 blocks dug out: " << dirty << " dirty chunks remeshed in " << remeshTime << " ms" << std::endl;
+    if (covered != exposed) {
+        std::cerr << "after digging the quads cover " << covered << " block faces instead of " << exposed << std::endl;
+        return 1;
+    }
+
+    // a circle above the terrain looking down the slopes
+    const glm::vec3 centre(sizeX * 0.5f, sizeY * 0.8f, sizeZ * 0.5f);
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.5f, 2000.0f);
+    std::vector<unsigned int> visible;
+    size_t visibleTotal = 0;
+    const int frames = 1000;
+    timer.Start();
+    for (int frame = 0; frame < frames; ++frame) {
+        const float angle = frame * 0.00628f;
+        const glm::vec3 eye = centre + glm::vec3(cosf(angle), 0.0f, sinf(angle)) * (sizeX * 0.3f);
+        visible.clear();
+        parallel.Cull(projection * glm::lookAt(eye, eye + glm::vec3(cosf(angle + 1.5f), -0.4f, sinf(angle + 1.5f)), glm::vec3(0, 1, 0)), visible);
+        visibleTotal += visible.size();
+    }
+    double cullTime = timer.Elapsed();
+    std::cout << "culling: " << std::setprecision(4) << cullTime / frames << " ms per frame, " << visibleTotal / frames
+              << " of " << meshedChunks << " chunks with faces visible" << std::endl;
+    return 0;
+}
@@ -34,6 +34,7 @@
 #include "controls/Slider.h"
 #include "objects/Plane.h"
 #include "objects/HeightMapTerrain.h"
+#include "objects/VoxelTerrain.h"
 #include "objects/Cube.h"
 #include "objects/Sphere.h"
 #include "objects/Torus.h"
@@ -865,8 +865,13 @@ void CFrameBufferObject::BlitToDepthBuffer(GLuint depthbuffer)
 {
     // copy content of geometry's depth buffer to default framebuffer's depth buffer
     // ----------------------------------------------------------------------------------
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_uiFramebuffer);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depthbuffer); // write to default framebuffer at 0
+    BlitDepthToDrawBuffer();
+}
+
+void CFrameBufferObject::BlitDepthToDrawBuffer()
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_uiFramebuffer);
     // blit to default framebuffer. Note that this may or may not work as the internal formats of both the FBO and default framebuffer have to match.
     // the internal formats are implementation defined. This works on all of my systems, but if it doesn't on yours you'll likely have to write to the
     // depth buffer in another shader stage (or somehow see to match the default framebuffer's internal format with the FBO's internal format).
@@ -50,6 +50,9 @@ public:
     // Blit multisampled buffer(s) to the usual depthbuffer of intermediate FBO. Image is stored in depthBuffer texture
     void BlitToDepthBuffer(GLuint depthbuffer);
     
+    // Copy the depth buffer into the frame buffer already bound for drawing, for a pass merged with the previous one
+    void BlitDepthToDrawBuffer();
+    
 	// Delete the framebuffer
 	void Release();
 
@@ -0,0 +1,163 @@
+#include "PostProcessingGraph.h"
+
+const unsigned int CPostProcessingGraph::SLOT_COUNT;
+
+FrameBufferType CPostProcessingGraph::GetSlotType(const unsigned int &slot)
+{
+    static const FrameBufferType types[SLOT_COUNT] = {
+        FrameBufferType::Default,                       // 0 scene
+        FrameBufferType::DeferredRendering,             // 1
+        FrameBufferType::PingPongRendering,             // 2 blur
+        FrameBufferType::DepthMapping,                  // 3
+        FrameBufferType::Default,                       // 4 second scene
+        FrameBufferType::SSAO,                          // 5 ambient occlusion
+        FrameBufferType::SSAO,                          // 6 ambient occlusion blur
+        FrameBufferType::DirectionalShadowMapping,      // 7
+        FrameBufferType::OmnidirectionalShadowMapping,  // 8
+        FrameBufferType::HighDynamicRangeRendering,     // 9
+        FrameBufferType::HighDynamicRangeLighting,      // 10
+        FrameBufferType::GeometryBuffer                 // 11
+    };
+    return types[slot];
+}
+
+FrameBufferType CPostProcessingGraph::GetSceneType(const PostProcessingEffectMode &mode)
+{
+    switch(mode) {
+        case PostProcessingEffectMode::GaussianBlur:
+        case PostProcessingEffectMode::BrightParts:
+        case PostProcessingEffectMode::Bloom:
+        case PostProcessingEffectMode::LensFlare:
+            return FrameBufferType::HighDynamicRangeRendering;
+        case PostProcessingEffectMode::HDRToneMapping:
+            return FrameBufferType::HighDynamicRangeLighting;
+        case PostProcessingEffectMode::DeferredRendering:
+            return FrameBufferType::DeferredRendering;
+        case PostProcessingEffectMode::SSAO:
+            return FrameBufferType::GeometryBuffer;
+        default:
+            return FrameBufferType::Default;
+    }
+}
+
+size_t CPostProcessingGraph::GetTargetBytes(const FrameBufferType &type, const unsigned int &width, const unsigned int &height,
+                                            const unsigned int &shadowSize)
+{
+    const size_t pixels = (size_t)width * height;
+    const size_t shadowPixels = (size_t)shadowSize * shadowSize;
+    switch(type) {
+        case FrameBufferType::Default:
+            return pixels * (4 + 4 + 8 + 4 + 4);    // RGBA8, depth texture, RGB16F, RGBA8, depth stencil
+        case FrameBufferType::DepthMapping:
+        case FrameBufferType::DirectionalShadowMapping:
+            return shadowPixels * 4;                // depth
+        case FrameBufferType::OmnidirectionalShadowMapping:
+            return shadowPixels * 4 * 6;            // depth cube map
+        case FrameBufferType::PingPongRendering:
+            return pixels * 8 * 2;                  // two RGB16F
+        case FrameBufferType::HighDynamicRangeLighting:
+            return pixels * (8 + 4);                // RGBA16F, depth
+        case FrameBufferType::HighDynamicRangeRendering:
+            return pixels * (8 * 2 + 4);            // two RGB16F, depth
+        case FrameBufferType::DeferredRendering:
+        case FrameBufferType::GeometryBuffer:
+            return pixels * (8 * 4 + 4 + 4);        // two RGB16F, position, normal, albedo, depth
+        case FrameBufferType::SSAO:
+            return pixels;                          // red
+        default:
+            return 0;
+    }
+}
+
+void CPostProcessingGraph::Declare(const PostProcessingEffectMode &mode, const unsigned int &width, const unsigned int &height,
+                                   const unsigned int &shadowSize, CRenderGraph &graph, std::vector<int> &slotTargets)
+{
+    const int SCREEN = CRenderGraph::SCREEN;
+    static const char *names[SLOT_COUNT] = {
+        "scene", "deferred", "ping pong", "depth", "second scene", "ssao", "ssao blur",
+        "directional shadow", "omnidirectional shadow", "hdr", "hdr lighting", "geometry"
+    };
+
+    slotTargets.resize(SLOT_COUNT);
+    for (unsigned int slot = 0; slot < SLOT_COUNT; ++slot) {
+        SRenderTargetDesc desc;
+        desc.type = GetSlotType(slot);
+        const bool shadow = desc.type == FrameBufferType::DepthMapping || desc.type == FrameBufferType::DirectionalShadowMapping ||
+                            desc.type == FrameBufferType::OmnidirectionalShadowMapping;
+        desc.width = shadow ? shadowSize : width;
+        desc.height = shadow ? shadowSize : height;
+        desc.bytes = GetTargetBytes(desc.type, width, height, shadowSize);
+        slotTargets[slot] = graph.CreateTarget(names[slot], desc);
+    }
+    const std::vector<int> &s = slotTargets;
+
+    // Game::BindPPFXFBO, the scene goes into the first slot of its frame buffer type
+    int scene = s[0];
+    switch(GetSceneType(mode)) {
+        case FrameBufferType::HighDynamicRangeRendering: scene = s[9]; break;
+        case FrameBufferType::HighDynamicRangeLighting: scene = s[10]; break;
+        case FrameBufferType::DeferredRendering: scene = s[1]; break;
+        case FrameBufferType::GeometryBuffer: scene = s[11]; break;
+        default: break;
+    }
+    graph.AddPass("scene", {}, scene);
+
+    // Game::RenderPPFXScene
+    switch(mode) {
+        case PostProcessingEffectMode::GaussianBlur:
+        case PostProcessingEffectMode::Bloom:
+        case PostProcessingEffectMode::LensFlare: {
+            const int amount = mode == PostProcessingEffectMode::GaussianBlur ? 9 : 10;
+            graph.AddPass("blur", { s[9] }, s[2]);
+            for (int i = 1; i < amount; ++i) {
+                graph.AddPass("blur", { s[2] }, s[2]);
+            }
+            if (mode == PostProcessingEffectMode::LensFlare) {
+                graph.AddPass("lens flare ghost", { s[2] }, s[4]);
+                graph.AddPass("lens flare", { s[4], s[9] }, SCREEN);
+            } else {
+                graph.AddPass(mode == PostProcessingEffectMode::Bloom ? "bloom" : "blur", { s[9], s[2] }, SCREEN);
+            }
+            break;
+        }
+        case PostProcessingEffectMode::BrightParts:
+            graph.AddPass("bright parts", { s[9] }, SCREEN);
+            break;
+        case PostProcessingEffectMode::HDRToneMapping:
+            graph.AddPass("tone mapping", { s[10] }, SCREEN);
+            break;
+        case PostProcessingEffectMode::MotionBlur:
+            graph.AddPass("depth", {}, s[3]);
+            graph.AddPass("motion blur", { s[3], scene }, SCREEN);
+            break;
+        case PostProcessingEffectMode::SSAO:
+            graph.AddPass("ssao", { s[11] }, s[5]);
+            graph.AddPass("ssao blur", { s[5] }, s[6]);
+            graph.AddPass("ssao lighting", { s[6], s[11] }, SCREEN);
+            break;
+        case PostProcessingEffectMode::DepthTesting:
+            graph.AddPass("depth testing scene", {}, s[4]);
+            graph.AddPass("composite", { s[4], scene }, SCREEN);
+            break;
+        case PostProcessingEffectMode::DepthMapping:
+            graph.AddPass("light space depth", {}, s[3]);
+            graph.AddPass("depth mapping", { s[3], scene }, SCREEN);
+            break;
+        case PostProcessingEffectMode::DirectionalShadowMapping:
+        case PostProcessingEffectMode::OmnidirectionalShadowMapping: {
+            const int shadowMap = mode == PostProcessingEffectMode::DirectionalShadowMapping ? s[7] : s[8];
+            graph.AddPass("light space depth", {}, shadowMap);
+            graph.AddPass("shadowed scene", { shadowMap }, s[4]);
+            graph.AddPass("composite", { s[4], scene }, SCREEN);
+            break;
+        }
+        case PostProcessingEffectMode::DeferredRendering:
+            graph.AddPass("deferred lighting", { s[1] }, SCREEN);
+            graph.AddPass("lamps", { s[1] }, SCREEN);     // depth blitted from the geometry
+            break;
+        default:
+            // every other effect is a single full screen pass over the scene
+            graph.AddPass("effect", { scene }, SCREEN);
+            break;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef PostProcessingGraph_h
+#define PostProcessingGraph_h
+
+#include <vector>
+#include "RenderGraph.h"
+#include "../utilities/PostProcessingEffectMode.h"
+
+// The frame buffers of the post processing effects as a render graph, it never calls OpenGL.
+// The effects refer to their frame buffers through the slots of IPostProcessing::m_pFBOs,
+// every slot becomes a graph target so that only the slots the current effect draws into
+// get a frame buffer and slots with disjoint lifetimes share one.
+class CPostProcessingGraph
+{
+public:
+    static const unsigned int SLOT_COUNT = 12;
+
+    ///Frame buffer type of each slot of IPostProcessing::m_pFBOs.
+    static FrameBufferType GetSlotType(const unsigned int &slot);
+
+    ///Frame buffer type the scene is rendered into before the effect runs.
+    static FrameBufferType GetSceneType(const PostProcessingEffectMode &mode);
+
+    ///Video memory CFrameBufferObject::CreateFramebuffer allocates for a frame buffer type,
+    ///three component formats are counted padded to four as drivers store them.
+    static size_t GetTargetBytes(const FrameBufferType &type, const unsigned int &width, const unsigned int &height,
+                                 const unsigned int &shadowSize);
+
+    ///Declares the passes mode renders every frame into graph. slotTargets receives the graph target of every slot.
+    static void Declare(const PostProcessingEffectMode &mode, const unsigned int &width, const unsigned int &height,
+                        const unsigned int &shadowSize, CRenderGraph &graph, std::vector<int> &slotTargets);
+};
+
+#endif /* PostProcessingGraph_h */
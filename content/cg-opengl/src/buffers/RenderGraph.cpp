@@ -0,0 +1,199 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+const int CRenderGraph::SCREEN;
+
+static bool Contains(const std::vector<int> &targets, const int &target)
+{
+    return std::find(targets.begin(), targets.end(), target) != targets.end();
+}
+
+CRenderGraph::CRenderGraph()
+{
+    Clear();
+}
+
+CRenderGraph::~CRenderGraph()
+{}
+
+void CRenderGraph::Clear()
+{
+    m_targets.clear();
+    m_passes.clear();
+    m_physical.clear();
+    m_stats = SRenderGraphStats();
+}
+
+int CRenderGraph::CreateTarget(const std::string &name, const SRenderTargetDesc &desc)
+{
+    STarget target;
+    target.name = name;
+    target.desc = desc;
+    target.first = 1;
+    target.last = 0;
+    target.physical = -1;
+    m_targets.push_back(target);
+    return (int)m_targets.size() - 1;
+}
+
+int CRenderGraph::AddPass(const std::string &name, const std::vector<int> &reads, const int &target)
+{
+    SPass pass;
+    pass.name = name;
+    pass.reads = reads;
+    pass.target = target;
+    pass.live = false;
+    pass.merged = false;
+    m_passes.push_back(pass);
+    return (int)m_passes.size() - 1;
+}
+
+int CRenderGraph::FindPass(const std::string &name) const
+{
+    for (size_t p = 0; p < m_passes.size(); ++p) {
+        if (m_passes[p].name == name) return (int)p;
+    }
+    return -1;
+}
+
+void CRenderGraph::Compile()
+{
+    m_stats = SRenderGraphStats();
+    CullPasses();
+    ComputeLifetimes();
+    AliasTargets();
+    MergePasses();
+
+    m_stats.declaredPasses = (unsigned int)m_passes.size();
+    m_stats.declaredTargets = (unsigned int)m_targets.size();
+    m_stats.physicalTargets = (unsigned int)m_physical.size();
+    for (const SPass &pass : m_passes) {
+        if (pass.live) ++m_stats.livePasses;
+    }
+    for (const STarget &target : m_targets) {
+        m_stats.declaredBytes += target.desc.bytes;
+        if (target.physical >= 0) ++m_stats.liveTargets;
+    }
+    for (const SPhysicalTarget &physical : m_physical) {
+        m_stats.allocatedBytes += physical.desc.bytes;
+    }
+}
+
+void CRenderGraph::CullPasses()
+{
+    const int passCount = (int)m_passes.size();
+    for (SPass &pass : m_passes) {
+        pass.live = false;
+        pass.merged = false;
+    }
+
+    // A pass is live when it draws to the screen or a later live pass samples its target. Passes
+    // draw on top of what the target holds, so any earlier pass into the same target counts too.
+    // The search wraps around the end of the frame for targets carried over to the next one,
+    // and repeats until nothing changes.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int p = passCount - 1; p >= 0; --p) {
+            SPass &pass = m_passes[p];
+            if (pass.live) continue;
+
+            bool consumed = pass.target == SCREEN;
+            for (int k = 1; k < passCount && !consumed; ++k) {
+                const SPass &next = m_passes[(p + k) % passCount];
+                consumed = next.live && Contains(next.reads, pass.target);
+            }
+            if (consumed) {
+                pass.live = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+void CRenderGraph::ComputeLifetimes()
+{
+    const int passCount = (int)m_passes.size();
+    std::vector<bool> carried(m_targets.size(), false);
+    for (STarget &target : m_targets) {
+        target.first = 1;
+        target.last = 0;
+        target.physical = -1;
+    }
+
+    for (int p = 0; p < passCount; ++p) {
+        const SPass &pass = m_passes[p];
+        if (!pass.live) continue;
+
+        for (const int &read : pass.reads) {
+            STarget &target = m_targets[read];
+            // sampled before anything drew into it this frame, the contents come from the last frame
+            if (target.first > target.last) {
+                carried[read] = true;
+                target.first = p;
+            }
+            target.last = p;
+        }
+        if (pass.target != SCREEN) {
+            STarget &target = m_targets[pass.target];
+            if (target.first > target.last) target.first = p;
+            target.last = p;
+        }
+    }
+
+    // carried over targets live through the whole frame and are never shared
+    for (size_t t = 0; t < m_targets.size(); ++t) {
+        if (carried[t]) {
+            m_targets[t].first = 0;
+            m_targets[t].last = passCount - 1;
+        }
+    }
+}
+
+void CRenderGraph::AliasTargets()
+{
+    m_physical.clear();
+
+    std::vector<int> order;
+    for (size_t t = 0; t < m_targets.size(); ++t) {
+        if (m_targets[t].first <= m_targets[t].last) order.push_back((int)t);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](const int &a, const int &b) {
+        return m_targets[a].first < m_targets[b].first;
+    });
+
+    // first fit: reuse a frame buffer of the same description whose last user ran before this target's first pass
+    for (const int &t : order) {
+        STarget &target = m_targets[t];
+        for (size_t i = 0; i < m_physical.size() && target.physical < 0; ++i) {
+            SPhysicalTarget &physical = m_physical[i];
+            if (physical.desc.type == target.desc.type && physical.desc.width == target.desc.width &&
+                physical.desc.height == target.desc.height && physical.last < target.first) {
+                target.physical = (int)i;
+                physical.last = target.last;
+            }
+        }
+        if (target.physical < 0) {
+            SPhysicalTarget physical;
+            physical.desc = target.desc;
+            physical.last = target.last;
+            m_physical.push_back(physical);
+            target.physical = (int)m_physical.size() - 1;
+        }
+    }
+}
+
+void CRenderGraph::MergePasses()
+{
+    // nothing is assumed to be bound when the frame starts
+    int bound = SCREEN - 1;
+    for (SPass &pass : m_passes) {
+        if (!pass.live) continue;
+
+        int target = pass.target == SCREEN ? SCREEN : m_targets[pass.target].physical;
+        pass.merged = target == bound && (pass.target == SCREEN || !Contains(pass.reads, pass.target));
+        if (!pass.merged) ++m_stats.targetBinds;
+        bound = target;
+    }
+}
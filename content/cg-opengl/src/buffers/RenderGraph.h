@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef RenderGraph_h
+#define RenderGraph_h
+
+#include <string>
+#include <vector>
+#include "../utilities/FrameBufferType.h"
+
+// what a render target is created as, targets with the same description can share a frame buffer
+struct SRenderTargetDesc
+{
+    FrameBufferType type;
+    unsigned int width, height;
+    size_t bytes;                   // video memory of the frame buffer with all of its attachments
+};
+
+struct SRenderGraphStats
+{
+    unsigned int declaredPasses, livePasses;
+    unsigned int declaredTargets, liveTargets, physicalTargets;
+    size_t declaredBytes;           // every declared target created on its own
+    size_t allocatedBytes;          // the frame buffers the live targets are aliased onto
+    unsigned int targetBinds;       // frame buffer binds per frame once passes are merged, binds of the screen included
+};
+
+// Frame graph of a multi pass effect, it never calls OpenGL.
+// Passes are declared in execution order with the targets they sample and
+// the one target they draw into. Compile() culls the passes whose output
+// never reaches the screen, gives every remaining target a lifetime from its
+// first to its last use and aliases targets of the same description whose
+// lifetimes do not overlap onto one physical frame buffer. Consecutive passes
+// drawing into the same target without sampling it are merged, so the target
+// is bound once for all of them.
+class CRenderGraph
+{
+public:
+    static const int SCREEN = -1;
+
+    CRenderGraph();
+    ~CRenderGraph();
+
+    ///Forgets every pass and target so that a new frame can be declared.
+    void Clear();
+
+    ///Declares a transient render target, it only gets a frame buffer if a live pass uses it.
+    int CreateTarget(const std::string &name, const SRenderTargetDesc &desc);
+
+    ///Declares a pass sampling reads and drawing into target, SCREEN is the default frame buffer.
+    ///A target sampled before any pass of the frame writes it keeps its contents from the previous frame.
+    int AddPass(const std::string &name, const std::vector<int> &reads, const int &target);
+
+    void Compile();
+
+    ///Physical frame buffer a target is aliased onto, -1 for a culled target.
+    int GetPhysicalTarget(const int &target) const { return m_targets[target].physical; }
+    unsigned int GetPhysicalTargetCount() const { return (unsigned int)m_physical.size(); }
+    const SRenderTargetDesc &GetPhysicalTargetDesc(const unsigned int &physical) const { return m_physical[physical].desc; }
+
+    bool IsPassLive(const int &pass) const { return m_passes[pass].live; }
+    ///A merged pass draws into the frame buffer the previous live pass left bound.
+    bool IsPassMerged(const int &pass) const { return m_passes[pass].merged; }
+
+    unsigned int GetPassCount() const { return (unsigned int)m_passes.size(); }
+    unsigned int GetTargetCount() const { return (unsigned int)m_targets.size(); }
+    const std::string &GetPassName(const int &pass) const { return m_passes[pass].name; }
+    ///First pass declared with name, -1 if there is none.
+    int FindPass(const std::string &name) const;
+    const std::vector<int> &GetPassReads(const int &pass) const { return m_passes[pass].reads; }
+    int GetPassTarget(const int &pass) const { return m_passes[pass].target; }
+    const std::string &GetTargetName(const int &target) const { return m_targets[target].name; }
+    const SRenderGraphStats &GetStats() const { return m_stats; }
+
+private:
+    struct STarget
+    {
+        std::string name;
+        SRenderTargetDesc desc;
+        int first, last;            // live passes using the target, first > last when unused
+        int physical;
+    };
+
+    struct SPass
+    {
+        std::string name;
+        std::vector<int> reads;
+        int target;
+        bool live, merged;
+    };
+
+    struct SPhysicalTarget
+    {
+        SRenderTargetDesc desc;
+        int last;                   // last pass of the latest target aliased onto it
+    };
+
+    void CullPasses();
+    void ComputeLifetimes();
+    void AliasTargets();
+    void MergePasses();
+
+    std::vector<STarget> m_targets;
+    std::vector<SPass> m_passes;
+    std::vector<SPhysicalTarget> m_physical;
+    SRenderGraphStats m_stats;
+};
+
+#endif /* RenderGraph_h */
@@ -9,6 +9,7 @@
 CVertexBufferObject::CVertexBufferObject()
 {
 	m_dataUploaded = false;
+	m_capacity = 0;
 }
 
 CVertexBufferObject::~CVertexBufferObject()
@@ -27,6 +28,7 @@ void CVertexBufferObject::Release()
 {
 	glDeleteBuffers(1, &m_vbo);
 	m_dataUploaded = false;
+	m_capacity = 0;
 	m_data.clear();
 }
 
@@ -83,6 +85,20 @@ void CVertexBufferObject::UploadDataToGPU(int usageHint)
 	m_data.clear();
 }
 
+// Uploads data that is rewritten every frame. Orphaning the old storage lets the driver hand out
+// fresh memory instead of waiting for draws still reading it; the capacity grows by half so that
+// slowly growing data does not reallocate every frame.
+void CVertexBufferObject::UploadStreamingDataToGPU(const void* ptrData, GLsizeiptr dataSize)
+{
+    if (dataSize > m_capacity)
+        m_capacity = std::max(dataSize, m_capacity + m_capacity/2);
+    
+    glBufferData(GL_ARRAY_BUFFER, m_capacity, NULL, GL_STREAM_DRAW);
+    if (dataSize > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, ptrData);
+    m_dataUploaded = true;
+}
+
 // Adds data to the VBO.  
 void CVertexBufferObject::AddData(void* ptrData, uint dataSize)
 {
@@ -16,10 +16,13 @@ public:
     void CopyTo(const GLenum &writetarget, const GLsizeiptr &size);
 	void AddData(void* ptrData, uint dataSize);	// Adds data to the VBO
 	void UploadDataToGPU(int usageHint);			// Uploads the VBO to the GPU
+    // Uploads data that changes every frame, the storage is orphaned and only ever grows
+    void UploadStreamingDataToGPU(const void* ptrData, GLsizeiptr dataSize);
 
 	
 private:
 	uint m_vbo;									// VBO id
 	std::vector<BYTE> m_data;							// Data to be put in the VBO
 	bool m_dataUploaded;							// A flag indicating if the data has been sent to the GPU
+	GLsizeiptr m_capacity;							// Bytes allocated on the GPU for streamed data
 };
@@ -9,6 +9,8 @@
 CVertexBufferObjectIndexed::CVertexBufferObjectIndexed()
 {
 	m_dataUploaded = false;
+	m_vertexCapacity = 0;
+	m_indexCapacity = 0;
 }
 
 CVertexBufferObjectIndexed::~CVertexBufferObjectIndexed()
@@ -66,6 +68,8 @@ void CVertexBufferObjectIndexed::Release()
     glDeleteBuffers(1, &m_vboVertices);
     glDeleteBuffers(1, &m_vboIndices);
     m_dataUploaded = false;
+    m_vertexCapacity = 0;
+    m_indexCapacity = 0;
     m_vertexData.clear();
     m_indexData.clear();
 }
@@ -114,6 +118,26 @@ void CVertexBufferObjectIndexed::UploadDataToGPU(int iUsageHint)
 	m_indexData.clear();
 }
 
+// Uploads data that changes every frame straight from the caller's memory, the VBO must be bound.
+// The storage only grows (by at least half) and is otherwise orphaned, so the driver can hand out
+// fresh memory instead of waiting for the GPU to finish drawing the previous frame.
+void CVertexBufferObjectIndexed::UploadStreamingDataToGPU(const void* pVertexData, GLsizeiptr vertexDataSize,
+                                                          const void* pIndexData, GLsizeiptr indexDataSize)
+{
+    if (vertexDataSize > m_vertexCapacity)
+        m_vertexCapacity = std::max(vertexDataSize, m_vertexCapacity + m_vertexCapacity/2);
+    if (indexDataSize > m_indexCapacity)
+        m_indexCapacity = std::max(indexDataSize, m_indexCapacity + m_indexCapacity/2);
+    
+    glBufferData(GL_ARRAY_BUFFER, m_vertexCapacity, NULL, GL_STREAM_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCapacity, NULL, GL_STREAM_DRAW);
+    if (vertexDataSize > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexDataSize, pVertexData);
+    if (indexDataSize > 0)
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexDataSize, pIndexData);
+    m_dataUploaded = true;
+}
+
 // Adds data to the VBO.  
 void CVertexBufferObjectIndexed::AddVertexData(void* ptrVertexData, uint uiVertexDataSize)
 {
@@ -16,6 +16,8 @@ public:
 	void AddVertexData(void* pVertexData, uint vertexDataSize);	// Adds vertex data
 	void AddIndexData(void* pIndexData, uint indexDataSize);	// Adds index data
 	void UploadDataToGPU(int iUsageHint);			// Upload the VBO to the GPU
+    void UploadStreamingDataToGPU(const void* pVertexData, GLsizeiptr vertexDataSize,
+                                  const void* pIndexData, GLsizeiptr indexDataSize);  // Replace the VBO contents every frame, reusing the storage
     
 
 private:
@@ -26,4 +28,7 @@ private:
 	std::vector<BYTE> m_indexData;	// Index data to be uploaded
 
 	bool m_dataUploaded;		// Flag indicating if data is uploaded to the GPU
+
+	GLsizeiptr m_vertexCapacity;	// Bytes allocated on the GPU for streamed vertices
+	GLsizeiptr m_indexCapacity;		// Bytes allocated on the GPU for streamed indices
 };
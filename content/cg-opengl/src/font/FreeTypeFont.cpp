@@ -1,150 +1,131 @@
 #include "FreeTypeFont.h"
 
+#include <algorithm>
+
 CFreeTypeFont::CFreeTypeFont()
 {
 	m_isLoaded = false;
+	m_atlasTexture = 0;
+	m_atlasSampler = 0;
+	m_vao = 0;
+	m_loadedPixelSize = 0;
 }
 CFreeTypeFont::~CFreeTypeFont()
 {
     Release();
 }
 
-/* -----------------------------------------------
-
-Name:	createChar
-
-Params:	iIndex - character index in Unicode.
-
-Result:	Creates one single character (its
-		texture).
-
-/* --------------------------------------------- */
-
-inline int next_p2(int n){int res = 1; while(res < n)res <<= 1; return res;}
-
-void CFreeTypeFont::CreateChar(int index, const TextureType &textureType)
-{
-
-	FT_Load_Glyph(m_ftFace, FT_Get_Char_Index(m_ftFace, index), FT_LOAD_DEFAULT);
-
-	FT_Render_Glyph(m_ftFace->glyph, FT_RENDER_MODE_NORMAL);
-	FT_Bitmap* pBitmap = &m_ftFace->glyph->bitmap;
-
-	int iW = pBitmap->width, iH = pBitmap->rows;
-	int iTW = next_p2(iW), iTH = next_p2(iH);
-
-	GLubyte* bData = new GLubyte[iTW*iTH];
-	// Copy glyph data and add dark pixels elsewhere
-	for (int ch = 0; ch < iTH; ch++) 
-		for (int cw = 0; cw < iTW; cw++)
-			bData[ch*iTW+cw] = (ch >= iH || cw >= iW) ? 0 : pBitmap->buffer[(iH-ch-1)*iW+cw];
- 
-	// And create a texture from it
-
-    m_charTextures[index].CreateFromData(bData, iTW, iTH, 8, GL_DEPTH_COMPONENT, textureType, false);
-	m_charTextures[index].SetSamplerObjectParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	m_charTextures[index].SetSamplerObjectParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	m_charTextures[index].SetSamplerObjectParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	m_charTextures[index].SetSamplerObjectParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-	// Calculate glyph data
-	m_advX[index] = m_ftFace->glyph->advance.x>>6;
-	m_bearingX[index] = m_ftFace->glyph->metrics.horiBearingX>>6;
-	m_charWidth[index] = m_ftFace->glyph->metrics.width>>6;
-
-	m_advY[index] = (m_ftFace->glyph->metrics.height - m_ftFace->glyph->metrics.horiBearingY)>>6;
-	m_bearingY[index] = m_ftFace->glyph->metrics.horiBearingY>>6;
-	m_charHeight[index] = m_ftFace->glyph->metrics.height>>6;
-
-	m_newLine = std::max(m_newLine, int(m_ftFace->glyph->metrics.height >> 6));
-
-	// Rendering data, texture coordinates are always the same, so now we waste a little memory
-	glm::vec2 vQuad[] =
-	{
-		glm::vec2(0.0f, float(-m_advY[index]+iTH)),
-		glm::vec2(0.0f, float(-m_advY[index])),
-		glm::vec2(float(iTW), float(-m_advY[index]+iTH)),
-		glm::vec2(float(iTW), float(-m_advY[index]))
-	};
-	glm::vec2 vTexQuad[] = {glm::vec2(0.0f, 1.0f), glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(1.0f, 0.0f)};
-
-	// Add this char to VBO
-	for (int i = 0; i < 4; i++) {
-		m_vbo.AddData(&vQuad[i], sizeof(glm::vec2));
-		m_vbo.AddData(&vTexQuad[i], sizeof(glm::vec2));
-	}
-	delete[] bData;
-}
-
-
-// Loads an entire font with the given path sFile and pixel size iPXSize
+// Loads a font with the given path sFile, text is printed at pixel size iPXSize unless another size is given
 bool CFreeTypeFont::LoadFont(std::string file, int ipixelSize, const TextureType &textureType)
 {
-
-	BOOL bError = FT_Init_FreeType(&m_ftLib);
-	
-	bError = FT_New_Face(m_ftLib, file.c_str(), 0, &m_ftFace);
-	if(bError) {
+	if (!m_glyphCache.Load(file)) {
 		char message[1024];
 		sprintf(message, "ERROR::FREETYPE: Failed to load font\n%s\n", file.c_str());
 		return false;
 	}
-	FT_Set_Pixel_Sizes(m_ftFace, ipixelSize, ipixelSize);
 	m_loadedPixelSize = ipixelSize;
+	m_textureType = textureType;
+
+	// Printable ASCII is rasterized up front, everything else on first use
+	for (unsigned int i = 32; i < 127; i++)
+		m_glyphCache.Request(i);
+	m_glyphCache.Flush();
+
+	glGenTextures(1, &m_atlasTexture);
+	glGenSamplers(1, &m_atlasSampler);
+	glSamplerParameteri(m_atlasSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_atlasSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_atlasSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glSamplerParameteri(m_atlasSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	UploadAtlas();
 
 	glGenVertexArrays(1, &m_vao);
 	glBindVertexArray(m_vao);
 	m_vbo.Create();
 	m_vbo.Bind();
-
-	for (int i = 0; i < 128; i++)
-		CreateChar(i, textureType);
-	m_isLoaded = true;
-
-	FT_Done_Face(m_ftFace);
-	FT_Done_FreeType(m_ftLib);
-	
-	m_vbo.UploadDataToGPU(GL_STATIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2)*2, 0);
 	glEnableVertexAttribArray(1);
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2)*2, (void*)(sizeof(glm::vec2)));
+
+	m_isLoaded = true;
 	return true;
 }
 
+// Uploads the parts of the atlas that changed, or all of it when it has grown
+void CFreeTypeFont::UploadAtlas()
+{
+	if (!m_glyphCache.IsAtlasResized() && m_glyphCache.GetDirtyRegions().empty())
+		return;
+
+	const unsigned char *pixels = m_glyphCache.GetAtlasPixels();
+	int atlasWidth = m_glyphCache.GetAtlasWidth();
+
+	glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (m_glyphCache.IsAtlasResized()) {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth, m_glyphCache.GetAtlasHeight(), 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+	} else {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, atlasWidth);
+		for (const glm::ivec4 &region : m_glyphCache.GetDirtyRegions()) {
+			glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.z, region.w, GL_RED, GL_UNSIGNED_BYTE,
+			                pixels + region.x + region.y * atlasWidth);
+		}
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	m_glyphCache.ClearDirty();
+}
+
 // Prints text at the specified location (x, y) with the given pixel size (iPXSize)
 void CFreeTypeFont::Print(CShaderProgram* program, std::string text, int x, int y, int pixelSize)
 {
 	if(!m_isLoaded)
 		return;
 
-	glBindVertexArray(m_vao);
-    
-	int iCurX = x, iCurY = y;
 	if (pixelSize == -1)
 		pixelSize = m_loadedPixelSize;
-	float fScale = float(pixelSize) / float(m_loadedPixelSize);
-	for (int i = 0; i < (int) text.size(); i++) {
-		if (text[i] == '\n')
-		{
-			iCurX = x;
-			iCurY -= m_newLine*pixelSize / m_loadedPixelSize;
-			continue;
-		}
-		int iIndex = int(text[i]);
-		iCurX += m_bearingX[iIndex] * pixelSize / m_loadedPixelSize;
-		if(text[i] != ' ')
-		{
-			m_charTextures[iIndex].BindTexture2DToTextureType();
-			glm::mat4 mModelView = glm::translate(glm::mat4(1.0f), glm::vec3(float(iCurX), float(iCurY), 0.0f));
-			mModelView = glm::scale(mModelView, glm::vec3(fScale));
-			program->SetUniform("matrices.modelViewMatrix", mModelView);
-			// Draw character
-			glDrawArrays(GL_TRIANGLE_STRIP, iIndex * 4, 4);
-		}
 
-		iCurX += (m_advX[iIndex] - m_bearingX[iIndex])*pixelSize / m_loadedPixelSize;
+	// Take in the glyphs the worker has finished since the last frame, new ones are requested by the layout
+	m_glyphCache.Update();
+	UploadAtlas();
+
+	m_quads.clear();
+	m_glyphCache.Layout(text, float(x), float(y), float(pixelSize), m_quads);
+	if (m_quads.empty())
+		return;
+
+	// Two triangles per glyph, all glyphs in one draw
+	m_vertices.resize(m_quads.size() * 12);
+	glm::vec2 *vertex = m_vertices.data();
+	for (const SGlyphQuad &quad : m_quads) {
+		const glm::vec2 corners[6][2] = {
+			{ quad.min, quad.uvMin },
+			{ glm::vec2(quad.max.x, quad.min.y), glm::vec2(quad.uvMax.x, quad.uvMin.y) },
+			{ quad.max, quad.uvMax },
+			{ quad.min, quad.uvMin },
+			{ quad.max, quad.uvMax },
+			{ glm::vec2(quad.min.x, quad.max.y), glm::vec2(quad.uvMin.x, quad.uvMax.y) }
+		};
+		for (int i = 0; i < 6; i++) {
+			*vertex++ = corners[i][0];
+			*vertex++ = corners[i][1];
+		}
 	}
+
+	glBindVertexArray(m_vao);
+	m_vbo.Bind();
+	m_vbo.UploadStreamingDataToGPU(m_vertices.data(), m_vertices.size() * sizeof(glm::vec2));
+
+	GLint iTextureUnit = static_cast<GLint>(m_textureType);
+	glActiveTexture(GL_TEXTURE0 + iTextureUnit);
+	glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+	glBindSampler(iTextureUnit, m_atlasSampler);
+
+	program->SetUniform("matrices.modelViewMatrix", glm::mat4(1.0f));
+	program->SetUniform("bUseDistanceField", true);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(m_quads.size() * 6));
+	program->SetUniform("bUseDistanceField", false);
 }
 
 
@@ -154,30 +135,36 @@ void CFreeTypeFont::Render(CShaderProgram* program, int x, int y, int pixelSize,
     char buf[512];
     va_list ap;
     va_start(ap, text);
-    vsprintf(buf, text, ap);
+    vsnprintf(buf, sizeof(buf), text, ap);
     va_end(ap);
     Print(program, buf, x, y, pixelSize);
 }
 
-// Deletes all font textures
+// Deletes the font atlas and the glyph cache
 void CFreeTypeFont::Release()
 {
-    for (int i = 0; i < 128; i++)
-        m_charTextures[i].Release();
-    m_vbo.Release();
-    glDeleteVertexArrays(1, &m_vao);
+    if (m_atlasTexture != 0) {
+        glDeleteTextures(1, &m_atlasTexture);
+        glDeleteSamplers(1, &m_atlasSampler);
+        m_atlasTexture = m_atlasSampler = 0;
+    }
+    if (m_vao != 0) {
+        m_vbo.Release();
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    m_glyphCache.Release();
+    m_isLoaded = false;
 }
 
 // Gets the width of text
 int CFreeTypeFont::GetTextWidth(std::string sText, int iPixelSize)
 {
-    int iResult = 0;
-    for (int i = 0; i < (int)sText.size(); i++)
-        iResult += m_advX[sText[i]];
-    return iResult*iPixelSize / m_loadedPixelSize;
+    return (int)m_glyphCache.GetTextWidth(sText, float(iPixelSize));
 }
 
-// Gets the height of text
+// Gets the height of text, every line break adds the line height of the font
 int CFreeTypeFont::GetTextHeight(std::string sText) {
-    return m_loadedPixelSize;
+    int lineBreaks = (int)std::count(sText.begin(), sText.end(), '\n');
+    return m_loadedPixelSize + (int)(lineBreaks * m_glyphCache.GetLineHeight(float(m_loadedPixelSize)));
 }
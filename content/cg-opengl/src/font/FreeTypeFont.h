@@ -4,9 +4,12 @@
 #define FreeTypeFont_h
 
 #include "../FontBase.h"
+#include "GlyphCache.h"
 
 
-// This class is a wrapper for FreeType fonts and their usage with OpenGL
+// This class is a wrapper for FreeType fonts and their usage with OpenGL.
+// Glyphs come from a CGlyphCache as signed distance fields in one atlas
+// texture, so any Unicode text at any size is drawn with a single call.
 class CFreeTypeFont
 {
 public:
@@ -17,38 +20,28 @@ public:
 
     int GetTextWidth(std::string text, int pixelSize);
     int GetTextHeight(std::string sText);
-    
+
+    // text is UTF-8
     void Print(CShaderProgram* program, std::string text, int x, int y, int pixelSize = -1);
     void Render(CShaderProgram* program, int x, int y, int pixelSize, char* text, ...);
     void Release();
 
 private:
 
-	void CreateChar(int index, const TextureType &textureType);
+	void UploadAtlas();
 
-	CTexture m_charTextures[256];
-	int m_advX[256], m_advY[256];
-	int m_bearingX[256], m_bearingY[256];
-	int m_charWidth[256], m_charHeight[256];
-	int m_loadedPixelSize, m_newLine;
+	CGlyphCache m_glyphCache;
+	int m_loadedPixelSize;
+	TextureType m_textureType;
 
     bool m_isLoaded;
+	GLuint m_atlasTexture, m_atlasSampler;
 	GLuint m_vao;
 	CVertexBufferObject m_vbo;
 
-	FT_Library m_ftLib;
-	FT_Face m_ftFace;
-
-
-    // Second way of loading font
-    struct Character {
-        GLuint   TextureID;    // ID handle of the glyph texture
-        glm::ivec2 Size;       // Size of glyph
-        glm::ivec2 Bearing;    // Offset from baseline to left/top of glyph
-        GLuint     Advance;    // Offset to advance to next glyph
-    };
-
-    std::map<GLchar, Character> Characters;
+	// reused every Print so laying out text does not allocate
+	std::vector<SGlyphQuad> m_quads;
+	std::vector<glm::vec2> m_vertices;
 };
 
 #endif /* FreeTypeFont_h */
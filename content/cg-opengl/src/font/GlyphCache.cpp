@@ -0,0 +1,386 @@
+#include "GlyphCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const int ATLAS_INITIAL_SIZE = 256;
+    const int ATLAS_MAX_SIZE = 8192;
+    const int ATLAS_PADDING = 1;
+    const float DISTANCE_INFINITY = 1e20f;
+
+    // Exact squared euclidean distance transform of a sampled function in one dimension
+    // (Felzenszwalb & Huttenlocher), the lower envelope of the parabolas rooted at every sample.
+    void DistanceTransform1D(const float *f, const int &n, float *d, int *v, float *z)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -DISTANCE_INFINITY;
+        z[1] = DISTANCE_INFINITY;
+        for (int q = 1; q < n; ++q) {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            while (s <= z[k]) {
+                --k;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = DISTANCE_INFINITY;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q) {
+            while (z[k + 1] < q) {
+                ++k;
+            }
+            d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+        }
+    }
+
+    // squared distance of every pixel to the nearest seed pixel, seeds hold 0 and the rest DISTANCE_INFINITY
+    void DistanceTransform2D(std::vector<float> &grid, const int &width, const int &height)
+    {
+        int n = std::max(width, height);
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+
+        for (int x = 0; x < width; ++x) {
+            for (int y = 0; y < height; ++y) f[y] = grid[x + y * width];
+            DistanceTransform1D(f.data(), height, d.data(), v.data(), z.data());
+            for (int y = 0; y < height; ++y) grid[x + y * width] = d[y];
+        }
+        for (int y = 0; y < height; ++y) {
+            DistanceTransform1D(&grid[y * width], width, d.data(), v.data(), z.data());
+            memcpy(&grid[y * width], d.data(), width * sizeof(float));
+        }
+    }
+}
+
+CGlyphCache::CGlyphCache():
+    m_ftLib(nullptr), m_ftFace(nullptr), m_basePixelSize(48), m_spread(6), m_lineHeight(0.0f), m_pendingAdvance(0.0f),
+    m_atlasWidth(0), m_atlasHeight(0), m_shelfX(0), m_shelfY(0), m_shelfHeight(0), m_atlasResized(false),
+    m_worker(1)
+{
+    std::fill(m_latinIndex, m_latinIndex + 256, -1);
+}
+
+CGlyphCache::~CGlyphCache()
+{
+    Release();
+}
+
+bool CGlyphCache::Load(const std::string &file, const int &basePixelSize, const int &spread)
+{
+    Release();
+
+    if (FT_Init_FreeType(&m_ftLib) != 0) {
+        m_ftLib = nullptr;
+        return false;
+    }
+    if (FT_New_Face(m_ftLib, file.c_str(), 0, &m_ftFace) != 0) {
+        std::cout << "ERROR::FREETYPE: Failed to load font " << file << std::endl;
+        m_ftFace = nullptr;
+        Release();
+        return false;
+    }
+
+    m_basePixelSize = basePixelSize;
+    m_spread = spread;
+    FT_Select_Charmap(m_ftFace, FT_ENCODING_UNICODE);
+    FT_Set_Pixel_Sizes(m_ftFace, 0, m_basePixelSize);
+    m_lineHeight = float(m_ftFace->size->metrics.height >> 6);
+    // until a glyph is rasterized its advance is estimated, so that text does not collapse
+    m_pendingAdvance = 0.5f * m_basePixelSize;
+
+    m_atlasWidth = m_atlasHeight = ATLAS_INITIAL_SIZE;
+    m_atlas.assign(m_atlasWidth * m_atlasHeight, 0);
+    m_shelfX = m_shelfY = m_shelfHeight = 0;
+    m_atlasResized = true;
+    m_dirtyRegions.clear();
+    return true;
+}
+
+void CGlyphCache::Release()
+{
+    // the worker may still be using the face
+    m_worker.WaitIdle();
+    m_finished.clear();
+
+    if (m_ftFace != nullptr) {
+        FT_Done_Face(m_ftFace);
+        m_ftFace = nullptr;
+    }
+    if (m_ftLib != nullptr) {
+        FT_Done_FreeType(m_ftLib);
+        m_ftLib = nullptr;
+    }
+
+    m_glyphs.clear();
+    m_glyphIndex.clear();
+    std::fill(m_latinIndex, m_latinIndex + 256, -1);
+    m_atlas.clear();
+    m_atlasWidth = m_atlasHeight = 0;
+    m_dirtyRegions.clear();
+    m_atlasResized = false;
+}
+
+unsigned int CGlyphCache::DecodeUtf8(const std::string &text, size_t &i)
+{
+    const unsigned int replacement = 0xFFFD;
+    unsigned char c = (unsigned char)text[i++];
+    if (c < 0x80) {
+        return c;
+    }
+
+    int length;
+    unsigned int codepoint;
+    if ((c & 0xE0) == 0xC0) {
+        length = 1; codepoint = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        length = 2; codepoint = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        length = 3; codepoint = c & 0x07;
+    } else {
+        return replacement;
+    }
+
+    for (int k = 0; k < length; ++k) {
+        if (i >= text.size() || ((unsigned char)text[i] & 0xC0) != 0x80) {
+            return replacement;
+        }
+        codepoint = (codepoint << 6) | ((unsigned char)text[i++] & 0x3F);
+    }
+    return codepoint <= 0x10FFFF ? codepoint : replacement;
+}
+
+const SGlyph &CGlyphCache::Request(const unsigned int &codepoint)
+{
+    if (codepoint < 256 && m_latinIndex[codepoint] >= 0) {
+        return m_glyphs[m_latinIndex[codepoint]];
+    }
+    if (codepoint >= 256) {
+        auto it = m_glyphIndex.find(codepoint);
+        if (it != m_glyphIndex.end()) {
+            return m_glyphs[it->second];
+        }
+    }
+
+    // first use: register a placeholder and rasterize on the worker
+    unsigned int index = (unsigned int)m_glyphs.size();
+    SGlyph glyph;
+    glyph.atlasPosition = glm::ivec2(0);
+    glyph.size = glm::ivec2(0);
+    glyph.bearing = glm::vec2(0.0f);
+    glyph.advance = m_pendingAdvance;
+    glyph.ready = false;
+    m_glyphs.push_back(glyph);
+    if (codepoint < 256) {
+        m_latinIndex[codepoint] = (int)index;
+    } else {
+        m_glyphIndex[codepoint] = index;
+    }
+
+    if (m_ftFace != nullptr) {
+        m_worker.Enqueue([this, index, codepoint]() { Rasterize(index, codepoint); });
+    }
+    return m_glyphs[index];
+}
+
+// Runs on the worker thread
+void CGlyphCache::Rasterize(const unsigned int &index, const unsigned int &codepoint)
+{
+    SRasterizedGlyph result;
+    result.index = index;
+    result.width = result.height = 0;
+    result.bearing = glm::vec2(0.0f);
+    result.advance = 0.0f;
+
+    if (FT_Load_Char(m_ftFace, codepoint, FT_LOAD_RENDER) == 0) {
+        FT_GlyphSlot slot = m_ftFace->glyph;
+        const FT_Bitmap &bitmap = slot->bitmap;
+        result.advance = float(slot->advance.x >> 6);
+
+        if (bitmap.width > 0 && bitmap.rows > 0) {
+            // the field extends spread pixels beyond the outline on every side
+            const int w = (int)bitmap.width + 2 * m_spread;
+            const int h = (int)bitmap.rows + 2 * m_spread;
+            result.width = w;
+            result.height = h;
+            result.bearing = glm::vec2(float(slot->bitmap_left - m_spread), float(slot->bitmap_top + m_spread));
+
+            // distance to the nearest inside pixel for the outside and vice versa
+            std::vector<float> toInside(w * h, DISTANCE_INFINITY), toOutside(w * h, 0.0f);
+            for (int y = 0; y < (int)bitmap.rows; ++y) {
+                const unsigned char *row = bitmap.buffer + y * bitmap.pitch;
+                for (int x = 0; x < (int)bitmap.width; ++x) {
+                    if (row[x] >= 128) {
+                        int i = (x + m_spread) + (y + m_spread) * w;
+                        toInside[i] = 0.0f;
+                        toOutside[i] = DISTANCE_INFINITY;
+                    }
+                }
+            }
+            DistanceTransform2D(toInside, w, h);
+            DistanceTransform2D(toOutside, w, h);
+
+            // 0.5 is the outline, one spread inside maps to 1 and one spread outside to 0;
+            // half a pixel moves the outline from the pixel centres to the pixel edges
+            result.pixels.resize(w * h);
+            const float scale = 0.5f / m_spread;
+            for (int i = 0; i < w * h; ++i) {
+                float distance = toInside[i] == 0.0f ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+                float value = std::min(std::max(0.5f + distance * scale, 0.0f), 1.0f);
+                result.pixels[i] = (unsigned char)(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    m_finished.push_back(std::move(result));
+}
+
+bool CGlyphCache::Pack(const int &width, const int &height, glm::ivec2 &position)
+{
+    if (m_shelfX + width + ATLAS_PADDING > m_atlasWidth) {
+        // start a new shelf below the current one
+        m_shelfY += m_shelfHeight + ATLAS_PADDING;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+    if (m_shelfY + height + ATLAS_PADDING > m_atlasHeight || width + ATLAS_PADDING > m_atlasWidth) {
+        return false;
+    }
+
+    position = glm::ivec2(m_shelfX + ATLAS_PADDING, m_shelfY + ATLAS_PADDING);
+    m_shelfX += width + ATLAS_PADDING;
+    m_shelfHeight = std::max(m_shelfHeight, height);
+    return true;
+}
+
+void CGlyphCache::GrowAtlas()
+{
+    // keep the atlas close to square, the shelves simply continue in the new space
+    int width = m_atlasWidth, height = m_atlasHeight;
+    if (width <= height) {
+        width *= 2;
+    } else {
+        height *= 2;
+    }
+
+    std::vector<unsigned char> atlas(width * height, 0);
+    for (int y = 0; y < m_atlasHeight; ++y) {
+        memcpy(&atlas[y * width], &m_atlas[y * m_atlasWidth], m_atlasWidth);
+    }
+    m_atlas.swap(atlas);
+    m_atlasWidth = width;
+    m_atlasHeight = height;
+
+    // everything is uploaded again anyway
+    m_atlasResized = true;
+    m_dirtyRegions.clear();
+}
+
+bool CGlyphCache::Update()
+{
+    std::vector<SRasterizedGlyph> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        finished.swap(m_finished);
+    }
+
+    bool changed = false;
+    for (SRasterizedGlyph &result : finished) {
+        SGlyph &glyph = m_glyphs[result.index];
+        glyph.advance = result.advance;
+        glyph.bearing = result.bearing;
+        glyph.size = glm::ivec2(result.width, result.height);
+        glyph.ready = true;
+
+        if (result.width == 0 || result.height == 0) {
+            continue;
+        }
+
+        glm::ivec2 position;
+        while (!Pack(result.width, result.height, position)) {
+            if (std::max(m_atlasWidth, m_atlasHeight) >= ATLAS_MAX_SIZE) {
+                // out of space: the glyph keeps its advance but is not drawn
+                glyph.size = glm::ivec2(0);
+                break;
+            }
+            GrowAtlas();
+        }
+        if (glyph.size.x == 0) {
+            continue;
+        }
+
+        glyph.atlasPosition = position;
+        for (int y = 0; y < result.height; ++y) {
+            memcpy(&m_atlas[position.x + (position.y + y) * m_atlasWidth], &result.pixels[y * result.width], result.width);
+        }
+        if (!m_atlasResized) {
+            m_dirtyRegions.push_back(glm::ivec4(position.x, position.y, result.width, result.height));
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+void CGlyphCache::Flush()
+{
+    m_worker.WaitIdle();
+    Update();
+}
+
+void CGlyphCache::ClearDirty()
+{
+    m_atlasResized = false;
+    m_dirtyRegions.clear();
+}
+
+float CGlyphCache::Layout(const std::string &text, const float &x, const float &y, const float &pixelSize, std::vector<SGlyphQuad> &quads)
+{
+    const float scale = pixelSize / m_basePixelSize;
+    const glm::vec2 texel(1.0f / std::max(m_atlasWidth, 1), 1.0f / std::max(m_atlasHeight, 1));
+    glm::vec2 pen(x, y);
+
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned int codepoint = DecodeUtf8(text, i);
+        if (codepoint == '\n') {
+            pen = glm::vec2(x, pen.y - GetLineHeight(pixelSize));
+            continue;
+        }
+
+        const SGlyph &glyph = Request(codepoint);
+        if (glyph.ready && glyph.size.x > 0) {
+            SGlyphQuad quad;
+            quad.min = glm::vec2(pen.x + glyph.bearing.x * scale, pen.y + (glyph.bearing.y - glyph.size.y) * scale);
+            quad.max = glm::vec2(pen.x + (glyph.bearing.x + glyph.size.x) * scale, pen.y + glyph.bearing.y * scale);
+            // atlas rows run top down, like the FreeType bitmaps
+            quad.uvMin = glm::vec2(glyph.atlasPosition.x, glyph.atlasPosition.y + glyph.size.y) * texel;
+            quad.uvMax = glm::vec2(glyph.atlasPosition.x + glyph.size.x, glyph.atlasPosition.y) * texel;
+            quads.push_back(quad);
+        }
+        pen.x += glyph.advance * scale;
+    }
+    return pen.x;
+}
+
+float CGlyphCache::GetTextWidth(const std::string &text, const float &pixelSize)
+{
+    float width = 0.0f, lineWidth = 0.0f;
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned int codepoint = DecodeUtf8(text, i);
+        if (codepoint == '\n') {
+            width = std::max(width, lineWidth);
+            lineWidth = 0.0f;
+            continue;
+        }
+        lineWidth += Request(codepoint).advance;
+    }
+    return std::max(width, lineWidth) * pixelSize / m_basePixelSize;
+}
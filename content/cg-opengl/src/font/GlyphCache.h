@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef GlyphCache_h
+#define GlyphCache_h
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "../utilities/ThreadPool.h"
+
+struct SGlyph
+{
+    glm::ivec2 atlasPosition;   // top left corner in the atlas
+    glm::ivec2 size;            // size in the atlas, including the distance field spread
+    glm::vec2 bearing;          // from the pen position to the top left corner, y up
+    float advance;
+    bool ready;                 // false while the glyph is still being rasterized
+};
+
+// one glyph of laid out text, positions in pixels (y up) and atlas texture coordinates
+struct SGlyphQuad
+{
+    glm::vec2 min, max;
+    glm::vec2 uvMin, uvMax;
+};
+
+// Caches the glyphs of one font as signed distance fields in a single
+// 8 bit atlas. Any Unicode code point is rasterized the first time it is
+// requested, on a worker thread that owns the FreeType face, so drawing
+// text never waits for FreeType; the glyph simply shows up a frame later.
+// Distance fields are resolution independent, so glyphs rasterized once at
+// the base size serve every text size. The atlas starts small, grows when
+// full and records the regions that changed so only those are uploaded.
+// This class never calls OpenGL.
+class CGlyphCache
+{
+public:
+    CGlyphCache();
+    ~CGlyphCache();
+
+    ///basePixelSize is the size glyphs are rasterized at, spread the distance in pixels the field covers around the outline.
+    bool Load(const std::string &file, const int &basePixelSize = 48, const int &spread = 6);
+    void Release();
+
+    ///Returns the glyph of a code point, which is not ready yet when it had to be queued for rasterization.
+    const SGlyph &Request(const unsigned int &codepoint);
+
+    ///Packs the glyphs the worker has finished into the atlas. Returns true when the atlas changed.
+    bool Update();
+
+    ///Blocks until every requested glyph is rasterized, then packs them.
+    void Flush();
+
+    ///Lays out UTF-8 text with the pen starting at (x, y), appending a quad per visible glyph. Returns the final pen x.
+    float Layout(const std::string &text, const float &x, const float &y, const float &pixelSize, std::vector<SGlyphQuad> &quads);
+    float GetTextWidth(const std::string &text, const float &pixelSize);
+    float GetLineHeight(const float &pixelSize) const { return m_lineHeight * pixelSize / m_basePixelSize; }
+
+    ///Decodes the code point starting at text[i] and moves i past it, invalid sequences decode to U+FFFD.
+    static unsigned int DecodeUtf8(const std::string &text, size_t &i);
+
+    const unsigned char *GetAtlasPixels() const { return m_atlas.data(); }
+    int GetAtlasWidth() const { return m_atlasWidth; }
+    int GetAtlasHeight() const { return m_atlasHeight; }
+    int GetSpread() const { return m_spread; }
+    int GetBasePixelSize() const { return m_basePixelSize; }
+    size_t GetGlyphCount() const { return m_glyphs.size(); }
+
+    ///True when the atlas was reallocated since the last ClearDirty and has to be uploaded completely.
+    bool IsAtlasResized() const { return m_atlasResized; }
+    ///Regions (x, y, width, height) written since the last ClearDirty.
+    const std::vector<glm::ivec4> &GetDirtyRegions() const { return m_dirtyRegions; }
+    void ClearDirty();
+
+private:
+    struct SRasterizedGlyph
+    {
+        unsigned int index;
+        int width, height;
+        glm::vec2 bearing;
+        float advance;
+        std::vector<unsigned char> pixels;
+    };
+
+    void Rasterize(const unsigned int &index, const unsigned int &codepoint);
+    bool Pack(const int &width, const int &height, glm::ivec2 &position);
+    void GrowAtlas();
+
+    FT_Library m_ftLib;
+    FT_Face m_ftFace;
+    int m_basePixelSize, m_spread;
+    float m_lineHeight, m_pendingAdvance;
+
+    // glyphs by code point, Latin-1 also through a direct table for the common case
+    std::vector<SGlyph> m_glyphs;
+    std::unordered_map<unsigned int, unsigned int> m_glyphIndex;
+    int m_latinIndex[256];
+
+    // atlas packed in shelves: rows of glyphs as high as the tallest glyph in the row
+    std::vector<unsigned char> m_atlas;
+    int m_atlasWidth, m_atlasHeight;
+    int m_shelfX, m_shelfY, m_shelfHeight;
+    bool m_atlasResized;
+    std::vector<glm::ivec4> m_dirtyRegions;
+
+    // FreeType is only used by the single worker after Load
+    CThreadPool m_worker;
+    std::mutex m_finishedMutex;
+    std::vector<SRasterizedGlyph> m_finished;
+};
+
+#endif /* GlyphCache_h */
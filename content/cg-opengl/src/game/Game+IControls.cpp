@@ -194,6 +194,10 @@ void Game::LoadControls() {
     useTerrain->SetValue(&m_useTerrain);
     guiBox->y += guiBox->height;
     
+    CButton * showVoxelWorld = (CButton *)AddControl(new CButton("Show Voxels", guiBox));
+    showVoxelWorld->SetValue(&m_showVoxelWorld);
+    guiBox->y += guiBox->height;
+    
     /// Post Processing Effects Selection
     guiBox->width -= 100;
     CButton * previousPPFX = (CButton *)AddControl(new CButton("Prev", guiBox));
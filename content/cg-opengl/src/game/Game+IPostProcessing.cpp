@@ -7,6 +7,7 @@
 //
 
 #include "Game.h"
+#include "../buffers/PostProcessingGraph.h"
 
 /// initialise frame buffer elements
 void Game::InitialiseFrameBuffers(const GLuint &width , const GLuint &height) {
@@ -112,38 +113,48 @@ void Game::InitialiseFrameBuffers(const GLuint &width , const GLuint &height) {
     m_ffaaOffset = 50.0f;
     
     
-    // framebuffers
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
-    m_pFBOs.push_back(new CFrameBufferObject);
+    // framebuffer slots, LoadFrameBuffers points them into the frame buffers of the current effect
+    m_pFBOs.assign(CPostProcessingGraph::SLOT_COUNT, nullptr);
+    currentFBO = nullptr;
 }
 
 /// create frame buffers
 void Game::LoadFrameBuffers(const GLuint &width , const GLuint &height) {
 
-    m_pFBOs[0]->CreateFramebuffer(width, height, FrameBufferType::Default);
-    m_pFBOs[1]->CreateFramebuffer(width, height, FrameBufferType::DeferredRendering);
-    m_pFBOs[2]->CreateFramebuffer(width, height, FrameBufferType::PingPongRendering);
-    m_pFBOs[3]->CreateFramebuffer(width, height, FrameBufferType::DepthMapping);
-    m_pFBOs[4]->CreateFramebuffer(width, height, FrameBufferType::Default);
-    m_pFBOs[5]->CreateFramebuffer(width, height, FrameBufferType::SSAO);
-    m_pFBOs[6]->CreateFramebuffer(width, height, FrameBufferType::SSAO);
-    m_pFBOs[7]->CreateFramebuffer(width, height, FrameBufferType::DirectionalShadowMapping);
-    m_pFBOs[8]->CreateFramebuffer(width, height, FrameBufferType::OmnidirectionalShadowMapping);
-    m_pFBOs[9]->CreateFramebuffer(width, height, FrameBufferType::HighDynamicRangeRendering);
-    m_pFBOs[10]->CreateFramebuffer(width, height, FrameBufferType::HighDynamicRangeLighting);
-    m_pFBOs[11]->CreateFramebuffer(width, height, FrameBufferType::GeometryBuffer);
+    // compile the render graph of the current effect, so only the slots it draws into get a frame buffer
+    // and slots whose lifetimes do not overlap share one. The slots of other effects stay null.
+    std::vector<GLint> slotTargets;
+    m_ppfxGraph.Clear();
+    CPostProcessingGraph::Declare(m_currentPPFXMode, width, height, SHADOW_WIDTH, m_ppfxGraph, slotTargets);
+    m_ppfxGraph.Compile();
+    
+    for (GLuint i = 0; i < m_ppfxGraph.GetPhysicalTargetCount(); i++) {
+        CFrameBufferObject *pFBO = new CFrameBufferObject;
+        pFBO->CreateFramebuffer(width, height, m_ppfxGraph.GetPhysicalTargetDesc(i).type);
+        m_pFBOPool.push_back(pFBO);
+    }
+    for (GLuint slot = 0; slot < m_pFBOs.size(); slot++) {
+        GLint physical = m_ppfxGraph.GetPhysicalTarget(slotTargets[slot]);
+        m_pFBOs[slot] = physical >= 0 ? m_pFBOPool[physical] : nullptr;
+    }
+    
+    const SRenderGraphStats &stats = m_ppfxGraph.GetStats();
+    std::cout << PostProcessingEffectToString(m_currentPPFXMode) << ": "
+              << stats.physicalTargets << "/" << stats.declaredTargets << " frame buffers, "
+              << stats.allocatedBytes / (1024 * 1024) << "/" << stats.declaredBytes / (1024 * 1024) << " MB, "
+              << stats.targetBinds << " binds per frame" << std::endl;
 }
 
+/// delete the frame buffers of the current effect
+void Game::ReleaseFrameBuffers() {
+    for (GLuint i = 0; i < m_pFBOPool.size(); i++) {
+        m_pFBOPool[i]->Release();
+        delete m_pFBOPool[i];
+    }
+    m_pFBOPool.clear();
+    std::fill(m_pFBOs.begin(), m_pFBOs.end(), nullptr);
+    currentFBO = nullptr;
+}
 
 void Game::ChangePPFXScene(PostProcessingEffectMode &mode) {
     if (m_prevPPFXMode) {
@@ -178,11 +189,7 @@ void Game::BindPPFXFBO(const PostProcessingEffectMode &mode) {
         const GLint width = m_gameWindow->GetWidth();
         const GLint height = m_gameWindow->GetHeight();
         
-        for (GLuint i = 0; i < m_pFBOs.size(); i++) {
-            m_pFBOs[i]->Release();
-        }
-        
-        currentFBO->Release();
+        ReleaseFrameBuffers();
         
         LoadFrameBuffers(width, height);
         
@@ -903,8 +910,13 @@ void Game::RenderPPFXScene(const PostProcessingEffectMode &mode) {
                 
             }
             
-            // Blit to default frame buffer
-            currentFBO->BlitToDepthBuffer(0);
+            // Blit the geometry depth to the default frame buffer, the lamps pass is merged with the
+            // lighting pass so the screen is still bound for drawing and only the read side is bound
+            if (m_ppfxGraph.IsPassMerged(m_ppfxGraph.FindPass("lamps"))) {
+                currentFBO->BlitDepthToDrawBuffer();
+            } else {
+                currentFBO->BlitToDepthBuffer(0);
+            }
             
             {
                 /// Render Lamps
@@ -1379,24 +1391,6 @@ const char * const Game::PostProcessingEffectToString(const PostProcessingEffect
 }
 
 FrameBufferType Game::GetFBOtype(const PostProcessingEffectMode &mode){
-    
-    switch(mode) {
-        case PostProcessingEffectMode::GaussianBlur:
-            return FrameBufferType::HighDynamicRangeRendering;
-        case PostProcessingEffectMode::BrightParts:
-            return FrameBufferType::HighDynamicRangeRendering;
-        case PostProcessingEffectMode::Bloom:
-            return FrameBufferType::HighDynamicRangeRendering;
-        case PostProcessingEffectMode::HDRToneMapping:
-            return FrameBufferType::HighDynamicRangeLighting;
-        case PostProcessingEffectMode::LensFlare:
-            return FrameBufferType::HighDynamicRangeRendering;
-        case PostProcessingEffectMode::DeferredRendering:
-            return FrameBufferType::DeferredRendering;
-        case PostProcessingEffectMode::SSAO:
-            return FrameBufferType::GeometryBuffer;
-        default:
-            return FrameBufferType::Default;
-    }
+    return CPostProcessingGraph::GetSceneType(mode);
 }
 
@@ -322,6 +322,25 @@ void Game::RenderScene(const GLboolean &toCustomShader, const GLboolean &include
     }
     
     RenderTerrainScene(pShaderProgram, -100.0f);
+    
+    // the voxel world has its own shader, so custom shader passes (shadow depth maps and
+    // the effects that light the scene themselves) leave it out
+    if (m_showVoxelWorld && !toCustomShader) {
+        /// Voxel World
+        
+        CShaderProgram *pVoxelProgram = (*m_pShaderPrograms)[87];
+        pVoxelProgram->UseProgram();
+        pVoxelProgram->SetUniform("matrices.projMatrix", m_pCamera->GetPerspectiveProjectionMatrix());
+        pVoxelProgram->SetUniform("matrices.viewMatrix", m_pCamera->GetViewMatrix());
+        pVoxelProgram->SetUniform("lightDirection", -m_directionalLightDirection);
+        
+        glm::mat4 model = m_pVoxelTerrain->Model();
+        pVoxelProgram->SetUniform("matrices.modelMatrix", model);
+        pVoxelProgram->SetUniform("matrices.normalMatrix", m_pCamera->ComputeNormalMatrix(model));
+        m_pVoxelTerrain->Render();
+        pShaderProgram->UseProgram();
+    }
+    
     RenderPBRScene(pShaderProgram, toCustomShader, toCustomShaderIndex, zfront, zback);
     //RenderRandomScene(pShaderProgram, toCustomShader, toCustomShaderIndex, zfront-200, zback+200);
     
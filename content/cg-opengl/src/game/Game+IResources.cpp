@@ -25,6 +25,7 @@ void Game::InitialiseResources()
     m_pIrrSkybox = new CSkybox;
     m_pPlanarTerrain = new CPlane;
     m_pHeightmapTerrain = new CHeightMapTerrain;
+    m_pVoxelTerrain = new CVoxelTerrain;
     
     m_teapot1 = new CModel;
     m_teapot2 = new CModel;
@@ -103,6 +104,12 @@ void Game::LoadResources(const std::string &path)
                                 m_mapSize,
                                 200.0f);
     
+    // Create the voxel world, 16 x 4 x 16 chunks of 32^3 blocks meshed over the first frames
+    m_pVoxelTerrain->Create(16, 4, 16, 7);
+    // one block per unit with the world centred under the scene, below the terrain
+    const GLfloat halfWidth = 0.5f * m_pVoxelTerrain->GetWorld().GetChunksX() * CVoxelChunk::SIZE;
+    m_pVoxelTerrain->Transform(glm::vec3(-halfWidth, -164.0f, -halfWidth));
+    
     m_pLamp->Create("", {} );
     m_pWoodenBox->Create(path+"/textures/pbr/woodenbox/",
                          {
@@ -401,7 +408,7 @@ void Game::LoadResources(const std::string &path)
     
     m_pSpherePBR12->Create("", {}, 50, 50);
     m_pCube12->Create("", { });
-    m_pMetaballs->Create(100.0f, 10, 0, 32, path+"/textures/pbr/metalpainted/",
+    m_pMetaballs->Create(100.0f, 10, 50, path+"/textures/pbr/metalpainted/",
                          {   { "albedo.jpg", TextureType::ALBEDO },           // albedo map
                              { "metallic.jpg",  TextureType::METALNESS },           // metallic map
                              { "roughness.jpg",   TextureType::ROUGHNESS},         // roughness map
@@ -411,7 +418,6 @@ void Game::LoadResources(const std::string &path)
                              { "diffuse.jpg",   TextureType::DIFFUSE},
                              { "specular.jpg",   TextureType::SPECULAR}
                          }); {
-                             m_pMetaballs->SetGridSize(50);
                              CMarchingCubes::BuildTables();
                          }
     
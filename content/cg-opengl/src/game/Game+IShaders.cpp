@@ -192,6 +192,8 @@ void Game::LoadShaderPrograms(const std::string &path) {
     sShaderFileNames.push_back("OmnidirectionalShadowDepthShader.frag");
     sShaderFileNames.push_back("OmnidirectionalShadowMappingShader.vert");// 86
     sShaderFileNames.push_back("OmnidirectionalShadowMappingShader.frag");
+    sShaderFileNames.push_back("VoxelShader.vert");// 87
+    sShaderFileNames.push_back("VoxelShader.frag");
     
     
     for (int i = 0; i < (int) sShaderFileNames.size(); i++) {
@@ -909,6 +911,14 @@ void Game::LoadShaderPrograms(const std::string &path) {
     pOmnidirectionalShadowMappingProgram->AddShaderToProgram(&shShaders[178]);
     pOmnidirectionalShadowMappingProgram->LinkProgram();
     m_pShaderPrograms->push_back(pOmnidirectionalShadowMappingProgram);
+    
+    // Voxel World Shader
+    CShaderProgram *pVoxelProgram = new CShaderProgram;
+    pVoxelProgram->CreateProgram();
+    pVoxelProgram->AddShaderToProgram(&shShaders[179]);
+    pVoxelProgram->AddShaderToProgram(&shShaders[180]);
+    pVoxelProgram->LinkProgram();
+    m_pShaderPrograms->push_back(pVoxelProgram);
 }
 
 
@@ -124,6 +124,8 @@ Game::Game()
     m_useTerrain = true;
     m_pPlanarTerrain = nullptr;
     m_pHeightmapTerrain = nullptr;
+    m_showVoxelWorld = false;
+    m_pVoxelTerrain = nullptr;
     m_heightMapMinHeight = 0.0f ;
     m_heightMapMaxHeight = 100.0f;
     
@@ -223,6 +225,7 @@ Game::~Game()
     delete m_pIrrSkybox;
     delete m_pPlanarTerrain;
     delete m_pHeightmapTerrain;
+    delete m_pVoxelTerrain;
     delete m_teapot1;
     delete m_teapot2;
     delete m_teapot3;
@@ -273,11 +276,7 @@ Game::~Game()
     delete m_pMetaballs;
     delete m_pQuad;
     
-    for (GLuint i = 0; i < m_pFBOs.size(); i++) {
-        // delete current buffers
-        m_pFBOs[i]->Release();
-        delete m_pFBOs[i];
-    }
+    ReleaseFrameBuffers();
     m_pFBOs.clear();
     
     if (m_pShaderPrograms != nullptr) {
@@ -303,6 +302,14 @@ void Game::PreRendering() {
     // update controls
     UpdateControls();
     
+    // select the terrain chunks once per frame, every render pass draws this selection
+    if (m_showTerrain) {
+        m_pHeightmapTerrain->UpdateChunks(m_pCamera->GetPosition(), *m_pCamera->GetPerspectiveProjectionMatrix() * m_pCamera->GetViewMatrix());
+    }
+    if (m_showVoxelWorld) {
+        m_pVoxelTerrain->Update(*m_pCamera->GetPerspectiveProjectionMatrix() * m_pCamera->GetViewMatrix());
+    }
+    
     // update audio
     UpdateAudio();
 }
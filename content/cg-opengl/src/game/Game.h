@@ -18,6 +18,7 @@ class CSkybox;
 class CModel;
 class CPlane;
 class CHeightMapTerrain;
+class CVoxelTerrain;
 class CCube;
 class CSphere;
 class CTorus;
@@ -64,6 +65,10 @@ private:
     CHeightMapTerrain *m_pHeightmapTerrain;
     float m_heightMapMinHeight, m_heightMapMaxHeight;
     
+    // voxel world
+    GLboolean m_showVoxelWorld;
+    CVoxelTerrain *m_pVoxelTerrain;
+    
     //models
     CModel * m_teapot1;
     CModel * m_teapot2;
@@ -206,6 +211,7 @@ protected:
     /// Post processing
     void InitialiseFrameBuffers(const GLuint &width, const GLuint &height) override;
     void LoadFrameBuffers(const GLuint &width, const GLuint &height) override;
+    void ReleaseFrameBuffers() override;
     void BindPPFXFBO(const PostProcessingEffectMode &mode) override;
     void RenderPPFXScene(const PostProcessingEffectMode &mode) override;
     void ChangePPFXScene(PostProcessingEffectMode &mode) override;
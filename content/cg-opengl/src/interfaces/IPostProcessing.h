@@ -14,11 +14,14 @@
 #include "../utilities/PostProcessingEffectMode.h"
 #include "../shaders/ShaderProgram.h"
 #include "../buffers/FrameBufferObject.h"
+#include "../buffers/RenderGraph.h"
 
 struct IPostProcessing {
     PostProcessingEffectMode m_currentPPFXMode;
     CFrameBufferObject *currentFBO;
-    std::vector<CFrameBufferObject*> m_pFBOs;
+    std::vector<CFrameBufferObject*> m_pFBOs;       // slots the effects use, aliases into the pool
+    std::vector<CFrameBufferObject*> m_pFBOPool;    // frame buffers of the current effect's render graph
+    CRenderGraph m_ppfxGraph;
     GLboolean m_changePPFXMode, m_prevPPFXMode, m_nextPPFXMode;
     GLuint m_PPFXOption;
     GLfloat m_coverage;
@@ -108,6 +111,7 @@ struct IPostProcessing {
     
     virtual void InitialiseFrameBuffers(const GLuint &width, const GLuint &height) = 0;
     virtual void LoadFrameBuffers(const GLuint &width , const GLuint &height) = 0;
+    virtual void ReleaseFrameBuffers() = 0;
     virtual void BindPPFXFBO(const PostProcessingEffectMode &mode) = 0;
     virtual void RenderPPFXScene(const PostProcessingEffectMode &mode) = 0;
     virtual void ChangePPFXScene(PostProcessingEffectMode &mode) = 0;
@@ -1,5 +1,6 @@
 #include "HeightMapTerrain.h"
 #pragma comment(lib, "lib/FreeImage.lib")
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
 
 CHeightMapTerrain::CHeightMapTerrain()
@@ -7,6 +8,15 @@ CHeightMapTerrain::CHeightMapTerrain()
     m_heightMap = nullptr;
     m_dib = nullptr;
     m_isRendered = false;
+    m_width = m_height = 0;
+    m_terrainHeightScale = 1.0f;
+    m_frame = 0;
+    m_residentChunks = 0;
+    m_maxResidentChunks = 512;
+    m_maxUploadsPerFrame = 16;
+    m_indexBuffer = 0;
+    m_indexType = GL_UNSIGNED_INT;
+    m_indexSize = sizeof(GLuint);
 }
 
 CHeightMapTerrain::~CHeightMapTerrain()
@@ -52,12 +62,12 @@ glm::vec3 CHeightMapTerrain::WorldToImageCoordinates(glm::vec3 p)
 GLboolean CHeightMapTerrain::GetImageBytes(char *terrainFilename, BYTE **bDataPointer, GLuint &width, GLuint &height)
 {
 	FREE_IMAGE_FORMAT fif = FIF_UNKNOWN;
-	
+
 	fif = FreeImage_GetFileType(terrainFilename, 0); // Check the file signature and deduce its format
 
 	if(fif == FIF_UNKNOWN) // If still unknown, try to guess the file format from the file extension
 		fif = FreeImage_GetFIFFromFilename(terrainFilename);
-	
+
 	if(fif == FIF_UNKNOWN) // If still unknown, return failure
 		return false;
 
@@ -75,99 +85,143 @@ GLboolean CHeightMapTerrain::GetImageBytes(char *terrainFilename, BYTE **bDataPo
 	height = FreeImage_GetHeight(m_dib);
 
 	// If somehow one of these failed (they shouldn't), return failure
-	if(bDataPointer == nullptr || width == 0 || height == 0) 
+	if(bDataPointer == nullptr || width == 0 || height == 0)
 		return false;
 
 	return true;
 }
 
-// This function generates a heightmap terrain based on a bitmap
-GLboolean CHeightMapTerrain::Create(const char *terrainFilename, const std::map<std::string, TextureType> &textureFilenames,
-                                    glm::vec3 origin, GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale)
+// Decode the heightmap image into normalized heights in the range [-1, 1]
+GLboolean CHeightMapTerrain::LoadHeights(const char *terrainFilename, std::vector<GLfloat> &heights, GLuint &width, GLuint &height)
 {
 	BYTE *bDataPointer;
-	unsigned int width, height;
-    
     char *terrain = const_cast<char*>(terrainFilename);
-    
+
 	if (GetImageBytes(terrain, &bDataPointer, width, height) == false)
 		return false;
 
+    // Convert bands of rows in parallel, the bitmap is released as soon as it is converted
+    heights.resize(width * height);
+    const GLuint bandRows = 64;
+    m_pool.ParallelFor((height + bandRows - 1) / bandRows, [&](unsigned int band) {
+        GLuint end = std::min((band + 1) * bandRows, height) * width;
+        for (GLuint index = band * bandRows * width; index < end; index++) {
+            // Retreive the colour from the terrain image, and set the normalized height
+            float grayScale = (bDataPointer[index*3] + bDataPointer[index*3+1] + bDataPointer[index*3+2]) / 3.0f;
+            heights[index] = (grayScale - 128.0f) / 128.0f;
+        }
+    });
+
+	FreeImage_Unload(m_dib);
+    m_dib = nullptr;
+    return true;
+}
+
+// This function generates a heightmap terrain based on a bitmap
+GLboolean CHeightMapTerrain::Create(const char *terrainFilename, const std::map<std::string, TextureType> &textureFilenames,
+                                    glm::vec3 origin, GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale,
+                                    const GLuint &chunkQuads)
+{
+	std::vector<GLfloat> heights;
+	unsigned int width, height;
+
+	if (LoadHeights(terrainFilename, heights, width, height) == false)
+		return false;
+
     m_isRendered = false;
 	m_width = width;
 	m_height = height;
 	m_origin = origin;
 	m_terrainSizeX = terrainSizeX;
 	m_terrainSizeZ = terrainSizeZ;
-	
+    m_terrainHeightScale = terrainHeightScale;
+
 	// Allocate memory and initialize to store the image
 	m_heightMap = new float[m_width * m_height];
-	if (m_heightMap == nullptr) 
+	if (m_heightMap == nullptr)
 		return false;
 
-	// Clear the heightmap
-	memset(m_heightMap, 0, m_width * m_height * sizeof(float));
-
-	// Form mesh
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> triangles;
-	float halfSizeX = m_width / 2.0f;
-	float halfSizeY = m_height / 2.0f;
-	
-	int X = 1;
-	int Z = m_width;
-	int triangleId = 0;
+	// Transform the heights the same way as a point from image to world coordinates, then scale the terrain
+	for (int index = 0; index < m_width * m_height; index++) {
+		m_heightMap[index] = (heights[index] + m_origin.y) * terrainHeightScale;
+	}
+
+	// Bound the heights of every chunk for the quadtree
+	GLuint chunksX = CTerrainTileFile::ChunkCount(m_width, chunkQuads);
+	GLuint chunksZ = CTerrainTileFile::ChunkCount(m_height, chunkQuads);
+	std::vector<glm::vec2> heightRanges(chunksX * chunksZ, glm::vec2(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()));
 	for (int z = 0; z < m_height; z++) {
 		for (int x = 0; x < m_width; x++) {
-			int index = x + z * m_width;
+			float h = m_heightMap[x + z * m_width];
+			// samples on a chunk border belong to both chunks
+			GLuint cx0 = std::min((GLuint)std::max(x - 1, 0) / chunkQuads, chunksX - 1), cx1 = std::min((GLuint)x / chunkQuads, chunksX - 1);
+			GLuint cz0 = std::min((GLuint)std::max(z - 1, 0) / chunkQuads, chunksZ - 1), cz1 = std::min((GLuint)z / chunkQuads, chunksZ - 1);
+			for (GLuint cz = cz0; cz <= cz1; cz++) {
+				for (GLuint cx = cx0; cx <= cx1; cx++) {
+					glm::vec2 &range = heightRanges[cx + cz * chunksX];
+					range = glm::vec2(std::min(range.x, h), std::max(range.y, h));
+				}
+			}
+		}
+	}
 
-			// Retreive the colour from the terrain image, and set the normalized height in the range [0, 1]
-			float grayScale = (bDataPointer[index*3] + bDataPointer[index*3+1] + bDataPointer[index*3+2]) / 3.0f;
-			float height = (grayScale - 128.0f) / 128.0f;
+	CreateChunks(chunksX, chunksZ, chunkQuads, heightRanges);
+	LoadTextures(textureFilenames);
 
-			// Make a point based on this pixel position.  Then, transform so that the mesh has the correct size and origin
-			// This transforms a point in image coordinates to world coordinates
-			glm::vec3 pImage = glm::vec3((float) x, height, (float) z);
-			glm::vec3 pWorld = ImageToWorldCoordinates(pImage);
+	return true;
+}
 
-			// Scale the terrain and store for later
-			pWorld.y *= terrainHeightScale;	 
-			m_heightMap[index] = pWorld.y;
+// This function generates a heightmap terrain streamed from a tile file written by CreateTileFile
+GLboolean CHeightMapTerrain::CreateFromTiles(const char *tileFilename, const std::map<std::string, TextureType> &textureFilenames,
+                                             glm::vec3 origin, GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale)
+{
+	if (m_tileFile.Open(tileFilename) == false)
+		return false;
 
-			// Store the point in a vector
-			Vertex v = Vertex(pWorld, glm::vec2(0.0, 0.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 0.0, 0.0));
-			vertices.push_back(v);
-		}
+    m_isRendered = false;
+	m_width = m_tileFile.GetWidth();
+	m_height = m_tileFile.GetHeight();
+	m_origin = origin;
+	m_terrainSizeX = terrainSizeX;
+	m_terrainSizeZ = terrainSizeZ;
+    m_terrainHeightScale = terrainHeightScale;
+
+	// The file stores normalized heights, transform the ranges like the heights themselves
+	std::vector<glm::vec2> heightRanges = m_tileFile.GetHeightRanges();
+	for (glm::vec2 &range : heightRanges) {
+		range = (range + m_origin.y) * terrainHeightScale;
+		if (range.x > range.y)
+			std::swap(range.x, range.y);
 	}
 
-	FreeImage_Unload(m_dib);
+	CreateChunks(m_tileFile.GetChunksX(), m_tileFile.GetChunksZ(), m_tileFile.GetChunkQuads(), heightRanges);
+	LoadTextures(textureFilenames);
 
-	// Form triangles from successive rows of the image
-	for (int z = 0; z < m_height-1; z++) {
-		for (int x = 0; x < m_width-1; x++) {
-			int index = x + z * m_width;
-			triangles.push_back(index);
-			triangles.push_back(index+X+Z);
-			triangles.push_back(index+X);
-
-			triangles.push_back(index);
-			triangles.push_back(index+Z);
-			triangles.push_back(index+X+Z);
-		}
-	}
+	return true;
+}
+
+GLboolean CHeightMapTerrain::CreateTileFile(const char *terrainFilename, const char *tileFilename, const GLuint &chunkQuads)
+{
+	std::vector<GLfloat> heights;
+	unsigned int width, height;
+
+	if (LoadHeights(terrainFilename, heights, width, height) == false)
+		return false;
 
-	// Create a face vertex mesh
-	m_mesh.CreateFromTriangleList(vertices, triangles);
+	return CTerrainTileFile::Write(tileFilename, heights.data(), width, height, chunkQuads);
+}
 
+void CHeightMapTerrain::LoadTextures(const std::map<std::string, TextureType> &textureFilenames)
+{
     // Load a texture for texture mapping the mesh
     m_textureFileNames = textureFilenames;
     m_textures.reserve(textureFilenames.size());
-    
+
     // Iterate through all elements in std::map
     for (auto it = textureFilenames.begin(); it != textureFilenames.end(); ++it) {
         // if the current index is needed:
         auto i = std::distance(textureFilenames.begin(), it);
-        
+
         // access element as *it
         m_textures.push_back(new CTexture);
         m_textures[i]->LoadTexture(it->first, it->second, true);
@@ -175,35 +229,267 @@ GLboolean CHeightMapTerrain::Create(const char *terrainFilename, const std::map<
         m_textures[i]->SetSamplerObjectParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         m_textures[i]->SetSamplerObjectParameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
         m_textures[i]->SetSamplerObjectParameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
-        
+
         // any code including continue, break, return
     }
-    
-    
-	return true;
 }
+
+void CHeightMapTerrain::CreateChunks(const GLuint &chunksX, const GLuint &chunksZ, const GLuint &chunkQuads, const std::vector<glm::vec2> &heightRanges)
+{
+	// The quadtree works in the same space as the vertices, before the model matrix
+	glm::vec3 corner = ImageToWorldCoordinates(glm::vec3(0.0f, 0.0f, 0.0f));
+	glm::vec2 chunkSize(m_terrainSizeX * chunkQuads / m_width, m_terrainSizeZ * chunkQuads / m_height);
+	m_quadtree.Create(chunksX, chunksZ, chunkQuads, glm::vec2(corner.x, corner.z), chunkSize, heightRanges);
+	m_quadtree.SetLodDistance(4.0f * std::max(chunkSize.x, chunkSize.y));
+
+	SChunk empty;
+	empty.vao = empty.vbo = 0;
+	empty.resident = empty.pending = false;
+	empty.lastUsedFrame = 0;
+	m_chunks.assign(m_quadtree.GetChunkCount(), empty);
+	m_residentChunks = 0;
+	m_frame = 0;
+
+	// Every chunk shares the same index patterns, one per level of detail and stitching mask
+	std::vector<GLuint> indices, pattern;
+	m_patternOffsets.resize(m_quadtree.GetLodCount() * 16);
+	m_patternCounts.resize(m_quadtree.GetLodCount() * 16);
+	for (GLuint lod = 0; lod < m_quadtree.GetLodCount(); lod++) {
+		for (GLuint edgeMask = 0; edgeMask < 16; edgeMask++) {
+			m_quadtree.BuildIndexPattern(lod, edgeMask, pattern);
+			m_patternOffsets[lod * 16 + edgeMask] = (GLuint)indices.size();
+			m_patternCounts[lod * 16 + edgeMask] = (GLuint)pattern.size();
+			indices.insert(indices.end(), pattern.begin(), pattern.end());
+		}
+	}
+
+	// A chunk rarely has more than 65536 vertices, 16 bit indices then halve the index memory
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	if ((chunkQuads + 1) * (chunkQuads + 1) <= 65536) {
+		std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+		m_indexType = GL_UNSIGNED_SHORT;
+		m_indexSize = sizeof(GLushort);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * shortIndices.size(), &shortIndices[0], GL_STATIC_DRAW);
+	} else {
+		m_indexType = GL_UNSIGNED_INT;
+		m_indexSize = sizeof(GLuint);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), &indices[0], GL_STATIC_DRAW);
+	}
+}
+
+// Runs on a worker thread: build the vertices of one chunk, no OpenGL calls here
+void CHeightMapTerrain::LoadChunk(const GLuint &chunk)
+{
+	const int n = (int)m_quadtree.GetChunkQuads();
+	const int side = n + 3;
+	const int x0 = (int)(chunk % m_quadtree.GetChunksX()) * n;
+	const int z0 = (int)(chunk / m_quadtree.GetChunksX()) * n;
+
+	// Heights of the chunk plus a one sample apron, in world units
+	std::vector<GLfloat> samples;
+	if (m_heightMap != nullptr) {
+		CTerrainTileFile::ExtractChunk(m_heightMap, m_width, m_height, n, chunk, samples);
+	} else if (m_tileFile.ReadChunk(chunk, samples)) {
+		for (GLfloat &h : samples)
+			h = (h + m_origin.y) * m_terrainHeightScale;
+	} else {
+		samples.assign(side * side, m_origin.y * m_terrainHeightScale);
+	}
+
+	SLoadedChunk *loaded = new SLoadedChunk;
+	loaded->chunk = chunk;
+	loaded->vertices.resize((n + 1) * (n + 1));
+	loaded->heights.resize((n + 1) * (n + 1));
+
+	for (int z = 0; z <= n; z++) {
+		for (int x = 0; x <= n; x++) {
+			// Samples past the edge of the heightmap are clamped onto it
+			glm::vec3 pWorld = ImageToWorldCoordinates(glm::vec3((float)std::min(x0 + x, m_width - 1), 0.0f, (float)std::min(z0 + z, m_height - 1)));
+			pWorld.y = samples[(x + 1) + (z + 1) * side];
+			glm::vec2 texture = glm::vec2(pWorld.x / 20.0f, pWorld.z / 20.0f);
+
+			loaded->vertices[x + z * (n + 1)] = Vertex(pWorld, texture, glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 0.0, 0.0));
+			loaded->heights[x + z * (n + 1)] = pWorld.y;
+		}
+
+		// Normals from central differences over the apron match across chunk borders
+		const GLfloat *row = &samples[1 + (z + 1) * side];
+		CTerrainMeshGenerator::ComputeNormalRow(row - side, row, row + side, n + 1, m_width / (2.0f * m_terrainSizeX), m_height / (2.0f * m_terrainSizeZ),
+		                                        &loaded->vertices[z * (n + 1)].normal, sizeof(Vertex));
+	}
+
+	std::lock_guard<std::mutex> lock(m_loadedMutex);
+	m_loaded.push_back(loaded);
+}
+
+void CHeightMapTerrain::UploadChunk(SLoadedChunk &loaded)
+{
+	SChunk &chunk = m_chunks[loaded.chunk];
+	chunk.pending = false;
+
+	if (chunk.vao == 0) {
+		glGenVertexArrays(1, &chunk.vao);
+		glBindVertexArray(chunk.vao);
+		glGenBuffers(1, &chunk.vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+		//vertex
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+
+		//texcoord
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,  sizeof(Vertex), (const GLvoid*)12);
+
+		//normal
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE,  sizeof(Vertex), (const GLvoid*)20);
+
+		//tangent
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE,  sizeof(Vertex), (const GLvoid*)32);
+
+		//bitangent
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)44);
+	} else {
+		glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+	}
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * loaded.vertices.size(), &loaded.vertices[0], GL_STATIC_DRAW);
+
+	chunk.heights.swap(loaded.heights);
+	chunk.resident = true;
+	m_residentChunks++;
+}
+
+// Drop the least recently used chunks that are not visible this frame until the budget is met
+void CHeightMapTerrain::EvictChunks()
+{
+	if (m_residentChunks <= m_maxResidentChunks)
+		return;
+
+	std::vector<GLuint> candidates;
+	for (GLuint i = 0; i < m_chunks.size(); i++) {
+		if (m_chunks[i].resident && m_chunks[i].lastUsedFrame != m_frame)
+			candidates.push_back(i);
+	}
+
+	GLuint count = std::min((GLuint)candidates.size(), m_residentChunks - m_maxResidentChunks);
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [this](GLuint a, GLuint b) {
+		return m_chunks[a].lastUsedFrame < m_chunks[b].lastUsedFrame;
+	});
+
+	for (GLuint i = 0; i < count; i++) {
+		SChunk &chunk = m_chunks[candidates[i]];
+		glDeleteVertexArrays(1, &chunk.vao);
+		glDeleteBuffers(1, &chunk.vbo);
+		chunk.vao = chunk.vbo = 0;
+		chunk.resident = false;
+		std::vector<GLfloat>().swap(chunk.heights);
+		m_residentChunks--;
+	}
+}
+
+void CHeightMapTerrain::UpdateChunks(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection)
+{
+	if (m_chunks.empty())
+		return;
+	m_frame++;
+
+	// Upload a bounded number of the chunks the workers have finished
+	std::vector<SLoadedChunk*> loaded;
+	{
+		std::lock_guard<std::mutex> lock(m_loadedMutex);
+		GLuint count = std::min((GLuint)m_loaded.size(), m_maxUploadsPerFrame);
+		loaded.assign(m_loaded.begin(), m_loaded.begin() + count);
+		m_loaded.erase(m_loaded.begin(), m_loaded.begin() + count);
+	}
+	for (SLoadedChunk *chunk : loaded) {
+		UploadChunk(*chunk);
+		delete chunk;
+	}
+
+	// Select in terrain space, the quadtree bounds do not include the model matrix
+	glm::mat4 model = Model();
+	glm::vec3 terrainCamera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+	m_selection.clear();
+	m_quadtree.Select(terrainCamera, viewProjection * model, m_selection);
+
+	// Request the visible chunks that are missing, nearest levels of detail first
+	std::stable_sort(m_selection.begin(), m_selection.end(), [](const STerrainChunkSelection &a, const STerrainChunkSelection &b) {
+		return a.lod < b.lod;
+	});
+	GLuint pending = 0;
+	for (const SChunk &chunk : m_chunks) {
+		if (chunk.pending)
+			pending++;
+	}
+	for (const STerrainChunkSelection &selected : m_selection) {
+		SChunk &chunk = m_chunks[selected.chunk];
+		chunk.lastUsedFrame = m_frame;
+		if (chunk.resident || chunk.pending || pending >= 4 * m_maxUploadsPerFrame)
+			continue;
+		chunk.pending = true;
+		pending++;
+		GLuint index = selected.chunk;
+		m_pool.Enqueue([this, index]() { LoadChunk(index); });
+	}
+
+	EvictChunks();
+}
+
+void CHeightMapTerrain::SetLodDistance(const GLfloat &distance)
+{
+	m_quadtree.SetLodDistance(distance);
+}
+
+void CHeightMapTerrain::SetStreamingBudget(const GLuint &maxResidentChunks, const GLuint &maxUploadsPerFrame)
+{
+	m_maxResidentChunks = maxResidentChunks;
+	m_maxUploadsPerFrame = std::max(maxUploadsPerFrame, 1u);
+}
+
 // For a point p in world coordinates, return the height of the terrain
 GLfloat CHeightMapTerrain::ReturnGroundHeight(glm::vec3 p)
 {
 	// Undo the transformation going from image coordinates to world coordinates
 	glm::vec3 pImage = WorldToImageCoordinates(p);
-	// Bilinear interpolation. 
+	// Bilinear interpolation.
 	int xl = (int) floor(pImage.x);
 	int zl = (int) floor (pImage.z);
 	// Check if the position is in the region of the heightmap
 	if (xl < 0 || xl >= m_width - 1 || zl < 0 || zl >= m_height -1)
 		return 0.0f;
-	// Get the indices of four pixels around the current point 
-	int indexll = xl + zl * m_width;
-	int indexlr = (xl+1) + zl * m_width;
-	int indexul = xl + (zl+1) * m_width;
-	int indexur = (xl+1) + (zl+1) * m_width;
 	// Interpolation amounts in x and z
 	float dx = pImage.x - xl;
 	float dz = pImage.z - zl;
+
+	// A streamed terrain only has the heights of the chunks that are resident
+	const GLfloat *heights = m_heightMap;
+	int stride = m_width;
+	if (heights == nullptr) {
+		int n = (int)m_quadtree.GetChunkQuads();
+		GLuint chunk = (xl / n) + (zl / n) * m_quadtree.GetChunksX();
+		if (m_chunks[chunk].resident == false) {
+			glm::vec3 min = m_quadtree.GetChunkMin(chunk), max = m_quadtree.GetChunkMax(chunk);
+			return 0.5f * (min.y + max.y);
+		}
+		heights = m_chunks[chunk].heights.data();
+		stride = n + 1;
+		xl %= n;
+		zl %= n;
+	}
+
+	// Get the indices of four pixels around the current point
+	int indexll = xl + zl * stride;
+	int indexlr = (xl+1) + zl * stride;
+	int indexul = xl + (zl+1) * stride;
+	int indexur = (xl+1) + (zl+1) * stride;
 	// Interpolate -- first in x and and then in z
-	float a = (1-dx) * m_heightMap[indexll] + dx * m_heightMap[indexlr];
-	float b = (1-dx) * m_heightMap[indexul] + dx * m_heightMap[indexur];
+	float a = (1-dx) * heights[indexll] + dx * heights[indexlr];
+	float b = (1-dx) * heights[indexul] + dx * heights[indexur];
 	float c = (1-dz) * a + dz * b;
 	return c;
 }
@@ -225,7 +511,16 @@ void CHeightMapTerrain::Render(const GLboolean &useTexture)
             m_textures[i]->BindTexture2DToTextureType();
         }
     }
-	m_mesh.Render();
+
+	// Chunks still being built are skipped for now, they show up once uploaded
+	for (const STerrainChunkSelection &selected : m_selection) {
+		const SChunk &chunk = m_chunks[selected.chunk];
+		if (chunk.resident == false)
+			continue;
+		GLuint pattern = selected.lod * 16 + selected.edgeMask;
+		glBindVertexArray(chunk.vao);
+		glDrawElements(GL_TRIANGLES, m_patternCounts[pattern], m_indexType, BUFFER_OFFSET(m_patternOffsets[pattern] * m_indexSize));
+	}
     m_isRendered = true;
 }
 
@@ -233,9 +528,37 @@ GLboolean CHeightMapTerrain::IsHeightMapRendered() {
     return m_isRendered;
 }
 
-// Release memory on the GPU 
+void CHeightMapTerrain::ReleaseChunks()
+{
+	// Workers may still be building chunks that reference the heightmap or the tile file
+	m_pool.WaitIdle();
+	for (SLoadedChunk *loaded : m_loaded) {
+		delete loaded;
+	}
+	m_loaded.clear();
+
+	for (SChunk &chunk : m_chunks) {
+		if (chunk.vao != 0) {
+			glDeleteVertexArrays(1, &chunk.vao);
+			glDeleteBuffers(1, &chunk.vbo);
+		}
+	}
+	m_chunks.clear();
+	m_selection.clear();
+	m_residentChunks = 0;
+
+	if (m_indexBuffer != 0) {
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+	m_quadtree.Release();
+	m_tileFile.Close();
+}
+
+// Release memory on the GPU
 void CHeightMapTerrain::Release()
 {
+    ReleaseChunks();
     for (unsigned int i = 0; i < m_textures.size(); ++i){
         m_textures[i]->Release();
         delete m_textures[i];
@@ -243,5 +566,9 @@ void CHeightMapTerrain::Release()
     m_textures.clear();
     m_isRendered = false;
     delete [] m_heightMap;
-    delete m_dib;
+    m_heightMap = nullptr;
+    if (m_dib != nullptr) {
+        FreeImage_Unload(m_dib);
+        m_dib = nullptr;
+    }
 }
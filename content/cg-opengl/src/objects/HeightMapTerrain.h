@@ -1,38 +1,95 @@
 #pragma once
 
 #include "../ObjectsBase.h"
+#include "TerrainQuadtree.h"
+#include "TerrainTileFile.h"
+#include "TerrainMeshGenerator.h"
+#include "../utilities/ThreadPool.h"
 
+// Heightmap terrain drawn as a grid of chunks. A quadtree over the chunks
+// culls them against the view frustum and picks a level of detail per chunk
+// from the camera distance. Chunk vertices are built on worker threads,
+// either from the heightmap held in memory (Create) or streamed from a
+// preprocessed tile file (CreateFromTiles) for heightmaps that do not fit
+// in memory, and only the chunks near the camera stay on the GPU.
 class CHeightMapTerrain: public IGameObject
 {
 public:
 	CHeightMapTerrain();
 	~CHeightMapTerrain();
 	GLboolean Create(const char *terrainFilename, const std::map<std::string, TextureType> &textureFilenames, glm::vec3 origin,
-                     GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale);
+                     GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale, const GLuint &chunkQuads = 64);
+    GLboolean CreateFromTiles(const char *tileFilename, const std::map<std::string, TextureType> &textureFilenames, glm::vec3 origin,
+                              GLfloat terrainSizeX, GLfloat terrainSizeZ, GLfloat terrainHeightScale);
+    // Preprocess a heightmap image into a tile file for CreateFromTiles
+    GLboolean CreateTileFile(const char *terrainFilename, const char *tileFilename, const GLuint &chunkQuads = 64);
 	GLfloat ReturnGroundHeight(glm::vec3 p);
 
     void Transform(const glm::vec3 & position,
                    const glm::vec3 & rotation = glm::vec3(0, 0, 0),
                    const glm::vec3 & scale = glm::vec3(1, 1, 1));
-    
+
+    // Select the visible chunks and their level of detail for the camera, call once per frame before the render passes,
+    // it uses the model matrix of the last Transform
+    void UpdateChunks(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection);
+    void SetLodDistance(const GLfloat &distance);
+    void SetStreamingBudget(const GLuint &maxResidentChunks, const GLuint &maxUploadsPerFrame);
+
     void Render(const GLboolean &useTexture = true);
     void Release();
     GLboolean IsHeightMapRendered();
-    
+
 private:
+    struct SChunk
+    {
+        GLuint vao, vbo;
+        GLboolean resident, pending;
+        GLuint lastUsedFrame;
+        std::vector<GLfloat> heights;       // (chunkQuads + 1)^2 world heights for ReturnGroundHeight
+    };
+
+    struct SLoadedChunk
+    {
+        GLuint chunk;
+        std::vector<Vertex> vertices;
+        std::vector<GLfloat> heights;
+    };
+
 	GLint m_width, m_height;
     GLboolean m_isRendered;
 	GLfloat *m_heightMap;
-	CFaceVertexMesh m_mesh;
 	GLuint m_hTexture;
-	GLfloat m_terrainSizeX, m_terrainSizeZ;
+	GLfloat m_terrainSizeX, m_terrainSizeZ, m_terrainHeightScale;
 	glm::vec3 m_origin;
     std::map<std::string, TextureType> m_textureFileNames;
     std::vector<CTexture*> m_textures;
-    
+
 	FIBITMAP* m_dib;
 
+    CTerrainQuadtree m_quadtree;
+    CTerrainTileFile m_tileFile;
+    std::vector<SChunk> m_chunks;
+    std::vector<STerrainChunkSelection> m_selection;
+    GLuint m_frame, m_residentChunks, m_maxResidentChunks, m_maxUploadsPerFrame;
+
+    // all index patterns in one buffer, pattern lod * 16 + edgeMask starts at index m_patternOffsets
+    GLuint m_indexBuffer;
+    GLenum m_indexType;
+    GLuint m_indexSize;
+    std::vector<GLuint> m_patternOffsets, m_patternCounts;
+
+    CThreadPool m_pool;
+    std::mutex m_loadedMutex;
+    std::vector<SLoadedChunk*> m_loaded;
+
 	glm::vec3 WorldToImageCoordinates(glm::vec3 p);
 	glm::vec3 ImageToWorldCoordinates(glm::vec3 p);
 	GLboolean GetImageBytes(char *terrainFilename, BYTE **bDataPointer, GLuint &width, GLuint &height);
+    GLboolean LoadHeights(const char *terrainFilename, std::vector<GLfloat> &heights, GLuint &width, GLuint &height);
+    void LoadTextures(const std::map<std::string, TextureType> &textureFilenames);
+    void CreateChunks(const GLuint &chunksX, const GLuint &chunksZ, const GLuint &chunkQuads, const std::vector<glm::vec2> &heightRanges);
+    void LoadChunk(const GLuint &chunk);
+    void UploadChunk(SLoadedChunk &loaded);
+    void EvictChunks();
+    void ReleaseChunks();
 };
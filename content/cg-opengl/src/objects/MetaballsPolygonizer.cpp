@@ -0,0 +1,383 @@
+#include "MetaballsPolygonizer.h"
+
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define METABALLS_USE_SSE
+#endif
+
+// massless balls used to pad the ball arrays to a multiple of four
+static const float PADDING_POSITION = 1000.0f;
+
+#ifdef METABALLS_USE_SSE
+// 1/x from the hardware estimate refined by one Newton-Raphson step, which is
+// within a couple of ulps of a true division at a fraction of its cost
+static inline __m128 Reciprocal(const __m128 &x)
+{
+	__m128 r = _mm_rcp_ps(x);
+	return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(x, r)));
+}
+#endif
+
+//=============================================================================
+CMetaballsPolygonizer::CMetaballsPolygonizer(const unsigned int &threadCount)
+: m_nGridSize(0), m_fVoxelSize(0.0f), m_fCullTolerance(0.0f), m_nNumBalls(0), m_pool(threadCount)
+{
+}
+
+CMetaballsPolygonizer::~CMetaballsPolygonizer()
+{
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::SetGridSize(const int &nSize)
+{
+	m_nGridSize  = nSize;
+	m_fVoxelSize = nSize > 0 ? 2/float(nSize) : 0.0f;
+
+	m_gridEnergy.assign(nSize > 0 ? (nSize+1)*(nSize+1)*(nSize+1) : 0, 0.0f);
+
+	// a few slabs per thread so that slabs crossing a lot of surface do not stall the others
+	int numberOfSlabs = std::max(1, std::min(nSize, (int)GetThreadCount()*4));
+	m_slabs.resize(numberOfSlabs);
+	for( int i = 0; i < numberOfSlabs; i++ )
+	{
+		m_slabs[i].z0 = nSize*i/numberOfSlabs;
+		m_slabs[i].z1 = nSize*(i+1)/numberOfSlabs;
+	}
+}
+
+void CMetaballsPolygonizer::SetCullTolerance(const float &tolerance)
+{
+	m_fCullTolerance = std::max(0.0f, tolerance);
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::Polygonize(const SBall *pBalls, const int &numberOfBalls, const float &level)
+{
+	m_vertices.clear();
+	m_indices.clear();
+	if( m_nGridSize <= 0 )
+		return;
+
+	PrepareBalls(pBalls, numberOfBalls, level);
+
+	// Evaluate the energy of every grid point, one z plane per task
+	m_pool.ParallelFor(m_nGridSize+1, [this](unsigned int z) { ComputeEnergyPlane(z); });
+
+	// March the voxels of every slab into the slab's own buffers
+	m_pool.ParallelFor((unsigned int)m_slabs.size(), [this, level](unsigned int i) {
+		CollectSlabBalls(m_slabs[i]);
+		PolygonizeSlab(m_slabs[i], level);
+	});
+
+	// Merge the slabs into one vertex and index array
+	size_t numVertices = 0, numIndices = 0;
+	std::vector<size_t> vertexOffsets(m_slabs.size()), indexOffsets(m_slabs.size());
+	for( size_t i = 0; i < m_slabs.size(); i++ )
+	{
+		vertexOffsets[i] = numVertices;
+		indexOffsets[i]  = numIndices;
+		numVertices += m_slabs[i].vertices.size();
+		numIndices  += m_slabs[i].indices.size();
+	}
+	m_vertices.resize(numVertices);
+	m_indices.resize(numIndices);
+
+	m_pool.ParallelFor((unsigned int)m_slabs.size(), [&](unsigned int i) {
+		const SSlab &slab = m_slabs[i];
+		std::copy(slab.vertices.begin(), slab.vertices.end(), m_vertices.begin() + vertexOffsets[i]);
+		GLuint base = (GLuint)vertexOffsets[i];
+		GLuint *pIndices = m_indices.data() + indexOffsets[i];
+		for( size_t j = 0; j < slab.indices.size(); j++ )
+			pIndices[j] = slab.indices[j] + base;
+	});
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::PrepareBalls(const SBall *pBalls, const int &numberOfBalls, const float &level)
+{
+	m_nNumBalls = numberOfBalls;
+	int padded = (numberOfBalls + 3) & ~3;
+
+	m_ballX.assign(padded, PADDING_POSITION);
+	m_ballY.assign(padded, PADDING_POSITION);
+	m_ballZ.assign(padded, PADDING_POSITION);
+	m_ballMass.assign(padded, 0.0f);
+	m_ballRadiusSq.assign(padded, -1.0f);
+
+	// Beyond this energy a ball is considered to have no influence
+	float fCullEnergy = numberOfBalls > 0 ? m_fCullTolerance*level/numberOfBalls : 0.0f;
+
+	for( int i = 0; i < numberOfBalls; i++ )
+	{
+		m_ballX[i]    = pBalls[i].p[0];
+		m_ballY[i]    = pBalls[i].p[1];
+		m_ballZ[i]    = pBalls[i].p[2];
+		m_ballMass[i] = pBalls[i].m;
+
+		// mass/distance^2 < cull energy  <=>  distance^2 > mass/cull energy
+		m_ballRadiusSq[i] = fCullEnergy > 0 ? pBalls[i].m/fCullEnergy : FLT_MAX;
+	}
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::ComputeEnergyPlane(int z)
+{
+	const int n = m_nGridSize+1;
+	float *pPlane = &m_gridEnergy[z*n*n];
+
+	// The energy on the edges are always zero to make sure the isosurface is
+	// always closed.
+	if( z == 0 || z == m_nGridSize )
+	{
+		std::fill(pPlane, pPlane + n*n, 0.0f);
+		return;
+	}
+
+	float fz = ConvertGridPointToWorldCoordinate(z);
+
+	// balls reaching the current row: x position, squared y/z distance and mass
+	std::vector<float> rowX, rowYZ, rowMass;
+	rowX.reserve(m_nNumBalls);
+	rowYZ.reserve(m_nNumBalls);
+	rowMass.reserve(m_nNumBalls);
+
+	for( int y = 0; y < n; y++ )
+	{
+		float *pRow = pPlane + y*n;
+		if( y == 0 || y == m_nGridSize )
+		{
+			std::fill(pRow, pRow + n, 0.0f);
+			continue;
+		}
+
+		float fy = ConvertGridPointToWorldCoordinate(y);
+
+		// Per ball bounding box culling, done once per row
+		rowX.clear();
+		rowYZ.clear();
+		rowMass.clear();
+		for( int i = 0; i < m_nNumBalls; i++ )
+		{
+			float dy = m_ballY[i] - fy;
+			float dz = m_ballZ[i] - fz;
+			float fSqDist = dy*dy + dz*dz;
+			if( fSqDist < m_ballRadiusSq[i] )
+			{
+				rowX.push_back(m_ballX[i]);
+				rowYZ.push_back(fSqDist);
+				rowMass.push_back(m_ballMass[i]);
+			}
+		}
+		const int numRowBalls = (int)rowX.size();
+
+		pRow[0] = 0;
+		pRow[m_nGridSize] = 0;
+
+		// The formula for the energy is
+		//
+		//   e += mass/distance^2
+		int x = 1;
+#ifdef METABALLS_USE_SSE
+		const __m128 minSqDist = _mm_set1_ps(0.0001f);
+		const __m128 voxelSize = _mm_set1_ps(m_fVoxelSize);
+		const __m128 one       = _mm_set1_ps(1.0f);
+		// eight points per iteration, two independent sums keep the pipeline busy
+		for( ; x + 8 <= m_nGridSize; x += 8 )
+		{
+			__m128 fx0 = _mm_sub_ps(_mm_mul_ps(_mm_setr_ps(float(x), float(x+1), float(x+2), float(x+3)), voxelSize), one);
+			__m128 fx1 = _mm_sub_ps(_mm_mul_ps(_mm_setr_ps(float(x+4), float(x+5), float(x+6), float(x+7)), voxelSize), one);
+			__m128 fEnergy0 = _mm_setzero_ps();
+			__m128 fEnergy1 = _mm_setzero_ps();
+			for( int i = 0; i < numRowBalls; i++ )
+			{
+				__m128 bx = _mm_set1_ps(rowX[i]);
+				__m128 yz = _mm_set1_ps(rowYZ[i]);
+				__m128 m  = _mm_set1_ps(rowMass[i]);
+				__m128 dx0 = _mm_sub_ps(bx, fx0);
+				__m128 dx1 = _mm_sub_ps(bx, fx1);
+				__m128 fSqDist0 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx0, dx0), yz), minSqDist);
+				__m128 fSqDist1 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx1, dx1), yz), minSqDist);
+				fEnergy0 = _mm_add_ps(fEnergy0, _mm_mul_ps(m, Reciprocal(fSqDist0)));
+				fEnergy1 = _mm_add_ps(fEnergy1, _mm_mul_ps(m, Reciprocal(fSqDist1)));
+			}
+			_mm_storeu_ps(pRow + x, fEnergy0);
+			_mm_storeu_ps(pRow + x + 4, fEnergy1);
+		}
+#endif
+		for( ; x < m_nGridSize; x++ )
+		{
+			float fx = ConvertGridPointToWorldCoordinate(x);
+			float fEnergy = 0;
+			for( int i = 0; i < numRowBalls; i++ )
+			{
+				float dx = rowX[i] - fx;
+				float fSqDist = dx*dx + rowYZ[i];
+				if( fSqDist < 0.0001f ) fSqDist = 0.0001f;
+				fEnergy += rowMass[i] / fSqDist;
+			}
+			pRow[x] = fEnergy;
+		}
+	}
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::CollectSlabBalls(SSlab &slab) const
+{
+	slab.ballX.clear();
+	slab.ballY.clear();
+	slab.ballZ.clear();
+	slab.ballMass.clear();
+
+	float fz0 = ConvertGridPointToWorldCoordinate(slab.z0);
+	float fz1 = ConvertGridPointToWorldCoordinate(slab.z1);
+	for( int i = 0; i < m_nNumBalls; i++ )
+	{
+		float dz = m_ballZ[i] < fz0 ? fz0 - m_ballZ[i] : (m_ballZ[i] > fz1 ? m_ballZ[i] - fz1 : 0.0f);
+		if( dz*dz >= m_ballRadiusSq[i] )
+			continue;
+		slab.ballX.push_back(m_ballX[i]);
+		slab.ballY.push_back(m_ballY[i]);
+		slab.ballZ.push_back(m_ballZ[i]);
+		slab.ballMass.push_back(m_ballMass[i]);
+	}
+	while( slab.ballX.size() & 3 )
+	{
+		slab.ballX.push_back(PADDING_POSITION);
+		slab.ballY.push_back(PADDING_POSITION);
+		slab.ballZ.push_back(PADDING_POSITION);
+		slab.ballMass.push_back(0.0f);
+	}
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::PolygonizeSlab(SSlab &slab, const float &level)
+{
+	slab.vertices.clear();
+	slab.indices.clear();
+
+	const int n = m_nGridSize+1;
+	const float *e = m_gridEnergy.data();
+
+	for( int z = slab.z0; z < slab.z1; z++ )
+	for( int y = 0; y < m_nGridSize; y++ )
+	{
+		const float *r00 = e + y*n + z*n*n;       // row (y  , z  )
+		const float *r01 = r00 + n*n;             // row (y  , z+1)
+		const float *r10 = r00 + n;               // row (y+1, z  )
+		const float *r11 = r01 + n;               // row (y+1, z+1)
+
+		for( int x = 0; x < m_nGridSize; x++ )
+		{
+			float b[8];
+			b[0] = r00[x  ];
+			b[1] = r00[x+1];
+			b[2] = r01[x+1];
+			b[3] = r01[x  ];
+			b[4] = r10[x  ];
+			b[5] = r10[x+1];
+			b[6] = r11[x+1];
+			b[7] = r11[x  ];
+
+			int c = 0;
+			c |= b[0] > level ? (1<<0) : 0;
+			c |= b[1] > level ? (1<<1) : 0;
+			c |= b[2] > level ? (1<<2) : 0;
+			c |= b[3] > level ? (1<<3) : 0;
+			c |= b[4] > level ? (1<<4) : 0;
+			c |= b[5] > level ? (1<<5) : 0;
+			c |= b[6] > level ? (1<<6) : 0;
+			c |= b[7] > level ? (1<<7) : 0;
+
+			// completely inside or outside, nothing to emit
+			if( c == 0 || c == 255 )
+				continue;
+
+			float fx = ConvertGridPointToWorldCoordinate(x);
+			float fy = ConvertGridPointToWorldCoordinate(y);
+			float fz = ConvertGridPointToWorldCoordinate(z);
+
+			GLuint EdgeIndices[12];
+			memset(EdgeIndices, 0xFF, 12*sizeof(GLuint));
+			for( int i = 0; ; i++ )
+			{
+				int nEdge = CMarchingCubes::m_CubeTriangles[c][i];
+				if( nEdge == -1 )
+					break;
+
+				if( EdgeIndices[nEdge] == 0xFFFFFFFF )
+				{
+					EdgeIndices[nEdge] = (GLuint)slab.vertices.size();
+
+					// Compute the vertex by interpolating between the two points
+					int nIndex0 = CMarchingCubes::m_CubeEdges[nEdge][0];
+					int nIndex1 = CMarchingCubes::m_CubeEdges[nEdge][1];
+
+					float t = (level - b[nIndex0])/(b[nIndex1] - b[nIndex0]);
+
+					SMetaballVertex vertex;
+					vertex.position.x = fx + (CMarchingCubes::m_CubeVertices[nIndex0][0]*(1-t) + CMarchingCubes::m_CubeVertices[nIndex1][0]*t)*m_fVoxelSize;
+					vertex.position.y = fy + (CMarchingCubes::m_CubeVertices[nIndex0][1]*(1-t) + CMarchingCubes::m_CubeVertices[nIndex1][1]*t)*m_fVoxelSize;
+					vertex.position.z = fz + (CMarchingCubes::m_CubeVertices[nIndex0][2]*(1-t) + CMarchingCubes::m_CubeVertices[nIndex1][2]*t)*m_fVoxelSize;
+
+					ComputeNormal(slab, vertex);
+					slab.vertices.push_back(vertex);
+				}
+
+				// Add the edge's vertex index to the index list
+				slab.indices.push_back(EdgeIndices[nEdge]);
+			}
+		}
+	}
+}
+
+//=============================================================================
+void CMetaballsPolygonizer::ComputeNormal(const SSlab &slab, SMetaballVertex &vertex) const
+{
+	// To compute the normal we derive the energy formula and get
+	//
+	//   n += 2 * mass * vector / distance^4
+	glm::vec3 n(0.0f);
+	const int numBalls = (int)slab.ballX.size();
+#ifdef METABALLS_USE_SSE
+	__m128 nx = _mm_setzero_ps(), ny = _mm_setzero_ps(), nz = _mm_setzero_ps();
+	const __m128 vx = _mm_set1_ps(vertex.position.x);
+	const __m128 vy = _mm_set1_ps(vertex.position.y);
+	const __m128 vz = _mm_set1_ps(vertex.position.z);
+	const __m128 two = _mm_set1_ps(2.0f);
+	for( int i = 0; i < numBalls; i += 4 )
+	{
+		__m128 x = _mm_sub_ps(vx, _mm_loadu_ps(&slab.ballX[i]));
+		__m128 y = _mm_sub_ps(vy, _mm_loadu_ps(&slab.ballY[i]));
+		__m128 z = _mm_sub_ps(vz, _mm_loadu_ps(&slab.ballZ[i]));
+		__m128 fSqDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 f = _mm_mul_ps(_mm_mul_ps(two, _mm_loadu_ps(&slab.ballMass[i])), Reciprocal(_mm_mul_ps(fSqDist, fSqDist)));
+		nx = _mm_add_ps(nx, _mm_mul_ps(f, x));
+		ny = _mm_add_ps(ny, _mm_mul_ps(f, y));
+		nz = _mm_add_ps(nz, _mm_mul_ps(f, z));
+	}
+	float sx[4], sy[4], sz[4];
+	_mm_storeu_ps(sx, nx);
+	_mm_storeu_ps(sy, ny);
+	_mm_storeu_ps(sz, nz);
+	n = glm::vec3(sx[0]+sx[1]+sx[2]+sx[3], sy[0]+sy[1]+sy[2]+sy[3], sz[0]+sz[1]+sz[2]+sz[3]);
+#else
+	for( int i = 0; i < numBalls; i++ )
+	{
+		glm::vec3 d = vertex.position - glm::vec3(slab.ballX[i], slab.ballY[i], slab.ballZ[i]);
+		float fSqDist = glm::dot(d, d);
+		n += 2 * slab.ballMass[i] * d / (fSqDist * fSqDist);
+	}
+#endif
+
+	// Compute the sphere-map texture coordinate
+	// Note: The normal used here should be transformed to camera space first
+	// for correct result. In this application no transformation is needed
+	// since the camera is fixed.
+	vertex.texture = glm::vec2(n.x/2 + 0.5f, -n.y/2 + 0.5f);
+
+	float fLength = glm::length(n);
+	vertex.normal = fLength > 0 ? n/fLength : glm::vec3(0, 1, 0);
+}
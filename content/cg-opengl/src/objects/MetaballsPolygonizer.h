@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef METABALLSPOLYGONIZER_H
+#define METABALLSPOLYGONIZER_H
+
+#include "MarchingCubes.h"
+#include "../utilities/ThreadPool.h"
+
+struct SBall
+{
+	float p[3]; // position
+	float v[3]; // vertex
+	float a[3];
+	float t;
+	float m;
+};
+
+// interleaved the way CMetaballs feeds the vertex attributes: position, texture, normal
+struct SMetaballVertex
+{
+    glm::vec3 position;
+    glm::vec2 texture;
+    glm::vec3 normal;
+};
+
+// Builds the metaball isosurface on the CPU without any OpenGL calls.
+// The energy grid is split into slabs along z which are evaluated in
+// parallel, eight grid points at a time (two SSE registers), only against the balls whose
+// bounding box reaches the row. The marching cubes pass then runs per
+// slab into per slab buffers which are finally merged into one vertex
+// and index array. All buffers are kept between frames and only grow.
+class CMetaballsPolygonizer
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CMetaballsPolygonizer(const unsigned int &threadCount = 0);
+    ~CMetaballsPolygonizer();
+
+    void SetGridSize(const int &nSize);
+
+    ///A ball is skipped where its energy drops below tolerance * level / numberOfBalls,
+    ///so the total error stays below tolerance * level. 0 evaluates every ball everywhere.
+    void SetCullTolerance(const float &tolerance);
+
+    void Polygonize(const SBall *pBalls, const int &numberOfBalls, const float &level);
+
+    const std::vector<SMetaballVertex> &GetVertices() const { return m_vertices; }
+    const std::vector<GLuint> &GetIndices() const { return m_indices; }
+    int GetGridSize() const { return m_nGridSize; }
+    float GetVoxelSize() const { return m_fVoxelSize; }
+    unsigned int GetThreadCount() const { return m_pool.GetThreadCount() + 1; }
+
+private:
+    struct SSlab
+    {
+        int z0, z1;
+        std::vector<SMetaballVertex> vertices;
+        std::vector<GLuint> indices;
+        // balls reaching into this slab, padded like the ball arrays below
+        std::vector<float> ballX, ballY, ballZ, ballMass;
+    };
+
+    void  PrepareBalls(const SBall *pBalls, const int &numberOfBalls, const float &level);
+    void  ComputeEnergyPlane(int z);
+    void  CollectSlabBalls(SSlab &slab) const;
+    void  PolygonizeSlab(SSlab &slab, const float &level);
+    void  ComputeNormal(const SSlab &slab, SMetaballVertex &vertex) const;
+
+    float ConvertGridPointToWorldCoordinate(int x) const { return float(x)*m_fVoxelSize - 1.0f; }
+
+    int    m_nGridSize;
+    float  m_fVoxelSize;
+    float  m_fCullTolerance;
+
+    std::vector<float> m_gridEnergy;
+
+    // balls as structure of arrays, padded to a multiple of four with massless balls
+    int                m_nNumBalls;
+    std::vector<float> m_ballX, m_ballY, m_ballZ, m_ballMass, m_ballRadiusSq;
+
+    std::vector<SSlab> m_slabs;
+
+    std::vector<SMetaballVertex> m_vertices;
+    std::vector<GLuint> m_indices;
+
+    CThreadPool m_pool;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef ProceduralMesh_h
+#define ProceduralMesh_h
+
+#include <vector>
+
+#include "../ObjectsBase.h"
+#include "../utilities/procedural_mesh.h"
+
+// Generates a procedural_mesh shape as interleaved Vertex data, the layout of the
+// vertex attributes 0 to 4, with 32 bit indices of counter-clockwise triangles.
+template<typename Shape>
+void GenerateProceduralMesh(const Shape &shape, std::vector<Vertex> &vertices, std::vector<GLuint> &indices)
+{
+    const procedural_mesh::counts counts = procedural_mesh::count(shape);
+    vertices.resize(counts.Vertices);
+    indices.resize(counts.Indices);
+
+    procedural_mesh::buffers buffers;
+    buffers.Position = &vertices[0].position.x;
+    buffers.PositionStride = sizeof(Vertex);
+    buffers.TexCoord = &vertices[0].texture.x;
+    buffers.TexCoordStride = sizeof(Vertex);
+    buffers.Normal = &vertices[0].normal.x;
+    buffers.NormalStride = sizeof(Vertex);
+    buffers.Tangent = &vertices[0].tangent.x;
+    buffers.TangentStride = sizeof(Vertex);
+    buffers.Bitangent = &vertices[0].bitangent.x;
+    buffers.BitangentStride = sizeof(Vertex);
+    buffers.Indices = &indices[0];
+    buffers.IndexSize = sizeof(GLuint);
+    procedural_mesh::generate(shape, buffers);
+}
+
+#endif /* ProceduralMesh_h */
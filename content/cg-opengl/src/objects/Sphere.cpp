@@ -4,6 +4,7 @@
 
 // http://www.songho.ca/opengl/gl_sphere.html
 #include "Sphere.h"
+#include "ProceduralMesh.h"
 
 CSphere::CSphere()
 {
@@ -44,89 +45,21 @@ void CSphere::Create(const std::string &directory, const std::map<std::string, T
 	m_vbo.Create();
 	m_vbo.Bind();
     
-    // http://www.songho.ca/opengl/gl_sphere.html
-	// Compute vertex attributes and store in VBO
-	int vertexCount = 0;
-	for (int stacks = 0; stacks < stacksIn; stacks++) {
-		float phi = (stacks / (float) (stacksIn - 1)) * (float) M_PI;
-		for (int slices = 0; slices <= slicesIn; slices++) {
-			float theta = (slices / (float) slicesIn) * ((float)M_PI * 2);
-			
-            glm::vec3 v = glm::vec3(cos(theta) * sin(phi), sin(theta) * sin(phi), cos(phi));
-			glm::vec2 t = glm::vec2((float)slices / (float) slicesIn, (float)stacks / (float) stacksIn);
-			glm::vec3 n = v;
-            
-            vertices.push_back(v);
-            uvs.push_back(t);
-            normals.push_back(n);
-            
-			vertexCount++;
-            //cout << "stacks: " << stacks << ", slices: " << slices << endl;
-		}
-	}
-    
-    for (long unsigned i = 0; i < vertexCount; i+=2) {
-        // triangle
-        glm::vec3 v0 = vertices[i+0];
-        glm::vec3 v1 = vertices[i+1 % vertexCount];
-        
-        // triangle UVs
-        glm::vec2 & uv0 = uvs[i+0];
-        glm::vec2 & uv1 = uvs[i+1 % vertexCount];
-        
-        // triangle Normals
-        glm::vec3 & norm0 = normals[i+0];
-        glm::vec3 & norm1 = normals[i+1 % vertexCount];
-        
-        // calculate tangent/bitangent vectors of both triangles
-        glm::vec3 tangent, bitangent;
-        
-        float coef = 1.0f / (uv0.x * uv1.y - uv1.x * uv0.y);
-        tangent.x = coef * ((v0.x * uv1.y) + (v1.x * -uv0.y));
-        tangent.y = coef * ((v0.y * uv1.y) + (v1.y * -uv0.y));
-        tangent.z = coef * ((v0.z * uv1.y) + (v1.z * -uv0.y));
-        tangent = glm::normalize(tangent);
-        bitangent = glm::normalize(glm::cross(norm0, tangent));
-        
-        m_vbo.AddVertexData(&v0, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&uv0, sizeof(glm::vec2));
-        m_vbo.AddVertexData(&norm0, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&tangent, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&bitangent, sizeof(glm::vec3));
-        
-        bitangent = glm::normalize(glm::cross(norm1, tangent));
-        
-        m_vbo.AddVertexData(&v1, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&uv1, sizeof(glm::vec2));
-        m_vbo.AddVertexData(&norm1, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&tangent, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&bitangent, sizeof(glm::vec3));
+    // Indexed vertices shared by the triangles around them, with tangents and bitangents
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    GenerateProceduralMesh(procedural_mesh::uv_sphere(1.0f, slicesIn, stacksIn), vertices, indices);
+
+    // procedural_mesh starts u at +y and puts v = 1 at the north pole, the
+    // textures of this sphere start at +x and have v = 0 at the north pole
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i].texture = glm::vec2(vertices[i].texture.s + 0.25f, 1.0f - vertices[i].texture.t);
+        vertices[i].bitangent = -vertices[i].bitangent;
     }
-    
-    
-	// Compute indices and store in VBO
-	m_numTriangles = 0;
-	for (int stacks = 0; stacks < stacksIn; stacks++) {
-		for (int slices = 0; slices < slicesIn; slices++) {
-			unsigned int nextSlice = slices + 1;
-			unsigned int nextStack = (stacks + 1) % stacksIn;
-
-			unsigned int index0 = stacks * (slicesIn+1) + slices;
-			unsigned int index1 = nextStack * (slicesIn+1) + slices;
-			unsigned int index2 = stacks * (slicesIn+1) + nextSlice;
-			unsigned int index3 = nextStack * (slicesIn+1) + nextSlice;
-
-			m_vbo.AddIndexData(&index0, sizeof(unsigned int));
-			m_vbo.AddIndexData(&index1, sizeof(unsigned int));
-			m_vbo.AddIndexData(&index2, sizeof(unsigned int));
-			m_numTriangles++;
 
-			m_vbo.AddIndexData(&index2, sizeof(unsigned int));
-			m_vbo.AddIndexData(&index1, sizeof(unsigned int));
-			m_vbo.AddIndexData(&index3, sizeof(unsigned int));
-			m_numTriangles++;
-		}
-	}
+    m_vbo.AddVertexData(&vertices[0], (uint)(vertices.size() * sizeof(Vertex)));
+    m_vbo.AddIndexData(&indices[0], (uint)(indices.size() * sizeof(GLuint)));
+    m_numTriangles = (GLint)(indices.size() / 3);
 
 	m_vbo.UploadDataToGPU(GL_STATIC_DRAW);
 
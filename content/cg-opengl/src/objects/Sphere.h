@@ -24,9 +24,5 @@ private:
     std::map<std::string, TextureType> m_textureNames;
     std::vector<CTexture*> m_textures;
     
-    // inputs
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec3> normals;
 	GLint m_numTriangles;
 };
@@ -0,0 +1,189 @@
+#include "TerrainMeshGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_USE_SSE
+#endif
+
+namespace {
+    // rows per band, fixed so that the bands do not depend on the number of threads
+    const unsigned int BAND_ROWS = 32;
+
+    inline glm::vec3 NormalFromDifferences(const float &dx, const float &dz)
+    {
+        return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+    }
+
+    template <typename T>
+    void FillIndices(T *indices, const unsigned int &width, const unsigned int &z0, const unsigned int &z1)
+    {
+        // same winding as the heightmap terrain: (i, i+X+Z, i+X) and (i, i+Z, i+X+Z)
+        const T X = 1;
+        const T Z = (T)width;
+        for (unsigned int z = z0; z < z1; ++z) {
+            for (unsigned int x = 0; x + 1 < width; ++x) {
+                T index = (T)(x + z * width);
+                *indices++ = index;
+                *indices++ = index + X + Z;
+                *indices++ = index + X;
+                *indices++ = index;
+                *indices++ = index + Z;
+                *indices++ = index + X + Z;
+            }
+        }
+    }
+}
+
+CTerrainMeshGenerator::CTerrainMeshGenerator(const unsigned int &threadCount):
+    m_use16BitIndices(false), m_pool(threadCount)
+{
+    memset(&m_layout, 0, sizeof(m_layout));
+}
+
+CTerrainMeshGenerator::~CTerrainMeshGenerator()
+{
+    Release();
+}
+
+void CTerrainMeshGenerator::Release()
+{
+    std::vector<STerrainVertex>().swap(m_vertices);
+    std::vector<uint16_t>().swap(m_indices16);
+    std::vector<uint32_t>().swap(m_indices32);
+    memset(&m_layout, 0, sizeof(m_layout));
+}
+
+const void *CTerrainMeshGenerator::GetIndexData() const
+{
+    if (m_use16BitIndices) {
+        return m_indices16.empty() ? nullptr : m_indices16.data();
+    }
+    return m_indices32.empty() ? nullptr : m_indices32.data();
+}
+
+void CTerrainMeshGenerator::ComputeNormalRow(const float *above, const float *row, const float *below, const unsigned int &count,
+                                             const float &scaleX, const float &scaleZ, glm::vec3 *normals, const size_t &normalStride)
+{
+    char *output = (char*)normals;
+    unsigned int x = 0;
+
+#ifdef TERRAIN_USE_SSE
+    const __m128 sx = _mm_set1_ps(scaleX);
+    const __m128 sz = _mm_set1_ps(scaleZ);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threeHalves = _mm_set1_ps(1.5f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    float nx[4], ny[4], nz[4];
+    for (; x + 4 <= count; x += 4) {
+        __m128 dx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + 1), _mm_loadu_ps(row + x - 1)), sx);
+        __m128 dz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(below + x), _mm_loadu_ps(above + x)), sz);
+
+        // 1/|(-dx, 1, -dz)| from the estimate and one Newton-Raphson step
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)), one);
+        __m128 r = _mm_rsqrt_ps(lengthSq);
+        r = _mm_mul_ps(r, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, lengthSq), _mm_mul_ps(r, r))));
+
+        _mm_storeu_ps(nx, _mm_xor_ps(_mm_mul_ps(dx, r), sign));
+        _mm_storeu_ps(ny, r);
+        _mm_storeu_ps(nz, _mm_xor_ps(_mm_mul_ps(dz, r), sign));
+        for (int i = 0; i < 4; ++i) {
+            *(glm::vec3*)(output + (x + i) * normalStride) = glm::vec3(nx[i], ny[i], nz[i]);
+        }
+    }
+#endif
+
+    for (; x < count; ++x) {
+        *(glm::vec3*)(output + x * normalStride) = NormalFromDifferences((row[x + 1] - row[x - 1]) * scaleX, (below[x] - above[x]) * scaleZ);
+    }
+}
+
+CTerrainMeshGenerator::SLayout CTerrainMeshGenerator::MakeLayout(const unsigned int &width, const unsigned int &height,
+                                                                 const glm::vec3 &origin, const glm::vec3 &spacing, const float &textureScale)
+{
+    SLayout layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.width = width;
+    layout.height = height;
+    for (int i = 0; i < 3; ++i) {
+        layout.origin[i] = origin[i];
+        layout.spacing[i] = spacing[i];
+    }
+    layout.textureScale = textureScale;
+    return layout;
+}
+
+void CTerrainMeshGenerator::BuildRows(const float *heights, const unsigned int &z0, const unsigned int &z1)
+{
+    const unsigned int width = m_layout.width;
+    const unsigned int height = m_layout.height;
+    const glm::vec3 origin(m_layout.origin[0], m_layout.origin[1], m_layout.origin[2]);
+    const glm::vec3 spacing(m_layout.spacing[0], m_layout.spacing[1], m_layout.spacing[2]);
+    // central differences span two samples; at the borders the missing neighbour is clamped
+    const float scaleX = spacing.y / (2.0f * spacing.x);
+    const float scaleZ = spacing.y / (2.0f * spacing.z);
+
+    for (unsigned int z = z0; z < z1; ++z) {
+        const float *row = heights + (size_t)z * width;
+        const float *above = heights + (size_t)(z > 0 ? z - 1 : 0) * width;
+        const float *below = heights + (size_t)(z + 1 < height ? z + 1 : z) * width;
+        STerrainVertex *vertices = &m_vertices[(size_t)z * width];
+
+        for (unsigned int x = 0; x < width; ++x) {
+            vertices[x].position = origin + spacing * glm::vec3((float)x, row[x], (float)z);
+            vertices[x].texture = glm::vec2(vertices[x].position.x, vertices[x].position.z) * m_layout.textureScale;
+        }
+
+        if (width > 2) {
+            ComputeNormalRow(above + 1, row + 1, below + 1, width - 2, scaleX, scaleZ, &vertices[1].normal, sizeof(STerrainVertex));
+        }
+        vertices[0].normal = NormalFromDifferences((row[std::min(1u, width - 1)] - row[0]) * scaleX, (below[0] - above[0]) * scaleZ);
+        if (width > 1) {
+            unsigned int last = width - 1;
+            vertices[last].normal = NormalFromDifferences((row[last] - row[last - 1]) * scaleX, (below[last] - above[last]) * scaleZ);
+        }
+
+        // the quads between this row and the next one
+        if (z + 1 < height && width > 1) {
+            size_t first = (size_t)z * (width - 1) * 6;
+            if (m_use16BitIndices) {
+                FillIndices(&m_indices16[first], width, z, z + 1);
+            } else {
+                FillIndices(&m_indices32[first], width, z, z + 1);
+            }
+        }
+    }
+}
+
+void CTerrainMeshGenerator::Generate(const float *heights, const unsigned int &width, const unsigned int &height,
+                                     const glm::vec3 &origin, const glm::vec3 &spacing, const float &textureScale)
+{
+    Release();
+    if (heights == nullptr || width == 0 || height == 0) {
+        return;
+    }
+
+    m_layout = MakeLayout(width, height, origin, spacing, textureScale);
+
+    // half the index memory (and bandwidth) whenever every vertex can be addressed with 16 bits
+    size_t vertexCount = (size_t)width * height;
+    size_t indexCount = (size_t)(width - 1) * (height - 1) * 6;
+    m_use16BitIndices = vertexCount <= 65536;
+    m_vertices.resize(vertexCount);
+    if (m_use16BitIndices) {
+        m_indices16.resize(indexCount);
+    } else {
+        m_indices32.resize(indexCount);
+    }
+
+    // every band writes its own rows of vertices and quads, nothing has to be merged afterwards
+    const unsigned int bands = (height + BAND_ROWS - 1) / BAND_ROWS;
+    m_pool.ParallelFor(bands, [&](unsigned int band) {
+        unsigned int z0 = band * BAND_ROWS;
+        BuildRows(heights, z0, std::min(z0 + BAND_ROWS, height));
+    });
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef TerrainMeshGenerator_h
+#define TerrainMeshGenerator_h
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../utilities/ThreadPool.h"
+
+// interleaved like the first three attributes of Vertex: position, texture, normal
+struct STerrainVertex
+{
+    glm::vec3 position;
+    glm::vec2 texture;
+    glm::vec3 normal;
+};
+
+// Turns a grid of height samples into a triangle mesh without any OpenGL
+// calls. The rows are split into bands that are built in parallel, normals
+// come from central differences evaluated four samples at a time, and the
+// indices are 16 bit whenever the vertex count allows it.
+// There is no mesh cache on disk: reading back the interleaved vertices takes
+// longer than generating them again from the heights.
+class CTerrainMeshGenerator
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CTerrainMeshGenerator(const unsigned int &threadCount = 0);
+    ~CTerrainMeshGenerator();
+
+    ///heights holds width x height samples, one row of width samples after the other. Sample (x, z) becomes the vertex
+    ///origin + spacing * (x, heights[x + z * width], z), textured with its x/z position times textureScale.
+    void Generate(const float *heights, const unsigned int &width, const unsigned int &height,
+                  const glm::vec3 &origin, const glm::vec3 &spacing, const float &textureScale);
+
+    void Release();
+
+    ///Normals of count samples of one row from central differences, with above and below the rows at z - 1 and z + 1.
+    ///row[-1] and row[count] must be readable. The result is written every normalStride bytes starting at normals.
+    static void ComputeNormalRow(const float *above, const float *row, const float *below, const unsigned int &count,
+                                 const float &scaleX, const float &scaleZ, glm::vec3 *normals, const size_t &normalStride);
+
+    const std::vector<STerrainVertex> &GetVertices() const { return m_vertices; }
+    unsigned int GetIndexSize() const { return m_use16BitIndices ? 2 : 4; }
+    size_t GetIndexCount() const { return m_use16BitIndices ? m_indices16.size() : m_indices32.size(); }
+    const void *GetIndexData() const;
+    const std::vector<uint16_t> &GetIndices16() const { return m_indices16; }
+    const std::vector<uint32_t> &GetIndices32() const { return m_indices32; }
+    unsigned int GetThreadCount() const { return m_pool.GetThreadCount() + 1; }
+
+private:
+    struct SLayout
+    {
+        uint32_t width, height;
+        float origin[3], spacing[3];
+        float textureScale;
+    };
+
+    static SLayout MakeLayout(const unsigned int &width, const unsigned int &height,
+                              const glm::vec3 &origin, const glm::vec3 &spacing, const float &textureScale);
+    void BuildRows(const float *heights, const unsigned int &z0, const unsigned int &z1);
+
+    SLayout m_layout;
+    bool m_use16BitIndices;
+    std::vector<STerrainVertex> m_vertices;
+    std::vector<uint16_t> m_indices16;
+    std::vector<uint32_t> m_indices32;
+
+    CThreadPool m_pool;
+};
+
+#endif /* TerrainMeshGenerator_h */
@@ -0,0 +1,256 @@
+#include "TerrainQuadtree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+CTerrainQuadtree::CTerrainQuadtree():
+    m_chunksX(0), m_chunksZ(0), m_chunkQuads(0), m_lodCount(1),
+    m_origin(0.0f), m_chunkSize(1.0f), m_lodDistance(1.0f), m_minHeight(0.0f), m_maxHeight(0.0f)
+{}
+
+CTerrainQuadtree::~CTerrainQuadtree()
+{
+    Release();
+}
+
+void CTerrainQuadtree::Create(const unsigned int &chunksX, const unsigned int &chunksZ, const unsigned int &chunkQuads,
+                              const glm::vec2 &origin, const glm::vec2 &chunkSize, const std::vector<glm::vec2> &heightRanges)
+{
+    Release();
+
+    m_chunksX = chunksX;
+    m_chunksZ = chunksZ;
+    m_chunkQuads = chunkQuads;
+    m_origin = origin;
+    m_chunkSize = chunkSize;
+
+    // every level doubles the vertex step, as long as the step still divides the chunk
+    // and the coarsest level keeps at least two quads per side for the stitching
+    m_lodCount = 1;
+    while ((1u << m_lodCount) < m_chunkQuads && m_chunkQuads % (1u << m_lodCount) == 0) {
+        ++m_lodCount;
+    }
+
+    m_chunkMin.resize(GetChunkCount());
+    m_chunkMax.resize(GetChunkCount());
+    m_minHeight = GetChunkCount() > 0 ? heightRanges[0].x : 0.0f;
+    m_maxHeight = GetChunkCount() > 0 ? heightRanges[0].y : 0.0f;
+    for (unsigned int z = 0; z < m_chunksZ; ++z) {
+        for (unsigned int x = 0; x < m_chunksX; ++x) {
+            unsigned int chunk = x + z * m_chunksX;
+            glm::vec2 corner = m_origin + m_chunkSize * glm::vec2((float)x, (float)z);
+            m_chunkMin[chunk] = glm::vec3(corner.x, heightRanges[chunk].x, corner.y);
+            m_chunkMax[chunk] = glm::vec3(corner.x + m_chunkSize.x, heightRanges[chunk].y, corner.y + m_chunkSize.y);
+            m_minHeight = std::min(m_minHeight, heightRanges[chunk].x);
+            m_maxHeight = std::max(m_maxHeight, heightRanges[chunk].y);
+        }
+    }
+
+    if (GetChunkCount() > 0) {
+        m_nodes.reserve(GetChunkCount() * 4 / 3 + 1);
+        BuildNode(0, 0, m_chunksX, m_chunksZ);
+    }
+
+    SetLodDistance(m_lodDistance);
+}
+
+void CTerrainQuadtree::Release()
+{
+    m_chunkMin.clear();
+    m_chunkMax.clear();
+    m_nodes.clear();
+    m_chunksX = m_chunksZ = 0;
+}
+
+void CTerrainQuadtree::SetLodDistance(const float &distance)
+{
+    // Two neighbouring chunks are one chunk apart, so their distances to the camera differ by at most
+    // one chunk size. With the level floor(log2(1 + d / lodDistance)) and lodDistance >= chunk size the
+    // ratio (1 + d2 / lodDistance) / (1 + d1 / lodDistance) stays below two, hence at most one level apart.
+    m_lodDistance = std::max(distance, std::max(m_chunkSize.x, m_chunkSize.y));
+}
+
+int CTerrainQuadtree::BuildNode(unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1)
+{
+    int index = (int)m_nodes.size();
+    m_nodes.push_back(SNode());
+
+    SNode node;
+    node.x0 = x0; node.z0 = z0; node.x1 = x1; node.z1 = z1;
+    std::fill(node.children, node.children + 4, -1);
+
+    if (x1 - x0 == 1 && z1 - z0 == 1) {
+        unsigned int chunk = x0 + z0 * m_chunksX;
+        node.min = m_chunkMin[chunk];
+        node.max = m_chunkMax[chunk];
+    } else {
+        // split the range in half along each axis that is still wider than one chunk
+        unsigned int xm = x1 - x0 > 1 ? (x0 + x1) / 2 : x1;
+        unsigned int zm = z1 - z0 > 1 ? (z0 + z1) / 2 : z1;
+        const unsigned int ranges[4][4] = {
+            { x0, z0, xm, zm }, { xm, z0, x1, zm }, { x0, zm, xm, z1 }, { xm, zm, x1, z1 }
+        };
+
+        node.min = glm::vec3(std::numeric_limits<float>::max());
+        node.max = glm::vec3(-std::numeric_limits<float>::max());
+        for (unsigned int i = 0; i < 4; ++i) {
+            if (ranges[i][0] == ranges[i][2] || ranges[i][1] == ranges[i][3]) {
+                continue;
+            }
+            int child = BuildNode(ranges[i][0], ranges[i][1], ranges[i][2], ranges[i][3]);
+            node.children[i] = child;
+            node.min = glm::min(node.min, m_nodes[child].min);
+            node.max = glm::max(node.max, m_nodes[child].max);
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+unsigned int CTerrainQuadtree::ChunkLod(const unsigned int &chunk, const glm::vec3 &cameraPosition) const
+{
+    // horizontal distance to the chunk, combined with the height of the camera above (or below)
+    // the whole terrain; the height term is shared by all chunks so the one level rule still holds
+    const glm::vec3 &min = m_chunkMin[chunk];
+    const glm::vec3 &max = m_chunkMax[chunk];
+    float dx = std::max(std::max(min.x - cameraPosition.x, cameraPosition.x - max.x), 0.0f);
+    float dz = std::max(std::max(min.z - cameraPosition.z, cameraPosition.z - max.z), 0.0f);
+    float dy = std::max(std::max(m_minHeight - cameraPosition.y, cameraPosition.y - m_maxHeight), 0.0f);
+    float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    int lod = std::ilogb(1.0f + distance / m_lodDistance);
+    return (unsigned int)std::min(lod, (int)m_lodCount - 1);
+}
+
+void CTerrainQuadtree::Select(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection,
+                              std::vector<STerrainChunkSelection> &selection) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // frustum planes straight from the rows of the view projection matrix (Gribb & Hartmann),
+    // a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    };
+
+    SelectNode(0, planes, false, cameraPosition, selection);
+}
+
+void CTerrainQuadtree::SelectNode(const int &nodeIndex, const glm::vec4 *planes, const bool &inside, const glm::vec3 &cameraPosition,
+                                  std::vector<STerrainChunkSelection> &selection) const
+{
+    const SNode &node = m_nodes[nodeIndex];
+    bool contained = inside;
+
+    // once a node is completely inside the frustum its whole subtree is, so the tests are skipped
+    if (!contained) {
+        contained = true;
+        for (int i = 0; i < 6; ++i) {
+            const glm::vec4 &plane = planes[i];
+            // the box corner furthest along the plane normal decides whether the box is outside,
+            // the nearest corner whether it is completely inside
+            glm::vec3 outer(plane.x >= 0.0f ? node.max.x : node.min.x,
+                            plane.y >= 0.0f ? node.max.y : node.min.y,
+                            plane.z >= 0.0f ? node.max.z : node.min.z);
+            glm::vec3 inner(plane.x >= 0.0f ? node.min.x : node.max.x,
+                            plane.y >= 0.0f ? node.min.y : node.max.y,
+                            plane.z >= 0.0f ? node.min.z : node.max.z);
+            if (glm::dot(glm::vec3(plane), outer) + plane.w < 0.0f) {
+                return;
+            }
+            if (glm::dot(glm::vec3(plane), inner) + plane.w < 0.0f) {
+                contained = false;
+            }
+        }
+    }
+
+    if (node.children[0] < 0 && node.children[1] < 0 && node.children[2] < 0 && node.children[3] < 0) {
+        SelectChunk(node.x0 + node.z0 * m_chunksX, cameraPosition, selection);
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        if (node.children[i] >= 0) {
+            SelectNode(node.children[i], planes, contained, cameraPosition, selection);
+        }
+    }
+}
+
+void CTerrainQuadtree::SelectChunk(const unsigned int &chunk, const glm::vec3 &cameraPosition, std::vector<STerrainChunkSelection> &selection) const
+{
+    unsigned int x = chunk % m_chunksX;
+    unsigned int z = chunk / m_chunksX;
+    unsigned int lod = ChunkLod(chunk, cameraPosition);
+
+    // the neighbours may be culled themselves, their level is a function of the distance only
+    // so the shared edge is stitched the same way whether the neighbour is drawn or not
+    unsigned int edgeMask = 0;
+    if (lod + 1 < m_lodCount) {
+        if (x > 0 && ChunkLod(chunk - 1, cameraPosition) > lod)
+            edgeMask |= TERRAIN_EDGE_NEGATIVE_X;
+        if (x + 1 < m_chunksX && ChunkLod(chunk + 1, cameraPosition) > lod)
+            edgeMask |= TERRAIN_EDGE_POSITIVE_X;
+        if (z > 0 && ChunkLod(chunk - m_chunksX, cameraPosition) > lod)
+            edgeMask |= TERRAIN_EDGE_NEGATIVE_Z;
+        if (z + 1 < m_chunksZ && ChunkLod(chunk + m_chunksX, cameraPosition) > lod)
+            edgeMask |= TERRAIN_EDGE_POSITIVE_Z;
+    }
+
+    STerrainChunkSelection selected;
+    selected.chunk = chunk;
+    selected.lod = (unsigned char)lod;
+    selected.edgeMask = (unsigned char)edgeMask;
+    selection.push_back(selected);
+}
+
+void CTerrainQuadtree::BuildIndexPattern(const unsigned int &lod, const unsigned int &edgeMask, std::vector<unsigned int> &indices) const
+{
+    indices.clear();
+    const int n = (int)m_chunkQuads;
+    const int step = 1 << lod;
+    const int X = 1;
+    const int Z = n + 1;
+
+    // On an edge shared with a coarser chunk every odd vertex of this level is moved onto the
+    // preceding even one. The two cells next to it then fan out from the even vertex and the
+    // edge becomes the single straight segment the coarser neighbour draws; the collapsed
+    // triangles are dropped.
+    auto snap = [&](int x, int z) {
+        if ((edgeMask & TERRAIN_EDGE_NEGATIVE_Z) && z == 0 && (x / step) % 2 == 1) x -= step;
+        if ((edgeMask & TERRAIN_EDGE_POSITIVE_Z) && z == n && (x / step) % 2 == 1) x -= step;
+        if ((edgeMask & TERRAIN_EDGE_NEGATIVE_X) && x == 0 && (z / step) % 2 == 1) z -= step;
+        if ((edgeMask & TERRAIN_EDGE_POSITIVE_X) && x == n && (z / step) % 2 == 1) z -= step;
+        return (unsigned int)(x * X + z * Z);
+    };
+    auto triangle = [&](unsigned int a, unsigned int b, unsigned int c) {
+        if (a == b || b == c || a == c) {
+            return;
+        }
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    };
+
+    indices.reserve((n / step) * (n / step) * 6);
+    // same winding as the full resolution terrain mesh
+    for (int z = 0; z < n; z += step) {
+        for (int x = 0; x < n; x += step) {
+            unsigned int a = snap(x, z);
+            unsigned int b = snap(x + step, z);
+            unsigned int c = snap(x, z + step);
+            unsigned int d = snap(x + step, z + step);
+            triangle(a, d, b);
+            triangle(a, c, d);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef TerrainQuadtree_h
+#define TerrainQuadtree_h
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// which side of a chunk borders a coarser neighbour, used to pick the stitched index pattern
+enum TerrainChunkEdge
+{
+    TERRAIN_EDGE_NEGATIVE_X = 1,
+    TERRAIN_EDGE_POSITIVE_X = 2,
+    TERRAIN_EDGE_NEGATIVE_Z = 4,
+    TERRAIN_EDGE_POSITIVE_Z = 8
+};
+
+struct STerrainChunkSelection
+{
+    unsigned int chunk;         // chunk index, x + z * chunksX
+    unsigned char lod;          // vertex step is 1 << lod
+    unsigned char edgeMask;     // TerrainChunkEdge bits of coarser neighbours
+};
+
+// CPU side of the chunked terrain, it never calls OpenGL.
+// The heightmap is cut into square chunks of chunkQuads x chunkQuads quads
+// (chunkQuads + 1 vertices per side) and a quadtree with a bounding box per
+// node is built over the chunk grid. Every frame the tree is culled against
+// the view frustum and each visible chunk gets a level of detail from its
+// distance to the camera. Each level halves the vertex density, neighbours
+// never differ by more than one level, and the side facing a coarser
+// neighbour drops its odd vertices so that no cracks open between chunks.
+class CTerrainQuadtree
+{
+public:
+    CTerrainQuadtree();
+    ~CTerrainQuadtree();
+
+    ///Builds the tree over chunksX x chunksZ chunks. heightRanges holds (min, max) height per chunk,
+    ///origin is the minimum x/z corner of the terrain and chunkSize the x/z extent of one chunk.
+    void Create(const unsigned int &chunksX, const unsigned int &chunksZ, const unsigned int &chunkQuads,
+                const glm::vec2 &origin, const glm::vec2 &chunkSize, const std::vector<glm::vec2> &heightRanges);
+    void Release();
+
+    ///Distance covered by the finest level, every further level covers twice the distance of the previous one.
+    ///Clamped to the chunk size so that neighbouring chunks never differ by more than one level.
+    void SetLodDistance(const float &distance);
+    float GetLodDistance() const { return m_lodDistance; }
+
+    ///Culls the tree against the frustum of viewProjection and appends the visible chunks with
+    ///their level of detail and stitching mask to selection. Both are given in terrain space.
+    void Select(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection,
+                std::vector<STerrainChunkSelection> &selection) const;
+
+    ///Level of detail of a chunk seen from the camera, also used for chunks that are culled.
+    unsigned int ChunkLod(const unsigned int &chunk, const glm::vec3 &cameraPosition) const;
+
+    ///Indices into a chunk's (chunkQuads + 1)^2 vertex grid for one level of detail and stitching mask.
+    void BuildIndexPattern(const unsigned int &lod, const unsigned int &edgeMask, std::vector<unsigned int> &indices) const;
+
+    unsigned int GetChunksX() const { return m_chunksX; }
+    unsigned int GetChunksZ() const { return m_chunksZ; }
+    unsigned int GetChunkCount() const { return m_chunksX * m_chunksZ; }
+    unsigned int GetChunkQuads() const { return m_chunkQuads; }
+    unsigned int GetLodCount() const { return m_lodCount; }
+    unsigned int GetNodeCount() const { return (unsigned int)m_nodes.size(); }
+    glm::vec3 GetChunkMin(const unsigned int &chunk) const { return m_chunkMin[chunk]; }
+    glm::vec3 GetChunkMax(const unsigned int &chunk) const { return m_chunkMax[chunk]; }
+
+private:
+    struct SNode
+    {
+        glm::vec3 min, max;
+        unsigned int x0, z0, x1, z1;    // covered chunk range [x0, x1) x [z0, z1)
+        int children[4];                // -1 for missing children, all -1 at a leaf
+    };
+
+    int  BuildNode(unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1);
+    void SelectNode(const int &node, const glm::vec4 *planes, const bool &inside, const glm::vec3 &cameraPosition,
+                    std::vector<STerrainChunkSelection> &selection) const;
+    void SelectChunk(const unsigned int &chunk, const glm::vec3 &cameraPosition, std::vector<STerrainChunkSelection> &selection) const;
+
+    unsigned int m_chunksX, m_chunksZ, m_chunkQuads, m_lodCount;
+    glm::vec2 m_origin, m_chunkSize;
+    float m_lodDistance;
+    float m_minHeight, m_maxHeight;
+
+    std::vector<glm::vec3> m_chunkMin, m_chunkMax;
+    std::vector<SNode> m_nodes;
+};
+
+#endif /* TerrainQuadtree_h */
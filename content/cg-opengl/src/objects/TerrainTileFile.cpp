@@ -0,0 +1,197 @@
+#include "TerrainTileFile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace {
+    const char TILE_FILE_MAGIC[4] = { 'C', 'G', 'T', 'T' };
+    const uint32_t TILE_FILE_VERSION = 2;
+
+    struct STileFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t width, height;
+        uint32_t chunkQuads;
+        uint32_t chunksX, chunksZ;
+        float heightMin, heightMax;     // quantization range of every record
+    };
+
+    // record: the quantized samples
+    std::streamoff RecordSize(const unsigned int &chunkQuads)
+    {
+        std::streamoff side = chunkQuads + 3;
+        return side * side * sizeof(uint16_t);
+    }
+}
+
+CTerrainTileFile::CTerrainTileFile():
+    m_width(0), m_height(0), m_chunkQuads(0), m_chunksX(0), m_chunksZ(0), m_heightMin(0.0f), m_heightMax(0.0f),
+    m_recordsOffset(0)
+{}
+
+CTerrainTileFile::~CTerrainTileFile()
+{
+    Close();
+}
+
+unsigned int CTerrainTileFile::ChunkCount(const unsigned int &samples, const unsigned int &chunkQuads)
+{
+    if (samples < 2 || chunkQuads == 0) {
+        return 1;
+    }
+    return (samples - 1 + chunkQuads - 1) / chunkQuads;
+}
+
+void CTerrainTileFile::ExtractChunk(const float *heights, const unsigned int &width, const unsigned int &height,
+                                    const unsigned int &chunkQuads, const unsigned int &chunk, std::vector<float> &samples)
+{
+    const unsigned int chunksX = ChunkCount(width, chunkQuads);
+    const int side = (int)chunkQuads + 3;
+    const int x0 = (int)((chunk % chunksX) * chunkQuads) - 1;
+    const int z0 = (int)((chunk / chunksX) * chunkQuads) - 1;
+
+    samples.resize(side * side);
+    for (int z = 0; z < side; ++z) {
+        int sz = std::min(std::max(z0 + z, 0), (int)height - 1);
+        const float *row = heights + (size_t)sz * width;
+        for (int x = 0; x < side; ++x) {
+            int sx = std::min(std::max(x0 + x, 0), (int)width - 1);
+            samples[x + z * side] = row[sx];
+        }
+    }
+}
+
+bool CTerrainTileFile::Write(const char *filename, const float *heights, const unsigned int &width, const unsigned int &height,
+                             const unsigned int &chunkQuads)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || heights == nullptr || width == 0 || height == 0 || chunkQuads == 0) {
+        return false;
+    }
+
+    STileFileHeader header;
+    memcpy(header.magic, TILE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TILE_FILE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.chunkQuads = chunkQuads;
+    header.chunksX = ChunkCount(width, chunkQuads);
+    header.chunksZ = ChunkCount(height, chunkQuads);
+    const unsigned int chunkCount = header.chunksX * header.chunksZ;
+    const float *heightsEnd = heights + (size_t)width * height;
+    header.heightMin = *std::min_element(heights, heightsEnd);
+    header.heightMax = *std::max_element(heights, heightsEnd);
+
+    // the range table is only known once every chunk has been seen, it is filled in at the end
+    std::vector<glm::vec2> ranges(chunkCount);
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)ranges.data(), chunkCount * sizeof(glm::vec2));
+
+    const unsigned int side = chunkQuads + 3;
+    const float scale = header.heightMax > header.heightMin ? 65535.0f / (header.heightMax - header.heightMin) : 0.0f;
+    std::vector<float> samples;
+    std::vector<uint16_t> quantized(side * side);
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk) {
+        ExtractChunk(heights, width, height, chunkQuads, chunk, samples);
+
+        // the quadtree range covers the chunk itself, without the apron
+        glm::vec2 range(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+        for (unsigned int z = 1; z < side - 1; ++z) {
+            for (unsigned int x = 1; x < side - 1; ++x) {
+                float h = samples[x + z * side];
+                range.x = std::min(range.x, h);
+                range.y = std::max(range.y, h);
+            }
+        }
+        ranges[chunk] = range;
+
+        for (unsigned int i = 0; i < side * side; ++i) {
+            quantized[i] = (uint16_t)((samples[i] - header.heightMin) * scale + 0.5f);
+        }
+
+        file.write((const char*)quantized.data(), quantized.size() * sizeof(uint16_t));
+    }
+
+    file.seekp(sizeof(header));
+    file.write((const char*)ranges.data(), chunkCount * sizeof(glm::vec2));
+    return file.good();
+}
+
+bool CTerrainTileFile::Open(const char *filename)
+{
+    Close();
+
+    m_file.open(filename, std::ios::binary);
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    STileFileHeader header;
+    m_file.read((char*)&header, sizeof(header));
+    if (!m_file.good() || memcmp(header.magic, TILE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != TILE_FILE_VERSION
+        || header.chunksX != ChunkCount(header.width, header.chunkQuads) || header.chunksZ != ChunkCount(header.height, header.chunkQuads)) {
+        std::cout << "Invalid terrain tile file " << filename << std::endl;
+        Close();
+        return false;
+    }
+
+    m_width = header.width;
+    m_height = header.height;
+    m_chunkQuads = header.chunkQuads;
+    m_chunksX = header.chunksX;
+    m_chunksZ = header.chunksZ;
+    m_heightMin = header.heightMin;
+    m_heightMax = header.heightMax;
+
+    m_heightRanges.resize(m_chunksX * m_chunksZ);
+    m_file.read((char*)m_heightRanges.data(), m_heightRanges.size() * sizeof(glm::vec2));
+    m_recordsOffset = m_file.tellg();
+    if (!m_file.good()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void CTerrainTileFile::Close()
+{
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+    m_heightRanges.clear();
+    m_width = m_height = m_chunkQuads = m_chunksX = m_chunksZ = 0;
+    m_heightMin = m_heightMax = 0.0f;
+}
+
+bool CTerrainTileFile::ReadChunk(const unsigned int &chunk, std::vector<float> &samples) const
+{
+    if (chunk >= m_heightRanges.size()) {
+        return false;
+    }
+
+    const unsigned int side = m_chunkQuads + 3;
+    std::vector<uint16_t> quantized(side * side);
+    {
+        // one shared stream, only the seek and the read are serialized; decoding runs in parallel
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_file.seekg(m_recordsOffset + chunk * RecordSize(m_chunkQuads));
+        m_file.read((char*)quantized.data(), quantized.size() * sizeof(uint16_t));
+        if (!m_file.good()) {
+            m_file.clear();
+            return false;
+        }
+    }
+
+    // the same code decodes every record, so equal samples give bit identical heights
+    const float scale = (m_heightMax - m_heightMin) / 65535.0f;
+    samples.resize(side * side);
+    for (unsigned int i = 0; i < side * side; ++i) {
+        samples[i] = m_heightMin + quantized[i] * scale;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef TerrainTileFile_h
+#define TerrainTileFile_h
+
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Preprocessed heightmap cut into the chunks of CTerrainQuadtree so that a
+// terrain far larger than memory can be streamed a chunk at a time.
+//
+// Layout: a header, the (min, max) height of every chunk for building the
+// quadtree without touching the samples, then one fixed size record per
+// chunk. A record holds the (chunkQuads + 3)^2 samples of the chunk plus a
+// one sample apron (for normals that match across chunk borders), quantized
+// to 16 bits between the minimum and maximum height of the whole file, so a
+// sample shared by neighbouring chunks decodes to the same height in both.
+class CTerrainTileFile
+{
+public:
+    CTerrainTileFile();
+    ~CTerrainTileFile();
+
+    ///Writes width x height heights (row major, z rows of x samples) as a tile file.
+    static bool Write(const char *filename, const float *heights, const unsigned int &width, const unsigned int &height,
+                      const unsigned int &chunkQuads);
+
+    ///Copies the samples of one chunk plus apron out of a full heightmap, clamped at the borders.
+    static void ExtractChunk(const float *heights, const unsigned int &width, const unsigned int &height,
+                             const unsigned int &chunkQuads, const unsigned int &chunk, std::vector<float> &samples);
+
+    ///Number of chunks needed along a side of the given number of samples.
+    static unsigned int ChunkCount(const unsigned int &samples, const unsigned int &chunkQuads);
+
+    bool Open(const char *filename);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    ///Decodes the samples of one chunk, including the apron. Safe to call from several threads.
+    bool ReadChunk(const unsigned int &chunk, std::vector<float> &samples) const;
+
+    unsigned int GetWidth() const { return m_width; }
+    unsigned int GetHeight() const { return m_height; }
+    unsigned int GetChunkQuads() const { return m_chunkQuads; }
+    unsigned int GetChunksX() const { return m_chunksX; }
+    unsigned int GetChunksZ() const { return m_chunksZ; }
+    const std::vector<glm::vec2> &GetHeightRanges() const { return m_heightRanges; }
+
+private:
+    unsigned int m_width, m_height, m_chunkQuads, m_chunksX, m_chunksZ;
+    float m_heightMin, m_heightMax;
+    std::vector<glm::vec2> m_heightRanges;
+    std::streamoff m_recordsOffset;
+
+    mutable std::ifstream m_file;
+    mutable std::mutex m_mutex;
+};
+
+#endif /* TerrainTileFile_h */
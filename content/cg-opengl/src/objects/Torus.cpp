@@ -1,5 +1,6 @@
 
 #include "Torus.h"
+#include "ProceduralMesh.h"
 
 //https://stackoverflow.com/questions/7966362/how-to-draw-a-textured-torus-in-opengl-without-using-glut
 //https://www.opengl.org/archives/resources/code/samples/redbook/torus.c
@@ -54,107 +55,17 @@ void CTorus::Create(const std::string &directory, const std::map<std::string, Te
     m_vbo.Create();
     m_vbo.Bind();
     
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> texCoords;
-    std::vector<glm::vec3> normals;
-    // outputs
-    std::vector<glm::vec3> tangents;
-    std::vector<glm::vec3> bitangents;
-    std::vector<glm::vec3> binormals;
-    
-    int i, j, k;
-    
-    static const float sTexCoord[3] = { 2.0, 0, 0 };
-    static const float tTexCoord[3] = { 0, 1.0, 0 };
-   
-    float x, y, z;      // POSITION
-    float nx, ny, nz;   // NORMAL
-    float tx, ty, tz;   // TANGENT
-    float bx, by, bz;   // BINORMAL
-    float s, t;         // TEXCOORD
-    float u, v;          //  U V
-    float cu, su;       // COS And SIN  U 
-    float cv, sv;       // COS And SIN  V
-    float twopi = 2.0f * glm::pi <float> (); 
-    
-    
-    for (i = 0; i < radialSeg; i++) {
-        for (j = 0; j <= circularSeg; j++) {
-            for (k = 1; k >= 0; k--) {
-                
-                /*
-                s = (i + k) % radialSeg + 0.5f; 
-                t = j % (circularSeg + 1); 
-                
-                x = (radius + tick * cos(s * twopi/radialSeg)) * cos( t * twopi / circularSeg);
-                y = (radius + tick * cos(s * twopi/radialSeg)) * sin( t * twopi / circularSeg);
-                z = tick * sin(s * twopi / radialSeg);
-                */
-                
-                u = (j % (circularSeg + 1)) / (float) circularSeg;
-                v = (i + k) / (float) radialSeg ;
-              
-                cu = cos( u * twopi ); //cos u
-                su = sin( u * twopi ); //sin u
-                cv = cos( v * twopi ); //con v
-                sv = sin( v * twopi ); //sin v
-            
-                // Position
-                x = ( outerRadius + innerRadius * cv ) * cu;
-                y = ( outerRadius + innerRadius * cv ) * su;
-                z = innerRadius * sv;
-                
-                // Normal
-                nx = cu * cv;
-                ny = su * cv;
-                nz = sv;
-                
-                // Tangent
-                tx = ( outerRadius + innerRadius * cv ) * -su;
-                ty = ( outerRadius + innerRadius * cv ) * cu;
-                tz = 0.0f;
-                
-                // Binormal
-                bx = -cu * sv;
-                by = -su * cv;
-                bz = cv;
-                
-                // U, V texture mapping
-                s = ( u * sTexCoord[0] ) + ( v * sTexCoord[1] );
-                t = ( v * tTexCoord[0] ) + ( v * tTexCoord[1] );
-                
-                //s = (i + k) % radialSeg + 0.5f; 
-                //t = j % (circularSeg + 1); 
-                
-                glm::vec3 vert = glm::vec3(x,y,z);
-                glm::vec2 uv = glm::vec2(s,t);
-                glm::vec3 norm = glm::vec3(nx, ny, nz );
-                glm::vec3 tan = glm::vec3(tx, ty, tz );
-                glm::vec3 biNorm = glm::vec3(bx, by, bz  );//glm::cross(norm, tan);
-                glm::vec3 biTan = glm::cross(norm, tan);
-                
-                vertices.push_back(vert);
-                texCoords.push_back(uv);
-                normals.push_back(norm);
-                tangents.push_back(tan);
-                binormals.push_back(biNorm);
-                bitangents.push_back(biTan);
-                
-            }
-        }
-    }
-    
-    m_numTriangles = vertices.size();
-    
+    // Indexed vertices shared by the triangles around them, u twice around the ring
+    procedural_mesh::torus torus(outerRadius, innerRadius, circularSeg, radialSeg);
+    torus.UScale = 2.0f;
 
-    for (int i = 0; i < m_numTriangles; i++) {
-        m_vbo.AddData(&vertices[i], sizeof(glm::vec3));
-        m_vbo.AddData(&texCoords[i], sizeof(glm::vec2));
-        m_vbo.AddData(&normals[i], sizeof(glm::vec3));
-        m_vbo.AddData(&tangents[i], sizeof(glm::vec3));
-        m_vbo.AddData(&bitangents[i], sizeof(glm::vec3));
-    }
-   
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    GenerateProceduralMesh(torus, vertices, indices);
+
+    m_vbo.AddVertexData(&vertices[0], (uint)(vertices.size() * sizeof(Vertex)));
+    m_vbo.AddIndexData(&indices[0], (uint)(indices.size() * sizeof(GLuint)));
+    m_numIndices = (GLuint)indices.size();
     
     m_vbo.UploadDataToGPU(GL_STATIC_DRAW);
     
@@ -199,7 +110,7 @@ void CTorus::Render(const GLboolean &useTexture)
             m_textures[i]->BindTexture2DToTextureType();
         }
     }
-    glDrawArrays( GL_TRIANGLE_STRIP, 0, m_numTriangles ); // draw the vertixes
+    glDrawElements(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, 0);
     
 }
 
@@ -27,8 +27,8 @@ public:
     void Release();
     
 private:
-    GLuint m_vao, m_numTriangles;
-    CVertexBufferObject m_vbo;
+    GLuint m_vao, m_numIndices;
+    CVertexBufferObjectIndexed m_vbo;
     
     std::map<std::string, TextureType> m_textureNames;
     std::vector<CTexture*> m_textures;
@@ -10,6 +10,7 @@
 // https://www.researchgate.net/publication/51910231_Electromagnetic_Torus_Knots
 
 #include "TorusKnot.h"
+#include "ProceduralMesh.h"
 
 CTorusKnot::CTorusKnot()
 {
@@ -107,244 +108,25 @@ void CTorusKnot:: Create(const std::string &directory,
     m_vbo.Create();
     m_vbo.Bind();
     
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec2> texCoords;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec3> tangents;
-    std::vector<glm::vec3> bitangents;
-    
-    int i, j;
-    aThickness *= aScale;
-    long double pi2 = glm::two_pi<double>();
-    
-    GLfloat *vtx      = new GLfloat[((aSteps + 1) * (aFacets + 1) + 1) * 3];
-    GLfloat *normal   = new GLfloat[((aSteps + 1) * (aFacets + 1) + 1) * 3];
-    GLfloat *texcoord = new GLfloat[((aSteps + 1) * (aFacets + 1) + 1) * 2];
-    GLuint  *torusIndices      = new GLuint[(aSteps + 1) * aFacets * 2];
-    
-    m_numIndices = (aSteps + 1) * aFacets * 2;
-    m_numVertices = ((aSteps + 1) * (aFacets + 1) + 1);
-    {
-        for (j = 0; j < aFacets; j++)
-        {
-            for (i = 0; i < aSteps + 1; i++)
-            {
-                torusIndices[i * 2 + 0 + j * (aSteps + 1) * 2] = ((j + 1) + i * (aFacets + 1));
-                torusIndices[i * 2 + 1 + j * (aSteps + 1) * 2] = (j + i * (aFacets + 1));
-            }
-        }
-        
-        
-        for (i = 0; i < aSteps; i++)
-        {
-            long double centerpoint[3];
-            long double Pp = aP * (double)i * pi2 / aSteps;
-            long double Qp = aQ * (double)i * pi2 / aSteps;
-            long double r = (.5f * (2 + (double)sin(Qp))) * aScale;
-            
-            centerpoint[0] = r * (double)cos(Pp);
-            centerpoint[1] = r * (double)cos(Qp);
-            centerpoint[2] = r * (double)sin(Pp);
-            
-            float nextpoint[3];
-            Pp = aP * (i + 1) * pi2 / aSteps;
-            Qp = aQ * (i + 1) * pi2 / aSteps;
-            r = (.5f * (2 + (double)sin(Qp))) * aScale;
-            nextpoint[0] = r * (double)cos(Pp);
-            nextpoint[1] = r * (double)cos(Qp);
-            nextpoint[2] = r * (double)sin(Pp);
-            
-            long double T[3];
-            T[0] = nextpoint[0] - centerpoint[0];
-            T[1] = nextpoint[1] - centerpoint[1];
-            T[2] = nextpoint[2] - centerpoint[2];
-            
-            long double N[3];
-            N[0] = nextpoint[0] + centerpoint[0];
-            N[1] = nextpoint[1] + centerpoint[1];
-            N[2] = nextpoint[2] + centerpoint[2];
-            
-            
-            long double B[3];
-            B[0] = T[1]*N[2] - T[2]*N[1];
-            B[1] = T[2]*N[0] - T[0]*N[2];
-            B[2] = T[0]*N[1] - T[1]*N[0];
-            
-            N[0] = B[1]*T[2] - B[2]*T[1];
-            N[1] = B[2]*T[0] - B[0]*T[2];
-            N[2] = B[0]*T[1] - B[1]*T[0];
-            
-            long double l;
-            l = (double)sqrt(B[0] * B[0] + B[1] * B[1] + B[2] * B[2]);
-            B[0] /= l;
-            B[1] /= l;
-            B[2] /= l;
-            
-            l = (double)sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
-            N[0] /= l;
-            N[1] /= l;
-            N[2] /= l;
-            
-            for (j = 0; j < aFacets; j++)
-            {
-                
-                long double pointx = (double)sin(j * pi2 / aFacets) * aThickness * (((double)sin(aClumpOffset + aClumps * i * pi2 / aSteps) * aClumpScale) + 1);
-                long double pointy = (double)cos(j * pi2 / aFacets) * aThickness * (((double)cos(aClumpOffset + aClumps * i * pi2 / aSteps) * aClumpScale) + 1);
-                
-                vtx[i * (aFacets + 1) * 3 + j * 3 + 0] = N[0] * pointx + B[0] * pointy + centerpoint[0];
-                vtx[i * (aFacets + 1) * 3 + j * 3 + 1] = N[1] * pointx + B[1] * pointy + centerpoint[1];
-                vtx[i * (aFacets + 1) * 3 + j * 3 + 2] = N[2] * pointx + B[2] * pointy + centerpoint[2];
-                
-                normal[i * (aFacets + 1) * 3 + j * 3 + 0] = vtx[i * (aFacets + 1) * 3 + j * 3 + 0] - centerpoint[0];
-                normal[i * (aFacets + 1) * 3 + j * 3 + 1] = vtx[i * (aFacets + 1) * 3 + j * 3 + 1] - centerpoint[1];
-                normal[i * (aFacets + 1) * 3 + j * 3 + 2] = vtx[i * (aFacets + 1) * 3 + j * 3 + 2] - centerpoint[2];
-                
-                long double l;
-                l = (double)sqrt(normal[i * (aFacets + 1) * 3 + j * 3 + 0] * normal[i * (aFacets + 1) * 3 + j * 3 + 0] +
-                                normal[i * (aFacets + 1) * 3 + j * 3 + 1] * normal[i * (aFacets + 1) * 3 + j * 3 + 1] +
-                                normal[i * (aFacets + 1) * 3 + j * 3 + 2] * normal[i * (aFacets + 1) * 3 + j * 3 + 2]);
-                
-                texcoord[i * (aFacets + 1) * 2 + j * 2 + 0] = ((double)j / aFacets) * aUScale;
-                texcoord[i * (aFacets + 1) * 2 + j * 2 + 1] = ((double)i / aSteps) * aVScale;
-          
-                glm::vec3 v = glm::vec3(vtx[    i * (aFacets + 1) * 3 + j * 3 + 0],
-                                        vtx[    i * (aFacets + 1) * 3 + j * 3 + 1],
-                                        vtx[    i * (aFacets + 1) * 3 + j * 3 + 2]);
-                glm::vec2 t = glm::vec2(texcoord[i * (aFacets + 1) * 2 + j * 2 + 0],
-                                        texcoord[i * (aFacets + 1) * 2 + j * 2 + 1]);
-                glm::vec3 n = glm::vec3(normal[  i * (aFacets + 1) * 3 + j * 3 + 0],
-                                        normal[  i * (aFacets + 1) * 3 + j * 3 + 1],
-                                        normal[  i * (aFacets + 1) * 3 + j * 3 + 2]);
-                positions.push_back(v);
-                texCoords.push_back(t);
-                normals.push_back(n);
-                
-                normal[i * (aFacets + 1) * 3 + j * 3 + 0] /= l;
-                normal[i * (aFacets + 1) * 3 + j * 3 + 1] /= l;
-                normal[i * (aFacets + 1) * 3 + j * 3 + 2] /= l;
-            }
-            // create duplicate vertex for sideways wrapping
-            // otherwise identical to first vertex in the 'ring' except for the U coordinate
-            vtx[i * (aFacets + 1) * 3 + aFacets * 3 + 0] = vtx[i * (aFacets + 1) * 3 + 0];
-            vtx[i * (aFacets + 1) * 3 + aFacets * 3 + 1] = vtx[i * (aFacets + 1) * 3 + 1];
-            vtx[i * (aFacets + 1) * 3 + aFacets * 3 + 2] = vtx[i * (aFacets + 1) * 3 + 2];
-            
-            normal[i * (aFacets + 1) * 3 + aFacets * 3 + 0] = normal[i * (aFacets + 1) * 3 + 0];
-            normal[i * (aFacets + 1) * 3 + aFacets * 3 + 1] = normal[i * (aFacets + 1) * 3 + 1];
-            normal[i * (aFacets + 1) * 3 + aFacets * 3 + 2] = normal[i * (aFacets + 1) * 3 + 2];
-            
-            texcoord[i * (aFacets + 1) * 2 + aFacets * 2 + 0] = aUScale;
-            texcoord[i * (aFacets + 1) * 2 + aFacets * 2 + 1] = texcoord[i * (aFacets + 1) * 2 + 1];
-      
-            glm::vec3 v = glm::vec3(vtx[    i * (aFacets + 1) * 3 + aFacets * 3 + 0],
-                                    vtx[    i * (aFacets + 1) * 3 + aFacets * 3 + 1],
-                                    vtx[    i * (aFacets + 1) * 3 + aFacets * 3 + 2]);
-            glm::vec2 t = glm::vec2(texcoord[i * (aFacets + 1) * 2 + aFacets * 2 + 0],
-                                    texcoord[i * (aFacets + 1) * 2 + aFacets * 2 + 1]);
-            glm::vec3 n = glm::vec3(normal[  i * (aFacets + 1) * 3 + aFacets * 3 + 0],
-                                    normal[  i * (aFacets + 1) * 3 + aFacets * 3 + 1],
-                                    normal[  i * (aFacets + 1) * 3 + aFacets * 3 + 2]);
-            
-            positions.push_back(v);
-            texCoords.push_back(t);
-            normals.push_back(n);
-            
-        }
-        
-        // create duplicate ring of vertices for longways wrapping
-        // otherwise identical to first 'ring' in the knot except for the V coordinate
-        for (j = 0; j < aFacets; j++)
-        {
-            vtx[aSteps * (aFacets + 1) * 3 + j * 3 + 0] = vtx[j * 3 + 0];
-            vtx[aSteps * (aFacets + 1) * 3 + j * 3 + 1] = vtx[j * 3 + 1];
-            vtx[aSteps * (aFacets + 1) * 3 + j * 3 + 2] = vtx[j * 3 + 2];
-            
-            normal[aSteps * (aFacets + 1) * 3 + j * 3 + 0] = normal[j * 3 + 0];
-            normal[aSteps * (aFacets + 1) * 3 + j * 3 + 1] = normal[j * 3 + 1];
-            normal[aSteps * (aFacets + 1) * 3 + j * 3 + 2] = normal[j * 3 + 2];
-            
-            texcoord[aSteps * (aFacets + 1) * 2 + j * 2 + 0] = texcoord[j * 2 + 0];
-            texcoord[aSteps * (aFacets + 1) * 2 + j * 2 + 1] = aVScale;
-            
-            positions.push_back( glm::vec3(vtx[    aSteps * (aFacets + 1) * 3 + j * 3 + 0], 
-                                           vtx[    aSteps * (aFacets + 1) * 3 + j * 3 + 1],
-                                           vtx[    aSteps * (aFacets + 1) * 3 + j * 3 + 2]));
-                                         
-            texCoords.push_back( glm::vec2(texcoord[aSteps * (aFacets + 1) * 2 + j * 2 + 0],
-                                          texcoord[aSteps * (aFacets + 1) * 2 + j * 2 + 1])); 
-            normals.push_back(glm::vec3(normal[  aSteps * (aFacets + 1) * 3 + j * 3 + 0],
-                                        normal[  aSteps * (aFacets + 1) * 3 + j * 3 + 1],
-                                        normal[  aSteps * (aFacets + 1) * 3 + j * 3 + 2]));
-                                        
-        }
-        
-        // finally, there's one vertex that needs to be duplicated due to both U and V coordinate.
-        vtx[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 0] = vtx[0];
-        vtx[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 1] = vtx[1];
-        vtx[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 2] = vtx[2];
-        
-        normal[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 0] = normal[0];
-        normal[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 1] = normal[1];
-        normal[aSteps * (aFacets + 1) * 3 + aFacets * 3 + 2] = normal[2];
-        
-        texcoord[aSteps * (aFacets + 1) * 2 + aFacets * 2 + 0] = aUScale;
-        texcoord[aSteps * (aFacets + 1) * 2 + aFacets * 2 + 1] = aVScale;
-        
-        positions.push_back( glm::vec3(vtx[    aSteps * (aFacets + 1) * 3 + aFacets * 3 + 0], 
-                                                      vtx[    aSteps * (aFacets + 1) * 3 + aFacets * 3 + 1], 
-                                       vtx[    aSteps * (aFacets + 1) * 3 + aFacets * 3 + 2])); 
-        texCoords.push_back( glm::vec2(texcoord[aSteps * (aFacets + 1) * 2 + aFacets * 2 + 0],
-                                     texcoord[aSteps * (aFacets + 1) * 2 + aFacets * 2 + 1])); 
-        normals.push_back(glm::vec3(normal[  aSteps * (aFacets + 1) * 3 + aFacets * 3 + 0],
-                                     normal[  aSteps * (aFacets + 1) * 3 + aFacets * 3 + 1],
-                                     normal[  aSteps * (aFacets + 1) * 3 + aFacets * 3 + 2]));
-        
-    }
-    
-    // http://fabiensanglard.net/bumpMapping/index.php
-    //for(long unsigned int i = 0; i < m_numVertices; i++)
-    for (long unsigned i = 0; i < m_numVertices; i+=2) {
-        // triangle
-        glm::vec3 v0 = positions[i+0];
-        glm::vec3 v1 = positions[i+1 % m_numVertices];
-        
-        // triangle UVs
-        glm::vec2 & uv0 = texCoords[i+0];
-        glm::vec2 & uv1 = texCoords[i+1 % m_numVertices];
-        
-        // triangle Normals
-        glm::vec3 & norm0 = normals[i+0];
-        glm::vec3 & norm1 = normals[i+1 % m_numVertices];
-        
-        glm::vec3 tangent, bitangent;
-        
-        float coef = 1.0f / (uv0.x * uv1.y - uv1.x * uv0.y);
-        tangent.x = coef * ((v0.x * uv1.y) + (v1.x * -uv0.y));
-        tangent.y = coef * ((v0.y * uv1.y) + (v1.y * -uv0.y));
-        tangent.z = coef * ((v0.z * uv1.y) + (v1.z * -uv0.y));
-        tangent = glm::normalize(tangent);
-        bitangent = glm::normalize(glm::cross(norm0, tangent));
-        
-        m_vbo.AddVertexData(&v0, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&uv0, sizeof(glm::vec2));
-        m_vbo.AddVertexData(&norm0, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&tangent, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&bitangent, sizeof(glm::vec3));
-        
-        bitangent = glm::normalize(glm::cross(norm1, tangent));
-        
-        m_vbo.AddVertexData(&v1, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&uv1, sizeof(glm::vec2));
-        m_vbo.AddVertexData(&norm1, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&tangent, sizeof(glm::vec3));
-        m_vbo.AddVertexData(&bitangent, sizeof(glm::vec3));
-    }
-    
-    for(unsigned int i = 0; i < m_numIndices; i++)
-    {
-        unsigned int index = torusIndices[i];
-        m_vbo.AddIndexData(&index, sizeof(unsigned int));
-    }
+    // Indexed vertices shared by the triangles around them, a seam of duplicated
+    // vertices around the tube and along the curve carries the texture coordinates
+    procedural_mesh::torus_knot knot(aSteps, aFacets, aP, aQ);
+    knot.Scale = aScale;
+    knot.Thickness = aThickness;
+    knot.Clumps = aClumps;
+    knot.ClumpOffset = aClumpOffset;
+    knot.ClumpScale = aClumpScale;
+    knot.UScale = aUScale;
+    knot.VScale = aVScale;
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    GenerateProceduralMesh(knot, vertices, indices);
+
+    m_vbo.AddVertexData(&vertices[0], (uint)(vertices.size() * sizeof(Vertex)));
+    m_vbo.AddIndexData(&indices[0], (uint)(indices.size() * sizeof(GLuint)));
+    m_numVertices = (GLuint)vertices.size();
+    m_numIndices = (GLuint)indices.size();
     
     m_vbo.UploadDataToGPU(GL_STATIC_DRAW);
     
@@ -392,7 +174,7 @@ void CTorusKnot::Render(const GLboolean &useTexture)
         }
     }
     
-    glDrawElements(GL_TRIANGLE_STRIP, m_numIndices, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, 0);
 }
 
 // Release memory on the GPU 
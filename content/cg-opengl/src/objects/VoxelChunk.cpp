@@ -0,0 +1,155 @@
+#include "VoxelChunk.h"
+
+#include <algorithm>
+
+CVoxelChunk::CVoxelChunk()
+{
+    Release();
+}
+
+CVoxelChunk::~CVoxelChunk()
+{
+}
+
+void CVoxelChunk::Release()
+{
+    m_palette.assign(1, 0);
+    std::vector<uint64_t>().swap(m_indices);
+    m_bits = 0;
+    m_edited = false;
+}
+
+// powers of two only, so that the entries of a word never cross into the next one
+unsigned int CVoxelChunk::BitsFor(const size_t &paletteSize)
+{
+    unsigned int bits = 0;
+    while (((size_t)1 << bits) < paletteSize) {
+        bits = bits == 0 ? 1 : bits * 2;
+    }
+    return bits;
+}
+
+VoxelBlock CVoxelChunk::GetIndex(const unsigned int &index) const
+{
+    if (m_bits == 0) {
+        return m_palette[0];
+    }
+    const unsigned int bit = index * m_bits;
+    const uint64_t mask = ((uint64_t)1 << m_bits) - 1;
+    return m_palette[(m_indices[bit >> 6] >> (bit & 63)) & mask];
+}
+
+unsigned int CVoxelChunk::FindOrAdd(const VoxelBlock &block)
+{
+    for (unsigned int i = 0; i < m_palette.size(); ++i) {
+        if (m_palette[i] == block) {
+            return i;
+        }
+    }
+    m_palette.push_back(block);
+    if (m_palette.size() > ((size_t)1 << m_bits)) {
+        Repack(BitsFor(m_palette.size()));
+    }
+    return (unsigned int)m_palette.size() - 1;
+}
+
+void CVoxelChunk::Set(const unsigned int &x, const unsigned int &y, const unsigned int &z, const VoxelBlock &block)
+{
+    if (m_bits == 0 && m_palette[0] == block) {
+        return;
+    }
+    const unsigned int entry = FindOrAdd(block);
+    m_edited = true;
+    const unsigned int bit = Index(x, y, z) * m_bits;
+    const uint64_t mask = ((uint64_t)1 << m_bits) - 1;
+    uint64_t &word = m_indices[bit >> 6];
+    word = (word & ~(mask << (bit & 63))) | ((uint64_t)entry << (bit & 63));
+}
+
+void CVoxelChunk::Pack(const VoxelBlock *paletteIndices, const unsigned int &bits)
+{
+    m_bits = bits;
+    if (bits == 0) {
+        std::vector<uint64_t>().swap(m_indices);
+        return;
+    }
+
+    const unsigned int perWord = 64 / bits;
+    m_indices.assign(VOLUME / perWord, 0);
+    m_indices.shrink_to_fit();
+    for (unsigned int word = 0; word < m_indices.size(); ++word) {
+        const VoxelBlock *entries = paletteIndices + word * perWord;
+        uint64_t packed = 0;
+        for (unsigned int i = 0; i < perWord; ++i) {
+            packed |= (uint64_t)entries[i] << (i * bits);
+        }
+        m_indices[word] = packed;
+    }
+}
+
+void CVoxelChunk::Repack(const unsigned int &bits)
+{
+    std::vector<VoxelBlock> paletteIndices(VOLUME, 0);
+    if (m_bits != 0) {
+        const uint64_t mask = ((uint64_t)1 << m_bits) - 1;
+        for (unsigned int i = 0; i < VOLUME; ++i) {
+            const unsigned int bit = i * m_bits;
+            paletteIndices[i] = (VoxelBlock)((m_indices[bit >> 6] >> (bit & 63)) & mask);
+        }
+    }
+    Pack(paletteIndices.data(), bits);
+}
+
+void CVoxelChunk::Fill(const VoxelBlock *blocks)
+{
+    // terrain comes in long runs of the same type, so the last hit is tried before the palette search
+    std::vector<VoxelBlock> paletteIndices(VOLUME);
+    m_palette.assign(1, blocks[0]);
+    unsigned int last = 0;
+    for (unsigned int i = 0; i < VOLUME; ++i) {
+        if (blocks[i] != m_palette[last]) {
+            last = (unsigned int)(std::find(m_palette.begin(), m_palette.end(), blocks[i]) - m_palette.begin());
+            if (last == m_palette.size()) {
+                m_palette.push_back(blocks[i]);
+            }
+        }
+        paletteIndices[i] = (VoxelBlock)last;
+    }
+    m_palette.shrink_to_fit();
+    Pack(paletteIndices.data(), BitsFor(m_palette.size()));
+    m_edited = false;
+}
+
+void CVoxelChunk::Decompress(VoxelBlock *blocks) const
+{
+    if (m_bits == 0) {
+        std::fill(blocks, blocks + VOLUME, m_palette[0]);
+        return;
+    }
+
+    const unsigned int perWord = 64 / m_bits;
+    const uint64_t mask = ((uint64_t)1 << m_bits) - 1;
+    for (unsigned int word = 0; word < m_indices.size(); ++word) {
+        uint64_t packed = m_indices[word];
+        VoxelBlock *entries = blocks + word * perWord;
+        for (unsigned int i = 0; i < perWord; ++i, packed >>= m_bits) {
+            entries[i] = m_palette[packed & mask];
+        }
+    }
+}
+
+void CVoxelChunk::Compact()
+{
+    if (!m_edited || m_bits == 0) {
+        m_edited = false;
+        return;
+    }
+    std::vector<VoxelBlock> blocks(VOLUME);
+    Decompress(blocks.data());
+    Fill(blocks.data());
+}
+
+size_t CVoxelChunk::GetMemoryUsage() const
+{
+    return sizeof(*this) + m_palette.capacity() * sizeof(VoxelBlock) + m_indices.capacity() * sizeof(uint64_t);
+}
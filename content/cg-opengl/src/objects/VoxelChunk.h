@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef VoxelChunk_h
+#define VoxelChunk_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// block type of one voxel, 0 is air and everything else is an opaque block
+typedef uint16_t VoxelBlock;
+
+// A cube of SIZE^3 blocks stored palette compressed: the distinct block types
+// of the chunk are kept in a palette and every block is an index into it,
+// packed with 0, 1, 2, 4, 8 or 16 bits depending on the palette size. A chunk
+// of a single type (all air, all stone) holds no indices at all. Blocks are
+// ordered x fastest, then y, then z. No OpenGL calls are made.
+class CVoxelChunk
+{
+public:
+    static const unsigned int SIZE = 32;
+    static const unsigned int VOLUME = SIZE * SIZE * SIZE;
+
+    CVoxelChunk();
+    ~CVoxelChunk();
+
+    static unsigned int Index(const unsigned int &x, const unsigned int &y, const unsigned int &z) { return x + SIZE * (y + SIZE * z); }
+
+    VoxelBlock Get(const unsigned int &x, const unsigned int &y, const unsigned int &z) const { return GetIndex(Index(x, y, z)); }
+    VoxelBlock GetIndex(const unsigned int &index) const;
+
+    ///Grows the palette and repacks the indices when the block type is new to the chunk. Types that are no longer
+    ///used stay in the palette until Compact.
+    void Set(const unsigned int &x, const unsigned int &y, const unsigned int &z, const VoxelBlock &block);
+
+    ///Replaces the whole chunk with VOLUME blocks in Index order, with the smallest palette.
+    void Fill(const VoxelBlock *blocks);
+    ///Writes the VOLUME blocks of the chunk to blocks in Index order.
+    void Decompress(VoxelBlock *blocks) const;
+    ///Drops the palette entries no block refers to any more and repacks the indices with as few bits as possible.
+    ///Does nothing unless Set has overwritten a block since the last Fill or Compact.
+    void Compact();
+    void Release();
+
+    ///True when every block is air, the mesher skips those chunks.
+    bool IsEmpty() const { return m_bits == 0 && m_palette[0] == 0; }
+    ///True when every block is the same type.
+    bool IsUniform() const { return m_bits == 0; }
+    unsigned int GetBitsPerBlock() const { return m_bits; }
+    unsigned int GetPaletteSize() const { return (unsigned int)m_palette.size(); }
+    ///Bytes held by the chunk, the object itself included.
+    size_t GetMemoryUsage() const;
+
+private:
+    unsigned int FindOrAdd(const VoxelBlock &block);
+    void Pack(const VoxelBlock *paletteIndices, const unsigned int &bits);
+    void Repack(const unsigned int &bits);
+    static unsigned int BitsFor(const size_t &paletteSize);
+
+    std::vector<VoxelBlock> m_palette;
+    std::vector<uint64_t> m_indices;    // m_bits bits per block, an entry never straddles two words
+    unsigned int m_bits;
+    bool m_edited;                      // a block was overwritten, the palette may hold unused entries
+};
+
+#endif /* VoxelChunk_h */
@@ -0,0 +1,109 @@
+#include "VoxelMesher.h"
+
+#include <algorithm>
+
+namespace {
+    const int SIZE = (int)CVoxelChunk::SIZE;
+
+    // one row of the face mask, inlined with a constant stride of 1 for the rows along x
+    inline void MaskRow(const VoxelBlock *a, const VoxelBlock *b, const int stride, const int ownBelow, const int ownAbove, int *row)
+    {
+        for (int i = 0; i < SIZE; ++i) {
+            const int below = a[i * stride], above = b[i * stride];
+            const int belowFace = below & -(int)(above == 0) & ownBelow;
+            const int aboveFace = above & -(int)(below == 0) & ownAbove;
+            row[i] = belowFace - aboveFace;
+        }
+    }
+}
+
+void CVoxelMesher::Mesh(const VoxelBlock *padded, const unsigned int &chunkX, const unsigned int &chunkY, const unsigned int &chunkZ,
+                        std::vector<SVoxelVertex> &vertices, std::vector<int> &mask)
+{
+    const int strides[3] = { 1, (int)PADDED_SIZE, (int)(PADDED_SIZE * PADDED_SIZE) };
+    const uint32_t chunk = PackChunk(chunkX, chunkY, chunkZ);
+
+    vertices.clear();
+    mask.resize(SIZE * SIZE);
+
+    for (int d = 0; d < 3; ++d) {
+        // the mask rows run along x whenever d allows it, so that they are read with unit stride
+        const int u = d == 0 ? 1 : 0, v = 3 - d - u;
+        const bool cyclic = v == (u + 1) % 3;   // u x v points along +d
+
+        // plane k lies between the blocks k - 1 and k of the chunk, padded k and k + 1
+        for (int k = 0; k <= SIZE; ++k) {
+            // a face belongs to the solid side, and only the chunk's own blocks make faces: positive
+            // faces of the blocks below the plane, negative faces of those above it. Written without
+            // branches so that the rows along x vectorise.
+            const int ownBelow = k > 0 ? -1 : 0, ownAbove = k < SIZE ? -1 : 0;
+            for (int j = 0; j < SIZE; ++j) {
+                const VoxelBlock *a = padded + k * strides[d] + (j + 1) * strides[v] + strides[u];
+                const VoxelBlock *b = a + strides[d];
+                int *row = &mask[j * SIZE];
+                if (u == 0) {
+                    MaskRow(a, b, 1, ownBelow, ownAbove, row);
+                } else {
+                    MaskRow(a, b, strides[u], ownBelow, ownAbove, row);
+                }
+            }
+
+            for (int j = 0; j < SIZE; ++j) {
+                for (int i = 0; i < SIZE;) {
+                    const int face = mask[i + j * SIZE];
+                    if (face == 0) {
+                        ++i;
+                        continue;
+                    }
+
+                    // widest run along u, then as many rows along v as match it entirely
+                    int width = 1;
+                    while (i + width < SIZE && mask[i + width + j * SIZE] == face) {
+                        ++width;
+                    }
+                    int height = 1;
+                    for (; j + height < SIZE; ++height) {
+                        const int *row = &mask[i + (j + height) * SIZE];
+                        int n = 0;
+                        while (n < width && row[n] == face) {
+                            ++n;
+                        }
+                        if (n < width) {
+                            break;
+                        }
+                    }
+                    for (int h = 0; h < height; ++h) {
+                        std::fill(&mask[i + (j + h) * SIZE], &mask[i + (j + h) * SIZE] + width, 0);
+                    }
+
+                    int p[3], du[3] = { 0, 0, 0 }, dv[3] = { 0, 0, 0 };
+                    p[d] = k;
+                    p[u] = i;
+                    p[v] = j;
+                    du[u] = width;
+                    dv[v] = height;
+                    const bool positive = face > 0;
+                    const VoxelBlock block = (VoxelBlock)(positive ? face : -face);
+                    const unsigned int faceIndex = d * 2 + (positive ? 0 : 1);
+
+                    // p, p + du, p + du + dv, p + dv is counter clockwise seen from u x v
+                    const int *first = positive == cyclic ? du : dv;
+                    const int *second = positive == cyclic ? dv : du;
+                    const int corners[4][3] = {
+                        { p[0], p[1], p[2] },
+                        { p[0] + first[0], p[1] + first[1], p[2] + first[2] },
+                        { p[0] + du[0] + dv[0], p[1] + du[1] + dv[1], p[2] + du[2] + dv[2] },
+                        { p[0] + second[0], p[1] + second[1], p[2] + second[2] }
+                    };
+                    for (int c = 0; c < 4; ++c) {
+                        SVoxelVertex vertex;
+                        vertex.position = PackPosition(corners[c][0], corners[c][1], corners[c][2], faceIndex, block);
+                        vertex.chunk = chunk;
+                        vertices.push_back(vertex);
+                    }
+                    i += width;
+                }
+            }
+        }
+    }
+}
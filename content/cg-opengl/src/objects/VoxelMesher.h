@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef VoxelMesher_h
+#define VoxelMesher_h
+
+#include <vector>
+
+#include "VoxelChunk.h"
+
+// One corner of a voxel quad in 8 bytes. position packs the corner inside its
+// chunk (x, y, z in 6 bits each, 0 to SIZE), the face (0 +X, 1 -X, 2 +Y, 3 -Y,
+// 4 +Z, 5 -Z) in 3 bits and the low 11 bits of the block type. chunk packs
+// the chunk coordinates in 10 bits each. The shader rebuilds the world
+// position, normal and tiled texture coordinates from them.
+struct SVoxelVertex
+{
+    uint32_t position;
+    uint32_t chunk;
+};
+
+// Greedy mesher: the faces between a block and air are merged into the
+// largest rectangles of the same block type, slice by slice along each axis,
+// and every rectangle becomes one quad of four vertices. Quads use the shared
+// index pattern 0 1 2 0 2 3, counter clockwise seen from outside.
+class CVoxelMesher
+{
+public:
+    ///Blocks per side of the padded input, the chunk plus a one block border from its neighbours.
+    static const unsigned int PADDED_SIZE = CVoxelChunk::SIZE + 2;
+    static const unsigned int PADDED_VOLUME = PADDED_SIZE * PADDED_SIZE * PADDED_SIZE;
+
+    static unsigned int PaddedIndex(const unsigned int &x, const unsigned int &y, const unsigned int &z)
+    {
+        return x + PADDED_SIZE * (y + PADDED_SIZE * z);
+    }
+
+    ///Meshes the chunk at chunkX, chunkY, chunkZ from padded, PADDED_VOLUME blocks in PaddedIndex order where the
+    ///block (x, y, z) of the chunk is at (x + 1, y + 1, z + 1). Only the faces of the chunk's own blocks are made,
+    ///the border decides which of them are hidden. vertices is cleared first, mask is scratch space.
+    static void Mesh(const VoxelBlock *padded, const unsigned int &chunkX, const unsigned int &chunkY, const unsigned int &chunkZ,
+                     std::vector<SVoxelVertex> &vertices, std::vector<int> &mask);
+
+    static uint32_t PackPosition(const unsigned int &x, const unsigned int &y, const unsigned int &z,
+                                 const unsigned int &face, const VoxelBlock &block)
+    {
+        return x | (y << 6) | (z << 12) | (face << 18) | ((uint32_t)(block & 0x7ff) << 21);
+    }
+    static uint32_t PackChunk(const unsigned int &chunkX, const unsigned int &chunkY, const unsigned int &chunkZ)
+    {
+        return chunkX | (chunkY << 10) | (chunkZ << 20);
+    }
+};
+
+#endif /* VoxelMesher_h */
@@ -0,0 +1,254 @@
+#include "VoxelTerrain.h"
+
+#include <iterator>
+
+CVoxelTerrain::CVoxelTerrain(const unsigned int &threadCount)
+    : m_world(threadCount)
+{
+    m_meshingBudget = 64;
+    m_vao = m_vertexBuffer = 0;
+    m_capacity = m_end = 0;
+    m_indexBuffer = m_indexQuads = 0;
+    m_useIndirect = false;
+    m_indirectBuffer = 0;
+}
+
+CVoxelTerrain::~CVoxelTerrain()
+{
+    Release();
+}
+
+void CVoxelTerrain::Create(const GLuint &chunksX, const GLuint &chunksY, const GLuint &chunksZ, const GLint &seed)
+{
+    Release();
+    m_world.Create(chunksX, chunksY, chunksZ);
+    m_world.Generate(seed);
+    m_ranges.assign(m_world.GetChunkCount(), SChunkRange{0, 0});
+    CreateBuffers();
+}
+
+void CVoxelTerrain::SetMeshingBudget(const GLuint &maxChunksPerUpdate)
+{
+    m_meshingBudget = maxChunksPerUpdate > 0 ? maxChunksPerUpdate : 1;
+}
+
+void CVoxelTerrain::CreateBuffers()
+{
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    // start with room for a few hundred quads per chunk, GrowVertexBuffer doubles it when needed
+    GrowVertexBuffer(m_world.GetChunkCount() * 1024);
+
+    glGenBuffers(1, &m_indexBuffer);
+    GrowIndexBuffer(4096);
+
+    // multi draw indirect is core in 4.3, older contexts issue the same draws from client arrays
+    m_useIndirect = GLEW_ARB_multi_draw_indirect ? true : false;
+    if (m_useIndirect) {
+        glGenBuffers(1, &m_indirectBuffer);
+    }
+    glBindVertexArray(0);
+}
+
+void CVoxelTerrain::GrowVertexBuffer(const GLuint &minCapacity)
+{
+    GLuint capacity = m_capacity > 0 ? m_capacity : 4096;
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
+    if (capacity == m_capacity)
+        return;
+
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity * sizeof(SVoxelVertex), nullptr, GL_DYNAMIC_DRAW);
+    if (m_end > 0) {
+        // the chunks keep their ranges, so only the used part is copied over on the GPU
+        glBindBuffer(GL_COPY_READ_BUFFER, m_vertexBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)m_end * sizeof(SVoxelVertex));
+    }
+    if (m_vertexBuffer != 0) {
+        glDeleteBuffers(1, &m_vertexBuffer);
+    }
+    m_vertexBuffer = buffer;
+    m_capacity = capacity;
+
+    // the attribute points at the buffer that was bound when it was set, so it follows the new one
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(SVoxelVertex), 0);
+}
+
+void CVoxelTerrain::GrowIndexBuffer(const GLuint &quads)
+{
+    if (quads <= m_indexQuads)
+        return;
+    GLuint count = m_indexQuads > 0 ? m_indexQuads : 1024;
+    while (count < quads) {
+        count *= 2;
+    }
+
+    std::vector<GLuint> indices(count * 6);
+    for (GLuint quad = 0; quad < count; ++quad) {
+        GLuint *index = &indices[quad * 6];
+        const GLuint vertex = quad * 4;
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex;
+        index[4] = vertex + 2;
+        index[5] = vertex + 3;
+    }
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), &indices[0], GL_STATIC_DRAW);
+    m_indexQuads = count;
+}
+
+// first fit from the free ranges, else the end of the buffer
+GLuint CVoxelTerrain::Allocate(const GLuint &count)
+{
+    for (std::map<GLuint, GLuint>::iterator it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it) {
+        if (it->second >= count) {
+            const GLuint first = it->first, size = it->second;
+            m_freeRanges.erase(it);
+            if (size > count) {
+                m_freeRanges[first + count] = size - count;
+            }
+            return first;
+        }
+    }
+    if (m_end + count > m_capacity) {
+        GrowVertexBuffer(m_end + count);
+    }
+    const GLuint first = m_end;
+    m_end += count;
+    return first;
+}
+
+// the range is merged with the free ranges around it, and given back to the end of the buffer when it is last
+void CVoxelTerrain::Free(const GLuint &first, const GLuint &count)
+{
+    if (count == 0)
+        return;
+    GLuint start = first, size = count;
+    std::map<GLuint, GLuint>::iterator next = m_freeRanges.lower_bound(first);
+    if (next != m_freeRanges.end() && next->first == start + size) {
+        size += next->second;
+        next = m_freeRanges.erase(next);
+    }
+    if (next != m_freeRanges.begin()) {
+        std::map<GLuint, GLuint>::iterator previous = std::prev(next);
+        if (previous->first + previous->second == start) {
+            start = previous->first;
+            size += previous->second;
+            m_freeRanges.erase(previous);
+        }
+    }
+    if (start + size == m_end) {
+        m_end = start;
+    } else {
+        m_freeRanges[start] = size;
+    }
+}
+
+void CVoxelTerrain::UploadChunk(const GLuint &chunk)
+{
+    SChunkRange &range = m_ranges[chunk];
+    Free(range.first, range.count);
+    range.first = range.count = 0;
+
+    const std::vector<SVoxelVertex> &vertices = m_world.GetChunkVertices(chunk);
+    if (vertices.empty())
+        return;
+    range.count = (GLuint)vertices.size();
+    range.first = Allocate(range.count);
+    GrowIndexBuffer(range.count / 4);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.first * sizeof(SVoxelVertex), range.count * sizeof(SVoxelVertex), &vertices[0]);
+}
+
+void CVoxelTerrain::Transform(const glm::vec3 & position, const glm::vec3 & rotation, const glm::vec3 & scale) {
+    transform.SetIdentity();
+    transform.Translate(position.x, position.y, position.z);
+    transform.RotateX(glm::radians(rotation.x));
+    transform.RotateY(glm::radians(rotation.y));
+    transform.RotateZ(glm::radians(rotation.z));
+    transform.Scale(scale);
+}
+
+void CVoxelTerrain::Update(const glm::mat4 &viewProjection)
+{
+    if (m_vao == 0)
+        return;
+
+    m_meshed.clear();
+    m_world.MeshDirtyChunks(m_meshed, m_meshingBudget);
+    for (GLuint chunk : m_meshed) {
+        UploadChunk(chunk);
+    }
+
+    // the world culls in block units, so the model matrix goes into the frustum
+    m_visible.clear();
+    m_world.Cull(viewProjection * Model(), m_visible);
+}
+
+// the blocks are flat coloured by VoxelShader, there is no texture to bind
+void CVoxelTerrain::Render(const GLboolean &/*useTexture*/)
+{
+    if (m_vao == 0)
+        return;
+
+    m_commands.clear();
+    m_counts.clear();
+    m_offsets.clear();
+    m_baseVertices.clear();
+    for (GLuint chunk : m_visible) {
+        const SChunkRange &range = m_ranges[chunk];
+        if (range.count == 0)
+            continue;
+        const GLuint count = range.count / 4 * 6;
+        if (m_useIndirect) {
+            m_commands.push_back(SDrawElementsIndirectCommand{count, 1, 0, (GLint)range.first, 0});
+        } else {
+            m_counts.push_back((GLsizei)count);
+            m_offsets.push_back(nullptr);
+            m_baseVertices.push_back((GLint)range.first);
+        }
+    }
+
+    glBindVertexArray(m_vao);
+    if (m_useIndirect) {
+        if (m_commands.empty())
+            return;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(SDrawElementsIndirectCommand) * m_commands.size(), &m_commands[0], GL_STREAM_DRAW);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)m_commands.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    } else if (!m_counts.empty()) {
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, &m_counts[0], GL_UNSIGNED_INT, &m_offsets[0], (GLsizei)m_counts.size(), &m_baseVertices[0]);
+    }
+}
+
+// Release memory on the GPU
+void CVoxelTerrain::Release()
+{
+    if (m_vao != 0) {
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_vertexBuffer);
+        glDeleteBuffers(1, &m_indexBuffer);
+        if (m_indirectBuffer != 0) {
+            glDeleteBuffers(1, &m_indirectBuffer);
+        }
+    }
+    m_vao = m_vertexBuffer = m_indexBuffer = m_indirectBuffer = 0;
+    m_capacity = m_end = m_indexQuads = 0;
+    m_freeRanges.clear();
+    m_ranges.clear();
+    m_visible.clear();
+    m_world.Release();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef VoxelTerrain_h
+#define VoxelTerrain_h
+
+#include <map>
+
+#include "../ObjectsBase.h"
+#include "VoxelWorld.h"
+
+// OpenGL side of the voxel world. The meshes of all chunks live in one shared
+// vertex buffer, each chunk owning a range handed out from a free list, and
+// all chunks share one quad index buffer. Update remeshes a budget of dirty
+// chunks on the worker pool, streams them into the shared buffer and culls
+// the chunks against the view frustum, and Render draws the visible ones with
+// a single multi draw call. The vertices carry their chunk coordinates, so no
+// per draw state is needed.
+class CVoxelTerrain: public IGameObject
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CVoxelTerrain(const unsigned int &threadCount = 0);
+    ~CVoxelTerrain();
+
+    ///A world of chunksX x chunksY x chunksZ chunks of CVoxelChunk::SIZE blocks filled with a noise terrain.
+    void Create(const GLuint &chunksX, const GLuint &chunksY, const GLuint &chunksZ, const GLint &seed);
+
+    VoxelBlock GetBlock(const GLint &x, const GLint &y, const GLint &z) const { return m_world.GetBlock(x, y, z); }
+    ///Takes effect on the next Update that has budget left for the chunk.
+    void SetBlock(const GLint &x, const GLint &y, const GLint &z, const VoxelBlock &block) { m_world.SetBlock(x, y, z, block); }
+    ///Dirty chunks meshed and uploaded per Update, the rest wait for the next frames.
+    void SetMeshingBudget(const GLuint &maxChunksPerUpdate);
+
+    void Transform(const glm::vec3 & position,
+                   const glm::vec3 & rotation = glm::vec3(0, 0, 0),
+                   const glm::vec3 & scale = glm::vec3(1, 1, 1));
+
+    // Remesh and upload dirty chunks and select the visible ones, call once per frame after Transform,
+    // every Render of the frame draws this selection
+    void Update(const glm::mat4 &viewProjection);
+    ///useTexture is part of IGameObject, the blocks have no textures.
+    void Render(const GLboolean &useTexture = true);
+    void Release();
+
+    const CVoxelWorld &GetWorld() const { return m_world; }
+    GLuint GetVisibleChunkCount() const { return (GLuint)m_visible.size(); }
+
+private:
+    // the layout glMultiDrawElementsIndirect reads from the indirect buffer
+    struct SDrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    struct SChunkRange
+    {
+        GLuint first;       // first vertex in the shared buffer
+        GLuint count;       // vertices, 4 per quad
+    };
+
+    void CreateBuffers();
+    void UploadChunk(const GLuint &chunk);
+    GLuint Allocate(const GLuint &count);
+    void Free(const GLuint &first, const GLuint &count);
+    void GrowVertexBuffer(const GLuint &minCapacity);
+    void GrowIndexBuffer(const GLuint &quads);
+
+    CVoxelWorld m_world;
+    GLuint m_meshingBudget;
+    std::vector<SChunkRange> m_ranges;
+    std::vector<GLuint> m_meshed, m_visible;
+
+    // the shared vertex buffer in vertices, free ranges by first vertex with their size
+    GLuint m_vao, m_vertexBuffer, m_capacity, m_end;
+    std::map<GLuint, GLuint> m_freeRanges;
+
+    // indices of m_indexQuads quads, the pattern 0 1 2 0 2 3 repeated 4 vertices apart
+    GLuint m_indexBuffer, m_indexQuads;
+
+    GLboolean m_useIndirect;
+    GLuint m_indirectBuffer;
+    std::vector<SDrawElementsIndirectCommand> m_commands;
+    std::vector<GLsizei> m_counts;
+    std::vector<const GLvoid *> m_offsets;
+    std::vector<GLint> m_baseVertices;
+};
+
+#endif /* VoxelTerrain_h */
@@ -0,0 +1,295 @@
+#include "VoxelWorld.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define STB_PERLIN_IMPLEMENTATION
+#include <stb/stb_perlin.h>
+
+namespace {
+    const int SIZE = (int)CVoxelChunk::SIZE;
+    const unsigned int MAX_CHUNKS_PER_AXIS = 1024;   // the vertices keep 10 bits per chunk coordinate
+
+    // scratch of the meshing tasks, one set per thread so that the pool never allocates while meshing
+    struct SMeshScratch
+    {
+        std::vector<VoxelBlock> padded, blocks;
+        std::vector<int> mask;
+        std::vector<SVoxelVertex> vertices;
+    };
+
+    SMeshScratch &Scratch()
+    {
+        static thread_local SMeshScratch scratch;
+        return scratch;
+    }
+}
+
+CVoxelWorld::CVoxelWorld(const unsigned int &threadCount)
+    : m_chunksX(0), m_chunksY(0), m_chunksZ(0), m_pool(threadCount)
+{
+}
+
+CVoxelWorld::~CVoxelWorld()
+{
+    Release();
+}
+
+void CVoxelWorld::Create(const unsigned int &chunksX, const unsigned int &chunksY, const unsigned int &chunksZ)
+{
+    Release();
+    m_chunksX = std::min(chunksX, MAX_CHUNKS_PER_AXIS);
+    m_chunksY = std::min(chunksY, MAX_CHUNKS_PER_AXIS);
+    m_chunksZ = std::min(chunksZ, MAX_CHUNKS_PER_AXIS);
+    m_chunks.resize((size_t)m_chunksX * m_chunksY * m_chunksZ);
+    m_meshes.resize(m_chunks.size());
+    m_dirty.assign(m_chunks.size(), 0);
+}
+
+void CVoxelWorld::Release()
+{
+    m_chunks.clear();
+    m_meshes.clear();
+    m_dirty.clear();
+    m_dirtyChunks.clear();
+    m_chunksX = m_chunksY = m_chunksZ = 0;
+}
+
+void CVoxelWorld::Generate(const int &seed)
+{
+    const int worldHeight = (int)m_chunksY * SIZE;
+    const float scale = 1.0f / 128.0f;
+    const float seedOffset = seed * 17.31f;
+
+    // one column of chunks per task, the heights of the column are shared by its chunks
+    m_pool.ParallelFor(m_chunksX * m_chunksZ, [&](unsigned int column) {
+        const unsigned int chunkX = column % m_chunksX, chunkZ = column / m_chunksX;
+        std::vector<int> heights(SIZE * SIZE);
+        std::vector<float> noise(SIZE);
+        for (int z = 0; z < SIZE; ++z) {
+            const float worldZ = (float)(chunkZ * SIZE + z);
+            stb_perlin_fbm_noise3_row(noise.data(), SIZE, chunkX * SIZE * scale, scale, seedOffset, worldZ * scale, 2.0f, 0.5f, 5);
+            for (int x = 0; x < SIZE; ++x) {
+                int height = (int)(worldHeight * (0.45f + 0.35f * noise[x]));
+                heights[x + z * SIZE] = std::max(1, std::min(height, worldHeight - 1));
+            }
+        }
+
+        std::vector<VoxelBlock> blocks(CVoxelChunk::VOLUME);
+        for (unsigned int chunkY = 0; chunkY < m_chunksY; ++chunkY) {
+            for (int z = 0; z < SIZE; ++z) {
+                for (int x = 0; x < SIZE; ++x) {
+                    const int top = heights[x + z * SIZE];
+                    const VoxelBlock surface = top > worldHeight * 3 / 4 ? VOXEL_SNOW : VOXEL_GRASS;
+                    for (int y = 0; y < SIZE; ++y) {
+                        const int worldY = (int)chunkY * SIZE + y;
+                        VoxelBlock block = VOXEL_AIR;
+                        if (worldY == top) {
+                            block = surface;
+                        } else if (worldY < top) {
+                            block = worldY >= top - 3 ? VOXEL_DIRT : VOXEL_STONE;
+                        }
+                        blocks[CVoxelChunk::Index(x, y, z)] = block;
+                    }
+                }
+            }
+            m_chunks[ChunkIndex(chunkX, chunkY, chunkZ)].Fill(blocks.data());
+        }
+    });
+
+    m_dirtyChunks.clear();
+    for (unsigned int chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        m_dirty[chunk] = 1;
+        m_dirtyChunks.push_back(chunk);
+    }
+}
+
+VoxelBlock CVoxelWorld::GetBlock(const int &x, const int &y, const int &z) const
+{
+    if (x < 0 || y < 0 || z < 0 || x >= (int)m_chunksX * SIZE || y >= (int)m_chunksY * SIZE || z >= (int)m_chunksZ * SIZE) {
+        return VOXEL_AIR;
+    }
+    return m_chunks[ChunkIndex(x / SIZE, y / SIZE, z / SIZE)].Get(x % SIZE, y % SIZE, z % SIZE);
+}
+
+void CVoxelWorld::SetBlock(const int &x, const int &y, const int &z, const VoxelBlock &block)
+{
+    if (x < 0 || y < 0 || z < 0 || x >= (int)m_chunksX * SIZE || y >= (int)m_chunksY * SIZE || z >= (int)m_chunksZ * SIZE) {
+        return;
+    }
+    const int chunkX = x / SIZE, chunkY = y / SIZE, chunkZ = z / SIZE;
+    const int localX = x % SIZE, localY = y % SIZE, localZ = z % SIZE;
+    CVoxelChunk &chunk = m_chunks[ChunkIndex(chunkX, chunkY, chunkZ)];
+    if (chunk.Get(localX, localY, localZ) == block) {
+        return;
+    }
+    chunk.Set(localX, localY, localZ, block);
+
+    // the neighbour's faces against this block appear or disappear as well
+    MarkDirty(chunkX, chunkY, chunkZ);
+    if (localX == 0) MarkDirty(chunkX - 1, chunkY, chunkZ);
+    if (localX == SIZE - 1) MarkDirty(chunkX + 1, chunkY, chunkZ);
+    if (localY == 0) MarkDirty(chunkX, chunkY - 1, chunkZ);
+    if (localY == SIZE - 1) MarkDirty(chunkX, chunkY + 1, chunkZ);
+    if (localZ == 0) MarkDirty(chunkX, chunkY, chunkZ - 1);
+    if (localZ == SIZE - 1) MarkDirty(chunkX, chunkY, chunkZ + 1);
+}
+
+void CVoxelWorld::MarkDirty(const int &chunkX, const int &chunkY, const int &chunkZ)
+{
+    if (chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= (int)m_chunksX || chunkY >= (int)m_chunksY || chunkZ >= (int)m_chunksZ) {
+        return;
+    }
+    const unsigned int chunk = ChunkIndex(chunkX, chunkY, chunkZ);
+    if (!m_dirty[chunk]) {
+        m_dirty[chunk] = 1;
+        m_dirtyChunks.push_back(chunk);
+    }
+}
+
+// a solid chunk whose six neighbours are solid as well has no visible face
+bool CVoxelWorld::IsBuried(const unsigned int &chunk) const
+{
+    const CVoxelChunk &self = m_chunks[chunk];
+    if (!self.IsUniform() || self.IsEmpty()) {
+        return false;
+    }
+    const int chunkX = chunk % m_chunksX, chunkY = (chunk / m_chunksX) % m_chunksY, chunkZ = chunk / (m_chunksX * m_chunksY);
+    const int offsets[6][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+    for (int i = 0; i < 6; ++i) {
+        const int x = chunkX + offsets[i][0], y = chunkY + offsets[i][1], z = chunkZ + offsets[i][2];
+        if (x < 0 || y < 0 || z < 0 || x >= (int)m_chunksX || y >= (int)m_chunksY || z >= (int)m_chunksZ) {
+            return false;
+        }
+        const CVoxelChunk &neighbour = m_chunks[ChunkIndex(x, y, z)];
+        if (!neighbour.IsUniform() || neighbour.IsEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CVoxelWorld::GatherPadded(const unsigned int &chunk, VoxelBlock *padded) const
+{
+    const unsigned int P = CVoxelMesher::PADDED_SIZE;
+    const int chunkX = chunk % m_chunksX, chunkY = (chunk / m_chunksX) % m_chunksY, chunkZ = chunk / (m_chunksX * m_chunksY);
+    std::fill(padded, padded + CVoxelMesher::PADDED_VOLUME, (VoxelBlock)VOXEL_AIR);
+
+    // the chunk itself, row by row into the middle
+    std::vector<VoxelBlock> &blocks = Scratch().blocks;
+    blocks.resize(CVoxelChunk::VOLUME);
+    m_chunks[chunk].Decompress(blocks.data());
+    for (int z = 0; z < SIZE; ++z) {
+        for (int y = 0; y < SIZE; ++y) {
+            memcpy(padded + CVoxelMesher::PaddedIndex(1, y + 1, z + 1), &blocks[CVoxelChunk::Index(0, y, z)], SIZE * sizeof(VoxelBlock));
+        }
+    }
+
+    // the facing layer of the six neighbours, air outside the world. The edges and corners are never looked at.
+    const CVoxelChunk *left = chunkX > 0 ? &m_chunks[chunk - 1] : nullptr;
+    const CVoxelChunk *right = chunkX + 1 < (int)m_chunksX ? &m_chunks[chunk + 1] : nullptr;
+    const CVoxelChunk *below = chunkY > 0 ? &m_chunks[chunk - m_chunksX] : nullptr;
+    const CVoxelChunk *above = chunkY + 1 < (int)m_chunksY ? &m_chunks[chunk + m_chunksX] : nullptr;
+    const CVoxelChunk *back = chunkZ > 0 ? &m_chunks[chunk - m_chunksX * m_chunksY] : nullptr;
+    const CVoxelChunk *front = chunkZ + 1 < (int)m_chunksZ ? &m_chunks[chunk + m_chunksX * m_chunksY] : nullptr;
+    for (int a = 0; a < SIZE; ++a) {
+        for (int b = 0; b < SIZE; ++b) {
+            if (left) padded[CVoxelMesher::PaddedIndex(0, a + 1, b + 1)] = left->Get(SIZE - 1, a, b);
+            if (right) padded[CVoxelMesher::PaddedIndex(P - 1, a + 1, b + 1)] = right->Get(0, a, b);
+            if (below) padded[CVoxelMesher::PaddedIndex(a + 1, 0, b + 1)] = below->Get(a, SIZE - 1, b);
+            if (above) padded[CVoxelMesher::PaddedIndex(a + 1, P - 1, b + 1)] = above->Get(a, 0, b);
+            if (back) padded[CVoxelMesher::PaddedIndex(a + 1, b + 1, 0)] = back->Get(a, b, SIZE - 1);
+            if (front) padded[CVoxelMesher::PaddedIndex(a + 1, b + 1, P - 1)] = front->Get(a, b, 0);
+        }
+    }
+}
+
+unsigned int CVoxelWorld::MeshDirtyChunks(std::vector<unsigned int> &meshed, const unsigned int &maxChunks)
+{
+    const unsigned int count = std::min(maxChunks, (unsigned int)m_dirtyChunks.size());
+    if (count == 0) {
+        return 0;
+    }
+    const size_t first = meshed.size();
+    meshed.insert(meshed.end(), m_dirtyChunks.begin(), m_dirtyChunks.begin() + count);
+    m_dirtyChunks.erase(m_dirtyChunks.begin(), m_dirtyChunks.begin() + count);
+
+    // edits may have left unused palette entries, each task only rewrites its own chunk
+    m_pool.ParallelFor(count, [&](unsigned int i) {
+        m_chunks[meshed[first + i]].Compact();
+    });
+
+    // from here on the workers only read the blocks, edits happen between calls on the calling thread
+    m_pool.ParallelFor(count, [&](unsigned int i) {
+        const unsigned int chunk = meshed[first + i];
+        std::vector<SVoxelVertex> &vertices = m_meshes[chunk];
+        if (m_chunks[chunk].IsEmpty() || IsBuried(chunk)) {
+            std::vector<SVoxelVertex>().swap(vertices);
+            return;
+        }
+
+        SMeshScratch &scratch = Scratch();
+        scratch.padded.resize(CVoxelMesher::PADDED_VOLUME);
+        GatherPadded(chunk, scratch.padded.data());
+        const unsigned int chunkX = chunk % m_chunksX, chunkY = (chunk / m_chunksX) % m_chunksY, chunkZ = chunk / (m_chunksX * m_chunksY);
+        CVoxelMesher::Mesh(scratch.padded.data(), chunkX, chunkY, chunkZ, scratch.vertices, scratch.mask);
+        // meshed into the reused scratch and copied at its final size, the chunks keep no spare capacity
+        std::vector<SVoxelVertex>(scratch.vertices.begin(), scratch.vertices.end()).swap(vertices);
+    });
+
+    for (unsigned int i = 0; i < count; ++i) {
+        m_dirty[meshed[first + i]] = 0;
+    }
+    return count;
+}
+
+void CVoxelWorld::Cull(const glm::mat4 &viewProjection, std::vector<unsigned int> &visible) const
+{
+    // frustum planes straight from the rows of the view projection matrix (Gribb & Hartmann),
+    // a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    };
+
+    for (unsigned int chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        if (m_meshes[chunk].empty()) {
+            continue;
+        }
+        const glm::vec3 min = glm::vec3(chunk % m_chunksX, (chunk / m_chunksX) % m_chunksY, chunk / (m_chunksX * m_chunksY)) * (float)SIZE;
+        const glm::vec3 max = min + glm::vec3((float)SIZE);
+        bool inside = true;
+        for (int i = 0; i < 6 && inside; ++i) {
+            // the box corner furthest along the plane normal decides whether the box is outside
+            const glm::vec4 &plane = planes[i];
+            glm::vec3 outer(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+            inside = glm::dot(glm::vec3(plane), outer) + plane.w >= 0.0f;
+        }
+        if (inside) {
+            visible.push_back(chunk);
+        }
+    }
+}
+
+size_t CVoxelWorld::GetBlockMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const CVoxelChunk &chunk : m_chunks) {
+        bytes += chunk.GetMemoryUsage();
+    }
+    return bytes;
+}
+
+size_t CVoxelWorld::GetMeshMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const std::vector<SVoxelVertex> &vertices : m_meshes) {
+        bytes += vertices.capacity() * sizeof(SVoxelVertex);
+    }
+    return bytes;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#ifndef VoxelWorld_h
+#define VoxelWorld_h
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "VoxelChunk.h"
+#include "VoxelMesher.h"
+#include "../utilities/ThreadPool.h"
+
+// block types Generate fills the world with
+enum VoxelBlockType
+{
+    VOXEL_AIR = 0,
+    VOXEL_GRASS = 1,
+    VOXEL_DIRT = 2,
+    VOXEL_STONE = 3,
+    VOXEL_SNOW = 4
+};
+
+// CPU side of the voxel world, it never calls OpenGL. The world is a grid of
+// chunksX x chunksY x chunksZ palette compressed chunks, one block being one
+// unit with the world starting at the origin. Editing a block marks its
+// chunk dirty, and the neighbours as well when the block is on a chunk side,
+// and the dirty chunks are remeshed by the greedy mesher on the worker pool.
+// Chunks are culled against the view frustum for drawing.
+class CVoxelWorld
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CVoxelWorld(const unsigned int &threadCount = 0);
+    ~CVoxelWorld();
+
+    ///An empty world of chunksX x chunksY x chunksZ chunks, at most 1024 along each axis.
+    void Create(const unsigned int &chunksX, const unsigned int &chunksY, const unsigned int &chunksZ);
+    ///Fills the world with a noise heightfield of stone, dirt, grass and snow and marks every chunk dirty.
+    void Generate(const int &seed);
+    void Release();
+
+    ///Air outside the world.
+    VoxelBlock GetBlock(const int &x, const int &y, const int &z) const;
+    ///Blocks outside the world are ignored.
+    void SetBlock(const int &x, const int &y, const int &z, const VoxelBlock &block);
+
+    ///Meshes up to maxChunks dirty chunks in parallel, oldest first, and appends their indices to meshed.
+    ///Returns the number of chunks meshed.
+    unsigned int MeshDirtyChunks(std::vector<unsigned int> &meshed, const unsigned int &maxChunks = 0xffffffffu);
+
+    ///Appends the chunks that have faces and whose box intersects the frustum of viewProjection, in world units.
+    void Cull(const glm::mat4 &viewProjection, std::vector<unsigned int> &visible) const;
+
+    unsigned int ChunkIndex(const unsigned int &chunkX, const unsigned int &chunkY, const unsigned int &chunkZ) const
+    {
+        return chunkX + m_chunksX * (chunkY + m_chunksY * chunkZ);
+    }
+    const CVoxelChunk &GetChunk(const unsigned int &chunk) const { return m_chunks[chunk]; }
+    const std::vector<SVoxelVertex> &GetChunkVertices(const unsigned int &chunk) const { return m_meshes[chunk]; }
+    unsigned int GetChunksX() const { return m_chunksX; }
+    unsigned int GetChunksY() const { return m_chunksY; }
+    unsigned int GetChunksZ() const { return m_chunksZ; }
+    unsigned int GetChunkCount() const { return (unsigned int)m_chunks.size(); }
+    unsigned int GetDirtyChunkCount() const { return (unsigned int)m_dirtyChunks.size(); }
+    ///Bytes of block storage over all chunks.
+    size_t GetBlockMemoryUsage() const;
+    ///Bytes of CPU side vertices over all chunks.
+    size_t GetMeshMemoryUsage() const;
+    unsigned int GetThreadCount() const { return m_pool.GetThreadCount() + 1; }
+
+private:
+    void MarkDirty(const int &chunkX, const int &chunkY, const int &chunkZ);
+    void GatherPadded(const unsigned int &chunk, VoxelBlock *padded) const;
+    bool IsBuried(const unsigned int &chunk) const;
+
+    unsigned int m_chunksX, m_chunksY, m_chunksZ;
+    std::vector<CVoxelChunk> m_chunks;
+    std::vector<std::vector<SVoxelVertex>> m_meshes;
+    std::vector<unsigned char> m_dirty;
+    std::vector<unsigned int> m_dirtyChunks;
+
+    CThreadPool m_pool;
+};
+
+#endif /* VoxelWorld_h */
@@ -24,6 +24,8 @@ uniform struct Material
     bool bUseTexture;
 } material;
 
+uniform bool bUseDistanceField;     // text drawn from the signed distance field glyph atlas
+
 in VS_OUT
 {
     vec2 vTexCoord;    // Texture coordinate
@@ -39,5 +41,11 @@ out vec4 vOutputColour;
 void main()
 {
     vec4 vTexColour = texture(material.depthMap, fs_in.vTexCoord);    // Get the texel colour from the image
-    vOutputColour = material.bUseTexture ? vec4(vTexColour.r) * material.color : material.color;
+    float fAlpha = vTexColour.r;
+    if (bUseDistanceField) {
+        // the outline is at 0.5, antialias over about one screen pixel at any text size
+        float fWidth = max(fwidth(vTexColour.r), 1e-4);
+        fAlpha = smoothstep(0.5 - fWidth, 0.5 + fWidth, vTexColour.r);
+    }
+    vOutputColour = material.bUseTexture ? vec4(fAlpha) * material.color : material.color;
 }
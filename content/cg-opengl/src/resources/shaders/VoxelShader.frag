@@ -0,0 +1,38 @@
+#version 400 core
+
+// Flat coloured blocks of the voxel world with a darkened block outline, so the
+// blocks stay readable on the large merged quads, and one directional light.
+
+uniform vec3 lightDirection;    // towards the light, in world space
+
+in VS_OUT
+{
+    vec2 vTexCoord;
+    vec3 vLocalPosition;
+    vec3 vWorldPosition;
+    vec3 vWorldNormal;
+    flat uint vBlock;
+} fs_in;
+
+// colours of VoxelBlockType: air, grass, dirt, stone, snow
+const vec3 blockColours[5] = vec3[5](vec3(1.0f, 0.0f, 1.0f), vec3(0.33f, 0.6f, 0.22f),
+                                     vec3(0.45f, 0.32f, 0.2f), vec3(0.5f, 0.5f, 0.52f),
+                                     vec3(0.92f, 0.94f, 0.97f));
+
+layout (location = 0) out vec4 vOutputColour;   // The output colour formely  gl_FragColor
+layout (location = 1) out vec4 vBrightColor;
+
+void main()
+{
+    vec3 albedo = blockColours[min(fs_in.vBlock, 4u)];
+
+    // distance to the nearest block edge in texels of the tiled coordinates
+    vec2 cell = abs(fract(fs_in.vTexCoord) - 0.5f);
+    float edge = smoothstep(0.44f, 0.5f, max(cell.x, cell.y));
+    albedo *= 1.0f - 0.25f * edge;
+
+    vec3 normal = normalize(fs_in.vWorldNormal);
+    float diffuse = max(dot(normal, normalize(lightDirection)), 0.0f);
+    vOutputColour = vec4(albedo * (0.35f + 0.65f * diffuse), 1.0f);
+    vBrightColor = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
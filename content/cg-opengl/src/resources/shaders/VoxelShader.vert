@@ -0,0 +1,58 @@
+#version 400 core
+
+// Voxel world quads from CVoxelTerrain. Every vertex is two packed integers
+// (see SVoxelVertex): the corner inside its chunk with the face and block type,
+// and the chunk coordinates. The world position, normal and tiled texture
+// coordinates are rebuilt here so the shared vertex buffer stays at 8 bytes a vertex.
+
+// Structure for matrices
+uniform struct Matrices
+{
+    mat4 projMatrix;
+    mat4 modelMatrix;
+    mat4 viewMatrix;
+    mat3 normalMatrix;
+    
+} matrices;
+
+// Layout of vertex attributes in VBO
+layout (location = 0) in uvec2 inVoxel;
+
+const float chunkSize = 32.0f;
+
+// face 0 +X, 1 -X, 2 +Y, 3 -Y, 4 +Z, 5 -Z
+const vec3 faceNormals[6] = vec3[6](vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+                                    vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+                                    vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f));
+
+out VS_OUT
+{
+    vec2 vTexCoord;    // Texture coordinate, one unit per block
+    vec3 vLocalPosition;
+    vec3 vWorldPosition;
+    vec3 vWorldNormal;
+    flat uint vBlock;
+} vs_out;
+
+// This is the entry point into the vertex shader
+void main()
+{
+    uint position = inVoxel.x;
+    uint chunk = inVoxel.y;
+    vec3 corner = vec3(position & 63u, (position >> 6) & 63u, (position >> 12) & 63u);
+    vec3 chunkOrigin = vec3(chunk & 1023u, (chunk >> 10) & 1023u, (chunk >> 20) & 1023u) * chunkSize;
+    uint face = (position >> 18) & 7u;
+
+    vec3 localPosition = chunkOrigin + corner;
+    vec3 normal = faceNormals[face];
+
+    // the two axes across the face
+    uint axis = face / 2u;
+    vs_out.vTexCoord = axis == 0u ? localPosition.zy : (axis == 1u ? localPosition.xz : localPosition.xy);
+    vs_out.vLocalPosition = localPosition;
+    vs_out.vWorldPosition = vec3(matrices.modelMatrix * vec4(localPosition, 1.0f));
+    vs_out.vWorldNormal = normalize(matrices.normalMatrix * normal);
+    vs_out.vBlock = position >> 21;
+
+    gl_Position = matrices.projMatrix * matrices.viewMatrix * vec4(vs_out.vWorldPosition, 1.0f);
+}
@@ -1,5 +1,14 @@
 #include "Cubemap.h"
 
+namespace {
+    // shared by every skybox, the workers only run while faces are decoded
+    CCubemapLoader &FaceLoader()
+    {
+        static CCubemapLoader loader;
+        return loader;
+    }
+}
+
 CCubemap::CCubemap()
 {
     m_skyTexture = 0;
@@ -29,56 +38,6 @@ CCubemap::~CCubemap()
     Release();
 }
 
-GLboolean CCubemap::LoadTexture(std::string filename, BYTE **bmpBytes, GLint &iWidth, GLint &iHeight)
-{
-	FREE_IMAGE_FORMAT fif = FIF_UNKNOWN;
-	FIBITMAP* dib(0);
-
-	fif = FreeImage_GetFileType(filename.c_str(), 0); // Check the file signature and deduce its format
-
-	if(fif == FIF_UNKNOWN) // If still unknown, try to guess the file format from the file extension
-		fif = FreeImage_GetFIFFromFilename(filename.c_str());
-	
-	if(fif == FIF_UNKNOWN) // If still unknown, return failure
-		return false;
-
-	if(FreeImage_FIFSupportsReading(fif)) // Check if the plugin has reading capabilities and load the file
-		dib = FreeImage_Load(fif, filename.c_str());
-
-	if(!dib) {
-		char message[1024];
-		printf(message, "Cannot load image\n%s\n", filename.c_str());
-		return false;
-	}
-
-    BYTE* bDataPointer = FreeImage_GetBits(dib); // Retrieve the image data
-
-    // If somehow one of these failed (they shouldn't), return failure
-    if(bDataPointer == NULL || FreeImage_GetWidth(dib) == 0 || FreeImage_GetHeight(dib) == 0) {
-        return false;
-    }
-    
-    iWidth = FreeImage_GetWidth(dib);
-    iHeight = FreeImage_GetWidth(dib);
-    int bpp = FreeImage_GetBPP(dib);
-    
-	int test = FreeImage_GetDIBSize(dib);
-	*bmpBytes = new BYTE [iWidth*iHeight*bpp/8];
-    
-	memcpy(*bmpBytes, bDataPointer, iWidth * iHeight * bpp / 8);
-	
-	/*
-	GLenum format;
-	FreeImage_GetBPP(dib);
-	if(FreeImage_GetBPP(dib) == 32)format = GL_RGBA;
-	if(FreeImage_GetBPP(dib) == 24)format = GL_BGR;
-	if(FreeImage_GetBPP(dib) == 8)format = GL_LUMINANCE;
-	*/
-	
-	FreeImage_Unload(dib);
-	return true; // Success
-}
-
 // loads a cubemap texture from 6 individual texture faces
 // order:
 // +X (right)
@@ -93,19 +52,47 @@ void CCubemap::LoadCubemap(const std::vector<std::string> &cubemapFaces, const T
     m_faces = cubemapFaces;
     m_type = type;
     
+    // the faces are decoded in parallel into one staging buffer, or read back from the
+    // cubemap.ktx written next to them the first time
+    SCubemapImage image;
+    if (!FaceLoader().LoadCached(CCubemapLoader::GetCachePath(cubemapFaces).c_str(), cubemapFaces, image)) {
+        return;
+    }
+    
+    // keep the channels of the files, one and two channel faces are shown as grey
+    const GLenum formats[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+    const GLenum internalFormats[4] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+    GLenum format = formats[image.channels - 1];
+    GLenum internalFormat = internalFormats[image.channels - 1];
+    GLint levels = 1;
+    while ((image.width >> levels) > 0) levels++;
+    
     // Generate an OpenGL texture ID for this texture
     glGenTextures(1, &m_skyTexture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_skyTexture);
     
-    GLint iWidth, iHeight, iChannels;
-    BYTE *data = nullptr;
-    for (GLuint i = 0; i < cubemapFaces.size(); i++)
+    // immutable storage for the whole chain where the driver has it (OpenGL 4.2), the faces are then copied in
+    if (GLEW_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, levels, internalFormat, image.width, image.height);
+    }
+    else {
+        for (GLuint i = 0; i < 6; i++)
+        {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+    
+    // the staging rows are packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (GLuint i = 0; i < 6; i++)
     {
-        std::string face = cubemapFaces[i];
-        LoadTexture(face, &data, iWidth, iHeight);
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, iWidth, iHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
-
-        if (data != NULL) delete[] data;
+        glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, image.width, image.height, format, GL_UNSIGNED_BYTE, image.GetFace(i));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    
+    if (image.channels < 3) {
+        const GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, image.channels == 2 ? GL_GREEN : GL_ONE };
+        glTexParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
     }
 
     glGenSamplers(1, &m_skySampler);
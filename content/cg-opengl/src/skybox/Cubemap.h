@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../SkyboxBase.h"
+#include "CubemapLoader.h"
 
 class CCubemap
 {
@@ -23,7 +24,6 @@ public:
     TextureType GetType() const;
     
 private:
-    GLboolean LoadTexture(std::string filename, BYTE **bmpBytes, GLint &iWidth, GLint &iHeight);
 	GLuint m_skyTexture, m_skySampler, m_envTexture, m_envSampler, m_irrTexture, m_irrSampler, m_prefilterTexture, m_prefilterSampler;
     GLuint m_brdfLUTTexture, m_brdfLUTSampler;
     GLuint m_envFramebuffer, m_envRenderbuffer;
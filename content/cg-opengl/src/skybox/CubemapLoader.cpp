@@ -0,0 +1,296 @@
+#include "CubemapLoader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+#include <stb/stb_image.h>
+
+namespace {
+    const unsigned int FACE_COUNT = 6;
+
+    const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    const uint32_t KTX_ENDIANNESS = 0x04030201;
+
+    // the OpenGL enums of the header, spelled out so that the loader stays free of OpenGL
+    const uint32_t KTX_UNSIGNED_BYTE = 0x1401;
+    const uint32_t KTX_FORMATS[4] = { 0x1903, 0x8227, 0x1907, 0x1908 };          // GL_RED, GL_RG, GL_RGB, GL_RGBA
+    const uint32_t KTX_INTERNAL_FORMATS[4] = { 0x8229, 0x822B, 0x8051, 0x8058 }; // GL_R8, GL_RG8, GL_RGB8, GL_RGBA8
+
+    // the rows are stored bottom first, as they are uploaded
+    const char KTX_ORIENTATION_KEY[] = "KTXorientation";
+    const char KTX_ORIENTATION[] = "S=r,T=u";
+    const char KTX_SOURCES_KEY[] = "CGCubemapSources";
+
+    struct SKTXHeader
+    {
+        unsigned char identifier[12];
+        uint32_t endianness;
+        uint32_t glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat;
+        uint32_t pixelWidth, pixelHeight, pixelDepth;
+        uint32_t numberOfArrayElements, numberOfFaces, numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    };
+
+    // size and modification time of a face file, a cache written from other stamps is stale
+    struct SSourceStamp
+    {
+        uint64_t size;
+        int64_t modified;
+    };
+
+    bool StampSources(const std::vector<std::string> &faces, SSourceStamp stamps[FACE_COUNT])
+    {
+        for (unsigned int i = 0; i < FACE_COUNT; ++i) {
+            struct stat status;
+            if (stat(faces[i].c_str(), &status) != 0) {
+                return false;
+            }
+            stamps[i].size = (uint64_t)status.st_size;
+            stamps[i].modified = (int64_t)status.st_mtime;
+        }
+        return true;
+    }
+
+    inline uint32_t Padded(const uint32_t &size)
+    {
+        return (size + 3) & ~3u;
+    }
+
+    // one key and value pair of the KTX key/value data, padded to four bytes
+    void AppendKeyValue(std::vector<char> &data, const char *key, const void *value, const uint32_t &valueSize)
+    {
+        uint32_t keyAndValueByteSize = (uint32_t)strlen(key) + 1 + valueSize;
+        size_t offset = data.size();
+        data.resize(offset + sizeof(uint32_t) + Padded(keyAndValueByteSize), 0);
+        memcpy(&data[offset], &keyAndValueByteSize, sizeof(uint32_t));
+        memcpy(&data[offset + sizeof(uint32_t)], key, strlen(key) + 1);
+        memcpy(&data[offset + sizeof(uint32_t) + strlen(key) + 1], value, valueSize);
+    }
+
+    // the value stored under key, or null
+    const char *FindKeyValue(const std::vector<char> &data, const char *key, uint32_t &valueSize)
+    {
+        size_t offset = 0;
+        while (offset + sizeof(uint32_t) <= data.size()) {
+            uint32_t keyAndValueByteSize;
+            memcpy(&keyAndValueByteSize, &data[offset], sizeof(uint32_t));
+            offset += sizeof(uint32_t);
+            if (keyAndValueByteSize > data.size() - offset) {
+                return nullptr;
+            }
+            const char *pair = &data[offset];
+            size_t keySize = strnlen(pair, keyAndValueByteSize);
+            if (keySize < keyAndValueByteSize && strcmp(pair, key) == 0) {
+                valueSize = keyAndValueByteSize - (uint32_t)keySize - 1;
+                return pair + keySize + 1;
+            }
+            offset += Padded(keyAndValueByteSize);
+        }
+        return nullptr;
+    }
+}
+
+CCubemapLoader::CCubemapLoader(const unsigned int &threadCount)
+    : m_pool(threadCount)
+{
+}
+
+CCubemapLoader::~CCubemapLoader()
+{
+}
+
+bool CCubemapLoader::LoadCached(const char *cacheFilename, const std::vector<std::string> &faces, SCubemapImage &image)
+{
+    if (cacheFilename != nullptr && LoadKTX(cacheFilename, faces, image)) {
+        return true;
+    }
+
+    if (!Decode(faces, image)) {
+        return false;
+    }
+    if (cacheFilename != nullptr && !SaveKTX(cacheFilename, image, faces)) {
+        std::cout << "Cannot write cubemap cache " << cacheFilename << std::endl;
+    }
+    return true;
+}
+
+bool CCubemapLoader::Decode(const std::vector<std::string> &faces, SCubemapImage &image)
+{
+    if (faces.size() != FACE_COUNT) {
+        return false;
+    }
+
+    // the headers first, the staging buffer has to be sized before the faces are decoded into it
+    int widths[FACE_COUNT], heights[FACE_COUNT], channels[FACE_COUNT];
+    bool readable[FACE_COUNT];
+    m_pool.ParallelFor(FACE_COUNT, [&](unsigned int face) {
+        readable[face] = stbi_info(faces[face].c_str(), &widths[face], &heights[face], &channels[face]) != 0;
+    });
+
+    image.width = widths[0];
+    image.height = heights[0];
+    image.channels = 0;
+    for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+        if (!readable[face]) {
+            std::cout << "Cannot load cubemap face " << faces[face] << std::endl;
+            return false;
+        }
+        if (widths[face] != image.width || heights[face] != image.height || widths[face] != heights[face]) {
+            std::cout << "Cubemap face " << faces[face] << " is " << widths[face] << " x " << heights[face]
+                      << ", the faces must be square and of the same size" << std::endl;
+            return false;
+        }
+        image.channels = std::max(image.channels, channels[face]);
+    }
+
+    // FreeImage hands the rows over bottom first and the face sets are flipped for it. The flag is
+    // global in this version of stb_image, so it is set here before the workers read it.
+    stbi_set_flip_vertically_on_load(true);
+
+    image.pixels.resize(FACE_COUNT * image.GetFaceSize());
+    m_pool.ParallelFor(FACE_COUNT, [&](unsigned int face) {
+        int width, height, fileChannels;
+        unsigned char *data = stbi_load(faces[face].c_str(), &width, &height, &fileChannels, image.channels);
+        readable[face] = data != nullptr && width == image.width && height == image.height;
+        if (readable[face]) {
+            memcpy(image.pixels.data() + face * image.GetFaceSize(), data, image.GetFaceSize());
+        }
+        stbi_image_free(data);
+    });
+
+    for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+        if (!readable[face]) {
+            std::cout << "Cannot load cubemap face " << faces[face] << std::endl;
+            image.pixels.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CCubemapLoader::SaveKTX(const char *filename, const SCubemapImage &image, const std::vector<std::string> &faces)
+{
+    SSourceStamp stamps[FACE_COUNT];
+    if (image.pixels.empty() || image.channels < 1 || image.channels > 4 || faces.size() != FACE_COUNT
+        || !StampSources(faces, stamps)) {
+        return false;
+    }
+
+    std::vector<char> keyValueData;
+    AppendKeyValue(keyValueData, KTX_ORIENTATION_KEY, KTX_ORIENTATION, sizeof(KTX_ORIENTATION));
+    AppendKeyValue(keyValueData, KTX_SOURCES_KEY, stamps, sizeof(stamps));
+
+    SKTXHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.identifier, KTX_IDENTIFIER, sizeof(header.identifier));
+    header.endianness = KTX_ENDIANNESS;
+    header.glType = KTX_UNSIGNED_BYTE;
+    header.glTypeSize = 1;
+    header.glFormat = header.glBaseInternalFormat = KTX_FORMATS[image.channels - 1];
+    header.glInternalFormat = KTX_INTERNAL_FORMATS[image.channels - 1];
+    header.pixelWidth = image.width;
+    header.pixelHeight = image.height;
+    header.numberOfFaces = FACE_COUNT;
+    header.numberOfMipmapLevels = 1;
+    header.bytesOfKeyValueData = (uint32_t)keyValueData.size();
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write(keyValueData.data(), keyValueData.size());
+
+    // KTX rows are padded to four bytes, the staging buffer is packed
+    const uint32_t rowSize = image.width * image.channels;
+    const uint32_t paddedRowSize = Padded(rowSize);
+    const uint32_t imageSize = paddedRowSize * image.height;
+    file.write((const char*)&imageSize, sizeof(imageSize));
+    const char padding[4] = { 0, 0, 0, 0 };
+    for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+        const unsigned char *pixels = image.GetFace(face);
+        for (int y = 0; y < image.height; ++y) {
+            file.write((const char*)pixels + (size_t)y * rowSize, rowSize);
+            file.write(padding, paddedRowSize - rowSize);
+        }
+    }
+    return file.good();
+}
+
+bool CCubemapLoader::LoadKTX(const char *filename, const std::vector<std::string> &faces, SCubemapImage &image)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open() || faces.size() != FACE_COUNT) {
+        return false;
+    }
+
+    SKTXHeader header;
+    file.read((char*)&header, sizeof(header));
+    if (!file.good() || memcmp(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0
+        || header.endianness != KTX_ENDIANNESS || header.glType != KTX_UNSIGNED_BYTE || header.glTypeSize != 1
+        || header.numberOfFaces != FACE_COUNT || header.numberOfArrayElements != 0 || header.pixelDepth != 0
+        || header.numberOfMipmapLevels != 1 || header.pixelWidth == 0 || header.pixelWidth != header.pixelHeight) {
+        return false;
+    }
+
+    int channels = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (header.glFormat == KTX_FORMATS[i] && header.glInternalFormat == KTX_INTERNAL_FORMATS[i]) {
+            channels = i + 1;
+        }
+    }
+    if (channels == 0 || header.bytesOfKeyValueData > (1u << 16)) {
+        return false;
+    }
+
+    // a stale cache is simply ignored, the caller decodes the faces again
+    std::vector<char> keyValueData(header.bytesOfKeyValueData);
+    file.read(keyValueData.data(), keyValueData.size());
+    SSourceStamp stamps[FACE_COUNT];
+    uint32_t stampsSize = 0;
+    const char *cachedStamps = FindKeyValue(keyValueData, KTX_SOURCES_KEY, stampsSize);
+    if (!file.good() || cachedStamps == nullptr || stampsSize != sizeof(stamps)
+        || !StampSources(faces, stamps) || memcmp(cachedStamps, stamps, sizeof(stamps)) != 0) {
+        return false;
+    }
+
+    const uint32_t rowSize = header.pixelWidth * channels;
+    const uint32_t paddedRowSize = Padded(rowSize);
+    uint32_t imageSize = 0;
+    file.read((char*)&imageSize, sizeof(imageSize));
+    if (!file.good() || imageSize != paddedRowSize * header.pixelHeight) {
+        return false;
+    }
+
+    image.width = header.pixelWidth;
+    image.height = header.pixelHeight;
+    image.channels = channels;
+    image.pixels.resize(FACE_COUNT * image.GetFaceSize());
+    char padding[4];
+    for (unsigned int face = 0; face < FACE_COUNT; ++face) {
+        unsigned char *pixels = image.pixels.data() + face * image.GetFaceSize();
+        for (int y = 0; y < image.height; ++y) {
+            file.read((char*)pixels + (size_t)y * rowSize, rowSize);
+            file.read(padding, paddedRowSize - rowSize);
+        }
+    }
+
+    if (!file.good()) {
+        image.pixels.clear();
+        return false;
+    }
+    return true;
+}
+
+std::string CCubemapLoader::GetCachePath(const std::vector<std::string> &faces)
+{
+    if (faces.empty()) {
+        return std::string();
+    }
+    size_t separator = faces[0].find_last_of("/\\");
+    return (separator == std::string::npos ? std::string() : faces[0].substr(0, separator + 1)) + "cubemap.ktx";
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef CubemapLoader_h
+#define CubemapLoader_h
+
+#include <string>
+#include <vector>
+
+#include "../utilities/ThreadPool.h"
+
+// the six faces of a cubemap in OpenGL order (+X, -X, +Y, -Y, +Z, -Z), one
+// after the other in a single staging buffer. Every face is width x height
+// pixels of channels bytes with the rows packed, bottom row first like the
+// FreeImage bitmaps the skybox face sets were flipped for.
+struct SCubemapImage
+{
+    int width, height, channels;
+    std::vector<unsigned char> pixels;
+
+    size_t GetFaceSize() const { return (size_t)width * height * channels; }
+    const unsigned char *GetFace(const unsigned int &face) const { return pixels.data() + face * GetFaceSize(); }
+};
+
+// Decodes the six face images of a skybox without any OpenGL calls. The faces
+// are decoded in parallel straight into one staging buffer, keeping the
+// channel count of the files, and the result can be written to a single file
+// KTX cubemap that is reused as long as the face files do not change.
+// CCubemap::LoadCubemap uploads the result.
+class CCubemapLoader
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CCubemapLoader(const unsigned int &threadCount = 0);
+    ~CCubemapLoader();
+
+    ///Loads the cubemap from cacheFilename when it was written from the same face files, otherwise decodes
+    ///the faces and writes the cache. A null cacheFilename only decodes. Returns false when a face cannot be read.
+    bool LoadCached(const char *cacheFilename, const std::vector<std::string> &faces, SCubemapImage &image);
+
+    ///Decodes the six faces in parallel. They must all be square and of the same size, the channel count is
+    ///the largest one of the files. Returns false otherwise or when a face cannot be read.
+    bool Decode(const std::vector<std::string> &faces, SCubemapImage &image);
+
+    ///Writes a KTX 1.1 cubemap with a single level, recording the size and modification time of the faces.
+    static bool SaveKTX(const char *filename, const SCubemapImage &image, const std::vector<std::string> &faces);
+    ///Reads a file written by SaveKTX. A cache written from other or since modified faces is rejected.
+    static bool LoadKTX(const char *filename, const std::vector<std::string> &faces, SCubemapImage &image);
+
+    ///cubemap.ktx next to the first face.
+    static std::string GetCachePath(const std::vector<std::string> &faces);
+
+    unsigned int GetThreadCount() const { return m_pool.GetThreadCount() + 1; }
+
+private:
+    CThreadPool m_pool;
+};
+
+#endif /* CubemapLoader_h */
@@ -98,6 +98,55 @@ void CTexture::CreateFromData(BYTE* data, GLint width, GLint height, GLint bpp,
     
 }
 
+// Create a texture from mip levels filtered on the CPU, which unlike glGenerateMipmap are filtered in linear light
+// for sRGB data and the same on every driver.
+void CTexture::CreateFromMipChain(const std::vector<SMipLevel> &levels, GLenum format, const TextureType &type,
+                                  GLboolean gammaCorrection)
+{
+    glGenTextures(1, &m_textureID);
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+
+    GLenum internalFormat;
+    GLint bpp;
+    // We must handle this because of internal format parameter
+    if(format == GL_RGBA || format == GL_BGRA){
+        internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
+        if(gammaCorrection)format=GL_RGBA;
+        bpp = 32;
+    }
+    else if(format == GL_RGB || format == GL_BGR){
+        internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
+        if(gammaCorrection)format=GL_RGB;
+        bpp = 24;
+    }
+    else if(format == GL_RED ){
+        internalFormat = GL_RED;
+        bpp = 8;
+    }
+    else{
+        internalFormat = format;
+        bpp = 8;
+    }
+
+    // the levels have packed rows, which are not 4 byte aligned for RGB
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level = 0; level < levels.size(); ++level) {
+        glTexImage2D(GL_TEXTURE_2D, (GLint)level, internalFormat, levels[level].width, levels[level].height, 0, format,
+                     GL_UNSIGNED_BYTE, levels[level].pixels.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels.empty() ? 0 : (GLint)levels.size() - 1);
+    glGenSamplers(1, &m_samplerObjectID);
+
+    m_path = "";
+    m_type = type;
+    m_format = format;
+    m_mipMapsGenerated = levels.size() > 1;
+    m_width = levels.empty() ? 0 : levels[0].width;
+    m_height = levels.empty() ? 0 : levels[0].height;
+    m_bpp = bpp;
+}
+
 // Loads a 2D texture given the filename (sPath).  bGenerateMipMaps will generate a mipmapped texture if true
 GLboolean CTexture::LoadTexture(const std::string &path, const TextureType &type, const GLboolean &generateMipMaps)
 {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../TextureBase.h"
+#include "TextureResampler.h"
 
 // Class that provides a texture for texture mapping in OpenGL
 class CTexture
@@ -8,6 +9,9 @@ class CTexture
 public:
     void CreateFromData(BYTE* data, GLint width, GLint height, GLint bpp, GLenum format, const TextureType &type,
                         GLboolean generateMipMaps = true, GLboolean gammaCorrection = false);
+    ///Uploads a chain built by CTextureResampler::BuildMipChain level by level instead of generating the mip maps on the GPU.
+    void CreateFromMipChain(const std::vector<SMipLevel> &levels, GLenum format, const TextureType &type,
+                            GLboolean gammaCorrection = false);
     GLboolean LoadTexture(const std::string &path, const TextureType &type, const GLboolean &generateMipMaps);
     GLuint LoadTexture(char const * path, const TextureType &type = TextureType::AMBIENT,
                        const GLboolean &generateMipMaps = true, GLboolean gammaCorrection = false);
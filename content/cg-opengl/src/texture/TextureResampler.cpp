@@ -0,0 +1,616 @@
+#include "TextureResampler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// The project's one copy of the stb_image_resize implementation. The resampler
+// takes its filter weights and sRGB tables from it, so that both give the
+// same pixels.
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb/stb_image_resize.h>
+
+// SSE2 is there on every x64 CPU, AVX2 is looked for at run time, so one build
+// runs everywhere. The AVX2 functions are compiled for AVX2 on their own.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLER_USE_SSE
+#if defined(_MSC_VER) || defined(__GNUC__)
+#include <immintrin.h>
+#define RESAMPLER_USE_AVX2
+#endif
+#endif
+
+#if defined(RESAMPLER_USE_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(RESAMPLER_USE_AVX2) && defined(__GNUC__)
+#define RESAMPLER_AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define RESAMPLER_AVX2_FUNCTION
+#endif
+
+namespace {
+    // bands per thread, so that the last bands still keep every thread busy
+    const int BANDS_PER_THREAD = 4;
+    // smaller bands would spend most of their time filtering the input rows they share with the next band
+    const int MIN_BAND_ROWS = 8;
+    // above this the horizontally filtered rows a band keeps are too big, stbir does such resizes itself
+    const size_t MAX_BAND_CACHE_BYTES = 64u << 20;
+
+    // The taps of one axis as a list per output sample: the input samples it
+    // sums, already wrapped by the edge mode, in the order stbir adds them.
+    // Every list is padded with zero weights to the same width.
+    struct STaps
+    {
+        int width;
+        std::vector<int> used;
+        std::vector<int> index;
+        std::vector<float> weight;
+    };
+
+    struct SResizeJob
+    {
+        const unsigned char *input;
+        int inputW, inputH, inputStride;
+        unsigned char *output;
+        int outputW, outputH, outputStride;
+        int channels;
+        int lanes;                  // floats per pixel in the work rows, RGB is padded to four
+        int alphaChannel;
+        int flags;
+        bool srgb;
+        bool avx2;
+        STaps horizontal, vertical;
+    };
+
+    bool CPUHasAVX2()
+    {
+#if defined(RESAMPLER_USE_AVX2) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        // OSXSAVE and AVX, and the OS has to save the ymm registers
+        if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(RESAMPLER_USE_AVX2)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }
+
+    void BuildTaps(STaps &taps, stbir_filter filter, float scale, int inputSize, int outputSize, stbir_edge edge)
+    {
+        int contributorCount = stbir__get_contributors(scale, filter, inputSize, outputSize);
+        int coefficientWidth = stbir__get_coefficient_width(filter, scale);
+        std::vector<stbir__contributors> contributors(contributorCount);
+        std::vector<float> coefficients((size_t)contributorCount * coefficientWidth, 0.0f);
+        stbir__calculate_filters(contributors.data(), coefficients.data(), filter, scale, 0.0f, inputSize, outputSize);
+
+        // upsampling contributors are output samples listing their inputs, downsampling ones are input samples
+        // (margin included) listing the outputs they add to
+        bool upsampling = stbir__use_upsampling(scale) != 0;
+        int margin = upsampling ? 0 : stbir__get_filter_pixel_margin(filter, scale);
+        std::vector<std::vector<std::pair<int, float>>> lists(outputSize);
+        for (int n = 0; n < contributorCount; ++n) {
+            const stbir__contributors &contributor = contributors[n];
+            const float *coefficient = &coefficients[(size_t)n * coefficientWidth];
+            for (int k = contributor.n0; k <= contributor.n1; ++k) {
+                int in = upsampling ? k : n - margin;
+                int out = upsampling ? n : k;
+                if (edge == STBIR_EDGE_ZERO && (in < 0 || in >= inputSize))
+                    continue;
+                // stbir reflects samples further than the image size before it to outside the image and reads
+                // past the row, those are clamped here
+                int wrapped = std::min(std::max(stbir__edge_wrap(edge, in, inputSize), 0), inputSize - 1);
+                lists[out].push_back(std::make_pair(wrapped, coefficient[k - contributor.n0]));
+            }
+        }
+
+        taps.width = 1;
+        for (const auto &list : lists) {
+            taps.width = std::max(taps.width, (int)list.size());
+        }
+        taps.used.resize(outputSize);
+        taps.index.assign((size_t)outputSize * taps.width, 0);
+        taps.weight.assign((size_t)outputSize * taps.width, 0.0f);
+        for (int out = 0; out < outputSize; ++out) {
+            const auto &list = lists[out];
+            int *index = &taps.index[(size_t)out * taps.width];
+            float *weight = &taps.weight[(size_t)out * taps.width];
+            taps.used[out] = (int)list.size();
+            for (int t = 0; t < taps.width; ++t) {
+                // the padding reads a sample that is there anyway and adds nothing
+                index[t] = list.empty() ? 0 : list[std::min(t, (int)list.size() - 1)].first;
+                weight[t] = t < (int)list.size() ? list[t].second : 0.0f;
+            }
+        }
+    }
+
+    inline unsigned char EncodeLinear(float value)
+    {
+        return (unsigned char)(int)(stbir__saturate(value) * stbir__max_uint8_as_float + 0.5);
+    }
+
+    inline bool AlphaIsLinear(const SResizeJob &job, int channel)
+    {
+        return channel == job.alphaChannel && !(job.flags & STBIR_FLAG_ALPHA_USES_COLORSPACE);
+    }
+
+    // pixels [x0, x1) of an input row to linear floats, premultiplied by alpha unless they already are
+    void DecodePixels(const SResizeJob &job, const unsigned char *pixels, float *decoded, int x0, int x1)
+    {
+        for (int x = x0; x < x1; ++x) {
+            const unsigned char *in = pixels + (size_t)x * job.channels;
+            float *out = decoded + (size_t)x * job.lanes;
+            for (int c = 0; c < job.channels; ++c) {
+                out[c] = job.srgb && !AlphaIsLinear(job, c) ? stbir__srgb_uchar_to_linear_float[in[c]] : in[c] / stbir__max_uint8_as_float;
+            }
+            for (int c = job.channels; c < job.lanes; ++c) {
+                out[c] = 0.0f;
+            }
+
+            if (!(job.flags & STBIR_FLAG_ALPHA_PREMULTIPLIED)) {
+                float alpha = out[job.alphaChannel];
+#ifndef STBIR_NO_ALPHA_EPSILON
+                alpha += STBIR_ALPHA_EPSILON;
+                out[job.alphaChannel] = alpha;
+#endif
+                for (int c = 0; c < job.channels; ++c) {
+                    if (c != job.alphaChannel)
+                        out[c] *= alpha;
+                }
+            }
+        }
+    }
+
+    // pixels [x0, x1) of a filtered row back to 8 bit
+    void EncodePixels(const SResizeJob &job, float *summed, unsigned char *pixels, int x0, int x1)
+    {
+        for (int x = x0; x < x1; ++x) {
+            float *in = summed + (size_t)x * job.lanes;
+            unsigned char *out = pixels + (size_t)x * job.channels;
+
+            if (!(job.flags & STBIR_FLAG_ALPHA_PREMULTIPLIED)) {
+                float alpha = in[job.alphaChannel];
+                float reciprocal = alpha ? 1.0f / alpha : 0;
+                for (int c = 0; c < job.channels; ++c) {
+                    if (c != job.alphaChannel)
+                        in[c] *= reciprocal;
+                }
+            }
+
+            for (int c = 0; c < job.channels; ++c) {
+                out[c] = job.srgb && !AlphaIsLinear(job, c) ? stbir__linear_to_srgb_uchar(in[c]) : EncodeLinear(in[c]);
+            }
+        }
+    }
+
+    void FilterRowScalar(const SResizeJob &job, const float *decoded, float *filtered)
+    {
+        const STaps &taps = job.horizontal;
+        const int lanes = job.lanes;
+        for (int o = 0; o < job.outputW; ++o) {
+            const int *index = &taps.index[(size_t)o * taps.width];
+            const float *weight = &taps.weight[(size_t)o * taps.width];
+            float *out = filtered + (size_t)o * lanes;
+            for (int c = 0; c < lanes; ++c) {
+                out[c] = 0.0f;
+            }
+            for (int t = 0; t < taps.used[o]; ++t) {
+                const float *in = decoded + (size_t)index[t] * lanes;
+                for (int c = 0; c < lanes; ++c) {
+                    out[c] += in[c] * weight[t];
+                }
+            }
+        }
+    }
+
+    void SumRowsScalar(const float *const *rows, const float *weight, int used, float *summed, int x0, int x1)
+    {
+        for (int x = x0; x < x1; ++x) {
+            float sum = 0.0f;
+            for (int t = 0; t < used; ++t) {
+                sum += rows[t][x] * weight[t];
+            }
+            summed[x] = sum;
+        }
+    }
+
+    // Products and sums stay separate instructions in the SIMD passes, a fused
+    // multiply-add would round differently from stbir.
+#ifdef RESAMPLER_USE_SSE
+    void FilterRowSSE(const SResizeJob &job, const float *decoded, float *filtered, int o0)
+    {
+        const STaps &taps = job.horizontal;
+        for (int o = o0; o < job.outputW; ++o) {
+            const int *index = &taps.index[(size_t)o * taps.width];
+            const float *weight = &taps.weight[(size_t)o * taps.width];
+            __m128 sum = _mm_setzero_ps();
+            for (int t = 0; t < taps.used[o]; ++t) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(decoded + (size_t)index[t] * 4), _mm_set1_ps(weight[t])));
+            }
+            _mm_storeu_ps(filtered + (size_t)o * 4, sum);
+        }
+    }
+
+    void SumRowsSSE(const float *const *rows, const float *weight, int used, float *summed, int count)
+    {
+        int x = 0;
+        for (; x + 16 <= count; x += 16) {
+            __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+            for (int t = 0; t < used; ++t) {
+                const float *row = rows[t] + x;
+                __m128 w = _mm_set1_ps(weight[t]);
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(row), w));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(row + 4), w));
+                sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(row + 8), w));
+                sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(row + 12), w));
+            }
+            _mm_storeu_ps(summed + x, sum0);
+            _mm_storeu_ps(summed + x + 4, sum1);
+            _mm_storeu_ps(summed + x + 8, sum2);
+            _mm_storeu_ps(summed + x + 12, sum3);
+        }
+        SumRowsScalar(rows, weight, used, summed, x, count);
+    }
+#endif
+
+#ifdef RESAMPLER_USE_AVX2
+    // two RGBA pixels per register, so each output pair walks the longer of its two tap lists
+    RESAMPLER_AVX2_FUNCTION void FilterRowAVX2(const SResizeJob &job, const float *decoded, float *filtered)
+    {
+        const STaps &taps = job.horizontal;
+        int o = 0;
+        for (; o + 2 <= job.outputW; o += 2) {
+            const int *indexA = &taps.index[(size_t)o * taps.width];
+            const int *indexB = indexA + taps.width;
+            const float *weightA = &taps.weight[(size_t)o * taps.width];
+            const float *weightB = weightA + taps.width;
+            int used = std::max(taps.used[o], taps.used[o + 1]);
+            __m256 sum = _mm256_setzero_ps();
+            for (int t = 0; t < used; ++t) {
+                __m256 in = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(decoded + (size_t)indexA[t] * 4)),
+                                                 _mm_loadu_ps(decoded + (size_t)indexB[t] * 4), 1);
+                __m256 w = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(weightA[t])), _mm_set1_ps(weightB[t]), 1);
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(in, w));
+            }
+            _mm256_storeu_ps(filtered + (size_t)o * 4, sum);
+        }
+        FilterRowSSE(job, decoded, filtered, o);
+    }
+
+    RESAMPLER_AVX2_FUNCTION void SumRowsAVX2(const float *const *rows, const float *weight, int used, float *summed, int count)
+    {
+        int x = 0;
+        for (; x + 32 <= count; x += 32) {
+            __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps(), sum2 = _mm256_setzero_ps(), sum3 = _mm256_setzero_ps();
+            for (int t = 0; t < used; ++t) {
+                const float *row = rows[t] + x;
+                __m256 w = _mm256_set1_ps(weight[t]);
+                sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(row), w));
+                sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(row + 8), w));
+                sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(_mm256_loadu_ps(row + 16), w));
+                sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(_mm256_loadu_ps(row + 24), w));
+            }
+            _mm256_storeu_ps(summed + x, sum0);
+            _mm256_storeu_ps(summed + x + 8, sum1);
+            _mm256_storeu_ps(summed + x + 16, sum2);
+            _mm256_storeu_ps(summed + x + 24, sum3);
+        }
+        for (; x + 8 <= count; x += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (int t = 0; t < used; ++t) {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows[t] + x), _mm256_set1_ps(weight[t])));
+            }
+            _mm256_storeu_ps(summed + x, sum);
+        }
+        SumRowsScalar(rows, weight, used, summed, x, count);
+    }
+
+    // lanes of two RGBA pixels that hold the given channel
+    RESAMPLER_AVX2_FUNCTION inline __m256 ChannelMaskAVX2(int channel)
+    {
+        __m256i lane = _mm256_and_si256(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(3));
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(lane, _mm256_set1_epi32(channel)));
+    }
+
+    // sRGB RGBA rows, two pixels at a time, with the table lookups done by gathers
+    RESAMPLER_AVX2_FUNCTION void DecodeRowAVX2(const SResizeJob &job, const unsigned char *pixels, float *decoded)
+    {
+        const bool linearAlpha = job.alphaChannel >= 0 && AlphaIsLinear(job, job.alphaChannel);
+        const bool premultiply = !(job.flags & STBIR_FLAG_ALPHA_PREMULTIPLIED);
+        const __m256 alphaMask = ChannelMaskAVX2(job.alphaChannel);
+        const __m256i alphaLane = _mm256_set1_epi32(std::max(job.alphaChannel, 0));
+        int x = 0;
+        for (; x + 2 <= job.inputW; x += 2) {
+            __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(pixels + (size_t)x * 4)));
+            __m256 value = _mm256_i32gather_ps(stbir__srgb_uchar_to_linear_float, bytes, 4);
+            if (linearAlpha) {
+                __m256 linear = _mm256_div_ps(_mm256_cvtepi32_ps(bytes), _mm256_set1_ps(stbir__max_uint8_as_float));
+                value = _mm256_blendv_ps(value, linear, alphaMask);
+            }
+            if (premultiply) {
+#ifndef STBIR_NO_ALPHA_EPSILON
+                value = _mm256_blendv_ps(value, _mm256_add_ps(value, _mm256_set1_ps(STBIR_ALPHA_EPSILON)), alphaMask);
+#endif
+                __m256 alpha = _mm256_permutevar_ps(value, alphaLane);
+                value = _mm256_blendv_ps(_mm256_mul_ps(value, alpha), value, alphaMask);
+            }
+            _mm256_storeu_ps(decoded + (size_t)x * 4, value);
+        }
+        DecodePixels(job, pixels, decoded, x, job.inputW);
+    }
+
+#ifndef STBIR_NON_IEEE_FLOAT
+    // stbir__linear_to_srgb_uchar on eight values
+    RESAMPLER_AVX2_FUNCTION inline __m256i LinearToSRGB8AVX2(__m256 value)
+    {
+        const __m256i minimum = _mm256_set1_epi32((127 - 13) << 23);
+        // max returns the second operand for NaN, which maps NaN to 0 like stbir does
+        __m256 clamped = _mm256_max_ps(value, _mm256_castsi256_ps(minimum));
+        clamped = _mm256_min_ps(clamped, _mm256_castsi256_ps(_mm256_set1_epi32(0x3f7fffff)));
+        __m256i bits = _mm256_castps_si256(clamped);
+        __m256i table = _mm256_i32gather_epi32((const int *)fp32_to_srgb8_tab4, _mm256_srli_epi32(_mm256_sub_epi32(bits, minimum), 20), 4);
+        __m256i bias = _mm256_slli_epi32(_mm256_srli_epi32(table, 16), 9);
+        __m256i scale = _mm256_and_si256(table, _mm256_set1_epi32(0xffff));
+        __m256i t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), _mm256_set1_epi32(0xff));
+        return _mm256_srli_epi32(_mm256_add_epi32(bias, _mm256_mullo_epi32(scale, t)), 16);
+    }
+
+    RESAMPLER_AVX2_FUNCTION void EncodeRowAVX2(const SResizeJob &job, float *summed, unsigned char *pixels)
+    {
+        const bool linearAlpha = job.alphaChannel >= 0 && AlphaIsLinear(job, job.alphaChannel);
+        const bool unpremultiply = !(job.flags & STBIR_FLAG_ALPHA_PREMULTIPLIED);
+        const __m256 alphaMask = ChannelMaskAVX2(job.alphaChannel);
+        const __m256i alphaLane = _mm256_set1_epi32(std::max(job.alphaChannel, 0));
+        int x = 0;
+        for (; x + 2 <= job.outputW; x += 2) {
+            __m256 value = _mm256_loadu_ps(summed + (size_t)x * 4);
+            if (unpremultiply) {
+                __m256 alpha = _mm256_permutevar_ps(value, alphaLane);
+                // 1 / alpha, or 0 where alpha is 0
+                __m256 reciprocal = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), alpha), _mm256_cmp_ps(alpha, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+                value = _mm256_blendv_ps(_mm256_mul_ps(value, reciprocal), value, alphaMask);
+            }
+            __m256i srgb = LinearToSRGB8AVX2(value);
+            __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(srgb), _mm256_extracti128_si256(srgb, 1));
+            unsigned char *out = pixels + (size_t)x * 4;
+            _mm_storel_epi64((__m128i *)out, _mm_packus_epi16(words, words));
+            if (linearAlpha) {
+                float lanes[8];
+                _mm256_storeu_ps(lanes, value);
+                out[job.alphaChannel] = EncodeLinear(lanes[job.alphaChannel]);
+                out[4 + job.alphaChannel] = EncodeLinear(lanes[4 + job.alphaChannel]);
+            }
+        }
+        EncodePixels(job, summed, pixels, x, job.outputW);
+    }
+#endif
+#endif
+
+    void DecodeRow(const SResizeJob &job, int row, float *decoded)
+    {
+        const unsigned char *pixels = job.input + (size_t)row * job.inputStride;
+#ifdef RESAMPLER_USE_AVX2
+        if (job.avx2 && job.srgb && job.channels == 4) {
+            DecodeRowAVX2(job, pixels, decoded);
+            return;
+        }
+#endif
+        DecodePixels(job, pixels, decoded, 0, job.inputW);
+    }
+
+    void EncodeRow(const SResizeJob &job, float *summed, int row)
+    {
+        unsigned char *pixels = job.output + (size_t)row * job.outputStride;
+#if defined(RESAMPLER_USE_AVX2) && !defined(STBIR_NON_IEEE_FLOAT)
+        if (job.avx2 && job.srgb && job.channels == 4) {
+            EncodeRowAVX2(job, summed, pixels);
+            return;
+        }
+#endif
+        EncodePixels(job, summed, pixels, 0, job.outputW);
+    }
+
+    void FilterRow(const SResizeJob &job, const float *decoded, float *filtered)
+    {
+#ifdef RESAMPLER_USE_SSE
+        if (job.lanes == 4) {
+#ifdef RESAMPLER_USE_AVX2
+            if (job.avx2) {
+                FilterRowAVX2(job, decoded, filtered);
+                return;
+            }
+#endif
+            FilterRowSSE(job, decoded, filtered, 0);
+            return;
+        }
+#endif
+        FilterRowScalar(job, decoded, filtered);
+    }
+
+    void SumRows(const SResizeJob &job, const float *const *rows, const float *weight, int used, float *summed)
+    {
+        const int count = job.outputW * job.lanes;
+#ifdef RESAMPLER_USE_AVX2
+        if (job.avx2) {
+            SumRowsAVX2(rows, weight, used, summed, count);
+            return;
+        }
+#endif
+#ifdef RESAMPLER_USE_SSE
+        SumRowsSSE(rows, weight, used, summed, count);
+#else
+        SumRowsScalar(rows, weight, used, summed, 0, count);
+#endif
+    }
+
+    // Output rows [y0, y1). The input rows they need are decoded and filtered
+    // horizontally once each into a few slots, which neighbouring output rows
+    // share, and then summed vertically.
+    void ResizeBand(const SResizeJob &job, int y0, int y1)
+    {
+        const STaps &taps = job.vertical;
+        const size_t rowFloats = (size_t)job.outputW * job.lanes;
+        const int slotCount = taps.width + 1;
+        std::vector<float> decoded((size_t)job.inputW * job.lanes);
+        std::vector<float> filtered(slotCount * rowFloats);
+        std::vector<float> summed(rowFloats);
+        std::vector<int> slotRow(slotCount, -1);
+        std::vector<const float *> rows(taps.width);
+        int nextSlot = 0;
+
+        for (int y = y0; y < y1; ++y) {
+            const int *index = &taps.index[(size_t)y * taps.width];
+            const float *weight = &taps.weight[(size_t)y * taps.width];
+            const int used = taps.used[y];
+
+            for (int t = 0; t < used; ++t) {
+                int slot = (int)(std::find(slotRow.begin(), slotRow.end(), index[t]) - slotRow.begin());
+                if (slot == slotCount) {
+                    // the oldest slot this output row does not read, there is always one more slot than taps
+                    while (std::find(index, index + used, slotRow[nextSlot]) != index + used) {
+                        nextSlot = (nextSlot + 1) % slotCount;
+                    }
+                    slot = nextSlot;
+                    nextSlot = (nextSlot + 1) % slotCount;
+                    DecodeRow(job, index[t], decoded.data());
+                    FilterRow(job, decoded.data(), &filtered[slot * rowFloats]);
+                    slotRow[slot] = index[t];
+                }
+                rows[t] = &filtered[slot * rowFloats];
+            }
+
+            SumRows(job, rows.data(), weight, used, summed.data());
+            EncodeRow(job, summed.data(), y);
+        }
+    }
+}
+
+CTextureResampler::CTextureResampler(const unsigned int &threadCount):
+    m_pool(threadCount), m_useAVX2(CPUHasAVX2())
+{
+}
+
+CTextureResampler::~CTextureResampler()
+{
+}
+
+void CTextureResampler::SetUseAVX2(const bool &useAVX2)
+{
+    m_useAVX2 = useAVX2 && CPUHasAVX2();
+}
+
+int CTextureResampler::ResizeUint8(const unsigned char *input, int inputW, int inputH, int inputStride,
+                                   unsigned char *output, int outputW, int outputH, int outputStride, int channels)
+{
+    return Resize(input, inputW, inputH, inputStride, output, outputW, outputH, outputStride,
+                  channels, -1, 0, false, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT);
+}
+
+int CTextureResampler::ResizeUint8SRGB(const unsigned char *input, int inputW, int inputH, int inputStride,
+                                       unsigned char *output, int outputW, int outputH, int outputStride,
+                                       int channels, int alphaChannel, int flags, stbir_edge edge, stbir_filter filter)
+{
+    return Resize(input, inputW, inputH, inputStride, output, outputW, outputH, outputStride,
+                  channels, alphaChannel, flags, true, edge, filter);
+}
+
+int CTextureResampler::Resize(const unsigned char *input, int inputW, int inputH, int inputStride,
+                              unsigned char *output, int outputW, int outputH, int outputStride,
+                              int channels, int alphaChannel, int flags, bool srgb, stbir_edge edge, stbir_filter filter)
+{
+    if (!input || !output || inputW <= 0 || inputH <= 0 || outputW <= 0 || outputH <= 0)
+        return 0;
+    if (channels <= 0 || channels > STBIR_MAX_CHANNELS || alphaChannel >= channels)
+        return 0;
+    if (filter < STBIR_FILTER_DEFAULT || filter > STBIR_FILTER_MITCHELL || edge < STBIR_EDGE_CLAMP || edge > STBIR_EDGE_ZERO)
+        return 0;
+
+    // as in stbir, without an alpha channel nothing is weighted by alpha
+    if (alphaChannel < 0)
+        flags |= STBIR_FLAG_ALPHA_USES_COLORSPACE | STBIR_FLAG_ALPHA_PREMULTIPLIED;
+
+    SResizeJob job;
+    job.input = input;
+    job.inputW = inputW;
+    job.inputH = inputH;
+    job.inputStride = inputStride ? inputStride : inputW * channels;
+    job.output = output;
+    job.outputW = outputW;
+    job.outputH = outputH;
+    job.outputStride = outputStride ? outputStride : outputW * channels;
+    job.channels = channels;
+    job.lanes = channels == 3 ? 4 : channels;
+    job.alphaChannel = alphaChannel;
+    job.flags = flags;
+    job.srgb = srgb;
+    job.avx2 = m_useAVX2;
+
+    float horizontalScale = (float)outputW / inputW;
+    float verticalScale = (float)outputH / inputH;
+    stbir_filter horizontalFilter = filter, verticalFilter = filter;
+    if (filter == STBIR_FILTER_DEFAULT) {
+        horizontalFilter = stbir__use_upsampling(horizontalScale) ? STBIR_DEFAULT_FILTER_UPSAMPLE : STBIR_DEFAULT_FILTER_DOWNSAMPLE;
+        verticalFilter = stbir__use_upsampling(verticalScale) ? STBIR_DEFAULT_FILTER_UPSAMPLE : STBIR_DEFAULT_FILTER_DOWNSAMPLE;
+    }
+
+    BuildTaps(job.vertical, verticalFilter, verticalScale, inputH, outputH, edge);
+    if ((size_t)(job.vertical.width + 1) * outputW * job.lanes * sizeof(float) > MAX_BAND_CACHE_BYTES) {
+        return stbir_resize_uint8_generic(input, inputW, inputH, inputStride, output, outputW, outputH, outputStride,
+                                          channels, alphaChannel, flags, edge, filter,
+                                          srgb ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR, NULL);
+    }
+    BuildTaps(job.horizontal, horizontalFilter, horizontalScale, inputW, outputW, edge);
+
+    // a single thread does the whole image as one band, so that no input row is filtered twice
+    int threads = (int)GetThreadCount();
+    int bandRows = outputH;
+    if (threads > 1) {
+        bandRows = std::max(MIN_BAND_ROWS, (outputH + threads * BANDS_PER_THREAD - 1) / (threads * BANDS_PER_THREAD));
+    }
+    int bands = (outputH + bandRows - 1) / bandRows;
+    m_pool.ParallelFor(bands, [&](unsigned int band) {
+        int y0 = (int)band * bandRows;
+        ResizeBand(job, y0, std::min(outputH, y0 + bandRows));
+    });
+    return 1;
+}
+
+bool CTextureResampler::BuildMipChain(const unsigned char *pixels, int width, int height, int channels, int alphaChannel, bool srgb,
+                                      std::vector<SMipLevel> &levels, stbir_filter filter)
+{
+    levels.clear();
+    if (!pixels || width <= 0 || height <= 0 || channels <= 0 || alphaChannel >= channels)
+        return false;
+
+    int levelCount = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) {
+        ++levelCount;
+    }
+    levels.resize(levelCount);
+
+    levels[0].width = width;
+    levels[0].height = height;
+    levels[0].pixels.assign(pixels, pixels + (size_t)width * height * channels);
+
+    // every level comes from the one before it, which is a quarter of the work of going back to level 0
+    for (int i = 1; i < levelCount; ++i) {
+        const SMipLevel &previous = levels[i - 1];
+        SMipLevel &level = levels[i];
+        level.width = std::max(1, previous.width / 2);
+        level.height = std::max(1, previous.height / 2);
+        level.pixels.resize((size_t)level.width * level.height * channels);
+        if (!Resize(previous.pixels.data(), previous.width, previous.height, 0, level.pixels.data(), level.width, level.height, 0,
+                    channels, alphaChannel, 0, srgb, STBIR_EDGE_CLAMP, filter)) {
+            levels.clear();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef TextureResampler_h
+#define TextureResampler_h
+
+#include <vector>
+#include <stb/stb_image_resize.h>
+
+#include "../utilities/ThreadPool.h"
+
+// one level of a mip chain, width x height pixels with the rows packed
+struct SMipLevel
+{
+    int width, height;
+    std::vector<unsigned char> pixels;
+};
+
+// Resizes 8 bit images the way stb_image_resize does, for offline texture
+// baking. The arguments and filter weights are stbir's, and every output
+// pixel sums its taps in the same order, so the result matches a single
+// threaded stbir_resize_uint8(_srgb) call. The output is split into bands of
+// rows that are resized in parallel, and the filter passes and sRGB
+// conversions use AVX2 when the CPU has it (SSE2 otherwise). No OpenGL calls
+// are made, CTexture::CreateFromMipChain uploads the result.
+class CTextureResampler
+{
+public:
+    ///threadCount 0 uses one worker per hardware thread.
+    explicit CTextureResampler(const unsigned int &threadCount = 0);
+    ~CTextureResampler();
+
+    ///Same arguments and result as stbir_resize_uint8: linear data, no alpha channel, clamped edges.
+    int ResizeUint8(const unsigned char *input, int inputW, int inputH, int inputStride,
+                    unsigned char *output, int outputW, int outputH, int outputStride, int channels);
+
+    ///Same arguments and result as stbir_resize_uint8_srgb, plus the edge mode and filter of the generic stbir calls.
+    ///alphaChannel -1 treats every channel as colour.
+    int ResizeUint8SRGB(const unsigned char *input, int inputW, int inputH, int inputStride,
+                        unsigned char *output, int outputW, int outputH, int outputStride,
+                        int channels, int alphaChannel, int flags,
+                        stbir_edge edge = STBIR_EDGE_CLAMP, stbir_filter filter = STBIR_FILTER_DEFAULT);
+
+    ///Fills levels with the whole chain down to 1 x 1, level 0 being a copy of pixels. Each level is half the previous
+    ///one, rounded down as OpenGL does, and is resized from it. sRGB chains are filtered in linear light, and colour is
+    ///weighted by alpha when alphaChannel is not -1. Returns false on invalid arguments.
+    bool BuildMipChain(const unsigned char *pixels, int width, int height, int channels, int alphaChannel, bool srgb,
+                       std::vector<SMipLevel> &levels, stbir_filter filter = STBIR_FILTER_DEFAULT);
+
+    unsigned int GetThreadCount() const { return m_pool.GetThreadCount() + 1; }
+
+    ///Whether the AVX2 passes are in use. They are whenever the CPU has AVX2, SetUseAVX2(false) falls back to SSE2.
+    bool IsUsingAVX2() const { return m_useAVX2; }
+    void SetUseAVX2(const bool &useAVX2);
+
+private:
+    int Resize(const unsigned char *input, int inputW, int inputH, int inputStride,
+               unsigned char *output, int outputW, int outputH, int outputStride,
+               int channels, int alphaChannel, int flags, bool srgb, stbir_edge edge, stbir_filter filter);
+
+    CThreadPool m_pool;
+    bool m_useAVX2;
+};
+
+#endif /* TextureResampler_h */
@@ -0,0 +1,128 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+CThreadPool::CThreadPool(const unsigned int &threadCount): m_busy(0), m_stopping(false)
+{
+    unsigned int count = threadCount;
+    if (count == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        count = hardware > 1 ? hardware - 1 : 0;
+    }
+    
+    m_workers.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        m_workers.emplace_back(&CThreadPool::WorkerLoop, this);
+    }
+}
+
+CThreadPool::~CThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+unsigned int CThreadPool::GetThreadCount() const
+{
+    return (unsigned int)m_workers.size();
+}
+
+void CThreadPool::Enqueue(const std::function<void()> &task)
+{
+    // without workers the task simply runs on the calling thread
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+    m_taskAvailable.notify_one();
+}
+
+void CThreadPool::ParallelFor(const unsigned int &count, const std::function<void(unsigned int)> &task)
+{
+    if (count == 0) {
+        return;
+    }
+    
+    if (m_workers.empty() || count == 1) {
+        for (unsigned int i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    
+    // every participant keeps pulling the next index until the range is exhausted,
+    // so uneven items balance themselves out
+    std::atomic<unsigned int> next(0);
+    auto run = [&]() {
+        unsigned int i;
+        while ((i = next.fetch_add(1)) < count) {
+            task(i);
+        }
+    };
+    
+    unsigned int helpers = std::min((unsigned int)m_workers.size(), count - 1);
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    unsigned int finished = 0;
+    
+    for (unsigned int h = 0; h < helpers; ++h) {
+        Enqueue([&]() {
+            run();
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (++finished == helpers) {
+                doneCondition.notify_one();
+            }
+        });
+    }
+    
+    run();
+    
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&]() { return finished == helpers; });
+}
+
+void CThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_tasks.empty() && m_busy == 0; });
+}
+
+void CThreadPool::WorkerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_busy;
+        }
+        
+        task();
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+            if (m_tasks.empty() && m_busy == 0) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A small pool of worker threads used for the CPU heavy parts of object
+// generation (field evaluation, mesh building, decoding) so that they do
+// not stall the render thread. The pool never touches OpenGL, all GL
+// calls stay on the thread that owns the context.
+class CThreadPool
+{
+public:
+    ///Starts the given number of worker threads, 0 means one per hardware thread minus the calling thread.
+    explicit CThreadPool(const unsigned int &threadCount = 0);
+    ~CThreadPool();
+
+    ///Returns the number of worker threads.
+    unsigned int GetThreadCount() const;
+
+    ///Queues a task to be run asynchronously on one of the worker threads.
+    void Enqueue(const std::function<void()> &task);
+
+    ///Runs task(i) for every i in [0, count) on the workers and the calling thread and returns once all are done.
+    ///Must not be called from inside a task of the same pool.
+    void ParallelFor(const unsigned int &count, const std::function<void(unsigned int)> &task);
+
+    ///Blocks until every queued task has finished.
+    void WaitIdle();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    unsigned int m_busy;
+    bool m_stopping;
+};
+
+#endif /* ThreadPool_h */
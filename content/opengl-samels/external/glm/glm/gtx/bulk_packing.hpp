@@ -0,0 +1,103 @@
+/// @ref gtx_bulk_packing
+/// @file glm/gtx/bulk_packing.hpp
+///
+/// @see core (dependence)
+/// @see gtc_packing (dependence)
+///
+/// @defgroup gtx_bulk_packing GLM_GTX_bulk_packing
+/// @ingroup gtx
+///
+/// Include <glm/gtx/bulk_packing.hpp> to use the features of this extension.
+///
+/// The gtc_packing conversions on whole arrays, to compress vertex and texture data.
+/// - Each element gets the bits of the gtc_packing function named in the comment of its
+///   array function, for denormals, infinities and NaN too. Where the scalar function is
+///   undefined for NaN, the array function returns 0.
+/// - Half floats use F16C when the compiler targets it, SSE2 integer code otherwise. Unorm
+///   and snorm use AVX2, SSE4.1 or SSE2, F2x11_1x10 and RGBM SSE4.1 or SSE2.
+/// - Arrays of at least GLM_BULK_PACKING_PARALLEL_SIZE bytes, source and destination
+///   together, are split over one thread per hardware thread when compiling as C++11.
+/// To convert arrays of vec2 or vec4 to half floats, pass &v[0].x and the component count.
+
+#pragma once
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtc/packing.hpp"
+#include <cstddef>
+
+#if(defined(GLM_MESSAGES) && !defined(GLM_EXT_INCLUDED))
+#	pragma message("GLM: GLM_GTX_bulk_packing extension included")
+#endif
+
+#if !defined(GLM_FORCE_PURE) && (GLM_ARCH & GLM_ARCH_SSE2_BIT)
+#	include <emmintrin.h>
+#	define GLM_BULK_PACKING_SSE2
+#	if GLM_ARCH & GLM_ARCH_SSE41_BIT
+#		include <smmintrin.h>
+#		define GLM_BULK_PACKING_SSE41
+#	endif
+#	if GLM_ARCH & GLM_ARCH_AVX2_BIT
+#		include <immintrin.h>
+#		define GLM_BULK_PACKING_AVX2
+#	endif
+#	if defined(__F16C__) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_ARCH & GLM_ARCH_AVX2_BIT))
+#		include <immintrin.h>
+#		define GLM_BULK_PACKING_F16C
+#	endif
+#endif
+
+#if GLM_LANG & GLM_LANG_CXX11_FLAG
+#	include <thread>
+#	include <vector>
+#endif
+
+/// Arrays of at least this many bytes are converted on several threads, 0 never does.
+#ifndef GLM_BULK_PACKING_PARALLEL_SIZE
+#	define GLM_BULK_PACKING_PARALLEL_SIZE (16 << 20)
+#endif
+
+namespace glm
+{
+	/// @addtogroup gtx_bulk_packing
+	/// @{
+
+	/// Dst[i] = packHalf1x16(Src[i]).
+	GLM_FUNC_DECL void packHalf(uint16* Dst, float const* Src, std::size_t Count);
+
+	/// Dst[i] = unpackHalf1x16(Src[i]).
+	GLM_FUNC_DECL void unpackHalf(float* Dst, uint16 const* Src, std::size_t Count);
+
+	/// Dst[i] = packUnorm1x8(Src[i]) or packUnorm1x16(Src[i]).
+	GLM_FUNC_DECL void packUnorm(uint8* Dst, float const* Src, std::size_t Count);
+	GLM_FUNC_DECL void packUnorm(uint16* Dst, float const* Src, std::size_t Count);
+
+	/// Dst[i] = unpackUnorm1x8(Src[i]) or unpackUnorm1x16(Src[i]).
+	GLM_FUNC_DECL void unpackUnorm(float* Dst, uint8 const* Src, std::size_t Count);
+	GLM_FUNC_DECL void unpackUnorm(float* Dst, uint16 const* Src, std::size_t Count);
+
+	/// Dst[i] = packSnorm1x8(Src[i]) or packSnorm1x16(Src[i]), as signed integers.
+	GLM_FUNC_DECL void packSnorm(int8* Dst, float const* Src, std::size_t Count);
+	GLM_FUNC_DECL void packSnorm(int16* Dst, float const* Src, std::size_t Count);
+
+	/// Dst[i] = unpackSnorm1x8(Src[i]) or unpackSnorm1x16(Src[i]), from signed integers.
+	GLM_FUNC_DECL void unpackSnorm(float* Dst, int8 const* Src, std::size_t Count);
+	GLM_FUNC_DECL void unpackSnorm(float* Dst, int16 const* Src, std::size_t Count);
+
+	/// Dst[i] = packF2x11_1x10(Src[i]).
+	GLM_FUNC_DECL void packF2x11_1x10(uint32* Dst, vec3 const* Src, std::size_t Count);
+
+	/// Dst[i] = unpackF2x11_1x10(Src[i]). Like the scalar function, it returns -1 for the
+	/// infinity and NaN codes.
+	GLM_FUNC_DECL void unpackF2x11_1x10(vec3* Dst, uint32 const* Src, std::size_t Count);
+
+	/// Dst[i] = packRGBM(Src[i]).
+	GLM_FUNC_DECL void packRGBM(vec4* Dst, vec3 const* Src, std::size_t Count);
+
+	/// Dst[i] = unpackRGBM(Src[i]).
+	GLM_FUNC_DECL void unpackRGBM(vec3* Dst, vec4 const* Src, std::size_t Count);
+
+	/// @}
+}//namespace glm
+
+#include "bulk_packing.inl"
@@ -0,0 +1,714 @@
+/// @ref gtx_bulk_packing
+/// @file glm/gtx/bulk_packing.inl
+
+#include <cstring>
+
+namespace glm{
+namespace detail
+{
+	// Scalar conversions for the elements after the last SIMD block
+
+	// clamp(v, 0, 1) and clamp(v, -1, 1), with NaN to 0
+	GLM_FUNC_QUALIFIER float bulk_clamp_unorm(float v)
+	{
+		return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;
+	}
+
+	GLM_FUNC_QUALIFIER float bulk_clamp_snorm(float v)
+	{
+		return v > -1.0f ? (v < 1.0f ? v : 1.0f) : (v != v ? 0.0f : -1.0f);
+	}
+
+	// packRGBM, with the operand order of its max and clamp written out
+	GLM_FUNC_QUALIFIER vec4 bulk_pack_rgbm(vec3 const& rgb)
+	{
+		vec3 const Color(rgb * static_cast<float>(1.0 / 6.0));
+		float const MaxXY = Color.x < Color.y ? Color.y : Color.x;
+		float const MaxZ = Color.z < 1e-6f ? 1e-6f : Color.z;
+		float Alpha = MaxXY < MaxZ ? MaxZ : MaxXY;
+		Alpha = Alpha < 0.0f ? 0.0f : Alpha;
+		Alpha = 1.0f < Alpha ? 1.0f : Alpha;
+		Alpha = ceil(Alpha * 255.0f) / 255.0f;
+		return vec4(Color / Alpha, Alpha);
+	}
+
+	GLM_FUNC_QUALIFIER vec3 bulk_unpack_rgbm(vec4 const& rgbm)
+	{
+		return vec3(rgbm.x, rgbm.y, rgbm.z) * rgbm.w * 6.0f;
+	}
+
+#	if defined(GLM_BULK_PACKING_SSE2)
+	GLM_FUNC_QUALIFIER __m128i bulk_select(__m128i Mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(Mask, a), _mm_andnot_si128(Mask, b));
+	}
+
+	// round half away from zero like std::round, for |x| < 2^31
+	GLM_FUNC_QUALIFIER __m128i bulk_round(__m128 x)
+	{
+		__m128i const Trunc = _mm_cvttps_epi32(x);
+		__m128 const Fract = _mm_sub_ps(x, _mm_cvtepi32_ps(Trunc));
+		__m128i const Up = _mm_castps_si128(_mm_cmpge_ps(Fract, _mm_set1_ps(0.5f)));
+		__m128i const Down = _mm_castps_si128(_mm_cmple_ps(Fract, _mm_set1_ps(-0.5f)));
+		return _mm_add_epi32(_mm_sub_epi32(Trunc, Up), Down);
+	}
+
+	// 8 int32 in [0, 65535] to uint16
+	GLM_FUNC_QUALIFIER __m128i bulk_pack_u16(__m128i a, __m128i b)
+	{
+#		if defined(GLM_BULK_PACKING_SSE41)
+			return _mm_packus_epi32(a, b);
+#		else
+			// packs saturates to int16, so sign extend the low 16 bits first
+			return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+#		endif
+	}
+
+	// 8 uint16 or int16 to int32
+	GLM_FUNC_QUALIFIER void bulk_widen_u16(__m128i v, __m128i& Low, __m128i& High)
+	{
+		Low = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+		High = _mm_unpackhi_epi16(v, _mm_setzero_si128());
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_widen_i16(__m128i v, __m128i& Low, __m128i& High)
+	{
+		Low = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		High = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+	}
+
+	// _mm_max_ps returns its second operand for NaN, so NaN clamps to 0
+	GLM_FUNC_QUALIFIER __m128i bulk_unorm(__m128 v, __m128 Max)
+	{
+		__m128 const Clamped = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return bulk_round(_mm_mul_ps(Clamped, Max));
+	}
+
+	GLM_FUNC_QUALIFIER __m128i bulk_snorm(__m128 v, __m128 Max)
+	{
+		__m128 const Clamped = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+		return bulk_round(_mm_mul_ps(_mm_and_ps(Clamped, _mm_cmpord_ps(v, v)), Max));
+	}
+
+	// packHalf1x16 of NaN: the sign and the 10 high significand bits, with at least one set
+	GLM_FUNC_QUALIFIER __m128i bulk_half_nan(__m128i i)
+	{
+		__m128i const Sign = _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000));
+		__m128i const Significand = _mm_and_si128(_mm_srli_epi32(i, 13), _mm_set1_epi32(0x03ff));
+		__m128i const Empty = _mm_srli_epi32(_mm_cmpeq_epi32(Significand, _mm_setzero_si128()), 31);
+		return _mm_or_si128(_mm_or_si128(Sign, _mm_set1_epi32(0x7c00)), _mm_or_si128(Significand, Empty));
+	}
+
+	// packHalf1x16 with integer operations, one half per 32 bit lane
+	GLM_FUNC_QUALIFIER __m128i bulk_half_bits(__m128 v)
+	{
+		__m128i const i = _mm_castps_si128(v);
+		__m128i const Abs = _mm_and_si128(i, _mm_set1_epi32(0x7fffffff));
+		__m128i const Sign = _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000));
+
+		// normal halves: rebias the exponent and round half up, the carry moves into the
+		// exponent and from the largest half to infinity
+		__m128i Normal = _mm_srli_epi32(_mm_add_epi32(Abs, _mm_set1_epi32(static_cast<int>(0xc8001000))), 13);
+		Normal = bulk_select(_mm_cmpgt_epi32(Abs, _mm_set1_epi32(0x477fefff)), _mm_set1_epi32(0x7c00), Normal);
+
+		// denormal halves and zero: |v| * 2^24 rounded half up
+		__m128 const Scaled = _mm_mul_ps(_mm_castsi128_ps(Abs), _mm_set1_ps(16777216.0f));
+		__m128i const Trunc = _mm_cvttps_epi32(Scaled);
+		__m128i const Up = _mm_castps_si128(_mm_cmpge_ps(_mm_sub_ps(Scaled, _mm_cvtepi32_ps(Trunc)), _mm_set1_ps(0.5f)));
+		__m128i const Denormal = _mm_sub_epi32(Trunc, Up);
+
+		__m128i const Bits = _mm_or_si128(Sign, bulk_select(_mm_cmplt_epi32(Abs, _mm_set1_epi32(0x38800000)), Denormal, Normal));
+		return bulk_select(_mm_cmpgt_epi32(Abs, _mm_set1_epi32(0x7f800000)), bulk_half_nan(i), Bits);
+	}
+
+	// unpackHalf1x16 with integer operations, halves zero extended to 32 bits
+	GLM_FUNC_QUALIFIER __m128 bulk_half_to_float(__m128i h)
+	{
+		__m128i const Sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+		__m128i const Abs = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+		__m128i const Normal = _mm_add_epi32(_mm_slli_epi32(Abs, 13), _mm_set1_epi32(0x38000000));
+		// infinity and NaN keep the significand, a signaling NaN stays signaling
+		__m128i const Special = _mm_or_si128(_mm_slli_epi32(Abs, 13), _mm_set1_epi32(0x7f800000));
+		__m128 const Denormal = _mm_mul_ps(_mm_cvtepi32_ps(Abs), _mm_set1_ps(1.0f / 16777216.0f));
+
+		__m128i Bits = bulk_select(_mm_cmpgt_epi32(Abs, _mm_set1_epi32(0x7bff)), Special, Normal);
+		Bits = bulk_select(_mm_cmplt_epi32(Abs, _mm_set1_epi32(0x0400)), _mm_castps_si128(Denormal), Bits);
+		return _mm_castsi128_ps(_mm_or_si128(Bits, Sign));
+	}
+
+#	if defined(GLM_BULK_PACKING_F16C)
+	// F16C rounds halfway cases to even where packHalf1x16 rounds them up, and sets the
+	// quiet bit of NaN. Returns 4 halves in the low 64 bits.
+	GLM_FUNC_QUALIFIER __m128i bulk_half_f16c(__m128 v)
+	{
+		__m128i const Nearest = _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT);
+		__m128i const Truncated = _mm_cvtps_ph(v, _MM_FROUND_TO_ZERO);
+		__m128 const Next = _mm_cvtph_ps(_mm_add_epi16(Truncated, _mm_set1_epi16(1)));
+		__m128 const Halfway = _mm_mul_ps(_mm_add_ps(_mm_cvtph_ps(Truncated), Next), _mm_set1_ps(0.5f));
+		__m128i const Tie = _mm_castps_si128(_mm_cmpeq_ps(v, Halfway));
+		__m128i const RoundedDown = _mm_and_si128(_mm_packs_epi32(Tie, Tie), _mm_cmpeq_epi16(Nearest, Truncated));
+		__m128i const Rounded = _mm_sub_epi16(Nearest, RoundedDown);
+
+		__m128i const NaN = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+		__m128i const NaNBits = bulk_pack_u16(bulk_half_nan(_mm_castps_si128(v)), _mm_setzero_si128());
+		return bulk_select(_mm_packs_epi32(NaN, NaN), NaNBits, Rounded);
+	}
+
+	// 4 halves in the low 64 bits
+	GLM_FUNC_QUALIFIER __m128 bulk_half_to_float_f16c(__m128i h)
+	{
+		__m128i const Wide = _mm_unpacklo_epi16(h, _mm_setzero_si128());
+		__m128i const NaN = _mm_cmpgt_epi32(_mm_and_si128(Wide, _mm_set1_epi32(0x7fff)), _mm_set1_epi32(0x7c00));
+		return _mm_castsi128_ps(bulk_select(NaN, _mm_castps_si128(bulk_half_to_float(Wide)), _mm_castps_si128(_mm_cvtph_ps(h))));
+	}
+#	endif//GLM_BULK_PACKING_F16C
+
+	// floatTo11bit for Shift 17, floatTo10bit for Shift 18
+	template<int Shift>
+	GLM_FUNC_QUALIFIER __m128i bulk_float_to_packed(__m128 v)
+	{
+		int const ExponentMask = 0x1f << (23 - Shift);
+		int const SignificandMask = (1 << (23 - Shift)) - 1;
+
+		__m128i const i = _mm_castps_si128(v);
+		__m128i const Rebiased = _mm_sub_epi32(_mm_and_si128(i, _mm_set1_epi32(0x7f800000)), _mm_set1_epi32(0x38000000));
+		__m128i const Exponent = _mm_and_si128(_mm_srli_epi32(Rebiased, Shift), _mm_set1_epi32(ExponentMask));
+		__m128i const Significand = _mm_and_si128(_mm_srli_epi32(i, Shift), _mm_set1_epi32(SignificandMask));
+		__m128i Packed = _mm_or_si128(Exponent, Significand);
+
+		__m128i const Infinity = _mm_cmpeq_epi32(_mm_and_si128(i, _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000));
+		Packed = bulk_select(Infinity, _mm_set1_epi32(ExponentMask), Packed);
+		Packed = _mm_or_si128(Packed, _mm_castps_si128(_mm_cmpunord_ps(v, v)));
+		Packed = _mm_andnot_si128(_mm_castps_si128(_mm_cmpeq_ps(v, _mm_setzero_ps())), Packed);
+		return _mm_and_si128(Packed, _mm_set1_epi32(ExponentMask | SignificandMask));
+	}
+
+	// packed11bitToFloat for Shift 17, packed10bitToFloat for Shift 18. p is not masked,
+	// the scalar functions compare the whole shifted word with the special codes.
+	template<int Shift>
+	GLM_FUNC_QUALIFIER __m128 bulk_packed_to_float(__m128i p)
+	{
+		int const ExponentMask = 0x1f << (23 - Shift);
+		int const SignificandMask = (1 << (23 - Shift)) - 1;
+
+		__m128i const Exponent = _mm_and_si128(_mm_add_epi32(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(ExponentMask)), Shift), _mm_set1_epi32(0x38000000)), _mm_set1_epi32(0x7f800000));
+		__m128i const Significand = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(SignificandMask)), Shift);
+		__m128i Bits = _mm_or_si128(Exponent, Significand);
+
+		__m128i const Special = _mm_or_si128(
+			_mm_cmpeq_epi32(p, _mm_set1_epi32(ExponentMask | SignificandMask)),
+			_mm_cmpeq_epi32(p, _mm_set1_epi32(ExponentMask)));
+		Bits = bulk_select(Special, _mm_castps_si128(_mm_set1_ps(-1.0f)), Bits);
+		return _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(p, _mm_setzero_si128()), Bits));
+	}
+
+	// ceil of non negative values, NaN stays NaN
+	GLM_FUNC_QUALIFIER __m128 bulk_ceil(__m128 x)
+	{
+#		if defined(GLM_BULK_PACKING_SSE41)
+			return _mm_ceil_ps(x);
+#		else
+			__m128 const Trunc = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+			__m128 const Ceil = _mm_add_ps(Trunc, _mm_and_ps(_mm_cmplt_ps(Trunc, x), _mm_set1_ps(1.0f)));
+			__m128 const Small = _mm_cmplt_ps(x, _mm_set1_ps(8388608.0f));
+			return _mm_or_ps(_mm_and_ps(Small, Ceil), _mm_andnot_ps(Small, x));
+#		endif
+	}
+
+	// 4 vec3 to x, y and z registers and back
+	GLM_FUNC_QUALIFIER void bulk_load3(float const* p, __m128& x, __m128& y, __m128& z)
+	{
+		__m128 const a = _mm_loadu_ps(p);		// x0 y0 z0 x1
+		__m128 const b = _mm_loadu_ps(p + 4);	// y1 z1 x2 y2
+		__m128 const c = _mm_loadu_ps(p + 8);	// z2 x3 y3 z3
+		x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_store3(float* p, __m128 x, __m128 y, __m128 z)
+	{
+		__m128 const xy0 = _mm_unpacklo_ps(x, y);	// x0 y0 x1 y1
+		__m128 const xy1 = _mm_unpackhi_ps(x, y);	// x2 y2 x3 y3
+		_mm_storeu_ps(p, _mm_shuffle_ps(xy0, _mm_shuffle_ps(z, xy0, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(xy0, z, _MM_SHUFFLE(1, 1, 3, 3)), xy1, _MM_SHUFFLE(1, 0, 2, 0)));
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, xy1, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(xy1, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+#	endif//GLM_BULK_PACKING_SSE2
+
+#	if defined(GLM_BULK_PACKING_AVX2)
+	GLM_FUNC_QUALIFIER __m256i bulk_round(__m256 x)
+	{
+		__m256i const Trunc = _mm256_cvttps_epi32(x);
+		__m256 const Fract = _mm256_sub_ps(x, _mm256_cvtepi32_ps(Trunc));
+		__m256i const Up = _mm256_castps_si256(_mm256_cmp_ps(Fract, _mm256_set1_ps(0.5f), _CMP_GE_OQ));
+		__m256i const Down = _mm256_castps_si256(_mm256_cmp_ps(Fract, _mm256_set1_ps(-0.5f), _CMP_LE_OQ));
+		return _mm256_add_epi32(_mm256_sub_epi32(Trunc, Up), Down);
+	}
+
+	GLM_FUNC_QUALIFIER __m256i bulk_unorm(__m256 v, __m256 Max)
+	{
+		__m256 const Clamped = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		return bulk_round(_mm256_mul_ps(Clamped, Max));
+	}
+
+	GLM_FUNC_QUALIFIER __m256i bulk_snorm(__m256 v, __m256 Max)
+	{
+		__m256 const Clamped = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+		return bulk_round(_mm256_mul_ps(_mm256_and_ps(Clamped, _mm256_cmp_ps(v, v, _CMP_ORD_Q)), Max));
+	}
+#	endif//GLM_BULK_PACKING_AVX2
+
+	// The array conversions, each on [Src, Src + Count)
+
+	GLM_FUNC_QUALIFIER void bulk_pack_half(uint16* Dst, float const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_F16C)
+			for(; i + 8 <= Count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_unpacklo_epi64(
+					bulk_half_f16c(_mm_loadu_ps(Src + i)), bulk_half_f16c(_mm_loadu_ps(Src + i + 4))));
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			for(; i + 8 <= Count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), bulk_pack_u16(
+					bulk_half_bits(_mm_loadu_ps(Src + i)), bulk_half_bits(_mm_loadu_ps(Src + i + 4))));
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = packHalf1x16(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_half(float* Dst, uint16 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_F16C)
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i const h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i));
+				_mm_storeu_ps(Dst + i, bulk_half_to_float_f16c(h));
+				_mm_storeu_ps(Dst + i + 4, bulk_half_to_float_f16c(_mm_unpackhi_epi64(h, h)));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i Low, High;
+				bulk_widen_u16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i)), Low, High);
+				_mm_storeu_ps(Dst + i, bulk_half_to_float(Low));
+				_mm_storeu_ps(Dst + i + 4, bulk_half_to_float(High));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = unpackHalf1x16(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_unorm8(uint8* Dst, float const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Max = _mm256_set1_ps(255.0f);
+			for(; i + 16 <= Count; i += 16)
+			{
+				__m256i const a = bulk_unorm(_mm256_loadu_ps(Src + i), Max);
+				__m256i const b = bulk_unorm(_mm256_loadu_ps(Src + i + 8), Max);
+				__m128i const Words = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+				__m128i const Words2 = _mm_packs_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packus_epi16(Words, Words2));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Max = _mm_set1_ps(255.0f);
+			for(; i + 16 <= Count; i += 16)
+			{
+				__m128i const Words = _mm_packs_epi32(bulk_unorm(_mm_loadu_ps(Src + i), Max), bulk_unorm(_mm_loadu_ps(Src + i + 4), Max));
+				__m128i const Words2 = _mm_packs_epi32(bulk_unorm(_mm_loadu_ps(Src + i + 8), Max), bulk_unorm(_mm_loadu_ps(Src + i + 12), Max));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packus_epi16(Words, Words2));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = static_cast<uint8>(round(bulk_clamp_unorm(Src[i]) * 255.0f));
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_unorm16(uint16* Dst, float const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Max = _mm256_set1_ps(65535.0f);
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const a = bulk_unorm(_mm256_loadu_ps(Src + i), Max);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packus_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1)));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Max = _mm_set1_ps(65535.0f);
+			for(; i + 8 <= Count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), bulk_pack_u16(
+					bulk_unorm(_mm_loadu_ps(Src + i), Max), bulk_unorm(_mm_loadu_ps(Src + i + 4), Max)));
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = static_cast<uint16>(round(bulk_clamp_unorm(Src[i]) * 65535.0f));
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_unorm8(float* Dst, uint8 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Scale = _mm256_set1_ps(0.0039215686274509803921568627451f); // 1.0f / 255.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const Ints = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(Src + i)));
+				_mm256_storeu_ps(Dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(Ints), Scale));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Scale = _mm_set1_ps(0.0039215686274509803921568627451f); // 1.0f / 255.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i Low, High;
+				bulk_widen_u16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(Src + i)), _mm_setzero_si128()), Low, High);
+				_mm_storeu_ps(Dst + i, _mm_mul_ps(_mm_cvtepi32_ps(Low), Scale));
+				_mm_storeu_ps(Dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(High), Scale));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = unpackUnorm1x8(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_unorm16(float* Dst, uint16 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Scale = _mm256_set1_ps(1.5259021896696421759365224689097e-5f); // 1.0 / 65535.0
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const Ints = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i)));
+				_mm256_storeu_ps(Dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(Ints), Scale));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Scale = _mm_set1_ps(1.5259021896696421759365224689097e-5f); // 1.0 / 65535.0
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i Low, High;
+				bulk_widen_u16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i)), Low, High);
+				_mm_storeu_ps(Dst + i, _mm_mul_ps(_mm_cvtepi32_ps(Low), Scale));
+				_mm_storeu_ps(Dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(High), Scale));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = unpackUnorm1x16(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_snorm8(int8* Dst, float const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Max = _mm256_set1_ps(127.0f);
+			for(; i + 16 <= Count; i += 16)
+			{
+				__m256i const a = bulk_snorm(_mm256_loadu_ps(Src + i), Max);
+				__m256i const b = bulk_snorm(_mm256_loadu_ps(Src + i + 8), Max);
+				__m128i const Words = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+				__m128i const Words2 = _mm_packs_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packs_epi16(Words, Words2));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Max = _mm_set1_ps(127.0f);
+			for(; i + 16 <= Count; i += 16)
+			{
+				__m128i const Words = _mm_packs_epi32(bulk_snorm(_mm_loadu_ps(Src + i), Max), bulk_snorm(_mm_loadu_ps(Src + i + 4), Max));
+				__m128i const Words2 = _mm_packs_epi32(bulk_snorm(_mm_loadu_ps(Src + i + 8), Max), bulk_snorm(_mm_loadu_ps(Src + i + 12), Max));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packs_epi16(Words, Words2));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = static_cast<int8>(round(bulk_clamp_snorm(Src[i]) * 127.0f));
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_snorm16(int16* Dst, float const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Max = _mm256_set1_ps(32767.0f);
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const a = bulk_snorm(_mm256_loadu_ps(Src + i), Max);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1)));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Max = _mm_set1_ps(32767.0f);
+			for(; i + 8 <= Count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm_packs_epi32(
+					bulk_snorm(_mm_loadu_ps(Src + i), Max), bulk_snorm(_mm_loadu_ps(Src + i + 4), Max)));
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = static_cast<int16>(round(bulk_clamp_snorm(Src[i]) * 32767.0f));
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_snorm8(float* Dst, int8 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Scale = _mm256_set1_ps(0.00787401574803149606299212598425f); // 1.0f / 127.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const Ints = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(Src + i)));
+				__m256 const f = _mm256_mul_ps(_mm256_cvtepi32_ps(Ints), Scale);
+				_mm256_storeu_ps(Dst + i, _mm256_min_ps(_mm256_max_ps(f, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f)));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Scale = _mm_set1_ps(0.00787401574803149606299212598425f); // 1.0f / 127.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i const Bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(Src + i));
+				__m128i Low, High;
+				bulk_widen_i16(_mm_srai_epi16(_mm_unpacklo_epi8(Bytes, Bytes), 8), Low, High);
+				__m128 const f = _mm_mul_ps(_mm_cvtepi32_ps(Low), Scale);
+				__m128 const g = _mm_mul_ps(_mm_cvtepi32_ps(High), Scale);
+				_mm_storeu_ps(Dst + i, _mm_min_ps(_mm_max_ps(f, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f)));
+				_mm_storeu_ps(Dst + i + 4, _mm_min_ps(_mm_max_ps(g, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f)));
+			}
+#		endif
+		for(; i < Count; ++i)
+		{
+			uint8 Bits = 0;
+			memcpy(&Bits, &Src[i], sizeof(Bits));
+			Dst[i] = unpackSnorm1x8(Bits);
+		}
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_snorm16(float* Dst, int16 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_AVX2)
+			__m256 const Scale = _mm256_set1_ps(3.0518509475997192297128208258309e-5f); // 1.0f / 32767.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m256i const Ints = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i)));
+				__m256 const f = _mm256_mul_ps(_mm256_cvtepi32_ps(Ints), Scale);
+				_mm256_storeu_ps(Dst + i, _mm256_min_ps(_mm256_max_ps(f, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f)));
+			}
+#		elif defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Scale = _mm_set1_ps(3.0518509475997192297128208258309e-5f); // 1.0f / 32767.0f
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i Low, High;
+				bulk_widen_i16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i)), Low, High);
+				__m128 const f = _mm_mul_ps(_mm_cvtepi32_ps(Low), Scale);
+				__m128 const g = _mm_mul_ps(_mm_cvtepi32_ps(High), Scale);
+				_mm_storeu_ps(Dst + i, _mm_min_ps(_mm_max_ps(f, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f)));
+				_mm_storeu_ps(Dst + i + 4, _mm_min_ps(_mm_max_ps(g, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f)));
+			}
+#		endif
+		for(; i < Count; ++i)
+		{
+			uint16 Bits = 0;
+			memcpy(&Bits, &Src[i], sizeof(Bits));
+			Dst[i] = unpackSnorm1x16(Bits);
+		}
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_f11f11f10(uint32* Dst, vec3 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_SSE2)
+			for(; i + 4 <= Count; i += 4)
+			{
+				__m128 x, y, z;
+				bulk_load3(&Src[i].x, x, y, z);
+				__m128i const Packed = _mm_or_si128(_mm_or_si128(
+					bulk_float_to_packed<17>(x),
+					_mm_slli_epi32(bulk_float_to_packed<17>(y), 11)),
+					_mm_slli_epi32(bulk_float_to_packed<18>(z), 22));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), Packed);
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = packF2x11_1x10(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_f11f11f10(vec3* Dst, uint32 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_SSE2)
+			for(; i + 4 <= Count; i += 4)
+			{
+				__m128i const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Src + i));
+				bulk_store3(&Dst[i].x,
+					bulk_packed_to_float<17>(p),
+					bulk_packed_to_float<17>(_mm_srli_epi32(p, 11)),
+					bulk_packed_to_float<18>(_mm_srli_epi32(p, 22)));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = unpackF2x11_1x10(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_pack_rgbm(vec4* Dst, vec3 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Sixth = _mm_set1_ps(static_cast<float>(1.0 / 6.0));
+			__m128 const Max = _mm_set1_ps(255.0f);
+			for(; i + 4 <= Count; i += 4)
+			{
+				__m128 r, g, b;
+				bulk_load3(&Src[i].x, r, g, b);
+				r = _mm_mul_ps(r, Sixth);
+				g = _mm_mul_ps(g, Sixth);
+				b = _mm_mul_ps(b, Sixth);
+
+				// max(x, y) is x < y ? y : x, which is _mm_max_ps(y, x)
+				__m128 a = _mm_max_ps(_mm_max_ps(_mm_set1_ps(1e-6f), b), _mm_max_ps(g, r));
+				a = _mm_min_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_setzero_ps(), a));
+				a = _mm_div_ps(bulk_ceil(_mm_mul_ps(a, Max)), Max);
+
+				r = _mm_div_ps(r, a);
+				g = _mm_div_ps(g, a);
+				b = _mm_div_ps(b, a);
+				_MM_TRANSPOSE4_PS(r, g, b, a);
+				float* p = &Dst[i].x;
+				_mm_storeu_ps(p, r);
+				_mm_storeu_ps(p + 4, g);
+				_mm_storeu_ps(p + 8, b);
+				_mm_storeu_ps(p + 12, a);
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = bulk_pack_rgbm(Src[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void bulk_unpack_rgbm(vec3* Dst, vec4 const* Src, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if defined(GLM_BULK_PACKING_SSE2)
+			__m128 const Six = _mm_set1_ps(6.0f);
+			for(; i + 4 <= Count; i += 4)
+			{
+				float const* p = &Src[i].x;
+				__m128 r = _mm_loadu_ps(p);
+				__m128 g = _mm_loadu_ps(p + 4);
+				__m128 b = _mm_loadu_ps(p + 8);
+				__m128 m = _mm_loadu_ps(p + 12);
+				_MM_TRANSPOSE4_PS(r, g, b, m);
+				bulk_store3(&Dst[i].x,
+					_mm_mul_ps(_mm_mul_ps(r, m), Six),
+					_mm_mul_ps(_mm_mul_ps(g, m), Six),
+					_mm_mul_ps(_mm_mul_ps(b, m), Six));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Dst[i] = bulk_unpack_rgbm(Src[i]);
+	}
+
+	// Calls Task(Begin, End) on ranges of Count elements, on several threads for large arrays
+	template<typename task>
+	GLM_FUNC_QUALIFIER void bulk_parallel(task const& Task, std::size_t Count, std::size_t ElementSize)
+	{
+#		if (GLM_LANG & GLM_LANG_CXX11_FLAG) && GLM_BULK_PACKING_PARALLEL_SIZE > 0
+			std::size_t const Threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+			if(Threads > 1 && Count * ElementSize >= static_cast<std::size_t>(GLM_BULK_PACKING_PARALLEL_SIZE))
+			{
+				// whole SIMD blocks and cache lines per thread
+				std::size_t const Chunk = ((Count + Threads - 1) / Threads + 63) & ~static_cast<std::size_t>(63);
+				std::vector<std::thread> Workers;
+				for(std::size_t Begin = Chunk; Begin < Count; Begin += Chunk)
+					Workers.push_back(std::thread(Task, Begin, Begin + Chunk < Count ? Begin + Chunk : Count));
+				Task(0, Chunk < Count ? Chunk : Count);
+				for(std::size_t i = 0; i < Workers.size(); ++i)
+					Workers[i].join();
+				return;
+			}
+#		else
+			(void)ElementSize;
+#		endif
+		Task(0, Count);
+	}
+
+	template<typename dst, typename src, void (*Convert)(dst*, src const*, std::size_t)>
+	struct bulk_task
+	{
+		dst* Dst;
+		src const* Src;
+
+		void operator()(std::size_t Begin, std::size_t End) const
+		{
+			Convert(Dst + Begin, Src + Begin, End - Begin);
+		}
+	};
+
+	template<typename dst, typename src, void (*Convert)(dst*, src const*, std::size_t)>
+	GLM_FUNC_QUALIFIER void bulk_convert(dst* Dst, src const* Src, std::size_t Count)
+	{
+		bulk_task<dst, src, Convert> Task;
+		Task.Dst = Dst;
+		Task.Src = Src;
+		bulk_parallel(Task, Count, sizeof(dst) + sizeof(src));
+	}
+}//namespace detail
+
+	GLM_FUNC_QUALIFIER void packHalf(uint16* Dst, float const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<uint16, float, detail::bulk_pack_half>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackHalf(float* Dst, uint16 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<float, uint16, detail::bulk_unpack_half>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packUnorm(uint8* Dst, float const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<uint8, float, detail::bulk_pack_unorm8>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packUnorm(uint16* Dst, float const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<uint16, float, detail::bulk_pack_unorm16>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackUnorm(float* Dst, uint8 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<float, uint8, detail::bulk_unpack_unorm8>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackUnorm(float* Dst, uint16 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<float, uint16, detail::bulk_unpack_unorm16>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packSnorm(int8* Dst, float const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<int8, float, detail::bulk_pack_snorm8>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packSnorm(int16* Dst, float const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<int16, float, detail::bulk_pack_snorm16>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackSnorm(float* Dst, int8 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<float, int8, detail::bulk_unpack_snorm8>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackSnorm(float* Dst, int16 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<float, int16, detail::bulk_unpack_snorm16>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packF2x11_1x10(uint32* Dst, vec3 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<uint32, vec3, detail::bulk_pack_f11f11f10>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackF2x11_1x10(vec3* Dst, uint32 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<vec3, uint32, detail::bulk_unpack_f11f11f10>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void packRGBM(vec4* Dst, vec3 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<vec4, vec3, detail::bulk_pack_rgbm>(Dst, Src, Count);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackRGBM(vec3* Dst, vec4 const* Src, std::size_t Count)
+	{
+		detail::bulk_convert<vec3, vec4, detail::bulk_unpack_rgbm>(Dst, Src, Count);
+	}
+}//namespace glm
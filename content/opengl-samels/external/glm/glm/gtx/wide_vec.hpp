@@ -0,0 +1,280 @@
+/// @ref gtx_wide_vec
+/// @file glm/gtx/wide_vec.hpp
+///
+/// @see core (dependence)
+/// @see gtc_quaternion (dependence)
+///
+/// @defgroup gtx_wide_vec GLM_GTX_wide_vec
+/// @ingroup gtx
+///
+/// Include <glm/gtx/wide_vec.hpp> to use the features of this extension.
+///
+/// Structure of arrays types holding 4, 8 or 16 vectors, matrices or quaternions with
+/// one SIMD register per component, so that a loop over an array of vec3 handles one
+/// element per lane instead of one element per vec4 register.
+/// - floatx4 uses SSE2, floatx8 AVX and floatx16 AVX-512F when the compiler targets
+///   them. Other widths, and GLM_FORCE_PURE, fall back to plain float arrays.
+/// - load, store, gather and scatter convert between the wide types and arrays of
+///   vec3, vec4, mat4 and quat, or separate x, y and z arrays.
+/// - The geometric functions evaluate the same expressions as their vec3 versions,
+///   lane by lane.
+/// The wide types are meant to live in registers. Keep the data in plain arrays and
+/// load it, containers of wide types need 32 or 64 byte aligned allocations.
+
+#pragma once
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtc/quaternion.hpp"
+
+#if(defined(GLM_MESSAGES) && !defined(GLM_EXT_INCLUDED))
+#	pragma message("GLM: GLM_GTX_wide_vec extension included")
+#endif
+
+#if !defined(GLM_FORCE_PURE) && (GLM_ARCH & GLM_ARCH_SSE2_BIT)
+#	include <emmintrin.h>
+#	if GLM_ARCH & GLM_ARCH_SSE41_BIT
+#		include <smmintrin.h>
+#	endif
+#	define GLM_WIDE_VEC_SSE2
+#endif
+#if !defined(GLM_FORCE_PURE) && (GLM_ARCH & GLM_ARCH_AVX_BIT)
+#	include <immintrin.h>
+#	define GLM_WIDE_VEC_AVX
+#endif
+#if !defined(GLM_FORCE_PURE) && (GLM_ARCH & GLM_ARCH_AVX_BIT) && defined(__AVX512F__)
+#	include <immintrin.h>
+#	define GLM_WIDE_VEC_AVX512
+#endif
+
+namespace glm
+{
+	/// @addtogroup gtx_wide_vec
+	/// @{
+
+	/// N floats, one per lane. Arithmetic applies lane by lane.
+	template<int N>
+	struct float_wide
+	{
+		float data[N];
+
+		GLM_FUNC_DECL float_wide() {}
+		GLM_FUNC_DECL float_wide(float Scalar);
+
+		/// Loads N floats, p does not have to be aligned.
+		GLM_FUNC_DECL static float_wide load(float const* p);
+		GLM_FUNC_DECL void store(float* p) const;
+	};
+
+#	ifdef GLM_WIDE_VEC_SSE2
+	template<>
+	struct float_wide<4>
+	{
+		__m128 data;
+
+		GLM_FUNC_DECL float_wide() {}
+		GLM_FUNC_DECL float_wide(float Scalar) : data(_mm_set1_ps(Scalar)) {}
+		GLM_FUNC_DECL float_wide(__m128 Data) : data(Data) {}
+
+		GLM_FUNC_DECL static float_wide load(float const* p) { return float_wide(_mm_loadu_ps(p)); }
+		GLM_FUNC_DECL void store(float* p) const { _mm_storeu_ps(p, data); }
+	};
+#	endif
+
+#	ifdef GLM_WIDE_VEC_AVX
+	template<>
+	struct float_wide<8>
+	{
+		__m256 data;
+
+		GLM_FUNC_DECL float_wide() {}
+		GLM_FUNC_DECL float_wide(float Scalar) : data(_mm256_set1_ps(Scalar)) {}
+		GLM_FUNC_DECL float_wide(__m256 Data) : data(Data) {}
+
+		GLM_FUNC_DECL static float_wide load(float const* p) { return float_wide(_mm256_loadu_ps(p)); }
+		GLM_FUNC_DECL void store(float* p) const { _mm256_storeu_ps(p, data); }
+	};
+#	endif
+
+#	ifdef GLM_WIDE_VEC_AVX512
+	template<>
+	struct float_wide<16>
+	{
+		__m512 data;
+
+		GLM_FUNC_DECL float_wide() {}
+		GLM_FUNC_DECL float_wide(float Scalar) : data(_mm512_set1_ps(Scalar)) {}
+		GLM_FUNC_DECL float_wide(__m512 Data) : data(Data) {}
+
+		GLM_FUNC_DECL static float_wide load(float const* p) { return float_wide(_mm512_loadu_ps(p)); }
+		GLM_FUNC_DECL void store(float* p) const { _mm512_storeu_ps(p, data); }
+	};
+#	endif
+
+	/// N vec3, one per lane.
+	template<int N>
+	struct vec3_wide
+	{
+		float_wide<N> x, y, z;
+
+		GLM_FUNC_DECL vec3_wide() {}
+		/// Every lane set to v.
+		GLM_FUNC_DECL explicit vec3_wide(vec3 const& v) : x(v.x), y(v.y), z(v.z) {}
+		GLM_FUNC_DECL vec3_wide(float_wide<N> const& X, float_wide<N> const& Y, float_wide<N> const& Z) : x(X), y(Y), z(Z) {}
+	};
+
+	/// N vec4, one per lane.
+	template<int N>
+	struct vec4_wide
+	{
+		float_wide<N> x, y, z, w;
+
+		GLM_FUNC_DECL vec4_wide() {}
+		GLM_FUNC_DECL explicit vec4_wide(vec4 const& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+		GLM_FUNC_DECL vec4_wide(vec3_wide<N> const& v, float_wide<N> const& W) : x(v.x), y(v.y), z(v.z), w(W) {}
+		GLM_FUNC_DECL vec4_wide(float_wide<N> const& X, float_wide<N> const& Y, float_wide<N> const& Z, float_wide<N> const& W) : x(X), y(Y), z(Z), w(W) {}
+	};
+
+	/// N column major mat4, one per lane.
+	template<int N>
+	struct mat4_wide
+	{
+		vec4_wide<N> value[4];
+
+		GLM_FUNC_DECL mat4_wide() {}
+		GLM_FUNC_DECL explicit mat4_wide(mat4 const& m);
+
+		GLM_FUNC_DECL vec4_wide<N>& operator[](int i) { return value[i]; }
+		GLM_FUNC_DECL vec4_wide<N> const& operator[](int i) const { return value[i]; }
+	};
+
+	/// N quat, one per lane.
+	template<int N>
+	struct quat_wide
+	{
+		float_wide<N> x, y, z, w;
+
+		GLM_FUNC_DECL quat_wide() {}
+		GLM_FUNC_DECL explicit quat_wide(quat const& q) : x(q.x), y(q.y), z(q.z), w(q.w) {}
+		GLM_FUNC_DECL quat_wide(float_wide<N> const& W, float_wide<N> const& X, float_wide<N> const& Y, float_wide<N> const& Z) : x(X), y(Y), z(Z), w(W) {}
+	};
+
+	typedef float_wide<4>		floatx4;
+	typedef float_wide<8>		floatx8;
+	typedef float_wide<16>		floatx16;
+	typedef vec3_wide<4>		vec3x4;
+	typedef vec3_wide<8>		vec3x8;
+	typedef vec3_wide<16>		vec3x16;
+	typedef vec4_wide<4>		vec4x4;
+	typedef vec4_wide<8>		vec4x8;
+	typedef vec4_wide<16>		vec4x16;
+	typedef mat4_wide<4>		mat4x4_wide;
+	typedef mat4_wide<8>		mat4x8;
+	typedef mat4_wide<16>		mat4x16;
+	typedef quat_wide<4>		quatx4;
+	typedef quat_wide<8>		quatx8;
+	typedef quat_wide<16>		quatx16;
+
+	// float_wide arithmetic, lane by lane. min, max and step pick the same operand as
+	// their scalar versions when lanes are equal or NaN.
+
+	template<int N> GLM_FUNC_DECL float_wide<N> operator+(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> operator-(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> operator*(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> operator/(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> operator-(float_wide<N> const& a);
+	template<int N> GLM_FUNC_DECL float_wide<N> sqrt(float_wide<N> const& a);
+	template<int N> GLM_FUNC_DECL float_wide<N> min(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> max(float_wide<N> const& a, float_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> floor(float_wide<N> const& a);
+	template<int N> GLM_FUNC_DECL float_wide<N> fract(float_wide<N> const& a);
+	template<int N> GLM_FUNC_DECL float_wide<N> abs(float_wide<N> const& a);
+	/// 0 in the lanes where x < edge, 1 elsewhere.
+	template<int N> GLM_FUNC_DECL float_wide<N> step(float_wide<N> const& edge, float_wide<N> const& x);
+
+	/// Lane i of a.
+	template<int N> GLM_FUNC_DECL float lane(float_wide<N> const& a, int i);
+	template<int N> GLM_FUNC_DECL vec3 lane(vec3_wide<N> const& v, int i);
+	template<int N> GLM_FUNC_DECL vec4 lane(vec4_wide<N> const& v, int i);
+	template<int N> GLM_FUNC_DECL mat4 lane(mat4_wide<N> const& m, int i);
+	template<int N> GLM_FUNC_DECL quat lane(quat_wide<N> const& q, int i);
+
+	// Conversions from and to arrays of structures
+
+	/// Loads Src[0] to Src[N - 1].
+	template<int N> GLM_FUNC_DECL void load(vec3_wide<N>& Dst, vec3 const* Src);
+	template<int N> GLM_FUNC_DECL void load(vec4_wide<N>& Dst, vec4 const* Src);
+	template<int N> GLM_FUNC_DECL void load(quat_wide<N>& Dst, quat const* Src);
+	/// Loads N vectors from separate x, y and z arrays.
+	template<int N> GLM_FUNC_DECL void load(vec3_wide<N>& Dst, float const* X, float const* Y, float const* Z);
+
+	/// Stores to Dst[0] to Dst[N - 1].
+	template<int N> GLM_FUNC_DECL void store(vec3* Dst, vec3_wide<N> const& Src);
+	template<int N> GLM_FUNC_DECL void store(vec4* Dst, vec4_wide<N> const& Src);
+	template<int N> GLM_FUNC_DECL void store(quat* Dst, quat_wide<N> const& Src);
+	template<int N> GLM_FUNC_DECL void store(float* X, float* Y, float* Z, vec3_wide<N> const& Src);
+
+	/// Lane i gets Base[Indices[i]].
+	template<int N> GLM_FUNC_DECL void gather(vec3_wide<N>& Dst, vec3 const* Base, int const* Indices);
+	template<int N> GLM_FUNC_DECL void gather(vec4_wide<N>& Dst, vec4 const* Base, int const* Indices);
+	template<int N> GLM_FUNC_DECL void gather(mat4_wide<N>& Dst, mat4 const* Base, int const* Indices);
+	template<int N> GLM_FUNC_DECL void gather(quat_wide<N>& Dst, quat const* Base, int const* Indices);
+
+	/// Base[Indices[i]] gets lane i, the last lane wins when indices repeat.
+	template<int N> GLM_FUNC_DECL void scatter(vec3* Base, int const* Indices, vec3_wide<N> const& Src);
+	template<int N> GLM_FUNC_DECL void scatter(vec4* Base, int const* Indices, vec4_wide<N> const& Src);
+
+	// vec3_wide and vec4_wide arithmetic
+
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator+(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator-(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator*(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator*(vec3_wide<N> const& a, float_wide<N> const& s);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator*(vec3_wide<N> const& a, float s);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator/(vec3_wide<N> const& a, float_wide<N> const& s);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator-(vec3_wide<N> const& a);
+
+	template<int N> GLM_FUNC_DECL vec4_wide<N> operator+(vec4_wide<N> const& a, vec4_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL vec4_wide<N> operator*(vec4_wide<N> const& a, float_wide<N> const& s);
+
+	// Geometric functions, lane by lane
+
+	template<int N> GLM_FUNC_DECL float_wide<N> dot(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> dot(vec4_wide<N> const& a, vec4_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> cross(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL float_wide<N> length(vec3_wide<N> const& v);
+	template<int N> GLM_FUNC_DECL float_wide<N> distance(vec3_wide<N> const& a, vec3_wide<N> const& b);
+	/// Lanes of zero length become NaN, as with normalize(vec3).
+	template<int N> GLM_FUNC_DECL vec3_wide<N> normalize(vec3_wide<N> const& v);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> mix(vec3_wide<N> const& a, vec3_wide<N> const& b, float_wide<N> const& t);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> mix(vec3_wide<N> const& a, vec3_wide<N> const& b, float t);
+
+	// Matrix transforms
+
+	/// One matrix applied to every lane.
+	template<int N> GLM_FUNC_DECL vec4_wide<N> operator*(mat4 const& m, vec4_wide<N> const& v);
+	/// A matrix per lane.
+	template<int N> GLM_FUNC_DECL vec4_wide<N> operator*(mat4_wide<N> const& m, vec4_wide<N> const& v);
+	/// m * vec4(p, 1) without the w component.
+	template<int N> GLM_FUNC_DECL vec3_wide<N> transformPosition(mat4 const& m, vec3_wide<N> const& p);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> transformPosition(mat4_wide<N> const& m, vec3_wide<N> const& p);
+	/// m * vec4(d, 0) without the w component, for directions and normals of rigid transforms.
+	template<int N> GLM_FUNC_DECL vec3_wide<N> transformDirection(mat4 const& m, vec3_wide<N> const& d);
+	template<int N> GLM_FUNC_DECL vec3_wide<N> transformDirection(mat4_wide<N> const& m, vec3_wide<N> const& d);
+
+	/// Component wise sum and weighting, to blend matrices per lane as in skinning.
+	template<int N> GLM_FUNC_DECL mat4_wide<N> operator+(mat4_wide<N> const& a, mat4_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL mat4_wide<N> operator*(mat4_wide<N> const& m, float_wide<N> const& s);
+
+	// Quaternions
+
+	template<int N> GLM_FUNC_DECL quat_wide<N> operator*(quat_wide<N> const& p, quat_wide<N> const& q);
+	/// Rotates v by q, as q * v does for a quat and a vec3.
+	template<int N> GLM_FUNC_DECL vec3_wide<N> operator*(quat_wide<N> const& q, vec3_wide<N> const& v);
+	template<int N> GLM_FUNC_DECL float_wide<N> dot(quat_wide<N> const& a, quat_wide<N> const& b);
+	template<int N> GLM_FUNC_DECL quat_wide<N> normalize(quat_wide<N> const& q);
+
+	/// @}
+}//namespace glm
+
+#include "wide_vec.inl"
@@ -0,0 +1,123 @@
+/// @ref gtx_wide_noise
+/// @file glm/gtx/wide_noise.hpp
+///
+/// @see core (dependence)
+/// @see gtc_noise (dependence)
+/// @see gtx_wide_vec (dependence)
+///
+/// @defgroup gtx_wide_noise GLM_GTX_wide_noise
+/// @ingroup gtx
+///
+/// Include <glm/gtx/wide_noise.hpp> to use the features of this extension.
+///
+/// Perlin and simplex noise for many points per call, to fill heightmaps and volumes.
+/// - perlin and simplex overloads on float_wide evaluate the expressions of gtc_noise
+///   lane by lane, so each lane is the scalar result. When the compiler forms fused
+///   multiply-adds (-mfma, -march=native) it may round the two versions differently, and
+///   where a hash sits on the edge between two gradients a few samples change by up to
+///   a few hundredths.
+/// - noiseGrid fills 2D, 3D and 4D grids and noisePoints evaluates arrays of points, with
+///   fBm or ridged octaves, on GLM_WIDE_NOISE_WIDTH lanes at a time and on several threads.
+/// - fractalNoise is the scalar version of both, one point per call.
+
+#pragma once
+
+// Dependency:
+#include "../glm.hpp"
+#include "../gtc/noise.hpp"
+#include "wide_vec.hpp"
+#include <cstddef>
+
+#ifndef GLM_ENABLE_EXPERIMENTAL
+#	error "GLM: GLM_GTX_wide_noise is an experimental extension and may change in the future. Use #define GLM_ENABLE_EXPERIMENTAL before including it, if you really want to use it."
+#endif
+
+#if GLM_MESSAGES == GLM_ENABLE && !defined(GLM_EXT_INCLUDED)
+#	pragma message("GLM: GLM_GTX_wide_noise extension included")
+#endif
+
+#if GLM_LANG & GLM_LANG_CXX11_FLAG
+#	include <thread>
+#	include <vector>
+#endif
+
+/// Lanes the batch functions evaluate at once, the widest float_wide with SIMD registers.
+#ifndef GLM_WIDE_NOISE_WIDTH
+#	if defined(GLM_WIDE_VEC_AVX512)
+#		define GLM_WIDE_NOISE_WIDTH 16
+#	elif defined(GLM_WIDE_VEC_AVX)
+#		define GLM_WIDE_NOISE_WIDTH 8
+#	else
+#		define GLM_WIDE_NOISE_WIDTH 4
+#	endif
+#endif
+
+namespace glm
+{
+	/// @addtogroup gtx_wide_noise
+	/// @{
+
+	/// Classic Perlin noise at N points.
+	template<int N> GLM_FUNC_DECL float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y);
+	template<int N> GLM_FUNC_DECL float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z);
+	template<int N> GLM_FUNC_DECL float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z, float_wide<N> const& w);
+
+	/// Simplex noise at N points.
+	template<int N> GLM_FUNC_DECL float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y);
+	template<int N> GLM_FUNC_DECL float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z);
+	template<int N> GLM_FUNC_DECL float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z, float_wide<N> const& w);
+
+	enum noise_basis
+	{
+		noise_perlin,
+		noise_simplex
+	};
+
+	enum noise_fractal
+	{
+		/// One octave, the basis noise itself.
+		noise_single,
+		/// Sum of Octaves octaves, octave i at Lacunarity^i times the frequency and Gain^i times the amplitude.
+		noise_fbm,
+		/// Ridged multifractal: each octave is (Offset - |noise|)^2, weighted by the previous octave.
+		noise_ridged
+	};
+
+	/// How the batch functions and fractalNoise sample the noise.
+	struct noise_params
+	{
+		noise_basis Basis;
+		noise_fractal Fractal;
+		int Octaves;
+		float Lacunarity;
+		float Gain;
+		float Offset;
+		/// Threads to split the batch over, 0 for one per hardware thread. Ignored without C++11.
+		int Threads;
+
+		GLM_FUNC_DECL noise_params() :
+			Basis(noise_perlin), Fractal(noise_single), Octaves(1),
+			Lacunarity(2.0f), Gain(0.5f), Offset(1.0f), Threads(1)
+		{}
+	};
+
+	/// One point, the reference for the batch functions.
+	GLM_FUNC_DECL float fractalNoise(vec2 const& Position, noise_params const& Params);
+	GLM_FUNC_DECL float fractalNoise(vec3 const& Position, noise_params const& Params);
+	GLM_FUNC_DECL float fractalNoise(vec4 const& Position, noise_params const& Params);
+
+	/// Fills Dst with Size.x * Size.y * ... samples, x varying fastest. Sample (i, j, ...) is
+	/// fractalNoise(Origin + vec(i, j, ...) * Step, Params).
+	GLM_FUNC_DECL void noiseGrid(float* Dst, ivec2 const& Size, vec2 const& Origin, vec2 const& Step, noise_params const& Params);
+	GLM_FUNC_DECL void noiseGrid(float* Dst, ivec3 const& Size, vec3 const& Origin, vec3 const& Step, noise_params const& Params);
+	GLM_FUNC_DECL void noiseGrid(float* Dst, ivec4 const& Size, vec4 const& Origin, vec4 const& Step, noise_params const& Params);
+
+	/// Dst[i] = fractalNoise(Points[i], Params).
+	GLM_FUNC_DECL void noisePoints(float* Dst, vec2 const* Points, std::size_t Count, noise_params const& Params);
+	GLM_FUNC_DECL void noisePoints(float* Dst, vec3 const* Points, std::size_t Count, noise_params const& Params);
+	GLM_FUNC_DECL void noisePoints(float* Dst, vec4 const* Points, std::size_t Count, noise_params const& Params);
+
+	/// @}
+}//namespace glm
+
+#include "wide_noise.inl"
@@ -0,0 +1,785 @@
+/// @ref gtx_wide_noise
+/// @file glm/gtx/wide_noise.inl
+///
+// The gtc_noise functions with float_wide lanes in place of vec4 components. Each
+// expression keeps the operand order of its scalar counterpart.
+
+namespace glm{
+namespace detail
+{
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_mod289(float_wide<N> const& x)
+	{
+		return x - floor(x * float_wide<N>(1.0f / 289.0f)) * float_wide<N>(289.0f);
+	}
+
+	// mod(x, 289), which divides where mod289 multiplies
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_mod(float_wide<N> const& x)
+	{
+		float_wide<N> const y(289.0f);
+		return x - y * floor(x / y);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_permute(float_wide<N> const& x)
+	{
+		return wide_mod289(((x * float_wide<N>(34.0f)) + float_wide<N>(1.0f)) * x);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_taylorInvSqrt(float_wide<N> const& r)
+	{
+		return float_wide<N>(static_cast<float>(1.79284291400159)) - float_wide<N>(static_cast<float>(0.85373472095314)) * r;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_fade(float_wide<N> const& t)
+	{
+		return (t * t * t) * (t * (t * float_wide<N>(6.0f) - float_wide<N>(15.0f)) + float_wide<N>(10.0f));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_mix(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& a)
+	{
+		return x + a * (y - x);
+	}
+
+	// One corner of 2D Perlin noise: gradient from the hash, normalized, dotted with the offset
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_perlin_corner(float_wide<N> const& i, float_wide<N> const& fx, float_wide<N> const& fy)
+	{
+		float_wide<N> gx = float_wide<N>(2.0f) * fract(i / float_wide<N>(41.0f)) - float_wide<N>(1.0f);
+		float_wide<N> gy = abs(gx) - float_wide<N>(0.5f);
+		float_wide<N> const tx = floor(gx + float_wide<N>(0.5f));
+		gx = gx - tx;
+
+		float_wide<N> const norm = wide_taylorInvSqrt(gx * gx + gy * gy);
+		gx = gx * norm;
+		gy = gy * norm;
+		return gx * fx + gy * fy;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_perlin_corner(float_wide<N> const& ixy,
+		float_wide<N> const& fx, float_wide<N> const& fy, float_wide<N> const& fz)
+	{
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const Half(0.5f);
+
+		float_wide<N> gx = ixy * float_wide<N>(static_cast<float>(1.0 / 7.0));
+		float_wide<N> gy = fract(floor(gx) * float_wide<N>(static_cast<float>(1.0 / 7.0))) - Half;
+		gx = fract(gx);
+		float_wide<N> const gz = Half - abs(gx) - abs(gy);
+		float_wide<N> const sz = step(gz, Zero);
+		gx = gx - sz * (step(Zero, gx) - Half);
+		gy = gy - sz * (step(Zero, gy) - Half);
+
+		float_wide<N> const norm = wide_taylorInvSqrt(gx * gx + gy * gy + gz * gz);
+		return gx * norm * fx + gy * norm * fy + gz * norm * fz;
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_perlin_corner(float_wide<N> const& ixy,
+		float_wide<N> const& fx, float_wide<N> const& fy, float_wide<N> const& fz, float_wide<N> const& fw)
+	{
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const Half(0.5f);
+
+		float_wide<N> gx = ixy / float_wide<N>(7.0f);
+		float_wide<N> gy = floor(gx) / float_wide<N>(7.0f);
+		float_wide<N> gz = floor(gy) / float_wide<N>(6.0f);
+		gx = fract(gx) - Half;
+		gy = fract(gy) - Half;
+		gz = fract(gz) - Half;
+		float_wide<N> const gw = float_wide<N>(0.75f) - abs(gx) - abs(gy) - abs(gz);
+		float_wide<N> const sw = step(gw, Zero);
+		gx = gx - sw * (step(Zero, gx) - Half);
+		gy = gy - sw * (step(Zero, gy) - Half);
+
+		float_wide<N> const norm = wide_taylorInvSqrt((gx * gx + gy * gy) + (gz * gz + gw * gw));
+		return (gx * norm * fx + gy * norm * fy) + (gz * norm * fz + gw * norm * fw);
+	}
+
+	// One gradient of 4D simplex noise, gtc::grad4 with ip = (1/294, 1/49, 1/7, 0)
+	template<int N>
+	GLM_FUNC_QUALIFIER void wide_grad4(float_wide<N> const& j, float_wide<N>& x, float_wide<N>& y, float_wide<N>& z, float_wide<N>& w)
+	{
+		float_wide<N> const One(1.0f);
+		float_wide<N> const Seven(7.0f);
+		float_wide<N> const ipz(1.0f / 7.0f);
+
+		x = floor(fract(j * float_wide<N>(1.0f / 294.0f)) * Seven) * ipz - One;
+		y = floor(fract(j * float_wide<N>(1.0f / 49.0f)) * Seven) * ipz - One;
+		z = floor(fract(j * ipz) * Seven) * ipz - One;
+		w = float_wide<N>(1.5f) - (abs(x) + abs(y) + abs(z));
+
+		// lessThan(p, 0) as 1 - step(0, p)
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const sw = One - step(Zero, w);
+		x = x + ((One - step(Zero, x)) * float_wide<N>(2.0f) - One) * sw;
+		y = y + ((One - step(Zero, y)) * float_wide<N>(2.0f) - One) * sw;
+		z = z + ((One - step(Zero, z)) * float_wide<N>(2.0f) - One) * sw;
+	}
+}//namespace detail
+
+	// Classic Perlin noise
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y)
+	{
+		float_wide<N> const One(1.0f);
+
+		float_wide<N> const X0 = detail::wide_mod(floor(x));
+		float_wide<N> const Y0 = detail::wide_mod(floor(y));
+		float_wide<N> const X1 = detail::wide_mod(floor(x) + One);
+		float_wide<N> const Y1 = detail::wide_mod(floor(y) + One);
+		float_wide<N> const fx0 = fract(x);
+		float_wide<N> const fy0 = fract(y);
+		float_wide<N> const fx1 = fract(x) - One;
+		float_wide<N> const fy1 = fract(y) - One;
+
+		float_wide<N> const px0 = detail::wide_permute(X0);
+		float_wide<N> const px1 = detail::wide_permute(X1);
+
+		float_wide<N> const n00 = detail::wide_perlin_corner(detail::wide_permute(px0 + Y0), fx0, fy0);
+		float_wide<N> const n10 = detail::wide_perlin_corner(detail::wide_permute(px1 + Y0), fx1, fy0);
+		float_wide<N> const n01 = detail::wide_perlin_corner(detail::wide_permute(px0 + Y1), fx0, fy1);
+		float_wide<N> const n11 = detail::wide_perlin_corner(detail::wide_permute(px1 + Y1), fx1, fy1);
+
+		float_wide<N> const fade_x = detail::wide_fade(fx0);
+		float_wide<N> const fade_y = detail::wide_fade(fy0);
+		float_wide<N> const n_x0 = detail::wide_mix(n00, n10, fade_x);
+		float_wide<N> const n_x1 = detail::wide_mix(n01, n11, fade_x);
+		return float_wide<N>(2.3f) * detail::wide_mix(n_x0, n_x1, fade_y);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z)
+	{
+		float_wide<N> const One(1.0f);
+
+		float_wide<N> const X0 = detail::wide_mod289(floor(x));
+		float_wide<N> const Y0 = detail::wide_mod289(floor(y));
+		float_wide<N> const Z0 = detail::wide_mod289(floor(z));
+		float_wide<N> const X1 = detail::wide_mod289(floor(x) + One);
+		float_wide<N> const Y1 = detail::wide_mod289(floor(y) + One);
+		float_wide<N> const Z1 = detail::wide_mod289(floor(z) + One);
+		float_wide<N> const fx0 = fract(x);
+		float_wide<N> const fy0 = fract(y);
+		float_wide<N> const fz0 = fract(z);
+		float_wide<N> const fx1 = fx0 - One;
+		float_wide<N> const fy1 = fy0 - One;
+		float_wide<N> const fz1 = fz0 - One;
+
+		float_wide<N> const px0 = detail::wide_permute(X0);
+		float_wide<N> const px1 = detail::wide_permute(X1);
+		float_wide<N> const ixy00 = detail::wide_permute(px0 + Y0);
+		float_wide<N> const ixy10 = detail::wide_permute(px1 + Y0);
+		float_wide<N> const ixy01 = detail::wide_permute(px0 + Y1);
+		float_wide<N> const ixy11 = detail::wide_permute(px1 + Y1);
+
+		float_wide<N> const n000 = detail::wide_perlin_corner(detail::wide_permute(ixy00 + Z0), fx0, fy0, fz0);
+		float_wide<N> const n100 = detail::wide_perlin_corner(detail::wide_permute(ixy10 + Z0), fx1, fy0, fz0);
+		float_wide<N> const n010 = detail::wide_perlin_corner(detail::wide_permute(ixy01 + Z0), fx0, fy1, fz0);
+		float_wide<N> const n110 = detail::wide_perlin_corner(detail::wide_permute(ixy11 + Z0), fx1, fy1, fz0);
+		float_wide<N> const n001 = detail::wide_perlin_corner(detail::wide_permute(ixy00 + Z1), fx0, fy0, fz1);
+		float_wide<N> const n101 = detail::wide_perlin_corner(detail::wide_permute(ixy10 + Z1), fx1, fy0, fz1);
+		float_wide<N> const n011 = detail::wide_perlin_corner(detail::wide_permute(ixy01 + Z1), fx0, fy1, fz1);
+		float_wide<N> const n111 = detail::wide_perlin_corner(detail::wide_permute(ixy11 + Z1), fx1, fy1, fz1);
+
+		float_wide<N> const fade_x = detail::wide_fade(fx0);
+		float_wide<N> const fade_y = detail::wide_fade(fy0);
+		float_wide<N> const fade_z = detail::wide_fade(fz0);
+		float_wide<N> const n_z00 = detail::wide_mix(n000, n001, fade_z);
+		float_wide<N> const n_z10 = detail::wide_mix(n100, n101, fade_z);
+		float_wide<N> const n_z01 = detail::wide_mix(n010, n011, fade_z);
+		float_wide<N> const n_z11 = detail::wide_mix(n110, n111, fade_z);
+		float_wide<N> const n_yz0 = detail::wide_mix(n_z00, n_z01, fade_y);
+		float_wide<N> const n_yz1 = detail::wide_mix(n_z10, n_z11, fade_y);
+		return float_wide<N>(2.2f) * detail::wide_mix(n_yz0, n_yz1, fade_x);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> perlin(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z, float_wide<N> const& w)
+	{
+		float_wide<N> const One(1.0f);
+
+		float_wide<N> const X0 = detail::wide_mod(floor(x));
+		float_wide<N> const Y0 = detail::wide_mod(floor(y));
+		float_wide<N> const Z0 = detail::wide_mod(floor(z));
+		float_wide<N> const W0 = detail::wide_mod(floor(w));
+		float_wide<N> const X1 = detail::wide_mod(floor(x) + One);
+		float_wide<N> const Y1 = detail::wide_mod(floor(y) + One);
+		float_wide<N> const Z1 = detail::wide_mod(floor(z) + One);
+		float_wide<N> const W1 = detail::wide_mod(floor(w) + One);
+		float_wide<N> const fx0 = fract(x);
+		float_wide<N> const fy0 = fract(y);
+		float_wide<N> const fz0 = fract(z);
+		float_wide<N> const fw0 = fract(w);
+		float_wide<N> const fx1 = fx0 - One;
+		float_wide<N> const fy1 = fy0 - One;
+		float_wide<N> const fz1 = fz0 - One;
+		float_wide<N> const fw1 = fw0 - One;
+
+		float_wide<N> const px0 = detail::wide_permute(X0);
+		float_wide<N> const px1 = detail::wide_permute(X1);
+		float_wide<N> const ixy[4] = {
+			detail::wide_permute(px0 + Y0), detail::wide_permute(px1 + Y0),
+			detail::wide_permute(px0 + Y1), detail::wide_permute(px1 + Y1)};
+		float_wide<N> const fx[4] = {fx0, fx1, fx0, fx1};
+		float_wide<N> const fy[4] = {fy0, fy0, fy1, fy1};
+
+		// n[z][w][xy], xy in the order 00, 10, 01, 11
+		float_wide<N> n[2][2][4];
+		for(int k = 0; k < 4; ++k)
+		{
+			float_wide<N> const ixy0 = detail::wide_permute(ixy[k] + Z0);
+			float_wide<N> const ixy1 = detail::wide_permute(ixy[k] + Z1);
+			n[0][0][k] = detail::wide_perlin_corner(detail::wide_permute(ixy0 + W0), fx[k], fy[k], fz0, fw0);
+			n[0][1][k] = detail::wide_perlin_corner(detail::wide_permute(ixy0 + W1), fx[k], fy[k], fz0, fw1);
+			n[1][0][k] = detail::wide_perlin_corner(detail::wide_permute(ixy1 + W0), fx[k], fy[k], fz1, fw0);
+			n[1][1][k] = detail::wide_perlin_corner(detail::wide_permute(ixy1 + W1), fx[k], fy[k], fz1, fw1);
+		}
+
+		float_wide<N> const fade_x = detail::wide_fade(fx0);
+		float_wide<N> const fade_y = detail::wide_fade(fy0);
+		float_wide<N> const fade_z = detail::wide_fade(fz0);
+		float_wide<N> const fade_w = detail::wide_fade(fw0);
+		float_wide<N> n_zw[4];
+		for(int k = 0; k < 4; ++k)
+		{
+			float_wide<N> const n_0w = detail::wide_mix(n[0][0][k], n[0][1][k], fade_w);
+			float_wide<N> const n_1w = detail::wide_mix(n[1][0][k], n[1][1][k], fade_w);
+			n_zw[k] = detail::wide_mix(n_0w, n_1w, fade_z);
+		}
+		float_wide<N> const n_yzw0 = detail::wide_mix(n_zw[0], n_zw[2], fade_y);
+		float_wide<N> const n_yzw1 = detail::wide_mix(n_zw[1], n_zw[3], fade_y);
+		return float_wide<N>(2.2f) * detail::wide_mix(n_yzw0, n_yzw1, fade_x);
+	}
+
+	// Simplex noise
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y)
+	{
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const One(1.0f);
+		float_wide<N> const Cx(static_cast<float>(0.211324865405187));
+		float_wide<N> const Cy(static_cast<float>(0.366025403784439));
+		float_wide<N> const Cz(static_cast<float>(-0.577350269189626));
+		float_wide<N> const Cw(static_cast<float>(0.024390243902439));
+
+		// First corner
+		float_wide<N> const d = x * Cy + y * Cy;
+		float_wide<N> ix = floor(x + d);
+		float_wide<N> iy = floor(y + d);
+		float_wide<N> const di = ix * Cx + iy * Cx;
+		float_wide<N> const x0 = x - ix + di;
+		float_wide<N> const y0 = y - iy + di;
+
+		// Other corners, i1 = x0 > y0 ? (1, 0) : (0, 1)
+		float_wide<N> const i1y = step(x0, y0);
+		float_wide<N> const i1x = One - i1y;
+		float_wide<N> const x1 = x0 + Cx - i1x;
+		float_wide<N> const y1 = y0 + Cx - i1y;
+		float_wide<N> const x2 = x0 + Cz;
+		float_wide<N> const y2 = y0 + Cz;
+
+		// Permutations
+		ix = detail::wide_mod(ix);
+		iy = detail::wide_mod(iy);
+		float_wide<N> const p0 = detail::wide_permute(detail::wide_permute(iy + Zero) + ix + Zero);
+		float_wide<N> const p1 = detail::wide_permute(detail::wide_permute(iy + i1y) + ix + i1x);
+		float_wide<N> const p2 = detail::wide_permute(detail::wide_permute(iy + One) + ix + One);
+
+		float_wide<N> m0 = max(float_wide<N>(0.5f) - (x0 * x0 + y0 * y0), Zero);
+		float_wide<N> m1 = max(float_wide<N>(0.5f) - (x1 * x1 + y1 * y1), Zero);
+		float_wide<N> m2 = max(float_wide<N>(0.5f) - (x2 * x2 + y2 * y2), Zero);
+		m0 = m0 * m0;
+		m1 = m1 * m1;
+		m2 = m2 * m2;
+		m0 = m0 * m0;
+		m1 = m1 * m1;
+		m2 = m2 * m2;
+
+		// Gradients: 41 points uniformly over a line, mapped onto a diamond
+		float_wide<N> const Half(0.5f);
+		float_wide<N> const gx0 = float_wide<N>(2.0f) * fract(p0 * Cw) - One;
+		float_wide<N> const gx1 = float_wide<N>(2.0f) * fract(p1 * Cw) - One;
+		float_wide<N> const gx2 = float_wide<N>(2.0f) * fract(p2 * Cw) - One;
+		float_wide<N> const h0 = abs(gx0) - Half;
+		float_wide<N> const h1 = abs(gx1) - Half;
+		float_wide<N> const h2 = abs(gx2) - Half;
+		float_wide<N> const a0 = gx0 - floor(gx0 + Half);
+		float_wide<N> const a1 = gx1 - floor(gx1 + Half);
+		float_wide<N> const a2 = gx2 - floor(gx2 + Half);
+
+		// Normalise gradients implicitly by scaling m
+		m0 = m0 * detail::wide_taylorInvSqrt(a0 * a0 + h0 * h0);
+		m1 = m1 * detail::wide_taylorInvSqrt(a1 * a1 + h1 * h1);
+		m2 = m2 * detail::wide_taylorInvSqrt(a2 * a2 + h2 * h2);
+
+		float_wide<N> const g0 = a0 * x0 + h0 * y0;
+		float_wide<N> const g1 = a1 * x1 + h1 * y1;
+		float_wide<N> const g2 = a2 * x2 + h2 * y2;
+		return float_wide<N>(130.0f) * (m0 * g0 + m1 * g1 + m2 * g2);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z)
+	{
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const One(1.0f);
+		float_wide<N> const Cx(static_cast<float>(1.0 / 6.0));
+		float_wide<N> const Cy(static_cast<float>(1.0 / 3.0));
+		float_wide<N> const Dy(0.5f);
+
+		// First corner
+		float_wide<N> const d = x * Cy + y * Cy + z * Cy;
+		float_wide<N> i[3] = {floor(x + d), floor(y + d), floor(z + d)};
+		float_wide<N> const di = i[0] * Cx + i[1] * Cx + i[2] * Cx;
+		float_wide<N> const x0[3] = {x - i[0] + di, y - i[1] + di, z - i[2] + di};
+
+		// Other corners
+		float_wide<N> const g[3] = {step(x0[1], x0[0]), step(x0[2], x0[1]), step(x0[0], x0[2])};
+		float_wide<N> const l[3] = {One - g[0], One - g[1], One - g[2]};
+		float_wide<N> const i1[3] = {min(g[0], l[2]), min(g[1], l[0]), min(g[2], l[1])};
+		float_wide<N> const i2[3] = {max(g[0], l[2]), max(g[1], l[0]), max(g[2], l[1])};
+
+		float_wide<N> x1[3], x2[3], x3[3];
+		for(int c = 0; c < 3; ++c)
+		{
+			x1[c] = x0[c] - i1[c] + Cx;
+			x2[c] = x0[c] - i2[c] + Cy;
+			x3[c] = x0[c] - Dy;
+		}
+
+		// Permutations
+		for(int c = 0; c < 3; ++c)
+			i[c] = detail::wide_mod289(i[c]);
+		float_wide<N> const Offsets[4][3] = {
+			{Zero, Zero, Zero}, {i1[0], i1[1], i1[2]}, {i2[0], i2[1], i2[2]}, {One, One, One}};
+		float_wide<N> p[4];
+		for(int k = 0; k < 4; ++k)
+			p[k] = detail::wide_permute(detail::wide_permute(detail::wide_permute(
+				i[2] + Offsets[k][2]) + i[1] + Offsets[k][1]) + i[0] + Offsets[k][0]);
+
+		// Gradients: 7x7 points over a square, mapped onto an octahedron
+		float_wide<N> const n_(static_cast<float>(0.142857142857)); // 1.0/7.0
+		float_wide<N> const nsx = n_ * float_wide<N>(2.0f) - Zero;
+		float_wide<N> const nsy = n_ * float_wide<N>(0.5f) - One;
+		float_wide<N> const nsz = n_ * One - Zero;
+
+		float_wide<N> const* const Corners[4] = {x0, x1, x2, x3};
+		float_wide<N> Dots[4], Lengths[4];
+		for(int k = 0; k < 4; ++k)
+		{
+			float_wide<N> const j = p[k] - float_wide<N>(49.0f) * floor(p[k] * nsz * nsz);
+			float_wide<N> const x_ = floor(j * nsz);
+			float_wide<N> const y_ = floor(j - float_wide<N>(7.0f) * x_);
+			float_wide<N> const gx = x_ * nsx + nsy;
+			float_wide<N> const gy = y_ * nsx + nsy;
+			float_wide<N> const h = One - abs(gx) - abs(gy);
+
+			float_wide<N> const sh = -step(h, Zero);
+			float_wide<N> const px = gx + (floor(gx) * float_wide<N>(2.0f) + One) * sh;
+			float_wide<N> const py = gy + (floor(gy) * float_wide<N>(2.0f) + One) * sh;
+
+			// Normalise gradients
+			float_wide<N> const norm = detail::wide_taylorInvSqrt(px * px + py * py + h * h);
+			float_wide<N> const* Corner = Corners[k];
+			Dots[k] = px * norm * Corner[0] + py * norm * Corner[1] + h * norm * Corner[2];
+			Lengths[k] = Corner[0] * Corner[0] + Corner[1] * Corner[1] + Corner[2] * Corner[2];
+		}
+
+		// Mix final noise value
+		float_wide<N> m[4];
+		for(int k = 0; k < 4; ++k)
+		{
+			m[k] = max(float_wide<N>(0.6f) - Lengths[k], Zero);
+			m[k] = m[k] * m[k];
+			m[k] = m[k] * m[k] * Dots[k];
+		}
+		return float_wide<N>(42.0f) * ((m[0] + m[1]) + (m[2] + m[3]));
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> simplex(float_wide<N> const& x, float_wide<N> const& y, float_wide<N> const& z, float_wide<N> const& w)
+	{
+		float_wide<N> const Zero(0.0f);
+		float_wide<N> const One(1.0f);
+		float_wide<N> const C[4] = {
+			float_wide<N>(static_cast<float>(0.138196601125011)),
+			float_wide<N>(static_cast<float>(0.276393202250021)),
+			float_wide<N>(static_cast<float>(0.414589803375032)),
+			float_wide<N>(static_cast<float>(-0.447213595499958))};
+		float_wide<N> const F4(static_cast<float>(0.309016994374947451));
+
+		// First corner
+		float_wide<N> const d = (x * F4 + y * F4) + (z * F4 + w * F4);
+		float_wide<N> i[4] = {floor(x + d), floor(y + d), floor(z + d), floor(w + d)};
+		float_wide<N> const di = (i[0] * C[0] + i[1] * C[0]) + (i[2] * C[0] + i[3] * C[0]);
+		float_wide<N> const x0[4] = {x - i[0] + di, y - i[1] + di, z - i[2] + di, w - i[3] + di};
+
+		// Rank sorting originally contributed by Bill Licea-Kane, AMD (formerly ATI)
+		float_wide<N> const isX[3] = {step(x0[1], x0[0]), step(x0[2], x0[0]), step(x0[3], x0[0])};
+		float_wide<N> const isYZ[3] = {step(x0[2], x0[1]), step(x0[3], x0[1]), step(x0[3], x0[2])};
+		float_wide<N> i0[4] = {isX[0] + isX[1] + isX[2], One - isX[0], One - isX[1], One - isX[2]};
+		i0[1] = i0[1] + (isYZ[0] + isYZ[1]);
+		i0[2] = i0[2] + (One - isYZ[0]);
+		i0[3] = i0[3] + (One - isYZ[1]);
+		i0[2] = i0[2] + isYZ[2];
+		i0[3] = i0[3] + (One - isYZ[2]);
+
+		// i0 now contains the unique values 0,1,2,3 in each channel
+		float_wide<N> i1[4], i2[4], i3[4];
+		float_wide<N> x1[4], x2[4], x3[4], x4[4];
+		for(int c = 0; c < 4; ++c)
+		{
+			i3[c] = min(max(i0[c], Zero), One);
+			i2[c] = min(max(i0[c] - One, Zero), One);
+			i1[c] = min(max(i0[c] - float_wide<N>(2.0f), Zero), One);
+			x1[c] = x0[c] - i1[c] + C[0];
+			x2[c] = x0[c] - i2[c] + C[1];
+			x3[c] = x0[c] - i3[c] + C[2];
+			x4[c] = x0[c] + C[3];
+		}
+
+		// Permutations
+		for(int c = 0; c < 4; ++c)
+			i[c] = detail::wide_mod(i[c]);
+		float_wide<N> j[5];
+		j[0] = detail::wide_permute(detail::wide_permute(detail::wide_permute(detail::wide_permute(i[3]) + i[2]) + i[1]) + i[0]);
+		float_wide<N> const* const Offsets[3] = {i1, i2, i3};
+		for(int k = 0; k < 4; ++k)
+		{
+			float_wide<N> o[4];
+			for(int c = 0; c < 4; ++c)
+				o[c] = k < 3 ? Offsets[k][c] : One;
+			j[k + 1] = detail::wide_permute(detail::wide_permute(detail::wide_permute(detail::wide_permute(
+				i[3] + o[3]) + i[2] + o[2]) + i[1] + o[1]) + i[0] + o[0]);
+		}
+
+		// Gradients: 7x7x6 points over a cube, mapped onto a 4-cross polytope
+		float_wide<N> const* const Corners[5] = {x0, x1, x2, x3, x4};
+		float_wide<N> Dots[5], Lengths[5];
+		for(int k = 0; k < 5; ++k)
+		{
+			float_wide<N> px, py, pz, pw;
+			detail::wide_grad4(j[k], px, py, pz, pw);
+
+			// Normalise gradients
+			float_wide<N> const norm = detail::wide_taylorInvSqrt((px * px + py * py) + (pz * pz + pw * pw));
+			px = px * norm;
+			py = py * norm;
+			pz = pz * norm;
+			pw = pw * norm;
+
+			float_wide<N> const* Corner = Corners[k];
+			Dots[k] = (px * Corner[0] + py * Corner[1]) + (pz * Corner[2] + pw * Corner[3]);
+			Lengths[k] = (Corner[0] * Corner[0] + Corner[1] * Corner[1]) + (Corner[2] * Corner[2] + Corner[3] * Corner[3]);
+		}
+
+		// Mix contributions from the five corners
+		float_wide<N> m[5];
+		for(int k = 0; k < 5; ++k)
+		{
+			m[k] = max(float_wide<N>(0.6f) - Lengths[k], Zero);
+			m[k] = m[k] * m[k];
+			m[k] = m[k] * m[k] * Dots[k];
+		}
+		return float_wide<N>(49.0f) * ((m[0] + m[1] + m[2]) + (m[3] + m[4]));
+	}
+
+	// Fractals
+
+	GLM_FUNC_QUALIFIER float fractalNoise(vec2 const& Position, noise_params const& Params)
+	{
+		float Sum = 0.0f, Frequency = 1.0f, Prev = 1.0f;
+		float Amplitude = Params.Fractal == noise_ridged ? 0.5f : 1.0f;
+		int const Octaves = Params.Fractal == noise_single ? 1 : Params.Octaves;
+		for(int Octave = 0; Octave < Octaves; ++Octave)
+		{
+			vec2 const p = Position * Frequency;
+			float const n = Params.Basis == noise_simplex ? simplex(p) : perlin(p);
+			if(Params.Fractal == noise_ridged)
+			{
+				float r = Params.Offset - abs(n);
+				r = r * r;
+				Sum += r * Amplitude * Prev;
+				Prev = r;
+			}
+			else
+				Sum += n * Amplitude;
+			Frequency *= Params.Lacunarity;
+			Amplitude *= Params.Gain;
+		}
+		return Sum;
+	}
+
+	GLM_FUNC_QUALIFIER float fractalNoise(vec3 const& Position, noise_params const& Params)
+	{
+		float Sum = 0.0f, Frequency = 1.0f, Prev = 1.0f;
+		float Amplitude = Params.Fractal == noise_ridged ? 0.5f : 1.0f;
+		int const Octaves = Params.Fractal == noise_single ? 1 : Params.Octaves;
+		for(int Octave = 0; Octave < Octaves; ++Octave)
+		{
+			vec3 const p = Position * Frequency;
+			float const n = Params.Basis == noise_simplex ? simplex(p) : perlin(p);
+			if(Params.Fractal == noise_ridged)
+			{
+				float r = Params.Offset - abs(n);
+				r = r * r;
+				Sum += r * Amplitude * Prev;
+				Prev = r;
+			}
+			else
+				Sum += n * Amplitude;
+			Frequency *= Params.Lacunarity;
+			Amplitude *= Params.Gain;
+		}
+		return Sum;
+	}
+
+	GLM_FUNC_QUALIFIER float fractalNoise(vec4 const& Position, noise_params const& Params)
+	{
+		float Sum = 0.0f, Frequency = 1.0f, Prev = 1.0f;
+		float Amplitude = Params.Fractal == noise_ridged ? 0.5f : 1.0f;
+		int const Octaves = Params.Fractal == noise_single ? 1 : Params.Octaves;
+		for(int Octave = 0; Octave < Octaves; ++Octave)
+		{
+			vec4 const p = Position * Frequency;
+			float const n = Params.Basis == noise_simplex ? simplex(p) : perlin(p);
+			if(Params.Fractal == noise_ridged)
+			{
+				float r = Params.Offset - abs(n);
+				r = r * r;
+				Sum += r * Amplitude * Prev;
+				Prev = r;
+			}
+			else
+				Sum += n * Amplitude;
+			Frequency *= Params.Lacunarity;
+			Amplitude *= Params.Gain;
+		}
+		return Sum;
+	}
+
+namespace detail
+{
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_noise_basis(noise_basis Basis, float_wide<N> const (&p)[2])
+	{
+		return Basis == noise_simplex ? simplex(p[0], p[1]) : perlin(p[0], p[1]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_noise_basis(noise_basis Basis, float_wide<N> const (&p)[3])
+	{
+		return Basis == noise_simplex ? simplex(p[0], p[1], p[2]) : perlin(p[0], p[1], p[2]);
+	}
+
+	template<int N>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_noise_basis(noise_basis Basis, float_wide<N> const (&p)[4])
+	{
+		return Basis == noise_simplex ? simplex(p[0], p[1], p[2], p[3]) : perlin(p[0], p[1], p[2], p[3]);
+	}
+
+	// fractalNoise on N points
+	template<int N, int L>
+	GLM_FUNC_QUALIFIER float_wide<N> wide_fractal_noise(float_wide<N> const (&Position)[L], noise_params const& Params)
+	{
+		float_wide<N> Sum(0.0f), Prev(1.0f);
+		float Frequency = 1.0f;
+		float Amplitude = Params.Fractal == noise_ridged ? 0.5f : 1.0f;
+		int const Octaves = Params.Fractal == noise_single ? 1 : Params.Octaves;
+		for(int Octave = 0; Octave < Octaves; ++Octave)
+		{
+			float_wide<N> p[L];
+			for(int c = 0; c < L; ++c)
+				p[c] = Position[c] * float_wide<N>(Frequency);
+			float_wide<N> const n = wide_noise_basis(Params.Basis, p);
+			if(Params.Fractal == noise_ridged)
+			{
+				float_wide<N> r = float_wide<N>(Params.Offset) - abs(n);
+				r = r * r;
+				Sum = Sum + r * float_wide<N>(Amplitude) * Prev;
+				Prev = r;
+			}
+			else
+				Sum = Sum + n * float_wide<N>(Amplitude);
+			Frequency *= Params.Lacunarity;
+			Amplitude *= Params.Gain;
+		}
+		return Sum;
+	}
+
+	// Calls Task(Begin, End) on Count items split over Threads threads
+	template<typename task>
+	GLM_FUNC_QUALIFIER void wide_noise_parallel(task const& Task, std::size_t Count, int Threads)
+	{
+#		if GLM_LANG & GLM_LANG_CXX11_FLAG
+			if(Threads <= 0)
+				Threads = static_cast<int>(std::thread::hardware_concurrency());
+			if(static_cast<std::size_t>(Threads) > Count)
+				Threads = static_cast<int>(Count);
+			if(Threads > 1)
+			{
+				std::vector<std::thread> Workers;
+				for(int Thread = 1; Thread < Threads; ++Thread)
+					Workers.push_back(std::thread(Task, Count * Thread / Threads, Count * (Thread + 1) / Threads));
+				Task(0, Count / Threads);
+				for(std::size_t i = 0; i < Workers.size(); ++i)
+					Workers[i].join();
+				return;
+			}
+#		else
+			(void)Threads;
+#		endif
+		Task(0, Count);
+	}
+
+	// Rows of a grid, x along the row and the other coordinates fixed
+	template<int L>
+	struct wide_noise_grid_task
+	{
+		float* Dst;
+		int Size[L];
+		float Origin[L];
+		float Step[L];
+		noise_params Params;
+
+		void operator()(std::size_t Begin, std::size_t End) const
+		{
+			int const W = GLM_WIDE_NOISE_WIDTH;
+			float Lanes[W];
+			for(std::size_t Row = Begin; Row < End; ++Row)
+			{
+				float_wide<W> p[L];
+				std::size_t Index = Row;
+				for(int c = 1; c < L; ++c)
+				{
+					p[c] = float_wide<W>(Origin[c] + static_cast<float>(static_cast<int>(Index % Size[c])) * Step[c]);
+					Index /= Size[c];
+				}
+
+				float* RowDst = Dst + Row * Size[0];
+				for(int i = 0; i < Size[0]; i += W)
+				{
+					for(int Lane = 0; Lane < W; ++Lane)
+						Lanes[Lane] = static_cast<float>(i + Lane);
+					p[0] = float_wide<W>(Origin[0]) + float_wide<W>::load(Lanes) * float_wide<W>(Step[0]);
+
+					float_wide<W> const Noise = wide_fractal_noise(p, Params);
+					if(i + W <= Size[0])
+						Noise.store(RowDst + i);
+					else
+					{
+						Noise.store(Lanes);
+						for(int Lane = 0; i + Lane < Size[0]; ++Lane)
+							RowDst[i + Lane] = Lanes[Lane];
+					}
+				}
+			}
+		}
+	};
+
+	template<int L>
+	struct wide_noise_points_task
+	{
+		float* Dst;
+		float const* Points;
+		noise_params Params;
+
+		void operator()(std::size_t Begin, std::size_t End) const
+		{
+			int const W = GLM_WIDE_NOISE_WIDTH;
+			float Coords[L][W];
+			for(std::size_t i = Begin; i < End; i += W)
+			{
+				// the last block repeats its last point in the missing lanes
+				for(int Lane = 0; Lane < W; ++Lane)
+				{
+					std::size_t const Point = i + Lane < End ? i + Lane : End - 1;
+					for(int c = 0; c < L; ++c)
+						Coords[c][Lane] = Points[Point * L + c];
+				}
+				float_wide<W> p[L];
+				for(int c = 0; c < L; ++c)
+					p[c] = float_wide<W>::load(Coords[c]);
+
+				float_wide<W> const Noise = wide_fractal_noise(p, Params);
+				if(i + W <= End)
+					Noise.store(Dst + i);
+				else
+				{
+					Noise.store(Coords[0]);
+					for(std::size_t Lane = 0; i + Lane < End; ++Lane)
+						Dst[i + Lane] = Coords[0][Lane];
+				}
+			}
+		}
+	};
+
+	template<int L>
+	GLM_FUNC_QUALIFIER void wide_noise_grid(float* Dst, int const* Size, float const* Origin, float const* Step, noise_params const& Params)
+	{
+		wide_noise_grid_task<L> Task;
+		Task.Dst = Dst;
+		Task.Params = Params;
+		std::size_t Rows = 1;
+		for(int c = 0; c < L; ++c)
+		{
+			if(Size[c] <= 0)
+				return;
+			Task.Size[c] = Size[c];
+			Task.Origin[c] = Origin[c];
+			Task.Step[c] = Step[c];
+			if(c > 0)
+				Rows *= static_cast<std::size_t>(Size[c]);
+		}
+		wide_noise_parallel(Task, Rows, Params.Threads);
+	}
+
+	template<int L>
+	GLM_FUNC_QUALIFIER void wide_noise_points(float* Dst, float const* Points, std::size_t Count, noise_params const& Params)
+	{
+		wide_noise_points_task<L> Task;
+		Task.Dst = Dst;
+		Task.Points = Points;
+		Task.Params = Params;
+		wide_noise_parallel(Task, Count, Params.Threads);
+	}
+}//namespace detail
+
+	GLM_FUNC_QUALIFIER void noiseGrid(float* Dst, ivec2 const& Size, vec2 const& Origin, vec2 const& Step, noise_params const& Params)
+	{
+		detail::wide_noise_grid<2>(Dst, &Size[0], &Origin[0], &Step[0], Params);
+	}
+
+	GLM_FUNC_QUALIFIER void noiseGrid(float* Dst, ivec3 const& Size, vec3 const& Origin, vec3 const& Step, noise_params const& Params)
+	{
+		detail::wide_noise_grid<3>(Dst, &Size[0], &Origin[0], &Step[0], Params);
+	}
+
+	GLM_FUNC_QUALIFIER void noiseGrid(float* Dst, ivec4 const& Size, vec4 const& Origin, vec4 const& Step, noise_params const& Params)
+	{
+		detail::wide_noise_grid<4>(Dst, &Size[0], &Origin[0], &Step[0], Params);
+	}
+
+	GLM_FUNC_QUALIFIER void noisePoints(float* Dst, vec2 const* Points, std::size_t Count, noise_params const& Params)
+	{
+		detail::wide_noise_points<2>(Dst, &Points[0][0], Count, Params);
+	}
+
+	GLM_FUNC_QUALIFIER void noisePoints(float* Dst, vec3 const* Points, std::size_t Count, noise_params const& Params)
+	{
+		detail::wide_noise_points<3>(Dst, &Points[0][0], Count, Params);
+	}
+
+	GLM_FUNC_QUALIFIER void noisePoints(float* Dst, vec4 const* Points, std::size_t Count, noise_params const& Params)
+	{
+		detail::wide_noise_points<4>(Dst, &Points[0][0], Count, Params);
+	}
+}//namespace glm
@@ -0,0 +1,337 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/gtx/gtx_bulk_packing.cpp
+/// @date 2026-10-19 / 2026-10-19
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/bulk_packing.hpp>
+#include <glm/gtc/packing.hpp>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	glm::uint32 State = 0x12345678;
+
+	glm::uint32 randomBits()
+	{
+		State ^= State << 13;
+		State ^= State >> 17;
+		State ^= State << 5;
+		return State;
+	}
+
+	float bitsToFloat(glm::uint32 Bits)
+	{
+		float Value;
+		std::memcpy(&Value, &Bits, sizeof(Value));
+		return Value;
+	}
+
+	bool sameBits(float a, float b)
+	{
+		return std::memcmp(&a, &b, sizeof(a)) == 0;
+	}
+
+	bool sameBits(glm::vec3 const& a, glm::vec3 const& b)
+	{
+		return sameBits(a.x, b.x) && sameBits(a.y, b.y) && sameBits(a.z, b.z);
+	}
+
+	bool sameBits(glm::vec4 const& a, glm::vec4 const& b)
+	{
+		return sameBits(glm::vec3(a), glm::vec3(b)) && sameBits(a.w, b.w);
+	}
+
+	// Edge cases, then random bit patterns and random values in [-2, 2]. The odd count
+	// leaves a scalar tail after the SIMD blocks.
+	std::vector<float> floats(bool WithNaN)
+	{
+		glm::uint32 const Edges[] =
+		{
+			0x00000000, 0x80000000, 0x00000001, 0x807fffff,	// zero and float denormals
+			0x33000000, 0x33000001, 0x337fffff, 0xb3000000,	// the smallest half denormal and its halfway point
+			0x33c00000, 0x34200000, 0x38000000, 0x387fc000,	// half denormal ties
+			0x387fe000, 0x38800000, 0x38801000, 0x38803000,	// the smallest normal half and ties around it
+			0x3f800000, 0x3f801000, 0x3f803000, 0xbf801000,	// ties at 1
+			0x3b000000, 0x3b800000, 0x3c000000, 0xbb000000,	// 1 / 255 and 1 / 127 neighbours
+			0x477fe000, 0x477fefff, 0x477ff000, 0x477fffff,	// the largest half and overflow
+			0x4f000000, 0xcf000000, 0x7f7fffff, 0xff7fffff,	// beyond the integer range
+			0x7f800000, 0xff800000,							// infinity
+			0x7fc00000, 0xffc00000, 0x7f800001, 0x7fa00000,	// quiet and signaling NaN
+			0x7f801fff, 0xff802000, 0x7fffffff
+		};
+
+		std::vector<float> Values;
+		for(std::size_t i = 0; i < sizeof(Edges) / sizeof(Edges[0]); ++i)
+			Values.push_back(bitsToFloat(Edges[i]));
+		for(int i = 0; i < 4000; ++i)
+			Values.push_back(bitsToFloat(randomBits()));
+		for(int i = 0; i < 4001; ++i)
+		{
+			float const Unit = static_cast<float>(randomBits() >> 8) / 16777216.0f;
+			Values.push_back(Unit * 4.0f - 2.0f);
+		}
+		for(int i = 0; i < 255; ++i)
+			Values.push_back((static_cast<float>(i) + 0.5f) / 255.0f);
+
+		if(!WithNaN)
+		{
+			std::vector<float> Numbers;
+			for(std::size_t i = 0; i < Values.size(); ++i)
+				if(!glm::isnan(Values[i]))
+					Numbers.push_back(Values[i]);
+			return Numbers;
+		}
+		return Values;
+	}
+
+	glm::vec4 packRGBMScalar(glm::vec3 const& rgb)
+	{
+#		if GLM_VERSION >= 99
+			return glm::packRGBM(rgb);
+#		else
+			glm::vec3 const Color(rgb * static_cast<float>(1.0 / 6.0));
+			float const MaxXY = Color.x < Color.y ? Color.y : Color.x;
+			float const MaxZ = Color.z < 1e-6f ? 1e-6f : Color.z;
+			float Alpha = MaxXY < MaxZ ? MaxZ : MaxXY;
+			Alpha = Alpha < 0.0f ? 0.0f : (Alpha > 1.0f ? 1.0f : Alpha);
+			Alpha = glm::ceil(Alpha * 255.0f) / 255.0f;
+			return glm::vec4(Color / Alpha, Alpha);
+#		endif
+	}
+}//namespace
+
+int test_half()
+{
+	int Error(0);
+
+	std::vector<float> const Values = floats(true);
+	std::vector<glm::uint16> Packed(Values.size() + 1, 42);
+	glm::packHalf(&Packed[0], &Values[0], Values.size());
+	for(std::size_t i = 0; i < Values.size(); ++i)
+		Error += Packed[i] == glm::packHalf1x16(Values[i]) ? 0 : 1;
+	Error += Packed[Values.size()] == 42 ? 0 : 1;
+
+	// every half
+	std::vector<glm::uint16> Halves(65536);
+	for(std::size_t i = 0; i < Halves.size(); ++i)
+		Halves[i] = static_cast<glm::uint16>(i);
+	std::vector<float> Unpacked(Halves.size());
+	glm::unpackHalf(&Unpacked[0], &Halves[0], Halves.size());
+	for(std::size_t i = 0; i < Halves.size(); ++i)
+		Error += sameBits(Unpacked[i], glm::unpackHalf1x16(Halves[i])) ? 0 : 1;
+
+	return Error;
+}
+
+int test_unorm()
+{
+	int Error(0);
+
+	std::vector<float> const Values = floats(false);
+	std::vector<glm::uint8> Packed8(Values.size());
+	std::vector<glm::uint16> Packed16(Values.size());
+	glm::packUnorm(&Packed8[0], &Values[0], Values.size());
+	glm::packUnorm(&Packed16[0], &Values[0], Values.size());
+	for(std::size_t i = 0; i < Values.size(); ++i)
+	{
+		Error += Packed8[i] == glm::packUnorm1x8(Values[i]) ? 0 : 1;
+		Error += Packed16[i] == glm::packUnorm1x16(Values[i]) ? 0 : 1;
+	}
+
+	std::vector<glm::uint8> Bytes(256 + 7);
+	std::vector<glm::uint16> Words(65536 + 7);
+	for(std::size_t i = 0; i < Bytes.size(); ++i)
+		Bytes[i] = static_cast<glm::uint8>(i);
+	for(std::size_t i = 0; i < Words.size(); ++i)
+		Words[i] = static_cast<glm::uint16>(i);
+	std::vector<float> Unpacked8(Bytes.size()), Unpacked16(Words.size());
+	glm::unpackUnorm(&Unpacked8[0], &Bytes[0], Bytes.size());
+	glm::unpackUnorm(&Unpacked16[0], &Words[0], Words.size());
+	for(std::size_t i = 0; i < Bytes.size(); ++i)
+		Error += sameBits(Unpacked8[i], glm::unpackUnorm1x8(Bytes[i])) ? 0 : 1;
+	for(std::size_t i = 0; i < Words.size(); ++i)
+		Error += sameBits(Unpacked16[i], glm::unpackUnorm1x16(Words[i])) ? 0 : 1;
+
+	return Error;
+}
+
+int test_snorm()
+{
+	int Error(0);
+
+	std::vector<float> const Values = floats(false);
+	std::vector<glm::int8> Packed8(Values.size());
+	std::vector<glm::int16> Packed16(Values.size());
+	glm::packSnorm(&Packed8[0], &Values[0], Values.size());
+	glm::packSnorm(&Packed16[0], &Values[0], Values.size());
+	for(std::size_t i = 0; i < Values.size(); ++i)
+	{
+		Error += static_cast<glm::uint8>(Packed8[i]) == glm::packSnorm1x8(Values[i]) ? 0 : 1;
+		Error += static_cast<glm::uint16>(Packed16[i]) == glm::packSnorm1x16(Values[i]) ? 0 : 1;
+	}
+
+	std::vector<glm::int8> Bytes(256 + 7);
+	std::vector<glm::int16> Words(65536 + 7);
+	for(std::size_t i = 0; i < Bytes.size(); ++i)
+		Bytes[i] = static_cast<glm::int8>(static_cast<glm::uint8>(i));
+	for(std::size_t i = 0; i < Words.size(); ++i)
+		Words[i] = static_cast<glm::int16>(static_cast<glm::uint16>(i));
+	std::vector<float> Unpacked8(Bytes.size()), Unpacked16(Words.size());
+	glm::unpackSnorm(&Unpacked8[0], &Bytes[0], Bytes.size());
+	glm::unpackSnorm(&Unpacked16[0], &Words[0], Words.size());
+	for(std::size_t i = 0; i < Bytes.size(); ++i)
+		Error += sameBits(Unpacked8[i], glm::unpackSnorm1x8(static_cast<glm::uint8>(Bytes[i]))) ? 0 : 1;
+	for(std::size_t i = 0; i < Words.size(); ++i)
+		Error += sameBits(Unpacked16[i], glm::unpackSnorm1x16(static_cast<glm::uint16>(Words[i]))) ? 0 : 1;
+
+	return Error;
+}
+
+// NaN is undefined for the scalar unorm and snorm functions, the array ones give 0
+int test_nan()
+{
+	int Error(0);
+
+	std::vector<float> Values(19, bitsToFloat(0x7fc00000));
+	Values[3] = bitsToFloat(0xffa00001);
+	std::vector<glm::uint8> Unorm8(Values.size(), 42);
+	std::vector<glm::uint16> Unorm16(Values.size(), 42);
+	std::vector<glm::int8> Snorm8(Values.size(), 42);
+	std::vector<glm::int16> Snorm16(Values.size(), 42);
+	glm::packUnorm(&Unorm8[0], &Values[0], Values.size());
+	glm::packUnorm(&Unorm16[0], &Values[0], Values.size());
+	glm::packSnorm(&Snorm8[0], &Values[0], Values.size());
+	glm::packSnorm(&Snorm16[0], &Values[0], Values.size());
+	for(std::size_t i = 0; i < Values.size(); ++i)
+		Error += Unorm8[i] == 0 && Unorm16[i] == 0 && Snorm8[i] == 0 && Snorm16[i] == 0 ? 0 : 1;
+
+	return Error;
+}
+
+int test_F2x11_1x10()
+{
+	int Error(0);
+
+	std::vector<float> const Values = floats(true);
+	std::vector<glm::vec3> Colors(Values.size() / 3);
+	for(std::size_t i = 0; i < Colors.size(); ++i)
+		Colors[i] = glm::vec3(Values[i * 3 + 0], Values[i * 3 + 1], Values[i * 3 + 2]);
+	std::vector<glm::uint32> Packed(Colors.size());
+	glm::packF2x11_1x10(&Packed[0], &Colors[0], Colors.size());
+	for(std::size_t i = 0; i < Colors.size(); ++i)
+		Error += Packed[i] == glm::packF2x11_1x10(Colors[i]) ? 0 : 1;
+
+	// random words and the zero, infinity and NaN codes of each component
+	std::vector<glm::uint32> Words;
+	glm::uint32 const Codes[] = {0x000, 0x7c0, 0x7ff, 0x3e0, 0x3ff, 0x001};
+	for(std::size_t i = 0; i < 6; ++i)
+	for(std::size_t j = 0; j < 6; ++j)
+	for(std::size_t k = 0; k < 6; ++k)
+		Words.push_back(Codes[i] | (Codes[j] << 11) | ((Codes[k] & 0x3ff) << 22));
+	for(int i = 0; i < 4001; ++i)
+		Words.push_back(randomBits());
+	std::vector<glm::vec3> Unpacked(Words.size());
+	glm::unpackF2x11_1x10(&Unpacked[0], &Words[0], Words.size());
+	for(std::size_t i = 0; i < Words.size(); ++i)
+		Error += sameBits(Unpacked[i], glm::unpackF2x11_1x10(Words[i])) ? 0 : 1;
+
+	return Error;
+}
+
+int test_RGBM()
+{
+	int Error(0);
+
+	std::vector<glm::vec3> Colors;
+	Colors.push_back(glm::vec3(0.0f));
+	Colors.push_back(glm::vec3(6.0f));
+	Colors.push_back(glm::vec3(100.0f, 0.0f, 0.5f));
+	Colors.push_back(glm::vec3(-1.0f, 0.25f, 0.0f));
+	Colors.push_back(glm::vec3(bitsToFloat(0x7f800000), 1.0f, 0.0f));
+	Colors.push_back(glm::vec3(bitsToFloat(0x7fc00000), 1.0f, 2.0f));
+	Colors.push_back(glm::vec3(1.0f, bitsToFloat(0x7fc00000), 2.0f));
+	Colors.push_back(glm::vec3(1.0f, 3.0f, bitsToFloat(0x7fc00000)));
+	for(int i = 0; i < 2001; ++i)
+	{
+		glm::vec3 Color;
+		for(int c = 0; c < 3; ++c)
+			Color[c] = static_cast<float>(randomBits() >> 8) / 16777216.0f * (i % 2 ? 8.0f : 0.01f);
+		Colors.push_back(Color);
+	}
+
+	std::vector<glm::vec4> Packed(Colors.size());
+	glm::packRGBM(&Packed[0], &Colors[0], Colors.size());
+	for(std::size_t i = 0; i < Colors.size(); ++i)
+		Error += sameBits(Packed[i], packRGBMScalar(Colors[i])) ? 0 : 1;
+
+	std::vector<glm::vec3> Unpacked(Packed.size());
+	glm::unpackRGBM(&Unpacked[0], &Packed[0], Packed.size());
+	for(std::size_t i = 0; i < Packed.size(); ++i)
+		Error += sameBits(Unpacked[i], glm::vec3(Packed[i]) * Packed[i].w * 6.0f) ? 0 : 1;
+
+	return Error;
+}
+
+// large enough for the threaded path when it is compiled in
+int test_parallel()
+{
+	int Error(0);
+
+	std::size_t const Count = (GLM_BULK_PACKING_PARALLEL_SIZE > 0 ? GLM_BULK_PACKING_PARALLEL_SIZE / 6 : 0) + 1001;
+	std::vector<float> Values(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+		Values[i] = static_cast<float>(randomBits() >> 8) / 16777216.0f * 4.0f - 2.0f;
+	std::vector<glm::uint16> Packed(Count);
+	glm::packHalf(&Packed[0], &Values[0], Count);
+	std::vector<float> Unpacked(Count);
+	glm::unpackHalf(&Unpacked[0], &Packed[0], Count);
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		Error += Packed[i] == glm::packHalf1x16(Values[i]) ? 0 : 1;
+		Error += sameBits(Unpacked[i], glm::unpackHalf1x16(Packed[i])) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+int main()
+{
+	int Error(0);
+
+	Error += test_half();
+	Error += test_unorm();
+	Error += test_snorm();
+	Error += test_nan();
+	Error += test_F2x11_1x10();
+	Error += test_RGBM();
+	Error += test_parallel();
+
+	return Error;
+}
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/gtx/gtx_wide_noise.cpp
+/// @date 2026-10-19 / 2026-10-19
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/wide_noise.hpp>
+#include <glm/gtc/random.hpp>
+#include <vector>
+
+namespace
+{
+	// the wide functions evaluate the scalar expressions, so they only differ by rounding. The
+	// test is built without multiply add contraction, which flips gradients of the scalar noise
+	float const Epsilon = 1e-3f;
+
+	bool near(float a, float b)
+	{
+		return glm::abs(a - b) <= Epsilon * glm::max(1.0f, glm::abs(b));
+	}
+
+	glm::noise_params params(glm::noise_basis Basis, glm::noise_fractal Fractal, int Threads)
+	{
+		glm::noise_params Params;
+		Params.Basis = Basis;
+		Params.Fractal = Fractal;
+		Params.Octaves = 5;
+		Params.Threads = Threads;
+		return Params;
+	}
+}//namespace
+
+template<int N>
+int test_basis()
+{
+	int Error(0);
+
+	for(int Pass = 0; Pass < 64; ++Pass)
+	{
+		// positions across lattice cells, negative coordinates and beyond the 289 period. Exact lattice
+		// points are avoided, the simplex corner order there flips with the rounding of a contracted
+		// multiply and add, so the cells are entered at a fixed offset instead
+		glm::vec4 P[N];
+		float X[N], Y[N], Z[N], W[N];
+		for(int i = 0; i < N; ++i)
+		{
+			P[i] = glm::linearRand(glm::vec4(-400.0f), glm::vec4(400.0f));
+			if(Pass % 4 == 0)
+				P[i] = glm::floor(P[i]) + glm::vec4(0.37f, 0.61f, 0.13f, 0.83f);
+			X[i] = P[i].x; Y[i] = P[i].y; Z[i] = P[i].z; W[i] = P[i].w;
+		}
+		glm::float_wide<N> const x = glm::float_wide<N>::load(X);
+		glm::float_wide<N> const y = glm::float_wide<N>::load(Y);
+		glm::float_wide<N> const z = glm::float_wide<N>::load(Z);
+		glm::float_wide<N> const w = glm::float_wide<N>::load(W);
+
+		glm::float_wide<N> const Perlin2 = glm::perlin(x, y);
+		glm::float_wide<N> const Perlin3 = glm::perlin(x, y, z);
+		glm::float_wide<N> const Perlin4 = glm::perlin(x, y, z, w);
+		glm::float_wide<N> const Simplex2 = glm::simplex(x, y);
+		glm::float_wide<N> const Simplex3 = glm::simplex(x, y, z);
+		glm::float_wide<N> const Simplex4 = glm::simplex(x, y, z, w);
+
+		for(int i = 0; i < N; ++i)
+		{
+			Error += near(glm::lane(Perlin2, i), glm::perlin(glm::vec2(P[i]))) ? 0 : 1;
+			Error += near(glm::lane(Perlin3, i), glm::perlin(glm::vec3(P[i]))) ? 0 : 1;
+			Error += near(glm::lane(Perlin4, i), glm::perlin(P[i])) ? 0 : 1;
+			Error += near(glm::lane(Simplex2, i), glm::simplex(glm::vec2(P[i]))) ? 0 : 1;
+			Error += near(glm::lane(Simplex3, i), glm::simplex(glm::vec3(P[i]))) ? 0 : 1;
+			Error += near(glm::lane(Simplex4, i), glm::simplex(P[i])) ? 0 : 1;
+		}
+	}
+
+	return Error;
+}
+
+int test_fractal()
+{
+	int Error(0);
+
+	glm::vec3 const P(1.3f, -2.7f, 5.1f);
+
+	// a single octave is the basis noise itself
+	Error += glm::fractalNoise(P, params(glm::noise_perlin, glm::noise_single, 1)) == glm::perlin(P) ? 0 : 1;
+	Error += glm::fractalNoise(P, params(glm::noise_simplex, glm::noise_single, 1)) == glm::simplex(P) ? 0 : 1;
+
+	// fBm: octave i at twice the frequency and half the amplitude of octave i - 1
+	glm::noise_params const Fbm = params(glm::noise_perlin, glm::noise_fbm, 1);
+	float Sum = 0.0f;
+	for(int i = 0; i < Fbm.Octaves; ++i)
+		Sum += glm::perlin(P * glm::pow(2.0f, float(i))) * glm::pow(0.5f, float(i));
+	Error += near(glm::fractalNoise(P, Fbm), Sum) ? 0 : 1;
+
+	// ridged octaves are never negative
+	glm::noise_params const Ridged = params(glm::noise_simplex, glm::noise_ridged, 1);
+	for(int i = 0; i < 100; ++i)
+		Error += glm::fractalNoise(glm::ballRand(50.0f), Ridged) >= 0.0f ? 0 : 1;
+
+	return Error;
+}
+
+int test_grid(glm::noise_basis Basis, glm::noise_fractal Fractal, int Threads)
+{
+	int Error(0);
+
+	glm::noise_params const Params = params(Basis, Fractal, Threads);
+
+	// x sizes that are not a multiple of any lane count
+	glm::ivec2 const Size2(37, 5);
+	glm::vec2 const Origin2(-3.2f, 7.9f), Step2(0.173f, 0.31f);
+	std::vector<float> Grid2(Size2.x * Size2.y);
+	glm::noiseGrid(&Grid2[0], Size2, Origin2, Step2, Params);
+	for(int j = 0; j < Size2.y; ++j)
+	for(int i = 0; i < Size2.x; ++i)
+		Error += near(Grid2[j * Size2.x + i], glm::fractalNoise(Origin2 + glm::vec2(i, j) * Step2, Params)) ? 0 : 1;
+
+	glm::ivec3 const Size3(19, 4, 3);
+	glm::vec3 const Origin3(0.5f, -1.25f, 2.0f), Step3(0.21f, 0.4f, 0.33f);
+	std::vector<float> Grid3(Size3.x * Size3.y * Size3.z);
+	glm::noiseGrid(&Grid3[0], Size3, Origin3, Step3, Params);
+	for(int k = 0; k < Size3.z; ++k)
+	for(int j = 0; j < Size3.y; ++j)
+	for(int i = 0; i < Size3.x; ++i)
+		Error += near(Grid3[(k * Size3.y + j) * Size3.x + i], glm::fractalNoise(Origin3 + glm::vec3(i, j, k) * Step3, Params)) ? 0 : 1;
+
+	glm::ivec4 const Size4(9, 3, 2, 2);
+	glm::vec4 const Origin4(1.0f, 2.0f, -3.0f, 0.25f), Step4(0.3f, 0.3f, 0.45f, 0.6f);
+	std::vector<float> Grid4(Size4.x * Size4.y * Size4.z * Size4.w);
+	glm::noiseGrid(&Grid4[0], Size4, Origin4, Step4, Params);
+	for(int l = 0; l < Size4.w; ++l)
+	for(int k = 0; k < Size4.z; ++k)
+	for(int j = 0; j < Size4.y; ++j)
+	for(int i = 0; i < Size4.x; ++i)
+		Error += near(Grid4[((l * Size4.z + k) * Size4.y + j) * Size4.x + i], glm::fractalNoise(Origin4 + glm::vec4(i, j, k, l) * Step4, Params)) ? 0 : 1;
+
+	return Error;
+}
+
+int test_points(glm::noise_basis Basis, glm::noise_fractal Fractal, int Threads)
+{
+	int Error(0);
+
+	glm::noise_params const Params = params(Basis, Fractal, Threads);
+
+	std::size_t const Count = 101;
+	std::vector<glm::vec2> Points2(Count);
+	std::vector<glm::vec3> Points3(Count);
+	std::vector<glm::vec4> Points4(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		Points4[i] = glm::linearRand(glm::vec4(-20.0f), glm::vec4(20.0f));
+		Points3[i] = glm::vec3(Points4[i]);
+		Points2[i] = glm::vec2(Points4[i]);
+	}
+
+	// one more element than Count, so the tail must not be written
+	std::vector<float> Noise2(Count + 1, 42.0f), Noise3(Count + 1, 42.0f), Noise4(Count + 1, 42.0f);
+	glm::noisePoints(&Noise2[0], &Points2[0], Count, Params);
+	glm::noisePoints(&Noise3[0], &Points3[0], Count, Params);
+	glm::noisePoints(&Noise4[0], &Points4[0], Count, Params);
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		Error += near(Noise2[i], glm::fractalNoise(Points2[i], Params)) ? 0 : 1;
+		Error += near(Noise3[i], glm::fractalNoise(Points3[i], Params)) ? 0 : 1;
+		Error += near(Noise4[i], glm::fractalNoise(Points4[i], Params)) ? 0 : 1;
+	}
+	Error += Noise2[Count] == 42.0f && Noise3[Count] == 42.0f && Noise4[Count] == 42.0f ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	int Error(0);
+
+	Error += test_basis<3>();
+	Error += test_basis<4>();
+	Error += test_basis<8>();
+	Error += test_basis<16>();
+	Error += test_fractal();
+
+	glm::noise_basis const Bases[] = {glm::noise_perlin, glm::noise_simplex};
+	glm::noise_fractal const Fractals[] = {glm::noise_single, glm::noise_fbm, glm::noise_ridged};
+	for(int b = 0; b < 2; ++b)
+	for(int f = 0; f < 3; ++f)
+	{
+		// one thread, then one per hardware thread, then more threads than rows
+		Error += test_grid(Bases[b], Fractals[f], 1);
+		Error += test_grid(Bases[b], Fractals[f], 0);
+		Error += test_grid(Bases[b], Fractals[f], 64);
+		Error += test_points(Bases[b], Fractals[f], 1);
+		Error += test_points(Bases[b], Fractals[f], 3);
+	}
+
+	return Error;
+}
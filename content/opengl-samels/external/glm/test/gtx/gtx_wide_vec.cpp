@@ -0,0 +1,356 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/gtx/gtx_wide_vec.cpp
+/// @date 2026-10-19 / 2026-10-19
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/wide_vec.hpp>
+#include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/random.hpp>
+#include <vector>
+
+namespace
+{
+	float const Epsilon = 1e-4f;
+
+	bool equal3(glm::vec3 const& a, glm::vec3 const& b)
+	{
+		return glm::all(glm::epsilonEqual(a, b, Epsilon * glm::max(1.0f, glm::length(b))));
+	}
+
+	bool equal4(glm::vec4 const& a, glm::vec4 const& b)
+	{
+		return glm::all(glm::epsilonEqual(a, b, Epsilon * glm::max(1.0f, glm::length(b))));
+	}
+
+	glm::quat randomQuat()
+	{
+		return glm::angleAxis(glm::linearRand(-3.0f, 3.0f), glm::sphericalRand(1.0f));
+	}
+
+	glm::mat4 randomMatrix()
+	{
+		glm::mat4 const Translate = glm::translate(glm::mat4(1.0f), glm::ballRand(10.0f));
+		return glm::scale(Translate * glm::mat4_cast(randomQuat()), glm::linearRand(glm::vec3(0.5f), glm::vec3(2.0f)));
+	}
+
+	std::vector<glm::vec3> randomVectors(int Count)
+	{
+		std::vector<glm::vec3> Vectors(Count);
+		for(int i = 0; i < Count; ++i)
+			Vectors[i] = glm::ballRand(10.0f);
+		return Vectors;
+	}
+}//namespace
+
+template<int N>
+int test_load_store()
+{
+	int Error(0);
+
+	// a few elements more than N, so the stores must not touch them
+	std::vector<glm::vec3> const Src = randomVectors(N + 2);
+	glm::vec3_wide<N> Wide;
+	glm::load(Wide, &Src[0]);
+	for(int i = 0; i < N; ++i)
+		Error += glm::lane(Wide, i) == Src[i] ? 0 : 1;
+
+	std::vector<glm::vec3> Dst(N + 2, glm::vec3(42.0f));
+	glm::store(&Dst[0], Wide);
+	for(int i = 0; i < N; ++i)
+		Error += Dst[i] == Src[i] ? 0 : 1;
+	Error += Dst[N] == glm::vec3(42.0f) ? 0 : 1;
+	Error += Dst[N + 1] == glm::vec3(42.0f) ? 0 : 1;
+
+	float X[N], Y[N], Z[N];
+	glm::store(X, Y, Z, Wide);
+	glm::vec3_wide<N> FromArrays;
+	glm::load(FromArrays, X, Y, Z);
+	for(int i = 0; i < N; ++i)
+	{
+		Error += X[i] == Src[i].x && Y[i] == Src[i].y && Z[i] == Src[i].z ? 0 : 1;
+		Error += glm::lane(FromArrays, i) == Src[i] ? 0 : 1;
+	}
+
+	std::vector<glm::vec4> Src4(N), Dst4(N);
+	std::vector<glm::quat> SrcQuat(N), DstQuat(N);
+	for(int i = 0; i < N; ++i)
+	{
+		Src4[i] = glm::vec4(Src[i], float(i));
+		SrcQuat[i] = randomQuat();
+	}
+	glm::vec4_wide<N> Wide4;
+	glm::quat_wide<N> WideQuat;
+	glm::load(Wide4, &Src4[0]);
+	glm::load(WideQuat, &SrcQuat[0]);
+	glm::store(&Dst4[0], Wide4);
+	glm::store(&DstQuat[0], WideQuat);
+	for(int i = 0; i < N; ++i)
+	{
+		Error += Dst4[i] == Src4[i] ? 0 : 1;
+		Error += DstQuat[i] == SrcQuat[i] ? 0 : 1;
+		Error += glm::lane(WideQuat, i) == SrcQuat[i] ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<int N>
+int test_gather_scatter()
+{
+	int Error(0);
+
+	int const Count = 3 * N;
+	std::vector<glm::vec3> const Base = randomVectors(Count);
+	std::vector<glm::mat4> Matrices(Count);
+	for(int i = 0; i < Count; ++i)
+		Matrices[i] = randomMatrix();
+
+	int Indices[N];
+	for(int i = 0; i < N; ++i)
+		Indices[i] = (i * 7 + 2) % Count;
+
+	glm::vec3_wide<N> Wide;
+	glm::mat4_wide<N> WideMatrices;
+	glm::gather(Wide, &Base[0], Indices);
+	glm::gather(WideMatrices, &Matrices[0], Indices);
+	for(int i = 0; i < N; ++i)
+	{
+		Error += glm::lane(Wide, i) == Base[Indices[i]] ? 0 : 1;
+		Error += glm::lane(WideMatrices, i) == Matrices[Indices[i]] ? 0 : 1;
+	}
+
+	std::vector<glm::vec3> Scattered(Count, glm::vec3(0.0f));
+	glm::scatter(&Scattered[0], Indices, Wide);
+	for(int i = 0; i < N; ++i)
+		Error += Scattered[Indices[i]] == Base[Indices[i]] ? 0 : 1;
+
+	return Error;
+}
+
+template<int N>
+int test_geometric()
+{
+	int Error(0);
+
+	std::vector<glm::vec3> const A = randomVectors(N);
+	std::vector<glm::vec3> const B = randomVectors(N);
+	float T[N];
+	for(int i = 0; i < N; ++i)
+		T[i] = glm::linearRand(0.0f, 1.0f);
+
+	glm::vec3_wide<N> WideA, WideB;
+	glm::load(WideA, &A[0]);
+	glm::load(WideB, &B[0]);
+	glm::float_wide<N> const WideT = glm::float_wide<N>::load(T);
+
+	glm::float_wide<N> const Dot = glm::dot(WideA, WideB);
+	glm::float_wide<N> const Length = glm::length(WideA);
+	glm::float_wide<N> const Distance = glm::distance(WideA, WideB);
+	glm::vec3_wide<N> const Cross = glm::cross(WideA, WideB);
+	glm::vec3_wide<N> const Normalized = glm::normalize(WideA);
+	glm::vec3_wide<N> const Mixed = glm::mix(WideA, WideB, WideT);
+	glm::vec3_wide<N> const Scaled = (WideA - WideB) * 0.5f + -WideA / glm::max(Length, glm::float_wide<N>(1.0f));
+
+	for(int i = 0; i < N; ++i)
+	{
+		Error += glm::epsilonEqual(glm::lane(Dot, i), glm::dot(A[i], B[i]), Epsilon * 100.0f) ? 0 : 1;
+		Error += glm::epsilonEqual(glm::lane(Length, i), glm::length(A[i]), Epsilon) ? 0 : 1;
+		Error += glm::epsilonEqual(glm::lane(Distance, i), glm::distance(A[i], B[i]), Epsilon * 10.0f) ? 0 : 1;
+		Error += equal3(glm::lane(Cross, i), glm::cross(A[i], B[i])) ? 0 : 1;
+		Error += equal3(glm::lane(Normalized, i), glm::normalize(A[i])) ? 0 : 1;
+		Error += equal3(glm::lane(Mixed, i), glm::mix(A[i], B[i], T[i])) ? 0 : 1;
+		Error += equal3(glm::lane(Scaled, i), (A[i] - B[i]) * 0.5f - A[i] / glm::max(glm::length(A[i]), 1.0f)) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<int N>
+int test_transform()
+{
+	int Error(0);
+
+	glm::mat4 const Uniform = randomMatrix();
+	std::vector<glm::mat4> PerLane(N);
+	for(int i = 0; i < N; ++i)
+		PerLane[i] = randomMatrix();
+	std::vector<glm::vec3> const P = randomVectors(N);
+
+	glm::mat4_wide<N> WideMatrices;
+	for(int c = 0; c < 4; ++c)
+	{
+		std::vector<glm::vec4> Column(N);
+		for(int i = 0; i < N; ++i)
+			Column[i] = PerLane[i][c];
+		glm::load(WideMatrices[c], &Column[0]);
+	}
+
+	glm::vec3_wide<N> WideP;
+	glm::load(WideP, &P[0]);
+	glm::vec4_wide<N> const WideP4(WideP, glm::float_wide<N>(1.0f));
+
+	glm::vec3_wide<N> const Positions = glm::transformPosition(Uniform, WideP);
+	glm::vec3_wide<N> const Directions = glm::transformDirection(Uniform, WideP);
+	glm::vec3_wide<N> const PerLanePositions = glm::transformPosition(WideMatrices, WideP);
+	glm::vec4_wide<N> const Products = Uniform * WideP4;
+	glm::vec4_wide<N> const PerLaneProducts = WideMatrices * WideP4;
+
+	// a linear blend of two matrices per lane, as in skinning
+	glm::float_wide<N> const Weight(0.25f);
+	glm::mat4_wide<N> const Blended = WideMatrices * Weight + glm::mat4_wide<N>(Uniform) * (glm::float_wide<N>(1.0f) - Weight);
+
+	for(int i = 0; i < N; ++i)
+	{
+		Error += equal3(glm::lane(Positions, i), glm::vec3(Uniform * glm::vec4(P[i], 1.0f))) ? 0 : 1;
+		Error += equal3(glm::lane(Directions, i), glm::vec3(Uniform * glm::vec4(P[i], 0.0f))) ? 0 : 1;
+		Error += equal3(glm::lane(PerLanePositions, i), glm::vec3(PerLane[i] * glm::vec4(P[i], 1.0f))) ? 0 : 1;
+		Error += equal4(glm::lane(Products, i), Uniform * glm::vec4(P[i], 1.0f)) ? 0 : 1;
+		Error += equal4(glm::lane(PerLaneProducts, i), PerLane[i] * glm::vec4(P[i], 1.0f)) ? 0 : 1;
+
+		glm::mat4 const Expected = PerLane[i] * 0.25f + Uniform * 0.75f;
+		glm::mat4 const Lane = glm::lane(Blended, i);
+		for(int c = 0; c < 4; ++c)
+			Error += equal4(Lane[c], Expected[c]) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<int N>
+int test_quat()
+{
+	int Error(0);
+
+	std::vector<glm::quat> Q(N), R(N);
+	for(int i = 0; i < N; ++i)
+	{
+		Q[i] = randomQuat();
+		R[i] = randomQuat() * 3.0f;
+	}
+	std::vector<glm::vec3> const V = randomVectors(N);
+
+	glm::quat_wide<N> WideQ, WideR;
+	glm::vec3_wide<N> WideV;
+	glm::load(WideQ, &Q[0]);
+	glm::load(WideR, &R[0]);
+	glm::load(WideV, &V[0]);
+
+	glm::vec3_wide<N> const Rotated = WideQ * WideV;
+	glm::quat_wide<N> const Product = WideQ * WideR;
+	glm::quat_wide<N> const Normalized = glm::normalize(WideR);
+
+	for(int i = 0; i < N; ++i)
+	{
+		Error += equal3(glm::lane(Rotated, i), Q[i] * V[i]) ? 0 : 1;
+
+		glm::quat const ExpectedProduct = Q[i] * R[i];
+		glm::quat const LaneProduct = glm::lane(Product, i);
+		Error += equal4(glm::vec4(LaneProduct.x, LaneProduct.y, LaneProduct.z, LaneProduct.w),
+			glm::vec4(ExpectedProduct.x, ExpectedProduct.y, ExpectedProduct.z, ExpectedProduct.w)) ? 0 : 1;
+
+		glm::quat const ExpectedNormalized = glm::normalize(R[i]);
+		glm::quat const LaneNormalized = glm::lane(Normalized, i);
+		Error += equal4(glm::vec4(LaneNormalized.x, LaneNormalized.y, LaneNormalized.z, LaneNormalized.w),
+			glm::vec4(ExpectedNormalized.x, ExpectedNormalized.y, ExpectedNormalized.z, ExpectedNormalized.w)) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<int N>
+int test_common()
+{
+	int Error(0);
+
+	// halves and integers around zero and past 2^23, where floor must not round
+	float const Special[] = {-2.5f, -2.0f, -1.5f, -0.5f, -0.0f, 0.0f, 0.5f, 1.0f, 1.5f, 8388609.0f, -8388609.0f, 1e9f, -1e9f};
+	int const SpecialCount = sizeof(Special) / sizeof(Special[0]);
+
+	float A[N], B[N];
+	for(int Pass = 0; Pass < 4; ++Pass)
+	{
+		for(int i = 0; i < N; ++i)
+		{
+			int const k = Pass * N + i;
+			A[i] = k < SpecialCount ? Special[k] : glm::linearRand(-100.0f, 100.0f);
+			B[i] = i % 3 == 0 ? A[i] : glm::linearRand(-100.0f, 100.0f);
+		}
+		glm::float_wide<N> const WideA = glm::float_wide<N>::load(A);
+		glm::float_wide<N> const WideB = glm::float_wide<N>::load(B);
+
+		glm::float_wide<N> const Floor = glm::floor(WideA);
+		glm::float_wide<N> const Fract = glm::fract(WideA);
+		glm::float_wide<N> const Abs = glm::abs(WideA);
+		glm::float_wide<N> const Step = glm::step(WideB, WideA);
+		glm::float_wide<N> const Min = glm::min(WideA, WideB);
+		glm::float_wide<N> const Max = glm::max(WideA, WideB);
+
+		for(int i = 0; i < N; ++i)
+		{
+			Error += glm::lane(Floor, i) == glm::floor(A[i]) ? 0 : 1;
+			Error += glm::lane(Fract, i) == glm::fract(A[i]) ? 0 : 1;
+			Error += glm::lane(Abs, i) == glm::abs(A[i]) ? 0 : 1;
+			Error += glm::lane(Step, i) == (A[i] < B[i] ? 0.0f : 1.0f) ? 0 : 1;
+			Error += glm::lane(Min, i) == glm::min(A[i], B[i]) ? 0 : 1;
+			Error += glm::lane(Max, i) == glm::max(A[i], B[i]) ? 0 : 1;
+		}
+	}
+
+	return Error;
+}
+
+template<int N>
+int test_width()
+{
+	int Error(0);
+
+	Error += test_load_store<N>();
+	Error += test_common<N>();
+	Error += test_gather_scatter<N>();
+	Error += test_geometric<N>();
+	Error += test_transform<N>();
+	Error += test_quat<N>();
+
+	return Error;
+}
+
+int main()
+{
+	int Error(0);
+
+	// 4, 8 and 16 use SIMD registers when the target has them, 3 and 5 never do
+	Error += test_width<3>();
+	Error += test_width<4>();
+	Error += test_width<5>();
+	Error += test_width<8>();
+	Error += test_width<16>();
+
+	return Error;
+}
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/perf/perf_bulk_packing.cpp
+/// @date 2026-10-19 / 2026-10-19
+///
+/// Throughput of the gtx_bulk_packing array functions against a loop over the
+/// gtc_packing function of each element, in gigabytes of source and destination per
+/// second, and checks that both give the same bits.
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/bulk_packing.hpp>
+#include <glm/gtc/packing.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	std::size_t const Count = 1 << 22;
+	int const Passes = 5;
+
+	typedef std::chrono::high_resolution_clock clock_type;
+
+	double gigabytesPerSecond(clock_type::time_point Start, std::size_t ElementSize)
+	{
+		double const Seconds = std::chrono::duration<double>(clock_type::now() - Start).count();
+		return double(Passes) * double(Count) * double(ElementSize) / Seconds * 1e-9;
+	}
+
+	template<typename dst, typename src, typename scalar, typename bulk>
+	int run(char const* Name, std::vector<src> const& Src, scalar Scalar, bulk Bulk)
+	{
+		std::vector<dst> Loop(Src.size()), Array(Src.size());
+
+		clock_type::time_point Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			for(std::size_t i = 0; i < Src.size(); ++i)
+				Loop[i] = Scalar(Src[i]);
+		double const LoopRate = gigabytesPerSecond(Start, sizeof(dst) + sizeof(src));
+
+		Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			Bulk(&Array[0], &Src[0], Src.size());
+		double const ArrayRate = gigabytesPerSecond(Start, sizeof(dst) + sizeof(src));
+
+		bool const Same = std::memcmp(&Loop[0], &Array[0], Loop.size() * sizeof(dst)) == 0;
+		std::printf("%-18s %10.2f %10.2f %8.1fx%s\n", Name, LoopRate, ArrayRate, ArrayRate / LoopRate, Same ? "" : "  differs");
+		return Same ? 0 : 1;
+	}
+
+	glm::uint16 packHalf1x16(float v) {return glm::packHalf1x16(v);}
+	float unpackHalf1x16(glm::uint16 v) {return glm::unpackHalf1x16(v);}
+	glm::uint8 packUnorm1x8(float v) {return glm::packUnorm1x8(v);}
+	float unpackUnorm1x8(glm::uint8 v) {return glm::unpackUnorm1x8(v);}
+	glm::uint16 packUnorm1x16(float v) {return glm::packUnorm1x16(v);}
+	float unpackUnorm1x16(glm::uint16 v) {return glm::unpackUnorm1x16(v);}
+	glm::int8 packSnorm1x8(float v) {return static_cast<glm::int8>(glm::packSnorm1x8(v));}
+	float unpackSnorm1x8(glm::int8 v) {return glm::unpackSnorm1x8(static_cast<glm::uint8>(v));}
+	glm::int16 packSnorm1x16(float v) {return static_cast<glm::int16>(glm::packSnorm1x16(v));}
+	float unpackSnorm1x16(glm::int16 v) {return glm::unpackSnorm1x16(static_cast<glm::uint16>(v));}
+	glm::uint32 packF2x11_1x10(glm::vec3 const& v) {return glm::packF2x11_1x10(v);}
+	glm::vec3 unpackF2x11_1x10(glm::uint32 v) {return glm::unpackF2x11_1x10(v);}
+
+	void packHalf(glm::uint16* Dst, float const* Src, std::size_t n) {glm::packHalf(Dst, Src, n);}
+	void unpackHalf(float* Dst, glm::uint16 const* Src, std::size_t n) {glm::unpackHalf(Dst, Src, n);}
+	void packUnorm8(glm::uint8* Dst, float const* Src, std::size_t n) {glm::packUnorm(Dst, Src, n);}
+	void unpackUnorm8(float* Dst, glm::uint8 const* Src, std::size_t n) {glm::unpackUnorm(Dst, Src, n);}
+	void packUnorm16(glm::uint16* Dst, float const* Src, std::size_t n) {glm::packUnorm(Dst, Src, n);}
+	void unpackUnorm16(float* Dst, glm::uint16 const* Src, std::size_t n) {glm::unpackUnorm(Dst, Src, n);}
+	void packSnorm8(glm::int8* Dst, float const* Src, std::size_t n) {glm::packSnorm(Dst, Src, n);}
+	void unpackSnorm8(float* Dst, glm::int8 const* Src, std::size_t n) {glm::unpackSnorm(Dst, Src, n);}
+	void packSnorm16(glm::int16* Dst, float const* Src, std::size_t n) {glm::packSnorm(Dst, Src, n);}
+	void unpackSnorm16(float* Dst, glm::int16 const* Src, std::size_t n) {glm::unpackSnorm(Dst, Src, n);}
+	void packF2x11(glm::uint32* Dst, glm::vec3 const* Src, std::size_t n) {glm::packF2x11_1x10(Dst, Src, n);}
+	void unpackF2x11(glm::vec3* Dst, glm::uint32 const* Src, std::size_t n) {glm::unpackF2x11_1x10(Dst, Src, n);}
+}//namespace
+
+int main()
+{
+	int Error(0);
+
+	std::vector<float> Floats(Count);
+	std::vector<glm::vec3> Colors(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		Floats[i] = glm::sin(static_cast<float>(i) * 0.001f) * 1.5f;
+		Colors[i] = glm::vec3(Floats[i], Floats[i] * 2.0f, static_cast<float>(i % 1024) / 256.0f);
+	}
+
+	std::vector<glm::uint16> Halves(Count), Words(Count);
+	std::vector<glm::uint8> Bytes(Count);
+	std::vector<glm::int8> SignedBytes(Count);
+	std::vector<glm::int16> SignedWords(Count);
+	std::vector<glm::uint32> Packed(Count);
+	glm::packHalf(&Halves[0], &Floats[0], Count);
+	glm::packUnorm(&Words[0], &Floats[0], Count);
+	glm::packUnorm(&Bytes[0], &Floats[0], Count);
+	glm::packSnorm(&SignedBytes[0], &Floats[0], Count);
+	glm::packSnorm(&SignedWords[0], &Floats[0], Count);
+	glm::packF2x11_1x10(&Packed[0], &Colors[0], Count);
+
+	std::printf("%u elements, GB/s of source and destination\n", static_cast<unsigned>(Count));
+	std::printf("%-18s %10s %10s\n", "", "loop", "array");
+	Error += run<glm::uint16>("packHalf", Floats, packHalf1x16, packHalf);
+	Error += run<float>("unpackHalf", Halves, unpackHalf1x16, unpackHalf);
+	Error += run<glm::uint8>("packUnorm 8", Floats, packUnorm1x8, packUnorm8);
+	Error += run<float>("unpackUnorm 8", Bytes, unpackUnorm1x8, unpackUnorm8);
+	Error += run<glm::uint16>("packUnorm 16", Floats, packUnorm1x16, packUnorm16);
+	Error += run<float>("unpackUnorm 16", Words, unpackUnorm1x16, unpackUnorm16);
+	Error += run<glm::int8>("packSnorm 8", Floats, packSnorm1x8, packSnorm8);
+	Error += run<float>("unpackSnorm 8", SignedBytes, unpackSnorm1x8, unpackSnorm8);
+	Error += run<glm::int16>("packSnorm 16", Floats, packSnorm1x16, packSnorm16);
+	Error += run<float>("unpackSnorm 16", SignedWords, unpackSnorm1x16, unpackSnorm16);
+	Error += run<glm::uint32>("packF2x11_1x10", Colors, packF2x11_1x10, packF2x11);
+	Error += run<glm::vec3>("unpackF2x11_1x10", Packed, unpackF2x11_1x10, unpackF2x11);
+
+	return Error;
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/perf/perf_wide_noise.cpp
+/// @date 2026-10-19 / 2026-10-19
+///
+/// Samples per second of a 3D fBm grid, one fractalNoise call per sample against
+/// noiseGrid on one thread and on every hardware thread, and checks that all three
+/// give the same samples.
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/wide_noise.hpp>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	glm::ivec3 const Size(64, 64, 16);
+	glm::vec3 const Origin(-8.0f, 3.0f, 0.5f);
+	glm::vec3 const Step(0.05f, 0.05f, 0.1f);
+	int const Passes = 3;
+
+	typedef std::chrono::high_resolution_clock clock_type;
+
+	double samplesPerSecond(clock_type::time_point Start)
+	{
+		double const Seconds = std::chrono::duration<double>(clock_type::now() - Start).count();
+		return double(Passes) * Size.x * Size.y * Size.z / Seconds;
+	}
+
+	void gridScalar(std::vector<float>& Dst, glm::noise_params const& Params)
+	{
+		for(int k = 0; k < Size.z; ++k)
+		for(int j = 0; j < Size.y; ++j)
+		for(int i = 0; i < Size.x; ++i)
+			Dst[(k * Size.y + j) * Size.x + i] = glm::fractalNoise(Origin + glm::vec3(i, j, k) * Step, Params);
+	}
+
+	// fraction of the samples more than 1e-3 apart, only non zero with fused multiply-adds
+	double mismatch(std::vector<float> const& a, std::vector<float> const& b)
+	{
+		std::size_t Count = 0;
+		for(std::size_t i = 0; i < a.size(); ++i)
+			Count += glm::abs(a[i] - b[i]) > 1e-3f ? 1 : 0;
+		return double(Count) / double(a.size());
+	}
+
+	int run(char const* Name, glm::noise_basis Basis)
+	{
+		int Error(0);
+
+		glm::noise_params Params;
+		Params.Basis = Basis;
+		Params.Fractal = glm::noise_fbm;
+		Params.Octaves = 4;
+
+		std::vector<float> Scalar(Size.x * Size.y * Size.z), Batch(Scalar.size()), Threaded(Scalar.size());
+
+		clock_type::time_point Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			gridScalar(Scalar, Params);
+		double const ScalarRate = samplesPerSecond(Start);
+
+		Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			glm::noiseGrid(&Batch[0], Size, Origin, Step, Params);
+		double const BatchRate = samplesPerSecond(Start);
+
+		Params.Threads = 0;
+		Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			glm::noiseGrid(&Threaded[0], Size, Origin, Step, Params);
+		double const ThreadedRate = samplesPerSecond(Start);
+
+		double const Mismatch = glm::max(mismatch(Batch, Scalar), mismatch(Threaded, Scalar));
+		if(Mismatch > 0.1)
+		{
+			std::printf("%s noiseGrid differs from fractalNoise\n", Name);
+			++Error;
+		}
+
+		std::printf("%-10s %16.2f %16.2f %16.2f %15.2f%%\n", Name, ScalarRate * 1e-6, BatchRate * 1e-6, ThreadedRate * 1e-6, Mismatch * 100.0);
+		return Error;
+	}
+}//namespace
+
+int main()
+{
+	int Error(0);
+
+	std::printf("4 octave fBm, %d lanes, million samples per second\n", GLM_WIDE_NOISE_WIDTH);
+	std::printf("%-10s %16s %16s %16s %16s\n", "", "fractalNoise", "noiseGrid", "threaded", "mismatch");
+	Error += run("perlin", glm::noise_perlin);
+	Error += run("simplex", glm::noise_simplex);
+
+	return Error;
+}
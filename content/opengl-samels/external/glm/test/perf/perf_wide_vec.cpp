@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////////
+/// OpenGL Mathematics (glm.g-truc.net)
+///
+/// Copyright (c) 2005 - 2015 G-Truc Creation (www.g-truc.net)
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// Restrictions:
+///		By making use of the Software for military purposes, you choose to make
+///		a Bunny unhappy.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+///
+/// @file test/perf/perf_wide_vec.cpp
+/// @date 2026-10-19 / 2026-10-19
+///
+/// Times a particle update and a four bone skinning loop written with vec3 and
+/// mat4 against the same loops written with GLM_GTX_wide_vec, and checks that
+/// both give the same positions.
+///////////////////////////////////////////////////////////////////////////////////
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/wide_vec.hpp>
+#include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/random.hpp>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	int const ParticleCount = 1 << 18;
+	int const VertexCount = 1 << 16;
+	int const BoneCount = 64;
+	int const Passes = 20;
+	float const DeltaTime = 1.0f / 60.0f;
+
+	typedef std::chrono::high_resolution_clock clock_type;
+
+	double elapsedNs(clock_type::time_point Start, int Elements)
+	{
+		return std::chrono::duration<double, std::nano>(clock_type::now() - Start).count() / (double(Passes) * Elements);
+	}
+
+	bool equalArrays(std::vector<glm::vec3> const& a, std::vector<glm::vec3> const& b)
+	{
+		for(std::size_t i = 0; i < a.size(); ++i)
+			if(!glm::all(glm::epsilonEqual(a[i], b[i], 1e-3f)))
+				return false;
+		return true;
+	}
+
+	// Particles: gravity, drag, and no falling through the ground plane
+
+	struct particles_aos
+	{
+		std::vector<glm::vec3> Position;
+		std::vector<glm::vec3> Velocity;
+	};
+
+	struct particles_soa
+	{
+		std::vector<float> X, Y, Z;
+		std::vector<float> VX, VY, VZ;
+	};
+
+	void updateScalar(particles_aos& Particles)
+	{
+		glm::vec3 const Gravity(0.0f, -9.81f, 0.0f);
+		for(int i = 0; i < ParticleCount; ++i)
+		{
+			glm::vec3 Velocity = (Particles.Velocity[i] + Gravity * DeltaTime) * 0.999f;
+			glm::vec3 Position = Particles.Position[i] + Velocity * DeltaTime;
+			Position.y = glm::max(Position.y, 0.0f);
+			Particles.Position[i] = Position;
+			Particles.Velocity[i] = Velocity;
+		}
+	}
+
+	template<int N>
+	void updateWide(particles_soa& Particles)
+	{
+		glm::vec3_wide<N> const Gravity(glm::vec3(0.0f, -9.81f, 0.0f));
+		glm::float_wide<N> const Zero(0.0f);
+		for(int i = 0; i < ParticleCount; i += N)
+		{
+			glm::vec3_wide<N> Position, Velocity;
+			glm::load(Position, &Particles.X[i], &Particles.Y[i], &Particles.Z[i]);
+			glm::load(Velocity, &Particles.VX[i], &Particles.VY[i], &Particles.VZ[i]);
+
+			Velocity = (Velocity + Gravity * DeltaTime) * 0.999f;
+			Position = Position + Velocity * DeltaTime;
+			Position.y = glm::max(Position.y, Zero);
+
+			glm::store(&Particles.X[i], &Particles.Y[i], &Particles.Z[i], Position);
+			glm::store(&Particles.VX[i], &Particles.VY[i], &Particles.VZ[i], Velocity);
+		}
+	}
+
+	// Skinning: four weighted bones per vertex, position and normal
+
+	struct skinned_mesh
+	{
+		std::vector<glm::vec3> Position;
+		std::vector<glm::vec3> Normal;
+		std::vector<int> Bones;		// four per vertex
+		std::vector<float> Weights;	// four per vertex
+		std::vector<glm::mat4> Palette;
+	};
+
+	void skinScalar(skinned_mesh const& Mesh, std::vector<glm::vec3>& Positions, std::vector<glm::vec3>& Normals)
+	{
+		for(int i = 0; i < VertexCount; ++i)
+		{
+			int const* Bones = &Mesh.Bones[i * 4];
+			float const* Weights = &Mesh.Weights[i * 4];
+			glm::mat4 const Skin =
+				Mesh.Palette[Bones[0]] * Weights[0] + Mesh.Palette[Bones[1]] * Weights[1] +
+				Mesh.Palette[Bones[2]] * Weights[2] + Mesh.Palette[Bones[3]] * Weights[3];
+			Positions[i] = glm::vec3(Skin * glm::vec4(Mesh.Position[i], 1.0f));
+			Normals[i] = glm::normalize(glm::vec3(Skin * glm::vec4(Mesh.Normal[i], 0.0f)));
+		}
+	}
+
+	template<int N>
+	void skinWide(skinned_mesh const& Mesh, std::vector<glm::vec3>& Positions, std::vector<glm::vec3>& Normals)
+	{
+		for(int i = 0; i < VertexCount; i += N)
+		{
+			glm::mat4_wide<N> Skin;
+			for(int Influence = 0; Influence < 4; ++Influence)
+			{
+				int Bones[N];
+				float Weights[N];
+				for(int Lane = 0; Lane < N; ++Lane)
+				{
+					Bones[Lane] = Mesh.Bones[(i + Lane) * 4 + Influence];
+					Weights[Lane] = Mesh.Weights[(i + Lane) * 4 + Influence];
+				}
+				glm::mat4_wide<N> Bone;
+				glm::gather(Bone, &Mesh.Palette[0], Bones);
+				glm::mat4_wide<N> const Weighted = Bone * glm::float_wide<N>::load(Weights);
+				Skin = Influence == 0 ? Weighted : Skin + Weighted;
+			}
+
+			glm::vec3_wide<N> Position, Normal;
+			glm::load(Position, &Mesh.Position[i]);
+			glm::load(Normal, &Mesh.Normal[i]);
+			glm::store(&Positions[i], glm::transformPosition(Skin, Position));
+			glm::store(&Normals[i], glm::normalize(glm::transformDirection(Skin, Normal)));
+		}
+	}
+
+	template<int N>
+	int run(char const* Name, particles_soa const& InitialSoa, skinned_mesh const& Mesh,
+		std::vector<glm::vec3> const& ScalarPositions, std::vector<glm::vec3> const& ScalarSkinned)
+	{
+		int Error(0);
+
+		particles_soa Particles(InitialSoa);
+		clock_type::time_point Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			updateWide<N>(Particles);
+		double const ParticleNs = elapsedNs(Start, ParticleCount);
+
+		std::vector<glm::vec3> Positions(ParticleCount);
+		for(int i = 0; i < ParticleCount; ++i)
+			Positions[i] = glm::vec3(Particles.X[i], Particles.Y[i], Particles.Z[i]);
+		if(!equalArrays(Positions, ScalarPositions))
+		{
+			std::printf("%s particles differ from vec3\n", Name);
+			++Error;
+		}
+
+		std::vector<glm::vec3> Skinned(VertexCount), Normals(VertexCount);
+		Start = clock_type::now();
+		for(int Pass = 0; Pass < Passes; ++Pass)
+			skinWide<N>(Mesh, Skinned, Normals);
+		double const SkinningNs = elapsedNs(Start, VertexCount);
+		if(!equalArrays(Skinned, ScalarSkinned))
+		{
+			std::printf("%s skinning differs from mat4\n", Name);
+			++Error;
+		}
+
+		std::printf("%-10s %16.3f %16.3f\n", Name, ParticleNs, SkinningNs);
+		return Error;
+	}
+}//namespace
+
+int main()
+{
+	int Error(0);
+
+	particles_aos Aos;
+	particles_soa Soa;
+	for(int i = 0; i < ParticleCount; ++i)
+	{
+		glm::vec3 const Position = glm::vec3(0.0f, 5.0f, 0.0f) + glm::ballRand(5.0f);
+		glm::vec3 const Velocity = glm::ballRand(3.0f);
+		Aos.Position.push_back(Position);
+		Aos.Velocity.push_back(Velocity);
+		Soa.X.push_back(Position.x); Soa.Y.push_back(Position.y); Soa.Z.push_back(Position.z);
+		Soa.VX.push_back(Velocity.x); Soa.VY.push_back(Velocity.y); Soa.VZ.push_back(Velocity.z);
+	}
+
+	skinned_mesh Mesh;
+	for(int i = 0; i < BoneCount; ++i)
+		Mesh.Palette.push_back(glm::translate(glm::mat4(1.0f), glm::ballRand(2.0f)) *
+			glm::mat4_cast(glm::angleAxis(glm::linearRand(-3.0f, 3.0f), glm::sphericalRand(1.0f))));
+	for(int i = 0; i < VertexCount; ++i)
+	{
+		Mesh.Position.push_back(glm::ballRand(1.0f));
+		Mesh.Normal.push_back(glm::sphericalRand(1.0f));
+		glm::vec4 const Weights = glm::linearRand(glm::vec4(0.1f), glm::vec4(1.0f));
+		float const Sum = Weights.x + Weights.y + Weights.z + Weights.w;
+		for(int j = 0; j < 4; ++j)
+		{
+			Mesh.Bones.push_back(glm::linearRand(0, BoneCount - 1));
+			Mesh.Weights.push_back(Weights[j] / Sum);
+		}
+	}
+
+	std::printf("%-10s %16s %16s\n", "", "particles", "skinning");
+	std::printf("%-10s %16s %16s\n", "", "ns/particle", "ns/vertex");
+
+	particles_aos Scalar(Aos);
+	clock_type::time_point Start = clock_type::now();
+	for(int Pass = 0; Pass < Passes; ++Pass)
+		updateScalar(Scalar);
+	double const ParticleNs = elapsedNs(Start, ParticleCount);
+
+	std::vector<glm::vec3> Skinned(VertexCount), Normals(VertexCount);
+	Start = clock_type::now();
+	for(int Pass = 0; Pass < Passes; ++Pass)
+		skinScalar(Mesh, Skinned, Normals);
+	double const SkinningNs = elapsedNs(Start, VertexCount);
+	std::printf("%-10s %16.3f %16.3f\n", "vec3", ParticleNs, SkinningNs);
+
+	Error += run<4>("floatx4", Soa, Mesh, Scalar.Position, Skinned);
+	Error += run<8>("floatx8", Soa, Mesh, Scalar.Position, Skinned);
+	Error += run<16>("floatx16", Soa, Mesh, Scalar.Position, Skinned);
+
+	return Error;
+}
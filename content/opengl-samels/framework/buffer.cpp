@@ -1,6 +1,7 @@
 #include "buffer.hpp"
 #include <memory>
 #include <cassert>
+#include <chrono>
 
 namespace
 {
@@ -69,6 +70,175 @@ namespace gl
 	{
 		return map_ptr(this->Name, Offset, Length, Flags);
 	}
+
+	fence_backend::handle sync_fence_backend::insert()
+	{
+		return reinterpret_cast<handle>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+
+	bool sync_fence_backend::wait(handle Fence, std::uint64_t Timeout)
+	{
+		// GL_WAIT_FAILED is reported by checkError, don't spin on it
+		return glClientWaitSync(reinterpret_cast<GLsync>(Fence), GL_SYNC_FLUSH_COMMANDS_BIT, Timeout) != GL_TIMEOUT_EXPIRED;
+	}
+
+	void sync_fence_backend::release(handle Fence)
+	{
+		glDeleteSync(reinterpret_cast<GLsync>(Fence));
+	}
+
+	ring_allocator::ring_allocator(std::size_t RegionSize, std::size_t RegionCount, fence_backend & Fences) :
+		Fences(Fences),
+		RegionSize(RegionSize),
+		Regions(RegionCount, 0),
+		Region(0),
+		Head(0),
+		Acquired(false),
+		Stats()
+	{
+		assert(RegionCount > 0);
+	}
+
+	ring_allocator::~ring_allocator()
+	{
+		for(std::size_t i = 0; i < this->Regions.size(); ++i)
+			if(this->Regions[i])
+				this->Fences.release(this->Regions[i]);
+	}
+
+	std::size_t ring_allocator::allocate(std::size_t Size, std::size_t Alignment)
+	{
+		assert(Alignment > 0);
+
+		if(!this->Acquired)
+			this->acquire();
+
+		// Align the offset in the buffer, binding offsets are checked against it
+		std::size_t const Base = this->region_offset();
+		std::size_t const Offset = (Base + this->Head + Alignment - 1) / Alignment * Alignment;
+		if(Offset + Size > Base + this->RegionSize)
+			return npos;
+
+		this->Head = Offset + Size - Base;
+		++this->Stats.Allocations;
+		this->Stats.Bytes += Size;
+		return Offset;
+	}
+
+	void ring_allocator::end_frame()
+	{
+		if(this->Acquired)
+		{
+			this->Regions[this->Region] = this->Fences.insert();
+			this->Region = (this->Region + 1) % this->Regions.size();
+		}
+
+		this->Head = 0;
+		this->Acquired = false;
+		++this->Stats.Frames;
+	}
+
+	void ring_allocator::acquire()
+	{
+		fence_backend::handle const Fence = this->Regions[this->Region];
+		if(Fence)
+		{
+			if(!this->Fences.wait(Fence, 0))
+			{
+				std::chrono::high_resolution_clock::time_point const Start = std::chrono::high_resolution_clock::now();
+				while(!this->Fences.wait(Fence, 1000000))
+					;
+				++this->Stats.Stalls;
+				this->Stats.StallTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+			}
+			this->Fences.release(Fence);
+			this->Regions[this->Region] = 0;
+		}
+
+		this->Acquired = true;
+	}
+
+	stream_buffer::stream_buffer(std::size_t RegionSize, std::size_t RegionCount) :
+		Allocator(RegionSize, RegionCount, Fences),
+		Name(0),
+		Persistent(GLEW_ARB_buffer_storage == GL_TRUE),
+		Mapped(nullptr),
+		MappedOffset(0)
+	{
+		GLsizeiptr const Size = static_cast<GLsizeiptr>(this->Allocator.size());
+
+		glGenBuffers(1, &this->Name);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, this->Name);
+		if(this->Persistent)
+		{
+			GLbitfield const Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, Size, nullptr, Flags);
+			this->Mapped = static_cast<std::uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, Size, Flags));
+		}
+		else
+			glBufferData(GL_COPY_WRITE_BUFFER, Size, nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	stream_buffer::~stream_buffer()
+	{
+		if(this->Mapped)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->Name);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		glDeleteBuffers(1, &this->Name);
+		this->Name = 0;
+	}
+
+	stream_buffer::allocation stream_buffer::allocate(std::size_t Size, std::size_t Alignment)
+	{
+		allocation Allocation = {nullptr, 0, Size};
+
+		std::size_t const Offset = this->Allocator.allocate(Size, Alignment);
+		if(Offset == ring_allocator::npos)
+			return Allocation;
+
+		if(!this->Mapped)
+		{
+			// The fence of the region already waited for the GPU, map the rest of it unsynchronized
+			std::size_t const End = this->Allocator.region_offset() + this->Allocator.region_size();
+			this->MappedOffset = Offset;
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->Name);
+			this->Mapped = static_cast<std::uint8_t*>(glMapBufferRange(
+				GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(Offset), static_cast<GLsizeiptr>(End - Offset),
+				GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		Allocation.Pointer = this->Mapped + (Offset - this->MappedOffset);
+		Allocation.Offset = Offset;
+		return Allocation;
+	}
+
+	void stream_buffer::flush()
+	{
+		// Coherent persistent writes are visible to the commands issued after them
+		if(this->Persistent || !this->Mapped)
+			return;
+
+		std::size_t const End = this->Allocator.region_offset() + this->Allocator.region_used();
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, this->Name);
+		glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(End - this->MappedOffset));
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		this->Mapped = nullptr;
+	}
+
+	void stream_buffer::end_frame()
+	{
+		this->flush();
+		this->Allocator.end_frame();
+	}
 /*
 	buffer::buffer(std::uint32_t Flags, std::size_t Size) :
 		buffer(Flags, Size, nullptr)
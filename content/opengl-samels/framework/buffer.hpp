@@ -55,6 +55,110 @@ namespace gl
 		name_t Name;
 	};
 
+	// Fences guarding the regions of a ring_allocator, GL sync objects in stream_buffer
+	class fence_backend
+	{
+	public:
+		typedef std::uintptr_t handle;
+
+		virtual ~fence_backend() {}
+
+		// Fence after the commands submitted so far
+		virtual handle insert() = 0;
+		// Returns true once the fence is signaled, waiting at most Timeout nanoseconds
+		virtual bool wait(handle Fence, std::uint64_t Timeout) = 0;
+		virtual void release(handle Fence) = 0;
+	};
+
+	class sync_fence_backend : public fence_backend
+	{
+	public:
+		handle insert();
+		bool wait(handle Fence, std::uint64_t Timeout);
+		void release(handle Fence);
+	};
+
+	// Sub-allocates RegionCount regions of RegionSize bytes, one region per frame. A region
+	// is fenced at the end of its frame and waited for when the ring comes back to it.
+	class ring_allocator : noncopyable
+	{
+	public:
+		static std::size_t const npos = static_cast<std::size_t>(-1);
+
+		struct statistics
+		{
+			std::size_t Frames;
+			std::size_t Allocations;
+			std::size_t Bytes;
+			// Frames that waited for the GPU to release their region
+			std::size_t Stalls;
+			double StallTime;	// milliseconds
+		};
+
+		ring_allocator(std::size_t RegionSize, std::size_t RegionCount, fence_backend & Fences);
+		~ring_allocator();
+
+		// Offset in the ring of Size bytes aligned to Alignment, npos if the frame region is full
+		std::size_t allocate(std::size_t Size, std::size_t Alignment);
+		// Fences the region of the frame and moves to the next one
+		void end_frame();
+
+		std::size_t size() const {return this->RegionSize * this->Regions.size();}
+		std::size_t region_size() const {return this->RegionSize;}
+		// Offset of the region of the current frame and the bytes allocated in it
+		std::size_t region_offset() const {return this->Region * this->RegionSize;}
+		std::size_t region_used() const {return this->Head;}
+		bool acquired() const {return this->Acquired;}
+		statistics const & stats() const {return this->Stats;}
+
+	private:
+		void acquire();
+
+		fence_backend & Fences;
+		std::size_t const RegionSize;
+		std::vector<fence_backend::handle> Regions;
+		std::size_t Region;
+		std::size_t Head;
+		bool Acquired;
+		statistics Stats;
+	};
+
+	// Streaming buffer for per frame uniform, vertex and pixel unpack data, triple buffered
+	// by default. With ARB_buffer_storage it stays mapped persistent and coherent, otherwise
+	// the frame region is mapped unsynchronized and unmapped by flush.
+	class stream_buffer : noncopyable
+	{
+	public:
+		struct allocation
+		{
+			void* Pointer;
+			std::size_t Offset;
+			std::size_t Size;
+		};
+
+		explicit stream_buffer(std::size_t RegionSize, std::size_t RegionCount = 3);
+		~stream_buffer();
+
+		// Pointer is null if the frame region is full
+		allocation allocate(std::size_t Size, std::size_t Alignment);
+		// Makes the writes visible to the GL, before the commands reading them
+		void flush();
+		// After the last command reading this frame allocations
+		void end_frame();
+
+		name_t name() const {return this->Name;}
+		bool persistent() const {return this->Persistent;}
+		ring_allocator::statistics const & stats() const {return this->Allocator.stats();}
+
+	private:
+		sync_fence_backend Fences;
+		ring_allocator Allocator;
+		name_t Name;
+		bool const Persistent;
+		std::uint8_t* Mapped;
+		std::size_t MappedOffset;
+	};
+
 /*
 	class buffer : public noncopyable
 	{
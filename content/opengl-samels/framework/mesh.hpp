@@ -2,8 +2,13 @@
 
 #include <vector>
 #include <glm/vec3.hpp>
+#include <glm/fwd.hpp>
 
 namespace glf
 {
+	// Unit icosphere, 20 * 4^Subdivision triangles of three vertices each
 	void generate_icosahedron(std::vector<glm::vec3>& VertexData, int Subdivision);
+
+	// Unit icosphere, each vertex shared by the triangles around it
+	void generate_icosahedron(std::vector<glm::vec3>& VertexData, std::vector<glm::uint32>& ElementData, int Subdivision);
 }//namespace glf
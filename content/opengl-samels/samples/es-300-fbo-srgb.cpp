@@ -12,6 +12,7 @@ namespace
 		enum type
 		{
 			VERTEX,
+			ELEMENT,
 			TRANSFORM,
 			MAX
 		};
@@ -69,7 +70,7 @@ private:
 	GLint UniformTransform;
 	GLuint FramebufferName;
 	glm::uint FramebufferScale;
-	GLuint VertexCount;
+	GLsizei ElementCount;
 
 	bool initProgram()
 	{
@@ -126,8 +127,9 @@ private:
 	bool initBuffer()
 	{
 		std::vector<glm::vec3> VertexData;
-		glf::generate_icosahedron(VertexData, 4);
-		this->VertexCount = static_cast<GLuint>(VertexData.size());
+		std::vector<glm::uint32> ElementData;
+		glf::generate_icosahedron(VertexData, ElementData, 4);
+		this->ElementCount = static_cast<GLsizei>(ElementData.size());
 
 		glGenBuffers(buffer::MAX, &BufferName[0]);
 
@@ -135,6 +137,10 @@ private:
 		glBufferData(GL_ARRAY_BUFFER, VertexData.size() * sizeof(glm::vec3), &VertexData[0], GL_STATIC_DRAW);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferName[buffer::ELEMENT]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, ElementData.size() * sizeof(glm::uint32), &ElementData[0], GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
 		GLint UniformBufferOffset(0);
 		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformBufferOffset);
 		GLint UniformBlockSize = glm::max(GLint(sizeof(glm::mat4)), UniformBufferOffset);
@@ -180,6 +186,7 @@ private:
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			glEnableVertexAttribArray(semantic::attr::POSITION);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferName[buffer::ELEMENT]);
 		glBindVertexArray(0);
 
 		glBindVertexArray(VertexArrayName[program::SPLASH]);
@@ -281,7 +288,7 @@ private:
 			glBindVertexArray(VertexArrayName[program::RENDER]);
 			glBindBufferBase(GL_UNIFORM_BUFFER, semantic::uniform::TRANSFORM0, BufferName[buffer::TRANSFORM]);
 
-			glDrawArraysInstanced(GL_TRIANGLES, 0, this->VertexCount, 1);
+			glDrawElementsInstanced(GL_TRIANGLES, this->ElementCount, GL_UNSIGNED_INT, 0, 1);
 		}
 
 		// Blit the sRGB framebuffer to the default framebuffer back buffer.
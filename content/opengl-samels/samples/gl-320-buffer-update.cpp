@@ -1,4 +1,5 @@
 #include "test.hpp"
+#include <chrono>
 
 namespace
 {
@@ -24,7 +25,6 @@ namespace
 			ARRAY,
 			COPY,
 			MATERIAL,
-			TRANSFORM,
 			MAX
 		};
 	}//namespace program
@@ -38,7 +38,10 @@ public:
 		VertexArrayName(0),
 		ProgramName(0),
 		UniformTransform(0),
-		UniformMaterial(0)
+		UniformMaterial(0),
+		UniformTransformSize(0),
+		UniformBufferAlignment(0),
+		RenderTime(0.0)
 	{}
 
 private:
@@ -47,6 +50,10 @@ private:
 	GLuint VertexArrayName;
 	GLint UniformTransform;
 	GLint UniformMaterial;
+	GLint UniformTransformSize;
+	GLint UniformBufferAlignment;
+	std::unique_ptr<gl::stream_buffer> TransformBuffer;
+	double RenderTime;
 
 	bool initProgram()
 	{
@@ -137,16 +144,17 @@ private:
 
 		GLint UniformBlockSize = 0;
 
+		// The transform changes every frame, it is written in a ring of three regions so
+		// that the CPU doesn't wait for the GPU to finish reading the previous frames.
 		{
 			glGetActiveUniformBlockiv(
 				ProgramName, 
 				UniformTransform,
 				GL_UNIFORM_BLOCK_DATA_SIZE,
-				&UniformBlockSize);
+				&UniformTransformSize);
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformBufferAlignment);
 
-			glBindBuffer(GL_UNIFORM_BUFFER, BufferName[buffer::TRANSFORM]);
-			glBufferData(GL_UNIFORM_BUFFER, UniformBlockSize, 0, GL_DYNAMIC_DRAW);
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			TransformBuffer.reset(new gl::stream_buffer(UniformTransformSize + UniformBufferAlignment));
 		}
 
 		{
@@ -196,6 +204,13 @@ private:
 
 	bool end()
 	{
+		gl::ring_allocator::statistics const& Stats = TransformBuffer->stats();
+		double const Frames = static_cast<double>(glm::max<std::size_t>(Stats.Frames, 1));
+		fprintf(stdout, "\nCPU %2.4f ms per frame, %d stalls in %d frames (%2.4f ms), %s mapping\n",
+			RenderTime / Frames, static_cast<int>(Stats.Stalls), static_cast<int>(Stats.Frames), Stats.StallTime,
+			TransformBuffer->persistent() ? "persistent" : "unsynchronized");
+		TransformBuffer.reset();
+
 		glDeleteBuffers(buffer::MAX, &BufferName[0]);
 		glDeleteProgram(ProgramName);
 		glDeleteVertexArrays(1, &VertexArrayName);
@@ -205,23 +220,23 @@ private:
 
 	bool render()
 	{
+		std::chrono::high_resolution_clock::time_point const Start = std::chrono::high_resolution_clock::now();
+
 		glm::vec2 WindowSize(this->getWindowSize());
 
-		{
-			glBindBuffer(GL_UNIFORM_BUFFER, BufferName[buffer::TRANSFORM]);
-			glm::mat4* Pointer = (glm::mat4*)glMapBufferRange(
-				GL_UNIFORM_BUFFER, 0,	sizeof(glm::mat4),
-				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		gl::stream_buffer::allocation const Transform = TransformBuffer->allocate(UniformTransformSize, UniformBufferAlignment);
+		if(!Transform.Pointer)
+			return false;
 
+		{
 			glm::mat4 Projection = glm::perspective(glm::pi<float>() * 0.25f, WindowSize.x / WindowSize.y, 0.1f, 100.0f);
 			glm::mat4 Model = glm::mat4(1.0f);
 			glm::mat4 MVP = Projection * this->view() * Model;
-		
-			*Pointer = MVP;
+
+			*static_cast<glm::mat4*>(Transform.Pointer) = MVP;
 
 			// Make sure the uniform buffer is uploaded
-			glUnmapBuffer(GL_UNIFORM_BUFFER);
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			TransformBuffer->flush();
 		}
 
 		glViewport(0, 0, static_cast<GLsizei>(WindowSize.x), static_cast<GLsizei>(WindowSize.y));
@@ -229,14 +244,19 @@ private:
 
 		glUseProgram(ProgramName);
 
-		// Attach the buffer to UBO binding point semantic::uniform::TRANSFORM0
-		glBindBufferBase(GL_UNIFORM_BUFFER, semantic::uniform::TRANSFORM0, BufferName[buffer::TRANSFORM]);
+		// Attach the frame range of the buffer to UBO binding point semantic::uniform::TRANSFORM0
+		glBindBufferRange(GL_UNIFORM_BUFFER, semantic::uniform::TRANSFORM0, TransformBuffer->name(), Transform.Offset, Transform.Size);
 		// Attach the buffer to UBO binding point semantic::uniform::MATERIAL
 		glBindBufferBase(GL_UNIFORM_BUFFER, semantic::uniform::MATERIAL, BufferName[buffer::MATERIAL]);
 
 		glBindVertexArray(VertexArrayName);
 		glDrawArraysInstanced(GL_TRIANGLES, 0, VertexCount, 1);
 
+		// Fence the region after the draw that reads it
+		TransformBuffer->end_frame();
+
+		RenderTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+
 		return true;
 	}
 };
@@ -1,10 +1,12 @@
 #include "test.hpp"
+#include <chrono>
 
 namespace
 {
 	char const* VERT_SHADER_SOURCE("gl-320/texture-2d.vert");
 	char const* FRAG_SHADER_SOURCE("gl-320/texture-2d.frag");
 	char const* TEXTURE_DIFFUSE("kueken7_rgba8_srgb.dds");
+	std::size_t const PixelAlignment(16);
 
 	struct vertex
 	{
@@ -39,7 +41,6 @@ namespace
 		enum type
 		{
 			VERTEX,
-			TRANSFORM,
 			MAX
 		};
 	}//namespace buffer
@@ -60,6 +61,14 @@ namespace
 	std::vector<GLuint> BufferName(buffer::MAX);
 	GLint UniformTransform(0);
 	GLint UniformDiffuse(0);
+	GLint UniformBufferAlignment(0);
+
+	// The texture and the transform are written each frame in a ring of three regions,
+	// the CPU only waits when the GPU is still reading the region of three frames ago.
+	gli::texture2d Texture;
+	gli::gl::format TextureFormat;
+	std::unique_ptr<gl::stream_buffer> StreamBuffer;
+	double RenderTime(0.0);
 }//namespace
 
 class sample : public framework
@@ -109,24 +118,16 @@ private:
 		glBufferData(GL_ARRAY_BUFFER, VertexSize, VertexData, GL_STATIC_DRAW);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-		GLint UniformBufferOffset(0);
-		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformBufferOffset);
-		GLint UniformBlockSize = glm::max(GLint(sizeof(glm::mat4)), UniformBufferOffset);
-
-		glBindBuffer(GL_UNIFORM_BUFFER, BufferName[buffer::TRANSFORM]);
-		glBufferData(GL_UNIFORM_BUFFER, UniformBlockSize, nullptr, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformBufferAlignment);
 
 		return true;
 	}
 
 	bool initTexture()
 	{
-		gli::texture2d Texture(gli::load_dds((getDataDirectory() + TEXTURE_DIFFUSE).c_str()));
+		Texture = gli::texture2d(gli::load_dds((getDataDirectory() + TEXTURE_DIFFUSE).c_str()));
 		gli::gl GL(gli::gl::PROFILE_GL32);
-		gli::gl::format const Format = GL.translate(Texture.format(), Texture.swizzles());
-
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		TextureFormat = GL.translate(Texture.format(), Texture.swizzles());
 
 		glGenTextures(1, &TextureName);
 		glActiveTexture(GL_TEXTURE0);
@@ -135,28 +136,14 @@ private:
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
 		glTexImage2D(GL_TEXTURE_2D, GLint(0),
-			Format.Internal,
+			TextureFormat.Internal,
 			GLsizei(Texture.extent().x), GLsizei(Texture.extent().y),
 			0,
-			Format.External, Format.Type,
+			TextureFormat.External, TextureFormat.Type,
 			nullptr);
 
-		GLsizei TextureSize = static_cast<GLsizei>(Texture[0].size());
-
-		GLuint PixelBuffer(0);
-		glGenBuffers(1, &PixelBuffer);
-		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PixelBuffer);
-		glBufferData(GL_PIXEL_UNPACK_BUFFER, TextureSize, nullptr, GL_STREAM_DRAW);
-		void* Pointer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, TextureSize, GL_MAP_WRITE_BIT);
-		memcpy(Pointer, Texture[0].data(), TextureSize);
-		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-
-		glTexSubImage2D(GL_TEXTURE_2D, 0,
-			0, 0, GLsizei(Texture.extent().x), GLsizei(Texture.extent().y),
-			Format.External, Format.Type, nullptr);
-		glDeleteBuffers(1, &PixelBuffer);
-
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		// One region holds the pixels and the transform of a frame
+		StreamBuffer.reset(new gl::stream_buffer(Texture[0].size() + PixelAlignment + sizeof(glm::mat4) + UniformBufferAlignment));
 
 		return true;
 	}
@@ -195,6 +182,13 @@ private:
 
 	bool end()
 	{
+		gl::ring_allocator::statistics const& Stats = StreamBuffer->stats();
+		double const Frames = static_cast<double>(glm::max<std::size_t>(Stats.Frames, 1));
+		fprintf(stdout, "\nCPU %2.4f ms per frame, %d stalls in %d frames (%2.4f ms), %s mapping\n",
+			RenderTime / Frames, static_cast<int>(Stats.Stalls), static_cast<int>(Stats.Frames), Stats.StallTime,
+			StreamBuffer->persistent() ? "persistent" : "unsynchronized");
+		StreamBuffer.reset();
+
 		glDeleteBuffers(buffer::MAX, &BufferName[0]);
 		glDeleteProgram(ProgramName);
 		glDeleteTextures(1, &TextureName);
@@ -205,24 +199,39 @@ private:
 
 	bool render()
 	{
+		std::chrono::high_resolution_clock::time_point const Start = std::chrono::high_resolution_clock::now();
+
 		glm::ivec2 WindowSize(this->getWindowSize());
 
+		gl::stream_buffer::allocation const Pixels = StreamBuffer->allocate(Texture[0].size(), PixelAlignment);
+		gl::stream_buffer::allocation const Transform = StreamBuffer->allocate(sizeof(glm::mat4), UniformBufferAlignment);
+		if(!Pixels.Pointer || !Transform.Pointer)
+			return false;
+
 		{
-			glBindBuffer(GL_UNIFORM_BUFFER, BufferName[buffer::TRANSFORM]);
-			glm::mat4* Pointer = (glm::mat4*)glMapBufferRange(
-				GL_UNIFORM_BUFFER, 0,	sizeof(glm::mat4),
-				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			memcpy(Pixels.Pointer, Texture[0].data(), Pixels.Size);
 
 			glm::mat4 Projection = glm::perspective(glm::pi<float>() * 0.25f, 4.0f / 3.0f, 0.1f, 100.0f);
 			glm::mat4 Model = glm::mat4(1.0f);
 			glm::mat4 MVP = Projection * this->view() * Model;
-		
-			*Pointer = MVP;
 
-			// Make sure the uniform buffer is uploaded
-			glUnmapBuffer(GL_UNIFORM_BUFFER);
+			*static_cast<glm::mat4*>(Transform.Pointer) = MVP;
+
+			// Make sure the pixels and the uniform buffer are uploaded
+			StreamBuffer->flush();
 		}
 
+		// Update the texture from the pixel range of the frame
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, StreamBuffer->name());
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, TextureName);
+		glTexSubImage2D(GL_TEXTURE_2D, 0,
+			0, 0, GLsizei(Texture.extent().x), GLsizei(Texture.extent().y),
+			TextureFormat.External, TextureFormat.Type, BUFFER_OFFSET(Pixels.Offset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
 		glViewport(0, 0, WindowSize.x, WindowSize.y);
 		glClearBufferfv(GL_COLOR, 0, &glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)[0]);
 
@@ -232,11 +241,16 @@ private:
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, TextureName);
-		glBindBufferBase(GL_UNIFORM_BUFFER, semantic::uniform::TRANSFORM0, BufferName[buffer::TRANSFORM]);
+		glBindBufferRange(GL_UNIFORM_BUFFER, semantic::uniform::TRANSFORM0, StreamBuffer->name(), Transform.Offset, Transform.Size);
 		glBindVertexArray(VertexArrayName);
 
 		glDrawArraysInstanced(GL_TRIANGLES, 0, VertexCount, 1);
 
+		// Fence the region after the commands reading it
+		StreamBuffer->end_frame();
+
+		RenderTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+
 		return true;
 	}
 };
@@ -0,0 +1,181 @@
+#include "buffer.hpp"
+#include <set>
+
+namespace
+{
+	// Fences that signal after a given number of timed out waits, no GL involved
+	class fake_fence_backend : public gl::fence_backend
+	{
+	public:
+		fake_fence_backend() :
+			Next(0),
+			Busy(0),
+			Inserted(0),
+			Waits(0),
+			Errors(0)
+		{}
+
+		handle insert()
+		{
+			++this->Inserted;
+			this->Live.insert(++this->Next);
+			return this->Next;
+		}
+
+		bool wait(handle Fence, std::uint64_t Timeout)
+		{
+			++this->Waits;
+			this->Errors += this->Live.count(Fence) ? 0 : 1;
+			if(this->Busy == 0)
+				return true;
+			--this->Busy;
+			return false;
+		}
+
+		void release(handle Fence)
+		{
+			this->Errors += this->Live.erase(Fence) ? 0 : 1;
+		}
+
+		handle Next;
+		std::set<handle> Live;
+		// Waits that time out before the fences signal
+		std::size_t Busy;
+		std::size_t Inserted;
+		std::size_t Waits;
+		// Waits on or releases of fences that are not live
+		std::size_t Errors;
+	};
+
+	std::size_t const REGION_SIZE(1024);
+	std::size_t const REGION_COUNT(3);
+}//namespace
+
+int test_alignment()
+{
+	int Error = 0;
+
+	fake_fence_backend Fences;
+	gl::ring_allocator Allocator(REGION_SIZE, REGION_COUNT, Fences);
+
+	Error += Allocator.allocate(3, 1) == 0 ? 0 : 1;
+	Error += Allocator.allocate(16, 256) == 256 ? 0 : 1;
+	Error += Allocator.allocate(4, 4) == 272 ? 0 : 1;
+	Error += Allocator.region_used() == 276 ? 0 : 1;
+	Allocator.end_frame();
+
+	// The offsets are aligned in the buffer, not in the region
+	Allocator.allocate(1, 1);
+	Allocator.end_frame();
+	Error += Allocator.region_offset() == 2 * REGION_SIZE ? 0 : 1;
+	Error += Allocator.allocate(8, 768) == 2304 ? 0 : 1;
+
+	return Error;
+}
+
+int test_oversize()
+{
+	int Error = 0;
+
+	fake_fence_backend Fences;
+	gl::ring_allocator Allocator(REGION_SIZE, REGION_COUNT, Fences);
+
+	// Never spills into the next region, a failed allocation leaves the region as it was
+	Error += Allocator.allocate(REGION_SIZE + 1, 1) == gl::ring_allocator::npos ? 0 : 1;
+	Error += Allocator.region_used() == 0 ? 0 : 1;
+	Error += Allocator.allocate(REGION_SIZE, 1) == 0 ? 0 : 1;
+	Error += Allocator.allocate(1, 1) == gl::ring_allocator::npos ? 0 : 1;
+
+	// Alignment padding counts against the region
+	Allocator.end_frame();
+	Error += Allocator.allocate(1, 1) == REGION_SIZE ? 0 : 1;
+	Error += Allocator.allocate(REGION_SIZE - 255, 256) == gl::ring_allocator::npos ? 0 : 1;
+	Error += Allocator.allocate(REGION_SIZE - 256, 256) == REGION_SIZE + 256 ? 0 : 1;
+
+	gl::ring_allocator::statistics const & Stats = Allocator.stats();
+	Error += Stats.Allocations == 3 ? 0 : 1;
+	Error += Stats.Bytes == REGION_SIZE + 1 + REGION_SIZE - 256 ? 0 : 1;
+
+	return Error;
+}
+
+int test_wrap_around()
+{
+	int Error = 0;
+
+	fake_fence_backend Fences;
+	{
+		gl::ring_allocator Allocator(REGION_SIZE, REGION_COUNT, Fences);
+
+		for(std::size_t Frame = 0; Frame < 10; ++Frame)
+		{
+			Error += Allocator.allocate(64, 16) == Frame % REGION_COUNT * REGION_SIZE ? 0 : 1;
+			Allocator.end_frame();
+
+			// One fence per region still in flight
+			Error += Fences.Live.size() == (Frame < REGION_COUNT ? Frame + 1 : REGION_COUNT) ? 0 : 1;
+		}
+
+		// A frame without allocations keeps its region and inserts no fence
+		std::size_t const Inserted = Fences.Inserted;
+		std::size_t const Offset = Allocator.region_offset();
+		Allocator.end_frame();
+		Error += Fences.Inserted == Inserted && Allocator.region_offset() == Offset ? 0 : 1;
+		Error += Allocator.stats().Frames == 11 ? 0 : 1;
+	}
+
+	// The allocator releases the fences it still holds
+	Error += Fences.Live.empty() ? 0 : 1;
+	Error += Fences.Errors == 0 ? 0 : 1;
+
+	return Error;
+}
+
+int test_fence_wait()
+{
+	int Error = 0;
+
+	fake_fence_backend Fences;
+	gl::ring_allocator Allocator(REGION_SIZE, REGION_COUNT, Fences);
+
+	// The first lap finds no fences
+	for(std::size_t Frame = 0; Frame < REGION_COUNT; ++Frame)
+	{
+		Allocator.allocate(64, 16);
+		Allocator.end_frame();
+	}
+	Error += Fences.Waits == 0 ? 0 : 1;
+
+	// A signaled fence is polled once and is not a stall
+	Allocator.allocate(64, 16);
+	Error += Fences.Waits == 1 && Allocator.stats().Stalls == 0 ? 0 : 1;
+	Allocator.end_frame();
+
+	// A busy fence is waited on until it signals, and the frame counts as one stall
+	Fences.Busy = 3;
+	Allocator.allocate(64, 16);
+	Error += Fences.Waits == 5 && Fences.Busy == 0 ? 0 : 1;
+	Error += Allocator.stats().Stalls == 1 ? 0 : 1;
+	Error += Allocator.stats().StallTime >= 0.0 ? 0 : 1;
+
+	// The region is only acquired once per frame
+	Allocator.allocate(64, 16);
+	Error += Fences.Waits == 5 ? 0 : 1;
+	Allocator.end_frame();
+
+	Error += Fences.Errors == 0 ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+	Error += test_alignment();
+	Error += test_oversize();
+	Error += test_wrap_around();
+	Error += test_fence_wait();
+
+	return Error;
+}
@@ -69,6 +69,18 @@ public:
 
     void End(void);
 
+    // Or, for a mesh that is already indexed, size the arrays for it and
+    // fill them in place through the Get...Array() functions before End()
+    void BeginIndexedMesh(GLuint nVerts, GLuint nIndexes);
+
+    inline GLushort *GetIndexArray(void) { return pIndexes; }
+
+    inline M3DVector3f *GetVertexArray(void) { return pVerts; }
+
+    inline M3DVector3f *GetNormalArray(void) { return pNorms; }
+
+    inline M3DVector2f *GetTexCoordArray(void) { return pTexCoords; }
+
     // Useful for statistics
     inline GLuint GetIndexCount(void) { return nNumIndexes; }
 
@@ -0,0 +1,141 @@
+// OpenEXRImage.h
+// Half float OpenEXR loading for the HDR samples.
+//
+// The image is read straight into a packed RGB half float buffer and handed
+// to OpenGL as GL_HALF_FLOAT, so nothing is converted on the CPU. Scanline
+// blocks are decompressed on OpenEXR's own thread pool, and the rows are put
+// in OpenGL's bottom up order by swapping whole rows. gltHalfToFloat is only
+// for code that really needs floats on the CPU.
+
+#ifndef OPENEXR_IMAGE_HEADER
+#define OPENEXR_IMAGE_HEADER
+
+#include <GLTools.h>
+
+#include <ImfInputFile.h>            // OpenEXR headers
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfThreading.h>
+#include <half.h>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define OPENEXR_IMAGE_USE_F16C
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Convert half floats to floats, eight at a time where the CPU has F16C
+inline void gltHalfToFloat(const half *pSrc, float *pDst, size_t count)
+{
+	size_t i = 0;
+#ifdef OPENEXR_IMAGE_USE_F16C
+	for (; i + 8 <= count; i += 8)
+		_mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(pSrc + i))));
+#endif
+	for (; i < count; i++)
+		pDst[i] = pSrc[i];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Read an OpenEXR file into texels as packed RGB half floats, 6 bytes per
+// pixel, with the bottom row first as glTexImage2D expects. A luminance only
+// file is expanded to grey. threads is the number of OpenEXR decoding threads,
+// 0 uses one per hardware thread. Returns false and prints why on failure.
+inline bool gltReadOpenEXRHalf(const char *fileName, std::vector<half> &texels, GLuint &texWidth, GLuint &texHeight,
+                               unsigned int threads = 0)
+{
+	// The OpenEXR uses exception handling to report errors or failures
+	try
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		if (Imf::globalThreadCount() != int(threads))
+			Imf::setGlobalThreadCount(int(threads));
+
+		Imf::InputFile file(fileName);
+		Imath::Box2i dw = file.header().dataWindow();
+		texWidth  = dw.max.x - dw.min.x + 1;
+		texHeight = dw.max.y - dw.min.y + 1;
+
+		// half has no constructor work, so this only allocates
+		texels.resize(size_t(texWidth) * texHeight * 3);
+
+		// the slices address pixel (x, y) of the data window as base + x * xStride + y * yStride
+		const size_t xStride = 3 * sizeof(half);
+		const size_t yStride = xStride * texWidth;
+		char *base = (char *)&texels[0] - dw.min.x * xStride - dw.min.y * yStride;
+
+		const Imf::ChannelList &channels = file.header().channels();
+		const bool luminance = channels.findChannel("R") == 0 && channels.findChannel("Y") != 0;
+		Imf::FrameBuffer frameBuffer;
+		if (luminance)
+		{
+			frameBuffer.insert("Y", Imf::Slice(Imf::HALF, base, xStride, yStride, 1, 1, 0.0));
+		}
+		else
+		{
+			frameBuffer.insert("R", Imf::Slice(Imf::HALF, base, xStride, yStride, 1, 1, 0.0));
+			frameBuffer.insert("G", Imf::Slice(Imf::HALF, base + sizeof(half), xStride, yStride, 1, 1, 0.0));
+			frameBuffer.insert("B", Imf::Slice(Imf::HALF, base + 2 * sizeof(half), xStride, yStride, 1, 1, 0.0));
+		}
+		file.setFrameBuffer(frameBuffer);
+		file.readPixels(dw.min.y, dw.max.y);
+
+		if (luminance)
+		{
+			for (size_t i = 0; i < texels.size(); i += 3)
+				texels[i + 1] = texels[i + 2] = texels[i];
+		}
+
+		// OpenEXR stores the top row first, swap whole rows instead of copying texel by texel
+		const size_t rowLength = size_t(texWidth) * 3;
+		for (GLuint v = 0; v < texHeight / 2; v++)
+		{
+			half *top = &texels[v * rowLength];
+			half *bottom = &texels[(texHeight - v - 1) * rowLength];
+			std::swap_ranges(top, top + rowLength, bottom);
+		}
+	}
+	catch(Iex::BaseExc & e)
+	{
+		std::cerr << e.what() << std::endl;
+		texels.clear();
+		return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Take a file name/location and load an OpenEXR
+// Load the image into the "texture" texture object as GL_RGB16F without
+// converting it and pass back the texture sizes
+inline bool gltLoadOpenEXRTexture(const char *fileName, GLuint textureName, GLuint &texWidth, GLuint &texHeight)
+{
+	std::vector<half> texels;
+	if (!gltReadOpenEXRHalf(fileName, texels, texWidth, texHeight))
+		return false;
+
+	// rows of 6 byte texels are only 2 byte aligned
+	GLint unpackAlignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+
+	// Bind texture, load image, set tex state
+	glBindTexture(GL_TEXTURE_2D, textureName);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, texWidth, texHeight, 0, GL_RGB, GL_HALF_FLOAT, &texels[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	return true;
+}
+
+#endif // OPENEXR_IMAGE_HEADER
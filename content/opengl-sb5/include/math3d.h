@@ -44,6 +44,19 @@ ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF S
 #include <math.h>
 #include <string.h>    // Memcpy lives here on most systems
 
+///////////////////////////////////////////////////////////////////////////////
+// SIMD code paths. The float 4x4 multiply, inverse and the
+// array transforms pick the best one the CPU supports the first time they are
+// used. m3dSetSIMDLevel caps it, M3D_SIMD_SCALAR runs the plain C++ code, and
+// returns the level in use.
+#define M3D_SIMD_SCALAR    0
+#define M3D_SIMD_SSE       1
+#define M3D_SIMD_AVX       2
+
+int m3dGetSIMDLevel(void);
+
+int m3dSetSIMDLevel(int level);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Data structures and containers
 // Much thought went into how these are declared. Many libraries declare these
@@ -535,6 +548,16 @@ __inline void m3dTransformVector4(M3DVector4d vOut, const M3DVector4d v, const M
     vOut[3] = m[3] * v[0] + m[7] * v[1] + m[11] * v[2] + m[15] * v[3];
 }
 
+// Transform whole arrays, points (w of 1), four component vectors and normals
+// (rotation only, pass the normal matrix). These use SSE or AVX when the CPU
+// has them, and vOut may be the same array as vIn.
+// Implemented in math3d.cpp
+void m3dTransformPoints3(M3DVector3f *vOut, const M3DVector3f *vIn, int count, const M3DMatrix44f m);
+
+void m3dTransformVectors4(M3DVector4f *vOut, const M3DVector4f *vIn, int count, const M3DMatrix44f m);
+
+void m3dRotateVectors(M3DVector3f *vOut, const M3DVector3f *vIn, int count, const M3DMatrix33f m);
+
 
 // Just do the rotation, not the translation... this is usually done with a 3x3
 // Matrix.
@@ -0,0 +1,957 @@
+// procedural_mesh.h - indexed procedural shapes with shared vertices
+//
+// Header only, standard library only. The same file is used by
+// opengl-samels/framework, opengl-sb5/include and cg-opengl/src/utilities:
+// change one copy, then copy it over the other two.
+//
+// Shapes: icosphere, UV sphere, torus, torus knot, cylinder and plane. Each
+// shape is a struct of parameters with a count function giving the vertex and
+// index counts and a generate function writing into caller-provided arrays:
+//
+//     procedural_mesh::torus Torus(1.0f, 0.25f, 64, 32);
+//     procedural_mesh::counts const Counts = procedural_mesh::count(Torus);
+//     std::vector<float> Vertices(Counts.Vertices * 8);
+//     std::vector<std::uint32_t> Indices(Counts.Indices);
+//
+//     procedural_mesh::buffers Buffers;
+//     Buffers.Position = &Vertices[0];
+//     Buffers.PositionStride = sizeof(float) * 8;
+//     Buffers.Normal = &Vertices[3];
+//     Buffers.NormalStride = sizeof(float) * 8;
+//     Buffers.TexCoord = &Vertices[6];
+//     Buffers.TexCoordStride = sizeof(float) * 8;
+//     Buffers.Indices = &Indices[0];
+//     procedural_mesh::generate(Torus, Buffers);
+//
+// - Vertices are shared by every triangle using them. Seams and poles keep
+//   one vertex per texture coordinate, like the generators this replaces.
+// - Triangles are counter-clockwise seen from outside.
+// - The shapes are evaluated 64 vertices at a time, then normals, tangents
+//   and bitangents are finished four at a time, with SSE2 when the compiler
+//   targets it: the normal is normalized, the tangent is made orthogonal to
+//   it and normalized, and the bitangent is cross(normal, tangent), negated
+//   where that points towards decreasing v.
+// - Shapes of at least PROCEDURAL_MESH_PARALLEL_VERTICES vertices are split
+//   over threads. The icosphere edge cache is filled on the calling thread,
+//   the vertices of each subdivision level on all of them.
+
+#ifndef PROCEDURAL_MESH_H
+#define PROCEDURAL_MESH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if !defined(PROCEDURAL_MESH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define PROCEDURAL_MESH_SSE2
+#endif
+
+// Shapes with at least this many vertices are generated on several threads, 0 never does.
+#ifndef PROCEDURAL_MESH_PARALLEL_VERTICES
+#	define PROCEDURAL_MESH_PARALLEL_VERTICES 65536
+#endif
+
+namespace procedural_mesh
+{
+	struct counts
+	{
+		std::size_t Vertices;
+		std::size_t Indices;
+	};
+
+	// Where generate writes. Only Position and Indices are required. Strides are in bytes,
+	// 0 for tightly packed, so interleaved and separate arrays are both written in place.
+	struct buffers
+	{
+		float* Position;			// x, y, z
+		std::size_t PositionStride;
+		float* Normal;				// x, y, z
+		std::size_t NormalStride;
+		float* Tangent;				// x, y, z, towards increasing u
+		std::size_t TangentStride;
+		float* Bitangent;			// x, y, z, towards increasing v
+		std::size_t BitangentStride;
+		float* TexCoord;			// u, v
+		std::size_t TexCoordStride;
+		void* Indices;
+		std::size_t IndexSize;		// 2 or 4 bytes, 2 only below 65536 vertices
+		unsigned Threads;			// 0 for one per hardware thread
+
+		buffers() :
+			Position(0), PositionStride(0),
+			Normal(0), NormalStride(0),
+			Tangent(0), TangentStride(0),
+			Bitangent(0), BitangentStride(0),
+			TexCoord(0), TexCoordStride(0),
+			Indices(0), IndexSize(4),
+			Threads(0)
+		{}
+	};
+
+	// Subdivided icosahedron of the opengl-samels framework. Every subdivision splits each
+	// triangle in four; the edge midpoints are pushed out to the sphere and shared by the two
+	// triangles of the edge. Subdivision 0 is the 12 vertex icosahedron. Texture coordinates
+	// are those of uv_sphere and are not split along its seam: textured spheres use uv_sphere.
+	struct icosphere
+	{
+		float Radius;
+		int Subdivisions;
+
+		explicit icosphere(float Radius = 1.0f, int Subdivisions = 3) :
+			Radius(Radius), Subdivisions(Subdivisions)
+		{}
+	};
+
+	// Sphere around the z axis like gltMakeSphere: the north pole is at +z with v = 1 and u
+	// goes around from +y towards -x. At least 3 slices and 2 stacks.
+	struct uv_sphere
+	{
+		float Radius;
+		int Slices;
+		int Stacks;
+
+		uv_sphere(float Radius = 1.0f, int Slices = 32, int Stacks = 16) :
+			Radius(Radius), Slices(Slices), Stacks(Stacks)
+		{}
+	};
+
+	// Torus in the xy plane like gltMakeTorus. u goes UScale times around the major circle,
+	// v VScale times around the tube. At least 3 segments each way.
+	struct torus
+	{
+		float MajorRadius;
+		float MinorRadius;
+		int MajorSegments;
+		int MinorSegments;
+		float UScale;
+		float VScale;
+
+		torus(float MajorRadius = 1.0f, float MinorRadius = 0.25f, int MajorSegments = 48, int MinorSegments = 24) :
+			MajorRadius(MajorRadius), MinorRadius(MinorRadius),
+			MajorSegments(MajorSegments), MinorSegments(MinorSegments),
+			UScale(1.0f), VScale(1.0f)
+		{}
+	};
+
+	// (P, Q) torus knot tube of cg-opengl: Steps rings of Facets vertices along the curve,
+	// Thickness relative to Scale, clumps swelling the tube. u goes UScale times around the
+	// tube, v VScale times along the curve. At least 3 steps and facets.
+	struct torus_knot
+	{
+		int Steps;
+		int Facets;
+		float Scale;
+		float Thickness;
+		float Clumps;
+		float ClumpOffset;
+		float ClumpScale;
+		float UScale;
+		float VScale;
+		float P;
+		float Q;
+
+		torus_knot(int Steps = 256, int Facets = 16, float P = 3.0f, float Q = 2.0f) :
+			Steps(Steps), Facets(Facets), Scale(1.0f), Thickness(0.25f),
+			Clumps(0.0f), ClumpOffset(0.0f), ClumpScale(0.0f),
+			UScale(1.0f), VScale(1.0f), P(P), Q(Q)
+		{}
+	};
+
+	// Open tube along z like gltMakeCylinder, BaseRadius at z = 0 and TopRadius at z = Length,
+	// a cone when one of them is 0. u goes around, v along z. At least 3 slices and 1 stack.
+	struct cylinder
+	{
+		float BaseRadius;
+		float TopRadius;
+		float Length;
+		int Slices;
+		int Stacks;
+
+		cylinder(float BaseRadius = 1.0f, float TopRadius = 1.0f, float Length = 1.0f, int Slices = 32, int Stacks = 1) :
+			BaseRadius(BaseRadius), TopRadius(TopRadius), Length(Length), Slices(Slices), Stacks(Stacks)
+		{}
+	};
+
+	// Plane y = 0 centered on the origin, facing +y. u goes along x, v along z.
+	struct plane
+	{
+		float Width;
+		float Depth;
+		int SegmentsX;
+		int SegmentsZ;
+
+		plane(float Width = 1.0f, float Depth = 1.0f, int SegmentsX = 1, int SegmentsZ = 1) :
+			Width(Width), Depth(Depth), SegmentsX(SegmentsX), SegmentsZ(SegmentsZ)
+		{}
+	};
+
+namespace detail
+{
+	std::size_t const LANES = 64;
+
+	// A block of vertices on one row of a shape, one array per component
+	struct lanes
+	{
+		alignas(16) float Px[LANES]; alignas(16) float Py[LANES]; alignas(16) float Pz[LANES];
+		alignas(16) float Nx[LANES]; alignas(16) float Ny[LANES]; alignas(16) float Nz[LANES];
+		// Towards increasing u and v; any length, only the side of B matters
+		alignas(16) float Tx[LANES]; alignas(16) float Ty[LANES]; alignas(16) float Tz[LANES];
+		alignas(16) float Bx[LANES]; alignas(16) float By[LANES]; alignas(16) float Bz[LANES];
+		alignas(16) float U[LANES]; alignas(16) float V[LANES];
+	};
+
+	inline void copy_lane(lanes& L, std::size_t Dst, std::size_t Src)
+	{
+		float* const Arrays[] = {L.Px, L.Py, L.Pz, L.Nx, L.Ny, L.Nz, L.Tx, L.Ty, L.Tz, L.Bx, L.By, L.Bz, L.U, L.V};
+		for(std::size_t i = 0; i < sizeof(Arrays) / sizeof(Arrays[0]); ++i)
+			Arrays[i][Dst] = Arrays[i][Src];
+	}
+
+	// Normalizes N, makes T orthogonal to N and normalizes it, and replaces B by the unit
+	// bitangent cross(N, T) on the side of B.
+	inline void finish(lanes& L, std::size_t Count)
+	{
+		std::size_t const Padded = (Count + 3) & ~static_cast<std::size_t>(3);
+		for(std::size_t i = Count; i < Padded; ++i)
+			copy_lane(L, i, Count - 1);
+
+#		ifdef PROCEDURAL_MESH_SSE2
+			__m128 const Tiny = _mm_set1_ps(1e-30f);
+			__m128 const SignBit = _mm_set1_ps(-0.0f);
+			for(std::size_t i = 0; i < Padded; i += 4)
+			{
+				__m128 Nx = _mm_load_ps(L.Nx + i), Ny = _mm_load_ps(L.Ny + i), Nz = _mm_load_ps(L.Nz + i);
+				__m128 Tx = _mm_load_ps(L.Tx + i), Ty = _mm_load_ps(L.Ty + i), Tz = _mm_load_ps(L.Tz + i);
+				__m128 const Sx = _mm_load_ps(L.Bx + i), Sy = _mm_load_ps(L.By + i), Sz = _mm_load_ps(L.Bz + i);
+
+				__m128 const NN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Nx, Nx), _mm_mul_ps(Ny, Ny)), _mm_mul_ps(Nz, Nz));
+				__m128 const NLength = _mm_sqrt_ps(_mm_max_ps(NN, Tiny));
+				Nx = _mm_div_ps(Nx, NLength);
+				Ny = _mm_div_ps(Ny, NLength);
+				Nz = _mm_div_ps(Nz, NLength);
+
+				__m128 const NT = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Nx, Tx), _mm_mul_ps(Ny, Ty)), _mm_mul_ps(Nz, Tz));
+				Tx = _mm_sub_ps(Tx, _mm_mul_ps(Nx, NT));
+				Ty = _mm_sub_ps(Ty, _mm_mul_ps(Ny, NT));
+				Tz = _mm_sub_ps(Tz, _mm_mul_ps(Nz, NT));
+				__m128 const TT = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Tx, Tx), _mm_mul_ps(Ty, Ty)), _mm_mul_ps(Tz, Tz));
+				__m128 const TLength = _mm_sqrt_ps(_mm_max_ps(TT, Tiny));
+				Tx = _mm_div_ps(Tx, TLength);
+				Ty = _mm_div_ps(Ty, TLength);
+				Tz = _mm_div_ps(Tz, TLength);
+
+				__m128 Bx = _mm_sub_ps(_mm_mul_ps(Ny, Tz), _mm_mul_ps(Nz, Ty));
+				__m128 By = _mm_sub_ps(_mm_mul_ps(Nz, Tx), _mm_mul_ps(Nx, Tz));
+				__m128 Bz = _mm_sub_ps(_mm_mul_ps(Nx, Ty), _mm_mul_ps(Ny, Tx));
+				__m128 const Side = _mm_and_ps(SignBit, _mm_add_ps(_mm_add_ps(_mm_mul_ps(Bx, Sx), _mm_mul_ps(By, Sy)), _mm_mul_ps(Bz, Sz)));
+				Bx = _mm_xor_ps(Bx, Side);
+				By = _mm_xor_ps(By, Side);
+				Bz = _mm_xor_ps(Bz, Side);
+
+				_mm_store_ps(L.Nx + i, Nx); _mm_store_ps(L.Ny + i, Ny); _mm_store_ps(L.Nz + i, Nz);
+				_mm_store_ps(L.Tx + i, Tx); _mm_store_ps(L.Ty + i, Ty); _mm_store_ps(L.Tz + i, Tz);
+				_mm_store_ps(L.Bx + i, Bx); _mm_store_ps(L.By + i, By); _mm_store_ps(L.Bz + i, Bz);
+			}
+#		else
+			for(std::size_t i = 0; i < Padded; ++i)
+			{
+				float const NLength = std::sqrt(std::max(L.Nx[i] * L.Nx[i] + L.Ny[i] * L.Ny[i] + L.Nz[i] * L.Nz[i], 1e-30f));
+				float const Nx = L.Nx[i] / NLength, Ny = L.Ny[i] / NLength, Nz = L.Nz[i] / NLength;
+
+				float const NT = Nx * L.Tx[i] + Ny * L.Ty[i] + Nz * L.Tz[i];
+				float Tx = L.Tx[i] - Nx * NT, Ty = L.Ty[i] - Ny * NT, Tz = L.Tz[i] - Nz * NT;
+				float const TLength = std::sqrt(std::max(Tx * Tx + Ty * Ty + Tz * Tz, 1e-30f));
+				Tx /= TLength;
+				Ty /= TLength;
+				Tz /= TLength;
+
+				float Bx = Ny * Tz - Nz * Ty, By = Nz * Tx - Nx * Tz, Bz = Nx * Ty - Ny * Tx;
+				if(Bx * L.Bx[i] + By * L.By[i] + Bz * L.Bz[i] < 0.0f)
+				{
+					Bx = -Bx;
+					By = -By;
+					Bz = -Bz;
+				}
+
+				L.Nx[i] = Nx; L.Ny[i] = Ny; L.Nz[i] = Nz;
+				L.Tx[i] = Tx; L.Ty[i] = Ty; L.Tz[i] = Tz;
+				L.Bx[i] = Bx; L.By[i] = By; L.Bz[i] = Bz;
+			}
+#		endif
+	}
+
+	inline float* element(float* Base, std::size_t Stride, std::size_t Components, std::size_t Index)
+	{
+		return reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(Base) + Index * (Stride ? Stride : Components * sizeof(float)));
+	}
+
+	inline void store3(float* Base, std::size_t Stride, std::size_t First, std::size_t Count, float const* X, float const* Y, float const* Z)
+	{
+		if(!Base)
+			return;
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			float* const Dst = element(Base, Stride, 3, First + i);
+			Dst[0] = X[i];
+			Dst[1] = Y[i];
+			Dst[2] = Z[i];
+		}
+	}
+
+	inline void store(lanes const& L, std::size_t First, std::size_t Count, buffers const& Buffers)
+	{
+		store3(Buffers.Position, Buffers.PositionStride, First, Count, L.Px, L.Py, L.Pz);
+		store3(Buffers.Normal, Buffers.NormalStride, First, Count, L.Nx, L.Ny, L.Nz);
+		store3(Buffers.Tangent, Buffers.TangentStride, First, Count, L.Tx, L.Ty, L.Tz);
+		store3(Buffers.Bitangent, Buffers.BitangentStride, First, Count, L.Bx, L.By, L.Bz);
+		if(Buffers.TexCoord)
+		{
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float* const Dst = element(Buffers.TexCoord, Buffers.TexCoordStride, 2, First + i);
+				Dst[0] = L.U[i];
+				Dst[1] = L.V[i];
+			}
+		}
+	}
+
+	// Task(Begin, End) over [0, Count), on several threads when the shape has enough vertices
+	template<typename task>
+	inline void parallel(task const& Task, std::size_t Count, std::size_t Vertices, unsigned Threads)
+	{
+		if(Threads == 0)
+			Threads = std::thread::hardware_concurrency();
+		if(PROCEDURAL_MESH_PARALLEL_VERTICES > 0 && Threads > 1 && Count > 1 && Vertices >= static_cast<std::size_t>(PROCEDURAL_MESH_PARALLEL_VERTICES))
+		{
+			std::size_t const Chunk = (Count + Threads - 1) / Threads;
+			std::vector<std::thread> Workers;
+			for(std::size_t Begin = Chunk; Begin < Count; Begin += Chunk)
+				Workers.push_back(std::thread(Task, Begin, std::min(Begin + Chunk, Count)));
+			Task(0, std::min(Chunk, Count));
+			for(std::size_t i = 0; i < Workers.size(); ++i)
+				Workers[i].join();
+			return;
+		}
+		Task(0, Count);
+	}
+
+	// Evaluates, finishes and stores Rows x Cols vertices, vertex (Row, Col) at Row * Cols + Col.
+	// Eval(Row, Col, Count, Lanes) fills Count vertices of a row starting at Col.
+	template<typename evaluator>
+	inline void write_vertices(evaluator const& Eval, std::size_t Rows, std::size_t Cols, buffers const& Buffers)
+	{
+		std::size_t const Blocks = (Cols + LANES - 1) / LANES;
+		parallel([&](std::size_t Begin, std::size_t End)
+		{
+			lanes L;
+			for(std::size_t Block = Begin; Block < End; ++Block)
+			{
+				std::size_t const Row = Block / Blocks;
+				std::size_t const Col = (Block % Blocks) * LANES;
+				std::size_t const Count = std::min(LANES, Cols - Col);
+				Eval(Row, Col, Count, L);
+				finish(L, Count);
+				store(L, Row * Cols + Col, Count, Buffers);
+			}
+		}, Rows * Blocks, Rows * Cols, Buffers.Threads);
+	}
+
+	// Rows x Cols vertices, two triangles per quad. Triangles with two vertices on the first or
+	// last row are left out where that row collapses to a point. Flip picks the winding: the
+	// quad (r, c) gives (r c, r c+1, r+1 c) and (r c+1, r+1 c+1, r+1 c), or the reverse.
+	struct grid
+	{
+		std::size_t Rows;
+		std::size_t Cols;
+		bool Flip;
+		bool CollapseFirst;
+		bool CollapseLast;
+
+		counts count() const
+		{
+			std::size_t const Quads = Cols - 1;
+			counts Counts;
+			Counts.Vertices = Rows * Cols;
+			Counts.Indices = (Rows - 1) * Quads * 6 - ((CollapseFirst ? 1 : 0) + (CollapseLast ? 1 : 0)) * Quads * 3;
+			return Counts;
+		}
+	};
+
+	template<typename index>
+	inline void write_grid_indices(grid const& Grid, index* Indices, unsigned Threads)
+	{
+		std::size_t const Quads = Grid.Cols - 1;
+		parallel([&](std::size_t Begin, std::size_t End)
+		{
+			std::size_t Offset = Begin * Quads * 6 - (Grid.CollapseFirst && Begin > 0 ? Quads * 3 : 0);
+			for(std::size_t Row = Begin; Row < End; ++Row)
+			{
+				bool const First = !(Grid.CollapseFirst && Row == 0);
+				bool const Second = !(Grid.CollapseLast && Row + 2 == Grid.Rows);
+				for(std::size_t Col = 0; Col < Quads; ++Col)
+				{
+					index const V00 = static_cast<index>(Row * Grid.Cols + Col);
+					index const V01 = static_cast<index>(V00 + 1);
+					index const V10 = static_cast<index>(V00 + Grid.Cols);
+					index const V11 = static_cast<index>(V10 + 1);
+					if(First)
+					{
+						Indices[Offset++] = V00;
+						Indices[Offset++] = Grid.Flip ? V10 : V01;
+						Indices[Offset++] = Grid.Flip ? V01 : V10;
+					}
+					if(Second)
+					{
+						Indices[Offset++] = V01;
+						Indices[Offset++] = Grid.Flip ? V10 : V11;
+						Indices[Offset++] = Grid.Flip ? V11 : V10;
+					}
+				}
+			}
+		}, Grid.Rows - 1, Grid.Rows * Grid.Cols, Threads);
+	}
+
+	template<typename evaluator>
+	inline void generate_grid(grid const& Grid, evaluator const& Eval, buffers const& Buffers)
+	{
+		write_vertices(Eval, Grid.Rows, Grid.Cols, Buffers);
+		if(Buffers.IndexSize == 2)
+			write_grid_indices(Grid, static_cast<std::uint16_t*>(Buffers.Indices), Buffers.Threads);
+		else
+			write_grid_indices(Grid, static_cast<std::uint32_t*>(Buffers.Indices), Buffers.Threads);
+	}
+
+	// Cosine and sine of Count + 1 steps around the circle, the last one equal to the first
+	inline void circle(std::vector<float>& Cos, std::vector<float>& Sin, int Count)
+	{
+		Cos.resize(Count + 1);
+		Sin.resize(Count + 1);
+		double const Step = 6.283185307179586 / Count;
+		for(int i = 0; i < Count; ++i)
+		{
+			Cos[i] = static_cast<float>(std::cos(i * Step));
+			Sin[i] = static_cast<float>(std::sin(i * Step));
+		}
+		Cos[Count] = Cos[0];
+		Sin[Count] = Sin[0];
+	}
+
+	inline grid uv_sphere_grid(uv_sphere const& Shape)
+	{
+		grid Grid = {static_cast<std::size_t>(std::max(Shape.Stacks, 2)) + 1, static_cast<std::size_t>(std::max(Shape.Slices, 3)) + 1, true, true, true};
+		return Grid;
+	}
+
+	struct uv_sphere_evaluator
+	{
+		float Radius;
+		float SliceStep;
+		float StackStep;
+		std::vector<float> CosTheta, SinTheta, CosRho, SinRho;
+
+		explicit uv_sphere_evaluator(uv_sphere const& Shape) :
+			Radius(Shape.Radius),
+			SliceStep(1.0f / std::max(Shape.Slices, 3)),
+			StackStep(1.0f / std::max(Shape.Stacks, 2))
+		{
+			int const Stacks = std::max(Shape.Stacks, 2);
+			circle(CosTheta, SinTheta, std::max(Shape.Slices, 3));
+			CosRho.resize(Stacks + 1);
+			SinRho.resize(Stacks + 1);
+			for(int i = 0; i <= Stacks; ++i)
+			{
+				double const Rho = 3.141592653589793 * i / Stacks;
+				CosRho[i] = static_cast<float>(std::cos(Rho));
+				SinRho[i] = i == Stacks ? 0.0f : static_cast<float>(std::sin(Rho));
+			}
+		}
+
+		void operator()(std::size_t Row, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			float const SinR = SinRho[Row], CosR = CosRho[Row];
+			float const V = 1.0f - static_cast<float>(Row) * StackStep;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float const CosT = CosTheta[Col + i], SinT = SinTheta[Col + i];
+				L.Nx[i] = -SinT * SinR;
+				L.Ny[i] = CosT * SinR;
+				L.Nz[i] = CosR;
+				L.Px[i] = L.Nx[i] * Radius;
+				L.Py[i] = L.Ny[i] * Radius;
+				L.Pz[i] = L.Nz[i] * Radius;
+				L.Tx[i] = -CosT;
+				L.Ty[i] = -SinT;
+				L.Tz[i] = 0.0f;
+				L.Bx[i] = SinT * CosR;
+				L.By[i] = -CosT * CosR;
+				L.Bz[i] = SinR;
+				L.U[i] = static_cast<float>(Col + i) * SliceStep;
+				L.V[i] = V;
+			}
+		}
+	};
+
+	inline grid torus_grid(torus const& Shape)
+	{
+		grid Grid = {static_cast<std::size_t>(std::max(Shape.MajorSegments, 3)) + 1, static_cast<std::size_t>(std::max(Shape.MinorSegments, 3)) + 1, true, false, false};
+		return Grid;
+	}
+
+	struct torus_evaluator
+	{
+		float MajorRadius;
+		float MinorRadius;
+		float UStep;
+		float VStep;
+		std::vector<float> CosA, SinA, CosB, SinB;
+
+		explicit torus_evaluator(torus const& Shape) :
+			MajorRadius(Shape.MajorRadius),
+			MinorRadius(Shape.MinorRadius),
+			UStep(Shape.UScale / std::max(Shape.MajorSegments, 3)),
+			VStep(Shape.VScale / std::max(Shape.MinorSegments, 3))
+		{
+			circle(CosA, SinA, std::max(Shape.MajorSegments, 3));
+			circle(CosB, SinB, std::max(Shape.MinorSegments, 3));
+		}
+
+		void operator()(std::size_t Row, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			float const Ca = CosA[Row], Sa = SinA[Row];
+			float const U = static_cast<float>(Row) * UStep;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float const Cb = CosB[Col + i], Sb = SinB[Col + i];
+				float const R = MajorRadius + MinorRadius * Cb;
+				L.Px[i] = Ca * R;
+				L.Py[i] = Sa * R;
+				L.Pz[i] = MinorRadius * Sb;
+				L.Nx[i] = Ca * Cb;
+				L.Ny[i] = Sa * Cb;
+				L.Nz[i] = Sb;
+				L.Tx[i] = -Sa;
+				L.Ty[i] = Ca;
+				L.Tz[i] = 0.0f;
+				L.Bx[i] = -Ca * Sb;
+				L.By[i] = -Sa * Sb;
+				L.Bz[i] = Cb;
+				L.U[i] = U;
+				L.V[i] = static_cast<float>(Col + i) * VStep;
+			}
+		}
+	};
+
+	inline grid torus_knot_grid(torus_knot const& Shape)
+	{
+		grid Grid = {static_cast<std::size_t>(std::max(Shape.Steps, 3)) + 1, static_cast<std::size_t>(std::max(Shape.Facets, 3)) + 1, true, false, false};
+		return Grid;
+	}
+
+	struct torus_knot_evaluator
+	{
+		// Per ring: center, the two axes of the ring scaled by the clumped thickness, direction of the curve
+		struct ring
+		{
+			float C[3];
+			float X[3];
+			float Y[3];
+			float D[3];
+		};
+
+		float UStep;
+		float VStep;
+		std::vector<ring> Rings;
+		std::vector<float> Cos, Sin;
+
+		static void curve(torus_knot const& Shape, int Step, int Steps, double* Point)
+		{
+			double const Pi2 = 6.283185307179586;
+			double const Pp = Shape.P * Step * Pi2 / Steps;
+			double const Qp = Shape.Q * Step * Pi2 / Steps;
+			double const R = 0.5 * (2.0 + std::sin(Qp)) * Shape.Scale;
+			Point[0] = R * std::cos(Pp);
+			Point[1] = R * std::cos(Qp);
+			Point[2] = R * std::sin(Pp);
+		}
+
+		explicit torus_knot_evaluator(torus_knot const& Shape) :
+			UStep(Shape.UScale / std::max(Shape.Facets, 3)),
+			VStep(Shape.VScale / std::max(Shape.Steps, 3))
+		{
+			int const Steps = std::max(Shape.Steps, 3);
+			double const Pi2 = 6.283185307179586;
+			double const Thickness = static_cast<double>(Shape.Thickness) * Shape.Scale;
+
+			circle(Cos, Sin, std::max(Shape.Facets, 3));
+			Rings.resize(Steps + 1);
+			for(int i = 0; i < Steps; ++i)
+			{
+				double C[3], Next[3];
+				curve(Shape, i, Steps, C);
+				curve(Shape, i + 1, Steps, Next);
+
+				// Frame of the ring from the direction of the curve and the sum of two consecutive points
+				double const T[3] = {Next[0] - C[0], Next[1] - C[1], Next[2] - C[2]};
+				double N[3] = {Next[0] + C[0], Next[1] + C[1], Next[2] + C[2]};
+				double B[3] = {T[1] * N[2] - T[2] * N[1], T[2] * N[0] - T[0] * N[2], T[0] * N[1] - T[1] * N[0]};
+				N[0] = B[1] * T[2] - B[2] * T[1];
+				N[1] = B[2] * T[0] - B[0] * T[2];
+				N[2] = B[0] * T[1] - B[1] * T[0];
+				double const BLength = std::sqrt(B[0] * B[0] + B[1] * B[1] + B[2] * B[2]);
+				double const NLength = std::sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+
+				double const Clump = Shape.ClumpOffset + Shape.Clumps * i * Pi2 / Steps;
+				double const ScaleX = Thickness * (std::sin(Clump) * Shape.ClumpScale + 1.0) / NLength;
+				double const ScaleY = Thickness * (std::cos(Clump) * Shape.ClumpScale + 1.0) / BLength;
+
+				ring& Ring = Rings[i];
+				for(int k = 0; k < 3; ++k)
+				{
+					Ring.C[k] = static_cast<float>(C[k]);
+					Ring.X[k] = static_cast<float>(N[k] * ScaleX);
+					Ring.Y[k] = static_cast<float>(B[k] * ScaleY);
+					Ring.D[k] = static_cast<float>(T[k]);
+				}
+			}
+			Rings[Steps] = Rings[0];
+		}
+
+		void operator()(std::size_t Row, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			ring const& Ring = Rings[Row];
+			float const V = static_cast<float>(Row) * VStep;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float const S = Sin[Col + i], C = Cos[Col + i];
+				L.Nx[i] = Ring.X[0] * S + Ring.Y[0] * C;
+				L.Ny[i] = Ring.X[1] * S + Ring.Y[1] * C;
+				L.Nz[i] = Ring.X[2] * S + Ring.Y[2] * C;
+				L.Px[i] = Ring.C[0] + L.Nx[i];
+				L.Py[i] = Ring.C[1] + L.Ny[i];
+				L.Pz[i] = Ring.C[2] + L.Nz[i];
+				L.Tx[i] = Ring.X[0] * C - Ring.Y[0] * S;
+				L.Ty[i] = Ring.X[1] * C - Ring.Y[1] * S;
+				L.Tz[i] = Ring.X[2] * C - Ring.Y[2] * S;
+				L.Bx[i] = Ring.D[0];
+				L.By[i] = Ring.D[1];
+				L.Bz[i] = Ring.D[2];
+				L.U[i] = static_cast<float>(Col + i) * UStep;
+				L.V[i] = V;
+			}
+		}
+	};
+
+	inline grid cylinder_grid(cylinder const& Shape)
+	{
+		grid Grid = {static_cast<std::size_t>(std::max(Shape.Stacks, 1)) + 1, static_cast<std::size_t>(std::max(Shape.Slices, 3)) + 1, false, Shape.BaseRadius == 0.0f, Shape.TopRadius == 0.0f};
+		return Grid;
+	}
+
+	struct cylinder_evaluator
+	{
+		float BaseRadius;
+		float RadiusStep;
+		float LengthStep;
+		float Slope;
+		float UStep;
+		float VStep;
+		std::vector<float> Cos, Sin;
+
+		explicit cylinder_evaluator(cylinder const& Shape) :
+			BaseRadius(Shape.BaseRadius),
+			RadiusStep((Shape.TopRadius - Shape.BaseRadius) / std::max(Shape.Stacks, 1)),
+			LengthStep(Shape.Length / std::max(Shape.Stacks, 1)),
+			Slope(Shape.Length != 0.0f ? (Shape.TopRadius - Shape.BaseRadius) / Shape.Length : 0.0f),
+			UStep(1.0f / std::max(Shape.Slices, 3)),
+			VStep(1.0f / std::max(Shape.Stacks, 1))
+		{
+			circle(Cos, Sin, std::max(Shape.Slices, 3));
+		}
+
+		void operator()(std::size_t Row, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			float const R = BaseRadius + static_cast<float>(Row) * RadiusStep;
+			float const Z = static_cast<float>(Row) * LengthStep;
+			float const V = static_cast<float>(Row) * VStep;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float const C = Cos[Col + i], S = Sin[Col + i];
+				L.Px[i] = C * R;
+				L.Py[i] = S * R;
+				L.Pz[i] = Z;
+				L.Nx[i] = C;
+				L.Ny[i] = S;
+				L.Nz[i] = -Slope;
+				L.Tx[i] = -S;
+				L.Ty[i] = C;
+				L.Tz[i] = 0.0f;
+				L.Bx[i] = C * Slope;
+				L.By[i] = S * Slope;
+				L.Bz[i] = 1.0f;
+				L.U[i] = static_cast<float>(Col + i) * UStep;
+				L.V[i] = V;
+			}
+		}
+	};
+
+	inline grid plane_grid(plane const& Shape)
+	{
+		grid Grid = {static_cast<std::size_t>(std::max(Shape.SegmentsZ, 1)) + 1, static_cast<std::size_t>(std::max(Shape.SegmentsX, 1)) + 1, true, false, false};
+		return Grid;
+	}
+
+	struct plane_evaluator
+	{
+		float StepX;
+		float StepZ;
+		float Width;
+		float Depth;
+		float UStep;
+		float VStep;
+
+		explicit plane_evaluator(plane const& Shape) :
+			StepX(Shape.Width / std::max(Shape.SegmentsX, 1)),
+			StepZ(Shape.Depth / std::max(Shape.SegmentsZ, 1)),
+			Width(Shape.Width),
+			Depth(Shape.Depth),
+			UStep(1.0f / std::max(Shape.SegmentsX, 1)),
+			VStep(1.0f / std::max(Shape.SegmentsZ, 1))
+		{}
+
+		void operator()(std::size_t Row, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			float const Z = static_cast<float>(Row) * StepZ - Depth * 0.5f;
+			float const V = static_cast<float>(Row) * VStep;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				L.Px[i] = static_cast<float>(Col + i) * StepX - Width * 0.5f;
+				L.Py[i] = 0.0f;
+				L.Pz[i] = Z;
+				L.Nx[i] = 0.0f;
+				L.Ny[i] = 1.0f;
+				L.Nz[i] = 0.0f;
+				L.Tx[i] = 1.0f;
+				L.Ty[i] = 0.0f;
+				L.Tz[i] = 0.0f;
+				L.Bx[i] = 0.0f;
+				L.By[i] = 0.0f;
+				L.Bz[i] = 1.0f;
+				L.U[i] = static_cast<float>(Col + i) * UStep;
+				L.V[i] = V;
+			}
+		}
+	};
+
+	// Vertices of an icosphere on the unit sphere, indexed by the level's triangles
+	struct icosphere_evaluator
+	{
+		float Radius;
+		float const* Unit;
+
+		void operator()(std::size_t, std::size_t Col, std::size_t Count, lanes& L) const
+		{
+			float const InvTwoPi = 0.159154943f;
+			float const InvPi = 0.318309886f;
+			for(std::size_t i = 0; i < Count; ++i)
+			{
+				float const X = Unit[(Col + i) * 3 + 0];
+				float const Y = Unit[(Col + i) * 3 + 1];
+				float const Z = Unit[(Col + i) * 3 + 2];
+				float const XY = X * X + Y * Y;
+				L.Px[i] = X * Radius;
+				L.Py[i] = Y * Radius;
+				L.Pz[i] = Z * Radius;
+				L.Nx[i] = X;
+				L.Ny[i] = Y;
+				L.Nz[i] = Z;
+				// Longitude and latitude of uv_sphere, whose tangent is (-cos, -sin, 0) of the longitude
+				bool const Pole = XY < 1e-12f;
+				L.Tx[i] = Pole ? -1.0f : -Y;
+				L.Ty[i] = Pole ? 0.0f : X;
+				L.Tz[i] = 0.0f;
+				L.Bx[i] = -X * Z;
+				L.By[i] = -Y * Z;
+				L.Bz[i] = XY;
+				float const U = std::atan2(-X, Y) * InvTwoPi;
+				L.U[i] = U < 0.0f ? U + 1.0f : U;
+				L.V[i] = 1.0f - std::acos(std::max(-1.0f, std::min(1.0f, Z))) * InvPi;
+			}
+		}
+	};
+
+	inline std::size_t icosphere_faces(icosphere const& Shape)
+	{
+		return static_cast<std::size_t>(20) << (2 * std::max(Shape.Subdivisions, 0));
+	}
+
+	template<typename index>
+	inline void write_icosphere_indices(std::vector<std::uint32_t> const& Faces, index* Indices, std::size_t Vertices, unsigned Threads)
+	{
+		parallel([&](std::size_t Begin, std::size_t End)
+		{
+			for(std::size_t i = Begin; i < End; ++i)
+				Indices[i] = static_cast<index>(Faces[i]);
+		}, Faces.size(), Vertices, Threads);
+	}
+}//namespace detail
+
+	inline counts count(icosphere const& Shape)
+	{
+		// A closed triangle mesh of genus 0 has F / 2 + 2 vertices
+		std::size_t const Faces = detail::icosphere_faces(Shape);
+		counts Counts;
+		Counts.Vertices = Faces / 2 + 2;
+		Counts.Indices = Faces * 3;
+		return Counts;
+	}
+
+	inline counts count(uv_sphere const& Shape) {return detail::uv_sphere_grid(Shape).count();}
+	inline counts count(torus const& Shape) {return detail::torus_grid(Shape).count();}
+	inline counts count(torus_knot const& Shape) {return detail::torus_knot_grid(Shape).count();}
+	inline counts count(cylinder const& Shape) {return detail::cylinder_grid(Shape).count();}
+	inline counts count(plane const& Shape) {return detail::plane_grid(Shape).count();}
+
+	inline void generate(icosphere const& Shape, buffers const& Buffers)
+	{
+		counts const Counts = count(Shape);
+		int const Subdivisions = std::max(Shape.Subdivisions, 0);
+
+		// The icosahedron of glf::generate_icosahedron, triangles counter-clockwise from outside
+		float const T = 1.618033989f;
+		float const Corners[12][3] =
+		{
+			{-1, T, 0}, {1, T, 0}, {-1, -T, 0}, {1, -T, 0},
+			{0, -1, T}, {0, 1, T}, {0, -1, -T}, {0, 1, -T},
+			{T, 0, -1}, {T, 0, 1}, {-T, 0, -1}, {-T, 0, 1}
+		};
+		std::uint32_t const Icosahedron[20 * 3] =
+		{
+			0, 11, 5,	0, 5, 1,	0, 1, 7,	0, 7, 10,	0, 10, 11,
+			1, 5, 9,	5, 11, 4,	11, 10, 2,	10, 7, 6,	7, 1, 8,
+			3, 9, 4,	3, 4, 2,	3, 2, 6,	3, 6, 8,	3, 8, 9,
+			4, 9, 5,	2, 4, 11,	6, 2, 10,	8, 6, 7,	9, 8, 1
+		};
+
+		std::vector<float> Unit(Counts.Vertices * 3);
+		for(std::size_t i = 0; i < 12; ++i)
+		{
+			float const Scale = 1.0f / std::sqrt(Corners[i][0] * Corners[i][0] + Corners[i][1] * Corners[i][1] + Corners[i][2] * Corners[i][2]);
+			for(std::size_t k = 0; k < 3; ++k)
+				Unit[i * 3 + k] = Corners[i][k] * Scale;
+		}
+		std::vector<std::uint32_t> Faces(Icosahedron, Icosahedron + 20 * 3);
+		std::size_t Vertices = 12;
+
+		// The last level writes 32 bit indices in place
+		bool const Direct = Subdivisions > 0 && Buffers.IndexSize == 4;
+		std::vector<std::uint32_t> Next, Parents, CacheEdge, CacheMidpoint;
+		for(int Level = 0; Level < Subdivisions; ++Level)
+		{
+			// Each edge is cached at its lower vertex, which has at most 6 neighbours
+			std::uint32_t const Empty = ~static_cast<std::uint32_t>(0);
+			std::size_t const First = Vertices;
+			CacheEdge.assign(Vertices * 6, Empty);
+			CacheMidpoint.resize(Vertices * 6);
+			Parents.clear();
+			Parents.reserve(Faces.size());
+			bool const InPlace = Direct && Level == Subdivisions - 1;
+			std::uint32_t* Out = 0;
+			if(InPlace)
+				Out = static_cast<std::uint32_t*>(Buffers.Indices);
+			else
+			{
+				Next.resize(Faces.size() * 4);
+				Out = &Next[0];
+			}
+
+			for(std::size_t f = 0, n = 0; f < Faces.size(); f += 3, n += 12)
+			{
+				std::uint32_t Mid[3];
+				for(std::size_t e = 0; e < 3; ++e)
+				{
+					std::uint32_t const A = Faces[f + e], B = Faces[f + (e + 1) % 3];
+					std::uint32_t const Low = std::min(A, B), High = std::max(A, B);
+					std::size_t Slot = Low * 6;
+					while(CacheEdge[Slot] != High && CacheEdge[Slot] != Empty)
+						++Slot;
+					if(CacheEdge[Slot] == Empty)
+					{
+						CacheEdge[Slot] = High;
+						CacheMidpoint[Slot] = static_cast<std::uint32_t>(Vertices++);
+						Parents.push_back(Low);
+						Parents.push_back(High);
+					}
+					Mid[e] = CacheMidpoint[Slot];
+				}
+
+				// Mid[0] is on A B, Mid[1] on B C, Mid[2] on C A
+				std::uint32_t const Children[12] =
+				{
+					Faces[f + 0], Mid[0], Mid[2],
+					Mid[0], Faces[f + 1], Mid[1],
+					Mid[2], Mid[1], Faces[f + 2],
+					Mid[0], Mid[1], Mid[2]
+				};
+				std::copy(Children, Children + 12, Out + n);
+			}
+
+			detail::parallel([&](std::size_t Begin, std::size_t End)
+			{
+				for(std::size_t i = Begin; i < End; ++i)
+				{
+					float const* A = &Unit[Parents[i * 2 + 0] * 3];
+					float const* B = &Unit[Parents[i * 2 + 1] * 3];
+					float const X = (A[0] + B[0]) * 0.5f, Y = (A[1] + B[1]) * 0.5f, Z = (A[2] + B[2]) * 0.5f;
+					float const Scale = 1.0f / std::sqrt(X * X + Y * Y + Z * Z);
+					float* const Dst = &Unit[(First + i) * 3];
+					Dst[0] = X * Scale;
+					Dst[1] = Y * Scale;
+					Dst[2] = Z * Scale;
+				}
+			}, Vertices - First, Vertices, Buffers.Threads);
+
+			if(!InPlace)
+				Faces.swap(Next);
+		}
+
+		detail::icosphere_evaluator const Eval = {Shape.Radius, &Unit[0]};
+		detail::write_vertices(Eval, 1, Vertices, Buffers);
+		if(Direct)
+			return;
+		if(Buffers.IndexSize == 2)
+			detail::write_icosphere_indices(Faces, static_cast<std::uint16_t*>(Buffers.Indices), Vertices, Buffers.Threads);
+		else
+			detail::write_icosphere_indices(Faces, static_cast<std::uint32_t*>(Buffers.Indices), Vertices, Buffers.Threads);
+	}
+
+	inline void generate(uv_sphere const& Shape, buffers const& Buffers)
+	{
+		detail::generate_grid(detail::uv_sphere_grid(Shape), detail::uv_sphere_evaluator(Shape), Buffers);
+	}
+
+	inline void generate(torus const& Shape, buffers const& Buffers)
+	{
+		detail::generate_grid(detail::torus_grid(Shape), detail::torus_evaluator(Shape), Buffers);
+	}
+
+	inline void generate(torus_knot const& Shape, buffers const& Buffers)
+	{
+		detail::generate_grid(detail::torus_knot_grid(Shape), detail::torus_knot_evaluator(Shape), Buffers);
+	}
+
+	inline void generate(cylinder const& Shape, buffers const& Buffers)
+	{
+		detail::generate_grid(detail::cylinder_grid(Shape), detail::cylinder_evaluator(Shape), Buffers);
+	}
+
+	inline void generate(plane const& Shape, buffers const& Buffers)
+	{
+		detail::generate_grid(detail::plane_grid(Shape), detail::plane_evaluator(Shape), Buffers);
+	}
+}//namespace procedural_mesh
+
+#endif//PROCEDURAL_MESH_H
@@ -0,0 +1,195 @@
+// exr_benchmark.cpp
+// Compares the old OpenEXR loader of the HDR samples with the half float one
+// in OpenEXRImage.h. No window or OpenGL context is needed.
+//
+// exr_benchmark [file.exr] [legacy|half|all]
+// Without a file a synthetic 8192x4096 panorama is written first. Run one
+// path at a time to see its own peak resident memory.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include <ImfRgbaFile.h>            // OpenEXR headers
+#include <ImfArray.h>
+
+#include <OpenEXRImage.h>
+#include <StopWatch.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment (lib, "psapi.lib")
+#pragma comment (lib, "half.lib")
+#pragma comment (lib, "Iex.lib")
+#pragma comment (lib, "IlmImf.lib")
+#pragma comment (lib, "IlmThread.lib")
+#pragma comment (lib, "Imath.lib")
+#pragma comment (lib, "zlib.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Peak resident memory of the process in megabytes
+double PeakResidentMB()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+	return usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+// A sky gradient with a bright sun, written the way the samples' images are
+void WritePanorama(const char *fileName, int width, int height)
+{
+	Imf::Array2D<Imf::Rgba> pixels(height, width);
+	for (int y = 0; y < height; y++)
+	{
+		float elevation = 1.0f - float(y) / height;
+		for (int x = 0; x < width; x++)
+		{
+			float dx = float(x - width / 4) / width;
+			float dy = float(y - height / 4) / height;
+			float sun = 1.0f / (1.0f + 4000.0f * (dx * dx + dy * dy));
+			pixels[y][x] = Imf::Rgba(0.2f + elevation * 0.6f + 50.0f * sun,
+			                         0.3f + elevation * 0.7f + 45.0f * sun,
+			                         0.5f + elevation + 40.0f * sun, 1.0f);
+		}
+	}
+
+	Imf::RgbaOutputFile file(fileName, width, height, Imf::WRITE_RGB);
+	file.setFrameBuffer(&pixels[0][0], 1, width);
+	file.writePixels(height);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// What LoadOpenEXRImage did before: RGBA halfs, then a flipped RGB float copy
+bool ReadLegacy(const char *fileName, std::vector<GLfloat> &texels, GLuint &texWidth, GLuint &texHeight, size_t &bufferBytes)
+{
+	try
+	{
+		Imf::Array2D<Imf::Rgba> pixels;
+		Imf::RgbaInputFile file (fileName);
+		Imath::Box2i dw = file.dataWindow();
+
+		texWidth  = dw.max.x - dw.min.x + 1;
+		texHeight = dw.max.y - dw.min.y + 1;
+
+		pixels.resizeErase (texHeight, texWidth);
+
+		file.setFrameBuffer (&pixels[0][0] - dw.min.x - dw.min.y * texWidth, 1, texWidth);
+		file.readPixels (dw.min.y, dw.max.y);
+
+		texels.resize(size_t(texWidth) * texHeight * 3);
+		GLfloat* pTex = &texels[0];
+		for (unsigned int v = 0; v < texHeight; v++)
+		{
+			for (unsigned int u = 0; u < texWidth; u++)
+			{
+				Imf::Rgba texel = pixels[texHeight - v - 1][u];
+				pTex[0] = texel.r;
+				pTex[1] = texel.g;
+				pTex[2] = texel.b;
+
+				pTex += 3;
+			}
+		}
+		bufferBytes = size_t(texWidth) * texHeight * sizeof(Imf::Rgba) + texels.size() * sizeof(GLfloat);
+	}
+	catch(Iex::BaseExc & e)
+	{
+		std::cerr << e.what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	const char *fileName = argc > 1 ? argv[1] : "exr_benchmark_panorama.exr";
+	const char *mode = argc > 2 ? argv[2] : "all";
+	const bool runLegacy = strcmp(mode, "half") != 0;
+	const bool runHalf = strcmp(mode, "legacy") != 0;
+	const int runs = 5;
+
+	CStopWatch timer;
+	if (argc < 2)
+	{
+		timer.Reset();
+		WritePanorama(fileName, 8192, 4096);
+		printf("wrote %s in %.2f s\n", fileName, timer.GetElapsedSeconds());
+	}
+
+	GLuint width = 0, height = 0;
+	std::vector<GLfloat> legacyTexels;
+	std::vector<half> halfTexels;
+
+	if (runLegacy)
+	{
+		size_t bufferBytes = 0;
+		double best = 1e30;
+		for (int i = 0; i < runs; i++)
+		{
+			timer.Reset();
+			if (!ReadLegacy(fileName, legacyTexels, width, height, bufferBytes))
+				return 1;
+			best = std::min(best, double(timer.GetElapsedSeconds()));
+		}
+		printf("%-24s %5u x %-5u %8.1f ms %8.1f MB buffers %8.1f MB peak\n", "legacy rgba + float", width, height,
+		       best * 1000.0, bufferBytes / (1024.0 * 1024.0), PeakResidentMB());
+	}
+
+	if (runHalf)
+	{
+		unsigned int threads[2] = { 1, 0 };
+		for (int t = 0; t < 2; t++)
+		{
+			double best = 1e30;
+			for (int i = 0; i < runs; i++)
+			{
+				timer.Reset();
+				if (!gltReadOpenEXRHalf(fileName, halfTexels, width, height, threads[t]))
+					return 1;
+				best = std::min(best, double(timer.GetElapsedSeconds()));
+			}
+			printf("half rgb, %2d thread(s)    %5u x %-5u %8.1f ms %8.1f MB buffers %8.1f MB peak\n", Imf::globalThreadCount(),
+			       width, height, best * 1000.0, halfTexels.size() * sizeof(half) / (1024.0 * 1024.0), PeakResidentMB());
+		}
+
+		// only for code that needs floats on the CPU, the samples upload the halfs
+		std::vector<GLfloat> floats(halfTexels.size());
+		timer.Reset();
+		gltHalfToFloat(&halfTexels[0], &floats[0], floats.size());
+		printf("%-24s %23.1f ms\n", "half to float", timer.GetElapsedSeconds() * 1000.0);
+
+		if (runLegacy)
+		{
+			// both paths have to produce the same bottom up image
+			for (size_t i = 0; i < floats.size(); i++)
+			{
+				if (floats[i] != legacyTexels[i])
+				{
+					fprintf(stderr, "texel %u differs: %f != %f\n", unsigned(i), floats[i], legacyTexels[i]);
+					return 1;
+				}
+			}
+			printf("half and legacy texels match\n");
+		}
+	}
+
+	return 0;
+}
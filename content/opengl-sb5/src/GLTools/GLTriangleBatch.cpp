@@ -110,6 +110,26 @@ void GLTriangleBatch::BeginMesh(GLuint nMaxVerts) {
     pTexCoords = new M3DVector2f[nMaxIndexes];
 }
 
+////////////////////////////////////////////////////////////
+// Start a mesh that is already indexed, nVerts vertices used by
+// nIndexes indexes. Nothing is searched, the caller writes the
+// arrays returned by the Get...Array() functions and calls End().
+void GLTriangleBatch::BeginIndexedMesh(GLuint nVerts, GLuint nIndexes) {
+    delete[] pIndexes;
+    delete[] pVerts;
+    delete[] pNorms;
+    delete[] pTexCoords;
+
+    nMaxIndexes = nIndexes;
+    nNumIndexes = nIndexes;
+    nNumVerts = nVerts;
+
+    pIndexes = new GLushort[nIndexes];
+    pVerts = new M3DVector3f[nVerts];
+    pNorms = new M3DVector3f[nVerts];
+    pTexCoords = new M3DVector2f[nVerts];
+}
+
 /////////////////////////////////////////////////////////////////
 // Add a triangle to the mesh. This searches the current list for identical
 // (well, almost identical - these are floats you know...) verts. If one is found, it
@@ -44,6 +44,235 @@ ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF S
 // Most functions are in-lined... and are defined here
 #include <math3d.h>
 
+// The float matrix multiply, inverse and the batch transforms have
+// SSE and AVX versions. SSE2 is there on every x64 CPU, AVX is looked for when
+// the library is first used, so one build runs everywhere. The plain C++ code
+// stays as the fallback and as the reference the SIMD versions are tested against.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define M3D_USE_SSE
+#if defined(_MSC_VER) || defined(__GNUC__)
+#include <immintrin.h>
+#define M3D_USE_AVX
+#endif
+#endif
+
+#if defined(M3D_USE_AVX) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// AVX functions are compiled for AVX on their own, the rest of the library is not
+#if defined(M3D_USE_AVX) && defined(__GNUC__)
+#define M3D_AVX_FUNCTION __attribute__((target("avx")))
+#else
+#define M3D_AVX_FUNCTION
+#endif
+
+////////////////////////////////////////////////////////////
+// SIMD level of the CPU
+static int SupportedSIMDLevel(void)
+	{
+#if defined(M3D_USE_AVX) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	// AVX and OSXSAVE, and the OS has to save the ymm registers
+	if((info[2] & (1 << 28)) && (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6)
+		return M3D_SIMD_AVX;
+#elif defined(M3D_USE_AVX)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx"))
+		return M3D_SIMD_AVX;
+#endif
+#ifdef M3D_USE_SSE
+	return M3D_SIMD_SSE;
+#else
+	return M3D_SIMD_SCALAR;
+#endif
+	}
+
+static int iSIMDLevel = -1;
+
+static inline int ActiveSIMDLevel(void)
+	{
+	if(iSIMDLevel < 0)
+		iSIMDLevel = SupportedSIMDLevel();
+	return iSIMDLevel;
+	}
+
+int m3dGetSIMDLevel(void)
+	{
+	return ActiveSIMDLevel();
+	}
+
+int m3dSetSIMDLevel(int level)
+	{
+	int supported = SupportedSIMDLevel();
+	iSIMDLevel = (level < supported) ? level : supported;
+	if(iSIMDLevel < M3D_SIMD_SCALAR)
+		iSIMDLevel = M3D_SIMD_SCALAR;
+	return iSIMDLevel;
+	}
+
+#ifdef M3D_USE_SSE
+///////////////////////////////////////////////////////////////////////////////
+// SSE versions. The sums are added in the same order as the C++ code, so the
+// multiply and the transforms give exactly the same floats.
+static void MatrixMultiply44SSE(float *product, const float *a, const float *b)
+	{
+	// all of a is loaded first, so product may be a or b
+	__m128 a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+	for(int j = 0; j < 4; j++) {
+		__m128 bj = _mm_loadu_ps(b + 4 * j);
+		__m128 p = _mm_add_ps(_mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, 0x00)), _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, 0x55)));
+		p = _mm_add_ps(p, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, 0xAA)));
+		p = _mm_add_ps(p, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, 0xFF)));
+		_mm_storeu_ps(product + 4 * j, p);
+		}
+	}
+
+// 2x2 determinants of rows P and Q, taken from columns 2 and 3, 2 and 3, 1 and 3, and 1 and 2
+template <int P, int Q>
+static inline __m128 CofactorPairs(__m128 c1, __m128 c2, __m128 c3)
+	{
+	__m128 q32 = _mm_shuffle_ps(c3, c2, _MM_SHUFFLE(Q, Q, Q, Q));
+	__m128 p32 = _mm_shuffle_ps(c3, c2, _MM_SHUFFLE(P, P, P, P));
+	__m128 p21 = _mm_shuffle_ps(c2, c1, _MM_SHUFFLE(P, P, P, P));
+	__m128 q21 = _mm_shuffle_ps(c2, c1, _MM_SHUFFLE(Q, Q, Q, Q));
+	return _mm_sub_ps(_mm_mul_ps(p21, _mm_shuffle_ps(q32, q32, _MM_SHUFFLE(2, 0, 0, 0))),
+					  _mm_mul_ps(_mm_shuffle_ps(p32, p32, _MM_SHUFFLE(2, 0, 0, 0)), q21));
+	}
+
+// Inverse from the adjugate, the 2x2 determinants are shared by all cofactors
+// instead of evaluating sixteen 3x3 determinants one by one
+static void InvertMatrix44SSE(float *mInverse, const float *m)
+	{
+	__m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+
+	__m128 fac0 = CofactorPairs<2, 3>(c1, c2, c3);
+	__m128 fac1 = CofactorPairs<1, 3>(c1, c2, c3);
+	__m128 fac2 = CofactorPairs<1, 2>(c1, c2, c3);
+	__m128 fac3 = CofactorPairs<0, 3>(c1, c2, c3);
+	__m128 fac4 = CofactorPairs<0, 2>(c1, c2, c3);
+	__m128 fac5 = CofactorPairs<0, 1>(c1, c2, c3);
+
+	// row r of column 1 followed by row r of column 0 three times
+	__m128 t0 = _mm_shuffle_ps(c1, c0, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 t1 = _mm_shuffle_ps(c1, c0, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 t2 = _mm_shuffle_ps(c1, c0, _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 t3 = _mm_shuffle_ps(c1, c0, _MM_SHUFFLE(3, 3, 3, 3));
+	__m128 v0 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 v1 = _mm_shuffle_ps(t1, t1, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 v2 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 2, 2, 0));
+	__m128 v3 = _mm_shuffle_ps(t3, t3, _MM_SHUFFLE(2, 2, 2, 0));
+
+	__m128 signA = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+	__m128 signB = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+	__m128 inv0 = _mm_mul_ps(signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v1, fac0), _mm_mul_ps(v2, fac1)), _mm_mul_ps(v3, fac2)));
+	__m128 inv1 = _mm_mul_ps(signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v0, fac0), _mm_mul_ps(v2, fac3)), _mm_mul_ps(v3, fac4)));
+	__m128 inv2 = _mm_mul_ps(signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v0, fac1), _mm_mul_ps(v1, fac3)), _mm_mul_ps(v3, fac5)));
+	__m128 inv3 = _mm_mul_ps(signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v0, fac2), _mm_mul_ps(v1, fac4)), _mm_mul_ps(v2, fac5)));
+
+	// determinant from the first row of the inverse and the first column of m
+	__m128 row0 = _mm_shuffle_ps(_mm_shuffle_ps(inv0, inv1, 0), _mm_shuffle_ps(inv2, inv3, 0), _MM_SHUFFLE(2, 0, 2, 0));
+	__m128 det = _mm_mul_ps(c0, row0);
+	det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 3, 0, 1)));
+	det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 0, 3, 2)));
+	__m128 rcp = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+	_mm_storeu_ps(mInverse, _mm_mul_ps(inv0, rcp));
+	_mm_storeu_ps(mInverse + 4, _mm_mul_ps(inv1, rcp));
+	_mm_storeu_ps(mInverse + 8, _mm_mul_ps(inv2, rcp));
+	_mm_storeu_ps(mInverse + 12, _mm_mul_ps(inv3, rcp));
+	}
+
+// Three floats without touching the fourth, so arrays can be transformed in place
+static inline void Store3SSE(float *out, __m128 v)
+	{
+	_mm_storel_pi((__m64 *)out, v);
+	_mm_store_ss(out + 2, _mm_movehl_ps(v, v));
+	}
+
+// c0, c1 and c2 are the matrix columns, c3 is added when Translate is set
+template <bool Translate>
+static void TransformArray3SSE(float *out, const float *in, int count, __m128 c0, __m128 c1, __m128 c2, __m128 c3)
+	{
+	for(int i = 0; i < count; i++, in += 3, out += 3) {
+		__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(in[0])), _mm_mul_ps(c1, _mm_set1_ps(in[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[2])));
+		if(Translate)
+			r = _mm_add_ps(r, c3);
+		Store3SSE(out, r);
+		}
+	}
+
+static void TransformArray4SSE(float *out, const float *in, int count, const float *m)
+	{
+	__m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+	for(int i = 0; i < count; i++, in += 4, out += 4) {
+		__m128 v = _mm_loadu_ps(in);
+		__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00)), _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+		r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+		_mm_storeu_ps(out, r);
+		}
+	}
+#endif
+
+#ifdef M3D_USE_AVX
+///////////////////////////////////////////////////////////////////////////////
+// AVX versions, two columns or two vectors at a time in the two 128 bit halves
+M3D_AVX_FUNCTION static void MatrixMultiply44AVX(float *product, const float *a, const float *b)
+	{
+	__m256 a0 = _mm256_broadcast_ps((const __m128 *)a), a1 = _mm256_broadcast_ps((const __m128 *)(a + 4));
+	__m256 a2 = _mm256_broadcast_ps((const __m128 *)(a + 8)), a3 = _mm256_broadcast_ps((const __m128 *)(a + 12));
+	__m256 b01 = _mm256_loadu_ps(b), b23 = _mm256_loadu_ps(b + 8);
+
+	__m256 p01 = _mm256_add_ps(_mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00)), _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+	p01 = _mm256_add_ps(p01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xAA)));
+	p01 = _mm256_add_ps(p01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)));
+	__m256 p23 = _mm256_add_ps(_mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00)), _mm256_mul_ps(a1, _mm256_permute_ps(b23, 0x55)));
+	p23 = _mm256_add_ps(p23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, 0xAA)));
+	p23 = _mm256_add_ps(p23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xFF)));
+
+	_mm256_storeu_ps(product, p01);
+	_mm256_storeu_ps(product + 8, p23);
+	}
+
+template <bool Translate>
+M3D_AVX_FUNCTION static void TransformArray3AVX(float *out, const float *in, int count, __m128 c0, __m128 c1, __m128 c2, __m128 c3)
+	{
+	__m256 w0 = _mm256_broadcast_ps(&c0), w1 = _mm256_broadcast_ps(&c1);
+	__m256 w2 = _mm256_broadcast_ps(&c2), w3 = _mm256_broadcast_ps(&c3);
+	int i = 0;
+	// the four float loads read the next vector's x, so the last vector is left to SSE
+	for(; i + 2 < count; i += 2, in += 6, out += 6) {
+		__m256 v = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in)), _mm_loadu_ps(in + 3), 1);
+		__m256 r = _mm256_add_ps(_mm256_mul_ps(w0, _mm256_permute_ps(v, 0x00)), _mm256_mul_ps(w1, _mm256_permute_ps(v, 0x55)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(w2, _mm256_permute_ps(v, 0xAA)));
+		if(Translate)
+			r = _mm256_add_ps(r, w3);
+		Store3SSE(out, _mm256_castps256_ps128(r));
+		Store3SSE(out + 3, _mm256_extractf128_ps(r, 1));
+		}
+	TransformArray3SSE<Translate>(out, in, count - i, c0, c1, c2, c3);
+	}
+
+M3D_AVX_FUNCTION static void TransformArray4AVX(float *out, const float *in, int count, const float *m)
+	{
+	__m256 c0 = _mm256_broadcast_ps((const __m128 *)m), c1 = _mm256_broadcast_ps((const __m128 *)(m + 4));
+	__m256 c2 = _mm256_broadcast_ps((const __m128 *)(m + 8)), c3 = _mm256_broadcast_ps((const __m128 *)(m + 12));
+	int i = 0;
+	for(; i + 2 <= count; i += 2, in += 8, out += 8) {
+		__m256 v = _mm256_loadu_ps(in);
+		__m256 r = _mm256_add_ps(_mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00)), _mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(v, 0xAA)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(v, 0xFF)));
+		_mm256_storeu_ps(out, r);
+		}
+	TransformArray4SSE(out, in, count - i, m);
+	}
+#endif
+
 
 ////////////////////////////////////////////////////////////
 // LoadIdentity
@@ -134,6 +363,18 @@ double m3dGetDistanceSquared3(const M3DVector3d u, const M3DVector3d v)
 // Multiply two 4x4 matricies
 void m3dMatrixMultiply44(M3DMatrix44f product, const M3DMatrix44f a, const M3DMatrix44f b )
 {
+#ifdef M3D_USE_AVX
+	if(ActiveSIMDLevel() >= M3D_SIMD_AVX) {
+		MatrixMultiply44AVX(product, a, b);
+		return;
+		}
+#endif
+#ifdef M3D_USE_SSE
+	if(ActiveSIMDLevel() >= M3D_SIMD_SSE) {
+		MatrixMultiply44SSE(product, a, b);
+		return;
+		}
+#endif
 	for (int i = 0; i < 4; i++) {
 		float ai0=A(i,0),  ai1=A(i,1),  ai2=A(i,2),  ai3=A(i,3);
 		P(i,0) = ai0 * B(0,0) + ai1 * B(1,0) + ai2 * B(2,0) + ai3 * B(3,0);
@@ -190,6 +431,74 @@ void m3dMatrixMultiply33(M3DMatrix33d product, const M3DMatrix33d a, const M3DMa
 #undef B33
 #undef P33
 
+///////////////////////////////////////////////////////////////////////////////
+// Transform arrays of points, four component vectors and normals
+void m3dTransformPoints3(M3DVector3f *vOut, const M3DVector3f *vIn, int count, const M3DMatrix44f m)
+{
+#ifdef M3D_USE_SSE
+	int level = ActiveSIMDLevel();
+	if(level >= M3D_SIMD_SSE) {
+		__m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+#ifdef M3D_USE_AVX
+		if(level >= M3D_SIMD_AVX) {
+			TransformArray3AVX<true>(vOut[0], vIn[0], count, c0, c1, c2, c3);
+			return;
+			}
+#endif
+		TransformArray3SSE<true>(vOut[0], vIn[0], count, c0, c1, c2, c3);
+		return;
+		}
+#endif
+	for (int i = 0; i < count; i++) {
+		M3DVector3f v = { vIn[i][0], vIn[i][1], vIn[i][2] };
+		m3dTransformVector3(vOut[i], v, m);
+	}
+}
+
+void m3dTransformVectors4(M3DVector4f *vOut, const M3DVector4f *vIn, int count, const M3DMatrix44f m)
+{
+#ifdef M3D_USE_AVX
+	if(ActiveSIMDLevel() >= M3D_SIMD_AVX) {
+		TransformArray4AVX(vOut[0], vIn[0], count, m);
+		return;
+		}
+#endif
+#ifdef M3D_USE_SSE
+	if(ActiveSIMDLevel() >= M3D_SIMD_SSE) {
+		TransformArray4SSE(vOut[0], vIn[0], count, m);
+		return;
+		}
+#endif
+	for (int i = 0; i < count; i++) {
+		M3DVector4f v = { vIn[i][0], vIn[i][1], vIn[i][2], vIn[i][3] };
+		m3dTransformVector4(vOut[i], v, m);
+	}
+}
+
+void m3dRotateVectors(M3DVector3f *vOut, const M3DVector3f *vIn, int count, const M3DMatrix33f m)
+{
+#ifdef M3D_USE_SSE
+	int level = ActiveSIMDLevel();
+	if(level >= M3D_SIMD_SSE) {
+		// the columns are three floats apart, so they can not be loaded four at a time
+		__m128 c0 = _mm_setr_ps(m[0], m[1], m[2], 0.0f), c1 = _mm_setr_ps(m[3], m[4], m[5], 0.0f);
+		__m128 c2 = _mm_setr_ps(m[6], m[7], m[8], 0.0f), c3 = _mm_setzero_ps();
+#ifdef M3D_USE_AVX
+		if(level >= M3D_SIMD_AVX) {
+			TransformArray3AVX<false>(vOut[0], vIn[0], count, c0, c1, c2, c3);
+			return;
+			}
+#endif
+		TransformArray3SSE<false>(vOut[0], vIn[0], count, c0, c1, c2, c3);
+		return;
+		}
+#endif
+	for (int i = 0; i < count; i++) {
+		M3DVector3f v = { vIn[i][0], vIn[i][1], vIn[i][2] };
+		m3dRotateVector(vOut[i], v, m);
+	}
+}
+
 	
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -518,6 +827,12 @@ static double DetIJ(const M3DMatrix44d m, const int i, const int j)
 // Invert matrix
 void m3dInvertMatrix44(M3DMatrix44f mInverse, const M3DMatrix44f m)
     {
+#ifdef M3D_USE_SSE
+    if(ActiveSIMDLevel() >= M3D_SIMD_SSE) {
+        InvertMatrix44SSE(mInverse, m);
+        return;
+        }
+#endif
     int i, j;
     float det, detij;
 
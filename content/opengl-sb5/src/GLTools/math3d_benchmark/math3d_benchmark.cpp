@@ -0,0 +1,176 @@
+// math3d_benchmark.cpp
+// Checks the SSE and AVX code paths of math3d against the plain C++ code and
+// times them. The multiply, rotation and transforms have to give exactly the
+// same floats; the inverse is computed differently and only has to agree
+// closely. Returns 1 if any check fails. Build without FMA contraction
+// (-ffp-contract=off when targeting a CPU with FMA), or the compiler fuses the
+// scalar code's multiplies and adds and it rounds differently.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include <math3d.h>
+#include <StopWatch.h>
+
+static const char *szLevelNames[] = { "scalar", "SSE", "AVX" };
+
+float RandomFloat(float fMin, float fMax)
+	{
+	return fMin + (fMax - fMin) * (float(rand()) / float(RAND_MAX));
+	}
+
+// Rotation, scale and translation, the kind of matrices the matrix stacks hold
+void RandomMatrix(M3DMatrix44f m)
+	{
+	M3DMatrix44f mRotation, mScale;
+	m3dRotationMatrix44(mRotation, RandomFloat(-3.0f, 3.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+	m3dScaleMatrix44(mScale, RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f));
+	m3dMatrixMultiply44(m, mRotation, mScale);
+	m[12] = RandomFloat(-10.0f, 10.0f);
+	m[13] = RandomFloat(-10.0f, 10.0f);
+	m[14] = RandomFloat(-10.0f, 10.0f);
+	}
+
+bool Identical(const float *a, const float *b, size_t count)
+	{
+	return memcmp(a, b, count * sizeof(float)) == 0;
+	}
+
+int main()
+	{
+	const int nMatrices = 1024;
+	const int nVectors = 100003;	// odd, so the AVX loops leave a tail
+	const int nPasses = 200;
+	bool bPassed = true;
+	CStopWatch timer;
+
+	srand(1234);
+	std::vector<float> matrices(nMatrices * 16), angles(nMatrices * 4);
+	for(int i = 0; i < nMatrices; i++)
+		{
+		RandomMatrix(&matrices[i * 16]);
+		for(int j = 0; j < 4; j++)
+			angles[i * 4 + j] = RandomFloat(-1.0f, 1.0f);
+		}
+	std::vector<float> points(nVectors * 3), vectors(nVectors * 4);
+	for(size_t i = 0; i < points.size(); i++)
+		points[i] = RandomFloat(-100.0f, 100.0f);
+	for(size_t i = 0; i < vectors.size(); i++)
+		vectors[i] = RandomFloat(-100.0f, 100.0f);
+	M3DMatrix33f mNormal;
+	m3dExtractRotationMatrix33(mNormal, &matrices[0]);
+
+	const int nBest = m3dSetSIMDLevel(M3D_SIMD_AVX);
+	printf("CPU supports %s\n\n", szLevelNames[nBest]);
+	printf("%-8s %12s %12s %12s %12s %12s %12s\n", "", "multiply", "inverse", "rotation", "points", "vectors4", "normals");
+	printf("%-8s %12s %12s %12s %12s %12s %12s\n", "", "ns", "ns", "ns", "ns/vector", "ns/vector", "ns/vector");
+
+	std::vector<float> refProducts, refInverses, refRotations, refPoints, refVectors, refNormals;
+	for(int level = M3D_SIMD_SCALAR; level <= nBest; level++)
+		{
+		m3dSetSIMDLevel(level);
+		std::vector<float> products(nMatrices * 16), inverses(nMatrices * 16), rotations(nMatrices * 16);
+		std::vector<float> outPoints(points.size()), outVectors(vectors.size()), outNormals(points.size());
+
+		// every matrix times the next one, like pushing onto a matrix stack
+		timer.Reset();
+		for(int p = 0; p < nPasses; p++)
+			for(int i = 0; i < nMatrices; i++)
+				m3dMatrixMultiply44(&products[i * 16], &matrices[i * 16], &matrices[((i + 1) % nMatrices) * 16]);
+		double dMultiply = timer.GetElapsedSeconds() * 1e9 / (double(nPasses) * nMatrices);
+
+		timer.Reset();
+		for(int p = 0; p < nPasses; p++)
+			for(int i = 0; i < nMatrices; i++)
+				m3dInvertMatrix44(&inverses[i * 16], &matrices[i * 16]);
+		double dInvert = timer.GetElapsedSeconds() * 1e9 / (double(nPasses) * nMatrices);
+
+		timer.Reset();
+		for(int p = 0; p < nPasses; p++)
+			for(int i = 0; i < nMatrices; i++)
+				m3dRotationMatrix44(&rotations[i * 16], angles[i * 4] * 3.0f, angles[i * 4 + 1], angles[i * 4 + 2], angles[i * 4 + 3]);
+		double dRotation = timer.GetElapsedSeconds() * 1e9 / (double(nPasses) * nMatrices);
+
+		const int nArrayPasses = 20;
+		timer.Reset();
+		for(int p = 0; p < nArrayPasses; p++)
+			m3dTransformPoints3((M3DVector3f *)&outPoints[0], (const M3DVector3f *)&points[0], nVectors, &matrices[0]);
+		double dPoints = timer.GetElapsedSeconds() * 1e9 / (double(nArrayPasses) * nVectors);
+
+		timer.Reset();
+		for(int p = 0; p < nArrayPasses; p++)
+			m3dTransformVectors4((M3DVector4f *)&outVectors[0], (const M3DVector4f *)&vectors[0], nVectors, &matrices[0]);
+		double dVectors = timer.GetElapsedSeconds() * 1e9 / (double(nArrayPasses) * nVectors);
+
+		timer.Reset();
+		for(int p = 0; p < nArrayPasses; p++)
+			m3dRotateVectors((M3DVector3f *)&outNormals[0], (const M3DVector3f *)&points[0], nVectors, mNormal);
+		double dNormals = timer.GetElapsedSeconds() * 1e9 / (double(nArrayPasses) * nVectors);
+
+		printf("%-8s %12.2f %12.2f %12.2f %12.3f %12.3f %12.3f\n", szLevelNames[level], dMultiply, dInvert, dRotation, dPoints, dVectors, dNormals);
+
+		if(level == M3D_SIMD_SCALAR)
+			{
+			refProducts = products;
+			refInverses = inverses;
+			refRotations = rotations;
+			refPoints = outPoints;
+			refVectors = outVectors;
+			refNormals = outNormals;
+			continue;
+			}
+
+		if(!Identical(&products[0], &refProducts[0], products.size()))
+			{
+			printf("  %s multiply differs from scalar\n", szLevelNames[level]);
+			bPassed = false;
+			}
+		if(!Identical(&rotations[0], &refRotations[0], rotations.size()))
+			{
+			printf("  %s rotation matrix differs from scalar\n", szLevelNames[level]);
+			bPassed = false;
+			}
+		if(!Identical(&outPoints[0], &refPoints[0], outPoints.size()) || !Identical(&outVectors[0], &refVectors[0], outVectors.size()) ||
+		   !Identical(&outNormals[0], &refNormals[0], outNormals.size()))
+			{
+			printf("  %s array transform differs from scalar\n", szLevelNames[level]);
+			bPassed = false;
+			}
+
+		// in place has to give the same result
+		std::vector<float> inPlace(points);
+		m3dTransformPoints3((M3DVector3f *)&inPlace[0], (const M3DVector3f *)&inPlace[0], nVectors, &matrices[0]);
+		if(!Identical(&inPlace[0], &refPoints[0], inPlace.size()))
+			{
+			printf("  %s in place transform differs from scalar\n", szLevelNames[level]);
+			bPassed = false;
+			}
+
+		// the inverse against the scalar one, and m times its inverse against the identity
+		float fMaxError = 0.0f, fMaxIdentityError = 0.0f;
+		for(int i = 0; i < nMatrices; i++)
+			{
+			M3DMatrix44f mCheck;
+			m3dMatrixMultiply44(mCheck, &matrices[i * 16], &inverses[i * 16]);
+			for(int j = 0; j < 16; j++)
+				{
+				float fRef = refInverses[i * 16 + j];
+				float fError = fabsf(inverses[i * 16 + j] - fRef) / (fabsf(fRef) > 1.0f ? fabsf(fRef) : 1.0f);
+				fMaxError = fError > fMaxError ? fError : fMaxError;
+				fError = fabsf(mCheck[j] - ((j % 5 == 0) ? 1.0f : 0.0f));
+				fMaxIdentityError = fError > fMaxIdentityError ? fError : fMaxIdentityError;
+				}
+			}
+		if(fMaxError > 1e-5f || fMaxIdentityError > 1e-5f)
+			{
+			printf("  %s inverse off by %g from scalar, %g from identity\n", szLevelNames[level], fMaxError, fMaxIdentityError);
+			bPassed = false;
+			}
+		}
+
+	printf("\n%s\n", bPassed ? "all SIMD paths match the scalar code" : "SIMD check failed");
+	return bPassed ? 0 : 1;
+	}
@@ -10,12 +10,20 @@
 #ifndef VBM_FILE_TYPES_ONLY
   #include "vgl.h"
   #include "vmath.h"
+  #include <vector>
 #endif
 
 #define VBM_FLAG_HAS_VERTICES       0x00000001
 #define VBM_FLAG_HAS_INDICES        0x00000002
 #define VBM_FLAG_HAS_FRAMES         0x00000004
 #define VBM_FLAG_HAS_MATERIALS      0x00000008
+#define VBM_FLAG_HAS_LODS           0x00000010
+#define VBM_FLAG_HAS_MORPH_FRAMES   0x00000020
+
+#define VBM_LOD_MAGIC               0x444F4C56
+#define VBM_MORPH_MAGIC             0x46524D56
+
+#define VBM_MORPH_FRAME_SPARSE      0x00000001
 
 typedef struct VBM_HEADER_t
 {
@@ -84,6 +92,50 @@ typedef struct VBM_VEC3F_t
     float z;
 } VBM_VEC3F;
 
+// Simplified versions of the object, written by obj2vbm -lod at the very end
+// of the file: num_lods VBM_LOD_HEADERs, num_indices unsigned int indices into
+// the object's vertices, then the VBM_LOD_FOOTER. The footer comes last so the
+// chain can be found without parsing the rest of the file.
+typedef struct VBM_LOD_HEADER_t
+{
+    unsigned int first;         /// First index of this level
+    unsigned int count;         /// Number of indices (triangles * 3)
+    float error;                /// Distance from the full object, in object units
+} VBM_LOD_HEADER;
+
+typedef struct VBM_LOD_FOOTER_t
+{
+    unsigned int magic;         /// VBM_LOD_MAGIC
+    unsigned int num_lods;      /// Levels, not counting the full object
+    unsigned int num_indices;   /// Indices of all levels
+    unsigned int num_triangles; /// Triangles of the full object
+    VBM_VEC3F center;           /// Bounding sphere of the object
+    float radius;
+} VBM_LOD_FOOTER;
+
+// Animation frames stored as offsets from a base pose, appended after the
+// body of the file like the LOD chain: num_vertices VBM_VEC3F base positions,
+// num_frames VBM_MORPH_FRAME_HEADERs, data_size bytes of offsets, then the
+// VBM_MORPH_FOOTER. Each offset is three shorts, times the scale of its frame.
+// Dense frames hold the offsets of all vertices in order. Sparse frames hold
+// only the vertices that move: count unsigned int vertex indices, then their
+// offsets.
+typedef struct VBM_MORPH_FRAME_HEADER_t
+{
+    unsigned int flags;         /// VBM_MORPH_FRAME_SPARSE or 0
+    unsigned int count;         /// Vertices stored
+    unsigned int offset;        /// Start of the frame in the offset data, in bytes
+    VBM_VEC3F scale;            /// Offset = short * scale
+} VBM_MORPH_FRAME_HEADER;
+
+typedef struct VBM_MORPH_FOOTER_t
+{
+    unsigned int magic;         /// VBM_MORPH_MAGIC
+    unsigned int num_frames;
+    unsigned int num_vertices;
+    unsigned int data_size;     /// Bytes of offset data
+} VBM_MORPH_FOOTER;
+
 typedef struct VBM_VEC2F_t
 {
     float x;
@@ -109,6 +161,13 @@ typedef struct VBM_MATERIAL_t
 
 #ifndef VBM_FILE_TYPES_ONLY
 
+#include <stdio.h>
+
+// Finds the section ending in a footer that starts with magic among those
+// appended to a VBM (LOD chain, morph frames), in any order. Reads the footer
+// and returns the file offset where the section starts, or -1.
+long vbmFindSection(FILE * f, unsigned int magic, void * footer, size_t footer_size);
+
 class VBObject
 {
 public:
@@ -214,6 +273,142 @@ protected:
 
     material_texture * m_material_textures;
 };
+
+// Picks a level of detail for every instance of an object from the chain
+// obj2vbm -lod appends to a VBM. Level 0 is the full object and level n is
+// the nth VBM_LOD_HEADER, coarser as n grows. Each instance gets the coarsest
+// level whose error covers at most the allowed number of pixels on screen.
+class VBMLODSelector
+{
+public:
+    VBMLODSelector(void);
+
+    bool LoadFromVBM(const char * filename);
+
+    unsigned int GetLevelCount(void) const
+    {
+        return (unsigned int)m_lods.size() + 1;
+    }
+
+    float GetBoundingRadius(void) const
+    {
+        return m_footer.radius;
+    }
+
+    float GetLevelError(unsigned int level) const
+    {
+        return level != 0 && level <= m_lods.size() ? m_lods[level - 1].error : 0.0f;
+    }
+
+    unsigned int GetLevelTriangleCount(unsigned int level) const
+    {
+        if (level == 0)
+            return m_footer.num_triangles;
+        return level <= m_lods.size() ? m_lods[level - 1].count / 3 : 0;
+    }
+
+    // Indices of a simplified level, into the vertices of the full object.
+    // Level 0 is drawn with the object's own indices.
+    const unsigned int * GetLevelIndices(unsigned int level) const
+    {
+        return level != 0 && level <= m_lods.size() ? &m_indices[m_lods[level - 1].first] : 0;
+    }
+
+    // fovy in degrees as for vmath::perspective, viewport_height in pixels
+    void SetCamera(const vmath::vec3 & eye, float fovy, float viewport_height, float max_pixel_error = 1.0f);
+
+    // Sorts instances by level. positions are the translations of the
+    // instances, which are assumed not to be scaled.
+    void Select(const vmath::vec3 * positions, unsigned int count);
+
+    // Instances given the level by the last Select, in increasing order
+    unsigned int GetInstanceCount(unsigned int level) const
+    {
+        return level < m_lods.size() + 1 ? m_first_instance[level + 1] - m_first_instance[level] : 0;
+    }
+
+    const unsigned int * GetInstances(unsigned int level) const
+    {
+        return GetInstanceCount(level) ? &m_instances[m_first_instance[level]] : 0;
+    }
+
+    // Triangles drawn for all the instances of the last Select
+    unsigned long long GetSelectedTriangleCount(void) const;
+
+protected:
+    void UpdateDistances(void);
+
+    VBM_LOD_FOOTER m_footer;
+    std::vector<VBM_LOD_HEADER> m_lods;
+    std::vector<unsigned int> m_indices;
+
+    vmath::vec3 m_eye;
+    float m_pixels_per_unit;                    // At distance 1
+    float m_max_pixel_error;
+    std::vector<float> m_min_distance2;         // Squared distance from which each level is used
+
+    std::vector<unsigned char> m_level;
+    std::vector<unsigned int> m_first_instance;
+    std::vector<unsigned int> m_instances;
+};
+
+// Morph animation kept compressed in memory and expanded on the CPU, blending
+// any two frames in one pass over the vertices, so that only the positions of
+// the current time need to be uploaded.
+class VBMMorphFrames
+{
+public:
+    VBMMorphFrames(void);
+
+    // Starts a new animation. Frames are then added in order with AddFrame,
+    // so the uncompressed animation never has to be in memory at once.
+    void SetBasePose(const VBM_VEC3F * positions, unsigned int vertex_count);
+
+    // Offsets of at most tolerance on every axis are dropped. A frame that
+    // leaves enough vertices in place is stored sparse.
+    void AddFrame(const VBM_VEC3F * positions, float tolerance = 0.0f);
+
+    bool LoadFromVBM(const char * filename);
+    bool AppendToVBM(const char * filename) const;
+
+    unsigned int GetFrameCount(void) const
+    {
+        return (unsigned int)m_frames.size();
+    }
+
+    unsigned int GetVertexCount(void) const
+    {
+        return (unsigned int)m_base.size();
+    }
+
+    bool IsFrameSparse(unsigned int frame) const
+    {
+        return frame < m_frames.size() && (m_frames[frame].flags & VBM_MORPH_FRAME_SPARSE) != 0;
+    }
+
+    // Bytes held for the base pose, the frame headers and the offsets
+    size_t GetStorageSize(void) const;
+
+    // Bytes the same frames take as full positions
+    size_t GetUncompressedSize(void) const
+    {
+        return m_frames.size() * m_base.size() * sizeof(VBM_VEC3F);
+    }
+
+    // Largest error quantization adds to a position of the frame, per axis
+    float GetFrameError(unsigned int frame) const;
+
+    // positions = frame_a * (1 - weight) + frame_b * weight
+    void Blend(unsigned int frame_a, unsigned int frame_b, float weight, VBM_VEC3F * positions) const;
+
+    // Blends the frames either side of time, measured in frames, looping
+    void Blend(float time, VBM_VEC3F * positions) const;
+
+protected:
+    std::vector<VBM_VEC3F> m_base;
+    std::vector<VBM_MORPH_FRAME_HEADER> m_frames;
+    std::vector<unsigned char> m_data;
+};
 #endif /* VBM_FILE_TYPES_ONLY */
 
 #endif /* __VBM_H__ */
@@ -37,10 +37,33 @@ struct vglImageData
     GLsizeiptr sliceStride;                     // Distance in bytes between slices of an array texture
     GLsizeiptr totalDataSize;                   // Complete amount of data allocated for texture
     vglImageMipData mip[MAX_TEXTURE_MIPS];      // Actual mipmap data
+    GLvoid* storage;                            // Mapped file or allocation the mips point into
+    GLsizeiptr storageSize;                     // Size of the mapping, 0 if storage was allocated
+    GLvoid* stream;                             // Pending vglStreamImageLevels, if any
 };
 
+// Called by vglStreamImageLevels on its own thread once a level is in memory.
+// Make no OpenGL calls here, hand the level over to the rendering thread.
+typedef void (*vglImageLevelCallback)(const vglImageData* image, GLint level, void* user);
+
 void vglLoadImage(const char* filename, vglImageData* image);
 void vglUnloadImage(vglImageData* image);
+
+// Maps the file and reads levels [firstLevel, firstLevel + levelCount) of every
+// slice only, levelCount 0 for all of them. The other levels are read from disk
+// when first touched or by vglStreamImageLevels. Files that cannot be mapped are
+// read whole. Returns GL_FALSE, with image cleared, for unsupported, corrupt or
+// truncated files.
+GLboolean vglLoadImageLevels(const char* filename, vglImageData* image,
+                             GLint firstLevel, GLint levelCount);
+
+// Reads levels [firstLevel, firstLevel + levelCount) on a background thread,
+// smallest first, calling callback after each. image must stay where it is
+// until vglWaitImageLevels or vglUnloadImage returns.
+GLboolean vglStreamImageLevels(vglImageData* image, GLint firstLevel, GLint levelCount,
+                               vglImageLevelCallback callback, void* user);
+void vglWaitImageLevels(vglImageData* image);
+
 GLuint vglLoadTexture(const char* filename,
                       GLuint texture,
                       vglImageData* image);
@@ -0,0 +1,438 @@
+/*
+
+    DDS loader benchmark
+
+    Writes large RGBA8 2D array DDS files and times, without a GL context,
+    reading them the way vglLoadDDS used to (fread of the whole file) against
+    mapping them with vglLoadDDSLevels:
+
+        preview     header plus the smallest levels, for a first frame
+        first mip   header plus level 0 of every slice
+        full        every level, in MB/s
+        stream      smallest levels, then the rest through vglStreamImageLevels
+
+    The page cache is dropped before every run so that the file comes from
+    disk each time. Truncated and corrupt copies of a small file must fail
+    to load.
+
+    Build with the loader, from the opengl_redbook directory:
+
+        g++ -O2 -Iinclude -I../opengl-samels/external/glfw-3.1.1/include
+            tools/ddsbench/ddsbench.cpp vermilion/vdds.cpp -lpthread
+
+    Usage: ddsbench [directory] [size] [slices] [runs]
+
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <vermilion.h>
+
+extern "C" GLboolean vglLoadDDSLevels(const char* filename, vglImageData* image, GLint firstLevel, GLint levelCount);
+extern "C" void vglUnloadDDS(vglImageData* image);
+
+#define DDS_MAGIC                   0x20534444
+#define DDS_DDPF_FOURCC             0x00000004
+#define DDS_FOURCC_DX10             0x30315844
+#define DDS_FORMAT_R8G8B8A8_UNORM   28
+#define DDS_DIMENSION_TEXTURE2D     3
+#define DDSCAPS_TEXTURE             0x00001000
+#define DDSCAPS_MIPMAP              0x00400000
+#define DDSCAPS_COMPLEX             0x00000008
+
+// Levels smaller than this are the preview
+#define PREVIEW_SIZE                128
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+static double elapsed_ms(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+static int count_levels(unsigned int size)
+{
+    int levels = 1;
+
+    while (size > 1)
+    {
+        size >>= 1;
+        levels++;
+    }
+
+    return levels;
+}
+
+// DX10 header RGBA8 2D array with a full mip chain, each texel tagged with its slice and level
+static size_t write_dds(const char* filename, unsigned int size, unsigned int slices)
+{
+    FILE* f = fopen(filename, "wb");
+
+    if (f == NULL)
+        return 0;
+
+    int levels = count_levels(size);
+    uint32_t header[37] = { 0 };
+
+    header[0] = DDS_MAGIC;
+    header[1] = 124;                            // size
+    header[2] = 0x0002100F;                     // caps, height, width, pitch, pixel format, mip count
+    header[3] = size;                           // height
+    header[4] = size;                           // width
+    header[5] = size * 4;                       // pitch
+    header[7] = levels;                         // mip levels
+    header[19] = 32;                            // pixel format size
+    header[20] = DDS_DDPF_FOURCC;
+    header[21] = DDS_FOURCC_DX10;
+    header[27] = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+    header[32] = DDS_FORMAT_R8G8B8A8_UNORM;
+    header[33] = DDS_DIMENSION_TEXTURE2D;
+    header[35] = slices;                        // array size
+
+    size_t written = fwrite(header, sizeof(header), 1, f) * sizeof(header);
+    std::vector<uint32_t> texels(size * size);
+
+    for (unsigned int slice = 0; slice < slices; slice++)
+    {
+        for (int level = 0; level < levels; level++)
+        {
+            unsigned int s = size >> level ? size >> level : 1;
+            std::fill(texels.begin(), texels.begin() + s * s, (slice << 8) | level);
+            written += fwrite(&texels[0], 4, s * s, f) * 4;
+        }
+    }
+
+    fflush(f);
+#ifndef _WIN32
+    fsync(fileno(f));
+#endif
+    fclose(f);
+
+    return written;
+}
+
+// Drops the file from the page cache, so that the next read goes to disk
+static void evict(const char* filename)
+{
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)filename;
+#endif
+}
+
+// What vglLoadDDS did before mapping: read everything, then look at it
+static size_t fread_whole(const char* filename, std::vector<unsigned char>& data)
+{
+    FILE* f = fopen(filename, "rb");
+
+    if (f == NULL)
+        return 0;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    data.resize(size);
+    size_t read = fread(&data[0], 1, size, f);
+    fclose(f);
+
+    return read;
+}
+
+// Sums a level of every slice, so that the texels are really looked at
+static uint64_t checksum_level(const vglImageData& image, int level)
+{
+    uint64_t sum = 0;
+    const unsigned char* data = (const unsigned char*)image.mip[level].data;
+
+    for (int slice = 0; slice < image.slices; slice++)
+    {
+        const uint32_t* texels = (const uint32_t*)(data + image.sliceStride * slice);
+        size_t count = image.mip[level].mipStride / 4;
+
+        for (size_t i = 0; i < count; i += 1024)
+            sum += texels[i];
+    }
+
+    return sum;
+}
+
+static bool check_level(const vglImageData& image, int level)
+{
+    const unsigned char* data = (const unsigned char*)image.mip[level].data;
+
+    for (int slice = 0; slice < image.slices; slice++)
+    {
+        const uint32_t* texels = (const uint32_t*)(data + image.sliceStride * slice);
+        size_t last = image.mip[level].mipStride / 4 - 1;
+        uint32_t tag = ((uint32_t)slice << 8) | level;
+
+        if (texels[0] != tag || texels[last] != tag)
+            return false;
+    }
+
+    return true;
+}
+
+struct stream_state
+{
+    bench_clock::time_point start;
+    std::atomic<int> pending;
+    double last;
+};
+
+static void on_level(const vglImageData* image, GLint level, void* user)
+{
+    stream_state* state = (stream_state*)user;
+
+    checksum_level(*image, level);
+    if (--state->pending == 0)
+        state->last = elapsed_ms(state->start);
+}
+
+struct result
+{
+    double best;
+    double total;
+    int runs;
+
+    result() : best(1e30), total(0.0), runs(0) {}
+
+    void add(double ms)
+    {
+        best = ms < best ? ms : best;
+        total += ms;
+        runs++;
+    }
+};
+
+static void print_result(const char* name, const result& r, size_t bytes)
+{
+    double mean = r.total / r.runs;
+
+    printf("  %-28s best %9.3f ms   mean %9.3f ms", name, r.best, mean);
+    if (bytes != 0)
+        printf("   %8.1f MB/s", bytes / (1024.0 * 1024.0) / (r.best / 1000.0));
+    printf("\n");
+}
+
+static bool write_file(const char* filename, const unsigned char* data, size_t size)
+{
+    FILE* f = fopen(filename, "wb");
+
+    if (f == NULL)
+        return false;
+
+    bool written = size == 0 || fwrite(data, size, 1, f) == 1;
+    fclose(f);
+
+    return written;
+}
+
+// Every truncated or corrupt copy of a small valid file must fail to load
+static bool truncation_test(const char* directory)
+{
+    std::string filename = std::string(directory) + "/ddsbench_small.dds";
+    std::string broken = std::string(directory) + "/ddsbench_broken.dds";
+    size_t fileSize = write_dds(filename.c_str(), 64, 3);
+    std::vector<unsigned char> data;
+    vglImageData image;
+
+    if (fileSize == 0 || fread_whole(filename.c_str(), data) != fileSize)
+        return false;
+
+    if (!vglLoadDDSLevels(filename.c_str(), &image, 0, 0))
+    {
+        printf("  %s: did not load\n", filename.c_str());
+        return false;
+    }
+    vglUnloadDDS(&image);
+
+    const size_t cuts[] = { 0, 3, 4, 100, 128, 147, 148, 149, fileSize / 2, fileSize - 1 };
+    bool passed = true;
+
+    for (size_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); i++)
+    {
+        if (!write_file(broken.c_str(), &data[0], cuts[i]))
+            return false;
+
+        if (vglLoadDDSLevels(broken.c_str(), &image, 0, 0))
+        {
+            printf("  truncated to %zu bytes: loaded, should have failed\n", cuts[i]);
+            vglUnloadDDS(&image);
+            passed = false;
+        }
+    }
+
+    // Corrupt sizes in an otherwise complete file
+    const struct { int word; uint32_t value; } corruptions[] =
+    {
+        { 1, 0 },                               // header size
+        { 4, 0 },                               // width
+        { 4, 0x80000000 },                      // width
+        { 7, 64 },                              // mip levels
+        { 19, 0 },                              // pixel format size
+        { 35, 0x10000000 },                     // array size
+    };
+
+    for (size_t i = 0; i < sizeof(corruptions) / sizeof(corruptions[0]); i++)
+    {
+        std::vector<unsigned char> copy(data);
+        memcpy(&copy[corruptions[i].word * 4], &corruptions[i].value, 4);
+
+        if (!write_file(broken.c_str(), &copy[0], copy.size()))
+            return false;
+
+        if (vglLoadDDSLevels(broken.c_str(), &image, 0, 0))
+        {
+            printf("  header word %d set to 0x%x: loaded, should have failed\n", corruptions[i].word, corruptions[i].value);
+            vglUnloadDDS(&image);
+            passed = false;
+        }
+    }
+
+    remove(broken.c_str());
+    remove(filename.c_str());
+
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    const char* directory = argc > 1 ? argv[1] : ".";
+    unsigned int size = argc > 2 ? atoi(argv[2]) : 2048;
+    unsigned int slices = argc > 3 ? atoi(argv[3]) : 8;
+    int runs = argc > 4 ? atoi(argv[4]) : 5;
+
+    if (size == 0 || slices == 0 || runs <= 0)
+    {
+        printf("Usage: ddsbench [directory] [size] [slices] [runs]\n");
+        return 1;
+    }
+
+    std::string filename = std::string(directory) + "/ddsbench.dds";
+    size_t fileSize = write_dds(filename.c_str(), size, slices);
+
+    if (fileSize == 0)
+    {
+        printf("Could not write %s\n", filename.c_str());
+        return 1;
+    }
+
+    const char* file = filename.c_str();
+    int levels = count_levels(size);
+    int preview = levels - count_levels(size < PREVIEW_SIZE ? size : PREVIEW_SIZE);
+
+    printf("%ux%u RGBA8, %u slices, %d levels, %.1f MB, %d runs from disk\n",
+           size, size, slices, levels, fileSize / (1024.0 * 1024.0), runs);
+
+    result freadPreview, mapPreview, mapFirst, freadFull, mapFull, streamFirst, streamAll;
+    bool valid = true;
+    uint64_t sink = 0;
+
+    for (int run = 0; run < runs; run++)
+    {
+        std::vector<unsigned char> data;
+
+        // fread has to read the whole file before anything can be shown
+        evict(file);
+        bench_clock::time_point start = bench_clock::now();
+        fread_whole(file, data);
+        double ms = elapsed_ms(start);
+        freadPreview.add(ms);
+        freadFull.add(ms);
+        sink += data[data.size() / 2];
+
+        vglImageData image;
+
+        evict(file);
+        start = bench_clock::now();
+        valid = vglLoadDDSLevels(file, &image, preview, 0) && valid;
+        sink += checksum_level(image, levels - 1);
+        mapPreview.add(elapsed_ms(start));
+        valid = check_level(image, levels - 1) && valid;
+        vglUnloadDDS(&image);
+
+        evict(file);
+        start = bench_clock::now();
+        valid = vglLoadDDSLevels(file, &image, 0, 1) && valid;
+        sink += checksum_level(image, 0);
+        mapFirst.add(elapsed_ms(start));
+        valid = check_level(image, 0) && valid;
+        vglUnloadDDS(&image);
+
+        evict(file);
+        start = bench_clock::now();
+        valid = vglLoadDDSLevels(file, &image, 0, 0) && valid;
+        for (int level = 0; level < levels; level++)
+            sink += checksum_level(image, level);
+        mapFull.add(elapsed_ms(start));
+        for (int level = 0; level < levels; level++)
+            valid = check_level(image, level) && valid;
+        vglUnloadDDS(&image);
+
+        // Preview right away, the rest arrives on the loader thread
+        stream_state state;
+        state.pending = preview;
+        state.last = 0.0;
+
+        evict(file);
+        state.start = bench_clock::now();
+        valid = vglLoadDDSLevels(file, &image, preview, 0) && valid;
+        streamFirst.add(elapsed_ms(state.start));
+        if (preview > 0)
+        {
+            valid = vglStreamImageLevels(&image, 0, preview, on_level, &state) && valid;
+            vglWaitImageLevels(&image);
+        }
+        else
+        {
+            state.last = elapsed_ms(state.start);
+        }
+        streamAll.add(state.last);
+        valid = state.pending == 0 && valid;
+        vglUnloadDDS(&image);
+    }
+
+    printf("Preview (levels %d-%d of every slice)\n", preview, levels - 1);
+    print_result("fread whole file", freadPreview, 0);
+    print_result("mapped", mapPreview, 0);
+    printf("Header plus first mip\n");
+    print_result("fread whole file", freadPreview, 0);
+    print_result("mapped", mapFirst, 0);
+    printf("Full load\n");
+    print_result("fread whole file", freadFull, fileSize);
+    print_result("mapped", mapFull, fileSize);
+    printf("Streamed\n");
+    print_result("preview", streamFirst, 0);
+    print_result("all levels delivered", streamAll, fileSize);
+
+    bool rejected = truncation_test(directory);
+    remove(file);
+
+    printf("Levels %s, truncated and corrupt files %s (%llu)\n",
+           valid ? "valid" : "INVALID", rejected ? "rejected" : "NOT REJECTED", (unsigned long long)sink);
+
+    return valid && rejected ? 0 : 1;
+}
@@ -1,10 +1,14 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <queue>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -23,6 +27,7 @@
 #define VBM_FLAG_HAS_INDICES        0x00000002
 #define VBM_FLAG_HAS_FRAMES         0x00000004
 #define VBM_FLAG_HAS_MATERIALS      0x00000008
+#define VBM_FLAG_HAS_LODS           0x00000010
 
 std::map<std::string, VBM_MATERIAL> materials;
 
@@ -193,6 +198,396 @@ void parse_material_file(const char * filename)
     fclose(infile);
 }
 
+// Quadric error metric simplification (Garland & Heckbert). Edges are
+// collapsed cheapest first and the triangle list is saved each time it
+// gets below the next target, giving a chain of coarser and coarser levels.
+struct quadric
+{
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+    quadric() : a2(0), ab(0), ac(0), ad(0), b2(0), bc(0), bd(0), c2(0), cd(0), d2(0) {}
+
+    // Squared distance to the plane ax + by + cz + d = 0, times weight
+    void add_plane(double a, double b, double c, double d, double weight)
+    {
+        a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+        b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+        c2 += weight * c * c; cd += weight * c * d;
+        d2 += weight * d * d;
+    }
+
+    void add(const quadric& q)
+    {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double error(double x, double y, double z) const
+    {
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+             + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+             + c2 * z * z + 2 * cd * z
+             + d2;
+    }
+
+    // Point of least error, if the quadric is not degenerate
+    bool optimum(double& x, double& y, double& z) const
+    {
+        double det = a2 * (b2 * c2 - bc * bc) - ab * (ab * c2 - bc * ac) + ac * (ab * bc - b2 * ac);
+
+        if (fabs(det) < 1e-12)
+            return false;
+
+        x = -(ad * (b2 * c2 - bc * bc) - ab * (bd * c2 - bc * cd) + ac * (bd * bc - b2 * cd)) / det;
+        y = -(a2 * (bd * c2 - cd * bc) - ad * (ab * c2 - bc * ac) + ac * (ab * cd - bd * ac)) / det;
+        z = -(a2 * (b2 * cd - bc * bd) - ab * (ab * cd - bd * ac) + ad * (ab * bc - b2 * ac)) / det;
+        return true;
+    }
+};
+
+struct collapse
+{
+    double cost;
+    double x, y, z;
+    unsigned int v0, v1;
+    unsigned int stamp0, stamp1;
+
+    bool operator < (const collapse& other) const { return cost > other.cost; }
+};
+
+class simplifier
+{
+public:
+    simplifier(const std::vector<VBM_VEC4F>& positions, const std::vector<unsigned int>& indices)
+        : live_triangles(indices.size() / 3)
+    {
+        size_t i;
+
+        for (i = 0; i < positions.size(); i++)
+        {
+            VBM_VEC3F p = { positions[i].x, positions[i].y, positions[i].z };
+            verts.push_back(p);
+        }
+
+        quadrics.resize(verts.size());
+        stamps.assign(verts.size(), 0);
+        alive.assign(verts.size(), true);
+        vertex_triangles.resize(verts.size());
+        tris = indices;
+        tri_alive.assign(indices.size() / 3, true);
+
+        for (i = 0; i < tris.size() / 3; i++)
+        {
+            for (int c = 0; c < 3; c++)
+                vertex_triangles[tris[i * 3 + c]].push_back((unsigned int)i);
+
+            double a, b, cc, d;
+            if (tri_alive[i] && plane((unsigned int)i, a, b, cc, d))
+            {
+                for (int c = 0; c < 3; c++)
+                    quadrics[tris[i * 3 + c]].add_plane(a, b, cc, d, 1.0);
+            }
+        }
+
+        add_boundary_planes();
+
+        for (i = 0; i < tris.size() / 3; i++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                unsigned int v0 = tris[i * 3 + c];
+                unsigned int v1 = tris[i * 3 + (c + 1) % 3];
+                if (v0 < v1)
+                    push_collapse(v0, v1);
+            }
+        }
+    }
+
+    size_t triangle_count() const { return live_triangles; }
+
+    // Collapses edges until at most target triangles remain. Returns the
+    // largest error of a collapse so far, as a distance.
+    double simplify(size_t target)
+    {
+        while (live_triangles > target && !heap.empty())
+        {
+            collapse c = heap.top();
+            heap.pop();
+
+            if (!alive[c.v0] || !alive[c.v1] || stamps[c.v0] != c.stamp0 || stamps[c.v1] != c.stamp1)
+                continue;
+
+            if (flips(c.v0, c.v1, c.x, c.y, c.z) || flips(c.v1, c.v0, c.x, c.y, c.z))
+                continue;
+
+            apply(c);
+            if (c.cost > max_cost)
+                max_cost = c.cost;
+        }
+
+        return sqrt(max_cost > 0.0 ? max_cost : 0.0);
+    }
+
+    void triangles(std::vector<unsigned int>& out) const
+    {
+        for (size_t i = 0; i < tris.size() / 3; i++)
+        {
+            if (tri_alive[i])
+                out.insert(out.end(), tris.begin() + i * 3, tris.begin() + i * 3 + 3);
+        }
+    }
+
+private:
+    bool plane(unsigned int t, double& a, double& b, double& c, double& d) const
+    {
+        const VBM_VEC3F& p0 = verts[tris[t * 3]];
+        const VBM_VEC3F& p1 = verts[tris[t * 3 + 1]];
+        const VBM_VEC3F& p2 = verts[tris[t * 3 + 2]];
+        double ux = p1.x - p0.x, uy = p1.y - p0.y, uz = p1.z - p0.z;
+        double vx = p2.x - p0.x, vy = p2.y - p0.y, vz = p2.z - p0.z;
+
+        a = uy * vz - uz * vy;
+        b = uz * vx - ux * vz;
+        c = ux * vy - uy * vx;
+
+        double len = sqrt(a * a + b * b + c * c);
+
+        if (len == 0.0)
+            return false;
+
+        a /= len; b /= len; c /= len;
+        d = -(a * p0.x + b * p0.y + c * p0.z);
+        return true;
+    }
+
+    // Keeps open borders in place with planes through the edge, at right angles to the face
+    void add_boundary_planes()
+    {
+        std::map<std::pair<unsigned int, unsigned int>, int> edges;
+        size_t i;
+
+        for (i = 0; i < tris.size() / 3; i++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                unsigned int v0 = tris[i * 3 + c];
+                unsigned int v1 = tris[i * 3 + (c + 1) % 3];
+                edges[std::make_pair(std::min(v0, v1), std::max(v0, v1))]++;
+            }
+        }
+
+        for (i = 0; i < tris.size() / 3; i++)
+        {
+            double a, b, c, d;
+
+            if (!plane((unsigned int)i, a, b, c, d))
+                continue;
+
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int v0 = tris[i * 3 + k];
+                unsigned int v1 = tris[i * 3 + (k + 1) % 3];
+
+                if (edges[std::make_pair(std::min(v0, v1), std::max(v0, v1))] != 1)
+                    continue;
+
+                const VBM_VEC3F& p0 = verts[v0];
+                const VBM_VEC3F& p1 = verts[v1];
+                double ex = p1.x - p0.x, ey = p1.y - p0.y, ez = p1.z - p0.z;
+                double nx = ey * c - ez * b, ny = ez * a - ex * c, nz = ex * b - ey * a;
+                double len = sqrt(nx * nx + ny * ny + nz * nz);
+
+                if (len == 0.0)
+                    continue;
+
+                nx /= len; ny /= len; nz /= len;
+                double nd = -(nx * p0.x + ny * p0.y + nz * p0.z);
+                quadrics[v0].add_plane(nx, ny, nz, nd, 10.0);
+                quadrics[v1].add_plane(nx, ny, nz, nd, 10.0);
+            }
+        }
+    }
+
+    void push_collapse(unsigned int v0, unsigned int v1)
+    {
+        quadric q = quadrics[v0];
+        q.add(quadrics[v1]);
+
+        const VBM_VEC3F& p0 = verts[v0];
+        const VBM_VEC3F& p1 = verts[v1];
+        collapse c;
+        double x, y, z;
+
+        // The endpoints and the midpoint, and the optimum if it is near the edge
+        double candidates[4][3] =
+        {
+            { p0.x, p0.y, p0.z },
+            { p1.x, p1.y, p1.z },
+            { (p0.x + p1.x) * 0.5, (p0.y + p1.y) * 0.5, (p0.z + p1.z) * 0.5 },
+            { 0.0, 0.0, 0.0 },
+        };
+        int num_candidates = 3;
+
+        if (q.optimum(x, y, z))
+        {
+            double ex = p1.x - p0.x, ey = p1.y - p0.y, ez = p1.z - p0.z;
+            double mx = x - candidates[2][0], my = y - candidates[2][1], mz = z - candidates[2][2];
+
+            if (mx * mx + my * my + mz * mz <= ex * ex + ey * ey + ez * ez)
+            {
+                candidates[3][0] = x; candidates[3][1] = y; candidates[3][2] = z;
+                num_candidates = 4;
+            }
+        }
+
+        c.cost = 1e300;
+        for (int i = 0; i < num_candidates; i++)
+        {
+            double cost = q.error(candidates[i][0], candidates[i][1], candidates[i][2]);
+            if (cost < c.cost)
+            {
+                c.cost = cost;
+                c.x = candidates[i][0]; c.y = candidates[i][1]; c.z = candidates[i][2];
+            }
+        }
+
+        c.v0 = v0;
+        c.v1 = v1;
+        c.stamp0 = stamps[v0];
+        c.stamp1 = stamps[v1];
+        heap.push(c);
+    }
+
+    // True if moving v to (x, y, z) turns over one of its triangles that don't also use other
+    bool flips(unsigned int v, unsigned int other, double x, double y, double z) const
+    {
+        const std::vector<unsigned int>& list = vertex_triangles[v];
+
+        for (size_t i = 0; i < list.size(); i++)
+        {
+            unsigned int t = list[i];
+            const unsigned int* tri = &tris[t * 3];
+
+            if (!tri_alive[t] || tri[0] == other || tri[1] == other || tri[2] == other)
+                continue;
+
+            double p[3][3], q[3][3];
+            for (int c = 0; c < 3; c++)
+            {
+                const VBM_VEC3F& src = verts[tri[c]];
+                p[c][0] = q[c][0] = src.x;
+                p[c][1] = q[c][1] = src.y;
+                p[c][2] = q[c][2] = src.z;
+                if (tri[c] == v)
+                {
+                    q[c][0] = x; q[c][1] = y; q[c][2] = z;
+                }
+            }
+
+            double n0[3], n1[3];
+            normal(p, n0);
+            normal(q, n1);
+
+            if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static void normal(const double p[3][3], double n[3])
+    {
+        double ux = p[1][0] - p[0][0], uy = p[1][1] - p[0][1], uz = p[1][2] - p[0][2];
+        double vx = p[2][0] - p[0][0], vy = p[2][1] - p[0][1], vz = p[2][2] - p[0][2];
+
+        n[0] = uy * vz - uz * vy;
+        n[1] = uz * vx - ux * vz;
+        n[2] = ux * vy - uy * vx;
+    }
+
+    // Moves v0 to the collapse point and gives it the triangles of v1
+    void apply(const collapse& c)
+    {
+        unsigned int v0 = c.v0;
+        unsigned int v1 = c.v1;
+        size_t i;
+
+        verts[v0].x = (float)c.x;
+        verts[v0].y = (float)c.y;
+        verts[v0].z = (float)c.z;
+        quadrics[v0].add(quadrics[v1]);
+        alive[v1] = false;
+
+        std::vector<unsigned int>& list0 = vertex_triangles[v0];
+        std::vector<unsigned int>& list1 = vertex_triangles[v1];
+
+        for (i = 0; i < list1.size(); i++)
+        {
+            unsigned int t = list1[i];
+            unsigned int* tri = &tris[t * 3];
+
+            if (!tri_alive[t])
+                continue;
+
+            if (tri[0] == v0 || tri[1] == v0 || tri[2] == v0)
+            {
+                tri_alive[t] = false;
+                live_triangles--;
+                continue;
+            }
+
+            for (int k = 0; k < 3; k++)
+            {
+                if (tri[k] == v1)
+                    tri[k] = v0;
+            }
+            list0.push_back(t);
+        }
+        list1.clear();
+
+        // Drop the dead triangles and queue the edges around v0 again
+        size_t live = 0;
+        for (i = 0; i < list0.size(); i++)
+        {
+            if (tri_alive[list0[i]])
+                list0[live++] = list0[i];
+        }
+        list0.resize(live);
+
+        stamps[v0]++;
+
+        std::vector<unsigned int> neighbors;
+        for (i = 0; i < list0.size(); i++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int n = tris[list0[i] * 3 + k];
+                if (n != v0)
+                    neighbors.push_back(n);
+            }
+        }
+
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        for (i = 0; i < neighbors.size(); i++)
+            push_collapse(std::min(v0, neighbors[i]), std::max(v0, neighbors[i]));
+    }
+
+    std::vector<VBM_VEC3F> verts;
+    std::vector<quadric> quadrics;
+    std::vector<unsigned int> stamps;
+    std::vector<bool> alive;
+    std::vector<std::vector<unsigned int> > vertex_triangles;
+    std::vector<unsigned int> tris;
+    std::vector<bool> tri_alive;
+    std::priority_queue<collapse> heap;
+    size_t live_triangles;
+    double max_cost = 0.0;
+};
+
 struct triangle
 {
     unsigned int v_index;
@@ -228,6 +623,18 @@ int main(int argc, char ** argv)
     std::vector<unsigned int> normal_indices;
     std::vector<unsigned int> texcoord_indices;
     std::vector<triangle> triangles;
+    unsigned int lod_levels = 0;
+
+    // obj2vbm input.obj output.vbm [materials.mtl] [-lod levels]
+    for (n = 3; n < argc; n++)
+    {
+        if (!strcmp(argv[n], "-lod"))
+        {
+            lod_levels = n + 1 < argc ? atoi(argv[n + 1]) : 4;
+            argc = n;
+            break;
+        }
+    }
 
     if (argc >= 4 && argv[3] != NULL)
     {
@@ -571,6 +978,79 @@ int main(int argc, char ** argv)
         }
     }
 
+    // Each level has half the triangles of the one before, down to a few dozen
+    std::vector<VBM_LOD_HEADER> lods;
+    std::vector<unsigned int> lod_indices;
+    VBM_LOD_FOOTER lod_footer;
+
+    memset(&lod_footer, 0, sizeof(lod_footer));
+
+    if (lod_levels != 0 && real_vertex_indices.size() != 0)
+    {
+        // Where each obj position ends up in the vertex data written below
+        std::vector<unsigned int> slot(vertices.size(), 0);
+
+        for (i = 0; i < vertices.size(); i++)
+            slot[i] = (unsigned int)i;
+
+        if (!can_do_indexed)
+        {
+            for (i = real_vertex_indices.size(); i-- > 0; )
+                slot[real_vertex_indices[i]] = (unsigned int)i;
+        }
+
+        simplifier simplify(vertices, real_vertex_indices);
+        size_t target = simplify.triangle_count();
+
+        while (lods.size() < lod_levels && target / 2 >= 32)
+        {
+            size_t previous = simplify.triangle_count();
+            target /= 2;
+
+            VBM_LOD_HEADER lod;
+            lod.error = (float)simplify.simplify(target);
+
+            if (simplify.triangle_count() >= previous)
+                break;
+
+            lod.first = (unsigned int)lod_indices.size();
+            simplify.triangles(lod_indices);
+            lod.count = (unsigned int)lod_indices.size() - lod.first;
+
+            for (i = lod.first; i < lod_indices.size(); i++)
+                lod_indices[i] = slot[lod_indices[i]];
+
+            lods.push_back(lod);
+            printf("LOD %u: %u triangles, error %f\n", (unsigned int)lods.size(), lod.count / 3, lod.error);
+        }
+
+        VBM_VEC3F lo = { vertices[0].x, vertices[0].y, vertices[0].z };
+        VBM_VEC3F hi = lo;
+
+        for (i = 0; i < vertices.size(); i++)
+        {
+            lo.x = std::min(lo.x, vertices[i].x); hi.x = std::max(hi.x, vertices[i].x);
+            lo.y = std::min(lo.y, vertices[i].y); hi.y = std::max(hi.y, vertices[i].y);
+            lo.z = std::min(lo.z, vertices[i].z); hi.z = std::max(hi.z, vertices[i].z);
+        }
+
+        lod_footer.magic = VBM_LOD_MAGIC;
+        lod_footer.num_lods = (unsigned int)lods.size();
+        lod_footer.num_indices = (unsigned int)lod_indices.size();
+        lod_footer.num_triangles = (unsigned int)(real_vertex_indices.size() / 3);
+        lod_footer.center.x = (lo.x + hi.x) * 0.5f;
+        lod_footer.center.y = (lo.y + hi.y) * 0.5f;
+        lod_footer.center.z = (lo.z + hi.z) * 0.5f;
+
+        for (i = 0; i < vertices.size(); i++)
+        {
+            float dx = vertices[i].x - lod_footer.center.x;
+            float dy = vertices[i].y - lod_footer.center.y;
+            float dz = vertices[i].z - lod_footer.center.z;
+            lod_footer.radius = std::max(lod_footer.radius, sqrtf(dx * dx + dy * dy + dz * dz));
+        }
+    }
+
     outfile = fopen(argv[2], "wb");
 
     VBM_HEADER file_header;
@@ -597,7 +1077,8 @@ int main(int argc, char ** argv)
         file_header.flags |= VBM_FLAG_HAS_MATERIALS;
         file_header.num_materials = materials.size();
     }
-    file_header.num_chunks = (unsigned int)(chunk - &chunks[0]);
+    if (lod_footer.magic != 0)
+        file_header.flags |= VBM_FLAG_HAS_LODS;
 
     fwrite(&file_header, sizeof(file_header), 1, outfile);
 
@@ -747,5 +1228,14 @@ int main(int argc, char ** argv)
 
     fwrite(chunks, sizeof(*chunk), chunk - &chunks[0], outfile);
 
+    if (lod_footer.magic != 0)
+    {
+        if (lods.size() != 0)
+            fwrite(&lods[0], sizeof(VBM_LOD_HEADER), lods.size(), outfile);
+        if (lod_indices.size() != 0)
+            fwrite(&lod_indices[0], sizeof(unsigned int), lod_indices.size(), outfile);
+        fwrite(&lod_footer, sizeof(lod_footer), 1, outfile);
+    }
+
     fclose(outfile);
 }
@@ -0,0 +1,105 @@
+/*
+
+    VBM LOD selection benchmark
+
+    Scatters instances of an object written by obj2vbm -lod through a volume
+    in front of the camera, as the instancing examples do with many more
+    copies, and times VBMLODSelector::Select. Prints how many instances got
+    each level and the triangles drawn with and without the LOD chain.
+
+    Build from the opengl_redbook directory:
+
+        g++ -O2 -Iinclude -I../opengl-samels/external/glfw-3.1.1/include
+            tools/vbmlodbench/vbmlodbench.cpp vermilion/vbmlod.cpp
+            vermilion/vbmsection.cpp
+
+    Usage: vbmlodbench object.vbm [instances] [pixel error] [runs]
+
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "vbm.h"
+
+using namespace vmath;
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: vbmlodbench object.vbm [instances] [pixel error] [runs]\n");
+        return 1;
+    }
+
+    unsigned int instance_count = argc > 2 ? atoi(argv[2]) : 100000;
+    float pixel_error = argc > 3 ? (float)atof(argv[3]) : 1.0f;
+    int runs = argc > 4 ? atoi(argv[4]) : 100;
+
+    VBMLODSelector selector;
+
+    if (!selector.LoadFromVBM(argv[1]))
+    {
+        printf("%s has no LOD chain, convert it with obj2vbm -lod\n", argv[1]);
+        return 1;
+    }
+
+    // Instances 2 to 200 object sizes away, in a 60 degree cone along -z
+    std::vector<vec3> positions(instance_count);
+    float size = 2.0f * selector.GetBoundingRadius();
+    unsigned int seed = 1;
+
+    for (unsigned int i = 0; i < instance_count; i++)
+    {
+        float r[3];
+
+        for (int k = 0; k < 3; k++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            r[k] = float(seed >> 8) / float(1 << 24);
+        }
+
+        float distance = size * (2.0f + 198.0f * r[0]);
+        positions[i] = vec3((r[1] - 0.5f) * distance, (r[2] - 0.5f) * distance * 0.5f, -distance);
+    }
+
+    selector.SetCamera(vec3(0.0f, 0.0f, 0.0f), 60.0f, 1080.0f, pixel_error);
+
+    double best = 1e30;
+    double total = 0.0;
+
+    for (int run = 0; run < runs; run++)
+    {
+        bench_clock::time_point start = bench_clock::now();
+        selector.Select(&positions[0], instance_count);
+        double ms = std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+        best = ms < best ? ms : best;
+        total += ms;
+    }
+
+    unsigned long long full = (unsigned long long)instance_count * selector.GetLevelTriangleCount(0);
+    unsigned long long selected = selector.GetSelectedTriangleCount();
+    unsigned int listed = 0;
+
+    printf("%u instances, %.1f pixel error, 1080 lines, 60 degrees\n", instance_count, pixel_error);
+    printf("  level  triangles     error  instances\n");
+    for (unsigned int level = 0; level < selector.GetLevelCount(); level++)
+    {
+        printf("  %5u  %9u  %8.5f  %9u\n", level, selector.GetLevelTriangleCount(level),
+               selector.GetLevelError(level), selector.GetInstanceCount(level));
+        listed += selector.GetInstanceCount(level);
+    }
+
+    printf("Triangles: %llu without LODs, %llu with (%.1f%%)\n", full, selected, 100.0 * selected / full);
+    printf("Select: best %.3f ms, mean %.3f ms, %.1f ns per instance\n",
+           best, total / runs, best * 1e6 / instance_count);
+
+    return listed == instance_count ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+
+    VBM morph frame benchmark
+
+    Builds a synthetic morph animation, 1M vertices and 100 frames by
+    default. In the first half only an arm moves, and the whole body breathes
+    in the second half. It compresses the animation with VBMMorphFrames,
+    round trips it through a VBM file, and reports memory use and error. It
+    then times blending at fractional times against a plain lerp of two
+    uncompressed frames.
+
+    Build from the opengl_redbook directory:
+
+        g++ -O2 -Iinclude -I../opengl-samels/external/glfw-3.1.1/include
+            tools/vbmmorphbench/vbmmorphbench.cpp vermilion/vbmmorph.cpp
+            vermilion/vbmsection.cpp
+
+    Usage: vbmmorphbench [directory] [vertices] [frames] [runs]
+
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "vbm.h"
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+static double elapsed_ms(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// Sphere of vertex_count points. The cap above y = 0.6 is the arm.
+static void make_pose(std::vector<VBM_VEC3F>& pose, unsigned int vertex_count, unsigned int frame, unsigned int frame_count)
+{
+    const float golden = 2.39996323f;
+    const float t = float(frame) / float(frame_count);
+    const float swing = 0.3f * sinf(t * 6.2831853f * 2.0f);
+    const float breathe = frame >= frame_count / 2 ? 0.05f * sinf(t * 6.2831853f * 4.0f) : 0.0f;
+
+    pose.resize(vertex_count);
+
+    for (unsigned int i = 0; i < vertex_count; i++)
+    {
+        float y = 1.0f - 2.0f * (i + 0.5f) / vertex_count;
+        float r = sqrtf(1.0f - y * y);
+        float x = r * cosf(golden * i);
+        float z = r * sinf(golden * i);
+
+        if (frame != 0 && y > 0.6f)
+        {
+            // Rotate the arm about z, more towards its tip
+            float a = swing * (y - 0.6f) * 2.5f;
+            float nx = x * cosf(a) - (y - 0.6f) * sinf(a);
+            float ny = x * sinf(a) + (y - 0.6f) * cosf(a) + 0.6f;
+            x = nx;
+            y = ny;
+        }
+
+        float s = 1.0f + breathe;
+        pose[i].x = x * s;
+        pose[i].y = y * s;
+        pose[i].z = z * s;
+    }
+}
+
+static float max_difference(const std::vector<VBM_VEC3F>& a, const std::vector<VBM_VEC3F>& b)
+{
+    float largest = 0.0f;
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        largest = fmaxf(largest, fabsf(a[i].x - b[i].x));
+        largest = fmaxf(largest, fabsf(a[i].y - b[i].y));
+        largest = fmaxf(largest, fabsf(a[i].z - b[i].z));
+    }
+
+    return largest;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * directory = argc > 1 ? argv[1] : ".";
+    unsigned int vertex_count = argc > 2 ? atoi(argv[2]) : 1000000;
+    unsigned int frame_count = argc > 3 ? atoi(argv[3]) : 100;
+    int runs = argc > 4 ? atoi(argv[4]) : 50;
+
+    if (vertex_count == 0 || frame_count < 2 || runs <= 0)
+    {
+        printf("Usage: vbmmorphbench [directory] [vertices] [frames] [runs]\n");
+        return 1;
+    }
+
+    VBMMorphFrames morph;
+    std::vector<VBM_VEC3F> pose;
+    unsigned int f;
+
+    bench_clock::time_point start = bench_clock::now();
+
+    make_pose(pose, vertex_count, 0, frame_count);
+    morph.SetBasePose(&pose[0], vertex_count);
+
+    for (f = 0; f < frame_count; f++)
+    {
+        make_pose(pose, vertex_count, f, frame_count);
+        morph.AddFrame(&pose[0], 1e-6f);
+    }
+
+    double encode_ms = elapsed_ms(start);
+
+    // Round trip through a file, the chain goes after the body of a VBM
+    std::string filename = std::string(directory) + "/vbmmorphbench.vbm";
+    VBM_HEADER header;
+    FILE * file = fopen(filename.c_str(), "wb");
+
+    memset(&header, 0, sizeof(header));
+    header.magic = 0x53424D31;
+    header.size = sizeof(header);
+    header.num_frames = frame_count;
+    header.num_vertices = vertex_count;
+
+    if (file == NULL || fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        printf("Could not write %s\n", filename.c_str());
+        return 1;
+    }
+    fclose(file);
+
+    VBMMorphFrames loaded;
+    bool round_trip = morph.AppendToVBM(filename.c_str()) && loaded.LoadFromVBM(filename.c_str()) &&
+                      loaded.GetStorageSize() == morph.GetStorageSize();
+    remove(filename.c_str());
+
+    unsigned int sparse_frames = 0;
+    float quantization = 0.0f;
+
+    for (f = 0; f < frame_count; f++)
+    {
+        sparse_frames += loaded.IsFrameSparse(f) ? 1 : 0;
+        quantization = fmaxf(quantization, loaded.GetFrameError(f));
+    }
+
+    printf("%u vertices, %u frames (%u sparse), encoded in %.0f ms, file round trip %s\n",
+           vertex_count, frame_count, sparse_frames, encode_ms, round_trip ? "ok" : "FAILED");
+    printf("Memory: %.1f MB as full frames, %.1f MB compressed (%.1f%%)\n",
+           morph.GetUncompressedSize() / (1024.0 * 1024.0), morph.GetStorageSize() / (1024.0 * 1024.0),
+           100.0 * morph.GetStorageSize() / morph.GetUncompressedSize());
+
+    // Blends must match the same blend of the original frames
+    std::vector<VBM_VEC3F> a, b, expected, blended(vertex_count);
+    const unsigned int checks[][2] = { { 0, 1 }, { 10, 11 }, { frame_count / 2 - 1, frame_count / 2 }, { frame_count - 2, frame_count - 1 } };
+    float error = 0.0f;
+
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++)
+    {
+        make_pose(a, vertex_count, checks[i][0], frame_count);
+        make_pose(b, vertex_count, checks[i][1], frame_count);
+        expected.resize(vertex_count);
+        for (unsigned int v = 0; v < vertex_count; v++)
+        {
+            expected[v].x = a[v].x * 0.75f + b[v].x * 0.25f;
+            expected[v].y = a[v].y * 0.75f + b[v].y * 0.25f;
+            expected[v].z = a[v].z * 0.75f + b[v].z * 0.25f;
+        }
+        loaded.Blend(checks[i][0], checks[i][1], 0.25f, &blended[0]);
+        error = fmaxf(error, max_difference(expected, blended));
+    }
+
+    bool accurate = error <= quantization + 1e-5f;
+
+    printf("Largest error %g, quantization step allows %g\n", error, quantization);
+
+    // Same blends from uncompressed frames
+    make_pose(a, vertex_count, 1, frame_count);
+    make_pose(b, vertex_count, 2, frame_count);
+
+    double best_lerp = 1e30;
+
+    for (int run = 0; run < runs; run++)
+    {
+        const float w = 0.37f;
+        start = bench_clock::now();
+        for (unsigned int v = 0; v < vertex_count; v++)
+        {
+            blended[v].x = a[v].x + (b[v].x - a[v].x) * w;
+            blended[v].y = a[v].y + (b[v].y - a[v].y) * w;
+            blended[v].z = a[v].z + (b[v].z - a[v].z) * w;
+        }
+        best_lerp = fmin(best_lerp, elapsed_ms(start));
+    }
+
+    // Sparse pairs in the first half of the animation, dense pairs in the second
+    const float times[] = { 1.37f, frame_count * 0.5f + 1.37f, 0.0f };
+    const char * names[] = { "sparse frames", "dense frames", "frame 0, no blend" };
+
+    printf("Blend of %u vertices, best of %d\n", vertex_count, runs);
+    printf("  %-28s %8.3f ms  %8.1f Mvertices/s\n", "uncompressed lerp", best_lerp, vertex_count / best_lerp / 1000.0);
+
+    for (int i = 0; i < 3; i++)
+    {
+        double best = 1e30;
+
+        for (int run = 0; run < runs; run++)
+        {
+            start = bench_clock::now();
+            loaded.Blend(times[i], &blended[0]);
+            best = fmin(best, elapsed_ms(start));
+        }
+
+        printf("  %-28s %8.3f ms  %8.1f Mvertices/s\n", names[i], best, vertex_count / best / 1000.0);
+    }
+
+    return round_trip && accurate ? 0 : 1;
+}
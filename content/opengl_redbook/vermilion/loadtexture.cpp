@@ -10,6 +10,8 @@
 #include <cstdint>
 
 extern "C" void vglLoadDDS(const char* filename, vglImageData* image);
+extern "C" GLboolean vglLoadDDSLevels(const char* filename, vglImageData* image, GLint firstLevel, GLint levelCount);
+extern "C" void vglUnloadDDS(vglImageData* image);
 
 void vglLoadImage(const char* filename, vglImageData* image)
 {
@@ -17,9 +19,14 @@ void vglLoadImage(const char* filename, vglImageData* image)
     vglLoadDDS(filename, image);
 }
 
+GLboolean vglLoadImageLevels(const char* filename, vglImageData* image, GLint firstLevel, GLint levelCount)
+{
+    return vglLoadDDSLevels(filename, image, firstLevel, levelCount);
+}
+
 void vglUnloadImage(vglImageData* image)
 {
-    delete [] reinterpret_cast<uint8_t *>(image->mip[0].data);
+    vglUnloadDDS(image);
 }
 
 GLuint vglLoadTexture(const char* filename,
@@ -0,0 +1,137 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif /* _MSC_VER */
+
+#include "vbm.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+VBMLODSelector::VBMLODSelector(void)
+    : m_eye(0.0f, 0.0f, 0.0f),
+      m_pixels_per_unit(1.0f),
+      m_max_pixel_error(1.0f)
+{
+    memset(&m_footer, 0, sizeof(m_footer));
+    m_first_instance.assign(2, 0);
+}
+
+bool VBMLODSelector::LoadFromVBM(const char * filename)
+{
+    FILE * f = fopen(filename, "rb");
+    VBM_LOD_FOOTER footer;
+    long start;
+    bool loaded = false;
+
+    m_lods.clear();
+    m_indices.clear();
+    memset(&m_footer, 0, sizeof(m_footer));
+
+    if (f == NULL)
+        return false;
+
+    // Files written without -lod have no such section
+    start = vbmFindSection(f, VBM_LOD_MAGIC, &footer, sizeof(footer));
+
+    if (start < 0 || footer.num_lods > 255 || fseek(f, start, SEEK_SET) != 0)
+        goto done_close_file;
+
+    m_lods.resize(footer.num_lods);
+    m_indices.resize(footer.num_indices);
+
+    if ((footer.num_lods && fread(&m_lods[0], sizeof(VBM_LOD_HEADER), footer.num_lods, f) != footer.num_lods) ||
+        (footer.num_indices && fread(&m_indices[0], sizeof(unsigned int), footer.num_indices, f) != footer.num_indices))
+    {
+        goto done_close_file;
+    }
+
+    for (unsigned int i = 0; i < footer.num_lods; i++)
+    {
+        if (m_lods[i].first > footer.num_indices || m_lods[i].count > footer.num_indices - m_lods[i].first)
+            goto done_close_file;
+    }
+
+    m_footer = footer;
+    loaded = true;
+
+done_close_file:
+    fclose(f);
+
+    if (!loaded)
+    {
+        m_lods.clear();
+        m_indices.clear();
+    }
+
+    m_first_instance.assign(m_lods.size() + 2, 0);
+    UpdateDistances();
+
+    return loaded;
+}
+
+void VBMLODSelector::SetCamera(const vmath::vec3 & eye, float fovy, float viewport_height, float max_pixel_error)
+{
+    m_eye = eye;
+    m_pixels_per_unit = 0.5f * viewport_height / tanf(vmath::radians(0.5f * fovy));
+    m_max_pixel_error = max_pixel_error > 0.0f ? max_pixel_error : 1.0f;
+
+    UpdateDistances();
+}
+
+// A level of error e covers e * m_pixels_per_unit / d pixels at distance d from
+// the eye, so it may be used once the object's bounding sphere is at least
+// e * m_pixels_per_unit / m_max_pixel_error away.
+void VBMLODSelector::UpdateDistances(void)
+{
+    m_min_distance2.resize(m_lods.size());
+
+    for (size_t i = 0; i < m_lods.size(); i++)
+    {
+        float distance = m_lods[i].error * m_pixels_per_unit / m_max_pixel_error + m_footer.radius;
+        m_min_distance2[i] = distance * distance;
+    }
+}
+
+void VBMLODSelector::Select(const vmath::vec3 * positions, unsigned int count)
+{
+    const unsigned int num_levels = (unsigned int)m_lods.size() + 1;
+    const vmath::vec3 eye = m_eye - vmath::vec3(m_footer.center.x, m_footer.center.y, m_footer.center.z);
+    unsigned int i;
+
+    m_level.resize(count);
+    m_instances.resize(count);
+    m_first_instance.assign(num_levels + 1, 0);
+
+    for (i = 0; i < count; i++)
+    {
+        const vmath::vec3 d = positions[i] - eye;
+        const float distance2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        unsigned int level = 0;
+
+        while (level < num_levels - 1 && distance2 >= m_min_distance2[level])
+            level++;
+
+        m_level[i] = (unsigned char)level;
+        m_first_instance[level + 1]++;
+    }
+
+    for (i = 1; i <= num_levels; i++)
+        m_first_instance[i] += m_first_instance[i - 1];
+
+    // Counting sort, so that each level's instances stay in their original order
+    std::vector<unsigned int> next(m_first_instance.begin(), m_first_instance.end() - 1);
+
+    for (i = 0; i < count; i++)
+        m_instances[next[m_level[i]]++] = i;
+}
+
+unsigned long long VBMLODSelector::GetSelectedTriangleCount(void) const
+{
+    unsigned long long triangles = 0;
+
+    for (unsigned int level = 0; level < GetLevelCount(); level++)
+        triangles += (unsigned long long)GetInstanceCount(level) * GetLevelTriangleCount(level);
+
+    return triangles;
+}
@@ -0,0 +1,376 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif /* _MSC_VER */
+
+#include "vbm.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VBM_MORPH_SSE2
+#include <emmintrin.h>
+#endif
+
+// Bytes of offset data of a frame, padded so that the next one starts aligned
+static size_t vbm_FrameSize(const VBM_MORPH_FRAME_HEADER& frame)
+{
+    size_t size = frame.count * 3 * sizeof(short);
+
+    if (frame.flags & VBM_MORPH_FRAME_SPARSE)
+        size += frame.count * sizeof(unsigned int);
+
+    return (size + 3) & ~(size_t)3;
+}
+
+// out = base + qa * sa (+ qb * sb), over whole vertices. The scales already
+// include the blend weights.
+template <bool two_frames>
+static void vbm_BlendDense(const float * base,
+                           const short * qa, const float sa[3],
+                           const short * qb, const float sb[3],
+                           float * out, size_t vertex_count)
+{
+    size_t v = 0;
+
+#ifdef VBM_MORPH_SSE2
+    // Four vertices are twelve floats, so the x, y, z pattern of the scales
+    // repeats every three registers
+    const __m128 a0 = _mm_setr_ps(sa[0], sa[1], sa[2], sa[0]);
+    const __m128 a1 = _mm_setr_ps(sa[1], sa[2], sa[0], sa[1]);
+    const __m128 a2 = _mm_setr_ps(sa[2], sa[0], sa[1], sa[2]);
+    const __m128 b0 = two_frames ? _mm_setr_ps(sb[0], sb[1], sb[2], sb[0]) : _mm_setzero_ps();
+    const __m128 b1 = two_frames ? _mm_setr_ps(sb[1], sb[2], sb[0], sb[1]) : _mm_setzero_ps();
+    const __m128 b2 = two_frames ? _mm_setr_ps(sb[2], sb[0], sb[1], sb[2]) : _mm_setzero_ps();
+
+    for (; v + 4 <= vertex_count; v += 4)
+    {
+        const size_t k = v * 3;
+        __m128i lo = _mm_loadu_si128((const __m128i *)(qa + k));
+        __m128i hi = _mm_loadl_epi64((const __m128i *)(qa + k + 8));
+        __m128 r0 = _mm_add_ps(_mm_loadu_ps(base + k), _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), a0));
+        __m128 r1 = _mm_add_ps(_mm_loadu_ps(base + k + 4), _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), a1));
+        __m128 r2 = _mm_add_ps(_mm_loadu_ps(base + k + 8), _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), a2));
+
+        if (two_frames)
+        {
+            lo = _mm_loadu_si128((const __m128i *)(qb + k));
+            hi = _mm_loadl_epi64((const __m128i *)(qb + k + 8));
+            r0 = _mm_add_ps(r0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), b0));
+            r1 = _mm_add_ps(r1, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), b1));
+            r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), b2));
+        }
+
+        _mm_storeu_ps(out + k, r0);
+        _mm_storeu_ps(out + k + 4, r1);
+        _mm_storeu_ps(out + k + 8, r2);
+    }
+#endif /* VBM_MORPH_SSE2 */
+
+    for (; v < vertex_count; v++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            const size_t k = v * 3 + c;
+            float r = base[k] + qa[k] * sa[c];
+            if (two_frames)
+                r += qb[k] * sb[c];
+            out[k] = r;
+        }
+    }
+}
+
+// out += q * s at the vertices listed by the frame
+static void vbm_BlendSparse(const unsigned int * index, const short * q, unsigned int count, const float s[3], float * out)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        float * p = out + index[i] * 3;
+
+        p[0] += q[i * 3 + 0] * s[0];
+        p[1] += q[i * 3 + 1] * s[1];
+        p[2] += q[i * 3 + 2] * s[2];
+    }
+}
+
+VBMMorphFrames::VBMMorphFrames(void)
+{
+}
+
+void VBMMorphFrames::SetBasePose(const VBM_VEC3F * positions, unsigned int vertex_count)
+{
+    m_base.assign(positions, positions + vertex_count);
+    m_frames.clear();
+    m_data.clear();
+}
+
+void VBMMorphFrames::AddFrame(const VBM_VEC3F * positions, float tolerance)
+{
+    const size_t vertex_count = m_base.size();
+    VBM_MORPH_FRAME_HEADER frame;
+    float range[3] = { 0.0f, 0.0f, 0.0f };
+    unsigned int moving = 0;
+    size_t v;
+    int c;
+
+    for (v = 0; v < vertex_count; v++)
+    {
+        const float d[3] = { positions[v].x - m_base[v].x, positions[v].y - m_base[v].y, positions[v].z - m_base[v].z };
+
+        if (fabsf(d[0]) <= tolerance && fabsf(d[1]) <= tolerance && fabsf(d[2]) <= tolerance)
+            continue;
+
+        for (c = 0; c < 3; c++)
+            range[c] = fabsf(d[c]) > range[c] ? fabsf(d[c]) : range[c];
+        moving++;
+    }
+
+    // Sparse costs an index on top of the offsets of each moving vertex
+    frame.flags = (size_t)moving * 10 < vertex_count * 6 ? VBM_MORPH_FRAME_SPARSE : 0;
+    frame.count = frame.flags ? moving : (unsigned int)vertex_count;
+    frame.offset = (unsigned int)m_data.size();
+    frame.scale.x = range[0] / 32767.0f;
+    frame.scale.y = range[1] / 32767.0f;
+    frame.scale.z = range[2] / 32767.0f;
+
+    const float scale[3] = { frame.scale.x, frame.scale.y, frame.scale.z };
+
+    m_data.resize(m_data.size() + vbm_FrameSize(frame), 0);
+
+    unsigned int * index = (unsigned int *)&m_data[frame.offset];
+    short * q = (short *)(frame.flags ? (unsigned char *)(index + frame.count) : (unsigned char *)index);
+    unsigned int stored = 0;
+
+    for (v = 0; v < vertex_count; v++)
+    {
+        const float d[3] = { positions[v].x - m_base[v].x, positions[v].y - m_base[v].y, positions[v].z - m_base[v].z };
+        const bool moves = fabsf(d[0]) > tolerance || fabsf(d[1]) > tolerance || fabsf(d[2]) > tolerance;
+
+        if (frame.flags)
+        {
+            if (!moves)
+                continue;
+            index[stored] = (unsigned int)v;
+        }
+        else
+        {
+            stored = (unsigned int)v;
+        }
+
+        for (c = 0; c < 3; c++)
+            q[stored * 3 + c] = moves && scale[c] > 0.0f ? (short)floorf(d[c] / scale[c] + 0.5f) : 0;
+        stored++;
+    }
+
+    m_frames.push_back(frame);
+}
+
+size_t VBMMorphFrames::GetStorageSize(void) const
+{
+    return m_base.size() * sizeof(VBM_VEC3F) +
+           m_frames.size() * sizeof(VBM_MORPH_FRAME_HEADER) +
+           m_data.size();
+}
+
+float VBMMorphFrames::GetFrameError(unsigned int frame) const
+{
+    if (frame >= m_frames.size())
+        return 0.0f;
+
+    const VBM_VEC3F& scale = m_frames[frame].scale;
+    float largest = scale.x > scale.y ? scale.x : scale.y;
+
+    return 0.5f * (largest > scale.z ? largest : scale.z);
+}
+
+void VBMMorphFrames::Blend(unsigned int frame_a, unsigned int frame_b, float weight, VBM_VEC3F * positions) const
+{
+    const size_t vertex_count = m_base.size();
+    const VBM_MORPH_FRAME_HEADER * dense[2] = { NULL, NULL };
+    const VBM_MORPH_FRAME_HEADER * sparse[2] = { NULL, NULL };
+    float dense_scale[2][3];
+    float sparse_scale[2][3];
+    int num_dense = 0;
+    int num_sparse = 0;
+
+    if (frame_a >= m_frames.size() || frame_b >= m_frames.size())
+        return;
+
+    if (frame_a == frame_b)
+        weight = 0.0f;
+
+    const unsigned int frames[2] = { frame_a, frame_b };
+    const float weights[2] = { 1.0f - weight, weight };
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (weights[i] == 0.0f)
+            continue;
+
+        const VBM_MORPH_FRAME_HEADER& frame = m_frames[frames[i]];
+        float * s = frame.flags ? sparse_scale[num_sparse] : dense_scale[num_dense];
+
+        s[0] = frame.scale.x * weights[i];
+        s[1] = frame.scale.y * weights[i];
+        s[2] = frame.scale.z * weights[i];
+
+        if (frame.flags)
+            sparse[num_sparse++] = &frame;
+        else
+            dense[num_dense++] = &frame;
+    }
+
+    const float * base = &m_base[0].x;
+    float * out = &positions[0].x;
+
+    if (num_dense == 2)
+    {
+        vbm_BlendDense<true>(base, (const short *)&m_data[dense[0]->offset], dense_scale[0],
+                             (const short *)&m_data[dense[1]->offset], dense_scale[1], out, vertex_count);
+    }
+    else if (num_dense == 1)
+    {
+        vbm_BlendDense<false>(base, (const short *)&m_data[dense[0]->offset], dense_scale[0],
+                              NULL, NULL, out, vertex_count);
+    }
+    else if (out != base)
+    {
+        memcpy(out, base, vertex_count * sizeof(VBM_VEC3F));
+    }
+
+    for (int i = 0; i < num_sparse; i++)
+    {
+        const unsigned int * index = (const unsigned int *)&m_data[sparse[i]->offset];
+        vbm_BlendSparse(index, (const short *)(index + sparse[i]->count), sparse[i]->count, sparse_scale[i], out);
+    }
+}
+
+void VBMMorphFrames::Blend(float time, VBM_VEC3F * positions) const
+{
+    const float frame_count = (float)m_frames.size();
+
+    if (m_frames.empty())
+        return;
+
+    time = fmodf(time, frame_count);
+    if (time < 0.0f)
+        time += frame_count;
+
+    unsigned int frame_a = (unsigned int)time;
+
+    if (frame_a >= m_frames.size())
+        frame_a = 0;
+
+    Blend(frame_a, (frame_a + 1) % m_frames.size(), time - (float)frame_a, positions);
+}
+
+bool VBMMorphFrames::LoadFromVBM(const char * filename)
+{
+    FILE * f = fopen(filename, "rb");
+    VBM_MORPH_FOOTER footer;
+    long start;
+    bool loaded = false;
+
+    m_base.clear();
+    m_frames.clear();
+    m_data.clear();
+
+    if (f == NULL)
+        return false;
+
+    start = vbmFindSection(f, VBM_MORPH_MAGIC, &footer, sizeof(footer));
+
+    if (start < 0 || footer.num_vertices == 0 || fseek(f, start, SEEK_SET) != 0)
+        goto done_close_file;
+
+    m_base.resize(footer.num_vertices);
+    m_frames.resize(footer.num_frames);
+    m_data.resize(footer.data_size);
+
+    if (fread(&m_base[0], sizeof(VBM_VEC3F), footer.num_vertices, f) != footer.num_vertices ||
+        (footer.num_frames && fread(&m_frames[0], sizeof(VBM_MORPH_FRAME_HEADER), footer.num_frames, f) != footer.num_frames) ||
+        (footer.data_size && fread(&m_data[0], 1, footer.data_size, f) != footer.data_size))
+    {
+        goto done_close_file;
+    }
+
+    // Blend trusts the offsets and the vertex indices, so check them all here
+    for (unsigned int i = 0; i < footer.num_frames; i++)
+    {
+        const VBM_MORPH_FRAME_HEADER& frame = m_frames[i];
+
+        if (frame.count > footer.num_vertices || (frame.offset & 3) != 0 ||
+            frame.offset > footer.data_size || vbm_FrameSize(frame) > footer.data_size - frame.offset)
+        {
+            goto done_close_file;
+        }
+
+        if ((frame.flags & VBM_MORPH_FRAME_SPARSE) == 0 && frame.count != footer.num_vertices)
+            goto done_close_file;
+
+        if (frame.flags & VBM_MORPH_FRAME_SPARSE)
+        {
+            const unsigned int * index = (const unsigned int *)&m_data[frame.offset];
+
+            for (unsigned int v = 0; v < frame.count; v++)
+            {
+                if (index[v] >= footer.num_vertices)
+                    goto done_close_file;
+            }
+        }
+    }
+
+    loaded = true;
+
+done_close_file:
+    fclose(f);
+
+    if (!loaded)
+    {
+        m_base.clear();
+        m_frames.clear();
+        m_data.clear();
+    }
+
+    return loaded;
+}
+
+// Appends the frames to the end of an existing VBM and flags its header
+bool VBMMorphFrames::AppendToVBM(const char * filename) const
+{
+    FILE * f = fopen(filename, "r+b");
+    VBM_HEADER header;
+    VBM_MORPH_FOOTER footer;
+    bool written = false;
+
+    if (f == NULL)
+        return false;
+
+    if (m_base.empty() || fread(&header, sizeof(header), 1, f) != 1)
+        goto done_close_file;
+
+    header.flags |= VBM_FLAG_HAS_MORPH_FRAMES;
+
+    footer.magic = VBM_MORPH_MAGIC;
+    footer.num_frames = (unsigned int)m_frames.size();
+    footer.num_vertices = (unsigned int)m_base.size();
+    footer.data_size = (unsigned int)m_data.size();
+
+    if (fseek(f, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, f) != 1 ||
+        fseek(f, 0, SEEK_END) != 0 ||
+        fwrite(&m_base[0], sizeof(VBM_VEC3F), m_base.size(), f) != m_base.size() ||
+        (!m_frames.empty() && fwrite(&m_frames[0], sizeof(VBM_MORPH_FRAME_HEADER), m_frames.size(), f) != m_frames.size()) ||
+        (!m_data.empty() && fwrite(&m_data[0], 1, m_data.size(), f) != m_data.size()) ||
+        fwrite(&footer, sizeof(footer), 1, f) != 1)
+    {
+        goto done_close_file;
+    }
+
+    written = true;
+
+done_close_file:
+    fclose(f);
+
+    return written;
+}
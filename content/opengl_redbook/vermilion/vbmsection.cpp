@@ -0,0 +1,76 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif /* _MSC_VER */
+
+#include "vbm.h"
+
+#include <cstring>
+
+// Reads the footer of size footer_size ending at end, if it starts with magic
+static bool vbm_ReadFooter(FILE * f, long end, unsigned int magic, void * footer, size_t footer_size)
+{
+    unsigned int found;
+
+    if (end < (long)footer_size ||
+        fseek(f, end - (long)footer_size, SEEK_SET) != 0 ||
+        fread(&found, sizeof(found), 1, f) != 1 ||
+        found != magic)
+    {
+        return false;
+    }
+
+    return fseek(f, end - (long)footer_size, SEEK_SET) == 0 &&
+           fread(footer, footer_size, 1, f) == 1;
+}
+
+long vbmFindSection(FILE * f, unsigned int magic, void * footer, size_t footer_size)
+{
+    VBM_LOD_FOOTER lod;
+    VBM_MORPH_FOOTER morph;
+    const void * found;
+    size_t found_size;
+    unsigned long long payload;
+    long end;
+
+    if (fseek(f, 0, SEEK_END) != 0 || (end = ftell(f)) < (long)sizeof(VBM_HEADER))
+        return -1;
+
+    // Walk back over the sections until the one asked for turns up
+    for (;;)
+    {
+        if (vbm_ReadFooter(f, end, VBM_LOD_MAGIC, &lod, sizeof(lod)))
+        {
+            payload = (unsigned long long)lod.num_lods * sizeof(VBM_LOD_HEADER) +
+                      (unsigned long long)lod.num_indices * sizeof(unsigned int);
+            found = &lod;
+            found_size = sizeof(lod);
+        }
+        else if (vbm_ReadFooter(f, end, VBM_MORPH_MAGIC, &morph, sizeof(morph)))
+        {
+            payload = (unsigned long long)morph.num_vertices * sizeof(VBM_VEC3F) +
+                      (unsigned long long)morph.num_frames * sizeof(VBM_MORPH_FRAME_HEADER) +
+                      morph.data_size;
+            found = &morph;
+            found_size = sizeof(morph);
+        }
+        else
+        {
+            return -1;
+        }
+
+        end -= (long)found_size;
+
+        if (end < (long)sizeof(VBM_HEADER) || payload > (unsigned long long)(end - (long)sizeof(VBM_HEADER)))
+            return -1;
+
+        end -= (long)payload;
+
+        if (*(const unsigned int *)found == magic)
+        {
+            if (footer_size != found_size)
+                return -1;
+            memcpy(footer, found, found_size);
+            return end;
+        }
+    }
+}
@@ -16,6 +16,17 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
 
 enum DDS_FORMAT
 {
@@ -350,14 +361,14 @@ static const DDS_FORMAT_GL_INFO gl_info_table[] =
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_BC5_UNORM
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_BC5_SNORM
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_B5G6R5_UNORM
-    { GL_RGBA,              GL_UNSIGNED_SHORT,  GL_RGB5_A1,         GL_RED,         GL_GREEN,       GL_BLUE,        GL_ALPHA            },      // DDS_FORMAT_B5G5R5A1_UNORM
-    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_RGBA8,           GL_BLUE,        GL_GREEN,       GL_RED,         GL_ALPHA            },      // DDS_FORMAT_B8G8R8A8_UNORM
-    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_RGBA8,           GL_RED,         GL_GREEN,       GL_BLUE,        GL_ONE              },      // DDS_FORMAT_B8G8R8X8_UNORM
+    { GL_RGBA,              GL_UNSIGNED_SHORT,  GL_RGB5_A1,         GL_RED,         GL_GREEN,       GL_BLUE,        GL_ALPHA,   16      },      // DDS_FORMAT_B5G5R5A1_UNORM
+    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_RGBA8,           GL_BLUE,        GL_GREEN,       GL_RED,         GL_ALPHA,   32      },      // DDS_FORMAT_B8G8R8A8_UNORM
+    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_RGBA8,           GL_RED,         GL_GREEN,       GL_BLUE,        GL_ONE,     32      },      // DDS_FORMAT_B8G8R8X8_UNORM
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_R10G10B10_XR_BIAS_A2_UNORM
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_B8G8R8A8_TYPELESS
-    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_SRGB8_ALPHA8,    GL_BLUE,        GL_GREEN,       GL_RED,         GL_ALPHA            },      // DDS_FORMAT_B8G8R8A8_UNORM_SRGB
+    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_SRGB8_ALPHA8,    GL_BLUE,        GL_GREEN,       GL_RED,         GL_ALPHA,   32      },      // DDS_FORMAT_B8G8R8A8_UNORM_SRGB
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_B8G8R8X8_TYPELESS
-    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_SRGB8_ALPHA8,    GL_BLUE,        GL_GREEN,       GL_RED,         GL_ONE              },      // DDS_FORMAT_B8G8R8X8_UNORM_SRGB
+    { GL_RGBA,              GL_UNSIGNED_BYTE,   GL_SRGB8_ALPHA8,    GL_BLUE,        GL_GREEN,       GL_RED,         GL_ONE,     32      },      // DDS_FORMAT_B8G8R8X8_UNORM_SRGB
     { GL_NONE,              GL_NONE,            GL_NONE,            GL_ZERO,        GL_ZERO,        GL_ZERO,        GL_ZERO             },      // DDS_FORMAT_BC6H_TYPELESS
     { GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB, GL_NONE, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB, GL_RED, GL_GREEN, GL_BLUE,     GL_ONE          },      // DDS_FORMAT_BC6H_UF16
     { GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB, GL_NONE, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB, GL_RED, GL_GREEN, GL_BLUE, GL_ONE         },   // DDS_FORMAT_BC6H_SF16
@@ -493,6 +504,12 @@ static GLsizei vgl_GetDDSStride(const DDS_FILE_HEADER& header, GLsizei width)
             return (format.bits_per_texel * width + 7) / 8;
         }
     }
+    else if (header.std_header.ddspf.dwFlags == DDS_DDPF_FOURCC)
+    {
+        // Same formats as vgl_DDSHeaderToImageDataHeader
+        if (header.std_header.ddspf.dwFourCC == 116)
+            return width * 16;
+    }
     else
     {
         switch (header.std_header.ddspf.dwFlags)
@@ -503,7 +520,10 @@ static GLsizei vgl_GetDDSStride(const DDS_FILE_HEADER& header, GLsizei width)
             case (DDS_DDPF_RGB | DDS_DDPF_ALPHAPIXELS):
                 return width * 4;
             case DDS_DDPF_ALPHA:
+            case DDS_DDPF_LUMINANCE:
                 return width;
+            case (DDS_DDPF_LUMINANCE | DDS_DDPF_ALPHA):
+                return width * 2;
             default:
                 break;
         }
@@ -512,6 +532,45 @@ static GLsizei vgl_GetDDSStride(const DDS_FILE_HEADER& header, GLsizei width)
     return 0;
 }
 
+// Bytes per 4x4 block of the block compressed formats, 0 for the others
+static GLsizei vgl_GetDDSBlockSize(const DDS_FILE_HEADER& header)
+{
+    if (header.std_header.ddspf.dwFlags != DDS_DDPF_FOURCC ||
+        header.std_header.ddspf.dwFourCC != DDS_FOURCC_DX10)
+    {
+        return 0;
+    }
+
+    switch (header.dxt10_header.format)
+    {
+        case DDS_FORMAT_BC1_TYPELESS:
+        case DDS_FORMAT_BC1_UNORM:
+        case DDS_FORMAT_BC1_UNORM_SRGB:
+        case DDS_FORMAT_BC4_TYPELESS:
+        case DDS_FORMAT_BC4_UNORM:
+        case DDS_FORMAT_BC4_SNORM:
+            return 8;
+        case DDS_FORMAT_BC2_TYPELESS:
+        case DDS_FORMAT_BC2_UNORM:
+        case DDS_FORMAT_BC2_UNORM_SRGB:
+        case DDS_FORMAT_BC3_TYPELESS:
+        case DDS_FORMAT_BC3_UNORM:
+        case DDS_FORMAT_BC3_UNORM_SRGB:
+        case DDS_FORMAT_BC5_TYPELESS:
+        case DDS_FORMAT_BC5_UNORM:
+        case DDS_FORMAT_BC5_SNORM:
+        case DDS_FORMAT_BC6H_TYPELESS:
+        case DDS_FORMAT_BC6H_UF16:
+        case DDS_FORMAT_BC6H_SF16:
+        case DDS_FORMAT_BC7_TYPELESS:
+        case DDS_FORMAT_BC7_UNORM:
+        case DDS_FORMAT_BC7_UNORM_SRGB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
 static GLenum vgl_GetTargetFromDDSHeader(const DDS_FILE_HEADER& header)
 {
     // If the DX10 header is present it's format should be non-zero (unless it's unknown)
@@ -567,83 +626,378 @@ static GLenum vgl_GetTargetFromDDSHeader(const DDS_FILE_HEADER& header)
     return GL_TEXTURE_2D;
 }
 
-extern "C"
+
+// Size of the file header, magic included
+static size_t vgl_GetDDSHeaderSize(const DDS_FILE_HEADER& header)
 {
+    size_t size = sizeof(header.magic) + sizeof(header.std_header);
 
-void vglLoadDDS(const char* filename, vglImageData* image)
+    if (header.std_header.ddspf.dwFlags == DDS_DDPF_FOURCC &&
+        header.std_header.ddspf.dwFourCC == DDS_FOURCC_DX10)
+    {
+        size += sizeof(header.dxt10_header);
+    }
+
+    return size;
+}
+
+// Fills in image from the header and points the mips into data, the bytes
+// following the header. Rejects anything data is too short to hold.
+static bool vgl_ParseDDS(const DDS_FILE_HEADER& header, const uint8_t* data, size_t dataSize, vglImageData* image)
 {
-    FILE* f;
+    if (header.magic != DDS_MAGIC ||
+        header.std_header.size != sizeof(header.std_header) ||
+        header.std_header.ddspf.dwSize != sizeof(header.std_header.ddspf))
+    {
+        return false;
+    }
 
-    memset(image, 0, sizeof(*image));
+    if (!vgl_DDSHeaderToImageDataHeader(header, image))
+        return false;
 
-    f = fopen(filename, "rb");
+    image->target = vgl_GetTargetFromDDSHeader(header);
 
-    if (f == NULL)
-        return;
+    if (image->target == GL_NONE)
+        return false;
 
-    DDS_FILE_HEADER file_header = { 0, };
+    // Beyond 64K texels on a side the sizes below could overflow
+    uint32_t width = header.std_header.width;
+    uint32_t height = header.std_header.height ? header.std_header.height : 1;
+    uint32_t depth = header.std_header.depth ? header.std_header.depth : 1;
+
+    if (width == 0 || width > 65536 || height > 65536 || depth > 65536)
+        return false;
+
+    if (image->target != GL_TEXTURE_3D)
+        depth = 1;
+
+    if (image->mipLevels == 0)
+        image->mipLevels = 1;
+
+    if (image->mipLevels > MAX_TEXTURE_MIPS)
+        return false;
+
+    // Faces of a cube map are slices too, as for glTexStorage3D
+    uint64_t slices = 1;
+
+    if (header.std_header.ddspf.dwFourCC == DDS_FOURCC_DX10 && header.dxt10_header.array_size > 1)
+        slices = header.dxt10_header.array_size;
+
+    if (image->target == GL_TEXTURE_CUBE_MAP || image->target == GL_TEXTURE_CUBE_MAP_ARRAY)
+        slices *= 6;
 
-    fread(&file_header, sizeof(file_header.magic) + sizeof(file_header.std_header), 1, f);
+    if (slices > 65536)
+        return false;
 
-    if (file_header.magic != DDS_MAGIC)
+    // Each slice holds all of its mips, one after the other
+    uint64_t sliceStride = 0;
+    uint64_t blockSize = (uint64_t)vgl_GetDDSBlockSize(header);
+
+    for (int level = 0; level < image->mipLevels; ++level)
     {
-        goto done_close_file;
+        uint64_t levelSize;
+
+        if (blockSize != 0)
+        {
+            // Compressed levels are whole 4x4 blocks, even the 2x2 and 1x1 ones
+            levelSize = blockSize * ((width + 3) / 4) * ((height + 3) / 4) * depth;
+        }
+        else
+        {
+            uint64_t stride = (uint64_t)vgl_GetDDSStride(header, (GLsizei)width);
+
+            if (stride == 0)
+                return false;
+
+            levelSize = stride * height * depth;
+        }
+
+        image->mip[level].data = const_cast<uint8_t*>(data) + sliceStride;
+        image->mip[level].width = (GLsizei)width;
+        image->mip[level].height = (GLsizei)height;
+        image->mip[level].depth = (GLsizei)depth;
+        image->mip[level].mipStride = (GLsizeiptr)levelSize;
+        sliceStride += levelSize;
+
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+        depth = depth > 1 ? depth >> 1 : 1;
     }
 
-    if (file_header.std_header.ddspf.dwFourCC == DDS_FOURCC_DX10)
+    if (sliceStride * slices > dataSize)
+        return false;
+
+    image->slices = (GLsizei)slices;
+    image->sliceStride = (GLsizeiptr)sliceStride;
+    image->totalDataSize = (GLsizeiptr)dataSize;
+
+    return true;
+}
+
+// Maps the whole file read only. size is 0 when the file cannot be mapped.
+static const uint8_t* vgl_MapFile(const char* filename, size_t* size)
+{
+    *size = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER fileSize;
+    void* view = NULL;
+
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && (uint64_t)fileSize.QuadPart <= (size_t)-1)
     {
-        fread(&file_header.dxt10_header, sizeof(file_header.dxt10_header), 1, f);
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (mapping != NULL)
+        {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
     }
 
-    if (!vgl_DDSHeaderToImageDataHeader(file_header, image))
-        goto done_close_file;
+    CloseHandle(file);
 
-    image->target = vgl_GetTargetFromDDSHeader(file_header);
+    if (view == NULL)
+        return NULL;
 
-    if (image->target == GL_NONE)
-        goto done_close_file;
+    *size = (size_t)fileSize.QuadPart;
+    return static_cast<const uint8_t*>(view);
+#else
+    int file = open(filename, O_RDONLY);
 
-    size_t current_pos = ftell(f);
-    size_t file_size;
-    fseek(f, 0, SEEK_END);
-    file_size = ftell(f);
-    fseek(f, (long)current_pos, SEEK_SET);
+    if (file < 0)
+        return NULL;
 
-    image->totalDataSize = file_size - current_pos;
-    image->mip[0].data = new uint8_t [image->totalDataSize];
+    struct stat info;
+    void* view = MAP_FAILED;
 
-    fread(image->mip[0].data, file_size - current_pos, 1, f);
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+        view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
 
-    int level;
-    GLubyte * ptr = reinterpret_cast<GLubyte*>(image->mip[0].data);
+    close(file);
 
-    int width = file_header.std_header.width;
-    int height = file_header.std_header.height;
-    int depth = file_header.std_header.depth;
+    if (view == MAP_FAILED)
+        return NULL;
 
-    image->sliceStride = 0;
+    *size = (size_t)info.st_size;
+    return static_cast<const uint8_t*>(view);
+#endif /* _WIN32 */
+}
 
-    if (image->mipLevels == 0)
+static void vgl_UnmapFile(const void* view, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(view);
+#else
+    munmap(const_cast<void*>(view), size);
+#endif /* _WIN32 */
+}
+
+// Reads the mapped pages of [begin, begin + size) from disk, if they are not in memory yet
+static void vgl_PrefetchRange(const uint8_t* begin, size_t size)
+{
+    const size_t page = 4096;
+
+    if (size == 0)
+        return;
+
+#ifndef _WIN32
+    uintptr_t first = reinterpret_cast<uintptr_t>(begin) & ~(uintptr_t)(page - 1);
+    madvise(reinterpret_cast<void*>(first), reinterpret_cast<uintptr_t>(begin) + size - first, MADV_WILLNEED);
+#endif /* _WIN32 */
+
+    volatile uint8_t sink = 0;
+
+    for (size_t offset = 0; offset < size; offset += page)
+        sink ^= begin[offset];
+    sink ^= begin[size - 1];
+    (void)sink;
+}
+
+// Pages in one level of every slice
+static void vgl_PrefetchLevel(const vglImageData* image, GLint level)
+{
+    const uint8_t* data = static_cast<const uint8_t*>(image->mip[level].data);
+
+    for (GLsizei slice = 0; slice < image->slices; ++slice)
+        vgl_PrefetchRange(data + (size_t)image->sliceStride * slice, (size_t)image->mip[level].mipStride);
+}
+
+// Clamps [*firstLevel, *firstLevel + *levelCount) to the levels of the image.
+// A levelCount of 0 or less means all levels from firstLevel on.
+static bool vgl_ClampLevels(const vglImageData* image, GLint* firstLevel, GLint* levelCount)
+{
+    if (*firstLevel < 0)
+        *firstLevel = 0;
+
+    if (*firstLevel >= image->mipLevels)
+        return false;
+
+    if (*levelCount <= 0 || *levelCount > image->mipLevels - *firstLevel)
+        *levelCount = image->mipLevels - *firstLevel;
+
+    return true;
+}
+
+// Reads the file with stdio, for files that cannot be mapped
+static bool vgl_ReadDDS(const char* filename, vglImageData* image)
+{
+    FILE* f = fopen(filename, "rb");
+
+    if (f == NULL)
+        return false;
+
+    DDS_FILE_HEADER file_header = { 0, };
+    bool loaded = false;
+    size_t headerSize = sizeof(file_header.magic) + sizeof(file_header.std_header);
+    long fileSize = -1;
+    uint8_t* data = NULL;
+
+    if (fread(&file_header, headerSize, 1, f) != 1)
+        goto done_close_file;
+
+    if (vgl_GetDDSHeaderSize(file_header) > headerSize)
     {
-        image->mipLevels = 1;
+        if (fread(&file_header.dxt10_header, sizeof(file_header.dxt10_header), 1, f) != 1)
+            goto done_close_file;
+        headerSize += sizeof(file_header.dxt10_header);
     }
 
-    for (level = 0; level < image->mipLevels; ++level)
+    if (fseek(f, 0, SEEK_END) != 0 || (fileSize = ftell(f)) < (long)headerSize || fseek(f, (long)headerSize, SEEK_SET) != 0)
+        goto done_close_file;
+
+    data = new uint8_t [fileSize - headerSize + 1];
+
+    if (fread(data, 1, fileSize - headerSize, f) != (size_t)(fileSize - headerSize) ||
+        !vgl_ParseDDS(file_header, data, fileSize - headerSize, image))
     {
-        image->mip[level].data = ptr;
-        image->mip[level].width = width;
-        image->mip[level].height = height;
-        image->mip[level].depth = depth;
-        image->mip[level].mipStride = vgl_GetDDSStride(file_header, width) * height;
-        image->sliceStride += image->mip[level].mipStride;
-        ptr += image->mip[level].mipStride;
-        width >>= 1;
-        height >>= 1;
-        depth >>= 1;
+        delete [] data;
+        goto done_close_file;
     }
 
+    image->storage = data;
+    loaded = true;
+
 done_close_file:
     fclose(f);
+    if (!loaded)
+        memset(image, 0, sizeof(*image));
+    return loaded;
+}
+
+// Worker of vglStreamImageLevels
+struct vgl_ImageStream
+{
+    std::thread             thread;
+};
+
+extern "C"
+{
+
+GLboolean vglLoadDDSLevels(const char* filename, vglImageData* image, GLint firstLevel, GLint levelCount)
+{
+    memset(image, 0, sizeof(*image));
+
+    size_t fileSize;
+    const uint8_t* file = vgl_MapFile(filename, &fileSize);
+
+    if (file == NULL)
+        return vgl_ReadDDS(filename, image) ? GL_TRUE : GL_FALSE;
+
+    DDS_FILE_HEADER file_header = { 0, };
+    size_t headerSize = sizeof(file_header.magic) + sizeof(file_header.std_header);
+
+    if (fileSize >= headerSize)
+    {
+        memcpy(&file_header, file, headerSize);
+        headerSize = vgl_GetDDSHeaderSize(file_header);
+    }
+
+    if (fileSize < headerSize)
+    {
+        vgl_UnmapFile(file, fileSize);
+        return GL_FALSE;
+    }
+
+    memcpy(&file_header, file, headerSize);
+
+    if (!vgl_ParseDDS(file_header, file + headerSize, fileSize - headerSize, image))
+    {
+        vgl_UnmapFile(file, fileSize);
+        memset(image, 0, sizeof(*image));
+        return GL_FALSE;
+    }
+
+    image->storage = const_cast<uint8_t*>(file);
+    image->storageSize = (GLsizeiptr)fileSize;
+
+    if (vgl_ClampLevels(image, &firstLevel, &levelCount))
+    {
+        for (GLint level = firstLevel; level < firstLevel + levelCount; ++level)
+            vgl_PrefetchLevel(image, level);
+    }
+
+    return GL_TRUE;
+}
+
+void vglLoadDDS(const char* filename, vglImageData* image)
+{
+    vglLoadDDSLevels(filename, image, 0, 0);
+}
+
+void vglWaitImageLevels(vglImageData* image)
+{
+    vgl_ImageStream* stream = static_cast<vgl_ImageStream*>(image->stream);
+
+    if (stream == NULL)
+        return;
+
+    stream->thread.join();
+    delete stream;
+    image->stream = NULL;
+}
+
+GLboolean vglStreamImageLevels(vglImageData* image, GLint firstLevel, GLint levelCount,
+                               vglImageLevelCallback callback, void* user)
+{
+    vglWaitImageLevels(image);
+
+    if (image->mip[0].data == NULL || !vgl_ClampLevels(image, &firstLevel, &levelCount))
+        return GL_FALSE;
+
+    vgl_ImageStream* stream = new vgl_ImageStream;
+
+    // Smallest level first, so that each callback makes the texture sharper
+    stream->thread = std::thread([image, firstLevel, levelCount, callback, user]()
+    {
+        for (GLint level = firstLevel + levelCount - 1; level >= firstLevel; --level)
+        {
+            vgl_PrefetchLevel(image, level);
+            if (callback != NULL)
+                callback(image, level, user);
+        }
+    });
+
+    image->stream = stream;
+    return GL_TRUE;
+}
+
+void vglUnloadDDS(vglImageData* image)
+{
+    vglWaitImageLevels(image);
+
+    if (image->storageSize != 0)
+        vgl_UnmapFile(image->storage, (size_t)image->storageSize);
+    else
+        delete [] static_cast<uint8_t*>(image->storage);
+
+    image->storage = NULL;
+    image->storageSize = 0;
 }
 
 }